@@ -350,6 +350,7 @@
 // TODO
 
 #define GAVIN_INTERRUPT_CONTROL		0xfec00100	// start of interrupt control registers -- all are 2 byte RW	
+#define GAVIN_INT_MASK_GROUP_0		(GAVIN_INTERRUPT_CONTROL + 0x18)	// mask for MCP interrupts 0x00-0x0F. groups 1 and 2 follow, 2 bytes each. a set bit means that interrupt is off
 
 
 // ** A2560K Timer control registers
@@ -606,6 +607,12 @@
 #define VICKYB_PS2_MOUSE_BYTE_0		0xfec80c0a				// PS/2 mouse movement byte 0 for VICKY to interpret. W16.
 #define VICKYB_PS2_MOUSE_BYTE_1		0xfec80c0c				// PS/2 mouse movement byte 1 for VICKY to interpret. W16.
 #define VICKYB_PS2_MOUSE_BYTE_2		0xfec80c0e				// PS/2 mouse movement byte 2 for VICKY to interpret. W16.
+#define VICKYB_SPRITE_REGS_A2560K	0xfec81000				// vicky III channel B sprite registers: one record of SPRITE_REG_STRIDE bytes per hardware sprite. lower-numbered sprites draw in front.
+	#define SPRITE_REG_CTRL_OFFSET	0x00					//!> sprite control register: bit 0 = enable, bits 1-3 = LUT, bits 4-5 = layer. W32.
+	#define SPRITE_REG_ADDR_OFFSET	0x04					//!> address of the sprite's image, as an offset within VRAM (same as the bitmap layer address registers). W32.
+	#define SPRITE_REG_POS_OFFSET	0x08					//!> sprite position (Y pos in upper 16 bits, x in lower), offset by the sprite size so a sprite can be partly off the top/left. W32.
+	#define SPRITE_REG_STRIDE		0x10					//!> bytes from one sprite's registers to the next
+	#define SPRITE_CTRL_ENABLE		0x01					//!> enable bit for the sprite control register. LUT 0, in front of both bitmap layers.
 #define TEXTA_RAM_A2560K			(char*)0xfec60000		// channel A text
 #define TEXTA_ATTR_A2560K			(char*)0xfec68000		// channel A attr
 #define TEXTA_FORE_LUT_A2560K		(char*)0xfec6c400		// FG_CHAR_LUT_PTR	Text Foreground Look-Up Table
@@ -702,6 +709,15 @@
 
 #define SYS_TICKS_PER_SEC		60	// per syscalls.h in MCP, "a jiffie is 1/60 of a second."
 
+// Halt the CPU until the next interrupt (the jiffy timer, start of frame, mouse, keyboard, ...)
+// STOP is a privileged instruction: only build with SYS_IDLE_WITH_STOP if programs run in supervisor mode.
+// Otherwise this does nothing, and code waiting on an interrupt goes back to reading the value the interrupt changes.
+#if defined(SYS_IDLE_WITH_STOP)
+	#define CPU_WAIT_FOR_INTERRUPT()	__asm(" stop #0x2000")
+#else
+	#define CPU_WAIT_FOR_INTERRUPT()
+#endif
+
 // C256 FPGA Version. not the machine model.
 //C256F_MODEL_MAJOR - $AF:070B
 //C256F_MODEL_MINOR - $AF:070C
@@ -1335,13 +1351,19 @@ typedef enum
 
 // forward declarations
 typedef struct Font Font;						// defined in font.h
+typedef struct FontGlyph FontGlyph;				// defined in font.h
 typedef struct Window Window;					// defined in window.h
 typedef struct ClipRect ClipRect;				// defined in window.h
 typedef struct NewWinTemplate NewWinTemplate;	// defined in window.h
+typedef struct WindowDrawOp WindowDrawOp;		// defined in window.h
 typedef struct Theme Theme;						// defined in theme.h
 typedef struct ControlBackdrop ControlBackdrop;	// defined in theme.h
 typedef struct Control Control;					// defined in control.h
 typedef struct ControlTemplate ControlTemplate;	// defined in control.h
+typedef struct Region Region;					// defined in region.h
+typedef struct Pool Pool;						// defined in pool.h
+typedef struct PoolArenaStats PoolArenaStats;	// defined in pool.h
+typedef struct VramStats VramStats;				// defined in vram.h
 typedef struct System System;					// defined in lib_sys.h
 typedef struct Bitmap Bitmap;					// defined in bitmap.h
 typedef struct List List;						// defined in list.h
@@ -1350,8 +1372,18 @@ typedef struct EventKeyboard EventKeyboard;		// defined in event.h
 typedef struct EventMenu EventMenu;				// defined in event.h
 typedef struct EventMouse EventMouse;			// defined in event.h
 typedef struct EventWindow EventWindow;			// defined in event.h
+typedef struct EventTimer EventTimer;			// defined in event.h
 typedef struct EventManager EventManager;		// defined in event.h
+typedef struct EventRing EventRing;				// defined in event.h
 typedef struct MouseTracker MouseTracker;		// defined in mouse.h
+typedef struct Sprite Sprite;					// defined in sprite.h
+typedef struct PageFlip PageFlip;				// defined in pageflip.h
+typedef struct HitGrid HitGrid;					// defined in hitgrid.h
+typedef struct Timer Timer;						// defined in timer.h
+typedef struct TimerWheel TimerWheel;			// defined in timer.h
+typedef struct InputLog InputLog;				// defined in inputlog.h
+typedef struct InputLogStats InputLogStats;		// defined in inputlog.h
+typedef struct InputRecord InputRecord;			// defined in inputlog.h
 typedef struct MenuItem MenuItem;				// defined in menu.h
 typedef struct MenuGroup MenuGroup;				// defined in menu.h
 typedef struct Menu Menu;						// defined in menu.h
@@ -16,6 +16,8 @@
 // project includes
 #include "bitmap.h"
 #include "debug.h"
+#include "pool.h"
+#include "vram.h"
 
 // C includes
 #include <stdbool.h>
@@ -33,6 +35,32 @@
 /*                               Definitions                                 */
 /*****************************************************************************/
 
+#define BITMAP_STRUCTS_PER_SLAB		16		// number of Bitmap structs the bitmap pool gets from the heap at a time
+
+//! One pending entry in a flood fill's work queue: columns x1_ to x2_ (inclusive) of row y_ are to be checked for pixels to fill
+typedef struct BitmapFillSpan
+{
+	int16_t			y_;
+	int16_t			x1_;
+	int16_t			x2_;
+	int16_t			dy_;		// direction the fill was moving when it queued this span: 1 = down, -1 = up, 0 = unknown (seed spans)
+} BitmapFillSpan;
+
+//! The working state of one flood fill
+typedef struct BitmapFillJob
+{
+	Bitmap*			bitmap_;			// the bitmap being filled
+	Bitmap*			pattern_;			// the tile to fill with, or NULL for a solid color fill
+	uint8_t			color_;				// the fill color, if no pattern
+	uint8_t			old_color_;			// the color of the starting pixel. only pixels of this color are filled.
+	int16_t			spread_;			// 1 for 8-way fills (spans reach 1 pixel further on the rows above/below), 0 for 4-way
+	uint8_t*		done_mask_;			// 1 bit per pixel, MSB first. 1 = pixel has been filled by this job.
+	int16_t			mask_row_bytes_;	// bytes per row in done_mask_
+	BitmapFillSpan*	queue_;				// pending spans, BITMAP_FILL_MAX_SPANS of them at most. used last-in, first-out, which keeps it short.
+	int16_t			queue_count_;		// number of spans in queue_
+	bool			queue_overflowed_;	// true if a span had to be dropped because the queue was full
+} BitmapFillJob;
+
 
 
 /*****************************************************************************/
@@ -45,6 +73,7 @@
 /*                             Global Variables                              */
 /*****************************************************************************/
 
+static Pool		bitmap_pool = POOL_INITIALIZER("Bitmap", Bitmap, BITMAP_STRUCTS_PER_SLAB);
 
 
 /*****************************************************************************/
@@ -70,13 +99,58 @@ unsigned char* Bitmap_GetMemLocForXY(Bitmap* the_bitmap, int16_t x, int16_t y);
 //! @return Returns an unsigned long that can be converted to the VRAM location that corresponds to the passed X, Y, or NULL on any error condition
 uint32_t Bitmap_GetMemLocIntForXY(Bitmap* the_bitmap, int16_t x, int16_t y);
 
-//! Draw 1 to 4 quadrants of a circle
-//! Only the specified quadrants will be drawn. This makes it possible to use this to make round rects, by only passing 1 quadrant.
+//! Set one pixel, with no logging. If needs_clip is true, pixels off the bitmap are skipped; if false, the caller has already checked the whole shape is on the bitmap.
+void Bitmap_PlotPoint(Bitmap* the_bitmap, int16_t x, int16_t y, uint8_t the_color, bool needs_clip);
+
+//! Fill columns x1 to x2 (inclusive) of row y with one memset, clipped to the bitmap
+void Bitmap_FillSpan(Bitmap* the_bitmap, int16_t x1, int16_t x2, int16_t y, uint8_t the_color);
+
+//! Divide, rounding toward positive infinity. the_divisor must be positive.
+int32_t Bitmap_DivideRoundUp(int32_t the_dividend, int32_t the_divisor);
+
+//! Copy the top-left num_cols x num_rows pixels from one buffer to another with a different row length. The buffers can be the same.
+void Bitmap_CopyRows(unsigned char* dst_addr, int16_t dst_width, unsigned char* src_addr, int16_t src_width, int16_t num_cols, int16_t num_rows);
+
+//! Draw a line, skipping the parts outside the clip rect. The clip rect must already be within the bitmap.
+void Bitmap_DrawLineInRect(Bitmap* the_bitmap, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint8_t the_color, Rectangle* the_clip);
+
+//! Draw the outline of a rounded shape: 4 quarter-circle arcs centered on the passed corners, joined by straight edges
+//! A circle is the case where left_x == right_x and top_y == bottom_y
 //! Based on http://rosettacode.org/wiki/Bitmap/Midpoint_circle_algorithm#C
-bool Bitmap_DrawCircleQuadrants(Bitmap* the_bitmap, int16_t x1, int16_t y1, int16_t radius, uint8_t the_color, bool ne, bool se, bool sw, bool nw);
+void Bitmap_DrawRoundedOutline(Bitmap* the_bitmap, int16_t left_x, int16_t top_y, int16_t right_x, int16_t bottom_y, int16_t radius, uint8_t the_color);
+
+//! Fill a rounded shape (see Bitmap_DrawRoundedOutline) with one horizontal span per row, matching the outline's extent on each row
+void Bitmap_FillRounded(Bitmap* the_bitmap, int16_t left_x, int16_t top_y, int16_t right_x, int16_t bottom_y, int16_t radius, uint8_t the_color);
+
+//! Flood fill from the passed coordinate, with either a color or a pattern. Shared by Bitmap_FloodFill and Bitmap_FloodFillPattern.
+bool Bitmap_FloodFillCommon(Bitmap* the_bitmap, int16_t x, int16_t y, uint8_t the_color, Bitmap* the_pattern, bool eight_way);
+
+//! Check if a pixel is one the fill job still needs to fill
+bool Bitmap_FillPixelIsOpen(BitmapFillJob* the_job, uint8_t* the_row, int16_t y, int16_t x);
+
+//! Add a span to the fill job's work queue, clipped to the bitmap. If the queue is full, the span is dropped and the job is flagged for a rescan.
+void Bitmap_FillQueuePush(BitmapFillJob* the_job, int16_t y, int16_t x1, int16_t x2, int16_t dy);
+
+//! Write the fill color or pattern to columns x1 to x2 of row y, and mark them done
+void Bitmap_FillRun(BitmapFillJob* the_job, uint8_t* the_row, int16_t y, int16_t x1, int16_t x2);
+
+//! Find every run of open pixels that overlaps the span, fill it, and queue the rows above and below it
+void Bitmap_FillScanSpan(BitmapFillJob* the_job, BitmapFillSpan* the_span);
+
+//! After the queue overflowed: look over the whole bitmap for open pixels next to filled ones, and queue them again
+void Bitmap_FillRescan(BitmapFillJob* the_job);
 
-//! Perform a flood fill starting at the coordinate passed. 
-bool Bitmap_Fill(Bitmap* the_bitmap, int16_t x, int16_t y, uint8_t the_color);
+//! Validate the bitmaps passed to a blit function, and clip the copy rectangle against both of them
+//! On return, the coordinates and width/height have been adjusted so that the whole rect is within both bitmaps
+//! @return	Returns false if either bitmap is invalid, or if no part of the rectangle is within both bitmaps
+bool Bitmap_ClipBlitRect(Bitmap* src_bm, int16_t* src_x, int16_t* src_y, Bitmap* dst_bm, int16_t* dst_x, int16_t* dst_y, int16_t* width, int16_t* height);
+
+//! Copy len bytes from src to dst, front to back, moving the mutually-aligned middle of the span as 32-bit longs
+void Bitmap_CopySpanForward(uint8_t* dst, uint8_t* src, uint32_t len);
+
+//! Copy len bytes from src to dst, back to front, moving the mutually-aligned middle of the span as 32-bit longs
+//! Use when dst is higher in memory than src and the spans may overlap
+void Bitmap_CopySpanBackward(uint8_t* dst, uint8_t* src, uint32_t len);
 
 // **** Debug functions *****
 
@@ -113,611 +187,721 @@ bool Bitmap_ValidateXY(Bitmap* the_bitmap, int16_t x, int16_t y)
 }
 
 
-//! Draw 1 to 4 quadrants of a circle
-//! Only the specified quadrants will be drawn. This makes it possible to use this to make round rects, by only passing 1 quadrant.
-//! NO VALIDATION PERFORMEND ON PARAMETERS. CALLING METHOD MUST VALIDATE.
-//! Based on http://rosettacode.org/wiki/Bitmap/Midpoint_circle_algorithm#C
-bool Bitmap_DrawCircleQuadrants(Bitmap* the_bitmap, int16_t x1, int16_t y1, int16_t radius, uint8_t the_color, bool ne, bool se, bool sw, bool nw)
+//! Set one pixel, with no logging
+//! NO VALIDATION PERFORMED ON PARAMETERS. CALLING METHOD MUST VALIDATE.
+//! @param	needs_clip -- if true, a pixel that is off the bitmap is skipped. Pass false only if the whole shape being drawn is known to be on the bitmap.
+void Bitmap_PlotPoint(Bitmap* the_bitmap, int16_t x, int16_t y, uint8_t the_color, bool needs_clip)
 {
-    int16_t	f;
-    int16_t	ddF_x;
-    int16_t	ddF_y;
-    int16_t	x;
-    int16_t	y;
- 
-	f = 1 - radius;
-	ddF_x = 0;
-	ddF_y = -2 * radius;
-	x = 0;
-	y = radius;
-
-	if (se || sw)
+	if (needs_clip && (x < 0 || x >= the_bitmap->width_ || y < 0 || y >= the_bitmap->height_))
 	{
-		Bitmap_SetPixelAtXY(the_bitmap, x1, y1 + radius, the_color);
+		return;
 	}
-	if (ne || nw)
-	{
-		Bitmap_SetPixelAtXY(the_bitmap, x1, y1 - radius, the_color);
-	}
-	if (se || ne)
+	
+	*(the_bitmap->addr_ + (uint32_t)y * (uint32_t)the_bitmap->width_ + x) = the_color;
+}
+
+
+//! Fill columns x1 to x2 (inclusive) of row y with one memset, clipped to the bitmap
+//! NO VALIDATION PERFORMED ON PARAMETERS. CALLING METHOD MUST VALIDATE.
+void Bitmap_FillSpan(Bitmap* the_bitmap, int16_t x1, int16_t x2, int16_t y, uint8_t the_color)
+{
+	if (y < 0 || y >= the_bitmap->height_)
 	{
-		Bitmap_SetPixelAtXY(the_bitmap, x1 + radius, y1, the_color);
+		return;
 	}
-	if (nw || sw)
+	
+	x1 = (x1 < 0) ? 0 : x1;
+	x2 = (x2 >= the_bitmap->width_) ? the_bitmap->width_ - 1 : x2;
+	
+	if (x1 > x2)
 	{
-		Bitmap_SetPixelAtXY(the_bitmap, x1 - radius, y1, the_color);
+		return;
 	}
- 
-    while(x < y) 
-	{
-		if(f >= 0) 
-		{
-			y--;
-			ddF_y += 2;
-			f += ddF_y;
-		}
-
-		x++;
-		ddF_x += 2;
-		f += ddF_x + 1;  
- 
- 		if (se)
-        {
-			Bitmap_SetPixelAtXY(the_bitmap, x1 + x, y1 + y, the_color);
-			Bitmap_SetPixelAtXY(the_bitmap, x1 + y, y1 + x, the_color);
-        }
- 
- 		if (sw)
-        {
-			Bitmap_SetPixelAtXY(the_bitmap, x1 - x, y1 + y, the_color);
-			Bitmap_SetPixelAtXY(the_bitmap, x1 - y, y1 + x, the_color);
-        }
- 
- 		if (ne)
-        {
-			Bitmap_SetPixelAtXY(the_bitmap, x1 + x, y1 - y, the_color);
-			Bitmap_SetPixelAtXY(the_bitmap, x1 + y, y1 - x, the_color);
-        }
- 
- 		if (nw)
-        {
-			Bitmap_SetPixelAtXY(the_bitmap, x1 - x, y1 - y, the_color);
-			Bitmap_SetPixelAtXY(the_bitmap, x1 - y, y1 - x, the_color);
-        }
-    }
-    
-    return true;
-}
-
-
-//! Perform a flood fill starting at the coordinate passed. 
-//! WARNING: this function is recursive, and if applied to a size even 1/10th the size of the screen, it can eat the stack. Either do not use this, or control its usage to just situations you can control. Or set an enormous stack size when building your app.
-//! @param	the_color -- a 1-byte index to the current LUT
-bool Bitmap_Fill(Bitmap* the_bitmap, int16_t x, int16_t y, uint8_t the_color)
-{   
-	int16_t	height;
-	int16_t	width;
 	
-	width = the_bitmap->width_;
-	height = the_bitmap->height_;
-
-    if ( 0 <= y && y < height && 0 <= x && x < width && Bitmap_GetPixelAtXY(the_bitmap, x, y) != the_color )
-    {
-        Bitmap_SetPixelAtXY(the_bitmap, x, y, the_color);
-        Bitmap_Fill(the_bitmap, x-1, y, the_color);
-        Bitmap_Fill(the_bitmap, x+1, y, the_color);
-        Bitmap_Fill(the_bitmap, x, y-1, the_color);
-        Bitmap_Fill(the_bitmap, x, y+1, the_color);
-    }    
-    
-    return true;
+	memset(the_bitmap->addr_ + (uint32_t)y * (uint32_t)the_bitmap->width_ + x1, the_color, (size_t)(x2 - x1 + 1));
 }
 
 
-
-// **** Debug functions *****
-
-void Bitmap_Print(Bitmap* the_bitmap)
+//! Divide, rounding toward positive infinity. the_divisor must be positive.
+int32_t Bitmap_DivideRoundUp(int32_t the_dividend, int32_t the_divisor)
 {
-	DEBUG_OUT(("Bitmap print out:"));
-	DEBUG_OUT(("  address: %p",			the_bitmap));
-	DEBUG_OUT(("  width_: %i",			the_bitmap->width_));	
-	DEBUG_OUT(("  height_: %i",			the_bitmap->height_));	
-	DEBUG_OUT(("  x_: %i",				the_bitmap->x_));	
-	DEBUG_OUT(("  y_: %i",				the_bitmap->y_));	
-	DEBUG_OUT(("  color_: %u",			the_bitmap->color_));	
-	DEBUG_OUT(("  reserved_: %u",		the_bitmap->reserved_));	
-	DEBUG_OUT(("  font_: %p",			the_bitmap->font_));	
-	DEBUG_OUT(("  addr_: %p",			the_bitmap->addr_));
-	DEBUG_OUT(("  addr_int_: %lx",		the_bitmap->addr_int_));
+	if (the_dividend >= 0)
+	{
+		return (the_dividend + the_divisor - 1) / the_divisor;
+	}
+	
+	return -((-the_dividend) / the_divisor);
 }
 
-//! \endcond
-
-
-
-/*****************************************************************************/
-/*                        Public Function Definitions                        */
-/*****************************************************************************/
-
-// **** CONSTRUCTOR AND DESTRUCTOR *****
-
-// constructor
 
-//! Create a new bitmap object by allocating space for the bitmap struct in regular memory, and for the graphics, in VRAM
-//! NOTE: when creating a bitmap to represent something actually in VRAM, pass true to in_vram, and manually assign a known VRAM location afterwards.
-//! @param	width -- width, in pixels, of the bitmap to be created
-//! @param	height -- height, in pixels, of the bitmap to be created
-//! @param	the_font -- optional font object to associate with the Bitmap. 
-//! @param	in_vram -- if true, no space will be allocated for the bitmap graphics. If false, width * height area of memory will be allocated in standard memory.
-Bitmap* Bitmap_New(int16_t width, int16_t height, Font* the_font, bool in_vram)
+//! Copy the top-left num_cols x num_rows pixels from one buffer to another with a different row length
+//! The buffers can be the same: when a bitmap's width changes, its rows have to be slid to their new start
+//! NO VALIDATION PERFORMED ON PARAMETERS. CALLING METHOD MUST VALIDATE.
+void Bitmap_CopyRows(unsigned char* dst_addr, int16_t dst_width, unsigned char* src_addr, int16_t src_width, int16_t num_cols, int16_t num_rows)
 {
-	Bitmap*		the_bitmap;
-
-	//DEBUG_OUT(("%s %d: start bitmap creation... (%i x %i, %p)", __func__, __LINE__, width, height, the_font));
-
-	// check width/height for some maximum??
-	// TODO
-	if ( (width < 2 || width > VICKY_BITMAP_MAX_H_RES) || (height < 2 || height > VICKY_BITMAP_MAX_V_RES) )
-	{
-		LOG_ERR(("%s %d: Illegal width (%i) and/or height (%i)", __func__, __LINE__, width, height));
-		goto error;
-	}
-
-	//DEBUG_OUT(("%s %d: allocating struct in normal memory...", __func__, __LINE__));
+	int16_t		y;
 	
 	// LOGIC:
-	//   we have 2 kinds of memory: VRAM and standard RAM
-	//   A bitmap object needs a struct which can and should be allocated in normal memory
-	//   If the bitmap actually represents something on the screen, it needs to point to VRAM, not normal memory
+	//   when the copy is within one buffer, and the rows get longer, each row moves to a higher address: go bottom up, so no row is overwritten before it is moved
+	//   when the rows get shorter, they move down: go top down. row 0 never moves.
+	//   memmove handles the overlap between a row and its own new location
 	
-	if ((the_bitmap = calloc(1, sizeof(Bitmap))) == NULL)
+	if (dst_addr == src_addr && dst_width == src_width)
 	{
-		LOG_ERR(("%s %d: Couldn't allocate space for bitmap struc", __func__, __LINE__));
-		goto error;
+		return;
 	}
-	LOG_ALLOC(("%s %d:	__ALLOC__	the_bitmap struct	%p	size	%i", __func__ , __LINE__, the_bitmap, sizeof(Bitmap)));
-	TRACK_ALLOC((sizeof(Bitmap)));
-
-	if (in_vram == false)
+	
+	if (dst_width > src_width)
 	{
-		//DEBUG_OUT(("%s %d: Allocating a screen-sized bitmap in standard RAM...", __func__, __LINE__));
-
-		if ((the_bitmap->addr_ = calloc(sizeof(uint8_t), width * height)) == NULL)
+		for (y = num_rows - 1; y >= 0; y--)
 		{
-			LOG_ERR(("%s %d: Couldn't instantiate a bitmap", __func__, __LINE__));
-			goto error;
+			memmove(dst_addr + (uint32_t)y * dst_width, src_addr + (uint32_t)y * src_width, num_cols);
 		}
-		LOG_ALLOC(("%s %d:	__ALLOC__	the_bitmap data	%p	size	%i", __func__ , __LINE__, the_bitmap, sizeof(uint8_t) * width * height));
-		TRACK_ALLOC((sizeof(uint8_t) * width * height));
-		
-		the_bitmap->addr_int_ = (uint32_t)the_bitmap->addr_;
 	}
 	else
 	{
-		the_bitmap->addr_ = NULL;
-		the_bitmap->addr_int_ = 0;
+		for (y = 0; y < num_rows; y++)
+		{
+			memmove(dst_addr + (uint32_t)y * dst_width, src_addr + (uint32_t)y * src_width, num_cols);
+		}
 	}
+}
 
-	the_bitmap->width_ = width;
-	the_bitmap->height_ = height;
-	the_bitmap->in_vram_ = in_vram;
-	
-	//DEBUG_OUT(("%s %d: Bitmap allocated! p=%p, addr=%p, width=%i, height=%i", __func__, __LINE__, the_bitmap, the_bitmap->addr_, the_bitmap->width_, the_bitmap->height_));
 
-	if (the_font)
-	{
-		if (Bitmap_SetFont(the_bitmap, the_font) == false)
+//! Draw a line, skipping the parts outside the clip rect
+//! NO VALIDATION PERFORMED ON PARAMETERS. CALLING METHOD MUST VALIDATE. The clip rect must be within the bitmap, and the line no longer than BITMAP_MAX_LINE_SPAN on either axis.
+//! @param	the_clip -- the rect, in bitmap coordinates, that pixels may be drawn in. MaxX and MaxY are included.
+void Bitmap_DrawLineInRect(Bitmap* the_bitmap, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint8_t the_color, Rectangle* the_clip)
+{
+	uint8_t*	the_write_loc;
+	int32_t		width = the_bitmap->width_;
+	int32_t		major_len;
+	int32_t		minor_len;
+	int32_t		major_step;
+	int32_t		minor_step;
+	int32_t		major_lo;
+	int32_t		major_hi;
+	int32_t		minor_lo;
+	int32_t		minor_hi;
+	int32_t		k;
+	int32_t		the_limit;
+	int32_t		the_remainder;
+	int32_t		minor_offset;
+	int16_t		lo;
+	int16_t		hi;
+	int16_t		sx;
+	int16_t		sy;
+	bool		x_is_major;
+	
+	// horizontal and vertical lines: clip the ends, then one memset, or one pointer stepping down the rows
+	if (y1 == y2)
+	{
+		if (y1 < the_clip->MinY || y1 > the_clip->MaxY)
 		{
-			LOG_ERR(("%s %d: Couldn't assign the font to the bitmap", __func__, __LINE__));
-			goto error;
+			return;
+		}
+		
+		lo = (x1 < x2) ? x1 : x2;
+		hi = (x1 < x2) ? x2 : x1;
+		lo = (lo < the_clip->MinX) ? the_clip->MinX : lo;
+		hi = (hi > the_clip->MaxX) ? the_clip->MaxX : hi;
+		
+		if (lo <= hi)
+		{
+			memset(the_bitmap->addr_ + (uint32_t)y1 * (uint32_t)width + lo, the_color, (size_t)(hi - lo + 1));
 		}
+		
+		return;
 	}
+	
+	if (x1 == x2)
+	{
+		if (x1 < the_clip->MinX || x1 > the_clip->MaxX)
+		{
+			return;
+		}
 		
-	//Bitmap_Print(the_bitmap);
+		lo = (y1 < y2) ? y1 : y2;
+		hi = (y1 < y2) ? y2 : y1;
+		lo = (lo < the_clip->MinY) ? the_clip->MinY : lo;
+		hi = (hi > the_clip->MaxY) ? the_clip->MaxY : hi;
+		
+		the_write_loc = the_bitmap->addr_ + (uint32_t)lo * (uint32_t)width + x1;
+		
+		for (; lo <= hi; lo++)
+		{
+			*the_write_loc = the_color;
+			the_write_loc += width;
+		}
+		
+		return;
+	}
 	
-	return the_bitmap;
+	// LOGIC:
+	//   Bresenham, with the line described by its major axis (the longer one) and minor axis.
+	//   at step k along the major axis (0 to major_len), the minor axis offset is (2 * k * minor_len + major_len) / (2 * major_len), rounded down.
+	//   that formula can be solved for k, so the clip (Liang-Barsky style) gives the exact range of steps that are inside the clip rect:
+	//     the pixels drawn are exactly the ones the unclipped line would have drawn there, whatever part of the line is off the bitmap.
+	//   the inner loop then only moves a pointer: by +/-1 or +/-width along the major axis every step, and along the minor axis when the remainder overflows.
 	
-error:
-	return NULL;
-}
-
-
-// destructor
-// frees all allocated memory associated with the passed object, and the object itself
-bool Bitmap_Destroy(Bitmap** the_bitmap)
-{
-	if (*the_bitmap == NULL)
+	sx = (x1 < x2) ? 1 : -1;
+	sy = (y1 < y2) ? 1 : -1;
+	
+	x_is_major = (abs(x2 - x1) >= abs(y2 - y1));
+	
+	if (x_is_major)
 	{
-		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
-		return false;
+		major_len = abs(x2 - x1);
+		minor_len = abs(y2 - y1);
+		major_step = sx;
+		minor_step = sy * width;
+		major_lo = (sx > 0) ? the_clip->MinX - x1 : x1 - the_clip->MaxX;
+		major_hi = (sx > 0) ? the_clip->MaxX - x1 : x1 - the_clip->MinX;
+		minor_lo = (sy > 0) ? the_clip->MinY - y1 : y1 - the_clip->MaxY;
+		minor_hi = (sy > 0) ? the_clip->MaxY - y1 : y1 - the_clip->MinY;
+	}
+	else
+	{
+		major_len = abs(y2 - y1);
+		minor_len = abs(x2 - x1);
+		major_step = sy * width;
+		minor_step = sx;
+		major_lo = (sy > 0) ? the_clip->MinY - y1 : y1 - the_clip->MaxY;
+		major_hi = (sy > 0) ? the_clip->MaxY - y1 : y1 - the_clip->MinY;
+		minor_lo = (sx > 0) ? the_clip->MinX - x1 : x1 - the_clip->MaxX;
+		minor_hi = (sx > 0) ? the_clip->MaxX - x1 : x1 - the_clip->MinX;
 	}
-
-	// LOGIC: 
-	//   Bitmaps optionally have fonts associated with them.
-	//   We do not want to destroy these, because other objects could be using them.
-	//   TODO: notify the system that we are no longer using this font (system needs to be tallying usage count for that to work)
 	
-	if ((*the_bitmap)->font_)
+	// the line's own extent limits both ranges
+	major_lo = (major_lo < 0) ? 0 : major_lo;
+	major_hi = (major_hi > major_len) ? major_len : major_hi;
+	minor_lo = (minor_lo < 0) ? 0 : minor_lo;
+	minor_hi = (minor_hi > minor_len) ? minor_len : minor_hi;
+	
+	if (minor_lo > minor_hi)
 	{
-		(*the_bitmap)->font_ = NULL;
+		return;
 	}
-
-	if ((*the_bitmap)->addr_)
+	
+	// first step whose minor offset is >= minor_lo, and last step whose minor offset is <= minor_hi
+	the_limit = Bitmap_DivideRoundUp((2 * minor_lo - 1) * major_len, 2 * minor_len);
+	major_lo = (the_limit > major_lo) ? the_limit : major_lo;
+	the_limit = Bitmap_DivideRoundUp((2 * minor_hi + 1) * major_len, 2 * minor_len) - 1;
+	major_hi = (the_limit < major_hi) ? the_limit : major_hi;
+	
+	if (major_lo > major_hi)
 	{
-		if ((*the_bitmap)->in_vram_ == false)
+		return;
+	}
+	
+	k = 2 * major_lo * minor_len + major_len;
+	minor_offset = k / (2 * major_len);
+	the_remainder = k % (2 * major_len);
+	
+	if (x_is_major)
+	{
+		the_write_loc = the_bitmap->addr_ + (int32_t)(y1 + sy * minor_offset) * width + (x1 + sx * major_lo);
+	}
+	else
+	{
+		the_write_loc = the_bitmap->addr_ + (int32_t)(y1 + sy * major_lo) * width + (x1 + sx * minor_offset);
+	}
+	
+	for (k = major_lo; k <= major_hi; k++)
+	{
+		*the_write_loc = the_color;
+		the_write_loc += major_step;
+		the_remainder += 2 * minor_len;
+		
+		if (the_remainder >= 2 * major_len)
 		{
-			LOG_ALLOC(("%s %d:	__FREE__	the_bitmap->addr_	%p	size	%i", __func__ , __LINE__, (*the_bitmap)->addr_, (*the_bitmap)->width_ * (*the_bitmap)->height_));
-			TRACK_ALLOC((0 - (*the_bitmap)->width_ * (*the_bitmap)->height_));
-			free((*the_bitmap)->addr_);
+			the_remainder -= 2 * major_len;
+			the_write_loc += minor_step;
 		}
 	}
-
-	LOG_ALLOC(("%s %d:	__FREE__	*the_bitmap	%p	size	%i", __func__ , __LINE__, *the_bitmap, sizeof(Bitmap)));
-	TRACK_ALLOC((0 - sizeof(Bitmap)));
-	free(*the_bitmap);
-	*the_bitmap = NULL;
-	
-	return true;
 }
 
 
-//! Resize and existing bitmap by setting new width/height and allocating bigger storage if necessary
-//! NOTE: if the bitmap is held in VRAM, storage will not be reallocated
-//! NOTE: if the new size for the bitmap is smaller than the previous size, storage will not be reallocated - extra bytes will simply not be used
-//! @param	width -- the new width, in pixels, to resize the bitmap to
-//! @param	height -- the new height, in pixels, to resize the bitmap to
-//! @return	Returns false in any error condition
-bool Bitmap_Resize(Bitmap* the_bitmap, int16_t width, int16_t height)
+//! Draw the outline of a rounded shape: 4 quarter-circle arcs centered on the passed corners, joined by straight edges
+//! A circle is the case where left_x == right_x and top_y == bottom_y: the "edges" are then just the 4 points at the ends of the radius
+//! NO VALIDATION PERFORMED ON PARAMETERS. CALLING METHOD MUST VALIDATE. right_x must be >= left_x and bottom_y >= top_y.
+//! Based on http://rosettacode.org/wiki/Bitmap/Midpoint_circle_algorithm#C
+void Bitmap_DrawRoundedOutline(Bitmap* the_bitmap, int16_t left_x, int16_t top_y, int16_t right_x, int16_t bottom_y, int16_t radius, uint8_t the_color)
 {
-	size_t	old_size;
-	size_t	new_size;
+	int32_t		f;
+	int32_t		ddF_x;
+	int32_t		ddF_y;
+	int16_t		x;
+	int16_t		y;
+	int16_t		i;
+	bool		needs_clip;
 	
-	if (the_bitmap == NULL)
+	// LOGIC:
+	//   the bounds are checked once for the whole shape. if it is all on the bitmap (the usual case), each point is written without any checks.
+	//   each step of the midpoint algorithm gives one point per octant: (x, y) and (y, x), mirrored into the 4 corners.
+	//   when x == y, the 2 octants meet on the same pixel, so the second is skipped.
+	
+	needs_clip = (left_x - radius < 0 || top_y - radius < 0 || right_x + radius >= the_bitmap->width_ || bottom_y + radius >= the_bitmap->height_);
+	
+	// straight edges. these also supply the 4 points where the arcs meet them.
+	for (i = left_x; i <= right_x; i++)
 	{
-		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
-		return false;
+		Bitmap_PlotPoint(the_bitmap, i, top_y - radius, the_color, needs_clip);
+		Bitmap_PlotPoint(the_bitmap, i, bottom_y + radius, the_color, needs_clip);
 	}
-
-	DEBUG_OUT(("%s %d: start bitmap resizing; old = %i x %i; new=%i x %i", __func__, __LINE__, the_bitmap->width_, the_bitmap->height_, width, height));
-
-	old_size = the_bitmap->width_ * the_bitmap->height_;
-	new_size = width * height;
 	
-	the_bitmap->width_ = width;
-	the_bitmap->height_ = height;
+	for (i = top_y; i <= bottom_y; i++)
+	{
+		Bitmap_PlotPoint(the_bitmap, left_x - radius, i, the_color, needs_clip);
+		Bitmap_PlotPoint(the_bitmap, right_x + radius, i, the_color, needs_clip);
+	}
+	
+	f = 1 - radius;
+	ddF_x = 0;
+	ddF_y = -2 * (int32_t)radius;
+	x = 0;
+	y = radius;
 	
-	// Reallocate bitmap only if both are true:
-	//   window is not in VRAM. we only store backdrop in VRAM, and it shares same bitmap as the screen.
-	//   window got LARGER. if it got smaller, we can just keep reusing same bitmap and not worry about the extra space.
-	if (the_bitmap->in_vram_ == false && new_size > old_size)
+	while (x < y)
 	{
-		if (the_bitmap->addr_)
+		if (f >= 0)
 		{
-			LOG_ALLOC(("%s %d:	__FREE__	the_bitmap->addr_	%p	size	%i", __func__ , __LINE__, the_bitmap->addr_, old_size));
-			TRACK_ALLOC((0 - old_size));
-			free(the_bitmap->addr_);
+			y--;
+			ddF_y += 2;
+			f += ddF_y;
 		}
 		
-		if ((the_bitmap->addr_ = calloc(sizeof(uint8_t), new_size)) == NULL)
+		x++;
+		ddF_x += 2;
+		f += ddF_x + 1;
+		
+		Bitmap_PlotPoint(the_bitmap, right_x + x, bottom_y + y, the_color, needs_clip);
+		Bitmap_PlotPoint(the_bitmap, left_x - x, bottom_y + y, the_color, needs_clip);
+		Bitmap_PlotPoint(the_bitmap, right_x + x, top_y - y, the_color, needs_clip);
+		Bitmap_PlotPoint(the_bitmap, left_x - x, top_y - y, the_color, needs_clip);
+		
+		if (x != y)
 		{
-			LOG_ERR(("%s %d: Couldn't instantiate a bitmap", __func__, __LINE__));
-			return false;
+			Bitmap_PlotPoint(the_bitmap, right_x + y, bottom_y + x, the_color, needs_clip);
+			Bitmap_PlotPoint(the_bitmap, left_x - y, bottom_y + x, the_color, needs_clip);
+			Bitmap_PlotPoint(the_bitmap, right_x + y, top_y - x, the_color, needs_clip);
+			Bitmap_PlotPoint(the_bitmap, left_x - y, top_y - x, the_color, needs_clip);
 		}
-		LOG_ALLOC(("%s %d:	__ALLOC__	the_bitmap->addr_	%p	size	%i", __func__ , __LINE__, the_bitmap->addr_, new_size));
-		TRACK_ALLOC((new_size));
-		
-		the_bitmap->addr_int_ = (uint32_t)the_bitmap->addr_;
 	}
-	
-	return true;
 }
 
 
-
-
-// **** Block copy functions ****
-
-//! Blit a rect from source bitmap to distination bitmap
-//! This is a wrapper around Bitmap_Blit()
-//! The source and destination bitmaps can be the same: you can use this to copy a chunk of pixels from one part of a screen to another. If the destination location cannot fit the entirety of the copied rectangle, the copy will be truncated, but will not return an error. 
-//! @param	src_bm -- the source bitmap. It must have a valid address within the VRAM memory space.
-//! @param	dst_bm -- the destination bitmap. It must have a valid address within the VRAM memory space. It can be the same bitmap as the source.
-//! @param	src_rect -- the rectangle from the source bitmap to be blitted to the target bitmap
-//! @param	dst_x -- the location within the destination bitmap to copy pixels to. May be negative.
-//! @param	dst_y -- the location within the destination bitmap to copy pixels to. May be negative.
-bool Bitmap_BlitRect(Bitmap* src_bm, Rectangle* src_rect, Bitmap* dst_bm, int16_t dst_x, int16_t dst_y)
+//! Fill a rounded shape (see Bitmap_DrawRoundedOutline) with one horizontal span per row, matching the outline's extent on each row
+//! NO VALIDATION PERFORMED ON PARAMETERS. CALLING METHOD MUST VALIDATE. right_x must be >= left_x and bottom_y >= top_y.
+void Bitmap_FillRounded(Bitmap* the_bitmap, int16_t left_x, int16_t top_y, int16_t right_x, int16_t bottom_y, int16_t radius, uint8_t the_color)
 {
-	int16_t	width;
-	int16_t	height;
+	int32_t		f;
+	int32_t		ddF_x;
+	int32_t		ddF_y;
+	int16_t		x;
+	int16_t		y;
+	int16_t		i;
 	
-	// LOGIC: validation checks will be done by Bitmap_Blit, no need to check them here too
+	// LOGIC:
+	//   runs the same midpoint steps as Bitmap_DrawRoundedOutline, but emits rows instead of points.
+	//   a row at vertical offset x (from the arc centers) is as wide as the y of the step that reached x: x increases every step, so each is filled once.
+	//   a row at vertical offset y is as wide as the last x before y steps in, so it is filled just before y changes.
+	//   the loop can end with x one past y; that row was already filled from the y side, so the x side skips it.
+	//   rows between top_y and bottom_y are the straight-sided middle of the shape.
 	
-	width = src_rect->MaxX - src_rect->MinX + 1;
-	height = src_rect->MaxY - src_rect->MinY + 1;
-
-	//DEBUG_OUT(("%s %d: incoming parameters: MinX=%i, MinY=%i, MaxX=%i, MaxY=%i", __func__, __LINE__, src_rect->MinX, src_rect->MinY, src_rect->MaxX, src_rect->MaxY));
-	//DEBUG_OUT(("%s %d: final parameters: src_x=%i, src_y=%i, dst_x=%i, dst_y=%i, width=%i, height=%i.", __func__, __LINE__, src_rect->MinX, src_rect->MinY, dst_x, dst_y, width, height));
-	//DEBUG_OUT(("%s %d: src_bm=%p, dst_bm=%p", __func__, __LINE__, src_bm->addr_, dst_bm->addr_));
+	for (i = top_y; i <= bottom_y; i++)
+	{
+		Bitmap_FillSpan(the_bitmap, left_x - radius, right_x + radius, i, the_color);
+	}
 	
-	return Bitmap_Blit(src_bm, src_rect->MinX, src_rect->MinY, dst_bm, dst_x, dst_y, width, height);
-}
+	f = 1 - radius;
+	ddF_x = 0;
+	ddF_y = -2 * (int32_t)radius;
+	x = 0;
+	y = radius;
+	
+	while (x < y)
+	{
+		if (f >= 0)
+		{
+			Bitmap_FillSpan(the_bitmap, left_x - x, right_x + x, top_y - y, the_color);
+			Bitmap_FillSpan(the_bitmap, left_x - x, right_x + x, bottom_y + y, the_color);
+			y--;
+			ddF_y += 2;
+			f += ddF_y;
+		}
+		
+		x++;
+		ddF_x += 2;
+		f += ddF_x + 1;
+		
+		if (x <= y)
+		{
+			Bitmap_FillSpan(the_bitmap, left_x - y, right_x + y, top_y - x, the_color);
+			Bitmap_FillSpan(the_bitmap, left_x - y, right_x + y, bottom_y + x, the_color);
+		}
+	}
+}
 
 
-//! Blit from source bitmap to distination bitmap. 
-//! The source and destination bitmaps can be the same: you can use this to copy a chunk of pixels from one part of a screen to another. If the destination location cannot fit the entirety of the copied rectangle, the copy will be truncated, but will not return an error. 
-//! @param	src_bm -- the source bitmap. It must have a valid address within the VRAM memory space.
-//! @param	dst_bm -- the destination bitmap. It must have a valid address within the VRAM memory space. It can be the same bitmap as the source.
-//! @param	src_x -- the upper left coordinate within the source bitmap, for the rectangle you want to copy. May be negative.
-//! @param	src_y -- the upper left coordinate within the source bitmap, for the rectangle you want to copy. May be negative.
-//! @param	dst_x -- the location within the destination bitmap to copy pixels to. May be negative.
-//! @param	dst_y -- the location within the destination bitmap to copy pixels to. May be negative.
-//! @param	width -- the scope of the copy, in pixels.
-//! @param	height -- the scope of the copy, in pixels.
-bool Bitmap_Blit(Bitmap* src_bm, int16_t src_x, int16_t src_y, Bitmap* dst_bm, int16_t dst_x, int16_t dst_y, int16_t width, int16_t height)
+//! Flood fill from the passed coordinate, with either a color or a pattern. Shared by Bitmap_FloodFill and Bitmap_FloodFillPattern.
+//! NO VALIDATION PERFORMED ON PARAMETERS. CALLING METHOD MUST VALIDATE.
+//! @param	the_color -- a 1-byte index to the current LUT. Ignored if the_pattern is not NULL.
+//! @param	the_pattern -- tile to fill with, or NULL to fill with the_color
+bool Bitmap_FloodFillCommon(Bitmap* the_bitmap, int16_t x, int16_t y, uint8_t the_color, Bitmap* the_pattern, bool eight_way)
 {
-	uint32_t		the_read_loc_int;
-	uint32_t		the_write_loc_int;
-	uint8_t*		the_write_loc;
-	uint8_t*		the_read_loc;
-	uint32_t		copy_size;
-	int16_t			j;
+	BitmapFillJob	the_job;
+	BitmapFillSpan	the_span;
+	uint32_t		mask_size;
+	uint32_t		queue_size;
 	
-	// TODO: move the 2 checks below to a private common function if other blit functions are added
+	// LOGIC:
+	//   scanline fill: each span taken from the work queue is scanned for runs of pixels of the old color. 
+	//     each run is extended left and right as far as it goes, written in one go, and the rows above and below it are queued.
+	//     the queue is a fixed size, so memory use is bounded no matter the shape filled. nothing here recurses.
+	//   a 1-bit-per-pixel "done" mask records what this fill has written. a solid fill doesn't need it to know where it has been
+	//     (filled pixels no longer have the old color), but a pattern fill does, as the pattern may contain the old color.
+	//   if the queue ever fills up, the span that didn't fit is dropped, and the job is flagged. once the queue drains, 
+	//     the done mask is used to find open pixels next to filled ones, which are queued again. repeat until nothing was dropped.
 	
-	if (src_bm == NULL || dst_bm == NULL)
-	{
-		LOG_ERR(("%s %d: passed source or destination bitmap was NULL", __func__, __LINE__));
-		return false;
-	}
+	the_job.bitmap_ = the_bitmap;
+	the_job.pattern_ = the_pattern;
+	the_job.color_ = the_color;
+	the_job.old_color_ = *(the_bitmap->addr_ + (uint32_t)y * (uint32_t)the_bitmap->width_ + (uint32_t)x);
+	the_job.spread_ = (eight_way == PARAM_FILL_8_WAY) ? 1 : 0;
+	the_job.mask_row_bytes_ = (the_bitmap->width_ + 7) / 8;
+	the_job.queue_count_ = 0;
+	the_job.queue_overflowed_ = false;
 	
-	if (src_bm->addr_ == NULL || dst_bm->addr_ == NULL)
+	if (the_pattern == NULL && the_color == the_job.old_color_)
 	{
-		LOG_ERR(("%s %d: passed source or destination bitmap had a NULL address", __func__, __LINE__));
-		return false;
+		return true;	// nothing would change
 	}
 	
-	// LOGIC:
-	//   check if any part of the desired rectangle is within visible space in the source.
-	//   We want to allow negative starting locations as long as height/width means some part of the rectange is actually in the bitmap. 
+	mask_size = (uint32_t)the_job.mask_row_bytes_ * (uint32_t)the_bitmap->height_;
+	queue_size = sizeof(BitmapFillSpan) * BITMAP_FILL_MAX_SPANS;
 	
-	if (src_x + width < 0 || src_y + height < 0)
+	if ((the_job.done_mask_ = calloc(mask_size, sizeof(uint8_t))) == NULL)
 	{
-		LOG_INFO(("%s %d: No part of the copy-from rectangle was on screen. No copy performed. src_x=%i, src_y=%i, width=%i, height=%i.", __func__, __LINE__, src_x, src_y, width, height));
+		LOG_ERR(("%s %d: could not allocate memory for the fill mask", __func__ , __LINE__));
 		return false;
 	}
+	LOG_ALLOC(("%s %d:	__ALLOC__	the_job.done_mask_	%p	size	%lu", __func__ , __LINE__, the_job.done_mask_, mask_size));
+	TRACK_ALLOC((mask_size));
 	
-	// LOGIC:
-	//   check if any part of the desired rectangle is within visible space in the target.
-	//   We want to allow near-right-edge/bottom-edge starting locations as long as some part of the rectange is actually in the bitmap. 
-	
-	if (dst_x >= dst_bm->width_ || dst_y >= dst_bm->height_)
+	if ((the_job.queue_ = (BitmapFillSpan*)malloc(queue_size)) == NULL)
 	{
-		LOG_INFO(("%s %d: No part of the copy-to rectangle was on screen. No copy performed. dst_x=%i, dst_y=%i, width=%i, height=%i.", __func__, __LINE__, dst_x, dst_y, width, height));
+		LOG_ERR(("%s %d: could not allocate memory for the fill queue", __func__ , __LINE__));
+		LOG_ALLOC(("%s %d:	__FREE__	the_job.done_mask_	%p	size	%lu", __func__ , __LINE__, the_job.done_mask_, mask_size));
+		TRACK_ALLOC((0 - mask_size));
+		free(the_job.done_mask_);
 		return false;
 	}
-
-	// adjust copy width/height if the whole image wouldn't fit on target bitmap anyway
-	width = (dst_x + width >= dst_bm->width_) ? dst_bm->width_ - dst_x : width;
-	height = (dst_y + height >= dst_bm->height_) ? dst_bm->height_ - dst_y : height;
+	LOG_ALLOC(("%s %d:	__ALLOC__	the_job.queue_	%p	size	%lu", __func__ , __LINE__, the_job.queue_, queue_size));
+	TRACK_ALLOC((queue_size));
+	
+	Bitmap_FillQueuePush(&the_job, y, x, x, 0);
 	
-	// adjust copy width/height if the starting x,y are offscreen
-	if (src_x < 0)
+	for (;;)
 	{
-		width -= src_x;
-		src_x = 0;
+		while (the_job.queue_count_ > 0)
+		{
+			the_span = the_job.queue_[--the_job.queue_count_];
+			Bitmap_FillScanSpan(&the_job, &the_span);
+		}
+		
+		if (the_job.queue_overflowed_ == false)
+		{
+			break;
+		}
+		
+		the_job.queue_overflowed_ = false;
+		Bitmap_FillRescan(&the_job);
 	}
+	
+	LOG_ALLOC(("%s %d:	__FREE__	the_job.queue_	%p	size	%lu", __func__ , __LINE__, the_job.queue_, queue_size));
+	TRACK_ALLOC((0 - queue_size));
+	free(the_job.queue_);
+	LOG_ALLOC(("%s %d:	__FREE__	the_job.done_mask_	%p	size	%lu", __func__ , __LINE__, the_job.done_mask_, mask_size));
+	TRACK_ALLOC((0 - mask_size));
+	free(the_job.done_mask_);
+	
+	return true;
+}
+
 
-	if (src_y < 0)
+//! Check if a pixel is one the fill job still needs to fill
+//! @param	the_row -- pointer to the first pixel of row y in the bitmap
+bool Bitmap_FillPixelIsOpen(BitmapFillJob* the_job, uint8_t* the_row, int16_t y, int16_t x)
+{
+	uint8_t*	the_mask_row;
+	
+	if (the_row[x] != the_job->old_color_)
 	{
-		height -= src_y;
-		src_y = 0;
+		return false;
 	}
-
-	//DEBUG_OUT(("%s %d: final parameters: src_x=%i, src_y=%i, dst_x=%i, dst_y=%i, width=%i, height=%i.", __func__, __LINE__, src_x, src_y, dst_x, dst_y, width, height));
-
-	// checks complete. ready to copy.
-	copy_size = (uint32_t)width;
-	the_read_loc_int = src_bm->addr_int_ + ((uint32_t)src_bm->width_ * (uint32_t)src_y) + (uint32_t)src_x;
-	the_write_loc_int = dst_bm->addr_int_ + ((uint32_t)dst_bm->width_ * (uint32_t)dst_y) + (uint32_t)dst_x;
-	//DEBUG_OUT(("%s %d: the_read_loc_int=%i, the_write_loc_int=%i, copy_size=%lu", __func__, __LINE__, the_read_loc_int, the_write_loc_int, copy_size));
 	
-	for (j = 0; j < height; j++)
+	if (the_job->pattern_ == NULL)
 	{
-		the_write_loc = (uint8_t*)the_write_loc_int;
-		the_read_loc = (uint8_t*)the_read_loc_int;
-		//DEBUG_OUT(("%s %d: the_read_loc=%p, the_write_loc=%p, copy_size=%lu", __func__, __LINE__, the_read_loc, the_write_loc, copy_size));
-
-		#ifdef _DO_NOT_TRUST_MEMCPY_
-			uint32_t i;
-			
-			for (i=0; i < copy_size; i++)
-			{
-				*the_write_loc = *the_read_loc;
-				the_write_loc++;
-				the_read_loc++;
-// 				the_write_loc_int++;			
-// 				the_read_loc_int++;			
-// 				the_write_loc = (uint8_t*)the_write_loc_int;
-// 				the_read_loc = (uint8_t*)the_read_loc_int;
-			}
-		#else
-			memcpy(the_write_loc, the_read_loc, copy_size);
-		#endif	
-		
-		the_write_loc_int += (uint32_t)dst_bm->width_;
-		the_read_loc_int += (uint32_t)src_bm->width_;
+		return true;
 	}
-
-	return true;
+	
+	the_mask_row = the_job->done_mask_ + (uint32_t)y * (uint32_t)the_job->mask_row_bytes_;
+	
+	return ((the_mask_row[x >> 3] & (0x80 >> (x & 7))) == 0);
 }
 
 
-//! Tile the source bitmap into the destination bitmap, filling it
-//! The source and destination bitmaps can be the same: you can use this to copy a chunk of pixels from one part of a screen to another. If the destination location cannot fit the entirety of the copied rectangle, the copy will be truncated, but will not return an error. 
-//! @param	src_bm -- the source bitmap. It must have a valid address within the VRAM memory space.
-//! @param	dst_bm -- the destination bitmap. It must have a valid address within the VRAM memory space. It can be the same bitmap as the source.
-//! @param	src_x -- the upper left coordinate within the source bitmap, for the tile you want to copy. Must be non-negative.
-//! @param	src_y -- the upper left coordinate within the source bitmap, for the tile you want to copy. Must be non-negative.
-//! @param	width -- the size of the tile to be derived from the source bitmap, in pixels.
-//! @param	height -- the size of the tile to be derived from the source bitmap, in pixels.
-bool Bitmap_TileV3(Bitmap* src_bm, int16_t src_x, int16_t src_y, Bitmap* dst_bm, int16_t width, int16_t height)
+//! Add a span to the fill job's work queue, clipped to the bitmap. If the queue is full, the span is dropped and the job is flagged for a rescan.
+//! @param	dy -- the direction the fill was moving: 1 if y is the row below the run that queued it, -1 if the row above, 0 for a seed
+void Bitmap_FillQueuePush(BitmapFillJob* the_job, int16_t y, int16_t x1, int16_t x2, int16_t dy)
 {
-	unsigned char*		the_starting_read_loc;
-	unsigned char*		the_read_loc;
-	unsigned char*		the_write_loc;
-	int16_t				i;
-	int16_t				h_tiles;
-	int16_t				h_rem;
-	int16_t				v_tiles;
-	int16_t				v_rem;
-	int16_t				j;
-	int16_t				bytes;
+	BitmapFillSpan*	the_span;
 	
-	
-	// TODO: move the 2 checks below to a private common function if other blit functions are added
-	
-	if (src_bm == NULL || dst_bm == NULL)
+	if (y < 0 || y >= the_job->bitmap_->height_)
 	{
-		LOG_ERR(("%s %d: passed source or destination bitmap was NULL", __func__, __LINE__));
-		return false;
+		return;
 	}
 	
-	if (src_bm->addr_ == NULL || dst_bm->addr_ == NULL)
+	if (x1 < 0)
 	{
-		LOG_ERR(("%s %d: passed source or destination bitmap had a NULL address", __func__, __LINE__));
-		return false;
+		x1 = 0;
 	}
 	
-	// LOGIC:
-	//   The entire width and height of the tile must be within the source bitmap. 
+	if (x2 >= the_job->bitmap_->width_)
+	{
+		x2 = the_job->bitmap_->width_ - 1;
+	}
 	
-	if (src_x < 0 || src_x + width > src_bm->width_ || src_y < 0 || src_y + height > src_bm->height_)
+	if (x1 > x2)
 	{
-		LOG_INFO(("%s %d: Tile operations require the entire height and width of the tile to be defined within the bounds of the source bitmap. No tiling performed. src_x=%i, src_y=%i, width=%i, height=%i.", __func__, __LINE__, src_x, src_y, width, height));
-		return false;
+		return;
 	}
-
-	//DEBUG_OUT(("%s %d: starting parameters: src_x=%i, src_y=%i, width=%i, height=%i.", __func__, __LINE__, src_x, src_y, width, height));
-	//DEBUG_OUT(("%s %d: dst_bm=%p, dst_bm=%p", __func__, __LINE__, src_bm, dst_bm));
 	
-	// LOGIC:
-	//   Unlike a blit operation, a tile operation always starts in the upper left corner of the target bitmap, and fills it entirely
-	//   As an optimization, each row of one tile worth will be copied to the right to fill one horizontal row of the dest. bitmap
-	//   From that point, will loop through the required number of remaining bands, copying the full width of the dest bitmap.
+	if (the_job->queue_count_ >= BITMAP_FILL_MAX_SPANS)
+	{
+		the_job->queue_overflowed_ = true;
+		return;
+	}
 	
-	// adjust copy width/height if the prescribed tile height or width wouldn't fit on target bitmap
-	width = (width >= dst_bm->width_) ? dst_bm->width_ : width;
-	height = (height >= dst_bm->height_) ? dst_bm->height_ : height;
+	the_span = &the_job->queue_[the_job->queue_count_++];
+	the_span->y_ = y;
+	the_span->x1_ = x1;
+	the_span->x2_ = x2;
+	the_span->dy_ = dy;
+}
 
-	// checks complete. ready to tile. 
-	the_starting_read_loc = src_bm->addr_ + (src_bm->width_ * src_y) + src_x;
-	
-	h_tiles = dst_bm->width_ / width;
-	h_rem = dst_bm->width_ % width;
+
+//! Write the fill color or pattern to columns x1 to x2 of row y, and mark them done
+//! @param	the_row -- pointer to the first pixel of row y in the bitmap
+void Bitmap_FillRun(BitmapFillJob* the_job, uint8_t* the_row, int16_t y, int16_t x1, int16_t x2)
+{
+	uint8_t*	the_mask_row;
+	int16_t		x;
 	
-	// first loop is to create 1 pixel row worth extending across the entire target bitmap
-	// and loop that for each row in the source tile
-	for (i = 0; i < height; i++)
+	if (the_job->pattern_ == NULL)
 	{
-		the_write_loc = dst_bm->addr_ + dst_bm->width_ * i; // x=0, row = i
-
-		for (j = 0; j < h_tiles; j++)
-		{
-			the_read_loc = the_starting_read_loc + src_bm->width_ * i;
-			for (bytes = 0; bytes < width; bytes++)
-			{
-				*the_write_loc++ = *the_read_loc++;
-			}
-// 			memcpy(the_write_loc, the_read_loc, width);
-// 	
-// 			the_write_loc += width;
-		}
+		memset(the_row + x1, the_job->color_, (size_t)(x2 - x1 + 1));
+	}
+	else
+	{
+		Bitmap*		the_pattern = the_job->pattern_;
+		uint8_t*	the_pattern_row;
+		uint8_t*	the_write_loc;
+		int16_t		pattern_x;
+		int16_t		remaining;
+		int16_t		this_len;
 		
-		// the last horizontal span, if any, will have less width
-		if (h_rem)
+		// copy the pattern row a tile-width (or less) at a time, starting at whatever column of the tile lines up with x1
+		the_pattern_row = the_pattern->addr_ + (uint32_t)(y % the_pattern->height_) * (uint32_t)the_pattern->width_;
+		pattern_x = x1 % the_pattern->width_;
+		the_write_loc = the_row + x1;
+		remaining = x2 - x1 + 1;
+		
+		while (remaining > 0)
 		{
-			//memcpy(the_write_loc, the_read_loc, h_rem);
-			the_read_loc = the_starting_read_loc + src_bm->width_ * i;
+			this_len = the_pattern->width_ - pattern_x;
 			
-			for (bytes = 0; bytes < h_rem; bytes++)
+			if (this_len > remaining)
 			{
-				*the_write_loc++ = *the_read_loc++;
+				this_len = remaining;
 			}
+			
+			memcpy(the_write_loc, the_pattern_row + pattern_x, (size_t)this_len);
+			the_write_loc += this_len;
+			remaining -= this_len;
+			pattern_x = 0;
 		}
-	}		
+	}
+	
+	// mark done: partial bytes at each end, whole bytes in between
+	the_mask_row = the_job->done_mask_ + (uint32_t)y * (uint32_t)the_job->mask_row_bytes_;
+	x = x1;
 	
+	for (; x <= x2 && (x & 7) != 0; x++)
+	{
+		the_mask_row[x >> 3] |= (0x80 >> (x & 7));
+	}
 	
-	// have now filled the entire width of the dest. bitmap, to a height of 'height'. tile downwards...
+	for (; x + 7 <= x2; x += 8)
+	{
+		the_mask_row[x >> 3] = 0xFF;
+	}
 	
-	v_tiles = dst_bm->height_ / height;
-	v_rem = dst_bm->height_ % height;
+	for (; x <= x2; x++)
+	{
+		the_mask_row[x >> 3] |= (0x80 >> (x & 7));
+	}
+}
 
-	//DEBUG_OUT(("%s %d: h_tiles=%i, h_rem=%i, v_tiles=%i, v_rem=%i", __func__, __LINE__, h_tiles, h_rem, v_tiles, v_rem));
 
-	// now we are reading from the destination bitmap, from the area we prepared. 
-	// we will keep reading the same blob over and over again, so read loc is now permanent.
+//! Find every run of open pixels that overlaps the span, fill it, and queue the rows above and below it
+void Bitmap_FillScanSpan(BitmapFillJob* the_job, BitmapFillSpan* the_span)
+{
+	uint8_t*	the_row;
+	int16_t		y = the_span->y_;
+	int16_t		x = the_span->x1_;
+	int16_t		run_start;
+	int16_t		run_end;
+	int16_t		max_col = the_job->bitmap_->width_ - 1;
+	int16_t		spread = the_job->spread_;
+	int16_t		dy = the_span->dy_;
+	
+	// LOGIC:
+	//   a span was queued from a run on the row it came from (y - dy), widened by the spread. everything on that row within the span 
+	//     was either part of the run, or the pixel just past its end: none of it can be open. so each run found here only has to be
+	//     queued back toward that row where it pokes out past the span. without this, a fill up a 1 pixel wide corridor would
+	//     queue a useless span behind it for every row it climbed.
 	
-	uint32_t write_size = dst_bm->width_ * height;
-	the_write_loc = dst_bm->addr_ + (dst_bm->width_ * height * 1); // right after the first band of tile
+	the_row = the_job->bitmap_->addr_ + (uint32_t)y * (uint32_t)the_job->bitmap_->width_;
 	
-	// each loop is horizontal band of tiles running full length of target bitmap, writing top to bottom, from 2nd vertical band
-	for (j = 1; j < v_tiles; j++)	 // 1 because we just wrote one band worth's above.
+	while (x <= the_span->x2_)
 	{
-		the_read_loc = dst_bm->addr_;
+		if (Bitmap_FillPixelIsOpen(the_job, the_row, y, x) == false)
+		{
+			++x;
+			continue;
+		}
+		
+		// a run can start to the left of the span and end to the right of it: extend it both ways as far as it goes
+		run_start = x;
+		
+		while (run_start > 0 && Bitmap_FillPixelIsOpen(the_job, the_row, y, run_start - 1))
+		{
+			--run_start;
+		}
+		
+		run_end = x;
+		
+		while (run_end < max_col && Bitmap_FillPixelIsOpen(the_job, the_row, y, run_end + 1))
+		{
+			++run_end;
+		}
 		
-		for (bytes = 0; bytes < write_size; bytes++)
+		Bitmap_FillRun(the_job, the_row, y, run_start, run_end);
+		
+		if (dy == 0)
+		{
+			Bitmap_FillQueuePush(the_job, y - 1, run_start - spread, run_end + spread, -1);
+			Bitmap_FillQueuePush(the_job, y + 1, run_start - spread, run_end + spread, 1);
+		}
+		else
 		{
-			*the_write_loc++ = *the_read_loc++;
+			if (run_start - spread < the_span->x1_)
+			{
+				Bitmap_FillQueuePush(the_job, y - dy, run_start - spread, the_span->x1_ - 1, -dy);
+			}
+			
+			if (run_end + spread > the_span->x2_)
+			{
+				Bitmap_FillQueuePush(the_job, y - dy, the_span->x2_ + 1, run_end + spread, -dy);
+			}
+			
+			Bitmap_FillQueuePush(the_job, y + dy, run_start - spread, run_end + spread, dy);
 		}
-// 		memcpy(the_write_loc, the_read_loc, write_size);
-// 	
-// 		the_write_loc += write_size;
+		
+		// the pixel after the run is not open, so skip it too
+		x = run_end + 2;
 	}
+}
+
+
+//! After the queue overflowed: look over the whole bitmap for open pixels next to filled ones, and queue them again
+void Bitmap_FillRescan(BitmapFillJob* the_job)
+{
+	uint8_t*	the_row;
+	uint8_t*	the_mask_row;
+	int16_t		x;
+	int16_t		y;
+	int16_t		check_x;
+	int16_t		check_y;
+	int16_t		width = the_job->bitmap_->width_;
+	int16_t		height = the_job->bitmap_->height_;
+	bool		next_to_done;
 	
-	// the last tile, if any, will have less height
-	if (v_rem)
+	// LOGIC:
+	//   every run is always extended as far as it goes, so a pixel that still needs filling can only be found next to a filled pixel 
+	//     on the row above or below. queue the first such pixel of each open run; scanning that span will fill the whole run.
+	
+	for (y = 0; y < height; y++)
 	{
-		height = v_rem;
-		write_size = dst_bm->width_ * height;
-		the_read_loc = dst_bm->addr_;
+		the_row = the_job->bitmap_->addr_ + (uint32_t)y * (uint32_t)width;
+		x = 0;
 		
-// 		memcpy(the_write_loc, the_read_loc, write_size);
-		for (bytes = 0; bytes < write_size; bytes++)
+		while (x < width)
 		{
-			*the_write_loc++ = *the_read_loc++;
+			if (Bitmap_FillPixelIsOpen(the_job, the_row, y, x) == false)
+			{
+				++x;
+				continue;
+			}
+			
+			next_to_done = false;
+			
+			for (check_y = y - 1; check_y <= y + 1 && next_to_done == false; check_y += 2)
+			{
+				if (check_y < 0 || check_y >= height)
+				{
+					continue;
+				}
+				
+				the_mask_row = the_job->done_mask_ + (uint32_t)check_y * (uint32_t)the_job->mask_row_bytes_;
+				
+				for (check_x = x - the_job->spread_; check_x <= x + the_job->spread_; check_x++)
+				{
+					if (check_x >= 0 && check_x < width && (the_mask_row[check_x >> 3] & (0x80 >> (check_x & 7))) != 0)
+					{
+						next_to_done = true;
+						break;
+					}
+				}
+			}
+			
+			if (next_to_done)
+			{
+				// one seed is enough for this run: skip to the end of it
+				Bitmap_FillQueuePush(the_job, y, x, x, 0);
+				
+				while (x < width && Bitmap_FillPixelIsOpen(the_job, the_row, y, x))
+				{
+					++x;
+				}
+			}
+			else
+			{
+				++x;
+			}
 		}
 	}
-	
-	//DEBUG_OUT(("%s %d: final parameters: src_x=%i, src_y=%i, width=%i, height=%i.", __func__, __LINE__, src_x, src_y, width, height));
-	
-	return true;
 }
 
 
-//! Tile the source bitmap into the destination bitmap, filling it
-//! The source and destination bitmaps can be the same: you can use this to copy a chunk of pixels from one part of a screen to another. If the destination location cannot fit the entirety of the copied rectangle, the copy will be truncated, but will not return an error. 
-//! @param	src_bm -- the source bitmap. It must have a valid address within the VRAM memory space.
-//! @param	dst_bm -- the destination bitmap. It must have a valid address within the VRAM memory space. It can be the same bitmap as the source.
-//! @param	src_x -- the upper left coordinate within the source bitmap, for the tile you want to copy. Must be non-negative.
-//! @param	src_y -- the upper left coordinate within the source bitmap, for the tile you want to copy. Must be non-negative.
-//! @param	width -- the size of the tile to be derived from the source bitmap, in pixels.
-//! @param	height -- the size of the tile to be derived from the source bitmap, in pixels.
-bool Bitmap_Tile(Bitmap* src_bm, int16_t src_x, int16_t src_y, Bitmap* dst_bm, int16_t width, int16_t height)
+
+//! Validate the bitmaps passed to a blit function, and clip the copy rectangle against both of them
+//! On return, the coordinates and width/height have been adjusted so that the whole rect is within both bitmaps
+//! @return	Returns false if either bitmap is invalid, or if no part of the rectangle is within both bitmaps
+bool Bitmap_ClipBlitRect(Bitmap* src_bm, int16_t* src_x, int16_t* src_y, Bitmap* dst_bm, int16_t* dst_x, int16_t* dst_y, int16_t* width, int16_t* height)
 {
-	unsigned char*		the_starting_read_loc;
-	unsigned char*		the_read_loc;
-	unsigned char*		the_write_loc;
-	int16_t				i;
-	int16_t				h_tiles;
-	int16_t				h_rem;
-	int16_t				v_tiles;
-	int16_t				v_rem;
-	int16_t				j;
-	
-	
-	// TODO: move the 2 checks below to a private common function if other blit functions are added
-	
 	if (src_bm == NULL || dst_bm == NULL)
 	{
 		LOG_ERR(("%s %d: passed source or destination bitmap was NULL", __func__, __LINE__));
@@ -731,351 +915,899 @@ bool Bitmap_Tile(Bitmap* src_bm, int16_t src_x, int16_t src_y, Bitmap* dst_bm, i
 	}
 	
 	// LOGIC:
-	//   The entire width and height of the tile must be within the source bitmap. 
+	//   Clip the copy rectangle against both bitmaps. A negative or too-large starting location is fine
+	//   as long as some part of the rectangle is within both the source and the target.
+	//   Any clipping applied on one side moves the other side by the same amount, so pixels stay registered.
 	
-	if (src_x < 0 || src_x + width > src_bm->width_ || src_y < 0 || src_y + height > src_bm->height_)
+	if (*src_x < 0)
 	{
-		LOG_INFO(("%s %d: Tile operations require the entire height and width of the tile to be defined within the bounds of the source bitmap. No tiling performed. src_x=%i, src_y=%i, width=%i, height=%i.", __func__, __LINE__, src_x, src_y, width, height));
-		return false;
+		*width += *src_x;
+		*dst_x -= *src_x;
+		*src_x = 0;
+	}
+
+	if (*src_y < 0)
+	{
+		*height += *src_y;
+		*dst_y -= *src_y;
+		*src_y = 0;
+	}
+
+	if (*dst_x < 0)
+	{
+		*width += *dst_x;
+		*src_x -= *dst_x;
+		*dst_x = 0;
+	}
+
+	if (*dst_y < 0)
+	{
+		*height += *dst_y;
+		*src_y -= *dst_y;
+		*dst_y = 0;
 	}
 
-	//DEBUG_OUT(("%s %d: starting parameters: src_x=%i, src_y=%i, width=%i, height=%i.", __func__, __LINE__, src_x, src_y, width, height));
-	//DEBUG_OUT(("%s %d: dst_bm=%p, dst_bm=%p", __func__, __LINE__, src_bm, dst_bm));
+	// adjust copy width/height if the whole image wouldn't fit on target bitmap anyway, or reads past the edge of the source
+	*width = (*dst_x + *width > dst_bm->width_) ? dst_bm->width_ - *dst_x : *width;
+	*height = (*dst_y + *height > dst_bm->height_) ? dst_bm->height_ - *dst_y : *height;
+	*width = (*src_x + *width > src_bm->width_) ? src_bm->width_ - *src_x : *width;
+	*height = (*src_y + *height > src_bm->height_) ? src_bm->height_ - *src_y : *height;
 	
-	// LOGIC:
-	//   Unlike a blit operation, a tile operation always starts in the upper left corner of the target bitmap, and fills it entirely
-	//   As an optimization, each row of one tile worth will be copied to the right to fill one horizontal row of the dest. bitmap
-	//   From that point, will loop through the required number of remaining bands, copying the full width of the dest bitmap.
+	if (*width <= 0 || *height <= 0)
+	{
+		LOG_INFO(("%s %d: No part of the copy rectangle was on both source and target. No copy performed. src_x=%i, src_y=%i, dst_x=%i, dst_y=%i, width=%i, height=%i.", __func__, __LINE__, *src_x, *src_y, *dst_x, *dst_y, *width, *height));
+		return false;
+	}
 	
-	// adjust copy width/height if the prescribed tile height or width wouldn't fit on target bitmap
-	width = (width >= dst_bm->width_) ? dst_bm->width_ : width;
-	height = (height >= dst_bm->height_) ? dst_bm->height_ : height;
+	return true;
+}
 
-	// checks complete. ready to tile. 
-	the_starting_read_loc = src_bm->addr_ + (src_bm->width_ * src_y) + src_x;
+
+//! Copy len bytes from src to dst, front to back, moving the mutually-aligned middle of the span as 32-bit longs
+//! Safe for overlapping spans only when dst is lower in memory than src.
+//! NO VALIDATION PERFORMED ON PARAMETERS. CALLING METHOD MUST VALIDATE.
+void Bitmap_CopySpanForward(uint8_t* dst, uint8_t* src, uint32_t len)
+{
+	uint32_t*	dst_long;
+	uint32_t*	src_long;
+	uint16_t*	dst_word;
+	uint16_t*	src_word;
+	uint32_t	num_longs;
 	
-	h_tiles = dst_bm->width_ / width;
-	h_rem = dst_bm->width_ % width;
+	// LOGIC:
+	//   Longs can only be used if src and dst share the same alignment (mod 4). If they do, copy bytes until both are aligned,
+	//   then move the middle 16 bytes at a time, then the remaining longs, then the tail bytes.
+	//   If they only share word alignment, do the same with 16-bit words. Otherwise, fall back to bytes.
+	//   Short spans (eg, a narrow control or a few pixels of a title bar) aren't worth the setup, so they go straight to bytes.
 	
-	// first loop is to create 1 pixel row worth extending across the entire target bitmap
-	// and loop that for each row in the source tile
-	for (i = 0; i < height; i++)
+	if (len >= 8 && (((uint32_t)dst ^ (uint32_t)src) & 0x03) == 0)
 	{
-		the_read_loc = the_starting_read_loc + src_bm->width_ * i;
-		the_write_loc = dst_bm->addr_ + dst_bm->width_ * i; // x=0, row = i
-
-		for (j = 0; j < h_tiles; j++)
+		while ((uint32_t)dst & 0x03)
 		{
-			memcpy(the_write_loc, the_read_loc, width);
-	
-			the_write_loc += width;
+			*dst++ = *src++;
+			len--;
 		}
 		
-		// the last horizontal span, if any, will have less width
-		if (h_rem)
+		dst_long = (uint32_t*)dst;
+		src_long = (uint32_t*)src;
+		num_longs = len >> 2;
+		len &= 0x03;
+		
+		while (num_longs >= 4)
 		{
-			memcpy(the_write_loc, the_read_loc, h_rem);
+			*dst_long++ = *src_long++;
+			*dst_long++ = *src_long++;
+			*dst_long++ = *src_long++;
+			*dst_long++ = *src_long++;
+			num_longs -= 4;
 		}
-	}		
-	
-	
-	// have now filled the entire width of the dest. bitmap, to a height of 'height'. tile downwards...
-	
-	v_tiles = dst_bm->height_ / height;
-	v_rem = dst_bm->height_ % height;
-
-	//DEBUG_OUT(("%s %d: h_tiles=%i, h_rem=%i, v_tiles=%i, v_rem=%i", __func__, __LINE__, h_tiles, h_rem, v_tiles, v_rem));
-
-	// now we are reading from the destination bitmap, from the area we prepared. 
-	// we will keep reading the same blob over and over again, so read loc is now permanent.
-	the_read_loc = dst_bm->addr_;
-	
-	uint32_t write_size = dst_bm->width_ * height;
-	the_write_loc = dst_bm->addr_ + (dst_bm->width_ * height * 1); // right after the first band of tile
-	
-	// each loop is horizontal band of tiles running full length of target bitmap, writing top to bottom, from 2nd vertical band
-	for (j = 1; j < v_tiles; j++)	 // 1 because we just wrote one band worth's above.
-	{
-		memcpy(the_write_loc, the_read_loc, write_size);
-	
-		the_write_loc += write_size;
+		
+		while (num_longs--)
+		{
+			*dst_long++ = *src_long++;
+		}
+		
+		dst = (uint8_t*)dst_long;
+		src = (uint8_t*)src_long;
 	}
-	
-	// the last tile, if any, will have less height
-	if (v_rem)
+	else if (len >= 8 && (((uint32_t)dst ^ (uint32_t)src) & 0x01) == 0)
 	{
-		height = v_rem;
-		write_size = dst_bm->width_ * height;
+		if ((uint32_t)dst & 0x01)
+		{
+			*dst++ = *src++;
+			len--;
+		}
+		
+		dst_word = (uint16_t*)dst;
+		src_word = (uint16_t*)src;
+		num_longs = len >> 1;	// (actually words)
+		len &= 0x01;
 		
-		memcpy(the_write_loc, the_read_loc, write_size);
+		while (num_longs--)
+		{
+			*dst_word++ = *src_word++;
+		}
+		
+		dst = (uint8_t*)dst_word;
+		src = (uint8_t*)src_word;
 	}
 	
-	//DEBUG_OUT(("%s %d: final parameters: src_x=%i, src_y=%i, width=%i, height=%i.", __func__, __LINE__, src_x, src_y, width, height));
-	
-	return true;
+	while (len--)
+	{
+		*dst++ = *src++;
+	}
 }
 
 
-//! Tile the source bitmap into the destination bitmap, filling it
-//! The source and destination bitmaps can be the same: you can use this to copy a chunk of pixels from one part of a screen to another. If the destination location cannot fit the entirety of the copied rectangle, the copy will be truncated, but will not return an error. 
-//! @param	src_bm -- the source bitmap. It must have a valid address within the VRAM memory space.
-//! @param	dst_bm -- the destination bitmap. It must have a valid address within the VRAM memory space. It can be the same bitmap as the source.
-//! @param	src_x -- the upper left coordinate within the source bitmap, for the tile you want to copy. Must be non-negative.
-//! @param	src_y -- the upper left coordinate within the source bitmap, for the tile you want to copy. Must be non-negative.
-//! @param	width -- the size of the tile to be derived from the source bitmap, in pixels.
-//! @param	height -- the size of the tile to be derived from the source bitmap, in pixels.
-bool Bitmap_TileV2(Bitmap* src_bm, int16_t src_x, int16_t src_y, Bitmap* dst_bm, int16_t width, int16_t height)
+//! Copy len bytes from src to dst, back to front, moving the mutually-aligned middle of the span as 32-bit longs
+//! Use when dst is higher in memory than src and the spans may overlap.
+//! NO VALIDATION PERFORMED ON PARAMETERS. CALLING METHOD MUST VALIDATE.
+void Bitmap_CopySpanBackward(uint8_t* dst, uint8_t* src, uint32_t len)
 {
-	unsigned char*		the_starting_read_loc;
-	unsigned char*		the_read_loc;
-	unsigned char*		the_write_loc;
-	int16_t				i;
-	int16_t				h_tiles;
-	int16_t				h_rem;
-	int16_t				v_tiles;
-	int16_t				v_rem;
-	int16_t				j;
+	uint32_t*	dst_long;
+	uint32_t*	src_long;
+	uint16_t*	dst_word;
+	uint16_t*	src_word;
+	uint32_t	num_longs;
 	
+	// LOGIC:
+	//   Mirror image of Bitmap_CopySpanForward: start one past the end of each span and work down,
+	//   so that a destination overlapping the tail of the source never reads bytes it has already written.
 	
-	// TODO: move the 2 checks below to a private common function if other blit functions are added
-	
-	if (src_bm == NULL || dst_bm == NULL)
-	{
-		LOG_ERR(("%s %d: passed source or destination bitmap was NULL", __func__, __LINE__));
-		return false;
-	}
+	dst += len;
+	src += len;
 	
-	if (src_bm->addr_ == NULL || dst_bm->addr_ == NULL)
+	if (len >= 8 && (((uint32_t)dst ^ (uint32_t)src) & 0x03) == 0)
 	{
-		LOG_ERR(("%s %d: passed source or destination bitmap had a NULL address", __func__, __LINE__));
-		return false;
+		while ((uint32_t)dst & 0x03)
+		{
+			*--dst = *--src;
+			len--;
+		}
+		
+		dst_long = (uint32_t*)dst;
+		src_long = (uint32_t*)src;
+		num_longs = len >> 2;
+		len &= 0x03;
+		
+		while (num_longs >= 4)
+		{
+			*--dst_long = *--src_long;
+			*--dst_long = *--src_long;
+			*--dst_long = *--src_long;
+			*--dst_long = *--src_long;
+			num_longs -= 4;
+		}
+		
+		while (num_longs--)
+		{
+			*--dst_long = *--src_long;
+		}
+		
+		dst = (uint8_t*)dst_long;
+		src = (uint8_t*)src_long;
+	}
+	else if (len >= 8 && (((uint32_t)dst ^ (uint32_t)src) & 0x01) == 0)
+	{
+		if ((uint32_t)dst & 0x01)
+		{
+			*--dst = *--src;
+			len--;
+		}
+		
+		dst_word = (uint16_t*)dst;
+		src_word = (uint16_t*)src;
+		num_longs = len >> 1;	// (actually words)
+		len &= 0x01;
+		
+		while (num_longs--)
+		{
+			*--dst_word = *--src_word;
+		}
+		
+		dst = (uint8_t*)dst_word;
+		src = (uint8_t*)src_word;
 	}
 	
-	// LOGIC:
-	//   The entire width and height of the tile must be within the source bitmap. 
-	
-	if (src_x < 0 || src_x + width > src_bm->width_ || src_y < 0 || src_y + height > src_bm->height_)
+	while (len--)
 	{
-		LOG_INFO(("%s %d: Tile operations require the entire height and width of the tile to be defined within the bounds of the source bitmap. No tiling performed. src_x=%i, src_y=%i, width=%i, height=%i.", __func__, __LINE__, src_x, src_y, width, height));
-		return false;
+		*--dst = *--src;
 	}
+}
+
+
+// **** Debug functions *****
+
+void Bitmap_Print(Bitmap* the_bitmap)
+{
+	DEBUG_OUT(("Bitmap print out:"));
+	DEBUG_OUT(("  address: %p",			the_bitmap));
+	DEBUG_OUT(("  width_: %i",			the_bitmap->width_));	
+	DEBUG_OUT(("  height_: %i",			the_bitmap->height_));	
+	DEBUG_OUT(("  x_: %i",				the_bitmap->x_));	
+	DEBUG_OUT(("  y_: %i",				the_bitmap->y_));	
+	DEBUG_OUT(("  color_: %u",			the_bitmap->color_));	
+	DEBUG_OUT(("  reserved_: %u",		the_bitmap->reserved_));	
+	DEBUG_OUT(("  font_: %p",			the_bitmap->font_));	
+	DEBUG_OUT(("  addr_: %p",			the_bitmap->addr_));
+	DEBUG_OUT(("  addr_int_: %lx",		the_bitmap->addr_int_));
+}
+
+//! \endcond
+
 
-	//DEBUG_OUT(("%s %d: starting parameters: src_x=%i, src_y=%i, width=%i, height=%i.", __func__, __LINE__, src_x, src_y, width, height));
-	//DEBUG_OUT(("%s %d: dst_bm=%p, dst_bm=%p", __func__, __LINE__, src_bm, dst_bm));
+
+/*****************************************************************************/
+/*                        Public Function Definitions                        */
+/*****************************************************************************/
+
+// **** CONSTRUCTOR AND DESTRUCTOR *****
+
+// constructor
+
+//! Create a new bitmap object by allocating space for the bitmap struct in regular memory, and for the graphics, in VRAM or regular memory
+//! NOTE: when creating a bitmap to represent something at a fixed place in VRAM, pass PARAM_IN_VRAM, and manually assign a known VRAM location afterwards.
+//! NOTE: the address of a bitmap created with PARAM_PREFER_VRAM can change whenever another VRAM bitmap is allocated (the VRAM heap may compact itself). Don't keep a copy of it.
+//! @param	width -- width, in pixels, of the bitmap to be created
+//! @param	height -- height, in pixels, of the bitmap to be created
+//! @param	the_font -- optional font object to associate with the Bitmap. 
+//! @param	vram_mode -- PARAM_NOT_IN_VRAM to allocate width * height bytes of standard memory; PARAM_PREFER_VRAM to allocate them from the VRAM heap if it has room, or standard memory if not; PARAM_IN_VRAM to allocate no space for the graphics.
+Bitmap* Bitmap_New(int16_t width, int16_t height, Font* the_font, uint8_t vram_mode)
+{
+	Bitmap*		the_bitmap = NULL;
+
+	//DEBUG_OUT(("%s %d: start bitmap creation... (%i x %i, %p)", __func__, __LINE__, width, height, the_font));
+
+	// check width/height for some maximum??
+	// TODO
+	if ( (width < 2 || width > VICKY_BITMAP_MAX_H_RES) || (height < 2 || height > VICKY_BITMAP_MAX_V_RES) )
+	{
+		LOG_ERR(("%s %d: Illegal width (%i) and/or height (%i)", __func__, __LINE__, width, height));
+		goto error;
+	}
+
+	//DEBUG_OUT(("%s %d: allocating struct in normal memory...", __func__, __LINE__));
 	
 	// LOGIC:
-	//   Unlike a blit operation, a tile operation always starts in the upper left corner of the target bitmap, and fills it entirely
-	//   As an optimization, each row of one tile worth will be copied to the right to fill one horizontal row of the dest. bitmap
-	//   From that point, will loop through the required number of remaining bands, copying the full width of the dest bitmap.
+	//   we have 2 kinds of memory: VRAM and standard RAM
+	//   A bitmap object needs a struct which can and should be allocated in normal memory
+	//   If the bitmap actually represents something on the screen, it needs to point to VRAM, not normal memory
+	//   Off-screen buffers (windows, menus) can also live in VRAM, in the VRAM heap: the part of VRAM the screen layers don't use
+	//   The struct comes from the bitmap pool, and pixel storage in normal memory comes from the buffer arena, so that
+	//     opening and closing windows doesn't leave the heap in pieces
 	
-	// adjust copy width/height if the prescribed tile height or width wouldn't fit on target bitmap
-	width = (width >= dst_bm->width_) ? dst_bm->width_ : width;
-	height = (height >= dst_bm->height_) ? dst_bm->height_ : height;
+	if ((the_bitmap = (Bitmap*)Pool_Alloc(&bitmap_pool)) == NULL)
+	{
+		LOG_ERR(("%s %d: Couldn't allocate space for bitmap struc", __func__, __LINE__));
+		goto error;
+	}
+	LOG_ALLOC(("%s %d:	__ALLOC__	the_bitmap struct	%p	size	%i", __func__ , __LINE__, the_bitmap, sizeof(Bitmap)));
+	TRACK_ALLOC((sizeof(Bitmap)));
 
-	// checks complete. ready to tile. 
-	the_starting_read_loc = src_bm->addr_ + (src_bm->width_ * src_y) + src_x;
-	
-	h_tiles = dst_bm->width_ / width;
-	h_rem = dst_bm->width_ % width;
+	if (vram_mode == PARAM_PREFER_VRAM)
+	{
+		if (Vram_Alloc(the_bitmap, (uint32_t)width * height) == true)
+		{
+			memset(the_bitmap->addr_, 0, (uint32_t)width * height);
+			the_bitmap->vram_block_ = true;
+			the_bitmap->capacity_ = (uint32_t)width * height;
+		}
+		else
+		{
+			// VRAM heap is full (or not set up): fall through to standard RAM
+			DEBUG_OUT(("%s %d: no VRAM for %i x %i bitmap; using standard RAM", __func__, __LINE__, width, height));
+			vram_mode = PARAM_NOT_IN_VRAM;
+		}
+	}
 	
-	// first loop is to create 1 pixel row worth extending across the entire target bitmap
-	// and loop that for each row in the source tile
-	for (i = 0; i < height; i++)
+	if (vram_mode == PARAM_NOT_IN_VRAM)
 	{
-		the_read_loc = the_starting_read_loc + src_bm->width_ * i;
-		the_write_loc = dst_bm->addr_ + dst_bm->width_ * i; // x=0, row = i
+		//DEBUG_OUT(("%s %d: Allocating a screen-sized bitmap in standard RAM...", __func__, __LINE__));
 
-		for (j = 0; j < h_tiles; j++)
+		if ((the_bitmap->addr_ = (unsigned char*)Pool_ArenaAlloc((uint32_t)width * height)) == NULL)
 		{
-			memcpy(the_write_loc, the_read_loc, width);
-	
-			the_write_loc += width;
+			LOG_ERR(("%s %d: Couldn't instantiate a bitmap", __func__, __LINE__));
+			goto error;
 		}
+		LOG_ALLOC(("%s %d:	__ALLOC__	the_bitmap data	%p	size	%i", __func__ , __LINE__, the_bitmap, sizeof(uint8_t) * width * height));
+		TRACK_ALLOC((sizeof(uint8_t) * width * height));
 		
-		// the last horizontal span, if any, will have less width
-		if (h_rem)
+		the_bitmap->addr_int_ = (uint32_t)the_bitmap->addr_;
+		the_bitmap->capacity_ = (uint32_t)width * height;
+	}
+	else if (vram_mode == PARAM_IN_VRAM)
+	{
+		the_bitmap->addr_ = NULL;
+		the_bitmap->addr_int_ = 0;
+	}
+
+	the_bitmap->width_ = width;
+	the_bitmap->height_ = height;
+	the_bitmap->in_vram_ = (vram_mode != PARAM_NOT_IN_VRAM);
+	
+	//DEBUG_OUT(("%s %d: Bitmap allocated! p=%p, addr=%p, width=%i, height=%i", __func__, __LINE__, the_bitmap, the_bitmap->addr_, the_bitmap->width_, the_bitmap->height_));
+
+	if (the_font)
+	{
+		if (Bitmap_SetFont(the_bitmap, the_font) == false)
 		{
-			memcpy(the_write_loc, the_read_loc, h_rem);
+			LOG_ERR(("%s %d: Couldn't assign the font to the bitmap", __func__, __LINE__));
+			goto error;
 		}
-	}		
-	
+	}
+		
+	//Bitmap_Print(the_bitmap);
 	
-	// have now filled the entire width of the dest. bitmap, to a height of 'height'. tile downwards...
+	return the_bitmap;
 	
-	v_tiles = dst_bm->height_ / height;
-	v_rem = dst_bm->height_ % height;
+error:
+	if (the_bitmap)		Bitmap_Destroy(&the_bitmap);
+	return NULL;
+}
+
+
+// destructor
+// frees all allocated memory associated with the passed object, and the object itself
+bool Bitmap_Destroy(Bitmap** the_bitmap)
+{
+	if (*the_bitmap == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		return false;
+	}
 
-	//DEBUG_OUT(("%s %d: h_tiles=%i, h_rem=%i, v_tiles=%i, v_rem=%i", __func__, __LINE__, h_tiles, h_rem, v_tiles, v_rem));
+	// LOGIC: 
+	//   Bitmaps optionally have fonts associated with them.
+	//   We do not want to destroy these, because other objects could be using them.
+	//   TODO: notify the system that we are no longer using this font (system needs to be tallying usage count for that to work)
 	
-	// each loop is one tile, writing top to bottom, from 2nd vertical band
-	for (j = 1; j < v_tiles; j++)	 // 1 because we just wrote one band worth's above.
+	if ((*the_bitmap)->font_)
 	{
-		the_read_loc = dst_bm->addr_; // now we are reading from the destination bitmap, from the area we prepared
-		the_write_loc = dst_bm->addr_ + (dst_bm->width_ * height * j);
-		
-		for (i = 0; i < height; i++)
+		(*the_bitmap)->font_ = NULL;
+	}
+
+	if ((*the_bitmap)->vram_block_)
+	{
+		Vram_Free(*the_bitmap);
+	}
+	else if ((*the_bitmap)->addr_)
+	{
+		if ((*the_bitmap)->in_vram_ == false)
 		{
-			memcpy(the_write_loc, the_read_loc, dst_bm->width_);
-		
-			the_write_loc += dst_bm->width_;
-			the_read_loc += dst_bm->width_;
-		}		
+			LOG_ALLOC(("%s %d:	__FREE__	the_bitmap->addr_	%p	size	%lu", __func__ , __LINE__, (*the_bitmap)->addr_, (*the_bitmap)->capacity_));
+			TRACK_ALLOC((0 - (*the_bitmap)->capacity_));
+			Pool_ArenaFree((*the_bitmap)->addr_);
+		}
 	}
+
+	LOG_ALLOC(("%s %d:	__FREE__	*the_bitmap	%p	size	%i", __func__ , __LINE__, *the_bitmap, sizeof(Bitmap)));
+	TRACK_ALLOC((0 - sizeof(Bitmap)));
+	Pool_Free(&bitmap_pool, *the_bitmap);
+	*the_bitmap = NULL;
+	
+	return true;
+}
+
+
+//! Resize and existing bitmap by setting new width/height and allocating bigger storage if necessary
+//! NOTE: if the bitmap is at a fixed VRAM address, storage will not be reallocated. If it is in the VRAM heap and needs more space, it gets a new VRAM block, or moves to standard memory if VRAM is full.
+//! NOTE: if the new size for the bitmap is smaller than the previous size, storage will not be reallocated - extra bytes will simply not be used
+//! @param	width -- the new width, in pixels, to resize the bitmap to
+//! @param	height -- the new height, in pixels, to resize the bitmap to
+//! @return	Returns false in any error condition
+bool Bitmap_Resize(Bitmap* the_bitmap, int16_t width, int16_t height)
+{
+	unsigned char*	new_addr;
+	uint32_t		old_size;
+	uint32_t		new_size;
+	uint32_t		new_capacity;
+	int16_t			keep_width;
+	int16_t			keep_height;
 	
-	// the last tile, if any, will have less height
-	if (v_rem)
+	if (the_bitmap == NULL)
 	{
-		the_read_loc = dst_bm->addr_; // now we are reading from the destination bitmap, from the area we prepared
-		the_write_loc = dst_bm->addr_ + (dst_bm->width_ * height * j);
-		height = v_rem;
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		return false;
+	}
 
-		for (i = 0; i < height; i++)
+	DEBUG_OUT(("%s %d: start bitmap resizing; old = %i x %i; new=%i x %i", __func__, __LINE__, the_bitmap->width_, the_bitmap->height_, width, height));
+
+	old_size = (uint32_t)the_bitmap->width_ * the_bitmap->height_;
+	new_size = (uint32_t)width * height;
+	keep_width = (width < the_bitmap->width_ ? width : the_bitmap->width_);
+	keep_height = (height < the_bitmap->height_ ? height : the_bitmap->height_);
+	
+	// LOGIC:
+	//   a bitmap at a fixed VRAM address is never reallocated. the backdrop shares the same bitmap as the screen, and that never moves.
+	//   otherwise, the pixels the old and new sizes share are kept, so a resized window only has to draw what's new.
+	//     the row length is the width, so if the width changed, the kept rows have to be slid to their new start.
+	//   storage is only reallocated when the new size is more than the capacity. if it got smaller, the extra space is kept for later.
+	//     when it does grow, it grows with headroom, so dragging a window's size doesn't reallocate (and copy) on every step.
+	
+	if (the_bitmap->in_vram_ == true && the_bitmap->vram_block_ == false)
+	{
+		the_bitmap->width_ = width;
+		the_bitmap->height_ = height;
+		return true;
+	}
+	
+	if (new_size <= the_bitmap->capacity_)
+	{
+		Bitmap_CopyRows(the_bitmap->addr_, width, the_bitmap->addr_, the_bitmap->width_, keep_width, keep_height);
+	}
+	else
+	{
+		new_capacity = new_size + new_size / BITMAP_RESIZE_HEADROOM;
+		
+		if (the_bitmap->vram_block_ && Vram_Resize(the_bitmap, new_capacity, old_size) == true)
+		{
+			Bitmap_CopyRows(the_bitmap->addr_, width, the_bitmap->addr_, the_bitmap->width_, keep_width, keep_height);
+		}
+		else
 		{
-			memcpy(the_write_loc, the_read_loc, dst_bm->width_);
+			// RAM bitmap, or VRAM is too full now: the bitmap gets (or moves to) standard RAM
+			if ((new_addr = (unsigned char*)Pool_ArenaAlloc(new_capacity)) == NULL)
+			{
+				LOG_ERR(("%s %d: Couldn't instantiate a bitmap", __func__, __LINE__));
+				return false;
+			}
+			LOG_ALLOC(("%s %d:	__ALLOC__	the_bitmap->addr_	%p	size	%lu", __func__ , __LINE__, new_addr, new_capacity));
+			TRACK_ALLOC((new_capacity));
+			
+			Bitmap_CopyRows(new_addr, width, the_bitmap->addr_, the_bitmap->width_, keep_width, keep_height);
+			
+			if (the_bitmap->vram_block_)
+			{
+				Vram_Free(the_bitmap);
+				the_bitmap->vram_block_ = false;
+				the_bitmap->in_vram_ = false;
+			}
+			else
+			{
+				LOG_ALLOC(("%s %d:	__FREE__	the_bitmap->addr_	%p	size	%lu", __func__ , __LINE__, the_bitmap->addr_, the_bitmap->capacity_));
+				TRACK_ALLOC((0 - the_bitmap->capacity_));
+				Pool_ArenaFree(the_bitmap->addr_);
+			}
+			
+			the_bitmap->addr_ = new_addr;
+			the_bitmap->addr_int_ = (uint32_t)new_addr;
+		}
 		
-			the_write_loc += dst_bm->width_;
-			the_read_loc += dst_bm->width_;
-		}		
+		the_bitmap->capacity_ = new_capacity;
 	}
 	
-	//DEBUG_OUT(("%s %d: final parameters: src_x=%i, src_y=%i, width=%i, height=%i.", __func__, __LINE__, src_x, src_y, width, height));
+	the_bitmap->width_ = width;
+	the_bitmap->height_ = height;
 	
 	return true;
 }
 
 
-//! Tile the source bitmap into the destination bitmap, filling it
+
+
+// **** Block copy functions ****
+
+//! Blit a rect from source bitmap to distination bitmap
+//! This is a wrapper around Bitmap_Blit()
 //! The source and destination bitmaps can be the same: you can use this to copy a chunk of pixels from one part of a screen to another. If the destination location cannot fit the entirety of the copied rectangle, the copy will be truncated, but will not return an error. 
 //! @param	src_bm -- the source bitmap. It must have a valid address within the VRAM memory space.
 //! @param	dst_bm -- the destination bitmap. It must have a valid address within the VRAM memory space. It can be the same bitmap as the source.
-//! @param	src_x -- the upper left coordinate within the source bitmap, for the tile you want to copy. Must be non-negative.
-//! @param	src_y -- the upper left coordinate within the source bitmap, for the tile you want to copy. Must be non-negative.
-//! @param	width -- the size of the tile to be derived from the source bitmap, in pixels.
-//! @param	height -- the size of the tile to be derived from the source bitmap, in pixels.
-bool Bitmap_TileV1(Bitmap* src_bm, int16_t src_x, int16_t src_y, Bitmap* dst_bm, int16_t width, int16_t height)
+//! @param	src_rect -- the rectangle from the source bitmap to be blitted to the target bitmap
+//! @param	dst_x -- the location within the destination bitmap to copy pixels to. May be negative.
+//! @param	dst_y -- the location within the destination bitmap to copy pixels to. May be negative.
+bool Bitmap_BlitRect(Bitmap* src_bm, Rectangle* src_rect, Bitmap* dst_bm, int16_t dst_x, int16_t dst_y)
 {
-	unsigned char*		the_starting_read_loc;
-	unsigned char*		the_read_loc;
-	unsigned char*		the_write_loc;
-	int16_t				i;
-	int16_t				h_tiles;
-	int16_t				h_rem;
-	int16_t				v_tiles;
-	int16_t				v_rem;
-	int16_t				j;
+	int16_t	width;
+	int16_t	height;
 	
+	// LOGIC: validation checks will be done by Bitmap_Blit, no need to check them here too
 	
-	// TODO: move the 2 checks below to a private common function if other blit functions are added
+	width = src_rect->MaxX - src_rect->MinX + 1;
+	height = src_rect->MaxY - src_rect->MinY + 1;
+
+	//DEBUG_OUT(("%s %d: incoming parameters: MinX=%i, MinY=%i, MaxX=%i, MaxY=%i", __func__, __LINE__, src_rect->MinX, src_rect->MinY, src_rect->MaxX, src_rect->MaxY));
+	//DEBUG_OUT(("%s %d: final parameters: src_x=%i, src_y=%i, dst_x=%i, dst_y=%i, width=%i, height=%i.", __func__, __LINE__, src_rect->MinX, src_rect->MinY, dst_x, dst_y, width, height));
+	//DEBUG_OUT(("%s %d: src_bm=%p, dst_bm=%p", __func__, __LINE__, src_bm->addr_, dst_bm->addr_));
 	
-	if (src_bm == NULL || dst_bm == NULL)
+	return Bitmap_Blit(src_bm, src_rect->MinX, src_rect->MinY, dst_bm, dst_x, dst_y, width, height);
+}
+
+
+//! Blit from source bitmap to distination bitmap. 
+//! The source and destination bitmaps can be the same: you can use this to copy a chunk of pixels from one part of a screen to another. If the destination location cannot fit the entirety of the copied rectangle, the copy will be truncated, but will not return an error. 
+//! Overlapping source and destination rectangles are handled correctly, so a bitmap can be scrolled within itself.
+//! Rows are copied as 32-bit longs where source and destination alignment allows; copies spanning the full width of both bitmaps are done as one contiguous move.
+//! @param	src_bm -- the source bitmap. It must have a valid address within the VRAM memory space.
+//! @param	dst_bm -- the destination bitmap. It must have a valid address within the VRAM memory space. It can be the same bitmap as the source.
+//! @param	src_x -- the upper left coordinate within the source bitmap, for the rectangle you want to copy. May be negative.
+//! @param	src_y -- the upper left coordinate within the source bitmap, for the rectangle you want to copy. May be negative.
+//! @param	dst_x -- the location within the destination bitmap to copy pixels to. May be negative.
+//! @param	dst_y -- the location within the destination bitmap to copy pixels to. May be negative.
+//! @param	width -- the scope of the copy, in pixels.
+//! @param	height -- the scope of the copy, in pixels.
+bool Bitmap_Blit(Bitmap* src_bm, int16_t src_x, int16_t src_y, Bitmap* dst_bm, int16_t dst_x, int16_t dst_y, int16_t width, int16_t height)
+{
+	uint8_t*		the_write_loc;
+	uint8_t*		the_read_loc;
+	uint32_t		copy_size;
+	uint32_t		src_stride;
+	uint32_t		dst_stride;
+	int16_t			j;
+	
+	if (Bitmap_ClipBlitRect(src_bm, &src_x, &src_y, dst_bm, &dst_x, &dst_y, &width, &height) == false)
 	{
-		LOG_ERR(("%s %d: passed source or destination bitmap was NULL", __func__, __LINE__));
 		return false;
 	}
+
+	//DEBUG_OUT(("%s %d: final parameters: src_x=%i, src_y=%i, dst_x=%i, dst_y=%i, width=%i, height=%i.", __func__, __LINE__, src_x, src_y, dst_x, dst_y, width, height));
+
+	// checks complete. ready to copy.
+	copy_size = (uint32_t)width;
+	src_stride = (uint32_t)src_bm->width_;
+	dst_stride = (uint32_t)dst_bm->width_;
+	the_read_loc = (uint8_t*)(src_bm->addr_int_ + (src_stride * (uint32_t)src_y) + (uint32_t)src_x);
+	the_write_loc = (uint8_t*)(dst_bm->addr_int_ + (dst_stride * (uint32_t)dst_y) + (uint32_t)dst_x);
 	
-	if (src_bm->addr_ == NULL || dst_bm->addr_ == NULL)
+	// LOGIC:
+	//   If the copy covers entire rows of both bitmaps, the source and target are each one contiguous block: do one move.
+	//   Otherwise copy row by row. When the target is later in memory than the source (eg, scrolling a bitmap down or right within itself),
+	//   go bottom row first and copy each span back to front, so no source pixel is overwritten before it has been read.
+	//   Bitmaps that do not overlap can go either direction; forward is used as the normal case.
+	
+	if (copy_size == src_stride && copy_size == dst_stride)
 	{
-		LOG_ERR(("%s %d: passed source or destination bitmap had a NULL address", __func__, __LINE__));
-		return false;
+		copy_size *= (uint32_t)height;
+		
+		if (the_write_loc > the_read_loc)
+		{
+			Bitmap_CopySpanBackward(the_write_loc, the_read_loc, copy_size);
+		}
+		else
+		{
+			Bitmap_CopySpanForward(the_write_loc, the_read_loc, copy_size);
+		}
+		
+		return true;
 	}
 	
-	// LOGIC:
-	//   The entire width and height of the tile must be within the source bitmap. 
+	if (the_write_loc > the_read_loc)
+	{
+		the_read_loc += src_stride * (uint32_t)(height - 1);
+		the_write_loc += dst_stride * (uint32_t)(height - 1);
+		
+		for (j = 0; j < height; j++)
+		{
+			Bitmap_CopySpanBackward(the_write_loc, the_read_loc, copy_size);
+			the_write_loc -= dst_stride;
+			the_read_loc -= src_stride;
+		}
+	}
+	else
+	{
+		for (j = 0; j < height; j++)
+		{
+			Bitmap_CopySpanForward(the_write_loc, the_read_loc, copy_size);
+			the_write_loc += dst_stride;
+			the_read_loc += src_stride;
+		}
+	}
+
+	return true;
+}
+
+
+//! Blit from source bitmap to destination bitmap, skipping any source pixels that match the key color
+//! Works span by span: runs of key-colored pixels are skipped, runs of opaque pixels are copied as a block.
+//! Clipping works the same as Bitmap_Blit(). The source and destination rectangles must not overlap.
+//! @param	src_bm -- the source bitmap. It must have a valid address.
+//! @param	dst_bm -- the destination bitmap. It must have a valid address.
+//! @param	src_x -- the upper left coordinate within the source bitmap, for the rectangle you want to copy. May be negative.
+//! @param	src_y -- the upper left coordinate within the source bitmap, for the rectangle you want to copy. May be negative.
+//! @param	dst_x -- the location within the destination bitmap to copy pixels to. May be negative.
+//! @param	dst_y -- the location within the destination bitmap to copy pixels to. May be negative.
+//! @param	width -- the scope of the copy, in pixels.
+//! @param	height -- the scope of the copy, in pixels.
+//! @param	key_color -- the color LUT index that will be treated as transparent. Destination pixels under key-colored source pixels are left as they were.
+//! @return	Returns false if no part of the rectangle could be copied, or on any error condition
+bool Bitmap_BlitTransparent(Bitmap* src_bm, int16_t src_x, int16_t src_y, Bitmap* dst_bm, int16_t dst_x, int16_t dst_y, int16_t width, int16_t height, uint8_t key_color)
+{
+	uint8_t*		the_write_loc;
+	uint8_t*		the_read_loc;
+	uint8_t*		the_row_end;
+	uint8_t*		the_run_start;
+	uint32_t		src_stride;
+	uint32_t		dst_stride;
+	int16_t			j;
 	
-	if (src_x < 0 || src_x + width > src_bm->width_ || src_y < 0 || src_y + height > src_bm->height_)
+	if (Bitmap_ClipBlitRect(src_bm, &src_x, &src_y, dst_bm, &dst_x, &dst_y, &width, &height) == false)
 	{
-		LOG_INFO(("%s %d: Tile operations require the entire height and width of the tile to be defined within the bounds of the source bitmap. No tiling performed. src_x=%i, src_y=%i, width=%i, height=%i.", __func__, __LINE__, src_x, src_y, width, height));
 		return false;
 	}
 
-	//DEBUG_OUT(("%s %d: starting parameters: src_x=%i, src_y=%i, width=%i, height=%i.", __func__, __LINE__, src_x, src_y, width, height));
-	//DEBUG_OUT(("%s %d: dst_bm=%p, dst_bm=%p", __func__, __LINE__, src_bm, dst_bm));
-	
-	// LOGIC:
-	//   Unlike a blit operation, a tile operation always starts in the upper left corner of the target bitmap, and fills it entirely
-	//   As an optimization, one tile worth will be copied first, then copied to the right to fill one horizontal band of the dest. bitmap
-	//   From that point, will loop through the required number of remaining bands, copying the full width of the dest bitmap.
+	src_stride = (uint32_t)src_bm->width_;
+	dst_stride = (uint32_t)dst_bm->width_;
 	
-	// adjust copy width/height if the prescribed tile height or width wouldn't fit on target bitmap
-	width = (width >= dst_bm->width_) ? dst_bm->width_ : width;
-	height = (height >= dst_bm->height_) ? dst_bm->height_ : height;
+	for (j = 0; j < height; j++)
+	{
+		the_read_loc = (uint8_t*)(src_bm->addr_int_ + (src_stride * (uint32_t)(src_y + j)) + (uint32_t)src_x);
+		the_write_loc = (uint8_t*)(dst_bm->addr_int_ + (dst_stride * (uint32_t)(dst_y + j)) + (uint32_t)dst_x);
+		the_row_end = the_read_loc + width;
+		
+		// LOGIC:
+		//   alternate between skipping a run of transparent pixels and copying a run of opaque ones, until the row is used up.
+		//   the write pointer just tracks the read pointer, so there is no per-pixel address math.
+		
+		while (the_read_loc < the_row_end)
+		{
+			while (the_read_loc < the_row_end && *the_read_loc == key_color)
+			{
+				the_read_loc++;
+				the_write_loc++;
+			}
+			
+			the_run_start = the_read_loc;
+			
+			while (the_read_loc < the_row_end && *the_read_loc != key_color)
+			{
+				the_read_loc++;
+			}
+			
+			if (the_read_loc > the_run_start)
+			{
+				Bitmap_CopySpanForward(the_write_loc, the_run_start, (uint32_t)(the_read_loc - the_run_start));
+				the_write_loc += the_read_loc - the_run_start;
+			}
+		}
+	}
 
-	// checks complete. ready to tile. 
-	the_starting_read_loc = src_bm->addr_ + (src_bm->width_ * src_y) + src_x;
+	return true;
+}
+
+
+//! Blit from source bitmap to destination bitmap, copying only the pixels that are set in a 1-bit-per-pixel mask
+//! The mask covers the entire source bitmap: bit 7 of the first byte of each mask row corresponds to x=0 in the source bitmap.
+//! Works span by span: whole mask bytes of 0x00 skip 8 pixels at once, runs of set bits are copied as a block.
+//! Clipping works the same as Bitmap_Blit(). The source and destination rectangles must not overlap.
+//! @param	src_bm -- the source bitmap. It must have a valid address.
+//! @param	dst_bm -- the destination bitmap. It must have a valid address.
+//! @param	src_x -- the upper left coordinate within the source bitmap, for the rectangle you want to copy. May be negative.
+//! @param	src_y -- the upper left coordinate within the source bitmap, for the rectangle you want to copy. May be negative.
+//! @param	dst_x -- the location within the destination bitmap to copy pixels to. May be negative.
+//! @param	dst_y -- the location within the destination bitmap to copy pixels to. May be negative.
+//! @param	width -- the scope of the copy, in pixels.
+//! @param	height -- the scope of the copy, in pixels.
+//! @param	the_mask -- 1-bpp mask, MSB first. 1=copy the source pixel, 0=leave the destination pixel alone.
+//! @param	mask_row_bytes -- the number of bytes per row in the mask. Must be at least (src_bm->width_ + 7) / 8.
+//! @return	Returns false if no part of the rectangle could be copied, or on any error condition
+bool Bitmap_BlitMasked(Bitmap* src_bm, int16_t src_x, int16_t src_y, Bitmap* dst_bm, int16_t dst_x, int16_t dst_y, int16_t width, int16_t height, uint8_t* the_mask, int16_t mask_row_bytes)
+{
+	uint8_t*		the_write_loc;
+	uint8_t*		the_read_loc;
+	uint8_t*		the_mask_row;
+	uint32_t		src_stride;
+	uint32_t		dst_stride;
+	int16_t			j;
+	int16_t			x;
+	int16_t			x_end;
+	int16_t			run_start;
+	uint8_t			the_mask_byte;
 	
-	h_tiles = dst_bm->width_ / width;
-	h_rem = dst_bm->width_ % width;
+	if (the_mask == NULL)
+	{
+		LOG_ERR(("%s %d: passed mask was NULL", __func__, __LINE__));
+		return false;
+	}
 	
-	// each loop is one tile, writing left to right
-	for (j = 0; j < h_tiles; j++)
+	if (mask_row_bytes < 1)
 	{
-		the_read_loc = the_starting_read_loc;
-		the_write_loc = dst_bm->addr_ + width * j; // row 0, and x pos of width * num times already tiled
+		LOG_ERR(("%s %d: illegal mask row width (%i)", __func__, __LINE__, mask_row_bytes));
+		return false;
+	}
+	
+	if (Bitmap_ClipBlitRect(src_bm, &src_x, &src_y, dst_bm, &dst_x, &dst_y, &width, &height) == false)
+	{
+		return false;
+	}
 
-		for (i = 0; i < height; i++)
-		{
-			memcpy(the_write_loc, the_read_loc, width);
+	src_stride = (uint32_t)src_bm->width_;
+	dst_stride = (uint32_t)dst_bm->width_;
+	x_end = src_x + width;
+	
+	for (j = 0; j < height; j++)
+	{
+		the_read_loc = (uint8_t*)(src_bm->addr_int_ + (src_stride * (uint32_t)(src_y + j)) + (uint32_t)src_x);
+		the_write_loc = (uint8_t*)(dst_bm->addr_int_ + (dst_stride * (uint32_t)(dst_y + j)) + (uint32_t)dst_x);
+		the_mask_row = the_mask + (uint32_t)mask_row_bytes * (uint32_t)(src_y + j);
+		x = src_x;
+		
+		// LOGIC:
+		//   x is in source-bitmap coordinates, which is also mask coordinates. 
+		//   skip clear bits, then measure a run of set bits, then copy that run. when on a byte boundary,
+		//   a mask byte of 0x00 or 0xFF can be consumed 8 pixels at a time without testing individual bits.
 		
-			the_write_loc += dst_bm->width_;
-			the_read_loc += src_bm->width_;
-		}		
+		while (x < x_end)
+		{
+			// skip transparent pixels
+			while (x < x_end)
+			{
+				the_mask_byte = the_mask_row[x >> 3];
+				
+				if ((x & 0x07) == 0 && the_mask_byte == 0x00)
+				{
+					x += 8;
+				}
+				else if ((the_mask_byte & (0x80 >> (x & 0x07))) == 0)
+				{
+					x++;
+				}
+				else
+				{
+					break;
+				}
+			}
+			
+			if (x >= x_end)
+			{
+				break;
+			}
+			
+			run_start = x;
+			
+			// measure the run of opaque pixels
+			while (x < x_end)
+			{
+				the_mask_byte = the_mask_row[x >> 3];
+				
+				if ((x & 0x07) == 0 && the_mask_byte == 0xFF)
+				{
+					x += 8;
+				}
+				else if (the_mask_byte & (0x80 >> (x & 0x07)))
+				{
+					x++;
+				}
+				else
+				{
+					break;
+				}
+			}
+			
+			x = (x > x_end) ? x_end : x;
+			
+			Bitmap_CopySpanForward(the_write_loc + (run_start - src_x), the_read_loc + (run_start - src_x), (uint32_t)(x - run_start));
+		}
 	}
+
+	return true;
+}
+
+
+//! Tile the source bitmap into the destination bitmap, filling it
+//! @param	src_bm -- the source bitmap. It must have a valid address within the VRAM memory space.
+//! @param	dst_bm -- the destination bitmap. It must have a valid address within the VRAM memory space.
+//! @param	src_x -- the upper left coordinate within the source bitmap, for the tile you want to copy. Must be non-negative.
+//! @param	src_y -- the upper left coordinate within the source bitmap, for the tile you want to copy. Must be non-negative.
+//! @param	width -- the size of the tile to be derived from the source bitmap, in pixels.
+//! @param	height -- the size of the tile to be derived from the source bitmap, in pixels.
+//! @return	returns false on any error/invalid input.
+bool Bitmap_Tile(Bitmap* src_bm, int16_t src_x, int16_t src_y, Bitmap* dst_bm, int16_t width, int16_t height)
+{
+	return Bitmap_TileRect(src_bm, src_x, src_y, dst_bm, width, height, NULL);
+}
+
+
+//! Tile the source bitmap into part of the destination bitmap
+//! The pattern is anchored to the destination bitmap's 0, 0, not to the corner of the rect: tiling any set of rects produces the same pixels as tiling the whole bitmap would have there.
+//! @param	src_bm -- the source bitmap. It must have a valid address within the VRAM memory space.
+//! @param	dst_bm -- the destination bitmap. It must have a valid address within the VRAM memory space. It must not be the same bitmap as the source.
+//! @param	src_x -- the upper left coordinate within the source bitmap, for the tile you want to copy. Must be non-negative.
+//! @param	src_y -- the upper left coordinate within the source bitmap, for the tile you want to copy. Must be non-negative.
+//! @param	width -- the size of the tile to be derived from the source bitmap, in pixels.
+//! @param	height -- the size of the tile to be derived from the source bitmap, in pixels.
+//! @param	the_dst_rect -- the area of the destination bitmap to fill (MaxX and MaxY are included). It is limited to the bitmap. Pass NULL to fill the whole bitmap.
+//! @return	returns false on any error/invalid input. A rect entirely off the bitmap is not an error.
+bool Bitmap_TileRect(Bitmap* src_bm, int16_t src_x, int16_t src_y, Bitmap* dst_bm, int16_t width, int16_t height, Rectangle* the_dst_rect)
+{
+	Rectangle			the_rect;
+	unsigned char*		the_tile_row;
+	unsigned char*		the_write_loc;
+	int16_t				y;
+	int16_t				band_bottom;
+	int16_t				phase_x;
+	int16_t				first_len;
+	uint32_t			span_len;
+	uint32_t			written;
+	uint32_t			this_len;
+	uint32_t			dst_row_bytes;
+	uint32_t			band_bytes;
 	
-	// the last tile, if any, will have same height, but less width
-	if (h_rem)
+	if (src_bm == NULL || dst_bm == NULL)
+	{
+		LOG_ERR(("%s %d: passed source or destination bitmap was NULL", __func__, __LINE__));
+		return false;
+	}
+	
+	if (src_bm->addr_ == NULL || dst_bm->addr_ == NULL)
 	{
-		the_read_loc = the_starting_read_loc;
-		the_write_loc = dst_bm->addr_ + width * j; // row 0, and x pos of width * num times already tiled
-		width = h_rem;
-
-		for (i = 0; i < height; i++)
-		{
-			memcpy(the_write_loc, the_read_loc, width);
-		
-			the_write_loc += dst_bm->width_;
-			the_read_loc += src_bm->width_;
-		}		
+		LOG_ERR(("%s %d: passed source or destination bitmap had a NULL address", __func__, __LINE__));
+		return false;
 	}
 	
-	// have now filled the entire width of the dest. bitmap, to a height of 'height'. tile downwards...
+	// LOGIC:
+	//   The entire width and height of the tile must be within the source bitmap. 
 	
-	v_tiles = dst_bm->height_ / height;
-	v_rem = dst_bm->height_ % height;
+	if (width < 1 || height < 1 || src_x < 0 || src_x + width > src_bm->width_ || src_y < 0 || src_y + height > src_bm->height_)
+	{
+		LOG_INFO(("%s %d: Tile operations require the entire height and width of the tile to be defined within the bounds of the source bitmap. No tiling performed. src_x=%i, src_y=%i, width=%i, height=%i.", __func__, __LINE__, src_x, src_y, width, height));
+		return false;
+	}
 
-	//DEBUG_OUT(("%s %d: h_tiles=%i, h_rem=%i, v_tiles=%i, v_rem=%i", __func__, __LINE__, h_tiles, h_rem, v_tiles, v_rem));
+	the_rect.MinX = 0;
+	the_rect.MinY = 0;
+	the_rect.MaxX = dst_bm->width_ - 1;
+	the_rect.MaxY = dst_bm->height_ - 1;
 	
-	// each loop is one tile, writing top to bottom, from 2nd vertical band
-	for (j = 1; j < v_tiles; j++)	 // 1 because we just wrote one band worth's above.
+	if (the_dst_rect != NULL)
 	{
-		the_read_loc = dst_bm->addr_; // now we are reading from the destination bitmap, from the area we prepared
-		the_write_loc = dst_bm->addr_ + (dst_bm->width_ * height * j);
+		the_rect.MinX = (the_dst_rect->MinX > the_rect.MinX) ? the_dst_rect->MinX : the_rect.MinX;
+		the_rect.MinY = (the_dst_rect->MinY > the_rect.MinY) ? the_dst_rect->MinY : the_rect.MinY;
+		the_rect.MaxX = (the_dst_rect->MaxX < the_rect.MaxX) ? the_dst_rect->MaxX : the_rect.MaxX;
+		the_rect.MaxY = (the_dst_rect->MaxY < the_rect.MaxY) ? the_dst_rect->MaxY : the_rect.MaxY;
 		
-		for (i = 0; i < height; i++)
+		if (the_rect.MinX > the_rect.MaxX || the_rect.MinY > the_rect.MaxY)
 		{
-			memcpy(the_write_loc, the_read_loc, dst_bm->width_);
-		
-			the_write_loc += dst_bm->width_;
-			the_read_loc += dst_bm->width_;
-		}		
+			return true;	// nothing on the bitmap to fill. not an error condition.
+		}
 	}
 	
-	// the last tile, if any, will have less height
-	if (v_rem)
-	{
-		the_read_loc = dst_bm->addr_; // now we are reading from the destination bitmap, from the area we prepared
-		the_write_loc = dst_bm->addr_ + (dst_bm->width_ * height * j);
-		height = v_rem;
-
-		for (i = 0; i < height; i++)
+	// LOGIC:
+	//   The pattern's phase comes from the destination coordinates, so the tile column for x is x % width, and the tile row for y is y % height
+	//   First, one band of rows (one tile high, or less if the rect is shorter) is built: 
+	//     each row gets one tile width of pixels copied from the source, starting at the right phase. 
+	//     after that, the part of the row already written is copied onto the rest of it, doubling each time. 
+	//     the written part is always a whole number of tile widths, so the copies stay in phase.
+	//   Every row below the band is then the same as the row one tile height above it: one wide copy per row.
+	
+	span_len = (uint32_t)(the_rect.MaxX - the_rect.MinX + 1);
+	dst_row_bytes = (uint32_t)dst_bm->width_;
+	phase_x = the_rect.MinX % width;
+	band_bottom = the_rect.MinY + height - 1;
+	band_bottom = (band_bottom > the_rect.MaxY) ? the_rect.MaxY : band_bottom;
+	
+	for (y = the_rect.MinY; y <= band_bottom; y++)
+	{
+		the_tile_row = src_bm->addr_ + (uint32_t)(src_y + y % height) * (uint32_t)src_bm->width_ + src_x;
+		the_write_loc = dst_bm->addr_ + (uint32_t)y * dst_row_bytes + the_rect.MinX;
+		
+		// one tile width: from the phase column to the right edge of the tile, then from the left edge of the tile back up to the phase column
+		first_len = width - phase_x;
+		this_len = ((uint32_t)first_len < span_len) ? (uint32_t)first_len : span_len;
+		memcpy(the_write_loc, the_tile_row + phase_x, this_len);
+		written = this_len;
+		
+		if (written < span_len && phase_x > 0)
 		{
-			memcpy(the_write_loc, the_read_loc, dst_bm->width_);
+			this_len = ((uint32_t)phase_x < span_len - written) ? (uint32_t)phase_x : span_len - written;
+			memcpy(the_write_loc + written, the_tile_row, this_len);
+			written += this_len;
+		}
 		
-			the_write_loc += dst_bm->width_;
-			the_read_loc += dst_bm->width_;
-		}		
+		while (written < span_len)
+		{
+			this_len = (written < span_len - written) ? written : span_len - written;
+			memcpy(the_write_loc + written, the_write_loc, this_len);
+			written += this_len;
+		}
 	}
 	
-	//DEBUG_OUT(("%s %d: final parameters: src_x=%i, src_y=%i, width=%i, height=%i.", __func__, __LINE__, src_x, src_y, width, height));
+	band_bytes = dst_row_bytes * (uint32_t)height;
+	the_write_loc = dst_bm->addr_ + (uint32_t)y * dst_row_bytes + the_rect.MinX;
+	
+	for (; y <= the_rect.MaxY; y++)
+	{
+		memcpy(the_write_loc, the_write_loc - band_bytes, span_len);
+		the_write_loc += dst_row_bytes;
+	}
 	
 	return true;
 }
@@ -1184,6 +1916,64 @@ bool Bitmap_FillBox(Bitmap* the_bitmap, int16_t x, int16_t y, int16_t width, int
 }
 
 
+//! Flood fill: replace the color of every pixel connected to the passed coordinate that has the same color it does
+//! Works a row-run at a time from a fixed-size work queue, so stack use does not depend on the size or shape of the area filled
+//! @param	the_bitmap -- reference to a valid Bitmap object.
+//! @param	x -- the horizontal position of the starting pixel, between 0 and bitmap width - 1
+//! @param	y -- the vertical position of the starting pixel, between 0 and bitmap height - 1
+//! @param	the_color -- a 1-byte index to the current LUT
+//! @param	eight_way -- PARAM_FILL_8_WAY to also spread to diagonally touching pixels, or PARAM_FILL_4_WAY to only spread up, down, left, and right
+//! @return	returns false on any error/invalid input.
+bool Bitmap_FloodFill(Bitmap* the_bitmap, int16_t x, int16_t y, uint8_t the_color, bool eight_way)
+{
+	if (the_bitmap == NULL)
+	{
+		LOG_ERR(("%s %d: passed bitmap was NULL", __func__, __LINE__));
+		return false;
+	}
+	
+	if (!Bitmap_ValidateXY(the_bitmap, x, y))
+	{
+		LOG_ERR(("%s %d: invalid coordinates: x=%i, y=%i", __func__, __LINE__, x, y));
+		return false;
+	}
+	
+	return Bitmap_FloodFillCommon(the_bitmap, x, y, the_color, NULL, eight_way);
+}
+
+
+//! Flood fill with a pattern: as Bitmap_FloodFill, but the filled pixels are taken from a tile bitmap, repeated across the target
+//! The tile is anchored to the target bitmap's 0,0, so adjacent fills line up. The pattern may contain the color being replaced.
+//! @param	the_bitmap -- reference to a valid Bitmap object.
+//! @param	x -- the horizontal position of the starting pixel, between 0 and bitmap width - 1
+//! @param	y -- the vertical position of the starting pixel, between 0 and bitmap height - 1
+//! @param	the_pattern -- reference to a valid Bitmap object, the whole of which is used as the tile
+//! @param	eight_way -- PARAM_FILL_8_WAY to also spread to diagonally touching pixels, or PARAM_FILL_4_WAY to only spread up, down, left, and right
+//! @return	returns false on any error/invalid input.
+bool Bitmap_FloodFillPattern(Bitmap* the_bitmap, int16_t x, int16_t y, Bitmap* the_pattern, bool eight_way)
+{
+	if (the_bitmap == NULL || the_pattern == NULL)
+	{
+		LOG_ERR(("%s %d: passed bitmap or pattern was NULL", __func__, __LINE__));
+		return false;
+	}
+	
+	if (the_pattern->width_ < 1 || the_pattern->height_ < 1)
+	{
+		LOG_ERR(("%s %d: pattern bitmap has no pixels", __func__, __LINE__));
+		return false;
+	}
+	
+	if (!Bitmap_ValidateXY(the_bitmap, x, y))
+	{
+		LOG_ERR(("%s %d: invalid coordinates: x=%i, y=%i", __func__, __LINE__, x, y));
+		return false;
+	}
+	
+	return Bitmap_FloodFillCommon(the_bitmap, x, y, 0, the_pattern, eight_way);
+}
+
+
 
 
 
@@ -1485,73 +2275,67 @@ uint8_t Bitmap_GetPixelAtXY(Bitmap* the_bitmap, int16_t x, int16_t y)
 
 
 //! Draws a line between 2 passed coordinates.
-//! Use for any line that is not perfectly vertical or perfectly horizontal
-//! Based on http://rosettacode.org/wiki/Bitmap/Bresenham%27s_line_algorithm#C. Used in C128 Lich King. 
+//! The line is clipped to the bitmap: either end, or both, may be off the bitmap. Horizontal and vertical lines are drawn by the same fast paths as Bitmap_DrawHLine and Bitmap_DrawVLine.
+//! @param	the_color -- a 1-byte index to the current LUT
+//! @return	returns false on any error/invalid input. A line entirely off the bitmap is not an error.
 bool Bitmap_DrawLine(Bitmap* the_bitmap, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint8_t the_color)
 {
-	int16_t dx;
-	int16_t sx;
-	int16_t dy;
-	int16_t sy;
-	int16_t err;
+	return Bitmap_DrawLineClipped(the_bitmap, x1, y1, x2, y2, the_color, NULL);
+}
+
 
+//! Draws a line between 2 passed coordinates, drawing only the part that is within the passed clip rect
+//! Either end, or both, may be outside the clip rect and the bitmap. The pixels drawn are the same ones an unclipped line would draw within the clip rect.
+//! @param	the_color -- a 1-byte index to the current LUT
+//! @param	the_clip_rect -- rect, in bitmap coordinates, to confine drawing to (MaxX and MaxY are included). It is limited to the bitmap. Pass NULL to clip to the bitmap only.
+//! @return	returns false on any error/invalid input. A line entirely outside the clip rect is not an error.
+bool Bitmap_DrawLineClipped(Bitmap* the_bitmap, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint8_t the_color, Rectangle* the_clip_rect)
+{
+	Rectangle	the_clip;
+	
 	if (the_bitmap == NULL)
 	{
 		LOG_ERR(("%s %d: passed bitmap was NULL", __func__, __LINE__));
 		return false;
 	}
 
-	if (!Bitmap_ValidateXY(the_bitmap, x1, y1))
+	if (abs(x2 - x1) > BITMAP_MAX_LINE_SPAN || abs(y2 - y1) > BITMAP_MAX_LINE_SPAN)
 	{
-		LOG_ERR(("%s %d: illegal coordinate", __func__, __LINE__));
+		LOG_ERR(("%s %d: line too long (%i, %i to %i, %i)", __func__, __LINE__, x1, y1, x2, y2));
 		return false;
 	}
 	
-	dx = abs(x2 - x1);
-	sx = x1 < x2 ? 1 : -1;
-	dy = abs(y2 - y1);
-	sy = y1 < y2 ? 1 : -1;
-	err = (dx > dy ? dx : -dy)/2;
-
-	for(;;)
+	the_clip.MinX = 0;
+	the_clip.MinY = 0;
+	the_clip.MaxX = the_bitmap->width_ - 1;
+	the_clip.MaxY = the_bitmap->height_ - 1;
+	
+	if (the_clip_rect != NULL)
 	{
-		int16_t e2;
-
-		Bitmap_SetPixelAtXY(the_bitmap, x1, y1, the_color);
-
-		if (x1==x2 && y1==y2)
-		{
-			break;
-		}
-
-		e2 = err;
-
-		if (e2 >-dx)
-		{
-			err -= dy;
-			x1 += sx;
-		}
-
-		if (e2 < dy)
+		the_clip.MinX = (the_clip_rect->MinX > the_clip.MinX) ? the_clip_rect->MinX : the_clip.MinX;
+		the_clip.MinY = (the_clip_rect->MinY > the_clip.MinY) ? the_clip_rect->MinY : the_clip.MinY;
+		the_clip.MaxX = (the_clip_rect->MaxX < the_clip.MaxX) ? the_clip_rect->MaxX : the_clip.MaxX;
+		the_clip.MaxY = (the_clip_rect->MaxY < the_clip.MaxY) ? the_clip_rect->MaxY : the_clip.MaxY;
+		
+		if (the_clip.MinX > the_clip.MaxX || the_clip.MinY > the_clip.MaxY)
 		{
-			err += dx;
-			y1 += sy;
+			return true;	// nothing on the bitmap to draw. not an error condition.
 		}
 	}
 	
+	Bitmap_DrawLineInRect(the_bitmap, x1, y1, x2, y2, the_color, &the_clip);
+	
 	return true;
 }
 
 //! Draws a horizontal line from specified coords, for n pixels, using the specified pixel value
+//! Any part of the line past the right edge of the bitmap is skipped.
 //! @param	the_color -- a 1-byte index to the current LUT
 //! @return	returns false on any error/invalid input.
 bool Bitmap_DrawHLine(Bitmap* the_bitmap, int16_t x, int16_t y, int16_t the_line_len, uint8_t the_color)
 {
-	bool			result;
+	Rectangle	the_clip;
 	
-	// LOGIC: 
-	//   an H line is just a box with 1 row, so we can re-use Bitmap_FillBox(). These routines use memset, so are quicker than for loops. 
-
 	//DEBUG_OUT(("%s %d: x=%i, y=%i, the_line_len=%i, the_color=%i", __func__, __LINE__, x, y, the_line_len, the_color));
 	
 	if (the_bitmap == NULL)
@@ -1566,18 +2350,35 @@ bool Bitmap_DrawHLine(Bitmap* the_bitmap, int16_t x, int16_t y, int16_t the_line
 		return false;
 	}
 
-	result = Bitmap_FillBox(the_bitmap, x, y, the_line_len, 0, the_color);
+	if (the_line_len < 1)
+	{
+		return true;
+	}
+	
+	the_clip.MinX = 0;
+	the_clip.MinY = 0;
+	the_clip.MaxX = the_bitmap->width_ - 1;
+	the_clip.MaxY = the_bitmap->height_ - 1;
+	
+	// trim the length to the bitmap first, so the end point can't overflow
+	if (the_line_len > the_bitmap->width_ - x)
+	{
+		the_line_len = the_bitmap->width_ - x;
+	}
+	
+	Bitmap_DrawLineInRect(the_bitmap, x, y, x + the_line_len - 1, y, the_color, &the_clip);
 
-	return result;
+	return true;
 }
 
 
 //! Draws a vertical line from specified coords, for n pixels
+//! Any part of the line past the bottom edge of the bitmap is skipped.
 //! @param	the_color -- a 1-byte index to the current LUT
 //! @return	returns false on any error/invalid input.
 bool Bitmap_DrawVLine(Bitmap* the_bitmap, int16_t x, int16_t y, int16_t the_line_len, uint8_t the_color)
 {
-	int16_t		dy;
+	Rectangle	the_clip;
 
 	//DEBUG_OUT(("%s %d: x=%i, y=%i, the_line_len=%i, the_color=%i", __func__, __LINE__, x, y, the_line_len, the_color));
 	
@@ -1593,11 +2394,23 @@ bool Bitmap_DrawVLine(Bitmap* the_bitmap, int16_t x, int16_t y, int16_t the_line
 		return false;
 	}
 	
-	for (dy = 0; dy < the_line_len; dy++)
+	if (the_line_len < 1)
+	{
+		return true;
+	}
+	
+	the_clip.MinX = 0;
+	the_clip.MinY = 0;
+	the_clip.MaxX = the_bitmap->width_ - 1;
+	the_clip.MaxY = the_bitmap->height_ - 1;
+	
+	if (the_line_len > the_bitmap->height_ - y)
 	{
-		Bitmap_SetPixelAtXY(the_bitmap, x, y + dy, the_color);
+		the_line_len = the_bitmap->height_ - y;
 	}
 	
+	Bitmap_DrawLineInRect(the_bitmap, x, y, x, y + the_line_len - 1, the_color, &the_clip);
+	
 	return true;
 }
 
@@ -1749,16 +2562,123 @@ bool Bitmap_DrawBox(Bitmap* the_bitmap, int16_t x, int16_t y, int16_t width, int
 }
 
 
+//! Draws the outline of a rectangle by XORing each outline pixel with the passed value
+//! Each outline pixel is changed exactly once, so drawing the same box a second time restores the bitmap to what it was. 
+//! Parts of the box that fall outside the bitmap are skipped, so the box may be partly or entirely off the bitmap.
+//! @param	width -- width, in pixels, of the rectangle to be drawn
+//! @param	height -- height, in pixels, of the rectangle to be drawn
+//! @param	the_xor_value -- value each pixel of the outline will be XORed with
+//! @return	returns false on any error/invalid input.
+bool Bitmap_DrawBoxXOR(Bitmap* the_bitmap, int16_t x, int16_t y, int16_t width, int16_t height, uint8_t the_xor_value)
+{
+	int16_t		right;
+	int16_t		bottom;
+	int16_t		clip_left;
+	int16_t		clip_right;
+	int16_t		clip_top;
+	int16_t		clip_bottom;
+	int16_t		i;
+	uint8_t*	the_loc;
+	
+	if (the_bitmap == NULL)
+	{
+		LOG_ERR(("%s %d: passed bitmap was NULL", __func__, __LINE__));
+		return false;
+	}
+
+	if (width < 1 || height < 1)
+	{
+		LOG_ERR(("%s %d: illegal box size (%i, %i)", __func__, __LINE__, width, height));
+		return false;
+	}
+	
+	// LOGIC:
+	//   unlike Bitmap_DrawBox, coordinates are clipped rather than rejected: a dragged window outline can go partly off screen
+	//   an edge that is off the bitmap is skipped entirely, not moved onto the bitmap, so the XOR always lands on the same pixels
+	//   corners belong to the top and bottom rows only, so no pixel is XORed twice (which would cancel it out)
+	
+	right = x + width - 1;
+	bottom = y + height - 1;
+	
+	clip_left = (x < 0) ? 0 : x;
+	clip_right = (right >= the_bitmap->width_) ? the_bitmap->width_ - 1 : right;
+	clip_top = (y < 0) ? 0 : y;
+	clip_bottom = (bottom >= the_bitmap->height_) ? the_bitmap->height_ - 1 : bottom;
+	
+	if (clip_left > clip_right || clip_top > clip_bottom)
+	{
+		return true;	// nothing on the bitmap to draw. not an error condition.
+	}
+	
+	// top and bottom rows
+	if (y >= 0)
+	{
+		the_loc = the_bitmap->addr_ + (uint32_t)y * the_bitmap->width_ + clip_left;
+		
+		for (i = clip_left; i <= clip_right; i++)
+		{
+			*the_loc++ ^= the_xor_value;
+		}
+	}
+	
+	if (bottom != y && bottom < the_bitmap->height_)
+	{
+		the_loc = the_bitmap->addr_ + (uint32_t)bottom * the_bitmap->width_ + clip_left;
+		
+		for (i = clip_left; i <= clip_right; i++)
+		{
+			*the_loc++ ^= the_xor_value;
+		}
+	}
+	
+	// left and right columns, between the top and bottom rows
+	if (clip_top <= y)
+	{
+		clip_top = y + 1;
+	}
+	
+	if (clip_bottom >= bottom)
+	{
+		clip_bottom = bottom - 1;
+	}
+	
+	if (x >= 0)
+	{
+		the_loc = the_bitmap->addr_ + (uint32_t)clip_top * the_bitmap->width_ + x;
+		
+		for (i = clip_top; i <= clip_bottom; i++)
+		{
+			*the_loc ^= the_xor_value;
+			the_loc += the_bitmap->width_;
+		}
+	}
+	
+	if (right != x && right < the_bitmap->width_)
+	{
+		the_loc = the_bitmap->addr_ + (uint32_t)clip_top * the_bitmap->width_ + right;
+		
+		for (i = clip_top; i <= clip_bottom; i++)
+		{
+			*the_loc ^= the_xor_value;
+			the_loc += the_bitmap->width_;
+		}
+	}
+	
+	return true;
+}
+
+
 //! Draws a rounded rectangle with the specified size and radius, and optionally fills the rectangle.
 //! @param	width -- width, in pixels, of the rectangle to be drawn
 //! @param	height -- height, in pixels, of the rectangle to be drawn
-//! @param	radius -- radius, in pixels, of the arc to be applied to the rectangle's corners. Enforces a minimum of 3, maximum of 20.
+//! @param	radius -- radius, in pixels, of the arc to be applied to the rectangle's corners. 0 draws square corners. A radius too big for the box is reduced to the largest that fits.
 //! @param	the_color -- a 1-byte index to the current color LUT
 //! @param	do_fill -- If true, the box will be filled with the provided color. If false, the box will only draw the outline.
 //! @return	returns false on any error/invalid input.
 bool Bitmap_DrawRoundBox(Bitmap* the_bitmap, int16_t x, int16_t y, int16_t width, int16_t height, int16_t radius, uint8_t the_color, bool do_fill)
 {	
-
+	int16_t		max_radius;
+	
 	//DEBUG_OUT(("%s %d: x=%i, y=%i, width=%i, height=%i, the_color=%i", __func__, __LINE__, x, y, width, height, the_color));
 
 	if (the_bitmap == NULL)
@@ -1767,6 +2687,12 @@ bool Bitmap_DrawRoundBox(Bitmap* the_bitmap, int16_t x, int16_t y, int16_t width
 		return false;
 	}
 
+	if (width < 1 || height < 1)
+	{
+		LOG_ERR(("%s %d: illegal box size (%i, %i)", __func__, __LINE__, width, height));
+		return false;
+	}
+	
 	if (!Bitmap_ValidateXY(the_bitmap, x, y))
 	{
 		LOG_ERR(("%s %d: illegal coordinate", __func__, __LINE__));
@@ -1779,67 +2705,93 @@ bool Bitmap_DrawRoundBox(Bitmap* the_bitmap, int16_t x, int16_t y, int16_t width
 		return false;
 	}
 
-	radius = (radius < 3) ? 3 : radius;
-	radius = (radius > 20) ? 20 : radius;
-	
-	
-	// adjust box x, y, width, height values to line up with the edges of the arcs
-	width -= radius * 2;
-	height -= radius * 2;
-	x += radius;
-	y += radius;
+	// LOGIC:
+	//   the corner arcs are centered radius pixels in from each corner. the arcs on opposite sides can meet, but not cross.
+	//   the fill is one memset per row, so the time taken is proportional to the area, and no flood fill is needed.
 	
-	// Draw 4 circle quadrants
-	Bitmap_DrawCircleQuadrants(the_bitmap, x, y, radius, the_color, PARAM_SKIP_NE, PARAM_SKIP_SE, PARAM_SKIP_SW, PARAM_DRAW_NW);
-	Bitmap_DrawCircleQuadrants(the_bitmap, x + width, y, radius, the_color, PARAM_DRAW_NE, PARAM_SKIP_SE, PARAM_SKIP_SW, PARAM_SKIP_NW);
-	Bitmap_DrawCircleQuadrants(the_bitmap, x, y + height, radius, the_color, PARAM_SKIP_NE, PARAM_SKIP_SE, PARAM_DRAW_SW, PARAM_SKIP_NW);
-	Bitmap_DrawCircleQuadrants(the_bitmap, x + width, y + height, radius, the_color, PARAM_SKIP_NE, PARAM_DRAW_SE, PARAM_SKIP_SW, PARAM_SKIP_NW);
+	max_radius = ((width < height ? width : height) - 1) / 2;
+	radius = (radius < 0) ? 0 : radius;
+	radius = (radius > max_radius) ? max_radius : radius;
 	
-	// draw 4 shortened lines that will match up with the edges of the arcs
-	if (!Bitmap_DrawHLine(the_bitmap, x, y - radius, width, the_color))
+	if (do_fill)
 	{
-		LOG_ERR(("%s %d: draw box failed", __func__, __LINE__));
-		return false;
+		Bitmap_FillRounded(the_bitmap, x + radius, y + radius, x + width - 1 - radius, y + height - 1 - radius, radius, the_color);
 	}
-	
-	if (!Bitmap_DrawVLine(the_bitmap, x + width + radius, y, height, the_color))
+	else
 	{
-		LOG_ERR(("%s %d: draw box failed", __func__, __LINE__));
+		Bitmap_DrawRoundedOutline(the_bitmap, x + radius, y + radius, x + width - 1 - radius, y + height - 1 - radius, radius, the_color);
+	}
+		
+	return true;
+}
+
+
+//! Draw a circle, and optionally fill it
+//! Parts of the circle that fall outside the bitmap are skipped.
+//! Based on http://rosettacode.org/wiki/Bitmap/Midpoint_circle_algorithm#C
+//! @param	x1 -- the horizontal position of the center of the circle. Must be within the bitmap.
+//! @param	y1 -- the vertical position of the center of the circle. Must be within the bitmap.
+//! @param	radius -- radius, in pixels. Must be between 0 and BITMAP_MAX_ELLIPSE_RADIUS.
+//! @param	the_color -- a 1-byte index to the current color LUT
+//! @param	do_fill -- If true, the circle will be filled with the provided color. If false, only the outline will be drawn.
+//! @return	returns false on any error/invalid input.
+bool Bitmap_DrawCircle(Bitmap* the_bitmap, int16_t x1, int16_t y1, int16_t radius, uint8_t the_color, bool do_fill)
+{
+	if (the_bitmap == NULL)
+	{
+		LOG_ERR(("%s %d: passed bitmap was NULL", __func__, __LINE__));
 		return false;
 	}
-	
-	if (!Bitmap_DrawHLine(the_bitmap, x, y + height + radius, width, the_color))
+
+	if (!Bitmap_ValidateXY(the_bitmap, x1, y1))
 	{
-		LOG_ERR(("%s %d: draw box failed", __func__, __LINE__));
+		LOG_ERR(("%s %d: illegal coordinate", __func__, __LINE__));
 		return false;
 	}
-	
-	if (!Bitmap_DrawVLine(the_bitmap, x - radius, y, height, the_color))
+
+	if (radius < 0 || radius > BITMAP_MAX_ELLIPSE_RADIUS)
 	{
-		LOG_ERR(("%s %d: draw box failed", __func__, __LINE__));
+		LOG_ERR(("%s %d: illegal radius %i", __func__, __LINE__, radius));
 		return false;
 	}
-	
-	// fill with same color as outline, if specified
+
 	if (do_fill)
 	{
-		Bitmap_FillBox(the_bitmap, x + radius, y + 1, width - radius*2, radius, the_color);
-		Bitmap_FillBox(the_bitmap, x + 1, y + radius, width - 1, height-radius*2, the_color);
-		Bitmap_FillBox(the_bitmap, x + radius, y + height-radius*1, width - radius*2, radius-1, the_color);
-		Bitmap_Fill(the_bitmap, x + radius - 1, y + 1, the_color);
-		Bitmap_Fill(the_bitmap, x + (width - radius) + 1, y + 1, the_color);
-		Bitmap_Fill(the_bitmap, x + radius - 1, y + (height - radius) + 1, the_color);
-		Bitmap_Fill(the_bitmap, x + (width - radius) + 1, y + (height - radius) + 1, the_color);
+		Bitmap_FillRounded(the_bitmap, x1, y1, x1, y1, radius, the_color);
 	}
-		
+	else
+	{
+		Bitmap_DrawRoundedOutline(the_bitmap, x1, y1, x1, y1, radius, the_color);
+	}
+	
 	return true;
 }
 
 
-//! Draw a circle
-//! Based on http://rosettacode.org/wiki/Bitmap/Midpoint_circle_algorithm#C
-bool Bitmap_DrawCircle(Bitmap* the_bitmap, int16_t x1, int16_t y1, int16_t radius, uint8_t the_color)
+//! Draw an ellipse, and optionally fill it
+//! Parts of the ellipse that fall outside the bitmap are skipped.
+//! Based on John Kennedy, "A Fast Bresenham Type Algorithm For Drawing Ellipses"
+//! @param	x1 -- the horizontal position of the center of the ellipse. Must be within the bitmap.
+//! @param	y1 -- the vertical position of the center of the ellipse. Must be within the bitmap.
+//! @param	x_radius -- horizontal radius, in pixels. Must be between 0 and BITMAP_MAX_ELLIPSE_RADIUS.
+//! @param	y_radius -- vertical radius, in pixels. Must be between 0 and BITMAP_MAX_ELLIPSE_RADIUS.
+//! @param	the_color -- a 1-byte index to the current color LUT
+//! @param	do_fill -- If true, the ellipse will be filled with the provided color. If false, only the outline will be drawn.
+//! @return	returns false on any error/invalid input.
+bool Bitmap_DrawEllipse(Bitmap* the_bitmap, int16_t x1, int16_t y1, int16_t x_radius, int16_t y_radius, uint8_t the_color, bool do_fill)
 {
+	int32_t		two_a_square;
+	int32_t		two_b_square;
+	int32_t		x_change;
+	int32_t		y_change;
+	int32_t		the_error;
+	int32_t		stopping_x;
+	int32_t		stopping_y;
+	int16_t		x;
+	int16_t		y;
+	int16_t		last_set_1_row;
+	bool		needs_clip;
+	
 	if (the_bitmap == NULL)
 	{
 		LOG_ERR(("%s %d: passed bitmap was NULL", __func__, __LINE__));
@@ -1852,7 +2804,138 @@ bool Bitmap_DrawCircle(Bitmap* the_bitmap, int16_t x1, int16_t y1, int16_t radiu
 		return false;
 	}
 
-	return Bitmap_DrawCircleQuadrants(the_bitmap, x1, y1, radius, the_color, PARAM_DRAW_NE, PARAM_DRAW_SE, PARAM_DRAW_SW, PARAM_DRAW_NW);
+	if (x_radius < 0 || y_radius < 0 || x_radius > BITMAP_MAX_ELLIPSE_RADIUS || y_radius > BITMAP_MAX_ELLIPSE_RADIUS)
+	{
+		LOG_ERR(("%s %d: illegal radius %i, %i", __func__, __LINE__, x_radius, y_radius));
+		return false;
+	}
+	
+	// LOGIC:
+	//   the ellipse is drawn in 2 sets of points, mirrored into the 4 quadrants: 
+	//     the first set starts at the right end of the horizontal axis, and steps y by 1 every time, so each row gets one point (the widest)
+	//     the second starts at the bottom end of the vertical axis, and steps x by 1 every time; the widest point on a row is the one before y steps in
+	//   filling emits one span per row from those widest points. the second set skips rows the first set has already filled.
+	//   (the first set always runs at least once, so row 0 is always drawn by it)
+	//   the bounds are checked once for the whole shape; if it is all on the bitmap, outline points are written without checks.
+	
+	needs_clip = (x1 - x_radius < 0 || y1 - y_radius < 0 || x1 + x_radius >= the_bitmap->width_ || y1 + y_radius >= the_bitmap->height_);
+	
+	// a flat ellipse is a straight line, filled or not. the point sets below would never reach their stopping condition.
+	if (x_radius == 0 || y_radius == 0)
+	{
+		for (y = -y_radius; y <= y_radius; y++)
+		{
+			Bitmap_FillSpan(the_bitmap, x1 - x_radius, x1 + x_radius, y1 + y, the_color);
+		}
+		
+		return true;
+	}
+	
+	two_a_square = 2 * (int32_t)x_radius * (int32_t)x_radius;
+	two_b_square = 2 * (int32_t)y_radius * (int32_t)y_radius;
+
+	// first set: x from x_radius down, y from 0 up
+	x = x_radius;
+	y = 0;
+	x_change = (int32_t)y_radius * (int32_t)y_radius * (1 - 2 * (int32_t)x_radius);
+	y_change = (int32_t)x_radius * (int32_t)x_radius;
+	the_error = 0;
+	stopping_x = two_b_square * x_radius;
+	stopping_y = 0;
+	
+	while (stopping_x >= stopping_y)
+	{
+		if (do_fill)
+		{
+			Bitmap_FillSpan(the_bitmap, x1 - x, x1 + x, y1 + y, the_color);
+			
+			if (y != 0)
+			{
+				Bitmap_FillSpan(the_bitmap, x1 - x, x1 + x, y1 - y, the_color);
+			}
+			
+		}
+		else
+		{
+			Bitmap_PlotPoint(the_bitmap, x1 + x, y1 + y, the_color, needs_clip);
+			Bitmap_PlotPoint(the_bitmap, x1 - x, y1 + y, the_color, needs_clip);
+			Bitmap_PlotPoint(the_bitmap, x1 + x, y1 - y, the_color, needs_clip);
+			Bitmap_PlotPoint(the_bitmap, x1 - x, y1 - y, the_color, needs_clip);
+		}
+		
+		last_set_1_row = y;
+		y++;
+		stopping_y += two_a_square;
+		the_error += y_change;
+		y_change += two_a_square;
+		
+		if (2 * the_error + x_change > 0)
+		{
+			x--;
+			stopping_x -= two_b_square;
+			the_error += x_change;
+			x_change += two_b_square;
+		}
+	}
+	
+	// second set: x from 0 up, y from y_radius down
+	x = 0;
+	y = y_radius;
+	x_change = (int32_t)y_radius * (int32_t)y_radius;
+	y_change = (int32_t)x_radius * (int32_t)x_radius * (1 - 2 * (int32_t)y_radius);
+	the_error = 0;
+	stopping_x = 0;
+	stopping_y = two_a_square * y_radius;
+	
+	while (stopping_x <= stopping_y)
+	{
+		if (!do_fill)
+		{
+			Bitmap_PlotPoint(the_bitmap, x1 + x, y1 + y, the_color, needs_clip);
+			Bitmap_PlotPoint(the_bitmap, x1 - x, y1 + y, the_color, needs_clip);
+			Bitmap_PlotPoint(the_bitmap, x1 + x, y1 - y, the_color, needs_clip);
+			Bitmap_PlotPoint(the_bitmap, x1 - x, y1 - y, the_color, needs_clip);
+		}
+		
+		x++;
+		stopping_x += two_b_square;
+		the_error += x_change;
+		x_change += two_b_square;
+		
+		if (2 * the_error + y_change > 0)
+		{
+			if (do_fill && y > last_set_1_row)
+			{
+				Bitmap_FillSpan(the_bitmap, x1 - (x - 1), x1 + (x - 1), y1 + y, the_color);
+				Bitmap_FillSpan(the_bitmap, x1 - (x - 1), x1 + (x - 1), y1 - y, the_color);
+			}
+			
+			y--;
+			stopping_y -= two_a_square;
+			the_error += y_change;
+			y_change += two_a_square;
+		}
+	}
+	
+	// the row the second set stopped on has not been filled yet. on very narrow ellipses, neither set reaches a few rows between where
+	// the 2 sets end, either. draw those at the second set's last width, so the edge of the shape is unbroken.
+	for (; y > last_set_1_row; y--)
+	{
+		if (do_fill)
+		{
+			Bitmap_FillSpan(the_bitmap, x1 - (x - 1), x1 + (x - 1), y1 + y, the_color);
+			Bitmap_FillSpan(the_bitmap, x1 - (x - 1), x1 + (x - 1), y1 - y, the_color);
+		}
+		else
+		{
+			Bitmap_PlotPoint(the_bitmap, x1 + (x - 1), y1 + y, the_color, needs_clip);
+			Bitmap_PlotPoint(the_bitmap, x1 - (x - 1), y1 + y, the_color, needs_clip);
+			Bitmap_PlotPoint(the_bitmap, x1 + (x - 1), y1 - y, the_color, needs_clip);
+			Bitmap_PlotPoint(the_bitmap, x1 - (x - 1), y1 - y, the_color, needs_clip);
+		}
+	}
+	
+	return true;
 }
 
 
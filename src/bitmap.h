@@ -67,20 +67,22 @@
 /*                            Macro Definitions                              */
 /*****************************************************************************/
 
-#define PARAM_DRAW_NE		true	//!< for Bitmap_DrawCircleQuadrants, do draw NE quadrant
-#define PARAM_DRAW_SE		true	//!< for Bitmap_DrawCircleQuadrants, do draw SE quadrant
-#define PARAM_DRAW_SW		true	//!< for Bitmap_DrawCircleQuadrants, do draw SW quadrant
-#define PARAM_DRAW_NW		true	//!< for Bitmap_DrawCircleQuadrants, do draw NW quadrant
-#define PARAM_SKIP_NE		false	//!< for Bitmap_DrawCircleQuadrants, do NOT draw NE quadrant
-#define PARAM_SKIP_SE		false	//!< for Bitmap_DrawCircleQuadrants, do NOT draw SE quadrant
-#define PARAM_SKIP_SW		false	//!< for Bitmap_DrawCircleQuadrants, do NOT draw SW quadrant
-#define PARAM_SKIP_NW		false	//!< for Bitmap_DrawCircleQuadrants, do NOT draw NW quadrant
-
 #define PARAM_DO_FILL		true	//!< for various graphic routines
 #define PARAM_DO_NOT_FILL	false	//!< for various graphic routines
 
-#define PARAM_IN_VRAM		true	//!< for Bitmap_New
-#define PARAM_NOT_IN_VRAM	false	//!< for Bitmap_New
+#define BITMAP_MAX_LINE_SPAN		16383	//!< for Bitmap_DrawLine, Bitmap_DrawLineClipped: longest line, in pixels, on either axis. keeps the clipping math within 32 bits.
+#define BITMAP_MAX_ELLIPSE_RADIUS	512		//!< for Bitmap_DrawEllipse and Bitmap_DrawCircle: largest radius on either axis. keeps the ellipse error terms within 32 bits, and circle edges within int16_t.
+
+#define PARAM_NOT_IN_VRAM	0		//!< for Bitmap_New: allocate the bitmap's storage in system RAM
+#define PARAM_IN_VRAM		1		//!< for Bitmap_New: don't allocate storage. The caller assigns a fixed VRAM address (eg, the screen layers).
+#define PARAM_PREFER_VRAM	2		//!< for Bitmap_New: allocate the bitmap's storage from the VRAM heap, or from system RAM if VRAM is full
+
+#define PARAM_FILL_8_WAY	true	//!< for Bitmap_FloodFill, Bitmap_FloodFillPattern: pixels that only touch diagonally are connected
+#define PARAM_FILL_4_WAY	false	//!< for Bitmap_FloodFill, Bitmap_FloodFillPattern: only pixels above, below, left, and right are connected
+
+#define BITMAP_FILL_MAX_SPANS	512	//!< max number of pending spans in a flood fill's work queue. If a fill needs more, it rescans for the spans it had to drop, rather than growing the queue.
+
+#define BITMAP_RESIZE_HEADROOM	4	//!< for Bitmap_Resize: when storage has to grow, it grows by an extra 1/this of the new size, so that a live resize doesn't reallocate on every step
 
 
 /*****************************************************************************/
@@ -105,6 +107,8 @@ struct Bitmap
 	unsigned char*	addr_;		//!< address of the start of the bitmap, within the machine's global address space. This is not the VICKY's local address for this bitmap. This address MUST be within the VRAM, however, it cannot be in non-VRAM memory space.
 	uint32_t		addr_int_;	//!< address of the start of the bitmap, as an unsigned long int. For use with plotting locations on 65816/Calypsi, which imposed a max 64k data size (at the moment)
 	bool			in_vram_;	//!< a way to know if this bitmap is pointing to VRAM or standard RAM space.
+	bool			vram_block_;	//!< true if the bitmap's storage was allocated from the VRAM heap (and may be moved by it), false if in RAM or at a fixed VRAM address
+	uint32_t		capacity_;	//!< bytes of storage allocated for the bitmap. Can be more than width_ * height_ after a resize. 0 if at a fixed VRAM address.
 };
 
 
@@ -122,21 +126,23 @@ struct Bitmap
 
 // constructor
 
-//! Create a new bitmap object by allocating space for the bitmap struct in regular memory, and for the graphics, in VRAM
-//! NOTE: when creating a bitmap to represent something actually in VRAM, pass true to in_vram, and manually assign a known VRAM location afterwards.
+//! Create a new bitmap object by allocating space for the bitmap struct in regular memory, and for the graphics, in VRAM or regular memory
+//! NOTE: when creating a bitmap to represent something at a fixed place in VRAM, pass PARAM_IN_VRAM, and manually assign a known VRAM location afterwards.
+//! NOTE: the address of a bitmap created with PARAM_PREFER_VRAM can change whenever another VRAM bitmap is allocated (the VRAM heap may compact itself). Don't keep a copy of it.
 //! @param	width -- width, in pixels, of the bitmap to be created
 //! @param	height -- height, in pixels, of the bitmap to be created
 //! @param	the_font -- optional font object to associate with the Bitmap. 
-//! @param	in_vram -- if true, no space will be allocated for the bitmap graphics. If false, width * height area of memory will be allocated in standard memory.
-Bitmap* Bitmap_New(int16_t width, int16_t height, Font* the_font, bool in_vram);
+//! @param	vram_mode -- PARAM_NOT_IN_VRAM to allocate width * height bytes of standard memory; PARAM_PREFER_VRAM to allocate them from the VRAM heap if it has room, or standard memory if not; PARAM_IN_VRAM to allocate no space for the graphics.
+Bitmap* Bitmap_New(int16_t width, int16_t height, Font* the_font, uint8_t vram_mode);
 
 // destructor
 // frees all allocated memory associated with the passed object, and the object itself
 bool Bitmap_Destroy(Bitmap** the_bitmap);
 
 //! Resize and existing bitmap by setting new width/height and allocating bigger storage if necessary
-//! NOTE: if the bitmap is held in VRAM, storage will not be reallocated
-//! NOTE: if the new size for the bitmap is smaller than the previous size, storage will not be reallocated - extra bytes will simply not be used
+//! The pixels in the area the old and new sizes share (the top-left) are kept in place. Pixels outside that area are undefined: the caller must draw them.
+//! NOTE: if the bitmap is at a fixed VRAM address, storage will not be reallocated, and pixels are not moved. If it is in the VRAM heap and needs more space, its block is grown, or it moves to standard memory if VRAM is full.
+//! NOTE: storage is only reallocated if the new size is more than the bitmap's capacity. It then grows with BITMAP_RESIZE_HEADROOM to spare, and is never shrunk.
 //! @param	width -- the new width, in pixels, to resize the bitmap to
 //! @param	height -- the new height, in pixels, to resize the bitmap to
 //! @return	Returns false in any error condition
@@ -159,6 +165,8 @@ bool Bitmap_BlitRect(Bitmap* src_bm, Rectangle* src_rect, Bitmap* dst_bm, int16_
 
 //! Blit from source bitmap to distination bitmap. 
 //! The source and destination bitmaps can be the same: you can use this to copy a chunk of pixels from one part of a screen to another. If the destination location cannot fit the entirety of the copied rectangle, the copy will be truncated, but will not return an error. 
+//! Overlapping source and destination rectangles are handled correctly, so a bitmap can be scrolled within itself.
+//! Rows are copied as 32-bit longs where source and destination alignment allows; copies spanning the full width of both bitmaps are done as one contiguous move.
 //! @param	src_bm -- the source bitmap. It must have a valid address within the VRAM memory space.
 //! @param	dst_bm -- the destination bitmap. It must have a valid address within the VRAM memory space. It can be the same bitmap as the source.
 //! @param	src_x -- the upper left coordinate within the source bitmap, for the rectangle you want to copy. May be negative.
@@ -169,45 +177,59 @@ bool Bitmap_BlitRect(Bitmap* src_bm, Rectangle* src_rect, Bitmap* dst_bm, int16_
 //! @param	height -- the scope of the copy, in pixels.
 bool Bitmap_Blit(Bitmap* src_bm, int16_t src_x, int16_t src_y, Bitmap* dst_bm, int16_t dst_x, int16_t dst_y, int16_t width, int16_t height);
 
-//! Tile the source bitmap into the destination bitmap, filling it
-//! The source and destination bitmaps can be the same: you can use this to copy a chunk of pixels from one part of a screen to another. If the destination location cannot fit the entirety of the copied rectangle, the copy will be truncated, but will not return an error. 
-//! @param	src_bm -- the source bitmap. It must have a valid address within the VRAM memory space.
-//! @param	dst_bm -- the destination bitmap. It must have a valid address within the VRAM memory space. It can be the same bitmap as the source.
-//! @param	src_x -- the upper left coordinate within the source bitmap, for the tile you want to copy. Must be non-negative.
-//! @param	src_y -- the upper left coordinate within the source bitmap, for the tile you want to copy. Must be non-negative.
-//! @param	width -- the size of the tile to be derived from the source bitmap, in pixels.
-//! @param	height -- the size of the tile to be derived from the source bitmap, in pixels.
-bool Bitmap_Tile(Bitmap* src_bm, int16_t src_x, int16_t src_y, Bitmap* dst_bm, int16_t width, int16_t height);
-
-//! Tile the source bitmap into the destination bitmap, filling it
-//! The source and destination bitmaps can be the same: you can use this to copy a chunk of pixels from one part of a screen to another. If the destination location cannot fit the entirety of the copied rectangle, the copy will be truncated, but will not return an error. 
-//! @param	src_bm -- the source bitmap. It must have a valid address within the VRAM memory space.
-//! @param	dst_bm -- the destination bitmap. It must have a valid address within the VRAM memory space. It can be the same bitmap as the source.
-//! @param	src_x -- the upper left coordinate within the source bitmap, for the tile you want to copy. Must be non-negative.
-//! @param	src_y -- the upper left coordinate within the source bitmap, for the tile you want to copy. Must be non-negative.
-//! @param	width -- the size of the tile to be derived from the source bitmap, in pixels.
-//! @param	height -- the size of the tile to be derived from the source bitmap, in pixels.
-bool Bitmap_TileV1(Bitmap* src_bm, int16_t src_x, int16_t src_y, Bitmap* dst_bm, int16_t width, int16_t height);
+//! Blit from source bitmap to destination bitmap, skipping any source pixels that match the key color
+//! Works span by span: runs of key-colored pixels are skipped, runs of opaque pixels are copied as a block.
+//! Clipping works the same as Bitmap_Blit(). The source and destination rectangles must not overlap.
+//! @param	src_bm -- the source bitmap. It must have a valid address.
+//! @param	dst_bm -- the destination bitmap. It must have a valid address.
+//! @param	src_x -- the upper left coordinate within the source bitmap, for the rectangle you want to copy. May be negative.
+//! @param	src_y -- the upper left coordinate within the source bitmap, for the rectangle you want to copy. May be negative.
+//! @param	dst_x -- the location within the destination bitmap to copy pixels to. May be negative.
+//! @param	dst_y -- the location within the destination bitmap to copy pixels to. May be negative.
+//! @param	width -- the scope of the copy, in pixels.
+//! @param	height -- the scope of the copy, in pixels.
+//! @param	key_color -- the color LUT index that will be treated as transparent. Destination pixels under key-colored source pixels are left as they were.
+//! @return	Returns false if no part of the rectangle could be copied, or on any error condition
+bool Bitmap_BlitTransparent(Bitmap* src_bm, int16_t src_x, int16_t src_y, Bitmap* dst_bm, int16_t dst_x, int16_t dst_y, int16_t width, int16_t height, uint8_t key_color);
+
+//! Blit from source bitmap to destination bitmap, copying only the pixels that are set in a 1-bit-per-pixel mask
+//! The mask covers the entire source bitmap: bit 7 of the first byte of each mask row corresponds to x=0 in the source bitmap.
+//! Works span by span: whole mask bytes of 0x00 skip 8 pixels at once, runs of set bits are copied as a block.
+//! Clipping works the same as Bitmap_Blit(). The source and destination rectangles must not overlap.
+//! @param	src_bm -- the source bitmap. It must have a valid address.
+//! @param	dst_bm -- the destination bitmap. It must have a valid address.
+//! @param	src_x -- the upper left coordinate within the source bitmap, for the rectangle you want to copy. May be negative.
+//! @param	src_y -- the upper left coordinate within the source bitmap, for the rectangle you want to copy. May be negative.
+//! @param	dst_x -- the location within the destination bitmap to copy pixels to. May be negative.
+//! @param	dst_y -- the location within the destination bitmap to copy pixels to. May be negative.
+//! @param	width -- the scope of the copy, in pixels.
+//! @param	height -- the scope of the copy, in pixels.
+//! @param	the_mask -- 1-bpp mask, MSB first. 1=copy the source pixel, 0=leave the destination pixel alone.
+//! @param	mask_row_bytes -- the number of bytes per row in the mask. Must be at least (src_bm->width_ + 7) / 8.
+//! @return	Returns false if no part of the rectangle could be copied, or on any error condition
+bool Bitmap_BlitMasked(Bitmap* src_bm, int16_t src_x, int16_t src_y, Bitmap* dst_bm, int16_t dst_x, int16_t dst_y, int16_t width, int16_t height, uint8_t* the_mask, int16_t mask_row_bytes);
 
 //! Tile the source bitmap into the destination bitmap, filling it
-//! The source and destination bitmaps can be the same: you can use this to copy a chunk of pixels from one part of a screen to another. If the destination location cannot fit the entirety of the copied rectangle, the copy will be truncated, but will not return an error. 
 //! @param	src_bm -- the source bitmap. It must have a valid address within the VRAM memory space.
-//! @param	dst_bm -- the destination bitmap. It must have a valid address within the VRAM memory space. It can be the same bitmap as the source.
+//! @param	dst_bm -- the destination bitmap. It must have a valid address within the VRAM memory space.
 //! @param	src_x -- the upper left coordinate within the source bitmap, for the tile you want to copy. Must be non-negative.
 //! @param	src_y -- the upper left coordinate within the source bitmap, for the tile you want to copy. Must be non-negative.
 //! @param	width -- the size of the tile to be derived from the source bitmap, in pixels.
 //! @param	height -- the size of the tile to be derived from the source bitmap, in pixels.
-bool Bitmap_TileV2(Bitmap* src_bm, int16_t src_x, int16_t src_y, Bitmap* dst_bm, int16_t width, int16_t height);
+//! @return	returns false on any error/invalid input.
+bool Bitmap_Tile(Bitmap* src_bm, int16_t src_x, int16_t src_y, Bitmap* dst_bm, int16_t width, int16_t height);
 
-//! Tile the source bitmap into the destination bitmap, filling it
-//! The source and destination bitmaps can be the same: you can use this to copy a chunk of pixels from one part of a screen to another. If the destination location cannot fit the entirety of the copied rectangle, the copy will be truncated, but will not return an error. 
+//! Tile the source bitmap into part of the destination bitmap
+//! The pattern is anchored to the destination bitmap's 0, 0, not to the corner of the rect: tiling any set of rects produces the same pixels as tiling the whole bitmap would have there.
 //! @param	src_bm -- the source bitmap. It must have a valid address within the VRAM memory space.
-//! @param	dst_bm -- the destination bitmap. It must have a valid address within the VRAM memory space. It can be the same bitmap as the source.
+//! @param	dst_bm -- the destination bitmap. It must have a valid address within the VRAM memory space. It must not be the same bitmap as the source.
 //! @param	src_x -- the upper left coordinate within the source bitmap, for the tile you want to copy. Must be non-negative.
 //! @param	src_y -- the upper left coordinate within the source bitmap, for the tile you want to copy. Must be non-negative.
 //! @param	width -- the size of the tile to be derived from the source bitmap, in pixels.
 //! @param	height -- the size of the tile to be derived from the source bitmap, in pixels.
-bool Bitmap_TileV3(Bitmap* src_bm, int16_t src_x, int16_t src_y, Bitmap* dst_bm, int16_t width, int16_t height);
+//! @param	the_dst_rect -- the area of the destination bitmap to fill (MaxX and MaxY are included). It is limited to the bitmap. Pass NULL to fill the whole bitmap.
+//! @return	returns false on any error/invalid input. A rect entirely off the bitmap is not an error.
+bool Bitmap_TileRect(Bitmap* src_bm, int16_t src_x, int16_t src_y, Bitmap* dst_bm, int16_t width, int16_t height, Rectangle* the_dst_rect);
 
 
 
@@ -229,6 +251,26 @@ bool Bitmap_FillBoxRect(Bitmap* the_bitmap, Rectangle* the_coords, uint8_t the_c
 //! @return	returns false on any error/invalid input.
 bool Bitmap_FillBox(Bitmap* the_bitmap, int16_t x, int16_t y, int16_t width, int16_t height, uint8_t the_color);
 
+//! Flood fill: replace the color of every pixel connected to the passed coordinate that has the same color it does
+//! Works a row-run at a time from a fixed-size work queue, so stack use does not depend on the size or shape of the area filled
+//! @param	the_bitmap -- reference to a valid Bitmap object.
+//! @param	x -- the horizontal position of the starting pixel, between 0 and bitmap width - 1
+//! @param	y -- the vertical position of the starting pixel, between 0 and bitmap height - 1
+//! @param	the_color -- a 1-byte index to the current LUT
+//! @param	eight_way -- PARAM_FILL_8_WAY to also spread to diagonally touching pixels, or PARAM_FILL_4_WAY to only spread up, down, left, and right
+//! @return	returns false on any error/invalid input.
+bool Bitmap_FloodFill(Bitmap* the_bitmap, int16_t x, int16_t y, uint8_t the_color, bool eight_way);
+
+//! Flood fill with a pattern: as Bitmap_FloodFill, but the filled pixels are taken from a tile bitmap, repeated across the target
+//! The tile is anchored to the target bitmap's 0,0, so adjacent fills line up. The pattern may contain the color being replaced.
+//! @param	the_bitmap -- reference to a valid Bitmap object.
+//! @param	x -- the horizontal position of the starting pixel, between 0 and bitmap width - 1
+//! @param	y -- the vertical position of the starting pixel, between 0 and bitmap height - 1
+//! @param	the_pattern -- reference to a valid Bitmap object, the whole of which is used as the tile
+//! @param	eight_way -- PARAM_FILL_8_WAY to also spread to diagonally touching pixels, or PARAM_FILL_4_WAY to only spread up, down, left, and right
+//! @return	returns false on any error/invalid input.
+bool Bitmap_FloodFillPattern(Bitmap* the_bitmap, int16_t x, int16_t y, Bitmap* the_pattern, bool eight_way);
+
 
 
 
@@ -314,16 +356,26 @@ uint8_t Bitmap_GetPixelAtXY(Bitmap* the_bitmap, int16_t x, int16_t y);
 
 
 //! Draws a line between 2 passed coordinates.
-//! Use for any line that is not perfectly vertical or perfectly horizontal
-//! Based on http://rosettacode.org/wiki/Bitmap/Bresenham%27s_line_algorithm#C. Used in C128 Lich King. 
+//! The line is clipped to the bitmap: either end, or both, may be off the bitmap. Horizontal and vertical lines are drawn by the same fast paths as Bitmap_DrawHLine and Bitmap_DrawVLine.
+//! @param	the_color -- a 1-byte index to the current LUT
+//! @return	returns false on any error/invalid input. A line entirely off the bitmap is not an error.
 bool Bitmap_DrawLine(Bitmap* the_bitmap, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint8_t the_color);
 
+//! Draws a line between 2 passed coordinates, drawing only the part that is within the passed clip rect
+//! Either end, or both, may be outside the clip rect and the bitmap. The pixels drawn are the same ones an unclipped line would draw within the clip rect.
+//! @param	the_color -- a 1-byte index to the current LUT
+//! @param	the_clip_rect -- rect, in bitmap coordinates, to confine drawing to (MaxX and MaxY are included). It is limited to the bitmap. Pass NULL to clip to the bitmap only.
+//! @return	returns false on any error/invalid input. A line entirely outside the clip rect is not an error.
+bool Bitmap_DrawLineClipped(Bitmap* the_bitmap, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint8_t the_color, Rectangle* the_clip_rect);
+
 //! Draws a horizontal line from specified coords, for n pixels, using the specified pixel value
+//! Any part of the line past the right edge of the bitmap is skipped.
 //! @param	the_color -- a 1-byte index to the current LUT
 //! @return	returns false on any error/invalid input.
 bool Bitmap_DrawHLine(Bitmap* the_bitmap, int16_t x, int16_t y, int16_t the_line_len, uint8_t the_color);
 
 //! Draws a vertical line from specified coords, for n pixels
+//! Any part of the line past the bottom edge of the bitmap is skipped.
 //! @param	the_color -- a 1-byte index to the current LUT
 //! @return	returns false on any error/invalid input.
 bool Bitmap_DrawVLine(Bitmap* the_bitmap, int16_t x, int16_t y, int16_t the_line_len, uint8_t the_color);
@@ -346,18 +398,46 @@ bool Bitmap_DrawBoxCoords(Bitmap* the_bitmap, int16_t x1, int16_t y1, int16_t x2
 //! @return	returns false on any error/invalid input.
 bool Bitmap_DrawBox(Bitmap* the_bitmap, int16_t x, int16_t y, int16_t width, int16_t height, uint8_t the_color, bool do_fill);
 
+//! Draws the outline of a rectangle by XORing each outline pixel with the passed value
+//! Each outline pixel is changed exactly once, so drawing the same box a second time restores the bitmap to what it was. 
+//! Parts of the box that fall outside the bitmap are skipped, so the box may be partly or entirely off the bitmap.
+//! @param	width -- width, in pixels, of the rectangle to be drawn
+//! @param	height -- height, in pixels, of the rectangle to be drawn
+//! @param	the_xor_value -- value each pixel of the outline will be XORed with
+//! @return	returns false on any error/invalid input.
+bool Bitmap_DrawBoxXOR(Bitmap* the_bitmap, int16_t x, int16_t y, int16_t width, int16_t height, uint8_t the_xor_value);
+
 //! Draws a rounded rectangle with the specified size and radius, and optionally fills the rectangle.
+//! The fill is drawn one horizontal span per row, so it takes time proportional to the box's area.
 //! @param	width -- width, in pixels, of the rectangle to be drawn
 //! @param	height -- height, in pixels, of the rectangle to be drawn
-//! @param	radius -- radius, in pixels, of the arc to be applied to the rectangle's corners. Enforces a minimum of 3, maximum of 20.
+//! @param	radius -- radius, in pixels, of the arc to be applied to the rectangle's corners. 0 draws square corners. A radius too big for the box is reduced to the largest that fits.
 //! @param	the_color -- a 1-byte index to the current color LUT
 //! @param	do_fill -- If true, the box will be filled with the provided color. If false, the box will only draw the outline.
 //! @return	returns false on any error/invalid input.
 bool Bitmap_DrawRoundBox(Bitmap* the_bitmap, int16_t x, int16_t y, int16_t width, int16_t height, int16_t radius, uint8_t the_color, bool do_fill);
 
-//! Draw a circle
+//! Draw a circle, and optionally fill it
+//! Parts of the circle that fall outside the bitmap are skipped.
 //! Based on http://rosettacode.org/wiki/Bitmap/Midpoint_circle_algorithm#C
-bool Bitmap_DrawCircle(Bitmap* the_bitmap, int16_t x1, int16_t y1, int16_t radius, uint8_t the_color);
+//! @param	x1 -- the horizontal position of the center of the circle. Must be within the bitmap.
+//! @param	y1 -- the vertical position of the center of the circle. Must be within the bitmap.
+//! @param	radius -- radius, in pixels. Must be between 0 and BITMAP_MAX_ELLIPSE_RADIUS.
+//! @param	the_color -- a 1-byte index to the current color LUT
+//! @param	do_fill -- If true, the circle will be filled with the provided color. If false, only the outline will be drawn.
+//! @return	returns false on any error/invalid input.
+bool Bitmap_DrawCircle(Bitmap* the_bitmap, int16_t x1, int16_t y1, int16_t radius, uint8_t the_color, bool do_fill);
+
+//! Draw an ellipse, and optionally fill it
+//! Parts of the ellipse that fall outside the bitmap are skipped.
+//! @param	x1 -- the horizontal position of the center of the ellipse. Must be within the bitmap.
+//! @param	y1 -- the vertical position of the center of the ellipse. Must be within the bitmap.
+//! @param	x_radius -- horizontal radius, in pixels. Must be between 0 and BITMAP_MAX_ELLIPSE_RADIUS.
+//! @param	y_radius -- vertical radius, in pixels. Must be between 0 and BITMAP_MAX_ELLIPSE_RADIUS.
+//! @param	the_color -- a 1-byte index to the current color LUT
+//! @param	do_fill -- If true, the ellipse will be filled with the provided color. If false, only the outline will be drawn.
+//! @return	returns false on any error/invalid input.
+bool Bitmap_DrawEllipse(Bitmap* the_bitmap, int16_t x1, int16_t y1, int16_t x_radius, int16_t y_radius, uint8_t the_color, bool do_fill);
 
 
 
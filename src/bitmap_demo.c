@@ -372,13 +372,13 @@ void Demo_Bitmap_DrawCircle(void)
 
 	for (i = 0; i < 256 && radius < 238; i += 3)
 	{
-		Bitmap_DrawCircle(Sys_GetScreenBitmap(global_system, back_layer), x1, y1, radius, (uint8_t)i);
+		Bitmap_DrawCircle(Sys_GetScreenBitmap(global_system, back_layer), x1, y1, radius, (uint8_t)i, PARAM_DO_NOT_FILL);
 		
 		radius += 3;
 	}
 
-	Bitmap_DrawCircle(Sys_GetScreenBitmap(global_system, back_layer), 25, 25, 12, 0xff);
-	Bitmap_DrawCircle(Sys_GetScreenBitmap(global_system, back_layer), 25, 25, 15, 0xff);
+	Bitmap_DrawCircle(Sys_GetScreenBitmap(global_system, back_layer), 25, 25, 12, 0xff, PARAM_DO_NOT_FILL);
+	Bitmap_DrawCircle(Sys_GetScreenBitmap(global_system, back_layer), 25, 25, 15, 0xff, PARAM_DO_NOT_FILL);
 
 	WaitForUser();
 }
@@ -403,9 +403,9 @@ void Demo_Bitmap_Blit1(void)
 		color += 7;
 	}
 	
- 	Bitmap_DrawCircle(Sys_GetScreenBitmap(global_system, back_layer), 25, 25, 12, 0x88);
-	Bitmap_DrawCircle(Sys_GetScreenBitmap(global_system, back_layer), 25, 25, 15, 0xcc);
-	Bitmap_DrawCircle(Sys_GetScreenBitmap(global_system, back_layer), 25, 25, 20, 0xff);
+ 	Bitmap_DrawCircle(Sys_GetScreenBitmap(global_system, back_layer), 25, 25, 12, 0x88, PARAM_DO_NOT_FILL);
+	Bitmap_DrawCircle(Sys_GetScreenBitmap(global_system, back_layer), 25, 25, 15, 0xcc, PARAM_DO_NOT_FILL);
+	Bitmap_DrawCircle(Sys_GetScreenBitmap(global_system, back_layer), 25, 25, 20, 0xff, PARAM_DO_NOT_FILL);
 
 	// copy bits of this screen to other parts of the Screen
 	src_bm = Sys_GetScreenBitmap(global_system, back_layer);
@@ -462,9 +462,9 @@ void Demo_Bitmap_BlitRect(void)
 		color += 4;
 	}
 	
- 	Bitmap_DrawCircle(Sys_GetScreenBitmap(global_system, back_layer), 25, 25, 12, SYS_COLOR_RED1);
-	Bitmap_DrawCircle(Sys_GetScreenBitmap(global_system, back_layer), 25, 25, 15, SYS_COLOR_GREEN1);
-	Bitmap_DrawCircle(Sys_GetScreenBitmap(global_system, back_layer), 25, 25, 20, SYS_COLOR_BLUE1);
+ 	Bitmap_DrawCircle(Sys_GetScreenBitmap(global_system, back_layer), 25, 25, 12, SYS_COLOR_RED1, PARAM_DO_NOT_FILL);
+	Bitmap_DrawCircle(Sys_GetScreenBitmap(global_system, back_layer), 25, 25, 15, SYS_COLOR_GREEN1, PARAM_DO_NOT_FILL);
+	Bitmap_DrawCircle(Sys_GetScreenBitmap(global_system, back_layer), 25, 25, 20, SYS_COLOR_BLUE1, PARAM_DO_NOT_FILL);
 
 	// copy bits of this screen to other parts of the Screen
 	src_bm = Sys_GetScreenBitmap(global_system, back_layer);
@@ -27,6 +27,9 @@
 
 // C includes
 #include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
 
 // A2560 includes
@@ -38,6 +41,12 @@
 /*                               Definitions                                 */
 /*****************************************************************************/
 
+#define BLIT_SPEED_TEST_WIDTH		640	// size of the RAM bitmaps used for blit speed tests
+#define BLIT_SPEED_TEST_HEIGHT		400
+
+#define FILL_SPEED_TEST_WIDTH		800	// size of the RAM bitmap used for flood fill stress tests (full 800x600 screen)
+#define FILL_SPEED_TEST_HEIGHT		600
+
 
 
 /*****************************************************************************/
@@ -59,6 +68,24 @@ System*			global_system;
 /*                       Private Function Prototypes                         */
 /*****************************************************************************/
 
+// the per-row memcpy blit that Bitmap_Blit used before the long-word engine. kept here as a speed reference.
+bool Bitmap_BlitLegacy(Bitmap* src_bm, int16_t src_x, int16_t src_y, Bitmap* dst_bm, int16_t dst_x, int16_t dst_y, int16_t width, int16_t height);
+
+// fill a bitmap with a repeatable, non-uniform pattern so misplaced pixels are detectable
+void Test_FillBitmapWithPattern(Bitmap* the_bitmap);
+
+// check that the top-left width x height pixels of a bitmap still hold the pattern from Test_FillBitmapWithPattern
+bool Test_BitmapKeptPattern(Bitmap* the_bitmap, int16_t width, int16_t height);
+
+// report the rate for a speed test, in bytes per second
+uint32_t Test_BytesPerSecond(uint32_t the_bytes, long the_ticks);
+
+// count the pixels in a bitmap that have the passed color
+uint32_t Test_CountPixelsOfColor(Bitmap* the_bitmap, uint8_t the_color);
+
+// draw a maze of vertical walls, alternately open at the bottom and the top, so a fill has to snake through every corridor
+void Test_DrawSerpentine(Bitmap* the_bitmap, uint8_t the_wall_color);
+
 
 
 /*****************************************************************************/
@@ -66,6 +93,120 @@ System*			global_system;
 /*****************************************************************************/
 
 
+// the per-row memcpy blit that Bitmap_Blit used before the long-word engine. kept here as a speed reference.
+// clipping is only what the old version did, so only call it with rects fully within both bitmaps.
+bool Bitmap_BlitLegacy(Bitmap* src_bm, int16_t src_x, int16_t src_y, Bitmap* dst_bm, int16_t dst_x, int16_t dst_y, int16_t width, int16_t height)
+{
+	uint32_t		the_read_loc_int;
+	uint32_t		the_write_loc_int;
+	int16_t			j;
+	
+	the_read_loc_int = src_bm->addr_int_ + ((uint32_t)src_bm->width_ * (uint32_t)src_y) + (uint32_t)src_x;
+	the_write_loc_int = dst_bm->addr_int_ + ((uint32_t)dst_bm->width_ * (uint32_t)dst_y) + (uint32_t)dst_x;
+	
+	for (j = 0; j < height; j++)
+	{
+		memcpy((uint8_t*)the_write_loc_int, (uint8_t*)the_read_loc_int, (uint32_t)width);
+		the_write_loc_int += (uint32_t)dst_bm->width_;
+		the_read_loc_int += (uint32_t)src_bm->width_;
+	}
+
+	return true;
+}
+
+
+// fill a bitmap with a repeatable, non-uniform pattern so misplaced pixels are detectable
+void Test_FillBitmapWithPattern(Bitmap* the_bitmap)
+{
+	int16_t		x;
+	int16_t		y;
+	uint8_t*	the_write_loc = the_bitmap->addr_;
+	
+	for (y = 0; y < the_bitmap->height_; y++)
+	{
+		for (x = 0; x < the_bitmap->width_; x++)
+		{
+			*the_write_loc++ = (uint8_t)(x * 7 + y * 13);
+		}
+	}
+}
+
+
+// check that the top-left width x height pixels of a bitmap still hold the pattern from Test_FillBitmapWithPattern
+bool Test_BitmapKeptPattern(Bitmap* the_bitmap, int16_t width, int16_t height)
+{
+	int16_t		x;
+	int16_t		y;
+	
+	for (y = 0; y < height; y++)
+	{
+		for (x = 0; x < width; x++)
+		{
+			if (the_bitmap->addr_[(uint32_t)y * the_bitmap->width_ + x] != (uint8_t)(x * 7 + y * 13))
+			{
+				return false;
+			}
+		}
+	}
+	
+	return true;
+}
+
+
+// report the rate for a speed test, in bytes per second
+uint32_t Test_BytesPerSecond(uint32_t the_bytes, long the_ticks)
+{
+	if (the_ticks < 1)
+	{
+		the_ticks = 1;
+	}
+	
+	return (uint32_t)(((double)the_bytes * SYS_TICKS_PER_SEC) / (double)the_ticks);
+}
+
+
+// count the pixels in a bitmap that have the passed color
+uint32_t Test_CountPixelsOfColor(Bitmap* the_bitmap, uint8_t the_color)
+{
+	uint32_t	the_count = 0;
+	uint32_t	i;
+	uint32_t	the_len = (uint32_t)the_bitmap->width_ * (uint32_t)the_bitmap->height_;
+	uint8_t*	the_read_loc = the_bitmap->addr_;
+	
+	for (i = 0; i < the_len; i++)
+	{
+		if (*the_read_loc++ == the_color)
+		{
+			++the_count;
+		}
+	}
+	
+	return the_count;
+}
+
+
+// draw a maze of vertical walls, alternately open at the bottom and the top, so a fill has to snake through every corridor
+void Test_DrawSerpentine(Bitmap* the_bitmap, uint8_t the_wall_color)
+{
+	int16_t		x;
+	int16_t		wall_num = 0;
+	
+	for (x = 1; x < the_bitmap->width_; x += 2)
+	{
+		if (wall_num & 1)
+		{
+			Bitmap_DrawVLine(the_bitmap, x, 1, the_bitmap->height_ - 1, the_wall_color);
+		}
+		else
+		{
+			Bitmap_DrawVLine(the_bitmap, x, 0, the_bitmap->height_ - 1, the_wall_color);
+		}
+		
+		++wall_num;
+	}
+}
+
+
 
 
 
@@ -91,31 +232,639 @@ void test_teardown(void)	// this is called EVERY test
 
 
 
+// **** unit tests
+
+MU_TEST(test_blit_clipping)
+{
+	Bitmap*		src_bm;
+	Bitmap*		dst_bm;
+	
+	src_bm = Bitmap_New(20, 10, NULL, PARAM_NOT_IN_VRAM);
+	dst_bm = Bitmap_New(30, 20, NULL, PARAM_NOT_IN_VRAM);
+	mu_assert(src_bm != NULL && dst_bm != NULL, "could not allocate test bitmaps");
+	
+	Test_FillBitmapWithPattern(src_bm);
+	Bitmap_FillMemory(dst_bm, 0xFF);
+	
+	// source starting off the top-left edge: pixel (0,0) of the source should land at (dst_x + 3, dst_y + 2)
+	mu_check( Bitmap_Blit(src_bm, -3, -2, dst_bm, 5, 5, 10, 10) == true );
+	mu_assert_int_eq(Bitmap_GetPixelAtXY(src_bm, 0, 0), Bitmap_GetPixelAtXY(dst_bm, 8, 7));
+	mu_assert_int_eq(0xFF, Bitmap_GetPixelAtXY(dst_bm, 7, 7));
+	mu_assert_int_eq(0xFF, Bitmap_GetPixelAtXY(dst_bm, 8, 6));
+
+	// target starting off the top-left edge
+	Bitmap_FillMemory(dst_bm, 0xFF);
+	mu_check( Bitmap_Blit(src_bm, 0, 0, dst_bm, -4, -1, 10, 5) == true );
+	mu_assert_int_eq(Bitmap_GetPixelAtXY(src_bm, 4, 1), Bitmap_GetPixelAtXY(dst_bm, 0, 0));
+	mu_assert_int_eq(0xFF, Bitmap_GetPixelAtXY(dst_bm, 6, 0));
+	
+	// entirely off-target
+	mu_check( Bitmap_Blit(src_bm, 0, 0, dst_bm, 30, 0, 10, 5) == false );
+	mu_check( Bitmap_Blit(src_bm, 0, 0, dst_bm, -10, 0, 10, 5) == false );
+	
+	Bitmap_Destroy(&src_bm);
+	Bitmap_Destroy(&dst_bm);
+}
+
+
+MU_TEST(test_blit_overlap)
+{
+	Bitmap*		the_bitmap;
+	Bitmap*		the_copy;
+	int16_t		x;
+	int16_t		y;
+	
+	the_bitmap = Bitmap_New(37, 23, NULL, PARAM_NOT_IN_VRAM);
+	the_copy = Bitmap_New(37, 23, NULL, PARAM_NOT_IN_VRAM);
+	mu_assert(the_bitmap != NULL && the_copy != NULL, "could not allocate test bitmaps");
+	
+	// scroll down and right within the same bitmap: every moved pixel must match the original, not a smeared copy
+	Test_FillBitmapWithPattern(the_bitmap);
+	Test_FillBitmapWithPattern(the_copy);
+	mu_check( Bitmap_Blit(the_bitmap, 1, 2, the_bitmap, 4, 3, 30, 18) == true );
+	
+	for (y = 0; y < 18; y++)
+	{
+		for (x = 0; x < 30; x++)
+		{
+			mu_assert_int_eq(Bitmap_GetPixelAtXY(the_copy, x + 1, y + 2), Bitmap_GetPixelAtXY(the_bitmap, x + 4, y + 3));
+		}
+	}
+
+	// scroll up and left
+	Test_FillBitmapWithPattern(the_bitmap);
+	mu_check( Bitmap_Blit(the_bitmap, 5, 4, the_bitmap, 2, 1, 30, 18) == true );
+	
+	for (y = 0; y < 18; y++)
+	{
+		for (x = 0; x < 30; x++)
+		{
+			mu_assert_int_eq(Bitmap_GetPixelAtXY(the_copy, x + 5, y + 4), Bitmap_GetPixelAtXY(the_bitmap, x + 2, y + 1));
+		}
+	}
+
+	// full-width scroll down by one row, which goes through the single contiguous move
+	Test_FillBitmapWithPattern(the_bitmap);
+	mu_check( Bitmap_Blit(the_bitmap, 0, 0, the_bitmap, 0, 1, 37, 22) == true );
+	
+	for (y = 0; y < 22; y++)
+	{
+		for (x = 0; x < 37; x++)
+		{
+			mu_assert_int_eq(Bitmap_GetPixelAtXY(the_copy, x, y), Bitmap_GetPixelAtXY(the_bitmap, x, y + 1));
+		}
+	}
+	
+	Bitmap_Destroy(&the_bitmap);
+	Bitmap_Destroy(&the_copy);
+}
+
+
+
+MU_TEST(test_blit_transparent_and_masked)
+{
+	Bitmap*		src_bm;
+	Bitmap*		dst_bm;
+	uint8_t		the_mask[2 * 4];
+	int16_t		x;
+	
+	// 12x4 source: left half key color 0, right half color 9
+	src_bm = Bitmap_New(12, 4, NULL, PARAM_NOT_IN_VRAM);
+	dst_bm = Bitmap_New(20, 10, NULL, PARAM_NOT_IN_VRAM);
+	mu_assert(src_bm != NULL && dst_bm != NULL, "could not allocate test bitmaps");
+	
+	Bitmap_FillMemory(src_bm, 0);
+	Bitmap_FillBox(src_bm, 6, 0, 6, 3, 9);
+	Bitmap_FillMemory(dst_bm, 0xFF);
+	
+	mu_check( Bitmap_BlitTransparent(src_bm, 0, 0, dst_bm, 2, 2, 12, 4, 0) == true );
+	
+	for (x = 0; x < 6; x++)
+	{
+		mu_assert_int_eq(0xFF, Bitmap_GetPixelAtXY(dst_bm, 2 + x, 3));
+		mu_assert_int_eq(9, Bitmap_GetPixelAtXY(dst_bm, 8 + x, 3));
+	}
+	
+	// same source, but now only copy where the mask says: first 3 pixels and last 3 pixels of each row
+	Test_FillBitmapWithPattern(src_bm);
+	Bitmap_FillMemory(dst_bm, 0xFF);
+	
+	for (x = 0; x < 4; x++)
+	{
+		the_mask[x * 2] = 0xE0;		// 1110 0000
+		the_mask[x * 2 + 1] = 0x70;	// 0111 0000 -> pixels 9, 10, 11
+	}
+	
+	mu_check( Bitmap_BlitMasked(src_bm, 0, 0, dst_bm, 0, 0, 12, 4, the_mask, 2) == true );
+	
+	for (x = 0; x < 12; x++)
+	{
+		if (x < 3 || x > 8)
+		{
+			mu_assert_int_eq(Bitmap_GetPixelAtXY(src_bm, x, 1), Bitmap_GetPixelAtXY(dst_bm, x, 1));
+		}
+		else
+		{
+			mu_assert_int_eq(0xFF, Bitmap_GetPixelAtXY(dst_bm, x, 1));
+		}
+	}
+	
+	Bitmap_Destroy(&src_bm);
+	Bitmap_Destroy(&dst_bm);
+}
+
+
+
+MU_TEST(test_draw_box_xor)
+{
+	Bitmap*		the_bitmap;
+	Bitmap*		the_copy;
+	int16_t		x;
+	int16_t		y;
+	int16_t		num_changed;
+	
+	the_bitmap = Bitmap_New(30, 20, NULL, PARAM_NOT_IN_VRAM);
+	the_copy = Bitmap_New(30, 20, NULL, PARAM_NOT_IN_VRAM);
+	mu_assert(the_bitmap != NULL && the_copy != NULL, "could not allocate test bitmaps");
+	
+	Test_FillBitmapWithPattern(the_bitmap);
+	Test_FillBitmapWithPattern(the_copy);
+	
+	// a 10x6 box fully on the bitmap changes exactly its 28 outline pixels, each flipped once
+	mu_check( Bitmap_DrawBoxXOR(the_bitmap, 5, 4, 10, 6, 0xFF) == true );
+	num_changed = 0;
+	
+	for (y = 0; y < 20; y++)
+	{
+		for (x = 0; x < 30; x++)
+		{
+			if (Bitmap_GetPixelAtXY(the_bitmap, x, y) != Bitmap_GetPixelAtXY(the_copy, x, y))
+			{
+				mu_assert_int_eq(Bitmap_GetPixelAtXY(the_copy, x, y) ^ 0xFF, Bitmap_GetPixelAtXY(the_bitmap, x, y));
+				++num_changed;
+			}
+		}
+	}
+	
+	mu_assert_int_eq(28, num_changed);
+	
+	// drawing it again restores the bitmap, including for boxes hanging off each edge, and 1 pixel wide/high boxes
+	mu_check( Bitmap_DrawBoxXOR(the_bitmap, 5, 4, 10, 6, 0xFF) == true );
+	mu_check( Bitmap_DrawBoxXOR(the_bitmap, -3, -2, 10, 8, 0x5A) == true );
+	mu_check( Bitmap_DrawBoxXOR(the_bitmap, 25, 15, 10, 10, 0x5A) == true );
+	mu_check( Bitmap_DrawBoxXOR(the_bitmap, 12, 3, 1, 9, 0x5A) == true );
+	mu_check( Bitmap_DrawBoxXOR(the_bitmap, 40, 3, 5, 5, 0x5A) == true );
+	mu_check( Bitmap_DrawBoxXOR(the_bitmap, 40, 3, 5, 5, 0x5A) == true );
+	mu_check( Bitmap_DrawBoxXOR(the_bitmap, 12, 3, 1, 9, 0x5A) == true );
+	mu_check( Bitmap_DrawBoxXOR(the_bitmap, 25, 15, 10, 10, 0x5A) == true );
+	mu_check( Bitmap_DrawBoxXOR(the_bitmap, -3, -2, 10, 8, 0x5A) == true );
+	
+	for (y = 0; y < 20; y++)
+	{
+		for (x = 0; x < 30; x++)
+		{
+			mu_assert_int_eq(Bitmap_GetPixelAtXY(the_copy, x, y), Bitmap_GetPixelAtXY(the_bitmap, x, y));
+		}
+	}
+	
+	Bitmap_Destroy(&the_bitmap);
+	Bitmap_Destroy(&the_copy);
+}
+
+
+
+MU_TEST(test_tile_rect)
+{
+	Bitmap*		the_bitmap;
+	Bitmap*		the_pattern;
+	Rectangle	the_rect;
+	int16_t		x;
+	int16_t		y;
+	
+	the_bitmap = Bitmap_New(50, 40, NULL, PARAM_NOT_IN_VRAM);
+	the_pattern = Bitmap_New(12, 10, NULL, PARAM_NOT_IN_VRAM);
+	mu_assert(the_bitmap != NULL && the_pattern != NULL, "could not allocate test bitmaps");
+	
+	Test_FillBitmapWithPattern(the_pattern);
+	
+	// whole-bitmap tile, using a 7x5 tile from inside the pattern bitmap
+	mu_check( Bitmap_Tile(the_pattern, 2, 3, the_bitmap, 7, 5) == true );
+	
+	for (y = 0; y < 40; y++)
+	{
+		for (x = 0; x < 50; x++)
+		{
+			mu_assert_int_eq(Bitmap_GetPixelAtXY(the_pattern, 2 + x % 7, 3 + y % 5), Bitmap_GetPixelAtXY(the_bitmap, x, y));
+		}
+	}
+	
+	// a rect that doesn't line up with the tile keeps the phase of the whole-bitmap tile, and nothing outside it is touched
+	Bitmap_FillMemory(the_bitmap, 0xEE);
+	the_rect.MinX = 9;
+	the_rect.MinY = 6;
+	the_rect.MaxX = 44;
+	the_rect.MaxY = 33;
+	mu_check( Bitmap_TileRect(the_pattern, 2, 3, the_bitmap, 7, 5, &the_rect) == true );
+	
+	for (y = 0; y < 40; y++)
+	{
+		for (x = 0; x < 50; x++)
+		{
+			if (x >= the_rect.MinX && x <= the_rect.MaxX && y >= the_rect.MinY && y <= the_rect.MaxY)
+			{
+				mu_assert_int_eq(Bitmap_GetPixelAtXY(the_pattern, 2 + x % 7, 3 + y % 5), Bitmap_GetPixelAtXY(the_bitmap, x, y));
+			}
+			else
+			{
+				mu_assert_int_eq(0xEE, Bitmap_GetPixelAtXY(the_bitmap, x, y));
+			}
+		}
+	}
+	
+	// rects narrower than the tile, hanging off the bitmap, or entirely off it
+	the_rect.MinX = 47;
+	the_rect.MinY = -4;
+	the_rect.MaxX = 60;
+	the_rect.MaxY = 1;
+	mu_check( Bitmap_TileRect(the_pattern, 0, 0, the_bitmap, 12, 10, &the_rect) == true );
+	mu_assert_int_eq(Bitmap_GetPixelAtXY(the_pattern, 47 % 12, 1), Bitmap_GetPixelAtXY(the_bitmap, 47, 1));
+	mu_assert_int_eq(Bitmap_GetPixelAtXY(the_pattern, 49 % 12, 0), Bitmap_GetPixelAtXY(the_bitmap, 49, 0));
+	mu_assert_int_eq(0xEE, Bitmap_GetPixelAtXY(the_bitmap, 46, 0));
+	mu_assert_int_eq(0xEE, Bitmap_GetPixelAtXY(the_bitmap, 47, 2));
+	
+	the_rect.MinX = 60;
+	the_rect.MaxX = 70;
+	mu_check( Bitmap_TileRect(the_pattern, 0, 0, the_bitmap, 12, 10, &the_rect) == true );
+	
+	// the tile must be within the source
+	mu_check( Bitmap_TileRect(the_pattern, 6, 0, the_bitmap, 7, 5, NULL) == false );
+	mu_check( Bitmap_TileRect(the_pattern, 0, 0, the_bitmap, 0, 5, NULL) == false );
+	
+	Bitmap_Destroy(&the_bitmap);
+	Bitmap_Destroy(&the_pattern);
+}
+
+
+MU_TEST(test_draw_line_clipping)
+{
+	Bitmap*		the_bitmap;
+	Bitmap*		the_reference;
+	Rectangle	the_clip;
+	int16_t		x;
+	int16_t		y;
+	int16_t		i;
+	int16_t		in_clip;
+	int16_t		the_lines[6][4] = 
+	{
+		{-10, -5, 50, 40},
+		{45, -20, -8, 33},
+		{20, -30, 25, 60},
+		{-50, 12, 90, 14},
+		{5, 29, 39, 0},
+		{-100, -100, -1, 70},
+	};
+	
+	// the reference is big enough to hold every test line whole, offset by 100, 100
+	the_bitmap = Bitmap_New(40, 30, NULL, PARAM_NOT_IN_VRAM);
+	the_reference = Bitmap_New(240, 230, NULL, PARAM_NOT_IN_VRAM);
+	mu_assert(the_bitmap != NULL && the_reference != NULL, "could not allocate test bitmaps");
+	
+	the_clip.MinX = 8;
+	the_clip.MinY = 5;
+	the_clip.MaxX = 30;
+	the_clip.MaxY = 19;
+	
+	// a clipped line draws exactly the pixels the whole line would have drawn there
+	for (i = 0; i < 6; i++)
+	{
+		Bitmap_FillMemory(the_bitmap, 0);
+		Bitmap_FillMemory(the_reference, 0);
+		mu_check( Bitmap_DrawLine(the_bitmap, the_lines[i][0], the_lines[i][1], the_lines[i][2], the_lines[i][3], 1) == true );
+		mu_check( Bitmap_DrawLineClipped(the_bitmap, the_lines[i][0], the_lines[i][1], the_lines[i][2], the_lines[i][3], 2, &the_clip) == true );
+		mu_check( Bitmap_DrawLine(the_reference, the_lines[i][0] + 100, the_lines[i][1] + 100, the_lines[i][2] + 100, the_lines[i][3] + 100, 1) == true );
+		
+		for (y = 0; y < 30; y++)
+		{
+			for (x = 0; x < 40; x++)
+			{
+				in_clip = (x >= the_clip.MinX && x <= the_clip.MaxX && y >= the_clip.MinY && y <= the_clip.MaxY);
+				
+				if (Bitmap_GetPixelAtXY(the_reference, x + 100, y + 100) == 0)
+				{
+					mu_assert_int_eq(0, Bitmap_GetPixelAtXY(the_bitmap, x, y));
+				}
+				else
+				{
+					mu_assert_int_eq(in_clip ? 2 : 1, Bitmap_GetPixelAtXY(the_bitmap, x, y));
+				}
+			}
+		}
+	}
+	
+	// horizontal and vertical lines hanging off either end are trimmed to the bitmap
+	Bitmap_FillMemory(the_bitmap, 0);
+	mu_check( Bitmap_DrawLine(the_bitmap, -5, 3, 100, 3, 3) == true );
+	mu_check( Bitmap_DrawLine(the_bitmap, 7, 50, 7, -50, 4) == true );
+	mu_assert_int_eq(39, Test_CountPixelsOfColor(the_bitmap, 3));
+	mu_assert_int_eq(30, Test_CountPixelsOfColor(the_bitmap, 4));
+	mu_check( Bitmap_DrawHLine(the_bitmap, 30, 10, 200, 5) == true );
+	mu_assert_int_eq(10, Test_CountPixelsOfColor(the_bitmap, 5));
+	mu_check( Bitmap_DrawVLine(the_bitmap, 20, 25, 200, 6) == true );
+	mu_assert_int_eq(5, Test_CountPixelsOfColor(the_bitmap, 6));
+	
+	// lines entirely off the bitmap or clip rect draw nothing, and are not an error
+	mu_check( Bitmap_DrawLine(the_bitmap, -10, -10, -1, 50, 7) == true );
+	mu_check( Bitmap_DrawLineClipped(the_bitmap, 0, 0, 3, 3, 7, &the_clip) == true );
+	mu_assert_int_eq(0, Test_CountPixelsOfColor(the_bitmap, 7));
+	mu_check( Bitmap_DrawLine(the_bitmap, 0, 0, BITMAP_MAX_LINE_SPAN + 1, 0, 7) == false );
+	
+	Bitmap_Destroy(&the_bitmap);
+	Bitmap_Destroy(&the_reference);
+}
+
+
+MU_TEST(test_draw_round_shapes)
+{
+	Bitmap*		the_bitmap;
+	Bitmap*		the_outline;
+	int16_t		x;
+	int16_t		y;
+	int16_t		radius;
+	int16_t		fill_min;
+	int16_t		fill_max;
+	int16_t		outline_min;
+	int16_t		outline_max;
+	
+	the_bitmap = Bitmap_New(80, 60, NULL, PARAM_NOT_IN_VRAM);
+	the_outline = Bitmap_New(80, 60, NULL, PARAM_NOT_IN_VRAM);
+	mu_assert(the_bitmap != NULL && the_outline != NULL, "could not allocate test bitmaps");
+	
+	// a filled circle covers exactly the same extent on each row as its outline, with no gaps
+	for (radius = 0; radius < 29; radius++)
+	{
+		Bitmap_FillMemory(the_bitmap, 0);
+		Bitmap_FillMemory(the_outline, 0);
+		mu_check( Bitmap_DrawCircle(the_bitmap, 40, 30, radius, 1, PARAM_DO_FILL) == true );
+		mu_check( Bitmap_DrawCircle(the_outline, 40, 30, radius, 1, PARAM_DO_NOT_FILL) == true );
+		
+		for (y = 0; y < 60; y++)
+		{
+			fill_min = fill_max = outline_min = outline_max = -1;
+			
+			for (x = 0; x < 80; x++)
+			{
+				if (Bitmap_GetPixelAtXY(the_bitmap, x, y) != 0)
+				{
+					fill_min = (fill_min < 0) ? x : fill_min;
+					fill_max = x;
+				}
+				
+				if (Bitmap_GetPixelAtXY(the_outline, x, y) != 0)
+				{
+					outline_min = (outline_min < 0) ? x : outline_min;
+					outline_max = x;
+				}
+			}
+			
+			mu_assert_int_eq(outline_min, fill_min);
+			mu_assert_int_eq(outline_max, fill_max);
+			
+			if (fill_min >= 0)
+			{
+				for (x = fill_min; x <= fill_max; x++)
+				{
+					mu_assert_int_eq(1, Bitmap_GetPixelAtXY(the_bitmap, x, y));
+				}
+			}
+		}
+	}
+	
+	// circles may hang off the bitmap, as long as the center is on it
+	mu_check( Bitmap_DrawCircle(the_bitmap, 2, 2, 100, 2, PARAM_DO_FILL) == true );
+	mu_assert_int_eq(80 * 60, Test_CountPixelsOfColor(the_bitmap, 2));
+	mu_check( Bitmap_DrawCircle(the_bitmap, 79, 59, 30, 3, PARAM_DO_NOT_FILL) == true );
+	mu_check( Bitmap_DrawCircle(the_bitmap, 80, 30, 5, 3, PARAM_DO_NOT_FILL) == false );
+	mu_check( Bitmap_DrawCircle(the_bitmap, 40, 30, -1, 3, PARAM_DO_NOT_FILL) == false );
+	mu_check( Bitmap_DrawCircle(the_bitmap, 40, 30, BITMAP_MAX_ELLIPSE_RADIUS, 3, PARAM_DO_FILL) == true );
+	mu_assert_int_eq(80 * 60, Test_CountPixelsOfColor(the_bitmap, 3));
+	mu_check( Bitmap_DrawCircle(the_bitmap, 40, 30, BITMAP_MAX_ELLIPSE_RADIUS + 1, 3, PARAM_DO_NOT_FILL) == false );
+	mu_check( Bitmap_DrawCircle(the_bitmap, 40, 30, 32000, 3, PARAM_DO_FILL) == false );
+	
+	// a round box with radius 0 is a plain box. there is no radius clamp other than the size of the box.
+	Bitmap_FillMemory(the_bitmap, 0);
+	mu_check( Bitmap_DrawRoundBox(the_bitmap, 10, 5, 30, 20, 0, 4, PARAM_DO_FILL) == true );
+	mu_assert_int_eq(30 * 20, Test_CountPixelsOfColor(the_bitmap, 4));
+	mu_assert_int_eq(4, Bitmap_GetPixelAtXY(the_bitmap, 10, 5));
+	mu_assert_int_eq(4, Bitmap_GetPixelAtXY(the_bitmap, 39, 24));
+	
+	Bitmap_FillMemory(the_bitmap, 0);
+	mu_check( Bitmap_DrawRoundBox(the_bitmap, 0, 0, 80, 60, 25, 4, PARAM_DO_FILL) == true );
+	mu_assert_int_eq(0, Bitmap_GetPixelAtXY(the_bitmap, 0, 0));
+	mu_assert_int_eq(0, Bitmap_GetPixelAtXY(the_bitmap, 6, 6));
+	mu_assert_int_eq(4, Bitmap_GetPixelAtXY(the_bitmap, 0, 30));
+	mu_assert_int_eq(4, Bitmap_GetPixelAtXY(the_bitmap, 40, 59));
+	
+	// an outline drawn over its own fill adds no pixels
+	mu_check( Bitmap_DrawRoundBox(the_bitmap, 0, 0, 80, 60, 25, 4, PARAM_DO_NOT_FILL) == true );
+	x = (int16_t)Test_CountPixelsOfColor(the_bitmap, 4);
+	mu_check( Bitmap_DrawRoundBox(the_bitmap, 0, 0, 80, 60, 25, 5, PARAM_DO_NOT_FILL) == true );
+	mu_assert_int_eq(80 * 60 - x, Test_CountPixelsOfColor(the_bitmap, 0));
+	
+	// ellipses: filled rows stay within the radii, and reach them on the axes
+	Bitmap_FillMemory(the_bitmap, 0);
+	mu_check( Bitmap_DrawEllipse(the_bitmap, 40, 30, 35, 12, 6, PARAM_DO_FILL) == true );
+	mu_assert_int_eq(6, Bitmap_GetPixelAtXY(the_bitmap, 5, 30));
+	mu_assert_int_eq(6, Bitmap_GetPixelAtXY(the_bitmap, 75, 30));
+	mu_assert_int_eq(0, Bitmap_GetPixelAtXY(the_bitmap, 4, 30));
+	mu_assert_int_eq(6, Bitmap_GetPixelAtXY(the_bitmap, 40, 18));
+	mu_assert_int_eq(0, Bitmap_GetPixelAtXY(the_bitmap, 40, 17));
+	mu_assert_int_eq(6, Bitmap_GetPixelAtXY(the_bitmap, 40, 42));
+	mu_assert_int_eq(0, Bitmap_GetPixelAtXY(the_bitmap, 40, 43));
+	mu_check( Bitmap_DrawEllipse(the_bitmap, 40, 30, 0, 0, 7, PARAM_DO_NOT_FILL) == true );
+	mu_assert_int_eq(1, Test_CountPixelsOfColor(the_bitmap, 7));
+	mu_check( Bitmap_DrawEllipse(the_bitmap, 40, 30, BITMAP_MAX_ELLIPSE_RADIUS + 1, 5, 7, PARAM_DO_NOT_FILL) == false );
+	
+	Bitmap_Destroy(&the_bitmap);
+	Bitmap_Destroy(&the_outline);
+}
+
+
+
+MU_TEST(test_flood_fill)
+{
+	Bitmap*		the_bitmap;
+	Bitmap*		the_pattern;
+	int16_t		x;
+	int16_t		y;
+	
+	the_bitmap = Bitmap_New(40, 30, NULL, PARAM_NOT_IN_VRAM);
+	the_pattern = Bitmap_New(3, 2, NULL, PARAM_NOT_IN_VRAM);
+	mu_assert(the_bitmap != NULL && the_pattern != NULL, "could not allocate test bitmaps");
+	
+	// a box outline is filled inside only, and the fill doesn't touch the outline or the outside
+	Bitmap_FillMemory(the_bitmap, 0);
+	Bitmap_DrawBox(the_bitmap, 5, 5, 10, 8, 1, PARAM_DO_NOT_FILL);
+	mu_check( Bitmap_FloodFill(the_bitmap, 8, 8, 2, PARAM_FILL_4_WAY) == true );
+	mu_assert_int_eq(8 * 6, Test_CountPixelsOfColor(the_bitmap, 2));
+	mu_assert_int_eq(32, Test_CountPixelsOfColor(the_bitmap, 1));
+	mu_assert_int_eq(0, Bitmap_GetPixelAtXY(the_bitmap, 4, 4));
+	
+	// a diagonal wall stops a 4-way fill, but not an 8-way one
+	Bitmap_FillMemory(the_bitmap, 0);
+	
+	for (x = 0; x < 30; x++)
+	{
+		Bitmap_SetPixelAtXY(the_bitmap, x, 29 - x, 1);
+	}
+	
+	mu_check( Bitmap_FloodFill(the_bitmap, 0, 0, 2, PARAM_FILL_4_WAY) == true );
+	mu_assert_int_eq(0, Bitmap_GetPixelAtXY(the_bitmap, 39, 29));
+	mu_assert_int_eq(2, Bitmap_GetPixelAtXY(the_bitmap, 28, 0));
+	mu_check( Bitmap_FloodFill(the_bitmap, 0, 0, 0, PARAM_FILL_4_WAY) == true );
+	mu_check( Bitmap_FloodFill(the_bitmap, 0, 0, 3, PARAM_FILL_8_WAY) == true );
+	mu_assert_int_eq(3, Bitmap_GetPixelAtXY(the_bitmap, 39, 29));
+	mu_assert_int_eq(40 * 30 - 30, Test_CountPixelsOfColor(the_bitmap, 3));
+	
+	// filling with the color already there changes nothing
+	mu_check( Bitmap_FloodFill(the_bitmap, 0, 0, 3, PARAM_FILL_8_WAY) == true );
+	mu_assert_int_eq(40 * 30 - 30, Test_CountPixelsOfColor(the_bitmap, 3));
+	
+	// a pattern that contains the color being replaced still fills the area exactly once, anchored to 0,0
+	for (y = 0; y < 2; y++)
+	{
+		for (x = 0; x < 3; x++)
+		{
+			Bitmap_SetPixelAtXY(the_pattern, x, y, (x + y) & 1 ? 5 : 0);
+		}
+	}
+	
+	Bitmap_FillMemory(the_bitmap, 0);
+	Bitmap_DrawBox(the_bitmap, 5, 5, 10, 8, 1, PARAM_DO_NOT_FILL);
+	mu_check( Bitmap_FloodFillPattern(the_bitmap, 8, 8, the_pattern, PARAM_FILL_4_WAY) == true );
+	
+	for (y = 6; y <= 11; y++)
+	{
+		for (x = 6; x <= 13; x++)
+		{
+			mu_assert_int_eq(Bitmap_GetPixelAtXY(the_pattern, x % 3, y % 2), Bitmap_GetPixelAtXY(the_bitmap, x, y));
+		}
+	}
+	
+	mu_assert_int_eq(0, Bitmap_GetPixelAtXY(the_bitmap, 4, 4));
+	mu_assert_int_eq(32, Test_CountPixelsOfColor(the_bitmap, 1));
+	
+	// bad input is rejected
+	mu_check( Bitmap_FloodFill(the_bitmap, -1, 0, 2, PARAM_FILL_4_WAY) == false );
+	mu_check( Bitmap_FloodFill(the_bitmap, 0, 30, 2, PARAM_FILL_4_WAY) == false );
+	mu_check( Bitmap_FloodFillPattern(the_bitmap, 0, 0, NULL, PARAM_FILL_4_WAY) == false );
+	
+	Bitmap_Destroy(&the_bitmap);
+	Bitmap_Destroy(&the_pattern);
+}
+
+
+MU_TEST(test_flood_fill_queue_overflow)
+{
+	Bitmap*		the_bitmap;
+	int16_t		x;
+	int16_t		y;
+	uint32_t	num_open;
+	
+	// LOGIC:
+	//   an 8-way fill of a checkerboard finds 1-pixel runs on every row, and leaves far more than BITMAP_FILL_MAX_SPANS spans queued
+	//   on a tall bitmap. every open pixel must still be filled once the dropped spans are recovered.
+	
+	the_bitmap = Bitmap_New(64, 600, NULL, PARAM_NOT_IN_VRAM);
+	mu_assert(the_bitmap != NULL, "could not allocate test bitmap");
+	
+	for (y = 0; y < the_bitmap->height_; y++)
+	{
+		for (x = 0; x < the_bitmap->width_; x++)
+		{
+			Bitmap_SetPixelAtXY(the_bitmap, x, y, (x + y) & 1);
+		}
+	}
+	
+	num_open = Test_CountPixelsOfColor(the_bitmap, 0);
+	mu_check( Bitmap_FloodFill(the_bitmap, 0, 0, 2, PARAM_FILL_8_WAY) == true );
+	mu_assert_int_eq(num_open, Test_CountPixelsOfColor(the_bitmap, 2));
+	mu_assert_int_eq(0, Test_CountPixelsOfColor(the_bitmap, 0));
+	
+	// a 4-way fill of the same checkerboard can't go anywhere
+	mu_check( Bitmap_FloodFill(the_bitmap, 1, 0, 3, PARAM_FILL_4_WAY) == true );
+	mu_assert_int_eq(1, Test_CountPixelsOfColor(the_bitmap, 3));
+	
+	Bitmap_Destroy(&the_bitmap);
+}
+
+
+MU_TEST(test_resize_keeps_pixels)
+{
+	Bitmap*			the_bitmap;
+	unsigned char*	the_addr;
+	uint32_t		the_capacity;
+	
+	the_bitmap = Bitmap_New(100, 80, NULL, PARAM_NOT_IN_VRAM);
+	mu_assert(the_bitmap != NULL, "could not allocate test bitmap");
+	Test_FillBitmapWithPattern(the_bitmap);
+	mu_assert_int_eq(100 * 80, the_bitmap->capacity_);
+	
+	// growing past the capacity reallocates, with headroom, and copies the pixels over at the new row length
+	mu_check( Bitmap_Resize(the_bitmap, 120, 80) == true );
+	mu_check( the_bitmap->capacity_ > 120 * 80 );
+	mu_check( Test_BitmapKeptPattern(the_bitmap, 100, 80) );
+	
+	the_addr = the_bitmap->addr_;
+	the_capacity = the_bitmap->capacity_;
+	
+	// growing within the headroom doesn't reallocate: rows slide out in place
+	mu_check( Bitmap_Resize(the_bitmap, 124, 80) == true );
+	mu_check( the_bitmap->addr_ == the_addr );
+	mu_check( Test_BitmapKeptPattern(the_bitmap, 100, 80) );
+	
+	// narrower and taller: rows slide back in, and only the shared 60 x 80 is kept
+	mu_check( Bitmap_Resize(the_bitmap, 60, 150) == true );
+	mu_check( the_bitmap->addr_ == the_addr );
+	mu_check( Test_BitmapKeptPattern(the_bitmap, 60, 80) );
+	
+	// shrinking never gives back storage
+	mu_check( Bitmap_Resize(the_bitmap, 50, 40) == true );
+	mu_assert_int_eq(the_capacity, the_bitmap->capacity_);
+	mu_check( Test_BitmapKeptPattern(the_bitmap, 50, 40) );
+	
+	Bitmap_Destroy(&the_bitmap);
+}
+
+
+
 // **** speed tests
 
 MU_TEST(test_speed_1_tiling)
 {
-	long	start_ticks;
-	long	end_ticks;
-	long	test1_ticks;
-	long	test2_ticks;
-	long	test3_ticks;
-	long	test4_ticks;
-	int16_t	i;
-	int16_t	times_to_run = 100;
+	long		start_ticks;
+	long		end_ticks;
+	long		test1_ticks;
+	long		test2_ticks;
+	int16_t		i;
+	int16_t		times_to_run = 100;
+	Rectangle	the_damage;
 	
 	Theme*	the_theme = Sys_GetTheme(global_system);
 	Bitmap*	the_pattern = Theme_GetDesktopPattern(the_theme);
 	Bitmap*	the_target_bitmap = Sys_GetScreenBitmap(global_system, back_layer);
 	
+	// a damaged area about the size of a dialog box, not lined up with the pattern
+	the_damage.MinX = 101;
+	the_damage.MinY = 77;
+	the_damage.MaxX = 420;
+	the_damage.MaxY = 276;
 	
-	// test speed of first variant
+	// test speed of tiling the whole screen
 	start_ticks = mu_timer_real();
 
-	// speed test 1 goes here
 	for (i = 0; i < times_to_run; i++)
 	{
-		Bitmap_TileV1(the_pattern, 0, 0, the_target_bitmap, 16, 16);
+		Bitmap_Tile(the_pattern, 0, 0, the_target_bitmap, 16, 16);
 	}
 	
 	end_ticks = mu_timer_real();
@@ -123,50 +872,172 @@ MU_TEST(test_speed_1_tiling)
 
 
 	
-	// test speed of 2nd variant
+	// test speed of re-tiling just the damaged area
 	start_ticks = mu_timer_real();
 	
-	// speed test 2 goes here
 	for (i = 0; i < times_to_run; i++)
 	{
-		Bitmap_TileV2(the_pattern, 0, 0, the_target_bitmap, 16, 16);
+		Bitmap_TileRect(the_pattern, 0, 0, the_target_bitmap, 16, 16, &the_damage);
 	}
 		
 	end_ticks = mu_timer_real();
 	test2_ticks = end_ticks - start_ticks;
+	
+	printf("\nSpeed results: whole screen: %li ticks; damaged rect: %li ticks\n", test1_ticks, test2_ticks);
+	DEBUG_OUT(("Speed results: whole screen: %li ticks; damaged rect: %li ticks", test1_ticks, test2_ticks));
+}
+
 
 
+MU_TEST(test_speed_2_blit)
+{
+	long		start_ticks;
+	long		the_ticks[2][3];	// [legacy, new][shape]
+	uint32_t	bytes_per_run[3];
+	int16_t		i;
+	int16_t		j;
+	int16_t		times_to_run = 50;
+	Bitmap*		src_bm;
+	Bitmap*		dst_bm;
 	
-	// test speed of 3rd variant
-	start_ticks = mu_timer_real();
+	// LOGIC:
+	//   3 shapes, each run with the old per-row memcpy blit and with the current Bitmap_Blit, on RAM bitmaps:
+	//     0: full-width copy (one contiguous move for the new engine)
+	//     1: window-sized copy with matching alignment, as in a window drag
+	//     2: window-sized copy with odd source/target alignment
 	
-	// speed test 3 goes here
-	for (i = 0; i < times_to_run; i++)
+	src_bm = Bitmap_New(BLIT_SPEED_TEST_WIDTH, BLIT_SPEED_TEST_HEIGHT, NULL, PARAM_NOT_IN_VRAM);
+	dst_bm = Bitmap_New(BLIT_SPEED_TEST_WIDTH, BLIT_SPEED_TEST_HEIGHT, NULL, PARAM_NOT_IN_VRAM);
+	mu_assert(src_bm != NULL && dst_bm != NULL, "could not allocate test bitmaps");
+	Test_FillBitmapWithPattern(src_bm);
+	
+	bytes_per_run[0] = (uint32_t)BLIT_SPEED_TEST_WIDTH * BLIT_SPEED_TEST_HEIGHT;
+	bytes_per_run[1] = (uint32_t)400 * 300;
+	bytes_per_run[2] = (uint32_t)401 * 300;
+	
+	for (j = 0; j < 2; j++)
 	{
-		Bitmap_TileV3(the_pattern, 0, 0, the_target_bitmap, 16, 16);
-	}
+		start_ticks = mu_timer_real();
 		
-	end_ticks = mu_timer_real();
-	test3_ticks = end_ticks - start_ticks;
+		for (i = 0; i < times_to_run; i++)
+		{
+			if (j == 0)
+			{
+				Bitmap_BlitLegacy(src_bm, 0, 0, dst_bm, 0, 0, BLIT_SPEED_TEST_WIDTH, BLIT_SPEED_TEST_HEIGHT);
+			}
+			else
+			{
+				Bitmap_Blit(src_bm, 0, 0, dst_bm, 0, 0, BLIT_SPEED_TEST_WIDTH, BLIT_SPEED_TEST_HEIGHT);
+			}
+		}
+		
+		the_ticks[j][0] = mu_timer_real() - start_ticks;
 
+		start_ticks = mu_timer_real();
+		
+		for (i = 0; i < times_to_run; i++)
+		{
+			if (j == 0)
+			{
+				Bitmap_BlitLegacy(src_bm, 16, 20, dst_bm, 120, 40, 400, 300);
+			}
+			else
+			{
+				Bitmap_Blit(src_bm, 16, 20, dst_bm, 120, 40, 400, 300);
+			}
+		}
+		
+		the_ticks[j][1] = mu_timer_real() - start_ticks;
 
+		start_ticks = mu_timer_real();
+		
+		for (i = 0; i < times_to_run; i++)
+		{
+			if (j == 0)
+			{
+				Bitmap_BlitLegacy(src_bm, 3, 20, dst_bm, 122, 41, 401, 300);
+			}
+			else
+			{
+				Bitmap_Blit(src_bm, 3, 20, dst_bm, 122, 41, 401, 300);
+			}
+		}
+		
+		the_ticks[j][2] = mu_timer_real() - start_ticks;
+	}
 	
-	// test speed of 4th variant
-	start_ticks = mu_timer_real();
-	
-	// speed test 4 goes here
-	for (i = 0; i < times_to_run; i++)
+	for (j = 0; j < 3; j++)
 	{
-		Bitmap_Tile(the_pattern, 0, 0, the_target_bitmap, 16, 16);
+		printf("\nBlit speed, shape %i: legacy: %li ticks (%lu bytes/sec); new: %li ticks (%lu bytes/sec)\n", j, the_ticks[0][j], Test_BytesPerSecond(bytes_per_run[j] * times_to_run, the_ticks[0][j]), the_ticks[1][j], Test_BytesPerSecond(bytes_per_run[j] * times_to_run, the_ticks[1][j]));
+		DEBUG_OUT(("Blit speed, shape %i: legacy: %li ticks (%lu bytes/sec); new: %li ticks (%lu bytes/sec)", j, the_ticks[0][j], Test_BytesPerSecond(bytes_per_run[j] * times_to_run, the_ticks[0][j]), the_ticks[1][j], Test_BytesPerSecond(bytes_per_run[j] * times_to_run, the_ticks[1][j])));
 	}
-		
-	end_ticks = mu_timer_real();
-	test4_ticks = end_ticks - start_ticks;
 	
-	printf("\nSpeed results: 1st: %li ticks; 2nd: %li ticks; 3rd: %li ticks 4th: %li ticks\n", test1_ticks, test2_ticks, test3_ticks, test4_ticks);
-	DEBUG_OUT(("Speed results: 1st: %li ticks; 2nd: %li ticks; 3rd: %li ticks; 4th: %li ticks", test1_ticks, test2_ticks, test3_ticks, test4_ticks));
+	Bitmap_Destroy(&src_bm);
+	Bitmap_Destroy(&dst_bm);
 }
 
+MU_TEST(test_speed_3_flood_fill)
+{
+	long		start_ticks;
+	long		the_ticks[3];
+	uint32_t	num_filled[3];
+	int16_t		i;
+	Bitmap*		the_bitmap;
+	Bitmap*		the_pattern;
+	Theme*		the_theme = Sys_GetTheme(global_system);
+	
+	// LOGIC:
+	//   3 stress fills of a full screen sized (800x600) RAM bitmap:
+	//     0: an empty bitmap: one run per row
+	//     1: a serpentine maze with 1 pixel corridors: the fill has to wind up and down through 400 corridors
+	//     2: the same empty bitmap, filled with the desktop pattern
+	
+	the_bitmap = Bitmap_New(FILL_SPEED_TEST_WIDTH, FILL_SPEED_TEST_HEIGHT, NULL, PARAM_NOT_IN_VRAM);
+	mu_assert(the_bitmap != NULL, "could not allocate test bitmap");
+	the_pattern = Theme_GetDesktopPattern(the_theme);
+	
+	for (i = 0; i < 3; i++)
+	{
+		Bitmap_FillMemory(the_bitmap, 0);
+		
+		if (i == 1)
+		{
+			Test_DrawSerpentine(the_bitmap, 1);
+		}
+		
+		start_ticks = mu_timer_real();
+		
+		if (i == 2)
+		{
+			mu_check( Bitmap_FloodFillPattern(the_bitmap, 0, 0, the_pattern, PARAM_FILL_4_WAY) == true );
+		}
+		else
+		{
+			mu_check( Bitmap_FloodFill(the_bitmap, 0, 0, 2, PARAM_FILL_4_WAY) == true );
+		}
+		
+		the_ticks[i] = mu_timer_real() - start_ticks;
+		
+		if (i == 2)
+		{
+			num_filled[i] = (uint32_t)FILL_SPEED_TEST_WIDTH * FILL_SPEED_TEST_HEIGHT;
+		}
+		else
+		{
+			// every pixel but the maze walls gets filled
+			num_filled[i] = Test_CountPixelsOfColor(the_bitmap, 2);
+			mu_assert_int_eq((uint32_t)FILL_SPEED_TEST_WIDTH * FILL_SPEED_TEST_HEIGHT - Test_CountPixelsOfColor(the_bitmap, 1), num_filled[i]);
+		}
+	}
+	
+	for (i = 0; i < 3; i++)
+	{
+		printf("\nFlood fill speed, shape %i: %li ticks (%lu pixels filled, %lu pixels/sec)\n", i, the_ticks[i], num_filled[i], Test_BytesPerSecond(num_filled[i], the_ticks[i]));
+		DEBUG_OUT(("Flood fill speed, shape %i: %li ticks (%lu pixels filled, %lu pixels/sec)", i, the_ticks[i], num_filled[i], Test_BytesPerSecond(num_filled[i], the_ticks[i])));
+	}
+	
+	Bitmap_Destroy(&the_bitmap);
+}
 
 
 	// speed tests
@@ -175,6 +1046,8 @@ MU_TEST_SUITE(test_suite_speed)
 	MU_SUITE_CONFIGURE(&test_setup, &test_teardown);
 	
 	MU_RUN_TEST(test_speed_1_tiling);
+	MU_RUN_TEST(test_speed_2_blit);
+	MU_RUN_TEST(test_speed_3_flood_fill);
 }
 
 
@@ -184,6 +1057,16 @@ MU_TEST_SUITE(test_suite_units)
 	MU_SUITE_CONFIGURE(&test_setup, &test_teardown);
 	
 // 	MU_RUN_TEST(font_replace_test);
+	MU_RUN_TEST(test_blit_clipping);
+	MU_RUN_TEST(test_blit_overlap);
+	MU_RUN_TEST(test_blit_transparent_and_masked);
+	MU_RUN_TEST(test_draw_box_xor);
+	MU_RUN_TEST(test_tile_rect);
+	MU_RUN_TEST(test_draw_line_clipping);
+	MU_RUN_TEST(test_draw_round_shapes);
+	MU_RUN_TEST(test_flood_fill);
+	MU_RUN_TEST(test_flood_fill_queue_overflow);
+	MU_RUN_TEST(test_resize_keeps_pixels);
 }
 
 
@@ -20,6 +20,7 @@
 #include "debug.h"
 #include "font.h"
 #include "general.h"
+#include "pool.h"
 #include "sys.h"
 #include "text.h"
 #include "window.h"
@@ -40,6 +41,7 @@
 /*                               Definitions                                 */
 /*****************************************************************************/
 
+#define CONTROL_STRUCTS_PER_SLAB	32		// number of Control structs the control pool gets from the heap at a time
 
 
 /*****************************************************************************/
@@ -54,6 +56,8 @@
 
 extern System*			global_system;
 
+static Pool				control_pool = POOL_INITIALIZER("Control", Control, CONTROL_STRUCTS_PER_SLAB);
+
 
 /*****************************************************************************/
 /*                       Private Function Prototypes                         */
@@ -65,6 +69,11 @@ extern System*			global_system;
 //! @param	the_control -- a valid pointer to a Control with a non-NULL caption
 static void Control_DrawCaption(Control* the_control);
 
+//! Draws a scroller control onto its parent window's bitmap: the control's image is repeated along its full length, then the thumb is drawn over it
+//! The thumb's size reflects how much of the range is in view (page_size_), and its position reflects the control's value
+//! @param	the_control -- a valid pointer to a Control of type H_SCROLLER or V_SCROLLER
+static void Control_DrawScroller(Control* the_control);
+
 
 // **** Debug functions *****
 
@@ -161,6 +170,78 @@ error:
 }
 
 
+//! Draws a scroller control onto its parent window's bitmap: the control's image is repeated along its full length, then the thumb is drawn over it
+//! The thumb's size reflects how much of the range is in view (page_size_), and its position reflects the control's value
+//! @param	the_control -- a valid pointer to a Control of type H_SCROLLER or V_SCROLLER
+static void Control_DrawScroller(Control* the_control)
+{
+	Theme*		the_theme;
+	Bitmap*		the_image;
+	Bitmap*		the_bitmap;
+	bool		is_horizontal;
+	int16_t		i;
+	int16_t		track_len;
+	int16_t		tile_len;
+	int16_t		thumb_start;
+	int16_t		thumb_len;
+	int32_t		range;
+	
+	// LOGIC:
+	//   the theme supplies one image the thickness of the scroller, which is repeated from the start of the control to its end.
+	//     it is blitted from the control's corner, not tiled from the bitmap's 0,0, so its edges line up with the control's.
+	//   the thumb is proportional: its share of the track is the share of the whole range that is in view.
+
+	the_theme = Sys_GetTheme(global_system);
+	the_image = the_control->image_[the_control->active_][the_control->pressed_];
+	the_bitmap = the_control->parent_win_->bitmap_;
+	is_horizontal = (the_control->type_ == H_SCROLLER);
+
+	track_len = (is_horizontal ? the_control->width_ : the_control->height_);
+	tile_len = (is_horizontal ? the_image->width_ : the_image->height_);
+	
+	for (i = 0; i < track_len; i += tile_len)
+	{
+		if (is_horizontal)
+		{
+			Bitmap_Blit(the_image, 0, 0, the_bitmap, the_control->rect_.MinX + i, the_control->rect_.MinY, (track_len - i < tile_len ? track_len - i : tile_len), the_control->height_);
+		}
+		else
+		{
+			Bitmap_Blit(the_image, 0, 0, the_bitmap, the_control->rect_.MinX, the_control->rect_.MinY + i, the_control->width_, (track_len - i < tile_len ? track_len - i : tile_len));
+		}
+	}
+	
+	range = (int32_t)the_control->max_ - (int32_t)the_control->min_;
+	
+	if (range <= 0 || the_control->page_size_ <= 0)
+	{
+		thumb_start = 0;
+		thumb_len = track_len;
+	}
+	else
+	{
+		thumb_len = (int16_t)(((int32_t)track_len * the_control->page_size_) / (range + the_control->page_size_));
+		
+		if (thumb_len < CONTROL_SCROLLER_MIN_THUMB)
+		{
+			thumb_len = (track_len < CONTROL_SCROLLER_MIN_THUMB ? track_len : CONTROL_SCROLLER_MIN_THUMB);
+		}
+		
+		thumb_start = (int16_t)(((int32_t)(track_len - thumb_len) * (the_control->value_ - the_control->min_)) / range);
+	}
+	
+	// the thumb is inset from the sides of the track by 2 pixels
+	if (is_horizontal)
+	{
+		Bitmap_FillBox(the_bitmap, the_control->rect_.MinX + thumb_start, the_control->rect_.MinY + 2, thumb_len, the_control->height_ - 5, (the_control->active_ ? the_theme->highlight_back_color_ : the_theme->inactive_fore_color_));
+	}
+	else
+	{
+		Bitmap_FillBox(the_bitmap, the_control->rect_.MinX + 2, the_control->rect_.MinY + thumb_start, the_control->width_ - 4, thumb_len - 1, (the_control->active_ ? the_theme->highlight_back_color_ : the_theme->inactive_fore_color_));
+	}
+}
+
+
 
 
 // **** Debug functions *****
@@ -189,6 +270,7 @@ void Control_Print(Control* the_control)
 	DEBUG_OUT(("  value_: %i",	 			the_control->value_));
 	DEBUG_OUT(("  min_: %i",	 			the_control->min_));
 	DEBUG_OUT(("  max_: %i", 				the_control->max_));
+	DEBUG_OUT(("  page_size_: %i", 			the_control->page_size_));
 	DEBUG_OUT(("  inactive image up: %p", 	the_control->image_[CONTROL_INACTIVE][CONTROL_NOT_PRESSED]));
 	DEBUG_OUT(("  inactive image dn: %p", 	the_control->image_[CONTROL_INACTIVE][CONTROL_PRESSED]));
 	DEBUG_OUT(("  active image up: %p", 	the_control->image_[CONTROL_ACTIVE][CONTROL_NOT_PRESSED]));
@@ -239,7 +321,7 @@ Control* Control_New(ControlTemplate* the_template, Window* the_window, Rectangl
 	//   to personalize the control for a given window, the parent window is needed
 	//   the final location of the control is calculated based on the offset info in the template + the size of the parent window
 	
-	if ( (the_control = (Control*)calloc(1, sizeof(Control)) ) == NULL)
+	if ( (the_control = (Control*)Pool_Alloc(&control_pool) ) == NULL)
 	{
 		LOG_ERR(("%s %d: could not allocate memory to create new control record", __func__ , __LINE__));
 		goto error;
@@ -327,7 +409,7 @@ bool Control_Destroy(Control** the_control)
 	
 	LOG_ALLOC(("%s %d:	__FREE__	*the_control	%p	size	%i", __func__ , __LINE__, *the_control, sizeof(Control)));
 	TRACK_ALLOC((0 - sizeof(Control)));
-	free(*the_control);
+	Pool_Free(&control_pool, *the_control);
 	*the_control = NULL;
 	
 	return true;
@@ -486,6 +568,11 @@ void Control_MarkInvalidated(Control* the_control, bool invalidated)
 	
 	the_control->invalidated_ = invalidated;
 	
+	if (invalidated == true)
+	{
+		Sys_RequestRender(global_system);
+	}
+	
 	return;
 	
 error:
@@ -752,13 +839,21 @@ void Control_Render(Control* the_control)
 
 	// LOGIC: the control's rect is the in-window coordinates, not a 0,0xheight,width rect local to the Control
 	
-	Bitmap_Blit(the_bitmap, 0, 0, 
-				the_control->parent_win_->bitmap_, 
-				the_control->rect_.MinX, 
-				the_control->rect_.MinY, 
-				the_control->width_, 
-				the_control->height_
-				);
+	if (the_control->type_ == H_SCROLLER || the_control->type_ == V_SCROLLER)
+	{
+		// scrollers stretch to fit the window: their image is repeated along them, rather than blitted once
+		Control_DrawScroller(the_control);
+	}
+	else
+	{
+		Bitmap_Blit(the_bitmap, 0, 0, 
+					the_control->parent_win_->bitmap_, 
+					the_control->rect_.MinX, 
+					the_control->rect_.MinY, 
+					the_control->width_, 
+					the_control->height_
+					);
+	}
 				
 	// some controls have captions. if present, draw them directly to the parent bitmap
 	// (leave the control's bitmaps clean, so text can be changed, font changed, etc.)
@@ -62,6 +62,8 @@
 #define CONTROL_ID_ERROR			-2	//! For any function trying to return the ID of a control, a value indicating an error occurred. This error must be handled.
 #define CONTROL_ID_NOT_FOUND		-1	//! For any function trying to return the ID of a control, a value indicating the that the described control could not be found.
 
+#define CONTROL_SCROLLER_MIN_THUMB	6	//! The smallest size a scroller's thumb is drawn at, in pixels, however little of the content is in view
+
 
 /*****************************************************************************/
 /*                               Enumerations                                */
@@ -149,6 +151,7 @@ struct Control
 	int16_t					value_;							//! current value of the control
 	int16_t					min_;							//! minimum allowed value
 	int16_t					max_;							//! maximum allowed value
+	int16_t					page_size_;						//! scrollers only: how much of the range from min_ to max_ is in view at once. Sizes the scroller's thumb.
 	Bitmap*					image_[2][2];					//! 4 image state bitmaps: [active yes/no][pushed down yes/no]
 	char*					caption_;						//! optional string to draw centered horizontally and vertically on the control. Typical use cases include buttons and labels.
 	int16_t					avail_text_width_;				//! number of pixels available for writing text. For flexible width buttons, etc., this excludes the left/right segments. 
@@ -210,6 +213,7 @@ bool Control_Destroy(Control** the_control);
 // 	int16_t					value_;							//! current value of the control
 // 	int16_t					min_;							//! minimum allowed value
 // 	int16_t					max_;							//! maximum allowed value
+	int16_t					page_size_;						//! scrollers only: how much of the range from min_ to max_ is in view at once. Sizes the scroller's thumb.
 // 	Bitmap*					image_inactive_;				//! image of the control in inactive state. size must match the length and width defined in the rect_. If not supplied, the control will be effectively invisible.
 // 	Bitmap*					image_active_up_;				//! image of the control when active, and not clicked/pressed. size must match the length and width defined in the rect_. If not supplied, the control will be effectively invisible.
 // 	Bitmap*					image_active_down_;				//! image of the control when active, and clicked/depressed. size must match the length and width defined in the rect_. If not supplied, the control will be effectively invisible.
@@ -17,8 +17,11 @@
 #include "bitmap.h"
 #include "debug.h"
 #include "event.h"
+#include "inputlog.h"
 #include "menu.h"
+#include "pool.h"
 #include "sys.h"
+#include "timer.h"
 #include "window.h"
 
 // C includes
@@ -38,6 +41,7 @@
 /*                               Definitions                                 */
 /*****************************************************************************/
 
+#define EVENT_RECORDS_PER_SLAB		(EVENT_QUEUE_SIZE * 2)	// the records for both event rings all come from the first slab, in one piece
 
 
 /*****************************************************************************/
@@ -52,6 +56,8 @@
 
 extern System*			global_system;
 
+static Pool				event_pool = POOL_INITIALIZER("EventRecord", EventRecord, EVENT_RECORDS_PER_SLAB);
+
 
 /*****************************************************************************/
 /*                       Private Function Prototypes                         */
@@ -60,12 +66,109 @@ extern System*			global_system;
 //! Make the passed event a nullEvent, blanking out all fields
 static void Event_SetNull(EventRecord* the_event);
 
+//! Allocate the event records for a ring, and set it to empty
+//! @return	Returns false on any error
+static bool EventRing_Init(EventRing* the_ring);
+
+//! Free the event records of a ring
+static void EventRing_Free(EventRing* the_ring);
+
+//! Throw out the oldest unread mouseMoved, to make room for a new event in a full ring
+//! The records after it move up one place, and its record becomes the newest, for the new event to be written into.
+//! @return	Returns the record to write the new event into, or NULL if there was no move to throw out
+static EventRecord* EventRing_EvictOldestMove(EventRing* the_ring);
+
+//! Get the record to write a new event into. A mouseMoved is merged into the newest unread event if that is also a mouseMoved.
+//! If the ring is full, an unread move is given up before any other event, whatever the policy: no button transition is lost to a move.
+//!   Past that, the overflow policy decides between writing over an unread event and throwing the new one away.
+//! @param	the_what -- the kind of event that will be written into the record
+//! @param	merged -- receives true if the record is the newest unread event, to be written over, rather than a new one
+//! @return	Returns NULL if the new event is to be thrown away
+static EventRecord* EventRing_BeginWrite(EventRing* the_ring, event_kind the_what, event_overflow_policy the_policy, bool* merged);
+
+//! Make the event written into the record from EventRing_BeginWrite() readable
+static void EventRing_EndWrite(EventRing* the_ring, bool merged);
+
+//! Copy the oldest unread event out of the ring
+//! @return	Returns false if there was no unread event
+static bool EventRing_Read(EventRing* the_ring, EventRecord* the_copy);
+
+//! Null out any unread events for the passed window
+static void EventRing_RemoveEventsForWindow(EventRing* the_ring, Window* the_window);
+
+//! Check whether a new mouse event is wanted by the system or by any window
+//! @return	Returns false if the event can be thrown away without being queued
+static bool EventManager_WantsMouseEvent(EventManager* the_event_manager, event_kind the_what);
+
+//! Check whether a new window or menu event is wanted by the system or by the window it is for
+//! @return	Returns false if the event can be thrown away without being queued
+static bool EventManager_WantsWindowEvent(Window* the_window, event_kind the_what);
+
+//! Give the event's window the event, if it subscribes to events of that kind
+static void EventManager_DispatchToWindow(EventManager* the_event_manager, EventRecord* the_event);
+
+//! Handle Inactivate events on the system level
+static void EventManager_HandleInactivate(EventManager* the_event_manager, EventRecord* the_event);
+
+//! The default clock: the MCP's jiffy count
+static uint32_t EventManager_GetJiffies(void);
+
+//! Post a timerEvt for a timer that has fired. Called by TimerWheel_Advance().
+static void EventManager_PostTimerEvent(Timer* the_timer);
+
+//! Check whether there are unread events in either queue
+static bool EventManager_HasEvents(EventManager* the_event_manager);
+
+//! Wait between interrupts until an event arrives, running timers as they come due
+//! @param	ticks_to_timer -- ticks until the next timer could be due, from EventManager_RunTimers()
+static void EventManager_Idle(EventManager* the_event_manager, uint32_t ticks_to_timer);
+
+// system-level handlers for mouse events
+void EventManager_HandleMouseUp(EventManager* the_event_manager, EventRecord* the_event);
+void EventManager_HandleMouseDown(EventManager* the_event_manager, EventRecord* the_event);
+void EventManager_HandleRightMouseDown(EventManager* the_event_manager, EventRecord* the_event);
+void EventManager_HandleMouseMoved(EventManager* the_event_manager, EventRecord* the_event);
+
 // **** DEBUG/TESTING Functions
 
 // create one random event in simulation of an interrupt activity
 void EventManager_GenerateRandomEvent(void);
 
 
+/*****************************************************************************/
+/*                              Dispatch Table                               */
+/*****************************************************************************/
+
+// LOGIC:
+//   EventManager_WaitForEvent() hands each event to the entry for its kind. NULL means the event is dropped: nothing handles it.
+//   the mouse handlers do the system's work first, and only pass an event on to a window where it makes sense.
+
+static void (* const event_dispatch_table[invalidEvent])(EventManager*, EventRecord*) =
+{
+	NULL,										// nullEvent
+	&EventManager_HandleMouseDown,				// mouseDown
+	&EventManager_HandleMouseUp,				// mouseUp
+	&EventManager_HandleRightMouseDown,			// rMouseDown
+	NULL,										// rMouseUp: menus act on right mouse DOWN
+	NULL,										// mMouseDown
+	NULL,										// mMouseUp
+	&EventManager_HandleMouseMoved,				// mouseMoved
+	&EventManager_DispatchToWindow,				// keyDown: EventManager_AddKeyEvent() already picked the window, normally the active one
+	&EventManager_DispatchToWindow,				// keyUp
+	&EventManager_DispatchToWindow,				// autoKey
+	&EventManager_DispatchToWindow,				// windowChanged
+	&EventManager_DispatchToWindow,				// updateEvt
+	&EventManager_DispatchToWindow,				// activateEvt
+	&EventManager_HandleInactivate,				// inactivateEvt
+	&EventManager_DispatchToWindow,				// controlClicked
+	&EventManager_DispatchToWindow,				// menuOpened
+	&EventManager_DispatchToWindow,				// menuSelected
+	&EventManager_DispatchToWindow,				// menuCanceled
+	NULL,										// diskEvt
+	&EventManager_DispatchToWindow,				// timerEvt
+};
+
+
 /*****************************************************************************/
 /*                       Private Function Definitions                        */
 /*****************************************************************************/
@@ -78,6 +181,377 @@ static void Event_SetNull(EventRecord* the_event)
 	the_event->what_ = nullEvent;
 }
 
+
+//! Allocate the event records for a ring, and set it to empty
+//! @return	Returns false on any error
+static bool EventRing_Init(EventRing* the_ring)
+{
+	int16_t	i;
+	
+	for (i=0; i < EVENT_QUEUE_SIZE; i++)
+	{
+		if ( (the_ring->queue_[i] = Event_New()) == NULL)
+		{
+			LOG_ERR(("%s %d: could not create event record #%i", __func__ , __LINE__, i));
+			return false;
+		}
+	}
+	
+	the_ring->write_idx_ = 0;
+	the_ring->read_idx_ = 0;
+	the_ring->dropped_newest_ = 0;
+	the_ring->coalesced_ = 0;
+	the_ring->filtered_ = 0;
+	the_ring->evicted_ = 0;
+	the_ring->dropped_oldest_ = 0;
+	
+	return true;
+}
+
+
+//! Free the event records of a ring
+static void EventRing_Free(EventRing* the_ring)
+{
+	int16_t	i;
+	
+	for (i=0; i < EVENT_QUEUE_SIZE; i++)
+	{
+		if (the_ring->queue_[i] != NULL)
+		{
+			Event_Destroy(&the_ring->queue_[i]);
+		}
+	}
+}
+
+
+//! Throw out the oldest unread mouseMoved, to make room for a new event in a full ring
+//! The records after it move up one place, and its record becomes the newest, for the new event to be written into.
+//! @return	Returns the record to write the new event into, or NULL if there was no move to throw out
+static EventRecord* EventRing_EvictOldestMove(EventRing* the_ring)
+{
+	uint16_t		i;
+	uint16_t		newest;
+	EventRecord*	the_victim;
+	
+	// LOGIC:
+	//   button transitions matter more than the positions in between: the next event carries a position anyway.
+	//   the reader can't run while this does (it is the interrupted main loop, or this is the main loop itself), but it may have been
+	//     interrupted just as it claimed the oldest unread event: that one is left where it is. the rest only ever move towards it, in order.
+	//   only pointers are moved: at most EVENT_QUEUE_SIZE of them, and only when the ring is full.
+	
+	newest = (uint16_t)(the_ring->write_idx_ - 1);
+	i = (uint16_t)(the_ring->read_idx_ + 1);
+	
+	// if the writer has already lapped the reader, only the newest EVENT_QUEUE_SIZE events are still in the ring
+	if ((uint16_t)(newest - i) > EVENT_QUEUE_SIZE - 2)
+	{
+		i = (uint16_t)(newest - (EVENT_QUEUE_SIZE - 2));
+	}
+	
+	for (; i != (uint16_t)(newest + 1); i++)
+	{
+		if (the_ring->queue_[i % EVENT_QUEUE_SIZE]->what_ == mouseMoved)
+		{
+			the_victim = the_ring->queue_[i % EVENT_QUEUE_SIZE];
+			
+			for (; i != newest; i++)
+			{
+				the_ring->queue_[i % EVENT_QUEUE_SIZE] = the_ring->queue_[(uint16_t)(i + 1) % EVENT_QUEUE_SIZE];
+			}
+			
+			the_ring->queue_[newest % EVENT_QUEUE_SIZE] = the_victim;
+			the_ring->evicted_++;
+			
+			return the_victim;
+		}
+	}
+	
+	return NULL;
+}
+
+
+//! Get the record to write a new event into. A mouseMoved is merged into the newest unread event if that is also a mouseMoved.
+//! If the ring is full, an unread move is given up before any other event, whatever the policy: no button transition is lost to a move.
+//!   Past that, the overflow policy decides between writing over an unread event and throwing the new one away.
+//! @param	the_what -- the kind of event that will be written into the record
+//! @param	merged -- receives true if the record is the newest unread event, to be written over, rather than a new one
+//! @return	Returns NULL if the new event is to be thrown away
+static EventRecord* EventRing_BeginWrite(EventRing* the_ring, event_kind the_what, event_overflow_policy the_policy, bool* merged)
+{
+	uint16_t		write_idx;
+	uint16_t		num_unread;
+	EventRecord*	the_newest;
+	
+	// LOGIC:
+	//   only the writer changes write_idx_, and only the reader changes read_idx_. each is one 16-bit write, so neither side ever sees a half-changed index.
+	//   the reader claims an event by moving read_idx_ past it, and only then copies it out. it can be interrupted while copying,
+	//     so the ring holds at most EVENT_QUEUE_SIZE - 1 unread events: the slot behind them may still be being copied.
+	//   when dropping the oldest events, the writer doesn't stop there: it laps the reader, and the reader notices and skips what was written over.
+	//   while there is any unread event, the newest one (write_idx_ - 1) can't have been claimed by the reader, so it is safe to write over.
+	
+	write_idx = the_ring->write_idx_;
+	num_unread = (uint16_t)(write_idx - the_ring->read_idx_);
+	the_newest = the_ring->queue_[(uint16_t)(write_idx - 1) % EVENT_QUEUE_SIZE];
+	*merged = false;
+	
+	// the reader only ever needs the latest mouse position: don't use up a slot for every one in between
+	if (the_what == mouseMoved && num_unread > 0 && the_newest->what_ == mouseMoved)
+	{
+		the_ring->coalesced_++;
+		*merged = true;
+		return the_newest;
+	}
+	
+	if (num_unread >= EVENT_QUEUE_SIZE - 1)
+	{
+		if (the_policy == EVENT_OVERFLOW_COALESCE && the_newest->what_ == mouseMoved)
+		{
+			the_ring->coalesced_++;
+			*merged = true;
+			return the_newest;
+		}
+		
+		// a new move only pushes out an older move, and only when dropping the oldest
+		if (the_what != mouseMoved || the_policy == EVENT_OVERFLOW_DROP_OLDEST)
+		{
+			if ( (the_newest = EventRing_EvictOldestMove(the_ring)) != NULL)
+			{
+				*merged = true;
+				return the_newest;
+			}
+		}
+		
+		if (the_what == mouseMoved || the_policy != EVENT_OVERFLOW_DROP_OLDEST)
+		{
+			the_ring->dropped_newest_++;
+			return NULL;
+		}
+	}
+	
+	return the_ring->queue_[write_idx % EVENT_QUEUE_SIZE];
+}
+
+
+//! Make the event written into the record from EventRing_BeginWrite() readable
+static void EventRing_EndWrite(EventRing* the_ring, bool merged)
+{
+	// a merged event was already readable. a new one only becomes readable now that all of it has been written.
+	//   the writer fills the record in through a volatile pointer, so its writes are all done before this one.
+	if (merged == false)
+	{
+		the_ring->write_idx_++;
+	}
+}
+
+
+//! Copy the oldest unread event out of the ring
+//! @return	Returns false if there was no unread event
+static bool EventRing_Read(EventRing* the_ring, EventRecord* the_copy)
+{
+	uint16_t	write_idx;
+	uint16_t	claimed_idx;
+	
+	for (;;)
+	{
+		write_idx = the_ring->write_idx_;
+		
+		if (write_idx == the_ring->read_idx_)
+		{
+			return false;
+		}
+		
+		// if the writer has lapped the reader, the oldest unread events are gone: skip to the oldest one still in the ring
+		if ((uint16_t)(write_idx - the_ring->read_idx_) > EVENT_QUEUE_SIZE)
+		{
+			the_ring->dropped_oldest_ += (uint16_t)(write_idx - the_ring->read_idx_) - EVENT_QUEUE_SIZE;
+			the_ring->read_idx_ = write_idx - EVENT_QUEUE_SIZE;
+		}
+		
+		// claim the event before copying it, so the writer won't merge anything into it
+		claimed_idx = the_ring->read_idx_;
+		the_ring->read_idx_ = claimed_idx + 1;
+		*the_copy = *(volatile EventRecord*)the_ring->queue_[claimed_idx % EVENT_QUEUE_SIZE];
+		
+		// if the writer lapped the reader during the copy, the copy may be half old event, half new: throw it away
+		if ((uint16_t)(the_ring->write_idx_ - claimed_idx) <= EVENT_QUEUE_SIZE)
+		{
+			return true;
+		}
+		
+		the_ring->dropped_oldest_++;
+	}
+}
+
+
+//! Null out any unread events for the passed window
+static void EventRing_RemoveEventsForWindow(EventRing* the_ring, Window* the_window)
+{
+	uint16_t		i;
+	uint16_t		stop;
+	EventRecord*	the_event;
+	
+	i = the_ring->read_idx_;
+	stop = the_ring->write_idx_;
+	
+	if ((uint16_t)(stop - i) > EVENT_QUEUE_SIZE)
+	{
+		i = stop - EVENT_QUEUE_SIZE;
+	}
+	
+	for (; i != stop; i++)
+	{
+		the_event = the_ring->queue_[i % EVENT_QUEUE_SIZE];
+
+		if (the_event->window_ == the_window)
+		{
+			Event_SetNull(the_event);
+		}
+	}
+}
+
+
+//! Check whether a new mouse event is wanted by the system or by any window
+//! @return	Returns false if the event can be thrown away without being queued
+static bool EventManager_WantsMouseEvent(EventManager* the_event_manager, event_kind the_what)
+{
+	if ((EVENT_SYSTEM_MASK | the_event_manager->wanted_mask_) & EVENT_MASK_FOR(the_what))
+	{
+		return true;
+	}
+	
+	// the system follows the mouse itself while a button is down, and while it is dragging, resizing, pressing a control, or showing a menu
+	if (the_what == mouseMoved)
+	{
+		return (the_event_manager->buttons_down_ != 0 || Mouse_GetMode(the_event_manager->mouse_tracker_) != mouseFree);
+	}
+	
+	return false;
+}
+
+
+//! Check whether a new window or menu event is wanted by the system or by the window it is for
+//! @return	Returns false if the event can be thrown away without being queued
+static bool EventManager_WantsWindowEvent(Window* the_window, event_kind the_what)
+{
+	if (the_window == NULL)
+	{
+		return false;
+	}
+	
+	return ((EVENT_SYSTEM_MASK | the_window->event_mask_) & EVENT_MASK_FOR(the_what)) != 0;
+}
+
+
+//! Give the event's window the event, if it subscribes to events of that kind
+static void EventManager_DispatchToWindow(EventManager* the_event_manager, EventRecord* the_event)
+{
+	if (the_event->window_ == NULL)
+	{
+		return;
+	}
+	
+	if ((the_event->window_->event_mask_ & EVENT_MASK_FOR(the_event->what_)) == 0)
+	{
+		return;
+	}
+	
+	(*the_event->window_->event_handler_)(the_event);
+}
+
+
+//! Handle Inactivate events on the system level
+static void EventManager_HandleInactivate(EventManager* the_event_manager, EventRecord* the_event)
+{
+	if (the_event->window_ == NULL)
+	{
+		return;
+	}
+	
+	// tell window to make its active_ state
+	Window_SetActive(the_event->window_, false);
+	
+	EventManager_DispatchToWindow(the_event_manager, the_event);
+}
+
+
+//! The default clock: the MCP's jiffy count
+static uint32_t EventManager_GetJiffies(void)
+{
+	return (uint32_t)sys_time_jiffies();
+}
+
+
+//! Post a timerEvt for a timer that has fired. Called by TimerWheel_Advance().
+static void EventManager_PostTimerEvent(Timer* the_timer)
+{
+	EventManager*	the_event_manager;
+	EventRecord*	the_event;
+	bool			merged;
+	
+	the_event_manager = Sys_GetEventManager(global_system);
+	
+	if (EventManager_WantsWindowEvent(the_timer->window_, timerEvt) == false)
+	{
+		the_event_manager->posted_.filtered_++;
+		return;
+	}
+	
+	if ( (the_event = EventRing_BeginWrite(&the_event_manager->posted_, timerEvt, the_event_manager->overflow_policy_, &merged)) == NULL)
+	{
+		LOG_WARN(("%s %d: event queue full, timer event dropped. id=%u", __func__, __LINE__, the_timer->id_));
+		return;
+	}
+	
+	the_event->window_ = the_timer->window_;
+	the_event->control_ = NULL;
+	the_event->timerinfo_.id_ = the_timer->id_;
+	the_event->timerinfo_.missed_ = the_timer->missed_;
+
+	the_event->when_ = (*the_event_manager->clock_)();
+	the_event->what_ = timerEvt;
+	
+	EventRing_EndWrite(&the_event_manager->posted_, merged);
+}
+
+
+//! Check whether there are unread events in either queue
+static bool EventManager_HasEvents(EventManager* the_event_manager)
+{
+	return (the_event_manager->posted_.write_idx_ != the_event_manager->posted_.read_idx_ || the_event_manager->input_.write_idx_ != the_event_manager->input_.read_idx_);
+}
+
+
+//! Wait between interrupts until an event arrives, running timers as they come due
+//! @param	ticks_to_timer -- ticks until the next timer could be due, from EventManager_RunTimers()
+static void EventManager_Idle(EventManager* the_event_manager, uint32_t ticks_to_timer)
+{
+	uint32_t	start_ticks;
+	
+	// LOGIC:
+	//   events only arrive from interrupts, and timers only come due when the jiffy interrupt moves the clock on:
+	//     between interrupts, there is nothing to check. so the loop sleeps until the next one, then looks again.
+	//   nothing is done tick by tick: with no timers, only an event ends the wait.
+	//   a timer further out than the wheel's bottom level gives a time to look again, not a time it is due: running the timers then returns the next time.
+	//   a render can be pending with no event to come: one requested outside the event loop, one held back to the next frame, or one a timer asked for.
+	//     so each pass draws it, if a frame has passed since the last one, before sleeping again.
+	
+	start_ticks = (*the_event_manager->clock_)();
+	
+	while (EventManager_HasEvents(the_event_manager) == false)
+	{
+		if (ticks_to_timer != TIMER_NONE_PENDING && (*the_event_manager->clock_)() - start_ticks >= ticks_to_timer)
+		{
+			ticks_to_timer = EventManager_RunTimers();
+			start_ticks = (*the_event_manager->clock_)();
+			continue;
+		}
+		
+		Sys_FlushRender(global_system, PARAM_DO_NOT_WAIT_FOR_FRAME);
+		Sys_WaitForInterrupt(global_system);
+	}
+}
+
+
 // **** Debug functions *****
 
 void Event_Print(EventRecord* the_event)
@@ -111,6 +585,10 @@ void Event_Print(EventRecord* the_event)
 	{
 		DEBUG_OUT(("  menu_ x,y,selection: %i, %i, %i", the_event->menuinfo_.x_, the_event->menuinfo_.y_, the_event->menuinfo_.selection_));
 	}
+	else if (the_event->what_ == timerEvt)
+	{
+		DEBUG_OUT(("  timer_ id,missed: %u, %u", the_event->timerinfo_.id_, the_event->timerinfo_.missed_));
+	}
 }
 
 
@@ -118,9 +596,10 @@ void EventManager_Print(EventManager* the_event_manager)
 {
 	DEBUG_OUT(("EventManager print out:"));
 	DEBUG_OUT(("  queue size: %u", EVENT_QUEUE_SIZE));
-	DEBUG_OUT(("  queue_: %p", the_event_manager->queue_));
-	DEBUG_OUT(("  write_idx_: %i", the_event_manager->write_idx_));
-	DEBUG_OUT(("  read_idx_: %i", the_event_manager->read_idx_));
+	DEBUG_OUT(("  input_ write_idx_: %u, read_idx_: %u", the_event_manager->input_.write_idx_, the_event_manager->input_.read_idx_));
+	DEBUG_OUT(("  posted_ write_idx_: %u, read_idx_: %u", the_event_manager->posted_.write_idx_, the_event_manager->posted_.read_idx_));
+	DEBUG_OUT(("  overflow_policy_: %i", the_event_manager->overflow_policy_));
+	DEBUG_OUT(("  wanted_mask_: %x", the_event_manager->wanted_mask_));
 }
 
 
@@ -189,7 +668,7 @@ EventRecord* Event_New(void)
 {
 	EventRecord*	the_event;
 	
-	if ( (the_event = (EventRecord*)calloc(1, sizeof(EventRecord)) ) == NULL)
+	if ( (the_event = (EventRecord*)Pool_Alloc(&event_pool) ) == NULL)
 	{
 		LOG_ERR(("%s %d: could not allocate memory to create new EventRecord", __func__ , __LINE__));
 		goto error;
@@ -220,7 +699,7 @@ bool Event_Destroy(EventRecord** the_event)
 
 	LOG_ALLOC(("%s %d:	__FREE__	*the_event	%p	size	%i", __func__ , __LINE__, *the_event, sizeof(EventRecord)));
 	TRACK_ALLOC((0 - sizeof(EventRecord)));
-	free(*the_event);
+	Pool_Free(&event_pool, *the_event);
 	*the_event = NULL;
 	
 	return true;
@@ -245,9 +724,9 @@ EventManager* EventManager_New(void)
 	LOG_ALLOC(("%s %d:	__ALLOC__	the_event_manager	%p	size	%i", __func__ , __LINE__, the_event_manager, sizeof(EventManager)));
 	TRACK_ALLOC((sizeof(EventManager)));
 
-	the_event_manager->write_idx_ = 0;
-	the_event_manager->read_idx_ = 0;
-	the_event_manager->mouse_tracker_->mode_ = mouseFree;
+	the_event_manager->overflow_policy_ = EVENT_OVERFLOW_DROP_OLDEST;
+	the_event_manager->clock_ = &EventManager_GetJiffies;
+	Event_SetNull(&the_event_manager->current_);
 
 	// get a mouse tracker
 	if ( (the_event_manager->mouse_tracker_ = Mouse_New()) == NULL)
@@ -259,17 +738,16 @@ EventManager* EventManager_New(void)
 
 	//DEBUG_OUT(("%s %d: EventManager (%p) created", __func__ , __LINE__, the_event_manager));
 	
-	int	i;
+	if (EventRing_Init(&the_event_manager->input_) == false || EventRing_Init(&the_event_manager->posted_) == false)
+	{
+		LOG_ERR(("%s %d: could not create event records", __func__ , __LINE__));
+		goto error;
+	}
 	
-	for (i=0; i < EVENT_QUEUE_SIZE; i++)
+	if ( (the_event_manager->timer_wheel_ = TimerWheel_New((*the_event_manager->clock_)())) == NULL)
 	{
-		if ( (the_event_manager->queue_[i] = Event_New()) == NULL)
-		{
-			LOG_ERR(("%s %d: could not create event record #%i", __func__ , __LINE__, i));
-			goto error;
-		}
-		
-		//DEBUG_OUT(("%s %d: Event %i (%p)(%p) created", __func__ , __LINE__, i, the_event_manager->queue_[i], the_event_manager->queue_[i]));
+		LOG_ERR(("%s %d: could not create timer wheel", __func__ , __LINE__));
+		goto error;
 	}
 	
 	return the_event_manager;
@@ -285,20 +763,18 @@ error:
 // frees all allocated memory associated with the passed object, and the object itself
 bool EventManager_Destroy(EventManager** the_event_manager)
 {
-	int16_t	i;
-	
 	if (*the_event_manager == NULL)
 	{
 		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
 		goto error;
 	}
 
-	for (i=0; i < EVENT_QUEUE_SIZE; i++)
+	EventRing_Free(&(*the_event_manager)->input_);
+	EventRing_Free(&(*the_event_manager)->posted_);
+	
+	if ((*the_event_manager)->timer_wheel_ != NULL)
 	{
-		if ((*the_event_manager)->queue_[i] != NULL)
-		{
-			Event_Destroy(&(*the_event_manager)->queue_[i]);
-		}
+		TimerWheel_Destroy(&(*the_event_manager)->timer_wheel_);
 	}
 	
 	LOG_ALLOC(("%s %d:	__FREE__	*the_event_manager	%p	size	%i", __func__ , __LINE__, *the_event_manager, sizeof(EventManager)));
@@ -317,146 +793,206 @@ error:
 
 // **** Queue Management functions *****
 
-//! Nulls out any events associated with the window pointer passed
+//! Nulls out any events associated with the window pointer passed, and stops its timers
 //! Call this when a window has been closed, to ensure that there are not future events that will try to recall the window after it is destroyed
 void EventManager_RemoveEventsForWindow(Window* the_window)
 {
 	EventManager*	the_event_manager;
-	uint16_t		start;
-	uint16_t		stop;
-	uint16_t		i;
 	
 	// LOGIC:
-	//   the event buffer is circular. nullEvents are allowed and present.
-	//   so the way to know if there is a waiting event is to compare the read and write indices
-	//   if read=write, then there are no pending events
+	//   the event buffers are circular. removed events are left in place as nullEvents, which EventManager_NextEvent() skips
 	
 	the_event_manager = Sys_GetEventManager(global_system);
 	
-// 	if (the_event_manager->read_idx_ == the_event_manager->write_idx_)
-// 	{
-// 		DEBUG_OUT(("%s %d: read_idx_=%i SAME AS write_idx_=%i", __func__, __LINE__, the_event_manager->read_idx_, the_event_manager->write_idx_));
-// 		return;
-// 	}
+	DEBUG_OUT(("%s %d: window=%p", __func__, __LINE__, the_window));
 	
-	start = the_event_manager->read_idx_;
-	stop = the_event_manager->write_idx_;
-	DEBUG_OUT(("%s %d: read_idx_=%i, write_idx_=%i, window=%p", __func__, __LINE__, the_event_manager->read_idx_, the_event_manager->write_idx_, the_window));
-	
-	for (i = start; i <= stop; i++)
-	{
-		EventRecord*	the_event;
-	
-		the_event = the_event_manager->queue_[i];
-
-		DEBUG_OUT(("%s %d: this event: window=%p, readidx=%i", __func__, __LINE__, the_event->window_, i));
-
-		if (the_event->window_ != NULL)
-		{
-			if (the_event->window_ == the_window)
-			{
-				Event_SetNull(the_event);
-			}
-		}
-	}
+	EventRing_RemoveEventsForWindow(&the_event_manager->input_, the_window);
+	EventRing_RemoveEventsForWindow(&the_event_manager->posted_, the_window);
+	TimerWheel_StopTimersForWindow(the_event_manager->timer_wheel_, the_window);
 	
 	return;
 }
 
 
 //! Checks to see if there is an event in the queue
-//! returns NULL if no event (not the same as returning an event of type nullEvent)
+//! Posted (window and menu) events are returned before mouse events: they were caused by events already handled
+//! returns NULL if no event. nullEvents (events removed from the queue) are skipped.
+//! The event returned is a copy owned by the event manager, good until the next call.
 EventRecord* EventManager_NextEvent(void)
 {
 	EventManager*	the_event_manager;
-	EventRecord*	the_event;
 	
 	// LOGIC:
-	//   the event buffer is circular. nullEvents are allowed and present.
-	//   so the way to know if there is a waiting event is to compare the read and write indices
-	//   if read=write, then there are no pending events
+	//   the event is copied out of the ring, rather than handed out in place, so the mouse interrupt can keep using the ring while it is handled
 	
 	the_event_manager = Sys_GetEventManager(global_system);
 	
-	if (the_event_manager->read_idx_ == the_event_manager->write_idx_)
+	while (EventRing_Read(&the_event_manager->posted_, &the_event_manager->current_) || EventRing_Read(&the_event_manager->input_, &the_event_manager->current_))
 	{
-		//DEBUG_OUT(("%s %d: read_idx_=%i SAME AS write_idx_=%i", __func__, __LINE__, the_event_manager->read_idx_, the_event_manager->write_idx_));
-		return NULL;
+		if (the_event_manager->current_.what_ != nullEvent)
+		{
+			//DEBUG_OUT(("%s %d: Next Event: type=%i", __func__, __LINE__, the_event_manager->current_.what_));
+			return &the_event_manager->current_;
+		}
 	}
 	
-	the_event = the_event_manager->queue_[the_event_manager->read_idx_];
+	return NULL;
+}
+
 
-	DEBUG_OUT(("%s %d: Next Event: type=%i, ptr=%p", __func__, __LINE__, the_event->what_, the_event));
-	//EventManager_Print(the_event_manager);
-	Event_Print(the_event);
+//! Add a new mouse event to the event queue
+//! NOTE: this does not actually insert a new record, as the event queue is a circular buffer
+//!   It overwrites whatever slot is next in line
+//! This is designed to be called from mouse IRQ, with minimimal information available
+//! @param	the_what -- specifies the type of event to add to the queue. only mouseDown/up/moved events supported
+//! The function will query VICKY for x,y and determine if the mouse is over a window, a control, etc. 
+void EventManager_AddMouseEvent(event_kind the_what)
+{
+	// LOGIC:
+	//   IRQ handler (presumably) has sent us a mouseup, mousedown, or mouse move event
+	//   in all cases, we want to query VICKY for the current mouse location and build an event
+	//   then add it to the event queue.
+	//   only the raw position and button go in the event: the window (and control) under the mouse are found when the event is handled, 
+	//     outside the interrupt, so the time spent here is the same however many windows are open. 
+	//   nothing is printed from here either: debug output from interrupt context is slow, and can interleave with the main loop's.
 	
-	the_event_manager->read_idx_++;
-	the_event_manager->read_idx_ %= EVENT_QUEUE_SIZE;
+	uint32_t		vicky_mouse_pos;
+	int16_t			x;
+	int16_t			y;
+
+	vicky_mouse_pos = NR32(VICKYB_MOUSE_PTR_POS);
+	// mb: 2025-01-04: this is producing "DEADBEEF". Probably from the FPGA. feature may not be ready yet. use temp hard-coded butlegal values until fix.
+	//x = (int16_t)((vicky_mouse_pos & 0xffff0000) >> 16);
+	//y = (int16_t)vicky_mouse_pos & 0x0000ffff;
+	(void)vicky_mouse_pos;
+	x = 50;
+	y = 50;
 	
-	if (the_event->what_ == nullEvent)
+	EventManager_AddMouseEventAt(the_what, x, y, NULL);
+}
+
+
+//! Add a new mouse event for a known position to the event queue
+//! A mouseMoved is merged into the newest unread event if that is also a mouseMoved: only the latest position is kept.
+//! If the queue is full, the overflow policy decides what is lost. Safe to call from an interrupt handler.
+//! @param	the_what -- specifies the type of event to add to the queue. only mouseDown/up/moved events supported
+//! @param	x -- Global horizontal position of the mouse
+//! @param	y -- Global vertical position of the mouse
+//! @param	the_window -- the window the mouse is over, if known. May be NULL: mouse events from the interrupt are hit-tested when they are handled.
+void EventManager_AddMouseEventAt(event_kind the_what, int16_t x, int16_t y, Window* the_window)
+{
+	EventManager*			the_event_manager;
+	volatile EventRecord*	the_event;	// volatile: the compiler must not move the field writes past the write_idx_ update that makes them readable
+	uint8_t					the_button;
+	bool					merged;
+
+	if (the_what < mouseDown || the_what > mouseMoved) 
 	{
-		DEBUG_OUT(("%s %d: event was null. read_idx_=%i, write_idx_=%i", __func__, __LINE__, the_event_manager->read_idx_, the_event_manager->write_idx_));
-		return NULL;
+		return;
 	}
-
-	//DEBUG_OUT(("%s %d: read_idx_=%i, read_idx_ mod EVENT_QUEUE_SIZE=%i", __func__, __LINE__, the_event_manager->read_idx_, the_event_manager->read_idx_ % EVENT_QUEUE_SIZE));
-	//DEBUG_OUT(("%s %d: exiting; event what=%i (%p), read_idx_=%i, write_idx_=%i", __func__, __LINE__, the_event->what_, the_event, the_event_manager->read_idx_, the_event_manager->write_idx_));
 	
-	return the_event;
+	the_event_manager = Sys_GetEventManager(global_system);
+	
+	// keep track of which buttons are down, whether or not this event is queued. down and up kinds come in pairs: left, right, middle.
+	if (the_what != mouseMoved)
+	{
+		the_button = 1 << ((the_what - mouseDown) >> 1);
+		
+		if (((the_what - mouseDown) & 1) == 0)
+		{
+			the_event_manager->buttons_down_ |= the_button;
+		}
+		else
+		{
+			the_event_manager->buttons_down_ &= ~the_button;
+		}
+	}
+	
+	if (the_event_manager->recorder_ != NULL)
+	{
+		InputLog_AddMouse(the_event_manager->recorder_, (*the_event_manager->clock_)(), the_what, x, y);
+	}
+	
+	// don't use up a queue slot on an event nothing will act on
+	if (EventManager_WantsMouseEvent(the_event_manager, the_what) == false)
+	{
+		the_event_manager->input_.filtered_++;
+		return;
+	}
+	
+	if ( (the_event = EventRing_BeginWrite(&the_event_manager->input_, the_what, the_event_manager->overflow_policy_, &merged)) == NULL)
+	{
+		return;
+	}
+	
+	// every field is set: the record may be being reused, or merged into
+	the_event->when_ = (*the_event_manager->clock_)();
+	the_event->what_ = the_what;
+	the_event->window_ = the_window;
+	the_event->control_ = NULL;
+	the_event->mouseinfo_.modifiers_ = noneFlagBit;
+	the_event->mouseinfo_.x_ = x;
+	the_event->mouseinfo_.y_ = y;
+	the_event->mouseinfo_.control_ = NULL;
+	
+	EventRing_EndWrite(&the_event_manager->input_, merged);
 }
 
 
-//! Add a new mouse event to the event queue
-//! NOTE: this does not actually insert a new record, as the event queue is a circular buffer
-//!   It overwrites whatever slot is next in line
-//! This is designed to be called from mouse IRQ, with minimimal information available
-//! @param	the_what -- specifies the type of event to add to the queue. only mouseDown/up/moved events supported
-//! The function will query VICKY for x,y and determine if the mouse is over a window, a control, etc. 
-void EventManager_AddMouseEvent(event_kind the_what)
+//! Add a new key event to the event queue
+//! Meant for the main loop, not an interrupt: key events are posted, like window events. Nothing reads the keyboard into key events yet.
+//! @param	the_what -- keyDown, keyUp, or autoKey
+//! @param	the_key -- the key code of the key pushed. eg, KEY_BKSP (0x92), not CH_BKSP (0x08).
+//! @param	the_char -- the character code resulting from the key, after mapping
+//! @param	the_modifiers -- bit flags for shift, ctrl, meta, etc.
+//! @param	the_window -- the window the key is for. NULL for the active window.
+void EventManager_AddKeyEvent(event_kind the_what, uint8_t the_key, uint8_t the_char, uint8_t the_modifiers, Window* the_window)
 {
-	// LOGIC:
-	//   IRQ handler (presumably) has sent us a mouseup, mousedown, or mouse move event
-	//   in all cases, we want to query VICKY for the current mouse location and build an event
-	//   then add it to the event queue.
-	//   if a mouseDown or mouseUp event (r/m/l), we also want to check for any windows or controls the mouse may have been over when clicked. 
-	
 	EventManager*	the_event_manager;
 	EventRecord*	the_event;
-	uint32_t		vicky_mouse_pos;
+	bool			merged;
 
-	DEBUG_OUT(("%s %d: reached; the_what=%i", __func__, __LINE__, the_what));
-	
-	if (the_what > mouseMoved) 
+	if (the_what < keyDown || the_what > autoKey) 
 	{
-		LOG_WARN(("%s %d: non-mouse event passed. the_what=%i", __func__, __LINE__, the_what));
+		LOG_WARN(("%s %d: non-key event passed. the_what=%i", __func__, __LINE__, the_what));
 		return;
 	}
 	
 	the_event_manager = Sys_GetEventManager(global_system);
 	
-	the_event = the_event_manager->queue_[the_event_manager->write_idx_++];
-	the_event_manager->write_idx_ %= EVENT_QUEUE_SIZE;
+	if (the_event_manager->recorder_ != NULL)
+	{
+		InputLog_AddKey(the_event_manager->recorder_, (*the_event_manager->clock_)(), the_what, the_key, the_char, the_modifiers);
+	}
 	
-	vicky_mouse_pos = NR32(VICKYB_MOUSE_PTR_POS);
-	// mb: 2025-01-04: this is producing "DEADBEEF". Probably from the FPGA. feature may not be ready yet. use temp hard-coded butlegal values until fix.
-	DEBUG_OUT(("%s %d: vicky_mouse_pos=%u, %x", __func__, __LINE__, vicky_mouse_pos, vicky_mouse_pos));
-	//the_event->mouseinfo_.x_ = (int16_t)((vicky_mouse_pos & 0xffff0000) >> 16);
-	//the_event->mouseinfo_.y_ = (int16_t)vicky_mouse_pos & 0x0000ffff;
-	the_event->mouseinfo_.x_ = 50;
-	the_event->mouseinfo_.y_ = 50;
-	the_event->mouseinfo_.modifiers_ = noneFlagBit;
-
-	the_event->when_ = sys_time_jiffies();
-	the_event->what_ = the_what;
+	if (the_window == NULL)
+	{
+		the_window = Sys_GetActiveWindow(global_system);
+	}
 	
-	// do not even bother clearing out the window and mouse sub-records. for one thing, it's a union. for another, it won't get used. 
-	// TODO: check for window
-	// TODO: check for control
+	if (EventManager_WantsWindowEvent(the_window, the_what) == false)
+	{
+		the_event_manager->posted_.filtered_++;
+		return;
+	}
 	
-	if (the_what == mouseDown || the_what == mouseUp)
+	if ( (the_event = EventRing_BeginWrite(&the_event_manager->posted_, the_what, the_event_manager->overflow_policy_, &merged)) == NULL)
 	{
-		the_event->window_ = Sys_GetWindowAtXY(global_system, the_event->mouseinfo_.x_, the_event->mouseinfo_.y_);
+		LOG_WARN(("%s %d: event queue full, key event dropped. the_what=%i", __func__, __LINE__, the_what));
+		return;
 	}
+	
+	the_event->window_ = the_window;
+	the_event->control_ = NULL;
+	the_event->keyinfo_.key_ = the_key;
+	the_event->keyinfo_.char_ = the_char;
+	the_event->keyinfo_.modifiers_ = the_modifiers;
+	the_event->keyinfo_.source_ = 0;
+
+	the_event->when_ = (*the_event_manager->clock_)();
+	the_event->what_ = the_what;
+	
+	EventRing_EndWrite(&the_event_manager->posted_, merged);
 }
 
 
@@ -474,6 +1010,7 @@ void EventManager_AddWindowEvent(event_kind the_what, int16_t x, int16_t y, int1
 {
 	EventManager*	the_event_manager;
 	EventRecord*	the_event;
+	bool			merged;
 
 	DEBUG_OUT(("%s %d: reached; the_what=%i", __func__, __LINE__, the_what));
 	
@@ -485,8 +1022,22 @@ void EventManager_AddWindowEvent(event_kind the_what, int16_t x, int16_t y, int1
 	
 	the_event_manager = Sys_GetEventManager(global_system);
 	
-	the_event = the_event_manager->queue_[the_event_manager->write_idx_++];
-	the_event_manager->write_idx_ %= EVENT_QUEUE_SIZE;
+	if (the_window == NULL)
+	{
+		the_window = Sys_GetActiveWindow(global_system);
+	}
+	
+	if (EventManager_WantsWindowEvent(the_window, the_what) == false)
+	{
+		the_event_manager->posted_.filtered_++;
+		return;
+	}
+	
+	if ( (the_event = EventRing_BeginWrite(&the_event_manager->posted_, the_what, the_event_manager->overflow_policy_, &merged)) == NULL)
+	{
+		LOG_WARN(("%s %d: event queue full, window event dropped. the_what=%i", __func__, __LINE__, the_what));
+		return;
+	}
 	
 	the_event->window_ = the_window;
 	the_event->control_ = the_control;
@@ -496,17 +1047,10 @@ void EventManager_AddWindowEvent(event_kind the_what, int16_t x, int16_t y, int1
 	the_event->windowinfo_.width_ = width;
 	the_event->windowinfo_.height_ = height;
 
-	if (the_window == NULL)
-	{
-		the_event->window_ = Sys_GetActiveWindow(global_system);
-	}	
-	else
-	{
-		the_event->window_ = the_window;
-	}
-
-	the_event->when_ = sys_time_jiffies();
+	the_event->when_ = (*the_event_manager->clock_)();
 	the_event->what_ = the_what;
+	
+	EventRing_EndWrite(&the_event_manager->posted_, merged);
 }
 
 
@@ -522,6 +1066,7 @@ void EventManager_AddMenuEvent(event_kind the_what, int16_t menu_selection, int1
 {
 	EventManager*	the_event_manager;
 	EventRecord*	the_event;
+	bool			merged;
 
 	DEBUG_OUT(("%s %d: reached; the_what=%i", __func__, __LINE__, the_what));
 	
@@ -533,24 +1078,33 @@ void EventManager_AddMenuEvent(event_kind the_what, int16_t menu_selection, int1
 	
 	the_event_manager = Sys_GetEventManager(global_system);
 	
-	the_event = the_event_manager->queue_[the_event_manager->write_idx_++];
-	the_event_manager->write_idx_ %= EVENT_QUEUE_SIZE;
-	
-	the_event->menuinfo_.selection_ = menu_selection;
-	the_event->menuinfo_.x_ = x;
-	the_event->menuinfo_.y_ = y;
-
 	if (the_window == NULL)
 	{
-		the_event->window_ = Sys_GetActiveWindow(global_system);
-	}	
-	else
+		the_window = Sys_GetActiveWindow(global_system);
+	}
+	
+	if (EventManager_WantsWindowEvent(the_window, the_what) == false)
 	{
-		the_event->window_ = the_window;
+		the_event_manager->posted_.filtered_++;
+		return;
+	}
+	
+	if ( (the_event = EventRing_BeginWrite(&the_event_manager->posted_, the_what, the_event_manager->overflow_policy_, &merged)) == NULL)
+	{
+		LOG_WARN(("%s %d: event queue full, menu event dropped. the_what=%i", __func__, __LINE__, the_what));
+		return;
 	}
+	
+	the_event->window_ = the_window;
+	the_event->control_ = NULL;
+	the_event->menuinfo_.selection_ = menu_selection;
+	the_event->menuinfo_.x_ = x;
+	the_event->menuinfo_.y_ = y;
 
-	the_event->when_ = sys_time_jiffies();
+	the_event->when_ = (*the_event_manager->clock_)();
 	the_event->what_ = the_what;
+	
+	EventRing_EndWrite(&the_event_manager->posted_, merged);
 }
 
 
@@ -592,6 +1146,10 @@ void EventManager_HandleMouseUp(EventManager* the_event_manager, EventRecord* th
 	the_event->window_ = the_window; // mouse up window not necessarily same as mouse down window!
 	clicked_window = Mouse_GetClickedWindow(the_event_manager->mouse_tracker_);
 	
+	// any drag/resize outline or drag image is finished with: undraw it before the window is moved and the screen repaired
+	Mouse_ClearDragOutline(the_event_manager->mouse_tracker_);
+	Mouse_ClearDragImage(the_event_manager->mouse_tracker_);
+	
 	// no matter what, reset the mouse history position flags
 	Mouse_AcceptUpdate(the_event_manager->mouse_tracker_, NULL, the_event->mouseinfo_.x_, the_event->mouseinfo_.y_, false);
 
@@ -623,7 +1181,7 @@ void EventManager_HandleMouseUp(EventManager* the_event_manager, EventRecord* th
 	{					
 		DEBUG_OUT(("%s %d: mouse up from mouseDragTitle: move window '%s'!", __func__, __LINE__, clicked_window->title_));
 		
-		if (x_delta != 0 && y_delta != 0)
+		if (x_delta != 0 || y_delta != 0)
 		{
 			int16_t	new_x;
 			int16_t	new_y;
@@ -837,7 +1395,7 @@ void EventManager_HandleMouseDown(EventManager* the_event_manager, EventRecord*
 			DEBUG_OUT(("%s %d: ** control '%s' (id=%i) moused down!", __func__, __LINE__, the_event->control_->caption_, the_event->control_->id_));
 			Window_SetSelectedControl(the_event->window_, the_event->control_);
 			Control_SetPressed(the_event->control_, CONTROL_PRESSED);
-			Window_Render(the_event->window_);
+			Sys_RequestRender(global_system);
 			// give window an event
 			//(*the_window->event_handler_)(the_event);
 			
@@ -971,8 +1529,15 @@ void EventManager_HandleMouseMoved(EventManager* the_event_manager, EventRecord*
 
 	starting_mode = Mouse_GetMode(the_event_manager->mouse_tracker_);
 
+	// mouse moves are queued without a window. while dragging, resizing, or pressing a control, it's the window the mouse went down in.
 	the_window = the_event->window_;
 	
+	if (the_window == NULL && (starting_mode == mouseDragTitle || starting_mode == mouseDownOnControl || starting_mode >= mouseResizeUp))
+	{
+		the_window = Mouse_GetClickedWindow(the_event_manager->mouse_tracker_);
+		the_event->window_ = the_window;
+	}
+	
 	// update the mouse so it knows it's X/Y
 	Mouse_SetXY(the_event_manager->mouse_tracker_, the_event->mouseinfo_.x_, the_event->mouseinfo_.y_);
 
@@ -1006,36 +1571,50 @@ void EventManager_HandleMouseMoved(EventManager* the_event_manager, EventRecord*
 	}
 	else if (starting_mode == mouseDragTitle)
 	{
-		// for a drag rect, we want to draw an outline same shape as the Window, in the foreground bitmap
-		// as mouse moves, we want to undraw the previous rect, and draw the new one.
-		// we need to know what the previous mouse X/Y was for that to work. (unless we just clear the whole foreground bitmap, but that seems dumb expensive)
-		// we will store every mouse-move X/Y as proposed X/Y in the window, and use that to draw/refresh rect as needed
-		// will also need proposed width/height, for size drags.
+		// LOGIC:
+		//   in outline mode (the default), only an XOR outline the shape of the window follows the mouse. 
+		//     moving it touches only the outline's pixels; the window is moved, and the screen repaired, once, on mouse up
+		//   where there are sprites (A2560K family), the part of the window around the click is carried under the pointer as a sprite instead:
+		//     it follows every position update with a register write, and no screen pixels change until mouse up.
+		//   in live mode, the window is moved on every mouse move, and the click position is reset so the next delta is relative to the new window position
 		
 		if (the_event->window_ != NULL)
 		{
-			if (x_delta != 0 && y_delta != 0)
+			if (x_delta != 0 || y_delta != 0)
 			{
-				int16_t	new_x;
-				int16_t	new_y;
-				int16_t	new_width;
-				int16_t	new_height;
-				//bool	change_made = false;
+				Rectangle	new_rect;
 				
 				DEBUG_OUT(("%s %d: window x/y (%i, %i)", __func__, __LINE__,  Window_GetX(the_window), Window_GetY(the_window)));
 				
-				new_x = Window_GetX(the_window) + x_delta;
-				new_y = Window_GetY(the_window) + y_delta;
-				new_width = Window_GetWidth(the_window);
-				new_height = Window_GetHeight(the_window);
+				new_rect.MinX = Window_GetX(the_window) + x_delta;
+				new_rect.MinY = Window_GetY(the_window) + y_delta;
+				new_rect.MaxX = new_rect.MinX + Window_GetWidth(the_window) - 1;
+				new_rect.MaxY = new_rect.MinY + Window_GetHeight(the_window) - 1;
 
-				//if (change_made)
+				if (Sys_GetWindowDragMode(global_system) == WIN_DRAG_LIVE)
 				{
-					Bitmap*		the_bitmap = Sys_GetScreenBitmap(global_system, back_layer);
-			
-					// undraw the old box, draw the new one. temporary problem: A2560 emulators are not currently doing composition, so we can't draw to foreground layer. 
-					//Bitmap_DrawBox(the_bitmap, prev_x, prev_y, prev_width, prev_height, 0, PARAM_DO_NOT_FILL)
-					Bitmap_DrawBox(the_bitmap, new_x, new_y, new_width, new_height, SYS_COLOR_RED1, PARAM_DO_NOT_FILL);						
+					Window_ChangeWindow(the_window, new_rect.MinX, new_rect.MinY, Window_GetWidth(the_window), Window_GetHeight(the_window), WIN_PARAM_UPDATE_NORM_SIZE_TO_MATCH);
+					Mouse_AcceptUpdate(the_event_manager->mouse_tracker_, the_window, the_event->mouseinfo_.x_, the_event->mouseinfo_.y_, true);
+				}
+				else if (Mouse_HasDragImage(the_event_manager->mouse_tracker_) == false)
+				{
+					Rectangle	the_grab;
+					int16_t		grab_x;
+					int16_t		grab_y;
+					
+					// window-local position of the click: the image is centered on it
+					grab_x = Mouse_GetClickedX(the_event_manager->mouse_tracker_) - Window_GetX(the_window);
+					grab_y = Mouse_GetClickedY(the_event_manager->mouse_tracker_) - Window_GetY(the_window);
+					the_grab.MinX = grab_x - SPRITE_SIZE / 2;
+					the_grab.MinY = grab_y - SPRITE_SIZE / 2;
+					the_grab.MaxX = the_grab.MinX + SPRITE_SIZE - 1;
+					the_grab.MaxY = the_grab.MinY + SPRITE_SIZE - 1;
+					
+					if (Sys_HasSprites(global_system) == false || 
+						Mouse_SetDragImage(the_event_manager->mouse_tracker_, Window_GetBitmap(the_window), &the_grab, SPRITE_SIZE / 2, SPRITE_SIZE / 2) == false)
+					{
+						Mouse_DrawDragOutline(the_event_manager->mouse_tracker_, &new_rect);
+					}
 				}
 			}
 		}					
@@ -1101,11 +1680,14 @@ void EventManager_HandleMouseMoved(EventManager* the_event_manager, EventRecord*
 		
 		if (change_made)
 		{
-			Bitmap*		the_bitmap = Sys_GetScreenBitmap(global_system, back_layer);
+			Rectangle	new_rect;
 			
-			// undraw the old box, draw the new one. temporary problem: A2560 emulators are not currently doing composition, so we can't draw to foreground layer. 
-			//Bitmap_DrawBox(the_bitmap, prev_x, prev_y, prev_width, prev_height, 0, PARAM_DO_NOT_FILL)
-			Bitmap_DrawBox(the_bitmap, new_x, new_y, new_width, new_height, SYS_COLOR_GREEN1, PARAM_DO_NOT_FILL);						
+			// move the XOR outline to the proposed size; the window itself is resized once, on mouse up
+			new_rect.MinX = new_x;
+			new_rect.MinY = new_y;
+			new_rect.MaxX = new_x + new_width - 1;
+			new_rect.MaxY = new_y + new_height - 1;
+			Mouse_DrawDragOutline(the_event_manager->mouse_tracker_, &new_rect);
 		}
 	}
 	else if (starting_mode == mouseDownOnControl)
@@ -1123,7 +1705,7 @@ void EventManager_HandleMouseMoved(EventManager* the_event_manager, EventRecord*
 
 		Window_SetSelectedControl(the_event->window_, the_event->control_);
 		Control_SetPressed(the_event->control_, CONTROL_NOT_PRESSED);
-		Window_Render(the_event->window_);
+		Sys_RequestRender(global_system);
 		
 		if (the_event->control_)
 		{
@@ -1135,234 +1717,309 @@ void EventManager_HandleMouseMoved(EventManager* the_event_manager, EventRecord*
 			if (clicked_control != the_event->control_)
 			{
 				Control_SetPressed(the_event->control_, CONTROL_NOT_PRESSED);
-				Window_Render(the_event->window_);
+				Sys_RequestRender(global_system);
 			}
 		}
 	}
 	else
 	{
-		// give window an event
-		(*the_window->event_handler_)(the_event);				
+		// give the window under the mouse an event
+		if (the_window == NULL)
+		{
+			the_window = Sys_GetWindowAtXY(global_system, the_event->mouseinfo_.x_, the_event->mouseinfo_.y_);
+			the_event->window_ = the_window;
+		}
+		
+		EventManager_DispatchToWindow(the_event_manager, the_event);
 	}					
 }
 
 
+//! Do system-processing of an event, then if appropriate, give the window responsible for the event a chance to do something with it
+//! EventManager_WaitForEvent() calls this for each event. Call it directly only from a loop that reads events with EventManager_NextEvent() itself.
+//! @param	the_event -- an event returned by EventManager_NextEvent()
+void EventManager_DispatchEvent(EventRecord* the_event)
+{
+	EventManager*	the_event_manager;
+	void			(*the_handler)(EventManager*, EventRecord*);
+	
+	if (the_event == NULL || the_event->what_ >= invalidEvent)
+	{
+		return;
+	}
+	
+	the_event_manager = Sys_GetEventManager(global_system);
+	
+	DEBUG_OUT(("%s %d: Received Event: type=%i", __func__, __LINE__, the_event->what_));
+	//Event_Print(the_event);
+	
+	// LOGIC:
+	//   event could be for:
+	//   1. a mouse event. Will sort out non-app window click vs main window click vs about window click in the specific handler
+	//   2. a window, menu, or timer event. goes to the window it is for, if that window subscribes to it
+	//   3. a keyboard event. goes to the window picked when it was added (normally the active window), if it subscribes to it
+	//   the table says which: there is no need to look at every kind in turn
+	
+	the_handler = event_dispatch_table[the_event->what_];
+	
+	if (the_handler != NULL)
+	{
+		(*the_handler)(the_event_manager, the_event);
+	}
+}
+
+
 //! Wait for an event to happen, do system-processing of it, then if appropriate, give the window responsible for the event a chance to do something with it
 void EventManager_WaitForEvent(void)
 {
 	EventManager*	the_event_manager;
 	EventRecord*	the_event;
+	uint32_t		ticks_to_timer;
 	bool			exit_loop = false;
 	
 	the_event_manager = Sys_GetEventManager(global_system);
 	
+	// timers due while the last events were being handled go in the queue first. then, if there is nothing to do, sleep until there is.
+	ticks_to_timer = EventManager_RunTimers();
+	
+	if (EventManager_HasEvents(the_event_manager) == false)
+	{
+		EventManager_Idle(the_event_manager, ticks_to_timer);
+	}
+	
 	//DEBUG_OUT(("%s %d: write_idx_=%i, read_idx_=%i", __func__, __LINE__, the_event_manager->write_idx_, the_event_manager->read_idx_));
 
 	//while ( (the_event = EventManager_NextEvent()) != NULL)	// mb: this is getting a real event pointer, but the pointer shows 0 for some reason. 
 	while ( !exit_loop)
 	{
-		MouseMode		starting_mode;
-		Window*			the_active_window;
+		the_event = EventManager_NextEvent();
 		
-		the_event = EventManager_NextEvent();	// MB 2025: in theory, this should return NULLs some time, but it is always returnning NULL, even tho pointer works. See Event_Print()
-		
-		if (the_event->what_ == nullEvent || the_event->what_ >= invalidEvent)
+		if (the_event == NULL || the_event->what_ >= invalidEvent)
 		{
 			exit_loop = true;
 		}
 		else
 		{
-			DEBUG_OUT(("%s %d: Received Event: type=%i", __func__, __LINE__, the_event->what_));
-			//Event_Print(the_event);
-			
-			starting_mode = Mouse_GetMode(the_event_manager->mouse_tracker_);
-			
-			// LOGIC:
-			//   event could be for:
-			//   1. a mouse event. Will sort out non-app window click vs main window click vs about window click in the specific handler
-			//   2. an update event. need to detect and route for main window vs about window
-			//   3. an activate event. need to detect and route for main window vs about window
-			//   4. a keyboard event. need to check for menu shortcuts and activate menus. no other keyboard input needed.
-	
-			switch (the_event->what_)
-			{
-				case nullEvent:
-					DEBUG_OUT(("%s %d: null event", __func__, __LINE__));
-					break;
-			
-				case mouseMoved:				
-					DEBUG_OUT(("%s %d: mouse move event (%i, %i)", __func__, __LINE__, the_event->mouseinfo_.x_, the_event->mouseinfo_.y_));
-	
-					EventManager_HandleMouseMoved(the_event_manager, the_event);
+			EventManager_DispatchEvent(the_event);
+		}
 		
-					break;
-					
-				case mouseDown:				
-					DEBUG_OUT(("%s %d: mouse down event (%i, %i)", __func__, __LINE__, the_event->mouseinfo_.x_, the_event->mouseinfo_.y_));
+		//DEBUG_OUT(("%s %d: r idx=%i, w idx=%i, meets_mask will be=%x", __func__, __LINE__, the_event_manager->write_idx_, the_event_manager->read_idx_, the_event->what_ & the_mask));
+		
+		//getchar();	
+		//General_DelayTicks(5);
+		
+		// if a new frame has started, draw whatever the events so far have changed. otherwise keep collecting.
+		Sys_FlushRender(global_system, PARAM_DO_NOT_WAIT_FOR_FRAME);
+	}
 	
-					EventManager_HandleMouseDown(the_event_manager, the_event);
-					
-					break;
+	// queue is empty: draw what is left if a new frame has started. if not, don't wait here for one: the next pass of the loop draws it.
+	Sys_FlushRender(global_system, PARAM_DO_NOT_WAIT_FOR_FRAME);
+	
+	return;
+}
+
+
+//! Set what happens to a new event when its queue is full
+//! @param	the_policy -- EVENT_OVERFLOW_DROP_OLDEST (the default), EVENT_OVERFLOW_DROP_NEWEST, or EVENT_OVERFLOW_COALESCE
+void EventManager_SetOverflowPolicy(event_overflow_policy the_policy)
+{
+	EventManager*	the_event_manager;
 	
-				case mouseUp:
-					DEBUG_OUT(("%s %d: mouse up event (%i, %i)", __func__, __LINE__, the_event->mouseinfo_.x_, the_event->mouseinfo_.y_));
+	the_event_manager = Sys_GetEventManager(global_system);
+	the_event_manager->overflow_policy_ = the_policy;
+}
+
+
+//! Get counts of events lost to full queues, and of events merged into other events, since startup
+//! @param	dropped -- receives the number of events thrown away or written over before being read. Can be NULL.
+//! @param	coalesced -- receives the number of events merged into a newer event. Can be NULL.
+void EventManager_GetQueueStats(uint32_t* dropped, uint32_t* coalesced)
+{
+	EventManager*	the_event_manager;
 	
-					EventManager_HandleMouseUp(the_event_manager, the_event);
-					
-					break;
+	// LOGIC: each ring keeps separate counts for its writer and its reader, so neither has to update a count the other can change
 	
-				case rMouseDown:				
-					DEBUG_OUT(("%s %d: right mouse down event (%i, %i)", __func__, __LINE__, the_event->mouseinfo_.x_, the_event->mouseinfo_.y_));
+	the_event_manager = Sys_GetEventManager(global_system);
 	
-					EventManager_HandleRightMouseDown(the_event_manager, the_event);
-					
-					break;
+	if (dropped)
+	{
+		*dropped = the_event_manager->input_.dropped_newest_ + the_event_manager->input_.dropped_oldest_ + the_event_manager->input_.evicted_ + 
+				   the_event_manager->posted_.dropped_newest_ + the_event_manager->posted_.dropped_oldest_ + the_event_manager->posted_.evicted_;
+	}
 	
-				case rMouseUp:
-					DEBUG_OUT(("%s %d: right mouse up event (%i, %i)", __func__, __LINE__, the_event->mouseinfo_.x_, the_event->mouseinfo_.y_));
+	if (coalesced)
+	{
+		*coalesced = the_event_manager->input_.coalesced_ + the_event_manager->posted_.coalesced_;
+	}
+}
+
+
+//! Add the event kinds in the passed mask to those wanted by windows. Call once for each window that subscribes.
+//! Events of kinds no window subscribes to, and that the system doesn't act on, are thrown away when added, without using a queue slot.
+//! @param	the_mask -- the event_mask bits of the event kinds subscribed to
+void EventManager_Subscribe(uint32_t the_mask)
+{
+	EventManager*	the_event_manager;
+	uint32_t		new_mask;
+	int16_t			i;
 	
-					// eat this event: we don't care about right mouse up: menu events are designed to fire on right mouse DOWN
-					
-					break;
+	the_event_manager = Sys_GetEventManager(global_system);
+	new_mask = the_event_manager->wanted_mask_;
 	
-				case menuOpened:
-					DEBUG_OUT(("%s %d: menu opened event: %c", __func__, __LINE__, the_event->menuinfo_.selection_));
-					// give window an event
-					(*the_event->window_->event_handler_)(the_event);
-			
-					break;
-					
-				case menuSelected:
-					DEBUG_OUT(("%s %d: menu item selected event: %c", __func__, __LINE__, the_event->menuinfo_.selection_));
-					// give window an event
-					(*the_event->window_->event_handler_)(the_event);
-			
-					break;
-					
-				case controlClicked:
-					DEBUG_OUT(("%s %d: control clicked event: %c", __func__, __LINE__, the_event->control_->id_));
-					// give window an event
-					(*the_event->window_->event_handler_)(the_event);
-			
-					break;
-					
-				case keyDown:
-					DEBUG_OUT(("%s %d: key down event: '%c' (%x) mod (%x)", __func__, __LINE__, the_event->keyinfo_.key_, the_event->keyinfo_.key_, the_event->keyinfo_.modifiers_));
+	for (i = 0; i < invalidEvent; i++)
+	{
+		if (the_mask & EVENT_MASK_FOR(i))
+		{
+			the_event_manager->subscribers_[i]++;
+			new_mask |= EVENT_MASK_FOR(i);
+		}
+	}
 	
-					// give active window an event
-					the_active_window = Sys_GetActiveWindow(global_system);
+	// one write, so the mouse interrupt never sees a half-updated mask
+	the_event_manager->wanted_mask_ = new_mask;
+}
+
+
+//! Take back a subscription made with EventManager_Subscribe()
+//! @param	the_mask -- the event_mask bits passed to EventManager_Subscribe()
+void EventManager_Unsubscribe(uint32_t the_mask)
+{
+	EventManager*	the_event_manager;
+	uint32_t		new_mask;
+	int16_t			i;
 	
-					(*the_active_window->event_handler_)(the_event);				
+	the_event_manager = Sys_GetEventManager(global_system);
+	new_mask = the_event_manager->wanted_mask_;
 	
-					break;
-				
-				case keyUp:
-					DEBUG_OUT(("%s %d: key up event: '%c' (%x) mod (%x)", __func__, __LINE__, the_event->keyinfo_.key_, the_event->keyinfo_.key_, the_event->keyinfo_.modifiers_));
-	
-					// give active window an event
-					the_active_window = Sys_GetActiveWindow(global_system);
-	
-					(*the_active_window->event_handler_)(the_event);				
-	
-					break;
-	
-				case updateEvt:
-					DEBUG_OUT(("%s %d: updateEvt event", __func__, __LINE__));
-	
-					// give window an event
-					(*the_event->window_->event_handler_)(the_event);				
-	
-	// 				// Get a RSS surface pointer from the message
-	// 				//  LOGIC: the_window will be 0 in some cases
-	// 				//    for activateEvt and updateEvt, message will be WindowPtr
-	// 				//    (see EventRecord)
-	// 			
-	// 				affected_app_window = (RSSWindow*)GetWRefCon((WindowPtr)the_event->message);
-	// 
-	// 				if (affected_app_window == global_app->main_window_)
-	// 				{
-	// 					the_surface = (RSSWindow*)affected_app_window;
-	// 					Window_HandleUpdateEvent(the_surface, the_event);
-	// 				}
-	// 				else
-	// 				{
-	// 					// maybe it was an About window that got the event? 	
-	// 					if (affected_app_window == global_app->about_window_)
-	// 					{
-	// 						the_about_window = (RSSAboutWindow*)affected_app_window;
-	// 						AboutWindow_HandleUpdateEvent(the_about_window, the_event);
-	// 					}
-	// 				}
-	// 			
-	// 				return kUIMsgTypeNonRelevant;
-					break;
-				
-				case activateEvt:
-					DEBUG_OUT(("%s %d: activateEvt event", __func__, __LINE__));
+	for (i = 0; i < invalidEvent; i++)
+	{
+		if ((the_mask & EVENT_MASK_FOR(i)) && the_event_manager->subscribers_[i] > 0)
+		{
+			if (--the_event_manager->subscribers_[i] == 0)
+			{
+				new_mask &= ~EVENT_MASK_FOR(i);
+			}
+		}
+	}
 	
-					// give window an event
-					(*the_event->window_->event_handler_)(the_event);				
+	the_event_manager->wanted_mask_ = new_mask;
+}
+
+
+//! Get the number of events thrown away when added because nothing was subscribed to them, since startup
+uint32_t EventManager_GetFilteredCount(void)
+{
+	EventManager*	the_event_manager;
 	
-					
-					// tell window to make its active_ state
-					//Window_SetActive(the_event->window_, true); // now this is done as part of Sys_SetActiveWindow
+	the_event_manager = Sys_GetEventManager(global_system);
+	
+	return the_event_manager->input_.filtered_ + the_event_manager->posted_.filtered_;
+}
+
+
+
+// **** Timer functions *****
+
+//! Start a timer that sends a timerEvt to the passed window. If the window already has a timer with this ID, it is restarted.
+//! Timer events go through the window's event mask like any other window event: the window must subscribe to timerEvtMask to get them.
+//! @param	the_window -- the window to send timer events to
+//! @param	the_id -- ID for the timer, passed back in the event's timerinfo_. Each window has its own IDs.
+//! @param	delay -- ticks until the timer first fires (60 per second)
+//! @param	period -- ticks between firings after the first. 0 for a timer that fires once.
+//! @return	Returns false if the timer could not be started
+bool EventManager_StartTimer(Window* the_window, uint16_t the_id, uint32_t delay, uint32_t period)
+{
+	EventManager*	the_event_manager;
 	
-					// do what, exactly? 
-					//Sys_SetActiveWindow(global_system, the_event->window_); // don't set here, set in the mouse down thing that caused it
-					//Sys_Render(global_system);
+	if (the_window == NULL)
+	{
+		LOG_ERR(("%s %d: passed window was null", __func__ , __LINE__));
+		return false;
+	}
 	
-					//Sys_SetActiveWindow(global_system, the_event->window_);
-					//DEBUG_OUT(("%s %d: **** changed active window to = '%s'; redrawing all windows", __func__, __LINE__, the_event->window_));
-					
-					
-					// need to make system move the window to the front
-					// but also need to give app a chance to get this activate event before system does that. 
-					//Window_Activate(the_event->window_);
-					
-					break;
-				
-				case inactivateEvt:
-					DEBUG_OUT(("%s %d: inactivateEvt event", __func__, __LINE__));
-					// do what, exactly? 
-					//Sys_SetActiveWindow(global_system, the_event->window_);
-					
-					// tell window to make its active_ state
-					Window_SetActive(the_event->window_, false); // now this is done as part of Sys_SetActiveWindow
-					//Sys_Render(global_system);
+	the_event_manager = Sys_GetEventManager(global_system);
 	
-					// give window an event
-					(*the_event->window_->event_handler_)(the_event);				
+	// bring the wheel up to date first: the delay counts from now, not from whenever timers were last run
+	EventManager_RunTimers();
 	
-					
-					// need to make system move the window to the front
-					// but also need to give app a chance to get this activate event before system does that. 
-					//Window_Inactivate(the_event->window_);
-					
-					break;
+	return TimerWheel_StartTimer(the_event_manager->timer_wheel_, the_window, the_id, delay, period);
+}
+
+
+//! Stop a timer started with EventManager_StartTimer(). Does nothing if there is no such timer.
+//! @param	the_window -- the window the timer was started for
+//! @param	the_id -- ID the timer was started with
+void EventManager_StopTimer(Window* the_window, uint16_t the_id)
+{
+	EventManager*	the_event_manager;
 	
-				case windowChanged:
-					DEBUG_OUT(("%s %d: windowChanged event", __func__, __LINE__));
+	the_event_manager = Sys_GetEventManager(global_system);
 	
-					// give window an event
-					(*the_event->window_->event_handler_)(the_event);				
+	TimerWheel_StopTimer(the_event_manager->timer_wheel_, the_window, the_id);
+}
+
+
+//! Post a timerEvt for each timer that is due
+//! EventManager_WaitForEvent() calls this: only call it directly from a loop that doesn't use EventManager_WaitForEvent().
+//! @return	Returns the number of ticks until the next timer could be due, or TIMER_NONE_PENDING if there are no timers
+uint32_t EventManager_RunTimers(void)
+{
+	EventManager*	the_event_manager;
 	
-					break;
-				
-				default:
-					DEBUG_OUT(("%s %d: other event: %i", __func__, __LINE__, the_event->what_));
-					
-					break;
-			}
-		}
-		
-		//DEBUG_OUT(("%s %d: r idx=%i, w idx=%i, meets_mask will be=%x", __func__, __LINE__, the_event_manager->write_idx_, the_event_manager->read_idx_, the_event->what_ & the_mask));
-		
-		//getchar();	
-		//General_DelayTicks(5);
-	}
+	the_event_manager = Sys_GetEventManager(global_system);
 	
-	return;
+	TimerWheel_Advance(the_event_manager->timer_wheel_, (*the_event_manager->clock_)(), &EventManager_PostTimerEvent);
+	
+	return TimerWheel_GetTicksToNext(the_event_manager->timer_wheel_);
+}
+
+
+//! Replace the clock used to time events and run timers
+//! For tests and replays, where time has to move under the program's control rather than with the jiffy count
+//! @param	the_clock -- function returning the time in ticks. NULL to go back to sys_time_jiffies().
+void EventManager_SetClock(uint32_t (*the_clock)(void))
+{
+	EventManager*	the_event_manager;
+	
+	// LOGIC: the wheel can't go back in time: timers are moved to the new clock's time, keeping the ticks each has left
+	
+	the_event_manager = Sys_GetEventManager(global_system);
+	the_event_manager->clock_ = (the_clock != NULL) ? the_clock : &EventManager_GetJiffies;
+	
+	TimerWheel_SetTime(the_event_manager->timer_wheel_, (*the_event_manager->clock_)());
+}
+
+
+//! Get the time in ticks, from the event manager's clock
+uint32_t EventManager_GetTicks(void)
+{
+	EventManager*	the_event_manager;
+	
+	the_event_manager = Sys_GetEventManager(global_system);
+	
+	return (*the_event_manager->clock_)();
 }
 
 
 
+// **** Recording functions *****
+
+//! Start recording raw mouse and key input into the passed log, emptying it first. Recording a log replaces any recording already going on.
+//! Input is recorded as it arrives, before it is filtered or coalesced. See inputlog.h.
+//! @param	the_log -- the log to record into. NULL to stop recording.
+void EventManager_SetRecorder(InputLog* the_log)
+{
+	EventManager*	the_event_manager;
+	
+	// LOGIC: the mouse interrupt reads recorder_: the log is ready before it is set, and setting it is a single write
+	
+	the_event_manager = Sys_GetEventManager(global_system);
+	
+	if (the_log != NULL)
+	{
+		the_event_manager->recorder_ = NULL;
+		InputLog_Begin(the_log, (*the_event_manager->clock_)());
+	}
+	
+	the_event_manager->recorder_ = the_log;
+}
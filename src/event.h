@@ -56,7 +56,15 @@
 /*                            Macro Definitions                              */
 /*****************************************************************************/
 
-#define EVENT_QUEUE_SIZE	128		//! number of event records in the circular buffer
+#define EVENT_QUEUE_SIZE	128		//! number of event records in each circular buffer. Must be a power of 2.
+
+#define EVENT_MASK_FOR(the_what)	((uint32_t)1 << (the_what))	//! the event_mask bit for an event_kind
+
+//! event kinds the system acts on itself: these are queued whether or not any window subscribes to them
+#define EVENT_SYSTEM_MASK	(mouseDownMask | mouseUpMask | rMouseDownMask | inactivateEvtMask)
+
+//! event kinds that can be handed to a window's event handler. A window can only subscribe to these.
+#define EVENT_WINDOW_MASK	(mouseMovedMask | keyDownMask | keyUpMask | autoKeyMask | windowChangedMask | updateMask | activateEvtMask | inactivateEvtMask | controlClickedMask | menuOpenedMask | menuSelectedMask | menuCanceledMask | timerEvtMask)
 
 
 /*****************************************************************************/
@@ -85,6 +93,7 @@ typedef enum event_kind
 	menuSelected			,	// menu event
 	menuCanceled			,	// menu event
 	diskEvt					,	// DOS event
+	timerEvt				,	// a window's timer has fired
 	invalidEvent			,	// marker for last event type supported
 } event_kind;
 
@@ -110,7 +119,8 @@ typedef enum event_mask
 	windowChangedMask		= 1 << windowChanged,	// a window has changed size and/or position
 	mMouseDownMask			= 1 << mMouseDown,		// middle mouse button pressed
 	mMouseUpMask			= 1 << mMouseUp,		// middle mouse button released
-	everyEvent				= 0xFFFF				// all of the above
+	timerEvtMask			= 1 << timerEvt,		// a timer started with EventManager_StartTimer() has fired
+	everyEvent				= (1 << invalidEvent) - 1	// all of the above
 } event_mask;
 
 
@@ -144,6 +154,14 @@ typedef enum event_modifier_flags
 } event_modifier_flags;
 
 
+typedef enum event_overflow_policy
+{
+	EVENT_OVERFLOW_DROP_OLDEST	= 0,	// the oldest unread mouseMoved is thrown out to make room. With none, a new move is thrown away, and any other event is written over the oldest unread event
+	EVENT_OVERFLOW_DROP_NEWEST	= 1,	// a new move is thrown away. Any other event throws out the oldest unread move; with none, it is thrown away
+	EVENT_OVERFLOW_COALESCE		= 2,	// a new event replaces the newest unread event if that is a mouseMoved. Otherwise, as for EVENT_OVERFLOW_DROP_NEWEST
+} event_overflow_policy;
+
+
 // TODO: localize this for A2560
 enum
 {
@@ -207,6 +225,11 @@ struct EventWindow {
 	int16_t				height_;	//! for window events: the new height of the window.
 };
 
+struct EventTimer {
+	uint16_t			id_;		//! for timer events: the ID the timer was started with
+	uint16_t			missed_;	//! for timer events: the number of times a periodic timer was due but didn't fire, because the event loop fell behind. Usually 0.
+};
+
 struct EventRecord
 {
 	uint32_t			when_;		//! ticks
@@ -218,15 +241,35 @@ struct EventRecord
 		EventMouse		mouseinfo_;
 		EventWindow		windowinfo_;
 		EventMenu		menuinfo_;
+		EventTimer		timerinfo_;
 	};
 };
 
+struct EventRing
+{
+	EventRecord*		queue_[EVENT_QUEUE_SIZE];	//! circular buffer of event records. Events are copied in and out: the records never leave the ring.
+	volatile uint16_t	write_idx_;					//! count of events written (wraps). Only the producer changes it. The slot is write_idx_ % EVENT_QUEUE_SIZE.
+	volatile uint16_t	read_idx_;					//! count of events claimed by the reader (wraps). Only the consumer changes it.
+	volatile uint32_t	dropped_newest_;			//! producer's count of new events thrown away because the ring was full
+	volatile uint32_t	coalesced_;					//! producer's count of events merged into (or written over) the newest unread event
+	volatile uint32_t	filtered_;					//! producer's count of new events thrown away because nothing was subscribed to them
+	volatile uint32_t	evicted_;					//! producer's count of unread mouseMoved events thrown out to make room for a newer event
+	uint32_t			dropped_oldest_;			//! consumer's count of unread events the producer wrote over before they could be read
+};
+
 struct EventManager
 {
-	EventRecord*		queue_[EVENT_QUEUE_SIZE];	//! circular buffer for the event queue
-	uint16_t			write_idx_;					//! index to queue_: where the next event record will be slotted
-	uint16_t			read_idx_;					//! index to queue_: where the next event record will be read from
+	EventRing			input_;						//! mouse events. Written only by interrupt handlers.
+	EventRing			posted_;					//! window and menu events. Written only by the main loop, while it handles other events.
+	EventRecord			current_;					//! the event handed out by EventManager_NextEvent(): a copy, so interrupts can keep writing to the ring while it is handled
+	event_overflow_policy	overflow_policy_;		//! what to do with a new event when its ring is full
 	MouseTracker*		mouse_tracker_;				//! tracks whether mouse is in drag mode, etc.
+	volatile uint32_t	wanted_mask_;				//! event kinds at least one window subscribes to. Read by interrupt handlers: only ever changed with a single write.
+	uint8_t				subscribers_[invalidEvent];	//! for each event kind, the number of windows subscribed to it
+	volatile uint8_t	buttons_down_;				//! bit for each mouse button down (1=left, 2=right, 4=middle), as of the last mouse event added. Only the mouse interrupt changes it.
+	TimerWheel*			timer_wheel_;				//! windows' timers. Only the main loop uses it: timers are run between events, not from an interrupt.
+	uint32_t			(*clock_)(void);			//! returns the time in ticks. sys_time_jiffies() unless replaced with EventManager_SetClock().
+	InputLog* volatile	recorder_;					//! if not NULL, raw mouse and key input is recorded into it. Read by interrupt handlers.
 };
 
 
@@ -242,8 +285,10 @@ struct EventManager
 /*****************************************************************************/
 
 
-// **** events are pre-created in a fixed size array on system startup (circular buffer)
+// **** events are pre-created in fixed size arrays on system startup (circular buffers)
 // **** as interrupts need to add more events, they take the next slot available in the array
+// **** each ring has a single producer and a single consumer, so neither side ever has to turn interrupts off:
+// ****   interrupt handlers write mouse events to one ring, the main loop posts window and menu events to the other, and only EventManager_NextEvent() reads them
 
 // **** CONSTRUCTOR AND DESTRUCTOR *****
 
@@ -271,12 +316,14 @@ bool EventManager_Destroy(EventManager** the_event_manager);
 // **** Queue Management functions *****
 
 
-//! Nulls out any events associated with the window pointer passed
+//! Nulls out any events associated with the window pointer passed, and stops its timers
 //! Call this when a window has been closed, to ensure that there are not future events that will try to recall the window after it is destroyed
 void EventManager_RemoveEventsForWindow(Window* the_window);
 
 //! Checks to see if there is an event in the queue
-//! returns NULL if no event (not the same as returning an event of type nullEvent)
+//! Posted (window and menu) events are returned before mouse events: they were caused by events already handled
+//! returns NULL if no event. nullEvents (events removed from the queue) are skipped.
+//! The event returned is a copy owned by the event manager, good until the next call.
 EventRecord* EventManager_NextEvent(void);
 
 //! Add a new mouse event to the event queue
@@ -284,12 +331,34 @@ EventRecord* EventManager_NextEvent(void);
 //!   It overwrites whatever slot is next in line
 //! This is designed to be called from mouse IRQ, with minimimal information available
 //! @param	the_what -- specifies the type of event to add to the queue. only mouseDown/up/moved events supported
-//! The function will query VICKY for x,y and determine if the mouse is over a window, a control, etc. 
+//! The function will query VICKY for x,y. It records only the position and button: which window or control the mouse is over is worked out when the event is handled. 
 void EventManager_AddMouseEvent(event_kind the_what);
 
+//! Add a new mouse event for a known position to the event queue
+//! An event that neither the system nor any window wants is not queued: mouseMoved is only queued while a window subscribes to it, 
+//!   a mouse button is down, or the system is tracking the mouse (dragging, resizing, pressing a control, or showing a menu)
+//! A mouseMoved is merged into the newest unread event if that is also a mouseMoved: only the latest position is kept.
+//! If the queue is full, the overflow policy decides what is lost. Safe to call from an interrupt handler.
+//! @param	the_what -- specifies the type of event to add to the queue. only mouseDown/up/moved events supported
+//! @param	x -- Global horizontal position of the mouse
+//! @param	y -- Global vertical position of the mouse
+//! @param	the_window -- the window the mouse is over, if known. May be NULL: mouse events from the interrupt are hit-tested when they are handled.
+void EventManager_AddMouseEventAt(event_kind the_what, int16_t x, int16_t y, Window* the_window);
+
+//! Add a new key event to the event queue
+//! Keys are read from the keyboard channel by the main loop, so key events are posted, like window events, rather than added by an interrupt
+//! The event is not queued if the window does not subscribe to it
+//! @param	the_what -- keyDown, keyUp, or autoKey
+//! @param	the_key -- the key code of the key pushed. eg, KEY_BKSP (0x92), not CH_BKSP (0x08).
+//! @param	the_char -- the character code resulting from the key, after mapping
+//! @param	the_modifiers -- bit flags for shift, ctrl, meta, etc.
+//! @param	the_window -- the window the key is for. NULL for the active window.
+void EventManager_AddKeyEvent(event_kind the_what, uint8_t the_key, uint8_t the_char, uint8_t the_modifiers, Window* the_window);
+
 //! Add a new window event to the event queue
 //! NOTE: this does not actually insert a new record, as the event queue is a circular buffer
 //!   It overwrites whatever slot is next in line
+//! The event is not queued if the window does not subscribe to it, unless the system acts on it too (see EVENT_SYSTEM_MASK)
 //! @param	the_what -- specifies the type of event to add to the queue. only window events such as windowChanged are supported
 //! @param	x -- Global horizontal coordinate associated with the event. e.g., where the mouse was clicked, etc.
 //! @param	y -- Global vertical coordinate associated with the event
@@ -302,6 +371,7 @@ void EventManager_AddWindowEvent(event_kind the_what, int16_t x, int16_t y, int1
 //! Add a new menu event to the event queue
 //! NOTE: this does not actually insert a new record, as the event queue is a circular buffer
 //!   It overwrites whatever slot is next in line
+//! The event is not queued if the window does not subscribe to it
 //! @param	the_what -- specifies the type of event to add to the queue. only menu events such as menuOpened are supported
 //! @param	menu_selection -- the ID of the specific menu item that was under the mouse at the time of the event. If no menu item is relevant (e.g, for an open menu event no menu was open so no menu item could have been selected, pass -1.
 //! @param	x -- Global horizontal coordinate associated with the event. e.g., where the mouse was clicked, etc.
@@ -310,8 +380,76 @@ void EventManager_AddWindowEvent(event_kind the_what, int16_t x, int16_t y, int1
 void EventManager_AddMenuEvent(event_kind the_what, int16_t menu_selection,int16_t x, int16_t y, Window* the_window);
 
 //! Wait for an event to happen, do system-processing of it, then if appropriate, give the window responsible for the event a chance to do something with it
+//! Each event kind is handed to its handler through a table. A window's event handler is only called for the kinds in its event mask.
+//! If there are no events, waits between interrupts until one arrives or the next timer is due, rather than polling.
 void EventManager_WaitForEvent(void);
 
+//! Do system-processing of an event, then if appropriate, give the window responsible for the event a chance to do something with it
+//! EventManager_WaitForEvent() calls this for each event. Call it directly only from a loop that reads events with EventManager_NextEvent() itself.
+//! @param	the_event -- an event returned by EventManager_NextEvent()
+void EventManager_DispatchEvent(EventRecord* the_event);
+
+//! Add the event kinds in the passed mask to those wanted by windows. Call once for each window that subscribes.
+//! Events of kinds no window subscribes to, and that the system doesn't act on, are thrown away when added, without using a queue slot.
+//! @param	the_mask -- the event_mask bits of the event kinds subscribed to
+void EventManager_Subscribe(uint32_t the_mask);
+
+//! Take back a subscription made with EventManager_Subscribe()
+//! @param	the_mask -- the event_mask bits passed to EventManager_Subscribe()
+void EventManager_Unsubscribe(uint32_t the_mask);
+
+//! Set what happens to a new event when its queue is full
+//! @param	the_policy -- EVENT_OVERFLOW_DROP_OLDEST (the default), EVENT_OVERFLOW_DROP_NEWEST, or EVENT_OVERFLOW_COALESCE
+void EventManager_SetOverflowPolicy(event_overflow_policy the_policy);
+
+//! Get counts of events lost to full queues, and of events merged into other events, since startup
+//! @param	dropped -- receives the number of events thrown away or written over before being read. Can be NULL.
+//! @param	coalesced -- receives the number of events merged into a newer event. Can be NULL.
+void EventManager_GetQueueStats(uint32_t* dropped, uint32_t* coalesced);
+
+//! Get the number of events thrown away when added because nothing was subscribed to them, since startup
+uint32_t EventManager_GetFilteredCount(void);
+
+
+
+// **** Timer functions *****
+
+//! Start a timer that sends a timerEvt to the passed window. If the window already has a timer with this ID, it is restarted.
+//! Timer events go through the window's event mask like any other window event: the window must subscribe to timerEvtMask to get them.
+//! @param	the_window -- the window to send timer events to
+//! @param	the_id -- ID for the timer, passed back in the event's timerinfo_. Each window has its own IDs.
+//! @param	delay -- ticks until the timer first fires (60 per second)
+//! @param	period -- ticks between firings after the first. 0 for a timer that fires once.
+//! @return	Returns false if the timer could not be started
+bool EventManager_StartTimer(Window* the_window, uint16_t the_id, uint32_t delay, uint32_t period);
+
+//! Stop a timer started with EventManager_StartTimer(). Does nothing if there is no such timer.
+//! @param	the_window -- the window the timer was started for
+//! @param	the_id -- ID the timer was started with
+void EventManager_StopTimer(Window* the_window, uint16_t the_id);
+
+//! Post a timerEvt for each timer that is due
+//! EventManager_WaitForEvent() calls this: only call it directly from a loop that doesn't use EventManager_WaitForEvent().
+//! @return	Returns the number of ticks until the next timer could be due, or TIMER_NONE_PENDING if there are no timers
+uint32_t EventManager_RunTimers(void);
+
+//! Replace the clock used to time events and run timers
+//! For tests and replays, where time has to move under the program's control rather than with the jiffy count
+//! @param	the_clock -- function returning the time in ticks. NULL to go back to sys_time_jiffies().
+void EventManager_SetClock(uint32_t (*the_clock)(void));
+
+//! Get the time in ticks, from the event manager's clock
+uint32_t EventManager_GetTicks(void);
+
+
+
+// **** Recording functions *****
+
+//! Start recording raw mouse and key input into the passed log, emptying it first. Recording a log replaces any recording already going on.
+//! Input is recorded as it arrives, before it is filtered or coalesced. See inputlog.h.
+//! @param	the_log -- the log to record into. NULL to stop recording.
+void EventManager_SetRecorder(InputLog* the_log);
+
 
 
 
@@ -0,0 +1,693 @@
+/*
+ * event_test.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: agent
+ */
+
+
+
+
+
+/*****************************************************************************/
+/*                                Includes                                   */
+/*****************************************************************************/
+
+// unit testing framework
+#include "debug.h"
+#include "minunit.h"
+
+// project includes
+#include "sys.h"
+#include "timer.h"
+#include "window.h"
+
+// class being tested
+#include "event.h"
+
+// C includes
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+
+// A2560 includes
+#include "a2560k.h"
+#include <mcp/syscalls.h>
+#include <mcp/interrupt.h>
+
+
+
+/*****************************************************************************/
+/*                               Definitions                                 */
+/*****************************************************************************/
+
+#define EVENT_TEST_STRESS_EVENTS	2000000L	// number of synthetic mouse events pushed through the queue in the stress test
+#define EVENT_TEST_MAX_MOVE_BURST	40			// most mouse moves added in a row, between button events, in the stress test
+#define EVENT_TEST_MAX_BUTTONS_UNREAD	(EVENT_QUEUE_SIZE / 4)	// in the lossless stress test, the queue is read before this many button events (each with a move before it) are waiting
+
+
+/*****************************************************************************/
+/*                               Enumerations                                */
+/*****************************************************************************/
+
+
+
+/*****************************************************************************/
+/*                             Global Variables                              */
+/*****************************************************************************/
+
+System*			global_system;
+
+// LOGIC: the queue keeps its counts since startup. each test compares against the counts at the start of the test.
+static uint32_t		test_start_dropped;
+static uint32_t		test_start_coalesced;
+
+static uint32_t		test_random_seed;
+
+static Window		test_window;	// only its address and event mask are used, to tag events
+
+static uint32_t		test_ticks;		// stand-in clock for the timer test
+
+
+/*****************************************************************************/
+/*                       Private Function Prototypes                         */
+/*****************************************************************************/
+
+// get the number of events dropped and coalesced since the test started
+void Test_GetStats(uint32_t* dropped, uint32_t* coalesced);
+
+// simple repeatable pseudo-random numbers, so a failing run can be repeated
+uint32_t Test_Random(uint32_t the_range);
+
+// run the stress test under the passed overflow policy. returns the number of problems found.
+uint32_t Test_StressQueue(event_overflow_policy the_policy, bool keep_up);
+
+// stand-in clock: time only moves when the test says so
+uint32_t Test_GetTicks(void);
+
+
+/*****************************************************************************/
+/*                       Private Function Definitions                        */
+/*****************************************************************************/
+
+// get the number of events dropped and coalesced since the test started
+void Test_GetStats(uint32_t* dropped, uint32_t* coalesced)
+{
+	EventManager_GetQueueStats(dropped, coalesced);
+	*dropped -= test_start_dropped;
+	*coalesced -= test_start_coalesced;
+}
+
+
+// simple repeatable pseudo-random numbers, so a failing run can be repeated
+uint32_t Test_Random(uint32_t the_range)
+{
+	test_random_seed = test_random_seed * 1103515245L + 12345;
+
+	return (test_random_seed >> 16) % the_range;
+}
+
+
+// stand-in clock: time only moves when the test says so
+uint32_t Test_GetTicks(void)
+{
+	return test_ticks;
+}
+
+
+// run the stress test under the passed overflow policy. returns the number of problems found.
+uint32_t Test_StressQueue(event_overflow_policy the_policy, bool keep_up)
+{
+	EventRecord*	the_event;
+	uint32_t		num_added = 0;
+	uint32_t		num_read = 0;
+	uint32_t		num_buttons_added = 0;
+	uint32_t		num_buttons_read = 0;
+	uint32_t		num_buttons_unread = 0;
+	uint32_t		num_problems = 0;
+	uint32_t		dropped;
+	uint32_t		coalesced;
+	uint32_t		burst;
+	int16_t			x = 0;
+	int16_t			y = 0;
+	int16_t			read_x = -1;
+	int16_t			read_y = -1;
+	bool			button_down = false;
+	bool			read_button_down = false;
+
+	// LOGIC:
+	//   the mouse interrupt is played by bursts of moves, each followed by a button going down or up.
+	//   the main loop is played by reads of a random number of events, at random times.
+	//   if keep_up is true, the reader never lets the queue fill with button events, so no button transition may be lost, whatever the policy.
+	//     moves in between may be merged, but the last position read must be the last position added.
+	//   otherwise, the reader falls behind: it reads fewer events than are added, but more than the button events alone.
+	//     moves are lost, but never a button transition, and every event added must be accounted for: read, dropped, or coalesced.
+
+	EventManager_SetOverflowPolicy(the_policy);
+	EventManager_GetQueueStats(&test_start_dropped, &test_start_coalesced);
+	test_random_seed = 2560;
+
+	while (num_added < EVENT_TEST_STRESS_EVENTS)
+	{
+		for (burst = Test_Random(EVENT_TEST_MAX_MOVE_BURST); burst > 0; burst--)
+		{
+			x = (int16_t)Test_Random(1024);
+			y = (int16_t)Test_Random(768);
+			EventManager_AddMouseEventAt(mouseMoved, x, y, NULL);
+			num_added++;
+		}
+
+		button_down = !button_down;
+		EventManager_AddMouseEventAt(button_down ? mouseDown : mouseUp, x, y, NULL);
+		num_added++;
+		num_buttons_added++;
+		num_buttons_unread++;
+
+		if (Test_Random(2) == 0 || (keep_up && num_buttons_unread >= EVENT_TEST_MAX_BUTTONS_UNREAD))
+		{
+			for (burst = (keep_up ? EVENT_QUEUE_SIZE : Test_Random(8)); burst > 0; burst--)
+			{
+				if ( (the_event = EventManager_NextEvent()) == NULL)
+				{
+					break;
+				}
+
+				num_read++;
+
+				if (the_event->what_ == mouseDown || the_event->what_ == mouseUp)
+				{
+					// button transitions must alternate: a lost one would show up as two downs or two ups in a row
+					if ((the_event->what_ == mouseDown) == read_button_down)
+					{
+						num_problems++;
+					}
+
+					read_button_down = (the_event->what_ == mouseDown);
+					num_buttons_read++;
+				}
+
+				read_x = the_event->mouseinfo_.x_;
+				read_y = the_event->mouseinfo_.y_;
+			}
+
+			num_buttons_unread = 0;
+		}
+	}
+
+	// read whatever is left. the last event read is the last button added, at the last position added.
+	while ( (the_event = EventManager_NextEvent()) != NULL)
+	{
+		num_read++;
+
+		if (the_event->what_ == mouseDown || the_event->what_ == mouseUp)
+		{
+			if ((the_event->what_ == mouseDown) == read_button_down)
+			{
+				num_problems++;
+			}
+
+			read_button_down = (the_event->what_ == mouseDown);
+			num_buttons_read++;
+		}
+
+		read_x = the_event->mouseinfo_.x_;
+		read_y = the_event->mouseinfo_.y_;
+	}
+
+	Test_GetStats(&dropped, &coalesced);
+
+	// every event is accounted for
+	if (num_read + dropped + coalesced != num_added)
+	{
+		printf("policy %i: %lu added, but %lu read + %lu dropped + %lu coalesced \n", the_policy, (unsigned long)num_added, (unsigned long)num_read, (unsigned long)dropped, (unsigned long)coalesced);
+		num_problems++;
+	}
+
+	// whether or not the reader keeps up, only moves may be lost
+	if (num_buttons_read != num_buttons_added || read_button_down != button_down)
+	{
+		printf("policy %i: %lu button events added, %lu read \n", the_policy, (unsigned long)num_buttons_added, (unsigned long)num_buttons_read);
+		num_problems++;
+	}
+	
+	if (keep_up)
+	{
+		if (dropped != 0)
+		{
+			printf("policy %i: %lu events dropped \n", the_policy, (unsigned long)dropped);
+			num_problems++;
+		}
+
+		if (read_x != x || read_y != y)
+		{
+			printf("policy %i: last position read was %i, %i, not %i, %i \n", the_policy, read_x, read_y, x, y);
+			num_problems++;
+		}
+
+		// with moves merged, far fewer events need to be read than were added
+		if (coalesced == 0 || num_read >= num_added / 2)
+		{
+			printf("policy %i: only %lu of %lu events coalesced \n", the_policy, (unsigned long)coalesced, (unsigned long)num_added);
+			num_problems++;
+		}
+	}
+	else if (dropped == 0)
+	{
+		printf("policy %i: reader never fell behind \n", the_policy);
+		num_problems++;
+	}
+
+	return num_problems;
+}
+
+
+
+
+/*****************************************************************************/
+/*                        MinUnit Function Defintions                        */
+/*****************************************************************************/
+
+
+
+void test_setup(void)	// this is called EVERY test
+{
+	// start each test with an empty queue and the default policy
+	while (EventManager_NextEvent() != NULL)
+	{
+	}
+
+	EventManager_SetOverflowPolicy(EVENT_OVERFLOW_DROP_OLDEST);
+	EventManager_GetQueueStats(&test_start_dropped, &test_start_coalesced);
+}
+
+
+void test_teardown(void)	// this is called EVERY test
+{
+	EventManager_SetOverflowPolicy(EVENT_OVERFLOW_DROP_OLDEST);
+}
+
+
+
+// **** unit tests
+
+MU_TEST(event_move_coalesce_test)
+{
+	EventRecord*	the_event;
+	uint32_t		dropped;
+	uint32_t		coalesced;
+	int16_t			i;
+
+	mu_check( EventManager_NextEvent() == NULL );
+
+	// a run of moves is read as one move, to the last position
+	for (i = 0; i < 10; i++)
+	{
+		EventManager_AddMouseEventAt(mouseMoved, i, i * 2, NULL);
+	}
+
+	the_event = EventManager_NextEvent();
+	mu_assert(the_event != NULL, "no event queued");
+	mu_assert_int_eq(mouseMoved, the_event->what_);
+	mu_assert_int_eq(9, the_event->mouseinfo_.x_);
+	mu_assert_int_eq(18, the_event->mouseinfo_.y_);
+	mu_check( EventManager_NextEvent() == NULL );
+
+	// moves on either side of a click are not merged across it
+	EventManager_AddMouseEventAt(mouseMoved, 1, 1, NULL);
+	EventManager_AddMouseEventAt(mouseMoved, 2, 2, NULL);
+	EventManager_AddMouseEventAt(mouseDown, 2, 2, NULL);
+	EventManager_AddMouseEventAt(mouseMoved, 3, 3, NULL);
+	EventManager_AddMouseEventAt(mouseMoved, 4, 4, NULL);
+
+	mu_assert_int_eq(mouseMoved, EventManager_NextEvent()->what_);
+	mu_assert_int_eq(mouseDown, EventManager_NextEvent()->what_);
+	the_event = EventManager_NextEvent();
+	mu_assert_int_eq(mouseMoved, the_event->what_);
+	mu_assert_int_eq(4, the_event->mouseinfo_.x_);
+	mu_check( EventManager_NextEvent() == NULL );
+
+	// a move already being handled is not changed by a new one
+	EventManager_AddMouseEventAt(mouseMoved, 5, 5, NULL);
+	the_event = EventManager_NextEvent();
+	EventManager_AddMouseEventAt(mouseMoved, 6, 6, NULL);
+	mu_assert_int_eq(5, the_event->mouseinfo_.x_);
+	mu_assert_int_eq(6, EventManager_NextEvent()->mouseinfo_.x_);
+
+	Test_GetStats(&dropped, &coalesced);
+	mu_assert_int_eq(0, dropped);
+	mu_assert_int_eq(9 + 1 + 1, coalesced);
+}
+
+
+MU_TEST(event_drop_oldest_test)
+{
+	EventRecord*	the_event;
+	uint32_t		dropped;
+	uint32_t		coalesced;
+	int16_t			i;
+
+	// with the default policy, the newest EVENT_QUEUE_SIZE events are kept
+	for (i = 0; i < EVENT_QUEUE_SIZE + 10; i++)
+	{
+		EventManager_AddMouseEventAt((i % 2) ? mouseUp : mouseDown, i, 0, NULL);
+	}
+
+	for (i = 10; i < EVENT_QUEUE_SIZE + 10; i++)
+	{
+		the_event = EventManager_NextEvent();
+		mu_assert(the_event != NULL, "queue ran out early");
+		mu_assert_int_eq(i, the_event->mouseinfo_.x_);
+	}
+
+	mu_check( EventManager_NextEvent() == NULL );
+
+	Test_GetStats(&dropped, &coalesced);
+	mu_assert_int_eq(10, dropped);
+	mu_assert_int_eq(0, coalesced);
+}
+
+
+MU_TEST(event_drop_newest_test)
+{
+	EventRecord*	the_event;
+	uint32_t		dropped;
+	uint32_t		coalesced;
+	int16_t			i;
+
+	EventManager_SetOverflowPolicy(EVENT_OVERFLOW_DROP_NEWEST);
+
+	// the queue holds one less than its size: the last slot is kept for an event being read
+	for (i = 0; i < EVENT_QUEUE_SIZE + 10; i++)
+	{
+		EventManager_AddMouseEventAt((i % 2) ? mouseUp : mouseDown, i, 0, NULL);
+	}
+
+	for (i = 0; i < EVENT_QUEUE_SIZE - 1; i++)
+	{
+		the_event = EventManager_NextEvent();
+		mu_assert(the_event != NULL, "queue ran out early");
+		mu_assert_int_eq(i, the_event->mouseinfo_.x_);
+	}
+
+	mu_check( EventManager_NextEvent() == NULL );
+
+	Test_GetStats(&dropped, &coalesced);
+	mu_assert_int_eq(11, dropped);
+	mu_assert_int_eq(0, coalesced);
+}
+
+
+MU_TEST(event_evict_move_test)
+{
+	uint32_t		dropped;
+	uint32_t		coalesced;
+	int16_t			i;
+
+	EventManager_SetOverflowPolicy(EVENT_OVERFLOW_DROP_NEWEST);
+
+	// fill the queue with clicks, and one move near the front
+	EventManager_AddMouseEventAt(mouseDown, 0, 0, NULL);
+	EventManager_AddMouseEventAt(mouseMoved, 1000, 0, NULL);
+
+	for (i = 1; i < EVENT_QUEUE_SIZE - 2; i++)
+	{
+		EventManager_AddMouseEventAt((i % 2) ? mouseUp : mouseDown, i, 0, NULL);
+	}
+
+	// a click pushes the move out, even though the policy drops new events. a new move is still dropped.
+	EventManager_AddMouseEventAt(mouseUp, 2000, 0, NULL);
+	EventManager_AddMouseEventAt(mouseMoved, 3000, 0, NULL);
+
+	for (i = 0; i < EVENT_QUEUE_SIZE - 2; i++)
+	{
+		mu_assert_int_eq(i, EventManager_NextEvent()->mouseinfo_.x_);
+	}
+
+	mu_assert_int_eq(2000, EventManager_NextEvent()->mouseinfo_.x_);
+	mu_check( EventManager_NextEvent() == NULL );
+
+	Test_GetStats(&dropped, &coalesced);
+	mu_assert_int_eq(2, dropped);
+	mu_assert_int_eq(0, coalesced);
+}
+
+
+MU_TEST(event_coalesce_policy_test)
+{
+	EventRecord*	the_event;
+	uint32_t		dropped;
+	uint32_t		coalesced;
+	int16_t			i;
+
+	EventManager_SetOverflowPolicy(EVENT_OVERFLOW_COALESCE);
+
+	// fill the queue, with a move last
+	for (i = 0; i < EVENT_QUEUE_SIZE - 2; i++)
+	{
+		EventManager_AddMouseEventAt((i % 2) ? mouseUp : mouseDown, i, 0, NULL);
+	}
+
+	EventManager_AddMouseEventAt(mouseMoved, 500, 0, NULL);
+
+	// a click takes the place of the move; after that, there's nothing to give up, and new events are dropped
+	EventManager_AddMouseEventAt(mouseDown, 600, 0, NULL);
+	EventManager_AddMouseEventAt(mouseUp, 700, 0, NULL);
+
+	for (i = 0; i < EVENT_QUEUE_SIZE - 2; i++)
+	{
+		mu_assert_int_eq(i, EventManager_NextEvent()->mouseinfo_.x_);
+	}
+
+	the_event = EventManager_NextEvent();
+	mu_assert_int_eq(mouseDown, the_event->what_);
+	mu_assert_int_eq(600, the_event->mouseinfo_.x_);
+	mu_check( EventManager_NextEvent() == NULL );
+
+	Test_GetStats(&dropped, &coalesced);
+	mu_assert_int_eq(1, dropped);
+	mu_assert_int_eq(1, coalesced);
+}
+
+
+MU_TEST(event_posted_test)
+{
+	EventRecord*	the_event;
+
+	// window events come out before mouse events queued ahead of them: they were caused by events already handled
+	EventManager_AddMouseEventAt(mouseDown, 10, 10, &test_window);
+	EventManager_AddWindowEvent(windowChanged, 1, 2, 30, 40, &test_window, NULL);
+	EventManager_AddMenuEvent(menuSelected, 7, 10, 10, &test_window);
+
+	the_event = EventManager_NextEvent();
+	mu_assert_int_eq(windowChanged, the_event->what_);
+	mu_assert_int_eq(30, the_event->windowinfo_.width_);
+	mu_check( the_event->window_ == &test_window );
+	mu_assert_int_eq(menuSelected, EventManager_NextEvent()->what_);
+	mu_assert_int_eq(mouseDown, EventManager_NextEvent()->what_);
+	mu_check( EventManager_NextEvent() == NULL );
+
+	// events for a closed window are skipped
+	EventManager_AddMouseEventAt(mouseDown, 10, 10, &test_window);
+	EventManager_AddMouseEventAt(mouseUp, 20, 20, NULL);
+	EventManager_AddWindowEvent(windowChanged, 1, 2, 30, 40, &test_window, NULL);
+	EventManager_RemoveEventsForWindow(&test_window);
+
+	the_event = EventManager_NextEvent();
+	mu_assert(the_event != NULL, "event for another window was removed");
+	mu_assert_int_eq(mouseUp, the_event->what_);
+	mu_check( EventManager_NextEvent() == NULL );
+}
+
+
+MU_TEST(event_mask_test)
+{
+	EventRecord*	the_event;
+	uint32_t		start_filtered;
+
+	start_filtered = EventManager_GetFilteredCount();
+
+	// with no window following the mouse, and no button down, moves are thrown away before they reach the queue
+	EventManager_Unsubscribe(mouseMovedMask);
+	EventManager_AddMouseEventAt(mouseMoved, 1, 1, NULL);
+	mu_check( EventManager_NextEvent() == NULL );
+	mu_assert_int_eq(1, EventManager_GetFilteredCount() - start_filtered);
+
+	// while a button is down, the system follows the mouse itself. the buttons are tracked even when their events are dropped.
+	EventManager_AddMouseEventAt(mouseDown, 2, 2, NULL);
+	EventManager_AddMouseEventAt(mouseMoved, 3, 3, NULL);
+	EventManager_AddMouseEventAt(mouseUp, 4, 4, NULL);
+	EventManager_AddMouseEventAt(mouseMoved, 5, 5, NULL);
+	mu_assert_int_eq(mouseDown, EventManager_NextEvent()->what_);
+	mu_assert_int_eq(mouseMoved, EventManager_NextEvent()->what_);
+	mu_assert_int_eq(mouseUp, EventManager_NextEvent()->what_);
+	mu_check( EventManager_NextEvent() == NULL );
+	mu_assert_int_eq(2, EventManager_GetFilteredCount() - start_filtered);
+
+	// nothing acts on the middle button, so neither of its events is queued
+	EventManager_AddMouseEventAt(mMouseDown, 6, 6, NULL);
+	EventManager_AddMouseEventAt(mMouseUp, 6, 6, NULL);
+	mu_check( EventManager_NextEvent() == NULL );
+	mu_assert_int_eq(4, EventManager_GetFilteredCount() - start_filtered);
+
+	// a subscription is counted: moves are wanted until every subscriber has gone
+	EventManager_Subscribe(mouseMovedMask);
+	EventManager_Subscribe(mouseMovedMask);
+	EventManager_Unsubscribe(mouseMovedMask);
+	EventManager_AddMouseEventAt(mouseMoved, 7, 7, NULL);
+	the_event = EventManager_NextEvent();
+	mu_assert(the_event != NULL, "move dropped while a window still subscribes");
+	mu_assert_int_eq(7, the_event->mouseinfo_.x_);
+	mu_assert_int_eq(4, EventManager_GetFilteredCount() - start_filtered);
+
+	// window events only go in the queue if the window wants them, or the system acts on them too
+	test_window.event_mask_ = everyEvent & ~windowChangedMask & ~inactivateEvtMask;
+	EventManager_AddWindowEvent(windowChanged, 1, 2, 30, 40, &test_window, NULL);
+	EventManager_AddWindowEvent(inactivateEvt, -1, -1, 0, 0, &test_window, NULL);
+	EventManager_AddWindowEvent(activateEvt, -1, -1, 0, 0, &test_window, NULL);
+	EventManager_AddWindowEvent(activateEvt, -1, -1, 0, 0, NULL, NULL);
+	mu_assert_int_eq(inactivateEvt, EventManager_NextEvent()->what_);
+	mu_assert_int_eq(activateEvt, EventManager_NextEvent()->what_);
+	mu_check( EventManager_NextEvent() == NULL );
+	mu_assert_int_eq(6, EventManager_GetFilteredCount() - start_filtered);
+
+	test_window.event_mask_ = everyEvent;
+}
+
+
+MU_TEST(event_timer_test)
+{
+	EventRecord*	the_event;
+	uint32_t		start_filtered;
+
+	test_ticks = 100;
+	EventManager_SetClock(&Test_GetTicks);
+	start_filtered = EventManager_GetFilteredCount();
+
+	mu_assert_int_eq(TIMER_NONE_PENDING, EventManager_RunTimers());
+	mu_check( EventManager_StartTimer(&test_window, 5, 10, 20) == true );
+
+	// not due yet: nothing is posted, and the loop is told how long it can sleep
+	test_ticks = 109;
+	mu_assert_int_eq(1, EventManager_RunTimers());
+	mu_check( EventManager_NextEvent() == NULL );
+
+	test_ticks = 110;
+	mu_assert_int_eq(20, EventManager_RunTimers());
+	the_event = EventManager_NextEvent();
+	mu_assert(the_event != NULL, "timer event not posted");
+	mu_assert_int_eq(timerEvt, the_event->what_);
+	mu_check( the_event->window_ == &test_window );
+	mu_assert_int_eq(5, the_event->timerinfo_.id_);
+	mu_assert_int_eq(0, the_event->timerinfo_.missed_);
+	mu_assert_int_eq(110, the_event->when_);
+	mu_check( EventManager_NextEvent() == NULL );
+
+	// the loop was busy through three periods: one event, saying two were missed
+	test_ticks = 175;
+	EventManager_RunTimers();
+	the_event = EventManager_NextEvent();
+	mu_assert(the_event != NULL, "late timer event not posted");
+	mu_assert_int_eq(2, the_event->timerinfo_.missed_);
+	mu_check( EventManager_NextEvent() == NULL );
+
+	// timer events go through the window's event mask like any other
+	test_window.event_mask_ = everyEvent & ~timerEvtMask;
+	test_ticks = 190;
+	EventManager_RunTimers();
+	mu_check( EventManager_NextEvent() == NULL );
+	mu_assert_int_eq(1, EventManager_GetFilteredCount() - start_filtered);
+	test_window.event_mask_ = everyEvent;
+
+	// a window's timers go with its events when it closes
+	EventManager_RemoveEventsForWindow(&test_window);
+	mu_assert_int_eq(TIMER_NONE_PENDING, EventManager_RunTimers());
+
+	EventManager_SetClock(NULL);
+}
+
+
+MU_TEST(event_stress_test)
+{
+	// whatever the policy, a reader that keeps up loses no clicks
+	mu_assert_int_eq(0, Test_StressQueue(EVENT_OVERFLOW_DROP_OLDEST, true));
+	mu_assert_int_eq(0, Test_StressQueue(EVENT_OVERFLOW_DROP_NEWEST, true));
+	mu_assert_int_eq(0, Test_StressQueue(EVENT_OVERFLOW_COALESCE, true));
+
+	// a reader that falls behind loses events, but they are all counted
+	mu_assert_int_eq(0, Test_StressQueue(EVENT_OVERFLOW_DROP_OLDEST, false));
+	mu_assert_int_eq(0, Test_StressQueue(EVENT_OVERFLOW_DROP_NEWEST, false));
+	mu_assert_int_eq(0, Test_StressQueue(EVENT_OVERFLOW_COALESCE, false));
+}
+
+
+
+// unit tests
+MU_TEST_SUITE(test_suite_units)
+{
+	MU_SUITE_CONFIGURE(&test_setup, &test_teardown);
+
+	MU_RUN_TEST(event_move_coalesce_test);
+	MU_RUN_TEST(event_drop_oldest_test);
+	MU_RUN_TEST(event_drop_newest_test);
+	MU_RUN_TEST(event_evict_move_test);
+	MU_RUN_TEST(event_coalesce_policy_test);
+	MU_RUN_TEST(event_posted_test);
+	MU_RUN_TEST(event_mask_test);
+	MU_RUN_TEST(event_timer_test);
+}
+
+
+// speed tests
+MU_TEST_SUITE(test_suite_speed)
+{
+	MU_SUITE_CONFIGURE(&test_setup, &test_teardown);
+
+	MU_RUN_TEST(event_stress_test);
+}
+
+
+
+
+
+/*****************************************************************************/
+/*                        Public Function Definitions                        */
+/*****************************************************************************/
+
+
+
+int main(int argc, char* argv[])
+{
+	printf("**** event.c Test Suite **** \n");
+
+	// allocate the system object
+	if ((global_system = Sys_New()) == NULL)
+	{
+		printf("Couldn't instantiate system object \n");
+		sys_exit(-1);
+	}
+
+	if (Sys_InitSystem(global_system) == false)
+	{
+		DEBUG_OUT(("%s %d: Couldn't initialize the system", __func__, __LINE__));
+		Sys_Exit(&global_system, PARAM_EXIT_ON_ERROR);
+	}
+
+	// the tests play the part of the mouse interrupt: keep the real one out of the counts
+	sys_int_disable(INT_MOUSE);
+
+	// ... and of a window that follows the mouse, so moves are queued whether or not a button is down
+	test_window.event_mask_ = everyEvent;
+	EventManager_Subscribe(mouseMovedMask);
+
+	MU_RUN_SUITE(test_suite_units);
+	MU_RUN_SUITE(test_suite_speed);
+	MU_REPORT();
+
+	printf("event test complete \n");
+
+	Sys_Exit(&global_system, PARAM_EXIT_NO_ERROR);
+
+	return MU_EXIT_CODE;
+}
@@ -56,6 +56,9 @@ extern System*			global_system;
 /*                       Private Function Prototypes                         */
 /*****************************************************************************/
 
+//! Get the index into the font's tables for the specified character. Chars not in the font return the index of the "missing glyph".
+uint16_t Font_GetGlyphIndex(Font* the_font, uint8_t the_char);
+
 //! Get the total width, in pixels, for the specified character, including any whitespace
 uint8_t Font_GetCharWidth(Font* the_font, unsigned char the_char);
 
@@ -65,6 +68,30 @@ uint8_t Font_GetRowHeight(Font* the_font);
 //! Get the width of characters, in pixels, for fixed width fonts (all fonts will report one)
 uint8_t Font_GetFixedWidth(Font* the_font);
 
+//! Draw one character by reading its bits directly from the font strike. Used when the glyph cache is disabled or a glyph could not be cached.
+int16_t Font_DrawCharUncached(Bitmap* the_bitmap, uint8_t the_char, Font* the_font);
+
+//! Draw a run of pre-expanded glyphs, one bitmap row at a time across all glyphs in the run
+void Font_DrawGlyphRun(Bitmap* the_bitmap, FontGlyph** the_glyphs, int16_t* the_x_positions, int16_t num_glyphs);
+
+//! Get the cached glyph for the char, building it if necessary. Returns NULL if the glyph could not be cached.
+FontGlyph* Font_GetCachedGlyph(Font* the_font, uint8_t the_char);
+
+//! Convert the bits of one glyph in the font strike into run-length spans. Pass NULL for the_spans to only count the bytes required.
+uint32_t Font_ExpandGlyphSpans(Font* the_font, uint16_t loc_offset, int16_t pixel_only_width, uint8_t first_row, uint8_t num_rows, uint8_t* the_spans);
+
+//! Build a cached glyph for the specified character, evicting older glyphs as needed to stay within budget. Returns NULL if the glyph could not be cached.
+FontGlyph* Font_BuildGlyph(Font* the_font, uint8_t the_char);
+
+//! Mark a cached glyph as the most recently used
+void Font_TouchGlyph(Font* the_font, FontGlyph* the_glyph);
+
+//! Remove a glyph from the cache and free it
+void Font_FreeGlyph(Font* the_font, FontGlyph* the_glyph);
+
+//! Free least recently used glyphs until the cache is using no more than the specified number of bytes
+void Font_TrimGlyphCache(Font* the_font, uint32_t max_bytes);
+
 
 /*****************************************************************************/
 /*                       Private Function Definitions                        */
@@ -74,38 +101,581 @@ uint8_t Font_GetFixedWidth(Font* the_font);
 // **** NEVER call these from your own functions. Always use the public interface. You have been warned!
 
 
-//! Get the total width, in pixels, for the specified character, including any whitespace
-uint8_t Font_GetCharWidth(Font* the_font, unsigned char the_char)
+//! Get the index into the font's tables for the specified character. Chars not in the font return the index of the "missing glyph".
+uint16_t Font_GetGlyphIndex(Font* the_font, uint8_t the_char)
+{
+	// LOGIC:
+	//   The "missing glyph" is stored one past the last real char in the font. 
+	//   It's used for chars the offset/width table marks as -1, and for chars past lastChar, which have no table entries at all.
+	//   Index is 16 bit: for a font with lastChar of 255, the missing glyph is at 256.
+	
+	if (the_char > the_font->lastChar || (int16_t)the_font->width_table_[the_char] == -1)
+	{
+		return (uint16_t)the_font->lastChar + 1;
+	}
+	
+	return the_char;
+}
+
+
+//! Get the total width, in pixels, for the specified character, including any whitespace
+uint8_t Font_GetCharWidth(Font* the_font, unsigned char the_char)
+{
+	int8_t			width_value;			//!< the total width of the character including any whitespace to left/right
+
+	width_value = the_font->width_table_[Font_GetGlyphIndex(the_font, the_char)] & 0xFF;
+	
+	return width_value;
+}
+
+
+//! Get the total height, in pixels, of one line of text, including any leading
+uint8_t Font_GetRowHeight(Font* the_font)
+{
+	return (uint8_t)(the_font->leading + the_font->fRectHeight);
+}
+
+//! Get the width of characters, in pixels, for fixed width fonts (all fonts will report one)
+uint8_t Font_GetFixedWidth(Font* the_font)
+{
+	return (uint8_t)(the_font->leading + the_font->widMax);
+}
+
+
+//! Draw one character by reading its bits directly from the font strike. Used when the glyph cache is disabled or a glyph could not be cached.
+int16_t Font_DrawCharUncached(Bitmap* the_bitmap, uint8_t the_char, Font* the_font)
+{
+	int32_t			row;
+	int32_t			pixels_moved;
+	uint16_t		glyph_index;
+	uint16_t		next_glyph_index;
+	int16_t			loc_offset;
+	int16_t			next_loc_offset;
+	int16_t			pixel_only_width;		// the width of the character's actual pixels at max width
+	int16_t			image_offset_index;
+	int16_t			image_offset_index_rem;
+	int16_t			offset_width_value;
+	uint16_t*		start_read_addr;
+	int8_t			h_offset_value;			// the horizontal offset from pen position before the first pixel should be drawn
+	int8_t			width_value;			// the total width of the character including any whitespace to left/right
+	uint8_t			the_color;				// shortcut to bitmap->color_
+	uint32_t		start_write_addr_int;
+	uint8_t			first_row;				// if no height table available, this is 0. otherwise it's first row to start drawing.
+	uint8_t			max_row;				// if no height table available, this is height of font rec. otherwise it's 1 past the last vis row
+	uint16_t		v_offset_height;
+	int16_t			first_col;				// bitmap column the glyph's first pixel falls on. Can be negative for a char that kerns left.
+	int16_t			clip_left;				// number of the glyph's pixels that fall left of the bitmap
+	int16_t			clip_right;				// number of the glyph's pixels that fall inside the bitmap's right edge
+	
+	// LOGIC:
+	//   Some Mac fonts have an optional height offset/num rows table. 
+	//   If present, it will contain row of first visible pixel, and count of rows with pixels
+	//   We can use that to reduce reads/write loops and draw faster. 
+	//     Characters that are not in the font (missing/-1 glyphs) will have 0 for height/offset. 
+	//   If no height table present, we read/write through every row in the Font
+	
+	//DEBUG_OUT(("%s %d: the_font->fontType=%u, (the_font->fontType & 0xFF) & 0x01)=%u", __func__, __LINE__, the_font->fontType, (the_font->fontType & 0xFF) & 0x01));
+	
+	glyph_index = Font_GetGlyphIndex(the_font, the_char);
+	
+	if ( ((the_font->fontType & 0xFF) & 0x01) )
+	{		
+
+		v_offset_height = the_font->height_table_[glyph_index];
+		
+		//DEBUG_OUT(("%s %d: v_offset_height=%u", __func__, __LINE__, v_offset_height));
+
+		if (v_offset_height == 0)
+		{
+			// if char is missing, height value seems to get set to 0. Use the one for the "missing glyph" char, which is one past last real char in font
+			v_offset_height = the_font->height_table_[the_font->lastChar + 1];
+		}
+		
+		first_row = v_offset_height >> 8;
+		max_row = first_row + v_offset_height & 0xFF;		
+	}
+	else
+	{
+		first_row = 0;
+		max_row = the_font->fRectHeight;
+		v_offset_height = 0;
+	}
+	
+	//DEBUG_OUT(("%s %d: glyph char=%u, height/offset value=%i, first_row=%i, max_row=%i", __func__, __LINE__, the_char, v_offset_height, first_row, max_row));
+	//DEBUG_OUT(("%s %d: fRectHeight=%x/%i", __func__, __LINE__, the_font->fRectHeight, the_font->fRectHeight));
+	
+	//   the low byte will be the v offset from top of glyph rect (eg, 3, if the first pixel is in the 4th row down)
+	//   the high byte will contain the total rows of visible pixels (eg, 3 for say a comma, but 9 for a capital letter)
+
+	
+	// LOGIC:
+	//   The pixel-only width (max width of character excluding any whitespace to left or right) is determined by subtracting the location offset of the the char to draw, from that of the following character. All the characters are packed in "shoulder to shoulder, so basically you are just comparing start of this char vs start of next char. 
+	
+	next_glyph_index = glyph_index + 1;
+
+	// LOGIC:
+	//   The offset/width table contains -1 if the char does not exist in this font (Font_GetGlyphIndex() has already switched those to the missing glyph)
+	//   If the char does exist:
+	//     the high byte will be the horizontal offset of the first pixel from the pen location, minus kernMax. Add kernMax back to get the real offset (negative for chars that kern left)
+	//     the low byte will contain the total width needed to render the character (including any whitespace to left or right of pixels)
+	
+	offset_width_value = the_font->width_table_[glyph_index];
+
+	h_offset_value = offset_width_value >> 8;
+	width_value = offset_width_value & 0xFF;
+	
+	loc_offset = the_font->loc_table_[glyph_index];
+	next_loc_offset = the_font->loc_table_[next_glyph_index];
+	pixel_only_width = next_loc_offset - loc_offset;
+	//DEBUG_OUT(("%s %d: loc_offset=%i, next_loc_offset=%i, pixel_only_width=%i", __func__, __LINE__, loc_offset, next_loc_offset, pixel_only_width));
+	//DEBUG_OUT(("%s %d: Wid/offset=%x, width_value=%x, h_offset_value=%x", __func__, __LINE__, offset_width_value, width_value, h_offset_value));
+	
+	// MB 2022: the following debug line, if not included in Calypsi 68k builds, has the effect of having width_value=0, which causes x to not advance after drawing this glyph
+
+	//DEBUG_OUT(("%s %d: pxwidth=%i, Wid/offset=%i, width_value=%i, h_offset_value=%i", __func__, __LINE__, pixel_only_width, offset_width_value, width_value, h_offset_value));
+	
+	// for A in Chicago, I get "227". this is apparently the BIT offset from the start of the image data table. 
+	// so 227/16=14.1875=image_table_[13] + 3 bits. 
+	
+	image_offset_index = loc_offset / 16;		// word # within the bitmap table to start reading. 
+	image_offset_index_rem = loc_offset % 16;	// # of bits within the first word until the bits for this glyph start
+	//DEBUG_OUT(("%s %d: loc_offset=%x, image_offset_index=%i, image_offset_index_rem=%i", __func__, __LINE__, loc_offset, image_offset_index, image_offset_index_rem));
+
+	the_color = Bitmap_GetColor(the_bitmap);
+	
+	start_read_addr = the_font->image_table_ + image_offset_index;
+	
+	start_write_addr_int = Bitmap_GetMemLocInt(the_bitmap);
+	//DEBUG_OUT(("%s %d: start_write_addr_int=%p, start_read=%p", __func__, __LINE__, start_write_addr_int, start_read_addr));
+
+	// LOGIC:
+	//   A negative kernMax or h offset can put the first pixels left of column 0, and a char near the right edge can run past it.
+	//   Clip the glyph's columns to the bitmap the same way Font_DrawGlyphRun() does: bits outside it are still read, but not written.
+	//   Rows above or below the bitmap are skipped.
+	
+	first_col = the_bitmap->x_ + h_offset_value + the_font->kernMax;
+	clip_left = (first_col < 0) ? -first_col : 0;
+	clip_right = the_bitmap->width_ - first_col;
+	
+	if (clip_right > pixel_only_width)
+	{
+		clip_right = pixel_only_width;
+	}
+
+	for (row = 0; row < the_font->fRectHeight; row++)
+	{
+		uint16_t*		read_addr;
+		uint32_t		write_addr_int;
+		
+		read_addr = start_read_addr;
+		write_addr_int = start_write_addr_int;
+		
+		// LOGIC: 
+		//   we have one or more 16 bit words to parse
+		//   each bit in the word represents one horizontal pixel on or off
+		//   a glyph may start on one word, and end on the next
+		//   of the 16 bits, we likely only need a subset: 
+		//     the bits from image_offset_index_rem to image_offset_index_rem +  pixel_only_width
+		
+		if (row >= first_row && row < max_row && clip_right > clip_left && the_bitmap->y_ + row >= 0 && the_bitmap->y_ + row < the_bitmap->height_)
+		{
+			int16_t	pixels_written = 0;
+
+			// for each row, account for any H offset specified for the glyph, and the font's max kern
+			write_addr_int += h_offset_value + the_font->kernMax;
+			
+			pixels_moved = 0;
+			
+			do
+			{
+				int16_t		i;
+				uint16_t	the_word;
+				bool		this_bit;
+				
+				the_word = *read_addr;
+				
+				for (i = 15; i >= 0 && pixels_written < pixel_only_width; i--)
+				{
+					this_bit = (bool)((the_word >> i) & 0x01);
+					
+					//DEBUG_OUT(("wd=%x, i=%i, row=%i, bit=%i px written=%u px moved=%u", the_word, i, row, this_bit, pixels_written, pixels_moved));
+					
+					if ( (pixels_moved >= image_offset_index_rem) )
+					{
+						if (this_bit && pixels_written >= clip_left && pixels_written < clip_right)
+						{
+							*(uint8_t*)write_addr_int = the_color;
+						}
+						
+						//DEBUG_OUT(("read_addr=%p, wd=%x, bit=%u, i=%i, row=%i", read_addr, *read_addr, this_bit, i, row));
+					
+						write_addr_int++;
+						pixels_written++;
+					}
+					
+					pixels_moved++;
+				}
+			
+				read_addr++; // move to next word in the font data
+				
+			} while (pixels_written < pixel_only_width);
+		}		
+		
+		// move read pointer in font to next row; move write pointer in bitmap to next row
+		start_read_addr += the_font->rowWords;
+		start_write_addr_int += (uint32_t)the_bitmap->width_;
+	}
+	
+	// finished writing visible pixels, but need to move pen further right if char's overall width was greater than amount moved so far
+// 	DEBUG_OUT(("%s %d: before: pixels_moved=%i, width_value=%i", __func__, __LINE__, pixels_moved, width_value));
+	//pixels_moved += width_value - pixels_moved;
+	pixels_moved = width_value;
+// 	DEBUG_OUT(("%s %d: after: pixels_moved=%i", __func__, __LINE__, pixels_moved));
+	
+	//DEBUG_OUT(("%s %d: before: pixels_moved=%i, the_bitmap->x_=%i", __func__, __LINE__, pixels_moved, the_bitmap->x_));
+// 	int16_t	temp = the_bitmap->x_;
+	the_bitmap->x_ += pixels_moved;
+	//DEBUG_OUT(("%s %d: after: the_bitmap->x_=%i", __func__, __LINE__, the_bitmap->x_));
+// 	the_bitmap->x_ = temp;
+// 	the_bitmap->x_ += (int16_t)pixels_moved;
+// 	DEBUG_OUT(("%s %d: after cast: the_bitmap->x_=%i", __func__, __LINE__, the_bitmap->x_));
+	
+	return pixels_moved;
+}
+
+
+//! Draw a run of pre-expanded glyphs, one bitmap row at a time across all glyphs in the run
+void Font_DrawGlyphRun(Bitmap* the_bitmap, FontGlyph** the_glyphs, int16_t* the_x_positions, int16_t num_glyphs)
+{
+	uint8_t*		the_spans[FONT_GLYPH_RUN_MAX];	// read position within each glyph's span data
+	uint8_t			the_color;
+	uint8_t			row;
+	uint8_t			max_row = 0;
+	int16_t			i;
+	int16_t			y;
+	uint32_t		row_addr_int;
+	
+	// LOGIC:
+	//   Every glyph's spans are stored row by row, so keeping one read pointer per glyph lets us walk all of them in step.
+	//   For each row of the font rect, write that row for every glyph in the run before moving down. 
+	//   Runs are clipped to the bitmap, as a left kern or a long string can put pixels outside it.
+	
+	for (i = 0; i < num_glyphs; i++)
+	{
+		the_spans[i] = the_glyphs[i]->spans_;
+		
+		if (the_glyphs[i]->first_row_ + the_glyphs[i]->num_rows_ > max_row)
+		{
+			max_row = the_glyphs[i]->first_row_ + the_glyphs[i]->num_rows_;
+		}
+	}
+	
+	the_color = Bitmap_GetColor(the_bitmap);
+	y = the_bitmap->y_;
+	row_addr_int = the_bitmap->addr_int_ + (uint32_t)y * (uint32_t)the_bitmap->width_;
+	
+	for (row = 0; row < max_row; row++, y++, row_addr_int += (uint32_t)the_bitmap->width_)
+	{
+		for (i = 0; i < num_glyphs; i++)
+		{
+			FontGlyph*	the_glyph = the_glyphs[i];
+			uint8_t		num_runs;
+			
+			if (row < the_glyph->first_row_ || row >= the_glyph->first_row_ + the_glyph->num_rows_)
+			{
+				continue;
+			}
+			
+			num_runs = *the_spans[i]++;
+			
+			if (y < 0 || y >= the_bitmap->height_)
+			{
+				// still need to step past this row's spans
+				the_spans[i] += num_runs * 2;
+				continue;
+			}
+			
+			while (num_runs--)
+			{
+				int16_t		x1;
+				int16_t		x2;
+				
+				x1 = the_x_positions[i] + *the_spans[i]++;
+				x2 = x1 + *the_spans[i]++;
+				
+				if (x1 < 0)
+				{
+					x1 = 0;
+				}
+				
+				if (x2 > the_bitmap->width_)
+				{
+					x2 = the_bitmap->width_;
+				}
+				
+				if (x2 > x1)
+				{
+					memset((uint8_t*)(row_addr_int + x1), the_color, x2 - x1);
+				}
+			}
+		}
+	}
+}
+
+
+//! Get the cached glyph for the char, building it if necessary. Returns NULL if the glyph could not be cached.
+FontGlyph* Font_GetCachedGlyph(Font* the_font, uint8_t the_char)
+{
+	FontGlyph*		the_glyph;
+	
+	if ( (the_glyph = the_font->glyph_cache_[the_char]) != NULL)
+	{
+		Font_TouchGlyph(the_font, the_glyph);
+		return the_glyph;
+	}
+	
+	return Font_BuildGlyph(the_font, the_char);
+}
+
+
+//! Convert the bits of one glyph in the font strike into run-length spans. Pass NULL for the_spans to only count the bytes required.
+uint32_t Font_ExpandGlyphSpans(Font* the_font, uint16_t loc_offset, int16_t pixel_only_width, uint8_t first_row, uint8_t num_rows, uint8_t* the_spans)
+{
+	uint32_t		span_bytes = 0;
+	uint16_t*		row_addr;
+	uint8_t			row;
+	
+	// LOGIC:
+	//   Glyph pixels for a row start loc_offset bits into that row of the strike, MSB first, and run for pixel_only_width bits
+	//   Each row is stored as a count byte, followed by (x start, run length) pairs for each run of set bits
+	//   Rows with no pixels still get their count byte (0), so the draw loop can step through rows without a lookup table
+	
+	row_addr = the_font->image_table_ + (uint32_t)first_row * (uint32_t)the_font->rowWords;
+	
+	for (row = 0; row < num_rows; row++)
+	{
+		uint8_t*	count_addr = NULL;
+		uint8_t		num_runs = 0;
+		int16_t		x = 0;
+		
+		if (the_spans)
+		{
+			count_addr = the_spans + span_bytes;
+		}
+		
+		span_bytes++;
+		
+		while (x < pixel_only_width)
+		{
+			uint16_t	bit_pos;
+			int16_t		run_start;
+			
+			bit_pos = loc_offset + x;
+			
+			if ( ((row_addr[bit_pos >> 4] >> (15 - (bit_pos & 0x0F))) & 0x01) == 0)
+			{
+				x++;
+				continue;
+			}
+			
+			run_start = x;
+			
+			do
+			{
+				x++;
+				bit_pos++;
+			} while (x < pixel_only_width && ((row_addr[bit_pos >> 4] >> (15 - (bit_pos & 0x0F))) & 0x01));
+			
+			if (the_spans)
+			{
+				the_spans[span_bytes] = (uint8_t)run_start;
+				the_spans[span_bytes + 1] = (uint8_t)(x - run_start);
+			}
+			
+			span_bytes += 2;
+			num_runs++;
+		}
+		
+		if (count_addr)
+		{
+			*count_addr = num_runs;
+		}
+		
+		row_addr += the_font->rowWords;
+	}
+	
+	return span_bytes;
+}
+
+
+//! Build a cached glyph for the specified character, evicting older glyphs as needed to stay within budget. Returns NULL if the glyph could not be cached.
+FontGlyph* Font_BuildGlyph(Font* the_font, uint8_t the_char)
+{
+	FontGlyph*		the_glyph;
+	uint16_t		glyph_index;
+	uint8_t			first_row;
+	uint8_t			max_row;
+	uint8_t			num_rows;
+	uint16_t		v_offset_height;
+	int16_t			offset_width_value;
+	int16_t			pixel_only_width;
+	uint32_t		span_bytes;
+	uint32_t		alloc_size;
+	
+	// LOGIC:
+	//   Resolve the glyph exactly as Font_DrawCharUncached() does (height table, missing glyph substitution, offset/width table)
+	//   then expand its bits once into spans. The glyph is cached under the requested char, so missing glyphs resolve in one lookup too.
+	
+	glyph_index = Font_GetGlyphIndex(the_font, the_char);
+	
+	if ( ((the_font->fontType & 0xFF) & 0x01) )
+	{
+		v_offset_height = the_font->height_table_[glyph_index];
+
+		if (v_offset_height == 0)
+		{
+			v_offset_height = the_font->height_table_[the_font->lastChar + 1];
+		}
+		
+		first_row = v_offset_height >> 8;
+		max_row = first_row + v_offset_height & 0xFF;		
+	}
+	else
+	{
+		first_row = 0;
+		max_row = the_font->fRectHeight;
+	}
+	
+	// rows are only drawn if they are within the font rect as well as within the height table's range
+	if (max_row > the_font->fRectHeight)
+	{
+		max_row = the_font->fRectHeight;
+	}
+	
+	num_rows = (max_row > first_row) ? max_row - first_row : 0;
+	
+	offset_width_value = the_font->width_table_[glyph_index];
+	pixel_only_width = (int16_t)the_font->loc_table_[glyph_index + 1] - (int16_t)the_font->loc_table_[glyph_index];
+	
+	if (pixel_only_width > 255)
+	{
+		// span x positions are stored as bytes. no real bitmap font comes close to this, but don't cache it if one does.
+		return NULL;
+	}
+
+	span_bytes = Font_ExpandGlyphSpans(the_font, the_font->loc_table_[glyph_index], pixel_only_width, first_row, num_rows, NULL);
+	alloc_size = sizeof(FontGlyph) + span_bytes;
+	
+	if (alloc_size > the_font->glyph_cache_budget_)
+	{
+		return NULL;
+	}
+	
+	Font_TrimGlyphCache(the_font, the_font->glyph_cache_budget_ - alloc_size);
+	
+	if ( (the_glyph = (FontGlyph*)calloc(1, alloc_size) ) == NULL)
+	{
+		LOG_ERR(("%s %d: could not allocate memory to cache glyph", __func__ , __LINE__));
+		return NULL;
+	}
+	LOG_ALLOC(("%s %d:	__ALLOC__	the_glyph	%p	size	%i", __func__ , __LINE__, the_glyph, alloc_size));
+	TRACK_ALLOC((alloc_size));
+
+	the_glyph->alloc_size_ = alloc_size;
+	the_glyph->the_char_ = the_char;
+	the_glyph->h_offset_ = (int8_t)(offset_width_value >> 8) + the_font->kernMax;
+	the_glyph->advance_ = offset_width_value & 0xFF;
+	the_glyph->first_row_ = first_row;
+	the_glyph->num_rows_ = num_rows;
+	the_glyph->spans_ = (uint8_t*)the_glyph + sizeof(FontGlyph);
+	
+	Font_ExpandGlyphSpans(the_font, the_font->loc_table_[glyph_index], pixel_only_width, first_row, num_rows, the_glyph->spans_);
+	
+	// add to cache as most recently used
+	the_glyph->older_ = the_font->glyph_mru_;
+	
+	if (the_font->glyph_mru_)
+	{
+		the_font->glyph_mru_->newer_ = the_glyph;
+	}
+	else
+	{
+		the_font->glyph_lru_ = the_glyph;
+	}
+	
+	the_font->glyph_mru_ = the_glyph;
+	the_font->glyph_cache_[the_char] = the_glyph;
+	the_font->glyph_cache_bytes_ += alloc_size;
+	
+	return the_glyph;
+}
+
+
+//! Mark a cached glyph as the most recently used
+void Font_TouchGlyph(Font* the_font, FontGlyph* the_glyph)
 {
-	int16_t			offset_width_value;
-	int8_t			width_value;			//!< the total width of the character including any whitespace to left/right
-
-	offset_width_value = the_font->width_table_[the_char];
+	if (the_font->glyph_mru_ == the_glyph)
+	{
+		return;
+	}
 	
-	if (offset_width_value == -1)
+	// unlink. it isn't the MRU, so it always has a newer neighbor
+	the_glyph->newer_->older_ = the_glyph->older_;
+	
+	if (the_glyph->older_)
 	{
-		// offset/width table says this char does not exist in the font		
-		// switch to the "missing glyph" character, which is the last one in the font.
-		the_char = the_font->lastChar + 1;
-		offset_width_value = the_font->width_table_[the_char];
+		the_glyph->older_->newer_ = the_glyph->newer_;
+	}
+	else
+	{
+		the_font->glyph_lru_ = the_glyph->newer_;
 	}
-
-	width_value = offset_width_value & 0xFF;
 	
-	return width_value;
+	// relink at the front
+	the_glyph->newer_ = NULL;
+	the_glyph->older_ = the_font->glyph_mru_;
+	the_font->glyph_mru_->newer_ = the_glyph;
+	the_font->glyph_mru_ = the_glyph;
 }
 
 
-//! Get the total height, in pixels, of one line of text, including any leading
-uint8_t Font_GetRowHeight(Font* the_font)
+//! Remove a glyph from the cache and free it
+void Font_FreeGlyph(Font* the_font, FontGlyph* the_glyph)
 {
-	return (uint8_t)(the_font->leading + the_font->fRectHeight);
+	if (the_glyph->newer_)
+	{
+		the_glyph->newer_->older_ = the_glyph->older_;
+	}
+	else
+	{
+		the_font->glyph_mru_ = the_glyph->older_;
+	}
+	
+	if (the_glyph->older_)
+	{
+		the_glyph->older_->newer_ = the_glyph->newer_;
+	}
+	else
+	{
+		the_font->glyph_lru_ = the_glyph->newer_;
+	}
+	
+	the_font->glyph_cache_[the_glyph->the_char_] = NULL;
+	the_font->glyph_cache_bytes_ -= the_glyph->alloc_size_;
+
+	LOG_ALLOC(("%s %d:	__FREE__	the_glyph	%p	size	%i", __func__ , __LINE__, the_glyph, the_glyph->alloc_size_));
+	TRACK_ALLOC((0 - the_glyph->alloc_size_));
+	free(the_glyph);
 }
 
-//! Get the width of characters, in pixels, for fixed width fonts (all fonts will report one)
-uint8_t Font_GetFixedWidth(Font* the_font)
+
+//! Free least recently used glyphs until the cache is using no more than the specified number of bytes
+void Font_TrimGlyphCache(Font* the_font, uint32_t max_bytes)
 {
-	return (uint8_t)(the_font->leading + the_font->widMax);
+	while (the_font->glyph_lru_ && the_font->glyph_cache_bytes_ > max_bytes)
+	{
+		Font_FreeGlyph(the_font, the_font->glyph_lru_);
+	}
 }
 
 
@@ -299,6 +869,9 @@ Font* Font_New(uint8_t* the_data, uint16_t data_size)
 
 	//DEBUG_OUT(("%s %d: image_table_count=%u, loc_table_count=%u, width_table_count=%u", __func__, __LINE__, image_table_count, loc_table_count, width_table_count));
 
+	// glyph cache starts empty (calloc), with the default budget. glyphs are expanded as they are first drawn.
+	the_font->glyph_cache_budget_ = FONT_GLYPH_CACHE_DEFAULT_BUDGET;
+
 	// DEBUG
 	//Font_Print(the_font);
 
@@ -324,6 +897,8 @@ bool Font_Destroy(Font** the_font)
 		return false;
 	}
 
+	Font_FlushGlyphCache(*the_font);
+	
 	if ((*the_font)->image_table_)
 	{
 		alloc_len = (int16_t)(*the_font)->rowWords * (int16_t)(*the_font)->fRectHeight;
@@ -367,7 +942,40 @@ bool Font_Destroy(Font** the_font)
 
 
 
-// **** xxx functions *****
+// **** Glyph cache functions *****
+
+//! Set the maximum number of bytes the font may spend on pre-expanded glyphs
+//! If the cache is currently using more than the new budget, least recently used glyphs are freed until it fits.
+//! @param	the_font -- reference to a complete, loaded Font object.
+//! @param	max_bytes -- the new budget, in bytes. Pass 0 to disable the glyph cache entirely (all glyphs will be drawn directly from the font strike).
+//! @return	Returns false if the font was NULL
+bool Font_SetGlyphCacheBudget(Font* the_font, uint32_t max_bytes)
+{
+	if (the_font == NULL)
+	{
+		LOG_ERR(("%s %d: passed font was NULL", __func__, __LINE__));
+		return false;
+	}
+	
+	the_font->glyph_cache_budget_ = max_bytes;
+	Font_TrimGlyphCache(the_font, max_bytes);
+	
+	return true;
+}
+
+
+//! Free all pre-expanded glyphs for the font. The cache budget is not changed; glyphs will be rebuilt as they are drawn.
+//! @param	the_font -- reference to a complete, loaded Font object.
+void Font_FlushGlyphCache(Font* the_font)
+{
+	if (the_font == NULL)
+	{
+		LOG_ERR(("%s %d: passed font was NULL", __func__, __LINE__));
+		return;
+	}
+	
+	Font_TrimGlyphCache(the_font, 0);
+}
 
 
 
@@ -399,6 +1007,10 @@ bool Font_DrawString(Bitmap* the_bitmap, char* the_string, int16_t max_chars)
 	int16_t			available_width;
 	int16_t			draw_result = 0;
 	int16_t			pixels_used;
+	int16_t			run_len;
+	Font*			the_font;
+	FontGlyph*		the_glyphs[FONT_GLYPH_RUN_MAX];
+	int16_t			the_x_positions[FONT_GLYPH_RUN_MAX];
 	
 	// LOGIC:
 	//   Determine how many characters of the string will fit in one line on the bitmap and draw that many
@@ -430,17 +1042,75 @@ bool Font_DrawString(Bitmap* the_bitmap, char* the_string, int16_t max_chars)
 		return false;
 	}
 	
-	for (i = 0; i < fit_count && draw_result != -1; i++)
+	// LOGIC:
+	//   With the glyph cache enabled, resolve the glyphs for a run of chars up front, then write the whole run one row at a time.
+	//   A run is drawn early (before it is full) when the next glyph isn't in the cache yet: building it may evict glyphs earlier in the run.
+	//   Chars that can't be cached are drawn individually, between runs.
+	//   With the cache disabled, draw char by char.
+	
+	the_font = the_bitmap->font_;
+	
+	if (the_font->glyph_cache_budget_ == 0)
+	{
+		for (i = 0; i < fit_count && draw_result != -1; i++)
+		{
+			unsigned char	the_char;
+			
+			the_char = the_string[i];
+			
+			//DEBUG_OUT(("%s %d: the_bitmap->x_ before drawChar=%i", __func__, __LINE__, the_bitmap->x_));
+			draw_result = Font_DrawChar(the_bitmap, the_char, NULL);
+			//DEBUG_OUT(("%s %d: the_bitmap->x_ after drawChar=%i", __func__, __LINE__, the_bitmap->x_));
+		}
+		
+		return true;
+	}
+	
+	run_len = 0;
+	
+	for (i = 0; i < fit_count; i++)
 	{
 		unsigned char	the_char;
+		FontGlyph*		the_glyph;
 		
 		the_char = the_string[i];
 		
-		//DEBUG_OUT(("%s %d: the_bitmap->x_ before drawChar=%i", __func__, __LINE__, the_bitmap->x_));
-		draw_result = Font_DrawChar(the_bitmap, the_char, NULL);
-		//DEBUG_OUT(("%s %d: the_bitmap->x_ after drawChar=%i", __func__, __LINE__, the_bitmap->x_));
+		if ( (the_glyph = the_font->glyph_cache_[the_char]) != NULL)
+		{
+			Font_TouchGlyph(the_font, the_glyph);
+		}
+		else
+		{
+			if (run_len > 0)
+			{
+				Font_DrawGlyphRun(the_bitmap, the_glyphs, the_x_positions, run_len);
+				run_len = 0;
+			}
+			
+			if ( (the_glyph = Font_BuildGlyph(the_font, the_char)) == NULL)
+			{
+				Font_DrawCharUncached(the_bitmap, the_char, the_font);
+				continue;
+			}
+		}
+		
+		the_glyphs[run_len] = the_glyph;
+		the_x_positions[run_len] = the_bitmap->x_ + the_glyph->h_offset_;
+		the_bitmap->x_ += the_glyph->advance_;
+		run_len++;
+		
+		if (run_len == FONT_GLYPH_RUN_MAX)
+		{
+			Font_DrawGlyphRun(the_bitmap, the_glyphs, the_x_positions, run_len);
+			run_len = 0;
+		}
 	}
 
+	if (run_len > 0)
+	{
+		Font_DrawGlyphRun(the_bitmap, the_glyphs, the_x_positions, run_len);
+	}
+	
 	return true;
 }
 
@@ -706,23 +1376,8 @@ int16_t Font_MeasureStringWidth(Font* the_font, char* the_string, int16_t num_ch
 //! @return	Returns number of horizontal pixels used, including left/right offsets, or -1 on any error condition.
 int16_t Font_DrawChar(Bitmap* the_bitmap, uint8_t the_char, Font* the_font)
 {
-	int32_t			row;
-	int32_t			pixels_moved;
-	uint8_t			next_char;
-	int16_t			loc_offset;
-	int16_t			next_loc_offset;
-	int16_t			pixel_only_width;		// the width of the character's actual pixels at max width
-	int16_t			image_offset_index;
-	int16_t			image_offset_index_rem;
-	int16_t			offset_width_value;
-	uint16_t*		start_read_addr;
-	int8_t			h_offset_value;			// the horizontal offset from pen position before the first pixel should be drawn
-	int8_t			width_value;			// the total width of the character including any whitespace to left/right
-	uint8_t			the_color;				// shortcut to bitmap->color_
-	uint32_t		start_write_addr_int;
-	uint8_t			first_row;				// if no height table available, this is 0. otherwise it's first row to start drawing.
-	uint8_t			max_row;				// if no height table available, this is height of font rec. otherwise it's 1 past the last vis row
-	uint16_t		v_offset_height;
+	FontGlyph*		the_glyph;
+	int16_t			x_position;
 	
 	if (the_bitmap == NULL)
 	{
@@ -743,178 +1398,22 @@ int16_t Font_DrawChar(Bitmap* the_bitmap, uint8_t the_char, Font* the_font)
 	}
 	
 	// LOGIC:
-	//   Some Mac fonts have an optional height offset/num rows table. 
-	//   If present, it will contain row of first visible pixel, and count of rows with pixels
-	//   We can use that to reduce reads/write loops and draw faster. 
-	//     Characters that are not in the font (missing/-1 glyphs) will have 0 for height/offset. 
-	//   If no height table present, we read/write through every row in the Font
-	
-	//DEBUG_OUT(("%s %d: the_font->fontType=%u, (the_font->fontType & 0xFF) & 0x01)=%u", __func__, __LINE__, the_font->fontType, (the_font->fontType & 0xFF) & 0x01));
-	
-	if ( ((the_font->fontType & 0xFF) & 0x01) )
-	{		
-
-		v_offset_height = the_font->height_table_[the_char];
-		
-		//DEBUG_OUT(("%s %d: v_offset_height=%u", __func__, __LINE__, v_offset_height));
-
-		if (v_offset_height == 0)
-		{
-			// if char is missing, height value seems to get set to 0. Use the one for the "missing glyph" char, which is one past last real char in font
-			v_offset_height = the_font->height_table_[the_font->lastChar + 1];
-		}
-		
-		first_row = v_offset_height >> 8;
-		max_row = first_row + v_offset_height & 0xFF;		
-	}
-	else
-	{
-		first_row = 0;
-		max_row = the_font->fRectHeight;
-		v_offset_height = 0;
-	}
-	
-	//DEBUG_OUT(("%s %d: glyph char=%u, height/offset value=%i, first_row=%i, max_row=%i", __func__, __LINE__, the_char, v_offset_height, first_row, max_row));
-	//DEBUG_OUT(("%s %d: fRectHeight=%x/%i", __func__, __LINE__, the_font->fRectHeight, the_font->fRectHeight));
-	
-	//   the low byte will be the v offset from top of glyph rect (eg, 3, if the first pixel is in the 4th row down)
-	//   the high byte will contain the total rows of visible pixels (eg, 3 for say a comma, but 9 for a capital letter)
-
-	
-	// LOGIC:
-	//   The pixel-only width (max width of character excluding any whitespace to left or right) is determined by subtracting the location offset of the the char to draw, from that of the following character. All the characters are packed in "shoulder to shoulder, so basically you are just comparing start of this char vs start of next char. 
-	
-	next_char = the_char + 1;
-
-	// LOGIC:
-	//   The offset/width table contains -1 if the char does not exist in this font
-	//   If the char does exist:
-	//     the low byte will be the horizontal offset (eg, 1, if you need to start drawing 1 pixel to the right of the pen location)if the value is -1
-	//     the high byte will contain the total width needed to render the character (including any whitespace to left or right of pixels)
-	
-	offset_width_value = the_font->width_table_[the_char];
-	
-	if (offset_width_value == -1)
-	{
-		// Comment out the line below causes the font data to be read in somewhat wrong. it's not clear to me why having the debug line should do anything. 
-		//DEBUG_OUT(("%s %d: offset/width table says this char (%u) does not exist in the font, switching to last char in font (%u)", __func__, __LINE__, the_char, the_font->lastChar + 1));
-		
-		// switch to the "missing glyph" character, which is the last one in the font.
-		the_char = the_font->lastChar + 1;
-		next_char = the_char+1;
-		offset_width_value = the_font->width_table_[the_char];
-	}
-	else
-	{
-		//DEBUG_OUT(("%s %d: this char (%u) has a glyph in the font. Width/offset value=%x", __func__, __LINE__, the_char, offset_width_value));		
-	}
-
-	h_offset_value = offset_width_value >> 8;
-	width_value = offset_width_value & 0xFF;
-	
-	loc_offset = the_font->loc_table_[the_char];
-	next_loc_offset = the_font->loc_table_[next_char];
-	pixel_only_width = next_loc_offset - loc_offset;
-	//DEBUG_OUT(("%s %d: loc_offset=%i, next_loc_offset=%i, pixel_only_width=%i", __func__, __LINE__, loc_offset, next_loc_offset, pixel_only_width));
-	//DEBUG_OUT(("%s %d: Wid/offset=%x, width_value=%x, h_offset_value=%x", __func__, __LINE__, offset_width_value, width_value, h_offset_value));
-	
-	// MB 2022: the following debug line, if not included in Calypsi 68k builds, has the effect of having width_value=0, which causes x to not advance after drawing this glyph
-
-	//DEBUG_OUT(("%s %d: pxwidth=%i, Wid/offset=%i, width_value=%i, h_offset_value=%i", __func__, __LINE__, pixel_only_width, offset_width_value, width_value, h_offset_value));
-	
-	// for A in Chicago, I get "227". this is apparently the BIT offset from the start of the image data table. 
-	// so 227/16=14.1875=image_table_[13] + 3 bits. 
-	
-	image_offset_index = loc_offset / 16;		// word # within the bitmap table to start reading. 
-	image_offset_index_rem = loc_offset % 16;	// # of bits within the first word until the bits for this glyph start
-	//DEBUG_OUT(("%s %d: loc_offset=%x, image_offset_index=%i, image_offset_index_rem=%i", __func__, __LINE__, loc_offset, image_offset_index, image_offset_index_rem));
-
-	the_color = Bitmap_GetColor(the_bitmap);
+	//   If the font has a glyph cache budget, draw from the pre-expanded spans for this char, building them on first use.
+	//   If the cache is disabled, or the glyph can't be cached (too big for budget, or out of memory), read the bits from the font strike directly.
 	
-	start_read_addr = the_font->image_table_ + image_offset_index;
-	
-	start_write_addr_int = Bitmap_GetMemLocInt(the_bitmap);
-	//DEBUG_OUT(("%s %d: start_write_addr_int=%p, start_read=%p", __func__, __LINE__, start_write_addr_int, start_read_addr));
-
-	for (row = 0; row < the_font->fRectHeight; row++)
+	if (the_font->glyph_cache_budget_ > 0)
 	{
-		uint16_t*		read_addr;
-		uint32_t		write_addr_int;
-		
-		read_addr = start_read_addr;
-		write_addr_int = start_write_addr_int;
-		
-		// LOGIC: 
-		//   we have one or more 16 bit words to parse
-		//   each bit in the word represents one horizontal pixel on or off
-		//   a glyph may start on one word, and end on the next
-		//   of the 16 bits, we likely only need a subset: 
-		//     the bits from image_offset_index_rem to image_offset_index_rem +  pixel_only_width
-		
-		if (row >= first_row && row < max_row)
+		if ( (the_glyph = Font_GetCachedGlyph(the_font, the_char)) != NULL)
 		{
-			int16_t	pixels_written = 0;
-
-			// for each row, account for any H offset specified for the glyph
-			write_addr_int += h_offset_value;
-			
-			pixels_moved = 0;
-			
-			do
-			{
-				int16_t		i;
-				uint16_t	the_word;
-				bool		this_bit;
-				
-				the_word = *read_addr;
-				
-				for (i = 15; i >= 0 && pixels_written < pixel_only_width; i--)
-				{
-					this_bit = (bool)((the_word >> i) & 0x01);
-					
-					//DEBUG_OUT(("wd=%x, i=%i, row=%i, bit=%i px written=%u px moved=%u", the_word, i, row, this_bit, pixels_written, pixels_moved));
-					
-					if ( (pixels_moved >= image_offset_index_rem) )
-					{
-						if (this_bit)
-						{
-							*(uint8_t*)write_addr_int = the_color;
-						}
-						
-						//DEBUG_OUT(("read_addr=%p, wd=%x, bit=%u, i=%i, row=%i", read_addr, *read_addr, this_bit, i, row));
-					
-						write_addr_int++;
-						pixels_written++;
-					}
-					
-					pixels_moved++;
-				}
+			x_position = the_bitmap->x_ + the_glyph->h_offset_;
+			Font_DrawGlyphRun(the_bitmap, &the_glyph, &x_position, 1);
+			the_bitmap->x_ += the_glyph->advance_;
 			
-				read_addr++; // move to next word in the font data
-				
-			} while (pixels_written < pixel_only_width);
-		}		
-		
-		// move read pointer in font to next row; move write pointer in bitmap to next row
-		start_read_addr += the_font->rowWords;
-		start_write_addr_int += (uint32_t)the_bitmap->width_;
+			return the_glyph->advance_;
+		}
 	}
 	
-	// finished writing visible pixels, but need to move pen further right if char's overall width was greater than amount moved so far
-// 	DEBUG_OUT(("%s %d: before: pixels_moved=%i, width_value=%i", __func__, __LINE__, pixels_moved, width_value));
-	//pixels_moved += width_value - pixels_moved;
-	pixels_moved = width_value;
-// 	DEBUG_OUT(("%s %d: after: pixels_moved=%i", __func__, __LINE__, pixels_moved));
-	
-	//DEBUG_OUT(("%s %d: before: pixels_moved=%i, the_bitmap->x_=%i", __func__, __LINE__, pixels_moved, the_bitmap->x_));
-// 	int16_t	temp = the_bitmap->x_;
-	the_bitmap->x_ += pixels_moved;
-	//DEBUG_OUT(("%s %d: after: the_bitmap->x_=%i", __func__, __LINE__, the_bitmap->x_));
-// 	the_bitmap->x_ = temp;
-// 	the_bitmap->x_ += (int16_t)pixels_moved;
-// 	DEBUG_OUT(("%s %d: after cast: the_bitmap->x_=%i", __func__, __LINE__, the_bitmap->x_));
-	
-	return pixels_moved;
+	return Font_DrawCharUncached(the_bitmap, the_char, the_font);
 }
 
 
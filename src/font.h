@@ -55,6 +55,10 @@
 #define FONT_CHAR_MENU_RIGHT		0x15	//!< the '>' style character for use in showing submenus
 #define FONT_CHAR_MENU_RIGHT_WIDTH	7		//!< the width, in pixels, of the standard '>' for menu sub-menus. Every font is to use the same width, regardless of style or size.
 
+#define FONT_GLYPH_CACHE_DEFAULT_BUDGET	8192	//!< default number of bytes each Font may spend on pre-expanded glyphs. Set to 0 with Font_SetGlyphCacheBudget() to disable the cache.
+#define FONT_GLYPH_CACHE_NUM_SLOTS		256		//!< one cache slot per possible 8-bit character code
+#define FONT_GLYPH_RUN_MAX				32		//!< max number of glyphs Font_DrawString() resolves before writing them out row by row
+
 
 /*****************************************************************************/
 /*                               Enumerations                                */
@@ -66,6 +70,21 @@
 /*                                 Structs                                   */
 /*****************************************************************************/
 
+//! One pre-expanded glyph. Built the first time a character is drawn, then reused until evicted.
+//! The span data is stored in the same allocation, immediately after the struct. 
+//! For each row from first_row_ to first_row_ + num_rows_ - 1 it holds: 1 byte count of runs, then that many (x start, run length) byte pairs. 
+struct FontGlyph {
+	FontGlyph*			newer_;			//!< the next more recently used glyph, or NULL if this is the most recently used
+	FontGlyph*			older_;			//!< the next less recently used glyph, or NULL if this is the least recently used
+	uint32_t			alloc_size_;	//!< total bytes allocated for this glyph, including the span data. Counted against the font's cache budget.
+	uint8_t				the_char_;		//!< the character code this glyph was requested as (missing glyphs are cached under the requested code)
+	int16_t				h_offset_;		//!< horizontal offset from the pen position to the first pixel column, including the font's kernMax
+	int8_t				advance_;		//!< total width of the character, including any whitespace to left/right. Pen moves this far.
+	uint8_t				first_row_;		//!< first row of the font rect that has pixels to draw
+	uint8_t				num_rows_;		//!< number of rows of span data
+	uint8_t*			spans_;			//!< run-length span data (see above)
+};
+
 //! This Font object is essentially the Mac "fontRecord" struct, with added pointers for the data tables. 
 //! It is designed to allow a Mac 'FONT' resource to be loaded into memory to populate this struct. 
 struct Font {
@@ -86,6 +105,11 @@ struct Font {
 	uint16_t*			loc_table_;		//!< The location table
 	uint16_t*			width_table_;	//!< Table containing h offset and widths for each glyph
 	uint16_t*			height_table_;	//!< Table containing starting v offset and active v pixel count for each glyph
+	FontGlyph*			glyph_cache_[FONT_GLYPH_CACHE_NUM_SLOTS];	//!< pre-expanded glyphs, indexed by character code. NULL if not (yet) cached.
+	FontGlyph*			glyph_mru_;		//!< most recently used cached glyph
+	FontGlyph*			glyph_lru_;		//!< least recently used cached glyph. First to be evicted when the budget is exceeded.
+	uint32_t			glyph_cache_bytes_;		//!< bytes currently allocated to cached glyphs
+	uint32_t			glyph_cache_budget_;	//!< max bytes that may be allocated to cached glyphs. 0 disables the cache.
 };
 
 
@@ -125,8 +149,18 @@ bool Font_Destroy(Font** the_font);
 
 
 
-// **** xxx functions *****
+// **** Glyph cache functions *****
 
+//! Set the maximum number of bytes the font may spend on pre-expanded glyphs
+//! If the cache is currently using more than the new budget, least recently used glyphs are freed until it fits.
+//! @param	the_font -- reference to a complete, loaded Font object.
+//! @param	max_bytes -- the new budget, in bytes. Pass 0 to disable the glyph cache entirely (all glyphs will be drawn directly from the font strike).
+//! @return	Returns false if the font was NULL
+bool Font_SetGlyphCacheBudget(Font* the_font, uint32_t max_bytes);
+
+//! Free all pre-expanded glyphs for the font. The cache budget is not changed; glyphs will be rebuilt as they are drawn.
+//! @param	the_font -- reference to a complete, loaded Font object.
+void Font_FlushGlyphCache(Font* the_font);
 
 
 
@@ -150,6 +184,7 @@ bool Font_Destroy(Font** the_font);
 // No word wrap is performed. 
 // If max_chars is less than the string length, only that many characters will be drawn (as space allows)
 // If max_chars is -1, then the full string length will be drawn, as space allows.
+// If the font's glyph cache is enabled, glyphs are resolved for a run of characters first, then the run is written one row at a time. Pixels that would fall outside the bitmap are clipped.
 bool Font_DrawString(Bitmap* the_bitmap, char* the_string, int16_t max_chars);
 
 //! Draw a string in a rectangular block on the screen, with wrap.
@@ -18,6 +18,7 @@
 #include "minunit.h"
 
 // project includes
+#include "bitmap.h"
 #include "debug.h"
 #include "sys.h"
 
@@ -26,6 +27,8 @@
 
 // C includes
 #include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
 
 // A2560 includes
 #include "a2560k.h"
@@ -37,6 +40,11 @@
 /*                               Definitions                                 */
 /*****************************************************************************/
 
+#define GLYPH_TEST_BITMAP_WIDTH		640
+#define GLYPH_TEST_BITMAP_HEIGHT	32
+#define GLYPH_SPEED_TEST_PASSES		40		//!< number of times the font's full character set is drawn, per variant
+#define STRING_SPEED_TEST_PASSES	400		//!< number of times the test string is drawn, per variant
+
 
 
 /*****************************************************************************/
@@ -57,12 +65,36 @@ System*			global_system;
 /*                       Private Function Prototypes                         */
 /*****************************************************************************/
 
+// draw every char in the font (firstChar to lastChar) across the bitmap, wrapping back to the left when the pen runs out of room. returns total pen advance.
+int32_t Test_DrawAllGlyphs(Bitmap* the_bitmap, Font* the_font);
 
 
 /*****************************************************************************/
 /*                       Private Function Definitions                        */
 /*****************************************************************************/
 
+// draw every char in the font (firstChar to lastChar) across the bitmap, wrapping back to the left when the pen runs out of room. returns total pen advance.
+// starts one font rect in from the left, as glyphs with a negative h offset would otherwise write before the start of the bitmap
+int32_t Test_DrawAllGlyphs(Bitmap* the_bitmap, Font* the_font)
+{
+	int16_t		i;
+	int32_t		total_advance = 0;
+	
+	Bitmap_SetXY(the_bitmap, the_font->fRectWidth, 0);
+	
+	for (i = the_font->firstChar; i <= the_font->lastChar; i++)
+	{
+		if (the_bitmap->x_ > the_bitmap->width_ - 2 * the_font->fRectWidth)
+		{
+			Bitmap_SetXY(the_bitmap, the_font->fRectWidth, 0);
+		}
+		
+		total_advance += Font_DrawChar(the_bitmap, (uint8_t)i, the_font);
+	}
+	
+	return total_advance;
+}
+
 
 
 
@@ -89,8 +121,241 @@ void test_teardown(void)	// this is called EVERY test
 
 
 
+MU_TEST(test_glyph_cache_matches_uncached)
+{
+	Font*		the_font;
+	Bitmap*		uncached_bitmap;
+	Bitmap*		cached_bitmap;
+	int32_t		uncached_advance;
+	int32_t		cached_advance;
+	uint32_t	bitmap_size = (uint32_t)GLYPH_TEST_BITMAP_WIDTH * GLYPH_TEST_BITMAP_HEIGHT;
+	
+	the_font = Sys_GetSystemFont(global_system);
+	mu_check(the_font != NULL);
+	
+	uncached_bitmap = Bitmap_New(GLYPH_TEST_BITMAP_WIDTH, GLYPH_TEST_BITMAP_HEIGHT, the_font, false);
+	cached_bitmap = Bitmap_New(GLYPH_TEST_BITMAP_WIDTH, GLYPH_TEST_BITMAP_HEIGHT, the_font, false);
+	mu_check(uncached_bitmap != NULL);
+	mu_check(cached_bitmap != NULL);
+	Bitmap_SetColor(uncached_bitmap, 0x35);
+	Bitmap_SetColor(cached_bitmap, 0x35);
+	
+	// draw with cache disabled, then with it enabled: twice, so second pass is entirely from cache
+	mu_check(Font_SetGlyphCacheBudget(the_font, 0));
+	uncached_advance = Test_DrawAllGlyphs(uncached_bitmap, the_font);
+	mu_assert_int_eq(0, the_font->glyph_cache_bytes_);
+	
+	mu_check(Font_SetGlyphCacheBudget(the_font, FONT_GLYPH_CACHE_DEFAULT_BUDGET * 4));
+	cached_advance = Test_DrawAllGlyphs(cached_bitmap, the_font);
+	mu_assert_int_eq(uncached_advance, cached_advance);
+	mu_check(memcmp(uncached_bitmap->addr_, cached_bitmap->addr_, bitmap_size) == 0);
+	
+	cached_advance = Test_DrawAllGlyphs(cached_bitmap, the_font);
+	mu_assert_int_eq(uncached_advance, cached_advance);
+	mu_check(memcmp(uncached_bitmap->addr_, cached_bitmap->addr_, bitmap_size) == 0);
+
+	// a small budget forces constant eviction: output must still match, and the cache must never exceed budget
+	mu_check(Font_SetGlyphCacheBudget(the_font, 256));
+	mu_check(the_font->glyph_cache_bytes_ <= 256);
+	Bitmap_FillMemory(cached_bitmap, 0);
+	cached_advance = Test_DrawAllGlyphs(cached_bitmap, the_font);
+	mu_assert_int_eq(uncached_advance, cached_advance);
+	mu_check(the_font->glyph_cache_bytes_ <= 256);
+	Bitmap_FillMemory(uncached_bitmap, 0);
+	Font_SetGlyphCacheBudget(the_font, 0);
+	Test_DrawAllGlyphs(uncached_bitmap, the_font);
+	mu_check(memcmp(uncached_bitmap->addr_, cached_bitmap->addr_, bitmap_size) == 0);
+	
+	// flush leaves budget alone
+	Font_SetGlyphCacheBudget(the_font, FONT_GLYPH_CACHE_DEFAULT_BUDGET);
+	Test_DrawAllGlyphs(cached_bitmap, the_font);
+	mu_check(the_font->glyph_cache_bytes_ > 0);
+	Font_FlushGlyphCache(the_font);
+	mu_assert_int_eq(0, the_font->glyph_cache_bytes_);
+	mu_assert_int_eq(FONT_GLYPH_CACHE_DEFAULT_BUDGET, the_font->glyph_cache_budget_);
+	mu_check(the_font->glyph_mru_ == NULL && the_font->glyph_lru_ == NULL);
+
+	Bitmap_Destroy(&uncached_bitmap);
+	Bitmap_Destroy(&cached_bitmap);
+}
+
+
+
+MU_TEST(test_draw_string_matches_draw_char)
+{
+	Font*		the_font;
+	Bitmap*		char_bitmap;
+	Bitmap*		string_bitmap;
+	char		the_string[80];
+	int16_t		i;
+	int16_t		num_chars;
+	uint32_t	bitmap_size = (uint32_t)GLYPH_TEST_BITMAP_WIDTH * GLYPH_TEST_BITMAP_HEIGHT;
+	
+	the_font = Sys_GetSystemFont(global_system);
+	char_bitmap = Bitmap_New(GLYPH_TEST_BITMAP_WIDTH, GLYPH_TEST_BITMAP_HEIGHT, the_font, false);
+	string_bitmap = Bitmap_New(GLYPH_TEST_BITMAP_WIDTH, GLYPH_TEST_BITMAP_HEIGHT, the_font, false);
+	mu_check(char_bitmap != NULL);
+	mu_check(string_bitmap != NULL);
+	Bitmap_SetColor(char_bitmap, 0x35);
+	Bitmap_SetColor(string_bitmap, 0x35);
+	
+	// string includes chars that are likely missing from the font, to exercise the missing glyph fallback. 
+	sprintf(the_string, "Title Bar%c%c Menu: File Edit %c%c {kern} WAVY jjj", 0x01, 0x7F, 0xFE, 0xFF);
+	num_chars = strlen(the_string);
+	
+	// reference: char by char, with the cache disabled
+	Font_SetGlyphCacheBudget(the_font, 0);
+	Bitmap_SetXY(char_bitmap, 4, 2);
+	
+	for (i = 0; i < num_chars; i++)
+	{
+		Font_DrawChar(char_bitmap, (uint8_t)the_string[i], the_font);
+	}
+	
+	// string renderer, cold then warm cache, then with a budget small enough to force eviction mid-string
+	Font_SetGlyphCacheBudget(the_font, FONT_GLYPH_CACHE_DEFAULT_BUDGET);
+	Font_FlushGlyphCache(the_font);
+	Bitmap_SetXY(string_bitmap, 4, 2);
+	mu_check(Font_DrawString(string_bitmap, the_string, GEN_NO_STRLEN_CAP));
+	mu_assert_int_eq(char_bitmap->x_, string_bitmap->x_);
+	mu_check(memcmp(char_bitmap->addr_, string_bitmap->addr_, bitmap_size) == 0);
+	
+	Bitmap_FillMemory(string_bitmap, 0);
+	Bitmap_SetXY(string_bitmap, 4, 2);
+	mu_check(Font_DrawString(string_bitmap, the_string, GEN_NO_STRLEN_CAP));
+	mu_check(memcmp(char_bitmap->addr_, string_bitmap->addr_, bitmap_size) == 0);
+
+	Font_SetGlyphCacheBudget(the_font, 256);
+	Bitmap_FillMemory(string_bitmap, 0);
+	Bitmap_SetXY(string_bitmap, 4, 2);
+	mu_check(Font_DrawString(string_bitmap, the_string, GEN_NO_STRLEN_CAP));
+	mu_assert_int_eq(char_bitmap->x_, string_bitmap->x_);
+	mu_check(memcmp(char_bitmap->addr_, string_bitmap->addr_, bitmap_size) == 0);
+	
+	// string that runs off the bottom of the bitmap must be clipped, not written past the end
+	Font_SetGlyphCacheBudget(the_font, FONT_GLYPH_CACHE_DEFAULT_BUDGET);
+	Bitmap_SetXY(string_bitmap, 0, GLYPH_TEST_BITMAP_HEIGHT - 2);
+	mu_check(Font_DrawString(string_bitmap, the_string, GEN_NO_STRLEN_CAP));
+	
+	Bitmap_Destroy(&char_bitmap);
+	Bitmap_Destroy(&string_bitmap);
+}
+
+
+
 // **** speed tests
 
+MU_TEST(test_speed_1_glyph_cache)
+{
+	Font*		the_font;
+	Bitmap*		the_bitmap;
+	long		start1;
+	long		end1;
+	long		start2;
+	long		end2;
+	int16_t		i;
+	uint32_t	num_glyphs;
+	
+	the_font = Sys_GetSystemFont(global_system);
+	num_glyphs = (uint32_t)GLYPH_SPEED_TEST_PASSES * (the_font->lastChar - the_font->firstChar + 1);
+	the_bitmap = Bitmap_New(GLYPH_TEST_BITMAP_WIDTH, GLYPH_TEST_BITMAP_HEIGHT, the_font, false);
+	mu_check(the_bitmap != NULL);
+	Bitmap_SetColor(the_bitmap, 0x35);
+	
+	// test speed of drawing directly from font strike
+	Font_SetGlyphCacheBudget(the_font, 0);
+	start1 = mu_timer_real();
+	
+	for (i = 0; i < GLYPH_SPEED_TEST_PASSES; i++)
+	{
+		Test_DrawAllGlyphs(the_bitmap, the_font);
+	}
+	
+	end1 = mu_timer_real();
+	
+	// test speed of drawing from glyph cache (warm cache after first pass)
+	// budget must hold the full character set: cycling through more glyphs than fit would evict every one before it is reused
+	Font_SetGlyphCacheBudget(the_font, FONT_GLYPH_CACHE_DEFAULT_BUDGET * 4);
+	start2 = mu_timer_real();
+	
+	for (i = 0; i < GLYPH_SPEED_TEST_PASSES; i++)
+	{
+		Test_DrawAllGlyphs(the_bitmap, the_font);
+	}
+	
+	end2 = mu_timer_real();
+	
+	Font_SetGlyphCacheBudget(the_font, FONT_GLYPH_CACHE_DEFAULT_BUDGET);
+	printf("\nSpeed results: uncached glyphs completed in %li ticks; cached glyphs in %li ticks\n", end1 - start1, end2 - start2);
+	
+	if (end1 > start1 && end2 > start2)
+	{
+		printf("Glyphs/sec: uncached=%lu, cached=%lu\n", num_glyphs * SYS_TICKS_PER_SEC / (end1 - start1), num_glyphs * SYS_TICKS_PER_SEC / (end2 - start2));
+	}
+	
+	Bitmap_Destroy(&the_bitmap);
+}
+
+
+MU_TEST(test_speed_2_draw_string)
+{
+	Font*		the_font;
+	Bitmap*		the_bitmap;
+	char*		the_string = "File  Edit  View  Special  -  Untitled Window Title 123";
+	long		start1;
+	long		end1;
+	long		start2;
+	long		end2;
+	int16_t		i;
+	int16_t		j;
+	int16_t		num_chars;
+	uint32_t	num_glyphs;
+	
+	the_font = Sys_GetSystemFont(global_system);
+	the_bitmap = Bitmap_New(GLYPH_TEST_BITMAP_WIDTH, GLYPH_TEST_BITMAP_HEIGHT, the_font, false);
+	mu_check(the_bitmap != NULL);
+	Bitmap_SetColor(the_bitmap, 0x35);
+	Font_SetGlyphCacheBudget(the_font, FONT_GLYPH_CACHE_DEFAULT_BUDGET);
+	num_chars = strlen(the_string);
+	num_glyphs = (uint32_t)STRING_SPEED_TEST_PASSES * num_chars;
+	
+	// test speed of drawing the string one Font_DrawChar() call at a time (cached glyphs)
+	start1 = mu_timer_real();
+	
+	for (i = 0; i < STRING_SPEED_TEST_PASSES; i++)
+	{
+		Bitmap_SetXY(the_bitmap, 0, 0);
+		
+		for (j = 0; j < num_chars; j++)
+		{
+			Font_DrawChar(the_bitmap, (uint8_t)the_string[j], the_font);
+		}
+	}
+	
+	end1 = mu_timer_real();
+	
+	// test speed of drawing the string with the row-at-a-time string renderer
+	start2 = mu_timer_real();
+	
+	for (i = 0; i < STRING_SPEED_TEST_PASSES; i++)
+	{
+		Bitmap_SetXY(the_bitmap, 0, 0);
+		Font_DrawString(the_bitmap, the_string, GEN_NO_STRLEN_CAP);
+	}
+	
+	end2 = mu_timer_real();
+	
+	printf("\nSpeed results: per-char string drawing completed in %li ticks; row-at-a-time in %li ticks\n", end1 - start1, end2 - start2);
+	
+	if (end1 > start1 && end2 > start2)
+	{
+		printf("Glyphs/sec: per-char=%lu, row-at-a-time=%lu\n", num_glyphs * SYS_TICKS_PER_SEC / (end1 - start1), num_glyphs * SYS_TICKS_PER_SEC / (end2 - start2));
+	}
+	
+	Bitmap_Destroy(&the_bitmap);
+}
+
+
 MU_TEST(test_speed_1)
 {
 	long start1;
@@ -128,6 +393,8 @@ MU_TEST_SUITE(test_suite_speed)
 {	
 	MU_SUITE_CONFIGURE(&test_setup, &test_teardown);
 	
+	MU_RUN_TEST(test_speed_1_glyph_cache);
+	MU_RUN_TEST(test_speed_2_draw_string);
 // 	MU_RUN_TEST(test_speed_1);
 }
 
@@ -137,6 +404,8 @@ MU_TEST_SUITE(test_suite_units)
 {	
 	MU_SUITE_CONFIGURE(&test_setup, &test_teardown);
 	
+	MU_RUN_TEST(test_glyph_cache_matches_uncached);
+	MU_RUN_TEST(test_draw_string_matches_draw_char);
 // 	MU_RUN_TEST(font_replace_test);
 }
 
@@ -176,7 +445,7 @@ int main(int argc, char* argv[])
 
 
 	MU_RUN_SUITE(test_suite_units);
-// 	MU_RUN_SUITE(test_suite_speed);
+	MU_RUN_SUITE(test_suite_speed);
 	MU_REPORT();
 
 	Sys_SetModeText(global_system, false);
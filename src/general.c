@@ -971,11 +971,11 @@ bool General_ExtractCoreFilename(const char* the_file_name, char* the_core_part)
 void General_DelayTicks(int32_t ticks)
 {
 	long	start_ticks = sys_time_jiffies();
-	long	now_ticks = start_ticks;
 	
-	while ((now_ticks - start_ticks) < ticks)
+	// LOGIC: the jiffy count only changes in an interrupt, so there is no point asking for it again until one has happened
+	while ((sys_time_jiffies() - start_ticks) < ticks)
 	{
-		now_ticks = sys_time_jiffies();
+		CPU_WAIT_FOR_INTERRUPT();
 	}
 }
 
@@ -984,13 +984,7 @@ void General_DelayTicks(int32_t ticks)
 //! In multi-tasking ever becomes a thing, this is not a multi-tasking-friendly operation. 
 void General_DelaySeconds(uint16_t seconds)
 {
-	long	start_ticks = sys_time_jiffies();
-	long	now_ticks = start_ticks;
-	
-	while ((now_ticks - start_ticks) / SYS_TICKS_PER_SEC < seconds)
-	{
-		now_ticks = sys_time_jiffies();
-	}
+	General_DelayTicks((int32_t)seconds * SYS_TICKS_PER_SEC);
 }
 
 
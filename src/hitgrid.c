@@ -0,0 +1,352 @@
+/*
+ * hitgrid.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: agent
+ */
+
+
+
+
+
+/*****************************************************************************/
+/*                                Includes                                   */
+/*****************************************************************************/
+
+// project includes
+#include "debug.h"
+#include "general.h"
+#include "hitgrid.h"
+#include "window.h"
+
+// C includes
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// A2560 includes
+#include <mcp/syscalls.h>
+#include "a2560k.h"
+
+
+/*****************************************************************************/
+/*                               Definitions                                 */
+/*****************************************************************************/
+
+
+
+/*****************************************************************************/
+/*                               Enumerations                                */
+/*****************************************************************************/
+
+
+
+/*****************************************************************************/
+/*                          File-scoped Variables                            */
+/*****************************************************************************/
+
+
+
+/*****************************************************************************/
+/*                             Global Variables                              */
+/*****************************************************************************/
+
+
+
+/*****************************************************************************/
+/*                       Private Function Prototypes                         */
+/*****************************************************************************/
+
+//! Get the slot a window is in
+//! @return	Returns -1 if the window is not in the grid
+static int16_t HitGrid_FindSlot(HitGrid* the_grid, Window* the_window);
+
+//! Get the range of cells a rect overlaps, clipped to the grid
+//! @return	Returns false if the rect is entirely off the grid
+static bool HitGrid_GetCellRange(Rectangle* the_rect, int16_t* first_col, int16_t* first_row, int16_t* last_col, int16_t* last_row);
+
+//! Set or clear a slot's bit in every cell a rect overlaps
+static void HitGrid_MarkCells(HitGrid* the_grid, Rectangle* the_rect, uint32_t the_bit, bool set_it);
+
+
+/*****************************************************************************/
+/*                       Private Function Definitions                        */
+/*****************************************************************************/
+
+//! Get the slot a window is in
+//! @return	Returns -1 if the window is not in the grid
+static int16_t HitGrid_FindSlot(HitGrid* the_grid, Window* the_window)
+{
+	int16_t		i;
+
+	for (i = 0; i < HITGRID_MAX_WINDOWS; i++)
+	{
+		if (the_grid->window_[i] == the_window)
+		{
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+
+//! Get the range of cells a rect overlaps, clipped to the grid
+//! @return	Returns false if the rect is entirely off the grid
+static bool HitGrid_GetCellRange(Rectangle* the_rect, int16_t* first_col, int16_t* first_row, int16_t* last_col, int16_t* last_row)
+{
+	if (the_rect->MaxX < 0 || the_rect->MaxY < 0 || the_rect->MinX >= HITGRID_MAX_WIDTH || the_rect->MinY >= HITGRID_MAX_HEIGHT || the_rect->MaxX < the_rect->MinX || the_rect->MaxY < the_rect->MinY)
+	{
+		return false;
+	}
+
+	*first_col = (the_rect->MinX < 0) ? 0 : the_rect->MinX >> HITGRID_CELL_SHIFT;
+	*first_row = (the_rect->MinY < 0) ? 0 : the_rect->MinY >> HITGRID_CELL_SHIFT;
+	*last_col = (the_rect->MaxX >= HITGRID_MAX_WIDTH) ? HITGRID_COLS - 1 : the_rect->MaxX >> HITGRID_CELL_SHIFT;
+	*last_row = (the_rect->MaxY >= HITGRID_MAX_HEIGHT) ? HITGRID_ROWS - 1 : the_rect->MaxY >> HITGRID_CELL_SHIFT;
+
+	return true;
+}
+
+
+//! Set or clear a slot's bit in every cell a rect overlaps
+static void HitGrid_MarkCells(HitGrid* the_grid, Rectangle* the_rect, uint32_t the_bit, bool set_it)
+{
+	int16_t		first_col;
+	int16_t		first_row;
+	int16_t		last_col;
+	int16_t		last_row;
+	int16_t		col;
+	int16_t		row;
+
+	if (HitGrid_GetCellRange(the_rect, &first_col, &first_row, &last_col, &last_row) == false)
+	{
+		return;
+	}
+
+	for (row = first_row; row <= last_row; row++)
+	{
+		for (col = first_col; col <= last_col; col++)
+		{
+			if (set_it)
+			{
+				the_grid->cell_[row][col] |= the_bit;
+			}
+			else
+			{
+				the_grid->cell_[row][col] &= ~the_bit;
+			}
+		}
+	}
+}
+
+
+
+
+/*****************************************************************************/
+/*                        Public Function Definitions                        */
+/*****************************************************************************/
+
+// **** CONSTRUCTOR AND DESTRUCTOR *****
+
+// constructor
+//! Allocate an empty HitGrid object
+//! @return	Returns NULL on any error
+HitGrid* HitGrid_New(void)
+{
+	HitGrid*	the_grid;
+
+	if ( (the_grid = (HitGrid*)calloc(1, sizeof(HitGrid)) ) == NULL)
+	{
+		LOG_ERR(("%s %d: could not allocate memory to create new hit grid", __func__ , __LINE__));
+		return NULL;
+	}
+	LOG_ALLOC(("%s %d:	__ALLOC__	the_grid	%p	size	%i", __func__ , __LINE__, the_grid, sizeof(HitGrid)));
+	TRACK_ALLOC((sizeof(HitGrid)));
+
+	return the_grid;
+}
+
+
+// destructor
+// frees all allocated memory associated with the passed object, and the object itself. The windows are not touched.
+//! @param	the_grid -- pointer to the pointer for the HitGrid object to be destroyed
+//! @return	Returns false if the pointer to the passed HitGrid was NULL
+bool HitGrid_Destroy(HitGrid** the_grid)
+{
+	if (the_grid == NULL || *the_grid == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		return false;
+	}
+
+	LOG_ALLOC(("%s %d:	__FREE__	*the_grid	%p	size	%i", __func__ , __LINE__, *the_grid, sizeof(HitGrid)));
+	TRACK_ALLOC((0 - sizeof(HitGrid)));
+	free(*the_grid);
+	*the_grid = NULL;
+
+	return true;
+}
+
+
+
+
+// **** INDEX functions *****
+
+//! Add a window to the grid, at its current global rect
+//! @param	the_grid -- reference to a valid HitGrid object
+//! @param	the_window -- reference to a valid Window object
+//! @return	Returns false if the grid already holds HITGRID_MAX_WINDOWS windows
+bool HitGrid_AddWindow(HitGrid* the_grid, Window* the_window)
+{
+	int16_t		the_slot;
+
+	if (HitGrid_FindSlot(the_grid, the_window) != -1)
+	{
+		HitGrid_UpdateWindow(the_grid, the_window);
+		return true;
+	}
+
+	if ( (the_slot = HitGrid_FindSlot(the_grid, NULL)) == -1)
+	{
+		LOG_ERR(("%s %d: no room in the hit grid for another window", __func__ , __LINE__));
+		return false;
+	}
+
+	the_grid->window_[the_slot] = the_window;
+	General_CopyRect(&the_grid->rect_[the_slot], &the_window->global_rect_);
+	HitGrid_MarkCells(the_grid, &the_grid->rect_[the_slot], (uint32_t)1 << the_slot, true);
+
+	return true;
+}
+
+
+//! Take a window out of the grid. Does nothing if the window is not in the grid.
+//! @param	the_grid -- reference to a valid HitGrid object
+//! @param	the_window -- the window to remove
+void HitGrid_RemoveWindow(HitGrid* the_grid, Window* the_window)
+{
+	int16_t		the_slot;
+
+	if (the_window == NULL || (the_slot = HitGrid_FindSlot(the_grid, the_window)) == -1)
+	{
+		return;
+	}
+
+	HitGrid_MarkCells(the_grid, &the_grid->rect_[the_slot], (uint32_t)1 << the_slot, false);
+	the_grid->window_[the_slot] = NULL;
+}
+
+
+//! Re-index a window whose global rect has changed. Only the cells it left or entered are changed.
+//! @param	the_grid -- reference to a valid HitGrid object
+//! @param	the_window -- a window already in the grid
+void HitGrid_UpdateWindow(HitGrid* the_grid, Window* the_window)
+{
+	int16_t		the_slot;
+	uint32_t	the_bit;
+	int16_t		old_first_col = 0;
+	int16_t		old_first_row = 0;
+	int16_t		old_last_col = -1;
+	int16_t		old_last_row = -1;
+	int16_t		new_first_col = 0;
+	int16_t		new_first_row = 0;
+	int16_t		new_last_col = -1;
+	int16_t		new_last_row = -1;
+	int16_t		col;
+	int16_t		row;
+	bool		in_old;
+	bool		in_new;
+
+	if ( (the_slot = HitGrid_FindSlot(the_grid, the_window)) == -1)
+	{
+		LOG_ERR(("%s %d: window %p is not in the hit grid", __func__ , __LINE__, the_window));
+		return;
+	}
+
+	// LOGIC:
+	//   a small move usually leaves the window in most of the same cells. only cells in one range but not the other change.
+	//   the ranges are walked together over the box that holds both of them.
+
+	HitGrid_GetCellRange(&the_grid->rect_[the_slot], &old_first_col, &old_first_row, &old_last_col, &old_last_row);
+	General_CopyRect(&the_grid->rect_[the_slot], &the_window->global_rect_);
+	HitGrid_GetCellRange(&the_grid->rect_[the_slot], &new_first_col, &new_first_row, &new_last_col, &new_last_row);
+
+	if (old_first_col == new_first_col && old_first_row == new_first_row && old_last_col == new_last_col && old_last_row == new_last_row)
+	{
+		return;
+	}
+
+	the_bit = (uint32_t)1 << the_slot;
+
+	for (row = 0; row < HITGRID_ROWS; row++)
+	{
+		if ((row < old_first_row || row > old_last_row) && (row < new_first_row || row > new_last_row))
+		{
+			continue;
+		}
+
+		for (col = 0; col < HITGRID_COLS; col++)
+		{
+			in_old = (row >= old_first_row && row <= old_last_row && col >= old_first_col && col <= old_last_col);
+			in_new = (row >= new_first_row && row <= new_last_row && col >= new_first_col && col <= new_last_col);
+
+			if (in_new && !in_old)
+			{
+				the_grid->cell_[row][col] |= the_bit;
+			}
+			else if (in_old && !in_new)
+			{
+				the_grid->cell_[row][col] &= ~the_bit;
+			}
+		}
+	}
+}
+
+
+
+
+// **** GET functions *****
+
+//! Find the frontmost window at the passed global coordinates
+//! @param	the_grid -- reference to a valid HitGrid object
+//! @return	Returns NULL if no window is at that point, or the point is off the grid
+Window* HitGrid_GetWindowAtXY(HitGrid* the_grid, int16_t x, int16_t y)
+{
+	uint32_t	the_mask;
+	int16_t		the_slot;
+	Window*		this_window;
+	Window*		the_front_window = NULL;
+
+	the_grid->windows_tested_ = 0;
+
+	if (x < 0 || y < 0 || x >= HITGRID_MAX_WIDTH || y >= HITGRID_MAX_HEIGHT)
+	{
+		return NULL;
+	}
+
+	the_mask = the_grid->cell_[y >> HITGRID_CELL_SHIFT][x >> HITGRID_CELL_SHIFT];
+
+	for (the_slot = 0; the_mask != 0; the_slot++, the_mask >>= 1)
+	{
+		if ((the_mask & 1) == 0)
+		{
+			continue;
+		}
+
+		this_window = the_grid->window_[the_slot];
+		the_grid->windows_tested_++;
+
+		if (General_PointInRect(x, y, the_grid->rect_[the_slot]))
+		{
+			if (the_front_window == NULL || this_window->display_order_ > the_front_window->display_order_)
+			{
+				the_front_window = this_window;
+			}
+		}
+	}
+
+	return the_front_window;
+}
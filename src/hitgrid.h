@@ -0,0 +1,138 @@
+//! @file hitgrid.h
+
+/*
+ * hitgrid.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: agent
+ */
+
+#ifndef LIB_HITGRID_H_
+#define LIB_HITGRID_H_
+
+
+/* about this class: HitGrid
+ *
+ * A coarse grid over the screen that answers "which window is at this x/y?" without walking the window list.
+ * Each cell has a bit for every window whose global rect overlaps it. A hit-test looks only at the windows in one cell,
+ *   so its cost depends on how many windows overlap at that spot, not on how many windows are open.
+ * The grid knows nothing of z-order: when more than one window in the cell contains the point, the one with the highest
+ *   display order wins. So bringing a window to the front needs no update; only adding, removing, moving, or resizing one does.
+ * Each window's rect is remembered as it was indexed, so a moved window can be taken out of its old cells after its rect has changed.
+ *
+ *** things this class needs to be able to do
+ * add and remove windows
+ * re-index a window that has moved or changed size, touching only the cells it left or entered
+ * find the frontmost window at a point
+ *
+ * STRETCH GOALS
+ *
+ *
+ * SUPER STRETCH GOALS
+ *
+ *
+ */
+
+
+/*****************************************************************************/
+/*                                Includes                                   */
+/*****************************************************************************/
+
+// project includes
+#include "window.h"
+
+// C includes
+#include <stdbool.h>
+#include <stdint.h>
+
+
+// A2560 includes
+#include <mcp/syscalls.h>
+#include "a2560k.h"
+
+
+/*****************************************************************************/
+/*                            Macro Definitions                              */
+/*****************************************************************************/
+
+#define HITGRID_CELL_SHIFT		6		//!< cells are 64x64 pixels
+#define HITGRID_MAX_WIDTH		1024	//!< the grid covers the largest screen the VICKY supports, so it survives resolution changes
+#define HITGRID_MAX_HEIGHT		768
+#define HITGRID_COLS			(HITGRID_MAX_WIDTH >> HITGRID_CELL_SHIFT)
+#define HITGRID_ROWS			(HITGRID_MAX_HEIGHT >> HITGRID_CELL_SHIFT)
+#define HITGRID_MAX_WINDOWS		32		//!< each cell has a 32-bit mask: one bit per window
+
+
+/*****************************************************************************/
+/*                               Enumerations                                */
+/*****************************************************************************/
+
+
+
+/*****************************************************************************/
+/*                                 Structs                                   */
+/*****************************************************************************/
+
+struct HitGrid
+{
+	uint32_t			cell_[HITGRID_ROWS][HITGRID_COLS];	//!< for each cell, a bit for each window slot whose rect overlaps it
+	Window*				window_[HITGRID_MAX_WINDOWS];		//!< the window in each slot, or NULL
+	Rectangle			rect_[HITGRID_MAX_WINDOWS];			//!< the global rect each window was last indexed with
+	uint16_t			windows_tested_;					//!< number of windows whose rect was checked by the last hit-test
+};
+
+
+
+/*****************************************************************************/
+/*                             Global Variables                              */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*                       Public Function Prototypes                          */
+/*****************************************************************************/
+
+
+// **** CONSTRUCTOR AND DESTRUCTOR *****
+
+// constructor
+//! Allocate an empty HitGrid object
+//! @return	Returns NULL on any error
+HitGrid* HitGrid_New(void);
+
+// destructor
+// frees all allocated memory associated with the passed object, and the object itself. The windows are not touched.
+//! @param	the_grid -- pointer to the pointer for the HitGrid object to be destroyed
+//! @return	Returns false if the pointer to the passed HitGrid was NULL
+bool HitGrid_Destroy(HitGrid** the_grid);
+
+
+// **** INDEX functions *****
+
+//! Add a window to the grid, at its current global rect
+//! @param	the_grid -- reference to a valid HitGrid object
+//! @param	the_window -- reference to a valid Window object
+//! @return	Returns false if the grid already holds HITGRID_MAX_WINDOWS windows
+bool HitGrid_AddWindow(HitGrid* the_grid, Window* the_window);
+
+//! Take a window out of the grid. Does nothing if the window is not in the grid.
+//! @param	the_grid -- reference to a valid HitGrid object
+//! @param	the_window -- the window to remove
+void HitGrid_RemoveWindow(HitGrid* the_grid, Window* the_window);
+
+//! Re-index a window whose global rect has changed. Only the cells it left or entered are changed.
+//! @param	the_grid -- reference to a valid HitGrid object
+//! @param	the_window -- a window already in the grid
+void HitGrid_UpdateWindow(HitGrid* the_grid, Window* the_window);
+
+
+// **** GET functions *****
+
+//! Find the frontmost window at the passed global coordinates
+//! @param	the_grid -- reference to a valid HitGrid object
+//! @return	Returns NULL if no window is at that point, or the point is off the grid
+Window* HitGrid_GetWindowAtXY(HitGrid* the_grid, int16_t x, int16_t y);
+
+
+
+#endif /* LIB_HITGRID_H_ */
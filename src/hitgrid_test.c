@@ -0,0 +1,273 @@
+/*
+ * hitgrid_test.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: agent
+ */
+
+
+
+
+
+/*****************************************************************************/
+/*                                Includes                                   */
+/*****************************************************************************/
+
+// unit testing framework
+#include "debug.h"
+#include "minunit.h"
+
+// project includes
+#include "window.h"
+
+// class being tested
+#include "hitgrid.h"
+
+// C includes
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+
+// A2560 includes
+#include "a2560k.h"
+
+
+
+/*****************************************************************************/
+/*                               Definitions                                 */
+/*****************************************************************************/
+
+#define HITGRID_TEST_NUM_WINDOWS	HITGRID_MAX_WINDOWS
+
+
+/*****************************************************************************/
+/*                               Enumerations                                */
+/*****************************************************************************/
+
+
+
+/*****************************************************************************/
+/*                             Global Variables                              */
+/*****************************************************************************/
+
+// LOGIC: the grid only looks at a window's global rect and display order, so the tests use bare window structs rather than real windows
+static Window		test_windows[HITGRID_TEST_NUM_WINDOWS + 1];
+static HitGrid*		test_grid;
+
+
+/*****************************************************************************/
+/*                       Private Function Prototypes                         */
+/*****************************************************************************/
+
+// set a test window's global rect and display order
+Window* Test_SetWindow(int16_t the_index, int16_t x, int16_t y, int16_t width, int16_t height, int8_t display_order);
+
+
+/*****************************************************************************/
+/*                       Private Function Definitions                        */
+/*****************************************************************************/
+
+// set a test window's global rect and display order
+Window* Test_SetWindow(int16_t the_index, int16_t x, int16_t y, int16_t width, int16_t height, int8_t display_order)
+{
+	Window*		the_window = &test_windows[the_index];
+
+	the_window->global_rect_.MinX = x;
+	the_window->global_rect_.MinY = y;
+	the_window->global_rect_.MaxX = x + width - 1;
+	the_window->global_rect_.MaxY = y + height - 1;
+	the_window->display_order_ = display_order;
+
+	return the_window;
+}
+
+
+
+
+/*****************************************************************************/
+/*                        MinUnit Function Defintions                        */
+/*****************************************************************************/
+
+
+
+void test_setup(void)	// this is called EVERY test
+{
+	memset(test_windows, 0, sizeof(test_windows));
+	test_grid = HitGrid_New();
+}
+
+
+void test_teardown(void)	// this is called EVERY test
+{
+	HitGrid_Destroy(&test_grid);
+}
+
+
+
+// **** unit tests
+
+MU_TEST(hitgrid_hit_test)
+{
+	Window*		the_backdrop;
+	Window*		the_window;
+
+	mu_assert(test_grid != NULL, "could not create hit grid");
+	mu_check( HitGrid_GetWindowAtXY(test_grid, 10, 10) == NULL );
+
+	the_backdrop = Test_SetWindow(0, 0, 0, 640, 480, -127);
+	the_window = Test_SetWindow(1, 100, 50, 200, 100, 10);
+	mu_check( HitGrid_AddWindow(test_grid, the_backdrop) == true );
+	mu_check( HitGrid_AddWindow(test_grid, the_window) == true );
+
+	// edges are inclusive
+	mu_check( HitGrid_GetWindowAtXY(test_grid, 100, 50) == the_window );
+	mu_check( HitGrid_GetWindowAtXY(test_grid, 299, 149) == the_window );
+	mu_check( HitGrid_GetWindowAtXY(test_grid, 300, 149) == the_backdrop );
+	mu_check( HitGrid_GetWindowAtXY(test_grid, 99, 50) == the_backdrop );
+
+	// off the screen, there is nothing
+	mu_check( HitGrid_GetWindowAtXY(test_grid, -1, 10) == NULL );
+	mu_check( HitGrid_GetWindowAtXY(test_grid, 10, -1) == NULL );
+	mu_check( HitGrid_GetWindowAtXY(test_grid, 700, 10) == NULL );
+	mu_check( HitGrid_GetWindowAtXY(test_grid, HITGRID_MAX_WIDTH, 10) == NULL );
+
+	HitGrid_RemoveWindow(test_grid, the_window);
+	mu_check( HitGrid_GetWindowAtXY(test_grid, 150, 100) == the_backdrop );
+
+	// removing a window that isn't there does nothing
+	HitGrid_RemoveWindow(test_grid, the_window);
+	HitGrid_RemoveWindow(test_grid, NULL);
+	mu_check( HitGrid_GetWindowAtXY(test_grid, 150, 100) == the_backdrop );
+}
+
+
+MU_TEST(hitgrid_z_order_test)
+{
+	Window*		the_back_window;
+	Window*		the_front_window;
+
+	the_back_window = Test_SetWindow(0, 50, 50, 200, 200, 20);
+	the_front_window = Test_SetWindow(1, 100, 100, 200, 200, 30);
+	HitGrid_AddWindow(test_grid, the_back_window);
+	HitGrid_AddWindow(test_grid, the_front_window);
+
+	mu_check( HitGrid_GetWindowAtXY(test_grid, 150, 150) == the_front_window );
+	mu_check( HitGrid_GetWindowAtXY(test_grid, 60, 60) == the_back_window );
+	mu_check( HitGrid_GetWindowAtXY(test_grid, 290, 290) == the_front_window );
+
+	// a change of z-order needs no update to the grid
+	the_back_window->display_order_ = 31;
+	mu_check( HitGrid_GetWindowAtXY(test_grid, 150, 150) == the_back_window );
+	mu_check( HitGrid_GetWindowAtXY(test_grid, 290, 290) == the_front_window );
+}
+
+
+MU_TEST(hitgrid_move_test)
+{
+	Window*		the_window;
+	int16_t		row;
+	int16_t		col;
+	uint32_t	num_cells;
+
+	the_window = Test_SetWindow(0, 10, 10, 100, 100, 10);
+	HitGrid_AddWindow(test_grid, the_window);
+
+	// the window's rect changes before the grid hears about it: until then, the grid still finds it where it was
+	Test_SetWindow(0, 500, 300, 120, 80, 10);
+	mu_check( HitGrid_GetWindowAtXY(test_grid, 50, 50) == the_window );
+
+	HitGrid_UpdateWindow(test_grid, the_window);
+	mu_check( HitGrid_GetWindowAtXY(test_grid, 50, 50) == NULL );
+	mu_check( HitGrid_GetWindowAtXY(test_grid, 500, 300) == the_window );
+	mu_check( HitGrid_GetWindowAtXY(test_grid, 619, 379) == the_window );
+
+	// none of the cells it left still have it
+	num_cells = 0;
+
+	for (row = 0; row < HITGRID_ROWS; row++)
+	{
+		for (col = 0; col < HITGRID_COLS; col++)
+		{
+			if (test_grid->cell_[row][col] != 0)
+			{
+				num_cells++;
+			}
+		}
+	}
+
+	mu_assert_int_eq((619 / 64 - 500 / 64 + 1) * (379 / 64 - 300 / 64 + 1), num_cells);
+
+	// a small move within the same cells, and a window hanging off the edge of the grid
+	Test_SetWindow(0, 505, 305, 120, 80, 10);
+	HitGrid_UpdateWindow(test_grid, the_window);
+	mu_check( HitGrid_GetWindowAtXY(test_grid, 502, 302) == NULL );
+	mu_check( HitGrid_GetWindowAtXY(test_grid, 506, 306) == the_window );
+
+	Test_SetWindow(0, 1000, 700, 200, 200, 10);
+	HitGrid_UpdateWindow(test_grid, the_window);
+	mu_check( HitGrid_GetWindowAtXY(test_grid, HITGRID_MAX_WIDTH - 1, HITGRID_MAX_HEIGHT - 1) == the_window );
+	mu_check( HitGrid_GetWindowAtXY(test_grid, 506, 306) == NULL );
+}
+
+
+MU_TEST(hitgrid_capacity_test)
+{
+	int16_t		i;
+
+	// one window per bit in a cell's mask. the window list is capped at the same number.
+	for (i = 0; i < HITGRID_MAX_WINDOWS; i++)
+	{
+		mu_check( HitGrid_AddWindow(test_grid, Test_SetWindow(i, i * 20, 0, 30, 30, i)) == true );
+	}
+
+	mu_check( HitGrid_AddWindow(test_grid, Test_SetWindow(HITGRID_MAX_WINDOWS, 0, 0, 10, 10, 0)) == false );
+
+	// every window is still found, and a hit-test only looks at the windows near the point
+	for (i = 0; i < HITGRID_MAX_WINDOWS; i++)
+	{
+		mu_check( HitGrid_GetWindowAtXY(test_grid, i * 20 + 15, 5) == &test_windows[i] );
+		mu_check( test_grid->windows_tested_ <= 5 );
+	}
+
+	// a slot given back can be used again
+	HitGrid_RemoveWindow(test_grid, &test_windows[3]);
+	mu_check( HitGrid_AddWindow(test_grid, &test_windows[HITGRID_MAX_WINDOWS]) == true );
+	mu_check( HitGrid_GetWindowAtXY(test_grid, 5, 5) == &test_windows[0] );
+}
+
+
+
+// unit tests
+MU_TEST_SUITE(test_suite_units)
+{
+	MU_SUITE_CONFIGURE(&test_setup, &test_teardown);
+
+	MU_RUN_TEST(hitgrid_hit_test);
+	MU_RUN_TEST(hitgrid_z_order_test);
+	MU_RUN_TEST(hitgrid_move_test);
+	MU_RUN_TEST(hitgrid_capacity_test);
+}
+
+
+
+
+
+/*****************************************************************************/
+/*                        Public Function Definitions                        */
+/*****************************************************************************/
+
+
+
+int main(int argc, char* argv[])
+{
+	printf("**** hitgrid.c Test Suite **** \n");
+
+	MU_RUN_SUITE(test_suite_units);
+	MU_REPORT();
+
+	printf("hitgrid test complete \n");
+
+	return MU_EXIT_CODE;
+}
@@ -0,0 +1,761 @@
+/*
+ * inputlog.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: agent
+ */
+
+
+
+
+
+/*****************************************************************************/
+/*                                Includes                                   */
+/*****************************************************************************/
+
+// project includes
+#include "debug.h"
+#include "event.h"
+#include "inputlog.h"
+#include "sys.h"
+
+// C includes
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// A2560 includes
+#include <mcp/syscalls.h>
+#include "a2560k.h"
+
+
+/*****************************************************************************/
+/*                               Definitions                                 */
+/*****************************************************************************/
+
+
+
+/*****************************************************************************/
+/*                               Enumerations                                */
+/*****************************************************************************/
+
+
+
+/*****************************************************************************/
+/*                          File-scoped Variables                            */
+/*****************************************************************************/
+
+static uint32_t			replay_ticks;	// the event manager's clock during a replay at maximum speed
+
+
+/*****************************************************************************/
+/*                             Global Variables                              */
+/*****************************************************************************/
+
+extern System*			global_system;
+
+
+/*****************************************************************************/
+/*                       Private Function Prototypes                         */
+/*****************************************************************************/
+
+//! The default stopwatch: the MCP's jiffy count
+static uint32_t InputLog_GetJiffies(void);
+
+//! The event manager's clock during a replay at maximum speed: the tick being replayed
+static uint32_t InputLog_GetReplayTicks(void);
+
+//! Get the next record in time order, from whichever of the mouse and key lists has the earlier one
+//! @param	mouse_idx -- the next record to look at in the mouse list. Moved on if the record returned is from it.
+//! @param	key_idx -- the next record to look at in the key list. Moved on if the record returned is from it.
+//! @return	Returns NULL when both lists have been used up
+static InputRecord* InputLog_NextRecord(InputLog* the_log, uint32_t* mouse_idx, uint32_t* key_idx);
+
+//! Count the records a log will be saved as, including the ones that stand for long pauses
+static uint32_t InputLog_CountFileRecords(InputLog* the_log);
+
+//! Write an 8 byte file record, big-endian
+static bool InputLog_WriteRecord(FILE* the_file, uint8_t the_what, uint8_t the_modifiers, uint16_t the_gap, int16_t x, int16_t y);
+
+//! Add the time spent since the last mark to a subsystem's total, and move the mark on
+static void InputLog_AddTime(InputLogStats* the_stats, InputLog* the_log, replay_subsystem the_subsystem, uint32_t* the_mark);
+
+//! Check whether the mouse interrupt is on, so a replay can put it back the way it found it
+static bool InputLog_IsMouseInterruptOn(void);
+
+
+/*****************************************************************************/
+/*                       Private Function Definitions                        */
+/*****************************************************************************/
+
+//! The default stopwatch: the MCP's jiffy count
+static uint32_t InputLog_GetJiffies(void)
+{
+	return (uint32_t)sys_time_jiffies();
+}
+
+
+//! The event manager's clock during a replay at maximum speed: the tick being replayed
+static uint32_t InputLog_GetReplayTicks(void)
+{
+	return replay_ticks;
+}
+
+
+//! Check whether the mouse interrupt is on, so a replay can put it back the way it found it
+static bool InputLog_IsMouseInterruptOn(void)
+{
+	// LOGIC: the MCP can turn an interrupt on or off, but not say which it is: read GAVIN's mask for it. a set bit means it is off.
+	
+	return (NR16(GAVIN_INT_MASK_GROUP_0 + ((INT_MOUSE >> 4) * 2)) & (1 << (INT_MOUSE & 0x0F))) == 0;
+}
+
+
+//! Get the next record in time order, from whichever of the mouse and key lists has the earlier one
+//! @param	mouse_idx -- the next record to look at in the mouse list. Moved on if the record returned is from it.
+//! @param	key_idx -- the next record to look at in the key list. Moved on if the record returned is from it.
+//! @return	Returns NULL when both lists have been used up
+static InputRecord* InputLog_NextRecord(InputLog* the_log, uint32_t* mouse_idx, uint32_t* key_idx)
+{
+	// LOGIC:
+	//   each list is already in time order. when a key and a mouse record have the same time, the key goes first:
+	//     key events are posted, and the event manager hands out posted events before mouse events anyway.
+
+	if (*key_idx < the_log->num_keys_)
+	{
+		if (*mouse_idx >= the_log->num_mouse_ || the_log->keys_[*key_idx].when_ <= the_log->mouse_[*mouse_idx].when_)
+		{
+			return &the_log->keys_[(*key_idx)++];
+		}
+	}
+
+	if (*mouse_idx < the_log->num_mouse_)
+	{
+		return &the_log->mouse_[(*mouse_idx)++];
+	}
+
+	return NULL;
+}
+
+
+//! Count the records a log will be saved as, including the ones that stand for long pauses
+static uint32_t InputLog_CountFileRecords(InputLog* the_log)
+{
+	InputRecord*	the_record;
+	uint32_t		mouse_idx = 0;
+	uint32_t		key_idx = 0;
+	uint32_t		last_when = 0;
+	uint32_t		num_records = 0;
+
+	while ( (the_record = InputLog_NextRecord(the_log, &mouse_idx, &key_idx)) != NULL)
+	{
+		num_records += (the_record->when_ - last_when) / INPUTLOG_MAX_GAP + 1;
+		last_when = the_record->when_;
+	}
+
+	return num_records;
+}
+
+
+//! Write an 8 byte file record, big-endian
+static bool InputLog_WriteRecord(FILE* the_file, uint8_t the_what, uint8_t the_modifiers, uint16_t the_gap, int16_t x, int16_t y)
+{
+	uint8_t		the_bytes[INPUTLOG_FILE_RECORD_SIZE];
+
+	the_bytes[0] = the_what;
+	the_bytes[1] = the_modifiers;
+	the_bytes[2] = (uint8_t)(the_gap >> 8);
+	the_bytes[3] = (uint8_t)the_gap;
+	the_bytes[4] = (uint8_t)((uint16_t)x >> 8);
+	the_bytes[5] = (uint8_t)x;
+	the_bytes[6] = (uint8_t)((uint16_t)y >> 8);
+	the_bytes[7] = (uint8_t)y;
+
+	return (fwrite(the_bytes, INPUTLOG_FILE_RECORD_SIZE, 1, the_file) == 1);
+}
+
+
+//! Add the time spent since the last mark to a subsystem's total, and move the mark on
+static void InputLog_AddTime(InputLogStats* the_stats, InputLog* the_log, replay_subsystem the_subsystem, uint32_t* the_mark)
+{
+	uint32_t	now;
+	uint32_t	the_time;
+
+	now = (*the_log->stopwatch_)();
+	the_time = now - *the_mark;
+	*the_mark = now;
+
+	the_stats->subsystem_total_[the_subsystem] += the_time;
+
+	if (the_time > the_stats->subsystem_max_[the_subsystem])
+	{
+		the_stats->subsystem_max_[the_subsystem] = the_time;
+	}
+}
+
+
+
+
+/*****************************************************************************/
+/*                        Public Function Definitions                        */
+/*****************************************************************************/
+
+// **** CONSTRUCTOR AND DESTRUCTOR *****
+
+// constructor
+//! Allocate an empty InputLog object
+//! @param	max_records -- the number of mouse records, and the number of key records, the log can hold. Nothing is allocated while recording.
+//! @return	Returns NULL on any error
+InputLog* InputLog_New(uint32_t max_records)
+{
+	InputLog*		the_log;
+
+	if ( (the_log = (InputLog*)calloc(1, sizeof(InputLog)) ) == NULL)
+	{
+		LOG_ERR(("%s %d: could not allocate memory to create new input log", __func__ , __LINE__));
+		goto error;
+	}
+	LOG_ALLOC(("%s %d:	__ALLOC__	the_log	%p	size	%i", __func__ , __LINE__, the_log, sizeof(InputLog)));
+	TRACK_ALLOC((sizeof(InputLog)));
+
+	if (max_records == 0)
+	{
+		max_records = 1;
+	}
+
+	if ( (the_log->mouse_ = (InputRecord*)calloc(max_records, sizeof(InputRecord)) ) == NULL)
+	{
+		LOG_ERR(("%s %d: could not allocate memory for %lu mouse records", __func__ , __LINE__, max_records));
+		goto error;
+	}
+	LOG_ALLOC(("%s %d:	__ALLOC__	the_log->mouse_	%p	size	%i", __func__ , __LINE__, the_log->mouse_, max_records * sizeof(InputRecord)));
+	TRACK_ALLOC((max_records * sizeof(InputRecord)));
+
+	if ( (the_log->keys_ = (InputRecord*)calloc(max_records, sizeof(InputRecord)) ) == NULL)
+	{
+		LOG_ERR(("%s %d: could not allocate memory for %lu key records", __func__ , __LINE__, max_records));
+		goto error;
+	}
+	LOG_ALLOC(("%s %d:	__ALLOC__	the_log->keys_	%p	size	%i", __func__ , __LINE__, the_log->keys_, max_records * sizeof(InputRecord)));
+	TRACK_ALLOC((max_records * sizeof(InputRecord)));
+
+	the_log->max_records_ = max_records;
+	the_log->stopwatch_ = &InputLog_GetJiffies;
+	the_log->stopwatch_per_sec_ = SYS_TICKS_PER_SEC;
+
+	return the_log;
+
+error:
+	if (the_log)		InputLog_Destroy(&the_log);
+	return NULL;
+}
+
+
+// destructor
+// frees all allocated memory associated with the passed object, and the object itself
+//! @param	the_log -- pointer to the pointer for the InputLog object to be destroyed
+//! @return	Returns false if the pointer to the passed InputLog was NULL
+bool InputLog_Destroy(InputLog** the_log)
+{
+	if (the_log == NULL || *the_log == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		return false;
+	}
+
+	if ((*the_log)->mouse_ != NULL)
+	{
+		LOG_ALLOC(("%s %d:	__FREE__	(*the_log)->mouse_	%p	size	%i", __func__ , __LINE__, (*the_log)->mouse_, (*the_log)->max_records_ * sizeof(InputRecord)));
+		TRACK_ALLOC((0 - (*the_log)->max_records_ * sizeof(InputRecord)));
+		free((*the_log)->mouse_);
+	}
+
+	if ((*the_log)->keys_ != NULL)
+	{
+		LOG_ALLOC(("%s %d:	__FREE__	(*the_log)->keys_	%p	size	%i", __func__ , __LINE__, (*the_log)->keys_, (*the_log)->max_records_ * sizeof(InputRecord)));
+		TRACK_ALLOC((0 - (*the_log)->max_records_ * sizeof(InputRecord)));
+		free((*the_log)->keys_);
+	}
+
+	LOG_ALLOC(("%s %d:	__FREE__	*the_log	%p	size	%i", __func__ , __LINE__, *the_log, sizeof(InputLog)));
+	TRACK_ALLOC((0 - sizeof(InputLog)));
+	free(*the_log);
+	*the_log = NULL;
+
+	return true;
+}
+
+
+
+
+// **** RECORDING functions *****
+
+//! Empty the log and start its clock. EventManager_SetRecorder() calls this.
+//! @param	the_log -- reference to a valid InputLog object
+//! @param	now -- the event manager's time in ticks
+void InputLog_Begin(InputLog* the_log, uint32_t now)
+{
+	the_log->num_mouse_ = 0;
+	the_log->num_keys_ = 0;
+	the_log->num_lost_ = 0;
+	the_log->start_ticks_ = now;
+}
+
+
+//! Record a mouse packet. Called from the mouse interrupt: nothing is allocated, and nothing printed.
+//! @param	the_log -- reference to a valid InputLog object
+//! @param	now -- the event manager's time in ticks
+//! @param	the_what -- mouseDown to mouseMoved
+//! @param	x -- Global horizontal position of the mouse
+//! @param	y -- Global vertical position of the mouse
+void InputLog_AddMouse(InputLog* the_log, uint32_t now, event_kind the_what, int16_t x, int16_t y)
+{
+	InputRecord*	the_record;
+	uint32_t		the_idx;
+
+	the_idx = the_log->num_mouse_;
+
+	if (the_idx >= the_log->max_records_)
+	{
+		the_log->num_lost_++;
+		return;
+	}
+
+	the_record = &the_log->mouse_[the_idx];
+	the_record->when_ = now - the_log->start_ticks_;
+	the_record->what_ = the_what;
+	the_record->modifiers_ = 0;
+	the_record->x_ = x;
+	the_record->y_ = y;
+
+	// only counted once it is all there
+	the_log->num_mouse_ = the_idx + 1;
+}
+
+
+//! Record a key press or release. Called from the main loop.
+//! @param	the_log -- reference to a valid InputLog object
+//! @param	now -- the event manager's time in ticks
+//! @param	the_what -- keyDown, keyUp, or autoKey
+void InputLog_AddKey(InputLog* the_log, uint32_t now, event_kind the_what, uint8_t the_key, uint8_t the_char, uint8_t the_modifiers)
+{
+	InputRecord*	the_record;
+	uint32_t		the_idx;
+
+	the_idx = the_log->num_keys_;
+
+	if (the_idx >= the_log->max_records_)
+	{
+		the_log->num_lost_++;
+		return;
+	}
+
+	the_record = &the_log->keys_[the_idx];
+	the_record->when_ = now - the_log->start_ticks_;
+	the_record->what_ = the_what;
+	the_record->modifiers_ = the_modifiers;
+	the_record->x_ = the_key;
+	the_record->y_ = the_char;
+
+	the_log->num_keys_ = the_idx + 1;
+}
+
+
+//! Get the number of input records in the log, mouse and key together
+uint32_t InputLog_GetCount(InputLog* the_log)
+{
+	return the_log->num_mouse_ + the_log->num_keys_;
+}
+
+
+//! Get the number of input records lost because the log was full
+uint32_t InputLog_GetLostCount(InputLog* the_log)
+{
+	return the_log->num_lost_;
+}
+
+
+
+
+// **** FILE functions *****
+
+//! Save the log to a file
+//! @param	the_log -- reference to a valid InputLog object. Don't save a log while it is recording.
+//! @param	the_file_path -- path of the file to create
+//! @return	Returns false if the file could not be written
+bool InputLog_Save(InputLog* the_log, const char* the_file_path)
+{
+	FILE*			the_file;
+	InputRecord*	the_record;
+	uint8_t			the_header[INPUTLOG_FILE_HEADER_SIZE];
+	uint32_t		num_records;
+	uint32_t		mouse_idx = 0;
+	uint32_t		key_idx = 0;
+	uint32_t		last_when = 0;
+	uint32_t		the_gap;
+
+	// LOGIC:
+	//   the mouse and key lists are saved as one list, in time order. a record stores the ticks since the one before, in 16 bits:
+	//     a longer pause is saved as nullEvent records, each standing for INPUTLOG_MAX_GAP ticks, so a record is 8 bytes however long the log.
+	//   every value is written a byte at a time, high byte first, so the file reads the same on any machine.
+
+	if ( (the_file = fopen(the_file_path, "wb")) == NULL)
+	{
+		LOG_ERR(("%s %d: could not open '%s' for writing", __func__ , __LINE__, the_file_path));
+		return false;
+	}
+
+	num_records = InputLog_CountFileRecords(the_log);
+
+	memcpy(the_header, INPUTLOG_FILE_ID, 4);
+	the_header[4] = 0;
+	the_header[5] = INPUTLOG_FILE_VERSION;
+	the_header[6] = 0;
+	the_header[7] = 0;
+	the_header[8] = (uint8_t)(num_records >> 24);
+	the_header[9] = (uint8_t)(num_records >> 16);
+	the_header[10] = (uint8_t)(num_records >> 8);
+	the_header[11] = (uint8_t)num_records;
+
+	if (fwrite(the_header, INPUTLOG_FILE_HEADER_SIZE, 1, the_file) != 1)
+	{
+		goto error;
+	}
+
+	while ( (the_record = InputLog_NextRecord(the_log, &mouse_idx, &key_idx)) != NULL)
+	{
+		the_gap = the_record->when_ - last_when;
+		last_when = the_record->when_;
+
+		while (the_gap > INPUTLOG_MAX_GAP)
+		{
+			if (InputLog_WriteRecord(the_file, nullEvent, 0, INPUTLOG_MAX_GAP, 0, 0) == false)
+			{
+				goto error;
+			}
+
+			the_gap -= INPUTLOG_MAX_GAP;
+		}
+
+		if (InputLog_WriteRecord(the_file, the_record->what_, the_record->modifiers_, (uint16_t)the_gap, the_record->x_, the_record->y_) == false)
+		{
+			goto error;
+		}
+	}
+
+	if (fclose(the_file) != 0)
+	{
+		LOG_ERR(("%s %d: could not finish writing '%s'", __func__ , __LINE__, the_file_path));
+		return false;
+	}
+
+	return true;
+
+error:
+	LOG_ERR(("%s %d: could not write to '%s'", __func__ , __LINE__, the_file_path));
+	fclose(the_file);
+	return false;
+}
+
+
+//! Load a log saved with InputLog_Save()
+//! @param	the_file_path -- path of the file to read
+//! @return	Returns a new InputLog object, or NULL if the file could not be read or is not a log
+InputLog* InputLog_Load(const char* the_file_path)
+{
+	FILE*			the_file;
+	InputLog*		the_log = NULL;
+	InputRecord*	the_record;
+	uint8_t			the_bytes[INPUTLOG_FILE_HEADER_SIZE];
+	uint32_t		num_records;
+	uint32_t		i;
+	uint32_t		the_when = 0;
+
+	if ( (the_file = fopen(the_file_path, "rb")) == NULL)
+	{
+		LOG_ERR(("%s %d: could not open '%s'", __func__ , __LINE__, the_file_path));
+		return NULL;
+	}
+
+	if (fread(the_bytes, INPUTLOG_FILE_HEADER_SIZE, 1, the_file) != 1 || memcmp(the_bytes, INPUTLOG_FILE_ID, 4) != 0)
+	{
+		LOG_ERR(("%s %d: '%s' is not an input log", __func__ , __LINE__, the_file_path));
+		goto error;
+	}
+
+	if (((uint16_t)the_bytes[4] << 8 | the_bytes[5]) != INPUTLOG_FILE_VERSION)
+	{
+		LOG_ERR(("%s %d: '%s' is an input log of a version this can't read", __func__ , __LINE__, the_file_path));
+		goto error;
+	}
+
+	num_records = (uint32_t)the_bytes[8] << 24 | (uint32_t)the_bytes[9] << 16 | (uint32_t)the_bytes[10] << 8 | the_bytes[11];
+
+	// LOGIC: the file doesn't say how the records split between mouse and keys: either list may need room for all of them
+	if ( (the_log = InputLog_New(num_records)) == NULL)
+	{
+		goto error;
+	}
+
+	for (i = 0; i < num_records; i++)
+	{
+		if (fread(the_bytes, INPUTLOG_FILE_RECORD_SIZE, 1, the_file) != 1)
+		{
+			LOG_ERR(("%s %d: '%s' ended after %lu of %lu records", __func__ , __LINE__, the_file_path, i, num_records));
+			goto error;
+		}
+
+		the_when += (uint16_t)the_bytes[2] << 8 | the_bytes[3];
+
+		if (the_bytes[0] == nullEvent)
+		{
+			continue;
+		}
+		else if (the_bytes[0] >= mouseDown && the_bytes[0] <= mouseMoved)
+		{
+			the_record = &the_log->mouse_[the_log->num_mouse_++];
+		}
+		else if (the_bytes[0] >= keyDown && the_bytes[0] <= autoKey)
+		{
+			the_record = &the_log->keys_[the_log->num_keys_++];
+		}
+		else
+		{
+			LOG_ERR(("%s %d: record %lu of '%s' is not mouse or key input (%u)", __func__ , __LINE__, i, the_file_path, the_bytes[0]));
+			goto error;
+		}
+
+		the_record->when_ = the_when;
+		the_record->what_ = the_bytes[0];
+		the_record->modifiers_ = the_bytes[1];
+		the_record->x_ = (int16_t)((uint16_t)the_bytes[4] << 8 | the_bytes[5]);
+		the_record->y_ = (int16_t)((uint16_t)the_bytes[6] << 8 | the_bytes[7]);
+	}
+
+	fclose(the_file);
+
+	return the_log;
+
+error:
+	if (the_log)		InputLog_Destroy(&the_log);
+	fclose(the_file);
+	return NULL;
+}
+
+
+
+
+// **** REPLAY functions *****
+
+//! Set what the time spent replaying is measured with
+//! @param	the_log -- reference to a valid InputLog object
+//! @param	the_stopwatch -- function returning a count that goes up at a steady rate. NULL for the jiffy count.
+//! @param	units_per_sec -- how fast the count goes up
+void InputLog_SetStopwatch(InputLog* the_log, uint32_t (*the_stopwatch)(void), uint32_t units_per_sec)
+{
+	if (the_stopwatch == NULL)
+	{
+		the_log->stopwatch_ = &InputLog_GetJiffies;
+		the_log->stopwatch_per_sec_ = SYS_TICKS_PER_SEC;
+	}
+	else
+	{
+		the_log->stopwatch_ = the_stopwatch;
+		the_log->stopwatch_per_sec_ = units_per_sec;
+	}
+}
+
+
+//! Replay the log: feed its input to the event manager, tick by tick, and handle and render the events that result
+//! Any recording is stopped first. After a replay at maximum speed, the event manager's clock is the jiffy count again.
+//! @param	the_log -- reference to a valid InputLog object
+//! @param	the_speed -- REPLAY_ORIGINAL_SPEED or REPLAY_MAX_SPEED
+//! @param	the_handler -- function to hand each event to. NULL for the normal handling, as EventManager_WaitForEvent() would.
+//! @param	the_stats -- receives the timings for the replay. Can be NULL.
+//! @return	Returns false if the log could not be replayed
+bool InputLog_Replay(InputLog* the_log, replay_speed the_speed, void (*the_handler)(EventRecord*), InputLogStats* the_stats)
+{
+	InputLogStats	local_stats;
+	InputRecord*	the_record;
+	EventRecord*	the_event;
+	uint32_t		mouse_idx = 0;
+	uint32_t		key_idx = 0;
+	uint32_t		the_tick;
+	uint32_t		last_tick = 0;
+	uint32_t		start_ticks;
+	uint32_t		frame_start;
+	uint32_t		the_mark;
+	uint32_t		frame_time;
+	uint32_t		frame_budget;
+	bool			mouse_was_on;
+
+	// LOGIC:
+	//   live input must not mix with the log's: any recording is stopped, and the mouse interrupt is off until the replay is done.
+	//   each tick of the log is run as the event loop would run it: add the input for the tick, run timers, handle every event, render.
+	//   each step is timed separately. input is added through the same functions the interrupt and the main loop use, so it is
+	//     filtered and coalesced just as it was when recorded.
+	//   at maximum speed, the event manager's clock is the tick being replayed, so timers fire at the same ticks as when recorded.
+
+	if (the_log == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		return false;
+	}
+
+	if (the_stats == NULL)
+	{
+		the_stats = &local_stats;
+	}
+
+	memset(the_stats, 0, sizeof(InputLogStats));
+	the_stats->units_per_sec_ = the_log->stopwatch_per_sec_;
+	the_stats->frame_min_ = 0xFFFFFFFF;
+	frame_budget = the_log->stopwatch_per_sec_ / SYS_TICKS_PER_SEC;
+
+	EventManager_SetRecorder(NULL);
+
+	mouse_was_on = InputLog_IsMouseInterruptOn();
+	sys_int_disable(INT_MOUSE);
+
+	if (the_log->num_mouse_ > 0)
+	{
+		last_tick = the_log->mouse_[the_log->num_mouse_ - 1].when_;
+	}
+
+	if (the_log->num_keys_ > 0 && the_log->keys_[the_log->num_keys_ - 1].when_ > last_tick)
+	{
+		last_tick = the_log->keys_[the_log->num_keys_ - 1].when_;
+	}
+
+	if (the_speed == REPLAY_MAX_SPEED)
+	{
+		replay_ticks = 0;
+		EventManager_SetClock(&InputLog_GetReplayTicks);
+	}
+
+	start_ticks = EventManager_GetTicks();
+	the_record = InputLog_NextRecord(the_log, &mouse_idx, &key_idx);
+
+	for (the_tick = 0; the_tick <= last_tick; the_tick++)
+	{
+		if (the_speed == REPLAY_MAX_SPEED)
+		{
+			replay_ticks = the_tick;
+		}
+		else
+		{
+			while (EventManager_GetTicks() - start_ticks < the_tick)
+			{
+				Sys_WaitForInterrupt(global_system);
+			}
+		}
+
+		frame_start = (*the_log->stopwatch_)();
+		the_mark = frame_start;
+
+		while (the_record != NULL && the_record->when_ == the_tick)
+		{
+			if (the_record->what_ >= keyDown && the_record->what_ <= autoKey)
+			{
+				EventManager_AddKeyEvent(the_record->what_, (uint8_t)the_record->x_, (uint8_t)the_record->y_, the_record->modifiers_, NULL);
+			}
+			else
+			{
+				EventManager_AddMouseEventAt(the_record->what_, the_record->x_, the_record->y_, NULL);
+			}
+
+			the_record = InputLog_NextRecord(the_log, &mouse_idx, &key_idx);
+		}
+
+		InputLog_AddTime(the_stats, the_log, REPLAY_TIME_INPUT, &the_mark);
+
+		EventManager_RunTimers();
+		InputLog_AddTime(the_stats, the_log, REPLAY_TIME_TIMERS, &the_mark);
+
+		while ( (the_event = EventManager_NextEvent()) != NULL)
+		{
+			if (the_handler != NULL)
+			{
+				(*the_handler)(the_event);
+			}
+			else
+			{
+				EventManager_DispatchEvent(the_event);
+			}
+
+			the_stats->events_++;
+		}
+
+		InputLog_AddTime(the_stats, the_log, REPLAY_TIME_EVENTS, &the_mark);
+
+		if (global_system->render_pending_)
+		{
+			Sys_Render(global_system);
+			the_stats->frames_rendered_++;
+		}
+
+		InputLog_AddTime(the_stats, the_log, REPLAY_TIME_RENDER, &the_mark);
+
+		frame_time = the_mark - frame_start;
+		the_stats->frames_++;
+		the_stats->frame_total_ += frame_time;
+
+		if (frame_time < the_stats->frame_min_)
+		{
+			the_stats->frame_min_ = frame_time;
+		}
+
+		if (frame_time > the_stats->frame_max_)
+		{
+			the_stats->frame_max_ = frame_time;
+		}
+
+		if (frame_time > frame_budget)
+		{
+			the_stats->frames_over_budget_++;
+		}
+	}
+
+	if (the_speed == REPLAY_MAX_SPEED)
+	{
+		EventManager_SetClock(NULL);
+	}
+
+	if (mouse_was_on)
+	{
+		// a packet that came in during the replay is stale now
+		sys_int_clear(INT_MOUSE);
+		sys_int_enable(INT_MOUSE);
+	}
+
+	if (the_stats->frames_ == 0)
+	{
+		the_stats->frame_min_ = 0;
+	}
+
+	return true;
+}
+
+
+
+
+// **** Debug functions *****
+
+void InputLog_PrintStats(InputLogStats* the_stats)
+{
+	static const char*	subsystem_names[REPLAY_NUM_SUBSYSTEMS] = {"input", "timers", "events", "render"};
+	int16_t				i;
+
+	DEBUG_OUT(("InputLogStats print out: (%p)", the_stats));
+	DEBUG_OUT(("  units_per_sec_: %lu", the_stats->units_per_sec_));
+	DEBUG_OUT(("  frames_: %lu (rendered %lu, over budget %lu)", the_stats->frames_, the_stats->frames_rendered_, the_stats->frames_over_budget_));
+	DEBUG_OUT(("  events_: %lu", the_stats->events_));
+	DEBUG_OUT(("  frame min,max,total: %lu, %lu, %lu", the_stats->frame_min_, the_stats->frame_max_, the_stats->frame_total_));
+
+	for (i = 0; i < REPLAY_NUM_SUBSYSTEMS; i++)
+	{
+		DEBUG_OUT(("  %s total,max: %lu, %lu", subsystem_names[i], the_stats->subsystem_total_[i], the_stats->subsystem_max_[i]));
+	}
+}
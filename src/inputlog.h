@@ -0,0 +1,233 @@
+//! @file inputlog.h
+
+/*
+ * inputlog.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: agent
+ */
+
+#ifndef LIB_INPUTLOG_H_
+#define LIB_INPUTLOG_H_
+
+
+/* about this class: InputLog
+ *
+ * Records raw input (mouse packets and key presses) as it reaches the event manager, and plays it back later.
+ * What is recorded is only what reaches EventManager_AddMouseEvent(), EventManager_AddMouseEventAt(), and EventManager_AddKeyEvent():
+ *   nothing reads the keyboard into key events yet, so a recording of a live session has no keys. and until the mouse position can be
+ *   read from VICKY, EventManager_AddMouseEvent() gives every live mouse event the same placeholder position.
+ *   So for now, useful logs are synthetic ones: built by calling those functions (or InputLog_AddMouse/InputLog_AddKey) with real positions and keys.
+ * Playing back the same log gives the same events at the same ticks every time, so it can be used as a benchmark:
+ *   record "drag 5 windows around for 30 seconds" once, then replay it against each change to the compositor and compare the timings.
+ * Recording: pass the log to EventManager_SetRecorder(). Input is recorded before it is filtered or coalesced, so nothing is lost.
+ *   Mouse input may be recorded from the mouse interrupt, keys from the main loop. Each has its own list in the log, so neither has
+ *   to turn the other off: every list has only one writer. Records are kept in memory, up to the number the log was created for.
+ * Replay: the log's input is fed back to the event manager one tick at a time, and the resulting events handled and rendered.
+ *   Any recording is stopped first, and the mouse interrupt is turned off while replaying, so live input doesn't mix with the log's.
+ *   At maximum speed, the event manager's clock is replaced with the log's, so timers and event times are the same as when recorded,
+ *   however long each tick actually takes. At original speed, each tick waits for the real clock.
+ *   While replaying, time spent on each part of a tick is measured with the log's stopwatch: by default that is the jiffy count, which
+ *   is too coarse to time a single tick. Benchmarks should pass a finer one (a hardware timer, or clock() on a host build).
+ * Saved logs are big-endian whatever the machine, so a log recorded on an A2560 can be replayed on a host build, and the other way round.
+ *
+ *** things this class needs to be able to do
+ * record timestamped mouse and key input from the event manager, from interrupt and main loop
+ * save a log to disk compactly, and load it back
+ * replay a log at its original speed, or as fast as possible
+ * time each replayed tick, overall and for each subsystem
+ *
+ * STRETCH GOALS
+ * record a checksum of the screen at intervals, so a replay can check it draws the same thing
+ *
+ * SUPER STRETCH GOALS
+ *
+ *
+ */
+
+
+/*****************************************************************************/
+/*                                Includes                                   */
+/*****************************************************************************/
+
+// project includes
+#include "event.h"
+
+// C includes
+#include <stdbool.h>
+#include <stdint.h>
+
+
+// A2560 includes
+#include <mcp/syscalls.h>
+#include "a2560k.h"
+
+
+/*****************************************************************************/
+/*                            Macro Definitions                              */
+/*****************************************************************************/
+
+#define INPUTLOG_FILE_ID			"OSFI"		//!< first 4 bytes of a saved log
+#define INPUTLOG_FILE_VERSION		1
+#define INPUTLOG_FILE_HEADER_SIZE	12			//!< file ID, version (2 bytes), 2 reserved bytes, number of records (4 bytes)
+#define INPUTLOG_FILE_RECORD_SIZE	8			//!< event kind, modifiers, ticks since the previous record (2 bytes), x or key (2 bytes), y or char (2 bytes)
+
+#define INPUTLOG_MAX_GAP			0xFFFF		//!< most ticks between 2 records in a file: a longer pause is saved as nullEvent records of this length
+
+
+/*****************************************************************************/
+/*                               Enumerations                                */
+/*****************************************************************************/
+
+typedef enum replay_speed
+{
+	REPLAY_ORIGINAL_SPEED	= 0,	// each tick of the log waits for a tick of the real clock
+	REPLAY_MAX_SPEED		= 1,	// each tick of the log is run as soon as the last one is done
+} replay_speed;
+
+
+typedef enum replay_subsystem
+{
+	REPLAY_TIME_INPUT		= 0,	// adding the tick's input to the event queues
+	REPLAY_TIME_TIMERS		= 1,	// running timers due this tick
+	REPLAY_TIME_EVENTS		= 2,	// handling events: hit-testing, menus, window event handlers
+	REPLAY_TIME_RENDER		= 3,	// rendering windows to the screen
+	REPLAY_NUM_SUBSYSTEMS	= 4,
+} replay_subsystem;
+
+
+/*****************************************************************************/
+/*                                 Structs                                   */
+/*****************************************************************************/
+
+struct InputRecord
+{
+	uint32_t			when_;			//!< ticks since recording started
+	uint8_t				what_;			//!< event_kind: mouseDown to mouseMoved, or keyDown to autoKey
+	uint8_t				modifiers_;		//!< for key events: the modifier flags
+	int16_t				x_;				//!< for mouse events: the global x position. for key events: the key code.
+	int16_t				y_;				//!< for mouse events: the global y position. for key events: the character code.
+};
+
+struct InputLogStats
+{
+	uint32_t			units_per_sec_;		//!< stopwatch units per second, for all the times below
+	uint32_t			frames_;			//!< number of ticks replayed
+	uint32_t			frames_rendered_;	//!< number of ticks in which there was anything to render
+	uint32_t			frames_over_budget_;	//!< number of ticks that took longer than a tick of real time
+	uint32_t			events_;			//!< number of events handled
+	uint32_t			frame_min_;			//!< shortest tick
+	uint32_t			frame_max_;			//!< longest tick
+	uint32_t			frame_total_;		//!< all the ticks together
+	uint32_t			subsystem_total_[REPLAY_NUM_SUBSYSTEMS];	//!< time in each subsystem over all the ticks
+	uint32_t			subsystem_max_[REPLAY_NUM_SUBSYSTEMS];		//!< longest time in each subsystem in one tick
+};
+
+struct InputLog
+{
+	InputRecord*		mouse_;				//!< mouse input, in the order it arrived. Only the mouse interrupt adds to it.
+	InputRecord*		keys_;				//!< key input, in the order it arrived. Only the main loop adds to it.
+	uint32_t			max_records_;		//!< size of each list
+	volatile uint32_t	num_mouse_;			//!< number of records in mouse_. Changed with a single write, after the record is complete.
+	volatile uint32_t	num_keys_;			//!< number of records in keys_
+	volatile uint32_t	num_lost_;			//!< input not recorded because its list was full
+	uint32_t			start_ticks_;		//!< clock time recording started at
+	uint32_t			(*stopwatch_)(void);	//!< measures time for replay statistics
+	uint32_t			stopwatch_per_sec_;	//!< stopwatch units per second
+};
+
+
+
+/*****************************************************************************/
+/*                             Global Variables                              */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*                       Public Function Prototypes                          */
+/*****************************************************************************/
+
+
+// **** CONSTRUCTOR AND DESTRUCTOR *****
+
+// constructor
+//! Allocate an empty InputLog object
+//! @param	max_records -- the number of mouse records, and the number of key records, the log can hold. Nothing is allocated while recording.
+//! @return	Returns NULL on any error
+InputLog* InputLog_New(uint32_t max_records);
+
+// destructor
+// frees all allocated memory associated with the passed object, and the object itself
+//! @param	the_log -- pointer to the pointer for the InputLog object to be destroyed
+//! @return	Returns false if the pointer to the passed InputLog was NULL
+bool InputLog_Destroy(InputLog** the_log);
+
+
+// **** RECORDING functions *****
+
+//! Empty the log and start its clock. EventManager_SetRecorder() calls this.
+//! @param	the_log -- reference to a valid InputLog object
+//! @param	now -- the event manager's time in ticks
+void InputLog_Begin(InputLog* the_log, uint32_t now);
+
+//! Record a mouse packet. Called from the mouse interrupt: nothing is allocated, and nothing printed.
+//! @param	the_log -- reference to a valid InputLog object
+//! @param	now -- the event manager's time in ticks
+//! @param	the_what -- mouseDown to mouseMoved
+//! @param	x -- Global horizontal position of the mouse
+//! @param	y -- Global vertical position of the mouse
+void InputLog_AddMouse(InputLog* the_log, uint32_t now, event_kind the_what, int16_t x, int16_t y);
+
+//! Record a key press or release. Called from the main loop.
+//! @param	the_log -- reference to a valid InputLog object
+//! @param	now -- the event manager's time in ticks
+//! @param	the_what -- keyDown, keyUp, or autoKey
+void InputLog_AddKey(InputLog* the_log, uint32_t now, event_kind the_what, uint8_t the_key, uint8_t the_char, uint8_t the_modifiers);
+
+//! Get the number of input records in the log, mouse and key together
+uint32_t InputLog_GetCount(InputLog* the_log);
+
+//! Get the number of input records lost because the log was full
+uint32_t InputLog_GetLostCount(InputLog* the_log);
+
+
+// **** FILE functions *****
+
+//! Save the log to a file
+//! @param	the_log -- reference to a valid InputLog object. Don't save a log while it is recording.
+//! @param	the_file_path -- path of the file to create
+//! @return	Returns false if the file could not be written
+bool InputLog_Save(InputLog* the_log, const char* the_file_path);
+
+//! Load a log saved with InputLog_Save()
+//! @param	the_file_path -- path of the file to read
+//! @return	Returns a new InputLog object, or NULL if the file could not be read or is not a log
+InputLog* InputLog_Load(const char* the_file_path);
+
+
+// **** REPLAY functions *****
+
+//! Set what the time spent replaying is measured with
+//! @param	the_log -- reference to a valid InputLog object
+//! @param	the_stopwatch -- function returning a count that goes up at a steady rate. NULL for the jiffy count.
+//! @param	units_per_sec -- how fast the count goes up
+void InputLog_SetStopwatch(InputLog* the_log, uint32_t (*the_stopwatch)(void), uint32_t units_per_sec);
+
+//! Replay the log: feed its input to the event manager, tick by tick, and handle and render the events that result
+//! Any recording is stopped first. The mouse interrupt is off during the replay, and turned back on after if it was on before.
+//! After a replay at maximum speed, the event manager's clock is the jiffy count again.
+//! @param	the_log -- reference to a valid InputLog object
+//! @param	the_speed -- REPLAY_ORIGINAL_SPEED or REPLAY_MAX_SPEED
+//! @param	the_handler -- function to hand each event to. NULL for the normal handling, as EventManager_WaitForEvent() would.
+//! @param	the_stats -- receives the timings for the replay. Can be NULL.
+//! @return	Returns false if the log could not be replayed
+bool InputLog_Replay(InputLog* the_log, replay_speed the_speed, void (*the_handler)(EventRecord*), InputLogStats* the_stats);
+
+
+// **** Debug functions *****
+
+void InputLog_PrintStats(InputLogStats* the_stats);
+
+
+
+#endif /* LIB_INPUTLOG_H_ */
@@ -0,0 +1,384 @@
+/*
+ * inputlog_test.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: agent
+ */
+
+
+
+
+
+/*****************************************************************************/
+/*                                Includes                                   */
+/*****************************************************************************/
+
+// unit testing framework
+#include "debug.h"
+#include "minunit.h"
+
+// project includes
+#include "event.h"
+#include "sys.h"
+#include "window.h"
+
+// class being tested
+#include "inputlog.h"
+
+// C includes
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+
+// A2560 includes
+#include "a2560k.h"
+#include <mcp/syscalls.h>
+#include <mcp/interrupt.h>
+
+
+
+/*****************************************************************************/
+/*                               Definitions                                 */
+/*****************************************************************************/
+
+#define INPUTLOG_TEST_FILE			"/sd/inputlog_test.bin"
+#define INPUTLOG_TEST_MAX_HANDLED	32
+#define INPUTLOG_TEST_STOPWATCH_HZ	6000		// stand-in stopwatch units per second: a tick's budget is 100 units
+
+
+/*****************************************************************************/
+/*                               Enumerations                                */
+/*****************************************************************************/
+
+
+
+/*****************************************************************************/
+/*                             Global Variables                              */
+/*****************************************************************************/
+
+System*			global_system;
+
+static Window		test_window;	// only its address and event mask are used, to tag events
+
+static uint32_t		test_ticks;		// stand-in clock for recording
+static uint32_t		test_stopwatch;	// stand-in stopwatch for replay: goes up by 1 each time it is read
+
+// the events handed out by a replay, in order
+static EventRecord	handled_events[INPUTLOG_TEST_MAX_HANDLED];
+static uint16_t		num_handled;
+
+
+/*****************************************************************************/
+/*                       Private Function Prototypes                         */
+/*****************************************************************************/
+
+// stand-in clock: time only moves when the test says so
+uint32_t Test_GetTicks(void);
+
+// stand-in stopwatch: every step of a replayed tick takes exactly 1 unit
+uint32_t Test_GetStopwatch(void);
+
+// replay event handler: keep a copy of each event
+void Test_HandleEvent(EventRecord* the_event);
+
+// record a short session: a click and a drag, with a key press in the middle, and a long pause before the last move
+void Test_RecordSession(InputLog* the_log);
+
+// empty the event queues
+void Test_DrainEvents(void);
+
+
+/*****************************************************************************/
+/*                       Private Function Definitions                        */
+/*****************************************************************************/
+
+// stand-in clock: time only moves when the test says so
+uint32_t Test_GetTicks(void)
+{
+	return test_ticks;
+}
+
+
+// stand-in stopwatch: every step of a replayed tick takes exactly 1 unit
+uint32_t Test_GetStopwatch(void)
+{
+	return test_stopwatch++;
+}
+
+
+// replay event handler: keep a copy of each event
+void Test_HandleEvent(EventRecord* the_event)
+{
+	if (num_handled < INPUTLOG_TEST_MAX_HANDLED)
+	{
+		handled_events[num_handled] = *the_event;
+	}
+
+	num_handled++;
+}
+
+
+// record a short session: a click and a drag, with a key press in the middle, and a long pause before the last move
+void Test_RecordSession(InputLog* the_log)
+{
+	test_ticks = 1000;
+	EventManager_SetRecorder(the_log);
+
+	EventManager_AddMouseEventAt(mouseMoved, 100, 50, NULL);
+	test_ticks += 2;
+	EventManager_AddMouseEventAt(mouseDown, 100, 50, NULL);
+	EventManager_AddKeyEvent(keyDown, 0x1e, 'a', 0, &test_window);
+	test_ticks += 1;
+	EventManager_AddMouseEventAt(mouseMoved, 110, 55, NULL);
+	EventManager_AddMouseEventAt(mouseMoved, 120, 60, NULL);
+	test_ticks += 7;
+	EventManager_AddMouseEventAt(mouseUp, -20, 60, NULL);
+	test_ticks += 70000;
+	EventManager_AddMouseEventAt(mouseMoved, 640, 480, NULL);
+
+	EventManager_SetRecorder(NULL);
+	Test_DrainEvents();
+}
+
+
+// empty the event queues
+void Test_DrainEvents(void)
+{
+	while (EventManager_NextEvent() != NULL)
+	{
+	}
+}
+
+
+
+
+/*****************************************************************************/
+/*                        MinUnit Function Defintions                        */
+/*****************************************************************************/
+
+
+
+void test_setup(void)	// this is called EVERY test
+{
+	test_window.event_mask_ = everyEvent;
+	test_stopwatch = 0;
+	num_handled = 0;
+	EventManager_SetClock(&Test_GetTicks);
+	Test_DrainEvents();
+}
+
+
+void test_teardown(void)	// this is called EVERY test
+{
+	EventManager_SetRecorder(NULL);
+	EventManager_SetClock(NULL);
+}
+
+
+
+// **** unit tests
+
+MU_TEST(inputlog_record_test)
+{
+	InputLog*	the_log;
+
+	the_log = InputLog_New(8);
+	mu_assert(the_log != NULL, "could not create input log");
+
+	Test_RecordSession(the_log);
+
+	// everything was recorded, even the move merged into the one before it
+	mu_assert_int_eq(7, InputLog_GetCount(the_log));
+	mu_assert_int_eq(6, the_log->num_mouse_);
+	mu_assert_int_eq(1, the_log->num_keys_);
+	mu_assert_int_eq(0, InputLog_GetLostCount(the_log));
+
+	// times are from the start of recording
+	mu_assert_int_eq(0, the_log->mouse_[0].when_);
+	mu_assert_int_eq(mouseDown, the_log->mouse_[1].what_);
+	mu_assert_int_eq(2, the_log->mouse_[1].when_);
+	mu_assert_int_eq(-20, the_log->mouse_[4].x_);
+	mu_assert_int_eq(70010, the_log->mouse_[5].when_);
+	mu_assert_int_eq(keyDown, the_log->keys_[0].what_);
+	mu_assert_int_eq(2, the_log->keys_[0].when_);
+	mu_assert_int_eq(0x1e, the_log->keys_[0].x_);
+	mu_assert_int_eq('a', the_log->keys_[0].y_);
+
+	// not recording now
+	EventManager_AddMouseEventAt(mouseMoved, 1, 1, NULL);
+	mu_assert_int_eq(7, InputLog_GetCount(the_log));
+
+	// a full log counts what it couldn't keep, and recording again starts it afresh
+	InputLog_Destroy(&the_log);
+	the_log = InputLog_New(4);
+	Test_RecordSession(the_log);
+	mu_assert_int_eq(5, InputLog_GetCount(the_log));
+	mu_assert_int_eq(2, InputLog_GetLostCount(the_log));
+
+	EventManager_SetRecorder(the_log);
+	mu_assert_int_eq(0, InputLog_GetCount(the_log));
+	mu_assert_int_eq(0, InputLog_GetLostCount(the_log));
+	EventManager_SetRecorder(NULL);
+
+	InputLog_Destroy(&the_log);
+}
+
+
+MU_TEST(inputlog_file_test)
+{
+	InputLog*	the_log;
+	InputLog*	the_loaded_log;
+	FILE*		the_file;
+	uint32_t	i;
+	long		the_file_size;
+
+	the_log = InputLog_New(8);
+	Test_RecordSession(the_log);
+
+	mu_check( InputLog_Save(the_log, INPUTLOG_TEST_FILE) == true );
+
+	// 8 bytes a record, plus one record for the pause of over 65535 ticks
+	the_file = fopen(INPUTLOG_TEST_FILE, "rb");
+	mu_assert(the_file != NULL, "saved log not found");
+	fseek(the_file, 0, SEEK_END);
+	the_file_size = ftell(the_file);
+	fclose(the_file);
+	mu_assert_int_eq(INPUTLOG_FILE_HEADER_SIZE + 8 * INPUTLOG_FILE_RECORD_SIZE, the_file_size);
+
+	the_loaded_log = InputLog_Load(INPUTLOG_TEST_FILE);
+	mu_assert(the_loaded_log != NULL, "could not load saved log");
+	mu_assert_int_eq(the_log->num_mouse_, the_loaded_log->num_mouse_);
+	mu_assert_int_eq(the_log->num_keys_, the_loaded_log->num_keys_);
+
+	for (i = 0; i < the_log->num_mouse_; i++)
+	{
+		mu_check( memcmp(&the_log->mouse_[i], &the_loaded_log->mouse_[i], sizeof(InputRecord)) == 0 );
+	}
+
+	mu_check( memcmp(&the_log->keys_[0], &the_loaded_log->keys_[0], sizeof(InputRecord)) == 0 );
+
+	InputLog_Destroy(&the_loaded_log);
+
+	// anything else is turned down
+	the_file = fopen(INPUTLOG_TEST_FILE, "wb");
+	fputs("not an input log", the_file);
+	fclose(the_file);
+	mu_check( InputLog_Load(INPUTLOG_TEST_FILE) == NULL );
+
+	InputLog_Destroy(&the_log);
+}
+
+
+MU_TEST(inputlog_replay_test)
+{
+	InputLog*		the_log;
+	InputLogStats	the_stats;
+	uint32_t		start_filtered;
+	uint16_t		i;
+
+	the_log = InputLog_New(8);
+	Test_RecordSession(the_log);
+
+	// cut the long pause out, so the replay is 11 ticks long
+	the_log->mouse_[5].when_ = 10;
+
+	EventManager_StartTimer(&test_window, 9, 5, 0);
+	InputLog_SetStopwatch(the_log, &Test_GetStopwatch, INPUTLOG_TEST_STOPWATCH_HZ);
+	start_filtered = EventManager_GetFilteredCount();
+
+	mu_check( InputLog_Replay(the_log, REPLAY_MAX_SPEED, &Test_HandleEvent, &the_stats) == true );
+
+	// the same events at the same ticks as when recorded: the two moves in one tick are merged again,
+	//   and the timer fires 5 ticks into the replay, whatever the real clock says.
+	//   the key goes to the active window, as keys do when replayed: there isn't one here, so it is filtered out.
+	mu_assert_int_eq(6, num_handled);
+	mu_assert_int_eq(1, EventManager_GetFilteredCount() - start_filtered);
+	mu_assert_int_eq(mouseMoved, handled_events[0].what_);
+	mu_assert_int_eq(0, handled_events[0].when_);
+	mu_assert_int_eq(mouseDown, handled_events[1].what_);
+	mu_assert_int_eq(2, handled_events[1].when_);
+	mu_assert_int_eq(mouseMoved, handled_events[2].what_);
+	mu_assert_int_eq(120, handled_events[2].mouseinfo_.x_);
+	mu_assert_int_eq(3, handled_events[2].when_);
+	mu_assert_int_eq(timerEvt, handled_events[3].what_);
+	mu_assert_int_eq(9, handled_events[3].timerinfo_.id_);
+	mu_assert_int_eq(5, handled_events[3].when_);
+	mu_assert_int_eq(mouseUp, handled_events[4].what_);
+	mu_assert_int_eq(-20, handled_events[4].mouseinfo_.x_);
+	mu_assert_int_eq(mouseMoved, handled_events[5].what_);
+	mu_assert_int_eq(10, handled_events[5].when_);
+
+	// every step of every tick was timed
+	mu_assert_int_eq(11, the_stats.frames_);
+	mu_assert_int_eq(6, the_stats.events_);
+	mu_assert_int_eq(INPUTLOG_TEST_STOPWATCH_HZ, the_stats.units_per_sec_);
+	mu_assert_int_eq(REPLAY_NUM_SUBSYSTEMS, the_stats.frame_min_);
+	mu_assert_int_eq(REPLAY_NUM_SUBSYSTEMS, the_stats.frame_max_);
+	mu_assert_int_eq(11 * REPLAY_NUM_SUBSYSTEMS, the_stats.frame_total_);
+	mu_assert_int_eq(0, the_stats.frames_over_budget_);
+
+	for (i = 0; i < REPLAY_NUM_SUBSYSTEMS; i++)
+	{
+		mu_assert_int_eq(11, the_stats.subsystem_total_[i]);
+		mu_assert_int_eq(1, the_stats.subsystem_max_[i]);
+	}
+
+	InputLog_Destroy(&the_log);
+}
+
+
+
+// unit tests
+MU_TEST_SUITE(test_suite_units)
+{
+	MU_SUITE_CONFIGURE(&test_setup, &test_teardown);
+
+	MU_RUN_TEST(inputlog_record_test);
+	MU_RUN_TEST(inputlog_file_test);
+	MU_RUN_TEST(inputlog_replay_test);
+}
+
+
+
+
+
+/*****************************************************************************/
+/*                        Public Function Definitions                        */
+/*****************************************************************************/
+
+
+
+int main(int argc, char* argv[])
+{
+	printf("**** inputlog.c Test Suite **** \n");
+
+	// allocate the system object
+	if ((global_system = Sys_New()) == NULL)
+	{
+		printf("Couldn't instantiate system object \n");
+		sys_exit(-1);
+	}
+
+	if (Sys_InitSystem(global_system) == false)
+	{
+		DEBUG_OUT(("%s %d: Couldn't initialize the system", __func__, __LINE__));
+		Sys_Exit(&global_system, PARAM_EXIT_ON_ERROR);
+	}
+
+	// the recording tests play the part of the mouse interrupt: keep the real one out of the logs. (replays turn it off for themselves.)
+	sys_int_disable(INT_MOUSE);
+
+	// ... and of a window that follows the mouse, so moves are queued whether or not a button is down
+	EventManager_Subscribe(mouseMovedMask);
+
+	MU_RUN_SUITE(test_suite_units);
+	MU_REPORT();
+
+	printf("inputlog test complete \n");
+
+	Sys_Exit(&global_system, PARAM_EXIT_NO_ERROR);
+
+	return MU_EXIT_CODE;
+}
@@ -17,6 +17,7 @@
 #include "debug.h"
 //#include "general.h"
 #include "list.h"
+#include "pool.h"
 //#include "sys.h"
 
 // C includes
@@ -30,12 +31,14 @@
 /*                               Definitions                                 */
 /*****************************************************************************/
 
+#define LIST_ITEMS_PER_SLAB		32		// number of List items the list pool gets from the heap at a time
 
 
 /*****************************************************************************/
 /*                             Global Variables                              */
 /*****************************************************************************/
 
+static Pool		list_pool = POOL_INITIALIZER("List", List, LIST_ITEMS_PER_SLAB);
 
 
 /*****************************************************************************/
@@ -190,7 +193,7 @@ List* List_NewItem(void* the_payload)
 {
 	List* the_item;
 
-	if ( (the_item = (List*)calloc(1, sizeof(List)) ) == NULL)
+	if ( (the_item = (List*)Pool_Alloc(&list_pool) ) == NULL)
 	{
 		LOG_ERR(("%s %d: could not allocate memory to create new list item", __func__ , __LINE__));
 		return NULL;
@@ -217,15 +220,26 @@ void List_Destroy(List** list_head)
 		the_item = *list_head;
 		*list_head = the_item->next_item_;
 
-		//List_DeleteItem(the_item);
-		LOG_ALLOC(("%s %d:	__FREE__	the_item	%p	size	%i", __func__ , __LINE__, the_item, sizeof(List)));
-		TRACK_ALLOC((0 - sizeof(List)));
-		free(the_item);
-		the_item = NULL;
+		List_DestroyItem(&the_item);
 	}
 }
 
 
+// frees a single list item, which must already have been removed from its list. Does not free the payload.
+void List_DestroyItem(List** the_item)
+{
+	if (*the_item == NULL)
+	{
+		return;
+	}
+	
+	LOG_ALLOC(("%s %d:	__FREE__	the_item	%p	size	%i", __func__ , __LINE__, *the_item, sizeof(List)));
+	TRACK_ALLOC((0 - sizeof(List)));
+	Pool_Free(&list_pool, *the_item);
+	*the_item = NULL;
+}
+
+
 // adds a new list item as the head of the list
 void List_AddItem(List** list_head, List* the_item)
 {
@@ -83,6 +83,9 @@ List* List_NewItem(void* the_payload);
 // destructor
 void List_Destroy(List** head_item);
 
+// frees a single list item, which must already have been removed from its list. Does not free the payload.
+void List_DestroyItem(List** the_item);
+
 // adds a new list item as the head of the list
 void List_AddItem(List** head_item, List* the_item);
 
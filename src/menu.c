@@ -417,6 +417,7 @@ error:
 bool Menu_BlitClipRects(Menu* the_menu)
 {
 	Rectangle*	the_clip;
+	Rectangle	the_global_clip;
 	Bitmap*		the_screen_bitmap;
 	int16_t		i;
 	
@@ -448,6 +449,13 @@ bool Menu_BlitClipRects(Menu* the_menu)
 					the_clip->MaxX - the_clip->MinX + 1, 
 					the_clip->MaxY - the_clip->MinY + 1
 					);
+		
+		// if double-buffering, the other page needs this too once it's flipped on screen
+		the_global_clip.MinX = the_clip->MinX + the_menu->x_;
+		the_global_clip.MinY = the_clip->MinY + the_menu->y_;
+		the_global_clip.MaxX = the_clip->MaxX + the_menu->x_;
+		the_global_clip.MaxY = the_clip->MaxY + the_menu->y_;
+		Sys_AddScreenDamage(global_system, &the_global_clip);
 	}
 	
 	// LOGIC: 
@@ -486,7 +494,7 @@ Menu* Menu_New(void)
 	LOG_ALLOC(("%s %d:	__ALLOC__	the_menu	%p	size	%i", __func__ , __LINE__, the_menu, sizeof(Menu)));
 	TRACK_ALLOC((sizeof(Menu)));
 
-	if ( (the_menu->bitmap_ = Bitmap_New(MENU_MAX_WIDTH, MENU_MAX_HEIGHT, Sys_GetAppFont(global_system), PARAM_NOT_IN_VRAM)) == NULL)
+	if ( (the_menu->bitmap_ = Bitmap_New(MENU_MAX_WIDTH, MENU_MAX_HEIGHT, Sys_GetAppFont(global_system), PARAM_PREFER_VRAM)) == NULL)
 	{
 		LOG_ERR(("%s %d: Failed to create bitmap", __func__, __LINE__));
 printf("menu bitmap allocation error!... \n");
@@ -562,6 +570,8 @@ error:
 //! @param	the_menu -- reference to a valid Menu object.
 void Menu_Render(Menu* the_menu)
 {
+	Rectangle	the_global_rect;
+	
 	if (the_menu == NULL)
 	{
 		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
@@ -581,6 +591,12 @@ void Menu_Render(Menu* the_menu)
 		the_menu->clip_count_ = 0;
 		Bitmap_BlitRect(the_menu->bitmap_, &the_menu->overall_rect_, Sys_GetScreenBitmap(global_system, back_layer), the_menu->x_, the_menu->y_);
 		the_menu->invalidated_ = false;
+		
+		the_global_rect.MinX = the_menu->overall_rect_.MinX + the_menu->x_;
+		the_global_rect.MinY = the_menu->overall_rect_.MinY + the_menu->y_;
+		the_global_rect.MaxX = the_menu->overall_rect_.MaxX + the_menu->x_;
+		the_global_rect.MaxY = the_menu->overall_rect_.MaxY + the_menu->y_;
+		Sys_AddScreenDamage(global_system, &the_global_rect);
 	}
 	else
 	{
@@ -715,8 +731,8 @@ void Menu_Hide(Menu* the_menu)
 
 	Sys_IssueMenuDamageRects(global_system);
 
-	// Re-render all windows
-	Sys_Render(global_system);		
+	// Re-render all windows at the start of the next frame
+	Sys_RequestRender(global_system);
 	
 	return;
 	
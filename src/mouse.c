@@ -16,6 +16,7 @@
 // project includes
 #include "debug.h"
 #include "mouse.h"
+#include "sprite.h"
 #include "sys.h"
 
 // A2560 includes
@@ -34,6 +35,40 @@
 /*                               Definitions                                 */
 /*****************************************************************************/
 
+#define MOUSE_POINTER_WIDTH		11
+#define MOUSE_POINTER_HEIGHT	16
+#define MOUSE_POINTER_HOT_X		0		// the tip of the arrow
+#define MOUSE_POINTER_HOT_Y		0
+
+#define _	SPRITE_TRANSPARENT_COLOR
+#define B	SYS_COLOR_BLACK
+#define W	SYS_COLOR_WHITE
+
+// the standard arrow pointer: white with a black outline
+static const uint8_t	mouse_pointer_image[MOUSE_POINTER_HEIGHT][MOUSE_POINTER_WIDTH] =
+{
+	{B,_,_,_,_,_,_,_,_,_,_},
+	{B,B,_,_,_,_,_,_,_,_,_},
+	{B,W,B,_,_,_,_,_,_,_,_},
+	{B,W,W,B,_,_,_,_,_,_,_},
+	{B,W,W,W,B,_,_,_,_,_,_},
+	{B,W,W,W,W,B,_,_,_,_,_},
+	{B,W,W,W,W,W,B,_,_,_,_},
+	{B,W,W,W,W,W,W,B,_,_,_},
+	{B,W,W,W,W,W,W,W,B,_,_},
+	{B,W,W,W,W,W,W,W,W,B,_},
+	{B,W,W,W,W,W,B,B,B,B,B},
+	{B,W,W,B,W,W,B,_,_,_,_},
+	{B,W,B,_,B,W,W,B,_,_,_},
+	{B,B,_,_,B,W,W,B,_,_,_},
+	{B,_,_,_,_,B,W,W,B,_,_},
+	{_,_,_,_,_,B,B,B,B,_,_},
+};
+
+#undef _
+#undef B
+#undef W
+
 
 
 /*****************************************************************************/
@@ -48,12 +83,86 @@ extern System*			global_system;
 /*                       Private Function Prototypes                         */
 /*****************************************************************************/
 
+// get the bitmap drag outlines are drawn on: the foreground layer if there is one, otherwise the background layer
+Bitmap* Mouse_GetOutlineBitmap(void);
+
+// if the outline was drawn on the background layer, report its edges as screen damage, so double-buffering keeps both pages in step
+void Mouse_DamageOutline(Bitmap* the_bitmap, Rectangle* the_rect);
+
+// move the pointer and drag image sprites (if any) to the current x, y coord
+void Mouse_MoveSprites(MouseTracker* the_mouse);
 
 
 /*****************************************************************************/
 /*                       Private Function Definitions                        */
 /*****************************************************************************/
 
+// get the bitmap drag outlines are drawn on: the foreground layer if there is one, otherwise the background layer
+Bitmap* Mouse_GetOutlineBitmap(void)
+{
+	Bitmap*		the_bitmap;
+	
+	// LOGIC:
+	//   the outline belongs on the foreground layer, so windows can render underneath it without disturbing it
+	//   on emulators that do not composite layers, there is no foreground layer, so fall back on the background layer.
+	
+	the_bitmap = Sys_GetScreenBitmap(global_system, fore_layer);
+	
+	if (the_bitmap == NULL)
+	{
+		the_bitmap = Sys_GetScreenBitmap(global_system, back_layer);
+	}
+	
+	return the_bitmap;
+}
+
+
+// if the outline was drawn on the background layer, report its edges as screen damage, so double-buffering keeps both pages in step
+void Mouse_DamageOutline(Bitmap* the_bitmap, Rectangle* the_rect)
+{
+	Rectangle	the_edge;
+	
+	if (the_bitmap != Sys_GetScreenBitmap(global_system, back_layer))
+	{
+		return;
+	}
+	
+	// top and bottom edges
+	the_edge.MinX = the_rect->MinX;
+	the_edge.MaxX = the_rect->MaxX;
+	the_edge.MinY = the_edge.MaxY = the_rect->MinY;
+	Sys_AddScreenDamage(global_system, &the_edge);
+	the_edge.MinY = the_edge.MaxY = the_rect->MaxY;
+	Sys_AddScreenDamage(global_system, &the_edge);
+	
+	// left and right edges
+	the_edge.MinY = the_rect->MinY;
+	the_edge.MaxY = the_rect->MaxY;
+	the_edge.MinX = the_edge.MaxX = the_rect->MinX;
+	Sys_AddScreenDamage(global_system, &the_edge);
+	the_edge.MinX = the_edge.MaxX = the_rect->MaxX;
+	Sys_AddScreenDamage(global_system, &the_edge);
+}
+
+
+// move the pointer and drag image sprites (if any) to the current x, y coord
+void Mouse_MoveSprites(MouseTracker* the_mouse)
+{
+	// LOGIC:
+	//   the sprites are composited over the screen by the VICKY: moving them is a register write each.
+	//   nothing under the old position needs to be redrawn, and no window pixels are dirtied.
+	
+	if (the_mouse->pointer_sprite_ != NULL)
+	{
+		Sprite_MoveTo(the_mouse->pointer_sprite_, the_mouse->x_, the_mouse->y_);
+	}
+	
+	if (the_mouse->drag_sprite_ != NULL)
+	{
+		Sprite_MoveTo(the_mouse->drag_sprite_, the_mouse->x_, the_mouse->y_);
+	}
+}
+
 
 
 
@@ -102,6 +211,16 @@ void Mouse_Destroy(MouseTracker** the_mouse)
 		goto error;
 	}
 
+	if ((*the_mouse)->pointer_sprite_ != NULL)
+	{
+		Sprite_Destroy(&(*the_mouse)->pointer_sprite_);
+	}
+	
+	if ((*the_mouse)->drag_sprite_ != NULL)
+	{
+		Sprite_Destroy(&(*the_mouse)->drag_sprite_);
+	}
+
 	LOG_ALLOC(("%s %d:	__FREE__	*the_mouse	%p	size	%i", __func__ , __LINE__, *the_mouse, sizeof(MouseTracker)));
 	TRACK_ALLOC((0 - sizeof(MouseTracker)));
 	free(*the_mouse);
@@ -144,6 +263,8 @@ void Mouse_AcceptUpdate(MouseTracker* the_mouse, Window* the_window, int16_t x,
 		the_mouse->movement_area_.MaxY = the_mouse->clicked_y_ + MOUSE_MOVEMENT_THRESHOLD;
 	}
 	
+	Mouse_MoveSprites(the_mouse);
+	
 	//Mouse_Print(the_mouse);
 	
 	return;
@@ -166,6 +287,8 @@ void Mouse_SetXY(MouseTracker* the_mouse, int16_t x, int16_t y)
 	the_mouse->x_ = x;
 	the_mouse->y_ = y;
 	
+	Mouse_MoveSprites(the_mouse);
+	
 	return;
 	
 error:
@@ -189,6 +312,10 @@ void Mouse_Clear(MouseTracker* the_mouse)
 	the_mouse->x_ = -1;
 	the_mouse->y_ = -1;
 	the_mouse->mode_ = mouseFree;
+	the_mouse->outline_visible_ = false;
+	
+	// a drag is over: the pointer stays, the drag image goes
+	Mouse_ClearDragImage(the_mouse);
 	
 	return;
 	
@@ -559,6 +686,208 @@ void Mouse_DrawSelectionBox(MouseTracker* the_mouse)
 }
 
 
+// move the window drag/resize outline to the passed global rect: undraws the previous outline (if any) and XORs the new one onto the foreground layer
+// only the outline pixels are touched, so the cost is proportional to the perimeter of the window, not its area
+void Mouse_DrawDragOutline(MouseTracker* the_mouse, Rectangle* the_new_rect)
+{
+	Bitmap*		the_bitmap;
+	
+	if (the_mouse == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		goto error;
+	}
+	
+	if (the_new_rect == NULL)
+	{
+		LOG_ERR(("%s %d: passed rect was null", __func__ , __LINE__));
+		goto error;
+	}
+	
+	if (the_mouse->outline_visible_ && the_mouse->outline_rect_.MinX == the_new_rect->MinX && the_mouse->outline_rect_.MinY == the_new_rect->MinY && 
+		the_mouse->outline_rect_.MaxX == the_new_rect->MaxX && the_mouse->outline_rect_.MaxY == the_new_rect->MaxY)
+	{
+		return;	// already showing in the right place
+	}
+	
+	the_bitmap = Mouse_GetOutlineBitmap();
+	
+	Mouse_ClearDragOutline(the_mouse);
+	
+	General_CopyRect(&the_mouse->outline_rect_, the_new_rect);
+	Bitmap_DrawBoxXOR(the_bitmap, the_new_rect->MinX, the_new_rect->MinY, the_new_rect->MaxX - the_new_rect->MinX + 1, the_new_rect->MaxY - the_new_rect->MinY + 1, MOUSE_DRAG_OUTLINE_XOR);
+	Mouse_DamageOutline(the_bitmap, the_new_rect);
+	the_mouse->outline_visible_ = true;
+	
+	return;
+	
+error:
+	Sys_Exit(&global_system, PARAM_EXIT_ON_ERROR);	// crash early, crash often
+	return;
+}
+
+
+// undraw the window drag/resize outline, if one is showing
+void Mouse_ClearDragOutline(MouseTracker* the_mouse)
+{
+	Bitmap*		the_bitmap;
+	Rectangle*	the_rect;
+	
+	if (the_mouse == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		goto error;
+	}
+	
+	if (the_mouse->outline_visible_ == false)
+	{
+		return;
+	}
+	
+	// XORing the same box again restores every pixel under it
+	the_bitmap = Mouse_GetOutlineBitmap();
+	the_rect = &the_mouse->outline_rect_;
+	Bitmap_DrawBoxXOR(the_bitmap, the_rect->MinX, the_rect->MinY, the_rect->MaxX - the_rect->MinX + 1, the_rect->MaxY - the_rect->MinY + 1, MOUSE_DRAG_OUTLINE_XOR);
+	Mouse_DamageOutline(the_bitmap, the_rect);
+	the_mouse->outline_visible_ = false;
+	
+	return;
+	
+error:
+	Sys_Exit(&global_system, PARAM_EXIT_ON_ERROR);	// crash early, crash often
+	return;
+}
+
+
+// show the mouse pointer as a sprite, at the current x, y coord. From then on, it follows every position update, without redrawing anything on screen.
+// returns false if no sprite was available (eg, sprites were not set up): the pointer is then not shown
+// the VICKY's own pointer is left on. the tracker's position doesn't yet come from the PS/2 packets, so don't use this in place of it.
+bool Mouse_ShowPointer(MouseTracker* the_mouse)
+{
+	if (the_mouse == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		goto error;
+	}
+	
+	if (the_mouse->pointer_sprite_ == NULL)
+	{
+		if ( (the_mouse->pointer_sprite_ = Sprite_New(MOUSE_POINTER_Z_ORDER)) == NULL)
+		{
+			LOG_WARN(("%s %d: no sprite available for the mouse pointer", __func__ , __LINE__));
+			return false;
+		}
+		
+		Sprite_SetImage(the_mouse->pointer_sprite_, &mouse_pointer_image[0][0], MOUSE_POINTER_WIDTH, MOUSE_POINTER_WIDTH, MOUSE_POINTER_HEIGHT, MOUSE_POINTER_HOT_X, MOUSE_POINTER_HOT_Y);
+	}
+	
+	Sprite_MoveTo(the_mouse->pointer_sprite_, the_mouse->x_, the_mouse->y_);
+	Sprite_SetVisible(the_mouse->pointer_sprite_, true);
+	
+	return true;
+	
+error:
+	Sys_Exit(&global_system, PARAM_EXIT_ON_ERROR);	// crash early, crash often
+	return false;
+}
+
+
+// show part of a bitmap as a sprite that follows the pointer, as feedback while dragging something (eg, an icon). Replaces any previous drag image.
+// the_rect is the part of the_bitmap to show: anything beyond SPRITE_SIZE x SPRITE_SIZE is cut off.
+// hot_x, hot_y is the point within that part that stays under the pointer (eg, where it was clicked)
+// returns false if no sprite was available
+bool Mouse_SetDragImage(MouseTracker* the_mouse, Bitmap* the_bitmap, Rectangle* the_rect, int16_t hot_x, int16_t hot_y)
+{
+	Rectangle	the_src;
+	Rectangle	the_bitmap_rect;
+	
+	if (the_mouse == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		goto error;
+	}
+	
+	if (the_bitmap == NULL || the_rect == NULL)
+	{
+		LOG_ERR(("%s %d: passed bitmap or rect was null", __func__ , __LINE__));
+		goto error;
+	}
+	
+	// only the part of the rect within the bitmap can be copied
+	the_bitmap_rect.MinX = 0;
+	the_bitmap_rect.MinY = 0;
+	the_bitmap_rect.MaxX = the_bitmap->width_ - 1;
+	the_bitmap_rect.MaxY = the_bitmap->height_ - 1;
+	
+	if (General_CalculateRectIntersection(the_rect, &the_bitmap_rect, &the_src) == false)
+	{
+		LOG_WARN(("%s %d: drag image rect is not within the bitmap", __func__ , __LINE__));
+		return false;
+	}
+	
+	if (the_mouse->drag_sprite_ == NULL)
+	{
+		if ( (the_mouse->drag_sprite_ = Sprite_New(MOUSE_DRAG_IMAGE_Z_ORDER)) == NULL)
+		{
+			LOG_WARN(("%s %d: no sprite available for the drag image", __func__ , __LINE__));
+			return false;
+		}
+	}
+	
+	Sprite_SetImage(the_mouse->drag_sprite_, the_bitmap->addr_ + (uint32_t)the_src.MinY * the_bitmap->width_ + the_src.MinX, the_bitmap->width_, 
+					the_src.MaxX - the_src.MinX + 1, the_src.MaxY - the_src.MinY + 1, hot_x - (the_src.MinX - the_rect->MinX), hot_y - (the_src.MinY - the_rect->MinY));
+	Sprite_MoveTo(the_mouse->drag_sprite_, the_mouse->x_, the_mouse->y_);
+	Sprite_SetVisible(the_mouse->drag_sprite_, true);
+	
+	return true;
+	
+error:
+	Sys_Exit(&global_system, PARAM_EXIT_ON_ERROR);	// crash early, crash often
+	return false;
+}
+
+
+// hide the drag image, if one is showing
+void Mouse_ClearDragImage(MouseTracker* the_mouse)
+{
+	if (the_mouse == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		goto error;
+	}
+	
+	// the sprite is given back, so the pointer (and anything else) can have it
+	if (the_mouse->drag_sprite_ != NULL)
+	{
+		Sprite_Destroy(&the_mouse->drag_sprite_);
+	}
+	
+	return;
+	
+error:
+	Sys_Exit(&global_system, PARAM_EXIT_ON_ERROR);	// crash early, crash often
+	return;
+}
+
+
+// returns true if a drag image is showing
+bool Mouse_HasDragImage(MouseTracker* the_mouse)
+{
+	if (the_mouse == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		goto error;
+	}
+	
+	return the_mouse->drag_sprite_ != NULL;
+	
+error:
+	Sys_Exit(&global_system, PARAM_EXIT_ON_ERROR);	// crash early, crash often
+	return false;
+}
+
+
+
 // **** Debug functions *****
 
 void Mouse_Print(MouseTracker* the_mouse)
@@ -573,5 +902,7 @@ void Mouse_Print(MouseTracker* the_mouse)
 	DEBUG_OUT(("  clicked_ticks: %lu", 	the_mouse->clicked_ticks));
 	DEBUG_OUT(("  selection_area_: %i, %i, %i, %i", the_mouse->selection_area_.MinX, the_mouse->selection_area_.MinY, the_mouse->selection_area_.MaxX, the_mouse->selection_area_.MaxY));
 	DEBUG_OUT(("  movement_area_: %i, %i, %i, %i", the_mouse->movement_area_.MinX, the_mouse->movement_area_.MinY, the_mouse->movement_area_.MaxX, the_mouse->movement_area_.MaxY));
+	DEBUG_OUT(("  pointer_sprite_: %p", the_mouse->pointer_sprite_));
+	DEBUG_OUT(("  drag_sprite_: %p", the_mouse->drag_sprite_));
 }
 
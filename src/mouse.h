@@ -21,6 +21,7 @@
  * Track time of last mouse click, and determine if a double-click happened
  * Track a mouse mode, which includes icon selected, drag mode, lasso mode, etc.
  * Determine if a given coordinate pair is within the defined zone around the mouse pointer
+ * Show the mouse pointer, and any image being dragged, as sprites, so moving them doesn't touch the bitmap layers
  *
  *** things objects of this class have
  *
@@ -35,6 +36,7 @@
 
 // project includes
 //#include "control.h"
+#include "sprite.h"
 
 // C includes
 #include <stdbool.h>
@@ -51,6 +53,9 @@
 #define MOUSE_POINTER_RADIUS		2	// number of pixels up/down/left/right from mouse pointer that will be included in selection. might need to be 0
 #define MOUSE_MOVEMENT_THRESHOLD	4	// number of pixels away from the mouse-down point that mouse must before before lasso starts drawing or drag mode begins
 #define MOUSE_DOUBLE_CLICK_TICKS	30	// maximum number of ticks between first and second click for a double-click event to be registered
+#define MOUSE_DRAG_OUTLINE_XOR		0xFF	// value XORed into each pixel of a window drag/resize outline. XORing again restores the pixel.
+#define MOUSE_POINTER_Z_ORDER		SPRITE_FRONTMOST			// the pointer is in front of every other sprite
+#define MOUSE_DRAG_IMAGE_Z_ORDER	(SPRITE_FRONTMOST + 1)		// an image being dragged is just behind the pointer
 
 
 /*****************************************************************************/
@@ -92,6 +97,10 @@ struct MouseTracker
 	uint32_t		clicked_ticks;
 	Rectangle		selection_area_;	// a box around the pointer (if not lasso), or the lasso box, used to detect icon selection and drag-mode start
 	Rectangle		movement_area_;		// a box between the last clicked and current location
+	Rectangle		outline_rect_;		// global rect of the drag/resize outline currently drawn on screen. Only valid if outline_visible_ is true.
+	bool			outline_visible_;	// true if a drag/resize outline is currently XORed onto the screen
+	Sprite*			pointer_sprite_;	// the sprite showing the mouse pointer. NULL until Mouse_ShowPointer() is called, or if no sprite was available.
+	Sprite*			drag_sprite_;		// the sprite showing an image being dragged with the pointer. NULL until Mouse_SetDragImage() is called.
 };
 
 
@@ -187,6 +196,30 @@ bool Mouse_MovedEnoughForDragStart(MouseTracker* the_mouse);
 // draw a rectangle in the rastport passed, using the mouse coordinates. If doUnDraw is TRUE, try to undraw it (unimplemented TODO)
 void Mouse_DrawSelectionBox(MouseTracker* the_mouse);
 
+// move the window drag/resize outline to the passed global rect: undraws the previous outline (if any) and XORs the new one onto the foreground layer
+// only the outline pixels are touched, so the cost is proportional to the perimeter of the window, not its area
+void Mouse_DrawDragOutline(MouseTracker* the_mouse, Rectangle* the_new_rect);
+
+// undraw the window drag/resize outline, if one is showing
+void Mouse_ClearDragOutline(MouseTracker* the_mouse);
+
+// show the mouse pointer as a sprite, at the current x, y coord. From then on, it follows every position update, without redrawing anything on screen.
+// returns false if no sprite was available (eg, sprites were not set up): the pointer is then not shown
+// the VICKY's own pointer is left on. the tracker's position doesn't yet come from the PS/2 packets, so don't use this in place of it.
+bool Mouse_ShowPointer(MouseTracker* the_mouse);
+
+// show part of a bitmap as a sprite that follows the pointer, as feedback while dragging something (eg, an icon). Replaces any previous drag image.
+// the_rect is the part of the_bitmap to show: anything beyond SPRITE_SIZE x SPRITE_SIZE is cut off.
+// hot_x, hot_y is the point within that part that stays under the pointer (eg, where it was clicked)
+// returns false if no sprite was available
+bool Mouse_SetDragImage(MouseTracker* the_mouse, Bitmap* the_bitmap, Rectangle* the_rect, int16_t hot_x, int16_t hot_y);
+
+// hide the drag image, if one is showing
+void Mouse_ClearDragImage(MouseTracker* the_mouse);
+
+// returns true if a drag image is showing
+bool Mouse_HasDragImage(MouseTracker* the_mouse);
+
 
 
 // **** Debug functions *****
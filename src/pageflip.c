@@ -0,0 +1,378 @@
+/*
+ * pageflip.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: agent
+ */
+
+
+
+
+
+/*****************************************************************************/
+/*                                Includes                                   */
+/*****************************************************************************/
+
+// project includes
+#include "bitmap.h"
+#include "debug.h"
+#include "general.h"
+#include "pageflip.h"
+#include "region.h"
+
+// C includes
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// A2560 includes
+#include <mcp/syscalls.h>
+#include "a2560k.h"
+
+
+/*****************************************************************************/
+/*                               Definitions                                 */
+/*****************************************************************************/
+
+
+
+/*****************************************************************************/
+/*                               Enumerations                                */
+/*****************************************************************************/
+
+
+
+/*****************************************************************************/
+/*                          File-scoped Variables                            */
+/*****************************************************************************/
+
+
+
+/*****************************************************************************/
+/*                             Global Variables                              */
+/*****************************************************************************/
+
+
+
+/*****************************************************************************/
+/*                       Private Function Prototypes                         */
+/*****************************************************************************/
+
+//! Copy the damaged rects from the shown page to the hidden page, so the two match again, and forget the damage
+static void PageFlip_Replay(PageFlip* the_flip);
+
+
+/*****************************************************************************/
+/*                       Private Function Definitions                        */
+/*****************************************************************************/
+
+//! Copy the damaged rects from the shown page to the hidden page, so the two match again, and forget the damage
+static void PageFlip_Replay(PageFlip* the_flip)
+{
+	Bitmap*		the_shown_page;
+	Bitmap*		the_draw_page;
+	Rectangle*	the_rect;
+	int16_t		i;
+
+	// LOGIC:
+	//   the damage rects are everything drawn into the page that was just flipped on screen.
+	//   the page that was just flipped off screen is the same as it everywhere else, so copying those rects makes them identical again.
+	//   the damage region's rects don't overlap, so no pixel is copied twice.
+
+	the_shown_page = the_flip->page_[1 - the_flip->draw_page_];
+	the_draw_page = the_flip->page_[the_flip->draw_page_];
+
+	for (i = 0; i < the_flip->damage_->num_rects_; i++)
+	{
+		the_rect = &the_flip->damage_->rects_[i];
+
+		Bitmap_Blit(the_shown_page,
+					the_rect->MinX,
+					the_rect->MinY,
+					the_draw_page,
+					the_rect->MinX,
+					the_rect->MinY,
+					the_rect->MaxX - the_rect->MinX + 1,
+					the_rect->MaxY - the_rect->MinY + 1
+					);
+	}
+
+	the_flip->pixels_replayed_ = Region_GetArea(the_flip->damage_);
+	Region_MakeEmpty(the_flip->damage_);
+	the_flip->replay_needed_ = false;
+}
+
+
+
+
+/*****************************************************************************/
+/*                        Public Function Definitions                        */
+/*****************************************************************************/
+
+// **** CONSTRUCTOR AND DESTRUCTOR *****
+
+// constructor
+//! Set up double-buffering for a bitmap layer. The current contents of the shown page are copied to the spare page, and the spare becomes the hidden page.
+//! The register is not written until the first flip: the shown page stays on screen.
+//! @param	the_shown_page -- the bitmap the layer is currently showing
+//! @param	the_spare_page -- a second bitmap of the same size, in VRAM. The PageFlip does not take ownership of either bitmap.
+//! @param	the_addr_reg -- address of the layer's VRAM address register. Tests can pass the address of a uint32_t in standard RAM.
+//! @return	Returns NULL on any error/invalid input
+PageFlip* PageFlip_New(Bitmap* the_shown_page, Bitmap* the_spare_page, uint32_t the_addr_reg)
+{
+	PageFlip*	the_flip;
+
+	if (the_shown_page == NULL || the_spare_page == NULL)
+	{
+		LOG_ERR(("%s %d: passed bitmap was null", __func__ , __LINE__));
+		return NULL;
+	}
+
+	if (the_shown_page->width_ != the_spare_page->width_ || the_shown_page->height_ != the_spare_page->height_)
+	{
+		LOG_ERR(("%s %d: pages are different sizes (%i x %i, %i x %i)", __func__ , __LINE__, the_shown_page->width_, the_shown_page->height_, the_spare_page->width_, the_spare_page->height_));
+		return NULL;
+	}
+
+	if ( (the_flip = (PageFlip*)calloc(1, sizeof(PageFlip)) ) == NULL)
+	{
+		LOG_ERR(("%s %d: could not allocate memory to create new page flip", __func__ , __LINE__));
+		return NULL;
+	}
+	LOG_ALLOC(("%s %d:	__ALLOC__	the_flip	%p	size	%i", __func__ , __LINE__, the_flip, sizeof(PageFlip)));
+	TRACK_ALLOC((sizeof(PageFlip)));
+
+	if ( (the_flip->damage_ = Region_New()) == NULL)
+	{
+		LOG_ERR(("%s %d: could not allocate damage region", __func__ , __LINE__));
+		PageFlip_Destroy(&the_flip);
+		return NULL;
+	}
+
+	the_flip->page_[0] = the_shown_page;
+	the_flip->page_[1] = the_spare_page;
+	the_flip->draw_page_ = 1;
+	the_flip->addr_reg_ = the_addr_reg;
+	the_flip->shown_addr_ = the_shown_page->addr_int_;
+
+	// both pages start out the same, so there is no damage to replay at the first flip
+	Bitmap_Blit(the_shown_page, 0, 0, the_spare_page, 0, 0, the_shown_page->width_, the_shown_page->height_);
+
+	return the_flip;
+}
+
+
+// destructor
+// frees all allocated memory associated with the passed object, and the object itself. The pages are not destroyed.
+//! @param	the_flip -- pointer to the pointer for the PageFlip object to be destroyed
+//! @return	Returns false if the pointer to the passed PageFlip was NULL
+bool PageFlip_Destroy(PageFlip** the_flip)
+{
+	if (the_flip == NULL || *the_flip == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		return false;
+	}
+
+	if ((*the_flip)->damage_ != NULL)
+	{
+		Region_Destroy(&(*the_flip)->damage_);
+	}
+
+	LOG_ALLOC(("%s %d:	__FREE__	*the_flip	%p	size	%i", __func__ , __LINE__, *the_flip, sizeof(PageFlip)));
+	TRACK_ALLOC((0 - sizeof(PageFlip)));
+	free(*the_flip);
+	*the_flip = NULL;
+
+	return true;
+}
+
+
+
+
+// **** FRAME functions *****
+
+//! Get ready to draw a frame into the hidden page: replays damage from the last flip, and re-points the register if the shown page has moved
+//! @param	the_flip -- reference to a valid PageFlip object
+//! @param	the_frame -- current frame number, used to time the render
+//! @return	Returns false if a queued flip has not happened yet: the hidden page is still waiting to be shown, and must not be drawn into for the next frame
+bool PageFlip_BeginFrame(PageFlip* the_flip, uint32_t the_frame)
+{
+	Bitmap*		the_shown_page;
+
+	if (the_flip == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		return false;
+	}
+
+	if (the_flip->flip_pending_ == true)
+	{
+		return false;
+	}
+
+	if (the_flip->replay_needed_ == true)
+	{
+		PageFlip_Replay(the_flip);
+	}
+
+	// LOGIC:
+	//   a page from the VRAM heap can be moved when the heap compacts itself. the heap copies its pixels along with it,
+	//   but the VICKY is still reading the old address. no flip is pending, so the interrupt won't touch the register while it is fixed up.
+
+	the_shown_page = the_flip->page_[1 - the_flip->draw_page_];
+
+	if (the_shown_page->addr_int_ != the_flip->shown_addr_)
+	{
+		DEBUG_OUT(("%s %d: shown page moved from %lx to %lx; re-pointing layer", __func__, __LINE__, the_flip->shown_addr_, the_shown_page->addr_int_));
+		R32(the_flip->addr_reg_) = the_shown_page->addr_int_ - (uint32_t)VRAM_START;
+		the_flip->shown_addr_ = the_shown_page->addr_int_;
+	}
+
+	the_flip->begin_frame_ = the_frame;
+
+	return true;
+}
+
+
+//! Record that part of the hidden page has been drawn into
+//! @param	the_flip -- reference to a valid PageFlip object
+//! @param	the_rect -- the rect drawn into, in page coordinates
+//! @return	Returns false on any error condition
+bool PageFlip_AddDamage(PageFlip* the_flip, Rectangle* the_rect)
+{
+	if (the_flip == NULL || the_rect == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object or rect was null", __func__ , __LINE__));
+		return false;
+	}
+
+	return Region_UnionRect(the_flip->damage_, the_rect);
+}
+
+
+//! Ask for the hidden page to be shown at the next PageFlip_Flip(). Nothing is queued if nothing has been drawn since the last flip.
+//! @param	the_flip -- reference to a valid PageFlip object
+//! @return	Returns true if a flip was queued
+bool PageFlip_QueueFlip(PageFlip* the_flip)
+{
+	if (the_flip == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		return false;
+	}
+
+	// LOGIC:
+	//   if the damage hasn't been replayed since the last flip, the hidden page is behind the shown one: showing it would go back in time.
+	//   that only happens if nothing has drawn into it (drawing goes through PageFlip_GetDrawPage, which replays), so there's nothing new to show.
+
+	if (the_flip->replay_needed_ == true || Region_IsEmpty(the_flip->damage_) == true)
+	{
+		return false;
+	}
+
+	the_flip->flip_pending_ = true;
+
+	return true;
+}
+
+
+//! If a flip has been queued, point the register at the hidden page and swap the pages. Safe to call from the start of frame interrupt.
+//! @param	the_flip -- reference to a valid PageFlip object
+//! @param	the_frame -- current frame number, used to time the render
+//! @return	Returns true if the pages were flipped
+bool PageFlip_Flip(PageFlip* the_flip, uint32_t the_frame)
+{
+	Bitmap*		the_new_page;
+
+	// LOGIC:
+	//   this runs in the interrupt, so it only does the register write and some bookkeeping: no logging, no allocation, no copying.
+	//   while a flip is pending, nothing else touches the pages or the register, so there is nothing to lock.
+
+	if (the_flip == NULL || the_flip->flip_pending_ == false)
+	{
+		return false;
+	}
+
+	the_new_page = the_flip->page_[the_flip->draw_page_];
+
+	R32(the_flip->addr_reg_) = the_new_page->addr_int_ - (uint32_t)VRAM_START;
+	the_flip->shown_addr_ = the_new_page->addr_int_;
+	the_flip->draw_page_ = 1 - the_flip->draw_page_;
+
+	the_flip->frame_time_ = the_frame - the_flip->begin_frame_;
+	the_flip->flip_count_++;
+	the_flip->replay_needed_ = true;
+	the_flip->flip_pending_ = false;
+
+	return true;
+}
+
+
+
+
+// **** GET functions *****
+
+//! Get the page to draw into. If there has been a flip since the last replay, the damage is replayed into it first.
+//! @param	the_flip -- reference to a valid PageFlip object
+Bitmap* PageFlip_GetDrawPage(PageFlip* the_flip)
+{
+	if (the_flip == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		return NULL;
+	}
+
+	if (the_flip->replay_needed_ == true && the_flip->flip_pending_ == false)
+	{
+		PageFlip_Replay(the_flip);
+	}
+
+	return the_flip->page_[the_flip->draw_page_];
+}
+
+
+//! Get the page the register is pointing at: the one on screen
+//! @param	the_flip -- reference to a valid PageFlip object
+Bitmap* PageFlip_GetShownPage(PageFlip* the_flip)
+{
+	if (the_flip == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		return NULL;
+	}
+
+	return the_flip->page_[1 - the_flip->draw_page_];
+}
+
+
+//! Get the timing and copy stats for the last flip
+//! @param	the_flip -- reference to a valid PageFlip object
+//! @param	frame_time -- receives the number of frames from the start of the last flipped render to the flip. Can be NULL.
+//! @param	pixels_replayed -- receives the number of pixels copied to keep the pages in step after the last flip. Can be NULL.
+//! @param	flip_count -- receives the number of flips done. Can be NULL.
+void PageFlip_GetStats(PageFlip* the_flip, uint32_t* frame_time, uint32_t* pixels_replayed, uint32_t* flip_count)
+{
+	if (the_flip == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		return;
+	}
+
+	if (frame_time != NULL)
+	{
+		*frame_time = the_flip->frame_time_;
+	}
+
+	if (pixels_replayed != NULL)
+	{
+		*pixels_replayed = the_flip->pixels_replayed_;
+	}
+
+	if (flip_count != NULL)
+	{
+		*flip_count = the_flip->flip_count_;
+	}
+}
@@ -0,0 +1,166 @@
+//! @file pageflip.h
+
+/*
+ * pageflip.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: agent
+ */
+
+#ifndef LIB_PAGEFLIP_H_
+#define LIB_PAGEFLIP_H_
+
+
+/* about this class: PageFlip
+ *
+ * Double-buffers a bitmap layer: the screen is composed into a hidden page, and the layer is switched over to it all at once, at the start of a frame.
+ * The VICKY finds a bitmap layer's pixels through a VRAM address register. Flipping is one write to that register, so a half-drawn frame is never shown.
+ *
+ * The two pages are kept identical, except for what has been drawn since the last flip: the damage.
+ *   Everything drawn into the hidden page must be reported with PageFlip_AddDamage().
+ *   After a flip, the page that is now hidden is out of date only in the damaged rects. Those are copied over from the shown page
+ *   (replayed) before anything else is drawn into it, so each flip costs a copy of only what changed, never a full page.
+ * PageFlip_Flip() is meant to be called from the start of frame interrupt: it does nothing unless PageFlip_QueueFlip() has asked for a flip,
+ *   and in that case it only writes the register and swaps the pages. The replay is done later, outside the interrupt.
+ * The register is passed in, so hosts and tests without a VICKY can point it at a variable in standard RAM.
+ *
+ *** things this class needs to be able to do
+ * hand out the page to draw into, brought up to date with the shown page
+ * track damage to the hidden page
+ * flip the pages at start of frame, without allocating or drawing anything in the interrupt
+ * keep the register pointing at the shown page if the VRAM heap moves it
+ * report how long renders take to reach the screen, and how much was copied to keep the pages in step
+ *
+ * STRETCH GOALS
+ * use VICKY/DMA for the replay copy
+ *
+ * SUPER STRETCH GOALS
+ *
+ *
+ */
+
+
+/*****************************************************************************/
+/*                                Includes                                   */
+/*****************************************************************************/
+
+// project includes
+#include "bitmap.h"
+
+// C includes
+#include <stdbool.h>
+#include <stdint.h>
+
+
+// A2560 includes
+#include <mcp/syscalls.h>
+#include "a2560k.h"
+
+
+/*****************************************************************************/
+/*                            Macro Definitions                              */
+/*****************************************************************************/
+
+
+
+/*****************************************************************************/
+/*                               Enumerations                                */
+/*****************************************************************************/
+
+
+
+/*****************************************************************************/
+/*                                 Structs                                   */
+/*****************************************************************************/
+
+struct PageFlip
+{
+	Bitmap*				page_[2];			//!< the two pages. Both must be the size of the screen, and in VRAM.
+	uint32_t			addr_reg_;			//!< address of the layer's VRAM address register (or a stand-in for it in standard RAM)
+	uint32_t			shown_addr_;		//!< address last written to the register. If the shown page's address no longer matches, the VRAM heap has moved it.
+	Region*				damage_;			//!< rects in which the two pages differ: drawn since the last flip, or not yet replayed since it
+	volatile uint8_t	draw_page_;			//!< index of the hidden page, the one to draw into. Swapped by PageFlip_Flip().
+	volatile bool		flip_pending_;		//!< set by PageFlip_QueueFlip(), cleared by PageFlip_Flip() once the pages have been swapped
+	volatile bool		replay_needed_;		//!< true after a flip, until the damage has been copied into the new hidden page
+	uint32_t			begin_frame_;		//!< frame number passed to the last PageFlip_BeginFrame()
+	uint32_t			frame_time_;		//!< frames from the start of the last flipped render to the flip: 0 means it made the frame it was started in
+	uint32_t			flip_count_;		//!< number of flips done
+	uint32_t			pixels_replayed_;	//!< pixels copied from the shown page to the hidden page after the last flip
+};
+
+
+
+/*****************************************************************************/
+/*                             Global Variables                              */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*                       Public Function Prototypes                          */
+/*****************************************************************************/
+
+
+// **** CONSTRUCTOR AND DESTRUCTOR *****
+
+// constructor
+//! Set up double-buffering for a bitmap layer. The current contents of the shown page are copied to the spare page, and the spare becomes the hidden page.
+//! The register is not written until the first flip: the shown page stays on screen.
+//! @param	the_shown_page -- the bitmap the layer is currently showing
+//! @param	the_spare_page -- a second bitmap of the same size, in VRAM. The PageFlip does not take ownership of either bitmap.
+//! @param	the_addr_reg -- address of the layer's VRAM address register. Tests can pass the address of a uint32_t in standard RAM.
+//! @return	Returns NULL on any error/invalid input
+PageFlip* PageFlip_New(Bitmap* the_shown_page, Bitmap* the_spare_page, uint32_t the_addr_reg);
+
+// destructor
+// frees all allocated memory associated with the passed object, and the object itself. The pages are not destroyed.
+//! @param	the_flip -- pointer to the pointer for the PageFlip object to be destroyed
+//! @return	Returns false if the pointer to the passed PageFlip was NULL
+bool PageFlip_Destroy(PageFlip** the_flip);
+
+
+// **** FRAME functions *****
+
+//! Get ready to draw a frame into the hidden page: replays damage from the last flip, and re-points the register if the shown page has moved
+//! @param	the_flip -- reference to a valid PageFlip object
+//! @param	the_frame -- current frame number, used to time the render
+//! @return	Returns false if a queued flip has not happened yet: the hidden page is still waiting to be shown, and must not be drawn into for the next frame
+bool PageFlip_BeginFrame(PageFlip* the_flip, uint32_t the_frame);
+
+//! Record that part of the hidden page has been drawn into
+//! @param	the_flip -- reference to a valid PageFlip object
+//! @param	the_rect -- the rect drawn into, in page coordinates
+//! @return	Returns false on any error condition
+bool PageFlip_AddDamage(PageFlip* the_flip, Rectangle* the_rect);
+
+//! Ask for the hidden page to be shown at the next PageFlip_Flip(). Nothing is queued if nothing has been drawn since the last flip.
+//! @param	the_flip -- reference to a valid PageFlip object
+//! @return	Returns true if a flip was queued
+bool PageFlip_QueueFlip(PageFlip* the_flip);
+
+//! If a flip has been queued, point the register at the hidden page and swap the pages. Safe to call from the start of frame interrupt.
+//! @param	the_flip -- reference to a valid PageFlip object
+//! @param	the_frame -- current frame number, used to time the render
+//! @return	Returns true if the pages were flipped
+bool PageFlip_Flip(PageFlip* the_flip, uint32_t the_frame);
+
+
+// **** GET functions *****
+
+//! Get the page to draw into. If there has been a flip since the last replay, the damage is replayed into it first.
+//! @param	the_flip -- reference to a valid PageFlip object
+Bitmap* PageFlip_GetDrawPage(PageFlip* the_flip);
+
+//! Get the page the register is pointing at: the one on screen
+//! @param	the_flip -- reference to a valid PageFlip object
+Bitmap* PageFlip_GetShownPage(PageFlip* the_flip);
+
+//! Get the timing and copy stats for the last flip
+//! @param	the_flip -- reference to a valid PageFlip object
+//! @param	frame_time -- receives the number of frames from the start of the last flipped render to the flip. Can be NULL.
+//! @param	pixels_replayed -- receives the number of pixels copied to keep the pages in step after the last flip. Can be NULL.
+//! @param	flip_count -- receives the number of flips done. Can be NULL.
+void PageFlip_GetStats(PageFlip* the_flip, uint32_t* frame_time, uint32_t* pixels_replayed, uint32_t* flip_count);
+
+
+
+#endif /* LIB_PAGEFLIP_H_ */
@@ -0,0 +1,281 @@
+/*
+ * pageflip_test.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: agent
+ */
+
+
+
+
+
+/*****************************************************************************/
+/*                                Includes                                   */
+/*****************************************************************************/
+
+// unit testing framework
+#include "debug.h"
+#include "minunit.h"
+
+// project includes
+#include "bitmap.h"
+#include "region.h"
+
+// class being tested
+#include "pageflip.h"
+
+// C includes
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+
+// A2560 includes
+#include "a2560k.h"
+
+
+
+/*****************************************************************************/
+/*                               Definitions                                 */
+/*****************************************************************************/
+
+#define PAGEFLIP_TEST_WIDTH		64
+#define PAGEFLIP_TEST_HEIGHT	48
+
+
+/*****************************************************************************/
+/*                               Enumerations                                */
+/*****************************************************************************/
+
+
+
+/*****************************************************************************/
+/*                             Global Variables                              */
+/*****************************************************************************/
+
+// LOGIC: the tests flip pages in standard RAM, and point the "register" at a variable, so what the VICKY would have been told can be checked
+static uint32_t		test_addr_reg;
+static Bitmap*		test_page_a;
+static Bitmap*		test_page_b;
+static PageFlip*	test_flip;
+
+
+/*****************************************************************************/
+/*                       Private Function Prototypes                         */
+/*****************************************************************************/
+
+// draw a filled box into the page to draw into, and report it as damage
+void Test_DrawDamage(int16_t x, int16_t y, int16_t width, int16_t height, uint8_t the_color);
+
+
+/*****************************************************************************/
+/*                       Private Function Definitions                        */
+/*****************************************************************************/
+
+// draw a filled box into the page to draw into, and report it as damage
+void Test_DrawDamage(int16_t x, int16_t y, int16_t width, int16_t height, uint8_t the_color)
+{
+	Rectangle	the_rect;
+
+	Bitmap_FillBox(PageFlip_GetDrawPage(test_flip), x, y, width, height, the_color);
+
+	the_rect.MinX = x;
+	the_rect.MinY = y;
+	the_rect.MaxX = x + width - 1;
+	the_rect.MaxY = y + height - 1;
+	PageFlip_AddDamage(test_flip, &the_rect);
+}
+
+
+
+
+/*****************************************************************************/
+/*                        MinUnit Function Defintions                        */
+/*****************************************************************************/
+
+
+
+void test_setup(void)	// this is called EVERY test
+{
+	test_addr_reg = 0xFFFFFFFF;
+
+	test_page_a = Bitmap_New(PAGEFLIP_TEST_WIDTH, PAGEFLIP_TEST_HEIGHT, NULL, PARAM_NOT_IN_VRAM);
+	test_page_b = Bitmap_New(PAGEFLIP_TEST_WIDTH, PAGEFLIP_TEST_HEIGHT, NULL, PARAM_NOT_IN_VRAM);
+	Bitmap_FillMemory(test_page_a, 0x11);
+	Bitmap_FillMemory(test_page_b, 0x22);
+
+	test_flip = PageFlip_New(test_page_a, test_page_b, (uint32_t)&test_addr_reg);
+}
+
+
+void test_teardown(void)	// this is called EVERY test
+{
+	if (test_flip)
+	{
+		PageFlip_Destroy(&test_flip);
+	}
+
+	Bitmap_Destroy(&test_page_a);
+	Bitmap_Destroy(&test_page_b);
+}
+
+
+
+// **** unit tests
+
+MU_TEST(pageflip_new_test)
+{
+	Bitmap*		the_small_page;
+
+	mu_assert(test_flip != NULL, "could not create page flip");
+
+	// the spare page starts as a copy of the shown page, and is the one to draw into. the register is left alone.
+	mu_check( PageFlip_GetShownPage(test_flip) == test_page_a );
+	mu_check( PageFlip_GetDrawPage(test_flip) == test_page_b );
+	mu_assert_int_eq(0x11, Bitmap_GetPixelAtXY(test_page_b, 0, 0));
+	mu_assert_int_eq(0x11, Bitmap_GetPixelAtXY(test_page_b, PAGEFLIP_TEST_WIDTH - 1, PAGEFLIP_TEST_HEIGHT - 1));
+	mu_assert_int_eq(0xFFFFFFFF, test_addr_reg);
+
+	// pages must be the same size
+	the_small_page = Bitmap_New(PAGEFLIP_TEST_WIDTH / 2, PAGEFLIP_TEST_HEIGHT, NULL, PARAM_NOT_IN_VRAM);
+	mu_check( PageFlip_New(test_page_a, the_small_page, (uint32_t)&test_addr_reg) == NULL );
+	Bitmap_Destroy(&the_small_page);
+}
+
+
+MU_TEST(pageflip_flip_test)
+{
+	uint32_t	the_frame_time;
+	uint32_t	the_flip_count;
+
+	mu_check( PageFlip_BeginFrame(test_flip, 100) == true );
+
+	// nothing drawn: nothing to flip
+	mu_check( PageFlip_QueueFlip(test_flip) == false );
+	mu_check( PageFlip_Flip(test_flip, 101) == false );
+	mu_assert_int_eq(0xFFFFFFFF, test_addr_reg);
+
+	Test_DrawDamage(4, 4, 8, 8, 0x33);
+	mu_check( PageFlip_QueueFlip(test_flip) == true );
+
+	// until the flip happens, the hidden page is spoken for
+	mu_check( PageFlip_BeginFrame(test_flip, 100) == false );
+	mu_check( PageFlip_GetShownPage(test_flip) == test_page_a );
+
+	// the flip points the register at the page that was drawn into, as a VICKY VRAM offset
+	mu_check( PageFlip_Flip(test_flip, 102) == true );
+	mu_assert_int_eq(test_page_b->addr_int_ - (uint32_t)VRAM_START, test_addr_reg);
+	mu_check( PageFlip_GetShownPage(test_flip) == test_page_b );
+	mu_check( PageFlip_Flip(test_flip, 103) == false );
+
+	PageFlip_GetStats(test_flip, &the_frame_time, NULL, &the_flip_count);
+	mu_assert_int_eq(2, the_frame_time);
+	mu_assert_int_eq(1, the_flip_count);
+
+	// and the next one points it back
+	mu_check( PageFlip_BeginFrame(test_flip, 110) == true );
+	Test_DrawDamage(0, 0, 2, 2, 0x44);
+	mu_check( PageFlip_QueueFlip(test_flip) == true );
+	mu_check( PageFlip_Flip(test_flip, 110) == true );
+	mu_assert_int_eq(test_page_a->addr_int_ - (uint32_t)VRAM_START, test_addr_reg);
+
+	PageFlip_GetStats(test_flip, &the_frame_time, NULL, &the_flip_count);
+	mu_assert_int_eq(0, the_frame_time);
+	mu_assert_int_eq(2, the_flip_count);
+}
+
+
+MU_TEST(pageflip_replay_test)
+{
+	uint32_t	the_pixels_replayed;
+
+	mu_check( PageFlip_BeginFrame(test_flip, 0) == true );
+	Test_DrawDamage(4, 4, 8, 8, 0x33);
+	Test_DrawDamage(20, 10, 4, 2, 0x55);
+	PageFlip_QueueFlip(test_flip);
+	PageFlip_Flip(test_flip, 1);
+
+	// mark a pixel outside the damage in the now-hidden page: only the damage should be copied over it
+	Bitmap_SetPixelAtXY(test_page_a, 40, 40, 0x77);
+
+	mu_check( PageFlip_BeginFrame(test_flip, 1) == true );
+	mu_assert_int_eq(0x33, Bitmap_GetPixelAtXY(test_page_a, 4, 4));
+	mu_assert_int_eq(0x33, Bitmap_GetPixelAtXY(test_page_a, 11, 11));
+	mu_assert_int_eq(0x11, Bitmap_GetPixelAtXY(test_page_a, 12, 12));
+	mu_assert_int_eq(0x55, Bitmap_GetPixelAtXY(test_page_a, 23, 11));
+	mu_assert_int_eq(0x77, Bitmap_GetPixelAtXY(test_page_a, 40, 40));
+
+	PageFlip_GetStats(test_flip, NULL, &the_pixels_replayed, NULL);
+	mu_assert_int_eq(8 * 8 + 4 * 2, the_pixels_replayed);
+
+	// the damage was used up by the replay: with nothing new drawn, there's nothing to flip
+	mu_check( PageFlip_QueueFlip(test_flip) == false );
+
+	// drawing without BeginFrame (eg, a menu, between renders) also gets the page brought up to date first
+	Test_DrawDamage(0, 0, 1, 1, 0x66);
+	PageFlip_QueueFlip(test_flip);
+	PageFlip_Flip(test_flip, 2);
+	Bitmap_SetPixelAtXY(test_page_b, 4, 4, 0x77);
+	mu_check( PageFlip_GetDrawPage(test_flip) == test_page_b );
+	mu_assert_int_eq(0x66, Bitmap_GetPixelAtXY(test_page_b, 0, 0));
+	mu_assert_int_eq(0x77, Bitmap_GetPixelAtXY(test_page_b, 4, 4));
+}
+
+
+MU_TEST(pageflip_moved_page_test)
+{
+	unsigned char*	the_old_addr;
+
+	mu_check( PageFlip_BeginFrame(test_flip, 0) == true );
+	Test_DrawDamage(0, 0, 4, 4, 0x33);
+	PageFlip_QueueFlip(test_flip);
+	PageFlip_Flip(test_flip, 0);
+
+	// the VRAM heap moves the page on screen (here, its pixels are just pointed somewhere else)
+	the_old_addr = test_page_b->addr_;
+	test_page_b->addr_ = test_page_a->addr_;
+	test_page_b->addr_int_ = (uint32_t)test_page_b->addr_;
+
+	// the next frame catches it, and points the register at the new address
+	mu_check( PageFlip_BeginFrame(test_flip, 1) == true );
+	mu_assert_int_eq(test_page_b->addr_int_ - (uint32_t)VRAM_START, test_addr_reg);
+
+	test_page_b->addr_ = the_old_addr;
+	test_page_b->addr_int_ = (uint32_t)the_old_addr;
+}
+
+
+
+// unit tests
+MU_TEST_SUITE(test_suite_units)
+{
+	MU_SUITE_CONFIGURE(&test_setup, &test_teardown);
+
+	MU_RUN_TEST(pageflip_new_test);
+	MU_RUN_TEST(pageflip_flip_test);
+	MU_RUN_TEST(pageflip_replay_test);
+	MU_RUN_TEST(pageflip_moved_page_test);
+}
+
+
+
+
+
+/*****************************************************************************/
+/*                        Public Function Definitions                        */
+/*****************************************************************************/
+
+
+
+int main(int argc, char* argv[])
+{
+	printf("**** pageflip.c Test Suite **** \n");
+
+	MU_RUN_SUITE(test_suite_units);
+	MU_REPORT();
+
+	printf("pageflip test complete \n");
+
+	return MU_EXIT_CODE;
+}
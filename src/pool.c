@@ -0,0 +1,518 @@
+/*
+ * pool.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: agent
+ */
+
+
+
+
+
+/*****************************************************************************/
+/*                                Includes                                   */
+/*****************************************************************************/
+
+// project includes
+#include "debug.h"
+#include "pool.h"
+
+// C includes
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// A2560 includes
+#include <mcp/syscalls.h>
+#include "a2560k.h"
+
+
+/*****************************************************************************/
+/*                               Definitions                                 */
+/*****************************************************************************/
+
+#define POOL_ARENA_TAG_USED		0x55534544	// 'USED': marks an allocated arena block, so stray and double frees can be caught
+#define POOL_ARENA_TAG_FREE		0x46524545	// 'FREE'
+
+#define POOL_ROUND_UP(x)		(((x) + (POOL_ALIGN - 1)) & ~(uint32_t)(POOL_ALIGN - 1))
+
+//! Header at the start of every arena block, free or allocated. The caller's buffer starts right after it.
+typedef struct PoolArenaBlock PoolArenaBlock;
+
+struct PoolArenaBlock
+{
+	uint32_t			size_;			// total bytes in the block, including this header
+	uint32_t			tag_;			// POOL_ARENA_TAG_USED or POOL_ARENA_TAG_FREE
+	PoolArenaBlock*		next_free_;		// next free block, in address order. only meaningful while the block is free.
+};
+
+#define POOL_ARENA_HEADER_SIZE	POOL_ROUND_UP(sizeof(PoolArenaBlock))
+
+//! Header at the start of every slab. The slab's objects start right after it.
+typedef struct PoolSlab PoolSlab;
+
+struct PoolSlab
+{
+	PoolSlab*			next_slab_;
+};
+
+#define POOL_SLAB_HEADER_SIZE	POOL_ROUND_UP(sizeof(PoolSlab))
+
+
+/*****************************************************************************/
+/*                               Enumerations                                */
+/*****************************************************************************/
+
+
+
+/*****************************************************************************/
+/*                          File-scoped Variables                            */
+/*****************************************************************************/
+
+static Pool*			pool_list = NULL;				// every pool that has allocated at least one slab
+
+static uint8_t*			pool_arena = NULL;				// start of the arena. NULL until Pool_InitArena() sets one up: every buffer comes from the heap.
+static uint32_t			pool_arena_size = 0;
+static PoolArenaBlock*	pool_arena_free_list = NULL;	// free blocks, in address order
+static uint32_t			pool_arena_in_use = 0;
+static uint32_t			pool_arena_high_water = 0;
+static uint32_t			pool_arena_heap_fallbacks = 0;
+
+
+/*****************************************************************************/
+/*                             Global Variables                              */
+/*****************************************************************************/
+
+
+
+/*****************************************************************************/
+/*                       Private Function Prototypes                         */
+/*****************************************************************************/
+
+//! Allocate a new slab from the heap for the pool, and add all its objects to the pool's free list
+bool Pool_AddSlab(Pool* the_pool);
+
+//! Returns true if the buffer is inside the arena (as opposed to having come from the heap)
+bool Pool_ArenaOwns(void* the_buffer);
+
+
+/*****************************************************************************/
+/*                       Private Function Definitions                        */
+/*****************************************************************************/
+
+//! \cond PRIVATE
+
+//! Allocate a new slab from the heap for the pool, and add all its objects to the pool's free list
+bool Pool_AddSlab(Pool* the_pool)
+{
+	PoolSlab*	the_slab;
+	uint8_t*	the_object;
+	uint32_t	slab_size;
+	int16_t		i;
+
+	if (the_pool->num_slabs_ == 0)
+	{
+		// first slab: settle the object size. a free object has to be able to hold the free list link.
+		if (the_pool->object_size_ < sizeof(void*))
+		{
+			the_pool->object_size_ = sizeof(void*);
+		}
+
+		the_pool->object_size_ = POOL_ROUND_UP(the_pool->object_size_);
+
+		if (the_pool->objects_per_slab_ < 1)
+		{
+			the_pool->objects_per_slab_ = 1;
+		}
+	}
+
+	slab_size = POOL_SLAB_HEADER_SIZE + (uint32_t)the_pool->object_size_ * the_pool->objects_per_slab_;
+
+	if ( (the_slab = (PoolSlab*)calloc(1, slab_size)) == NULL)
+	{
+		LOG_ERR(("%s %d: could not allocate a %lu byte slab for the %s pool", __func__ , __LINE__, slab_size, the_pool->name_));
+		return false;
+	}
+	LOG_ALLOC(("%s %d:	__ALLOC__	%s slab	%p	size	%lu", __func__ , __LINE__, the_pool->name_, the_slab, slab_size));
+
+	the_slab->next_slab_ = (PoolSlab*)the_pool->slabs_;
+	the_pool->slabs_ = the_slab;
+
+	if (the_pool->num_slabs_++ == 0)
+	{
+		the_pool->next_pool_ = pool_list;
+		pool_list = the_pool;
+	}
+
+	// push the objects last to first, so they are handed out in address order
+	the_object = (uint8_t*)the_slab + POOL_SLAB_HEADER_SIZE + (uint32_t)the_pool->object_size_ * (the_pool->objects_per_slab_ - 1);
+
+	for (i = 0; i < the_pool->objects_per_slab_; i++)
+	{
+		*(void**)the_object = the_pool->free_list_;
+		the_pool->free_list_ = the_object;
+		the_object -= the_pool->object_size_;
+	}
+
+	return true;
+}
+
+
+//! Returns true if the buffer is inside the arena (as opposed to having come from the heap)
+bool Pool_ArenaOwns(void* the_buffer)
+{
+	return (pool_arena != NULL && (uint8_t*)the_buffer >= pool_arena && (uint8_t*)the_buffer < pool_arena + pool_arena_size);
+}
+
+
+//! \endcond
+
+
+
+/*****************************************************************************/
+/*                        Public Function Definitions                        */
+/*****************************************************************************/
+
+
+// **** SLAB POOLS *****
+
+//! Allocate one zeroed object from a pool. If the pool has no free objects, a new slab is allocated from the heap.
+//! @param	the_pool -- a Pool set up with POOL_INITIALIZER
+//! @return	Returns a pointer to the object, or NULL if the heap had no room for a new slab
+void* Pool_Alloc(Pool* the_pool)
+{
+	void*	the_object;
+
+	if (the_pool == NULL)
+	{
+		LOG_ERR(("%s %d: passed pool was null", __func__ , __LINE__));
+		return NULL;
+	}
+
+	if (the_pool->free_list_ == NULL)
+	{
+		if (Pool_AddSlab(the_pool) == false)
+		{
+			return NULL;
+		}
+	}
+
+	the_object = the_pool->free_list_;
+	the_pool->free_list_ = *(void**)the_object;
+	memset(the_object, 0, the_pool->object_size_);
+
+	if (++the_pool->in_use_ > the_pool->high_water_)
+	{
+		the_pool->high_water_ = the_pool->in_use_;
+	}
+
+	return the_object;
+}
+
+
+//! Return an object to the pool it was allocated from. The memory is kept by the pool for re-use, not returned to the heap.
+//! @param	the_pool -- the Pool that the object was allocated from
+//! @param	the_object -- the object to return. NULL is ignored.
+void Pool_Free(Pool* the_pool, void* the_object)
+{
+	if (the_pool == NULL || the_object == NULL)
+	{
+		return;
+	}
+
+	if (the_pool->in_use_ == 0)
+	{
+		LOG_ERR(("%s %d: more objects freed than allocated from the %s pool (%p)", __func__ , __LINE__, the_pool->name_, the_object));
+		return;
+	}
+
+	*(void**)the_object = the_pool->free_list_;
+	the_pool->free_list_ = the_object;
+	--the_pool->in_use_;
+}
+
+
+// **** BUFFER ARENA *****
+
+//! Set up the buffer arena, replacing any arena already set up, or give the arena back to the heap
+//! Call before the first buffer is allocated, normally before Sys_InitSystem(). Until it is called, every buffer comes from the heap.
+//! @param	the_size -- bytes to take from the heap for the arena. 0 to have no arena.
+//! @return	Returns false if buffers are still allocated from the current arena (it is left as it was), or if the heap had no room for the new one
+bool Pool_InitArena(uint32_t the_size)
+{
+	// LOGIC:
+	//   the arena can only be replaced while it is empty: a buffer still in it would be left pointing at freed memory.
+	//   buffers that came from the heap don't matter. they are recognized by their address, and go back to the heap whatever the arena is.
+	
+	if (pool_arena_in_use > 0)
+	{
+		LOG_ERR(("%s %d: %lu bytes of buffers are still allocated from the arena", __func__ , __LINE__, pool_arena_in_use));
+		return false;
+	}
+
+	if (pool_arena != NULL)
+	{
+		LOG_ALLOC(("%s %d:	__FREE__	pool_arena	%p	size	%lu", __func__ , __LINE__, pool_arena, pool_arena_size));
+		free(pool_arena);
+		pool_arena = NULL;
+		pool_arena_size = 0;
+		pool_arena_free_list = NULL;
+	}
+
+	the_size &= ~(uint32_t)(POOL_ALIGN - 1);
+
+	if (the_size <= POOL_ARENA_HEADER_SIZE)
+	{
+		return (the_size == 0);
+	}
+
+	if ( (pool_arena = (uint8_t*)malloc(the_size)) == NULL)
+	{
+		LOG_ERR(("%s %d: could not allocate %lu byte buffer arena; buffers will be allocated from the heap", __func__ , __LINE__, the_size));
+		return false;
+	}
+	LOG_ALLOC(("%s %d:	__ALLOC__	pool_arena	%p	size	%lu", __func__ , __LINE__, pool_arena, the_size));
+
+	pool_arena_size = the_size;
+	pool_arena_high_water = 0;
+	pool_arena_free_list = (PoolArenaBlock*)pool_arena;
+	pool_arena_free_list->size_ = pool_arena_size;
+	pool_arena_free_list->tag_ = POOL_ARENA_TAG_FREE;
+	pool_arena_free_list->next_free_ = NULL;
+
+	return true;
+}
+
+
+//! Allocate a zeroed buffer from the arena, using the smallest free block it fits in
+//! If there is no arena, or no free block big enough, the buffer comes from the heap.
+//! @param	the_size -- number of bytes needed
+//! @return	Returns a pointer to the buffer, or NULL if neither the arena nor the heap had room
+void* Pool_ArenaAlloc(uint32_t the_size)
+{
+	PoolArenaBlock*		this_block;
+	PoolArenaBlock*		prev_block;
+	PoolArenaBlock*		best_block = NULL;
+	PoolArenaBlock*		best_prev = NULL;
+	PoolArenaBlock*		the_block;
+	uint32_t			block_size;
+	void*				the_buffer;
+
+	if (the_size == 0)
+	{
+		LOG_ERR(("%s %d: zero-length buffer requested", __func__ , __LINE__));
+		return NULL;
+	}
+
+	block_size = POOL_ROUND_UP(the_size) + POOL_ARENA_HEADER_SIZE;
+
+	// LOGIC:
+	//   best fit: take the smallest free block the buffer fits in, so big free blocks stay big for the next big window
+	//   an exact fit can't be beaten, so stop looking if one turns up
+
+	if (block_size > the_size)	// (guards against wrap-around of huge requests)
+	{
+		prev_block = NULL;
+
+		for (this_block = pool_arena_free_list; this_block != NULL; this_block = this_block->next_free_)
+		{
+			if (this_block->size_ >= block_size && (best_block == NULL || this_block->size_ < best_block->size_))
+			{
+				best_block = this_block;
+				best_prev = prev_block;
+
+				if (this_block->size_ == block_size)
+				{
+					break;
+				}
+			}
+
+			prev_block = this_block;
+		}
+	}
+
+	if (best_block == NULL)
+	{
+		if ( (the_buffer = calloc(1, the_size)) == NULL)
+		{
+			LOG_ERR(("%s %d: could not allocate %lu byte buffer from arena or heap", __func__ , __LINE__, the_size));
+			return NULL;
+		}
+
+		if (pool_arena != NULL)
+		{
+			LOG_WARN(("%s %d: no arena block for %lu byte buffer; allocated from heap instead", __func__ , __LINE__, the_size));
+			++pool_arena_heap_fallbacks;
+		}
+
+		return the_buffer;
+	}
+
+	if (best_block->size_ - block_size >= POOL_ARENA_MIN_SPLIT)
+	{
+		// split: carve the new block from the end of the free block, so the free block keeps its place in the free list
+		best_block->size_ -= block_size;
+		the_block = (PoolArenaBlock*)((uint8_t*)best_block + best_block->size_);
+		the_block->size_ = block_size;
+	}
+	else
+	{
+		// use the whole free block: the few bytes left over would be too small to ever be useful
+		if (best_prev == NULL)
+		{
+			pool_arena_free_list = best_block->next_free_;
+		}
+		else
+		{
+			best_prev->next_free_ = best_block->next_free_;
+		}
+
+		the_block = best_block;
+	}
+
+	the_block->tag_ = POOL_ARENA_TAG_USED;
+	the_block->next_free_ = NULL;
+
+	pool_arena_in_use += the_block->size_;
+
+	if (pool_arena_in_use > pool_arena_high_water)
+	{
+		pool_arena_high_water = pool_arena_in_use;
+	}
+
+	the_buffer = (uint8_t*)the_block + POOL_ARENA_HEADER_SIZE;
+	memset(the_buffer, 0, the_block->size_ - POOL_ARENA_HEADER_SIZE);
+
+	return the_buffer;
+}
+
+
+//! Return a buffer allocated with Pool_ArenaAlloc(). The block is merged with any free neighbors.
+//! @param	the_buffer -- the buffer to free. NULL is ignored.
+void Pool_ArenaFree(void* the_buffer)
+{
+	PoolArenaBlock*		the_block;
+	PoolArenaBlock*		prev_block;
+	PoolArenaBlock*		next_block;
+
+	if (the_buffer == NULL)
+	{
+		return;
+	}
+
+	if (Pool_ArenaOwns(the_buffer) == false)
+	{
+		// this one didn't fit in the arena when it was allocated
+		free(the_buffer);
+		return;
+	}
+
+	the_block = (PoolArenaBlock*)((uint8_t*)the_buffer - POOL_ARENA_HEADER_SIZE);
+
+	if (the_block->tag_ != POOL_ARENA_TAG_USED)
+	{
+		LOG_ERR(("%s %d: buffer %p is not an allocated arena block (already freed?)", __func__ , __LINE__, the_buffer));
+		return;
+	}
+
+	pool_arena_in_use -= the_block->size_;
+	the_block->tag_ = POOL_ARENA_TAG_FREE;
+
+	// find where the block goes in the address-ordered free list
+	prev_block = NULL;
+	next_block = pool_arena_free_list;
+
+	while (next_block != NULL && next_block < the_block)
+	{
+		prev_block = next_block;
+		next_block = next_block->next_free_;
+	}
+
+	// merge with the following free block if they touch
+	if (next_block != NULL && (uint8_t*)the_block + the_block->size_ == (uint8_t*)next_block)
+	{
+		the_block->size_ += next_block->size_;
+		next_block->tag_ = 0;
+		next_block = next_block->next_free_;
+	}
+
+	the_block->next_free_ = next_block;
+
+	// merge with the preceding free block if they touch
+	if (prev_block != NULL && (uint8_t*)prev_block + prev_block->size_ == (uint8_t*)the_block)
+	{
+		prev_block->size_ += the_block->size_;
+		prev_block->next_free_ = the_block->next_free_;
+		the_block->tag_ = 0;
+	}
+	else if (prev_block != NULL)
+	{
+		prev_block->next_free_ = the_block;
+	}
+	else
+	{
+		pool_arena_free_list = the_block;
+	}
+}
+
+
+// **** STATS *****
+
+//! Get current usage, high-water mark, and fragmentation stats for the buffer arena
+//! @param	the_stats -- filled with the current stats
+void Pool_GetArenaStats(PoolArenaStats* the_stats)
+{
+	PoolArenaBlock*		this_block;
+
+	if (the_stats == NULL)
+	{
+		LOG_ERR(("%s %d: passed stats struct was null", __func__ , __LINE__));
+		return;
+	}
+
+	the_stats->size_ = pool_arena_size;
+	the_stats->in_use_ = pool_arena_in_use;
+	the_stats->high_water_ = pool_arena_high_water;
+	the_stats->heap_fallbacks_ = pool_arena_heap_fallbacks;
+	the_stats->free_ = 0;
+	the_stats->largest_free_ = 0;
+	the_stats->num_free_blocks_ = 0;
+	the_stats->fragmentation_ = 0;
+
+	for (this_block = pool_arena_free_list; this_block != NULL; this_block = this_block->next_free_)
+	{
+		the_stats->free_ += this_block->size_;
+		++the_stats->num_free_blocks_;
+
+		if (this_block->size_ > the_stats->largest_free_)
+		{
+			the_stats->largest_free_ = this_block->size_;
+		}
+	}
+
+	if (the_stats->free_ > 0)
+	{
+		the_stats->fragmentation_ = 100 - (uint16_t)((the_stats->largest_free_ * 100) / the_stats->free_);
+	}
+}
+
+
+//! Write usage stats for each slab pool and for the buffer arena to the allocation log. Does nothing unless LOG_LEVEL_5 is defined.
+void Pool_LogStats(void)
+{
+#ifdef LOG_LEVEL_5
+	Pool*			this_pool;
+	PoolArenaStats	the_stats;
+
+	for (this_pool = pool_list; this_pool != NULL; this_pool = this_pool->next_pool_)
+	{
+		LOG_ALLOC(("%s %d:	__POOL__	%s	in use	%u	high water	%u	capacity	%u	slabs	%u	bytes	%lu", __func__ , __LINE__, this_pool->name_, this_pool->in_use_, this_pool->high_water_, this_pool->num_slabs_ * this_pool->objects_per_slab_, this_pool->num_slabs_, (uint32_t)this_pool->num_slabs_ * (POOL_SLAB_HEADER_SIZE + (uint32_t)this_pool->object_size_ * this_pool->objects_per_slab_)));
+	}
+
+	Pool_GetArenaStats(&the_stats);
+
+	LOG_ALLOC(("%s %d:	__POOL__	arena	in use	%lu	high water	%lu	size	%lu	free blocks	%u	largest free	%lu	fragmentation	%u%%	heap fallbacks	%lu", __func__ , __LINE__, the_stats.in_use_, the_stats.high_water_, the_stats.size_, the_stats.num_free_blocks_, the_stats.largest_free_, the_stats.fragmentation_, the_stats.heap_fallbacks_));
+#endif
+}
@@ -0,0 +1,167 @@
+//! @file pool.h
+
+/*
+ * pool.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: agent
+ */
+
+#ifndef LIB_POOL_H_
+#define LIB_POOL_H_
+
+
+/* about this class: Pool
+ *
+ * The heap is a fixed size (see HEAP_SIZE in the makefile), and never grows. Opening and closing windows for hours
+ * with plain calloc/free leaves it fragmented: there is enough memory free in total, but not in one piece.
+ * This class keeps the 2 kinds of allocation that churn the most out of the general heap:
+ *
+ * Slab pools, for small fixed-size structs (Bitmap, Control, List, EventRecord)
+ *   Each struct type has its own Pool. A pool gets memory from the heap in slabs of many objects at a time.
+ *   Freed objects go back on the pool's free list and are handed out again by the next allocation from that pool.
+ *   Slabs are never given back to the heap, so small structs can't leave holes between large buffers.
+ *
+ * A best-fit arena, for large buffers (bitmap pixel storage)
+ *   Programs that open and close many large windows set one up with Pool_InitArena(), sized for what they need.
+ *   One big block is taken from the heap then, and all buffers are carved from it. Without it, buffers come from the heap.
+ *   Free blocks are kept in address order and merged with their neighbors when freed.
+ *   If the arena can't fit a request, it comes from the heap instead (and is counted, so it shows up in the stats).
+ *   Once every buffer in it has been freed, Pool_InitArena(0) gives the arena back to the heap.
+ *
+ * Both report in-use counts, high-water marks, and fragmentation. With LOG_LEVEL_5 (the level that enables TRACK_ALLOC),
+ *   Pool_LogStats() writes them to the allocation log.
+ *
+ *** things this class needs to be able to do
+ * hand out and take back fixed-size zeroed objects
+ * hand out and take back variable-size zeroed buffers
+ * report high-water marks and fragmentation
+ *
+ * STRETCH GOALS
+ *
+ *
+ * SUPER STRETCH GOALS
+ *
+ *
+ */
+
+
+/*****************************************************************************/
+/*                                Includes                                   */
+/*****************************************************************************/
+
+// project includes
+
+// C includes
+#include <stdbool.h>
+#include <stdint.h>
+
+
+// A2560 includes
+#include <mcp/syscalls.h>
+#include "a2560k.h"
+
+
+/*****************************************************************************/
+/*                            Macro Definitions                              */
+/*****************************************************************************/
+
+#define POOL_ALIGN					4		//!< object sizes and arena block sizes are rounded up to a multiple of this many bytes
+#define POOL_ARENA_DEFAULT_SIZE		262144	//!< a starting point for Pool_InitArena(): enough for a few large off-screen windows, while leaving most of HEAP_SIZE to the heap
+#define POOL_ARENA_MIN_SPLIT		64		//!< a free arena block is only split if the part left over would be at least this many bytes
+
+//! Static initializer for a Pool. the_name is used in stats output; objects_per_slab is how many objects to get from the heap at a time.
+#define POOL_INITIALIZER(the_name, the_type, objects_per_slab)		{ the_name, sizeof(the_type), objects_per_slab, NULL, NULL, 0, 0, 0, NULL }
+
+
+/*****************************************************************************/
+/*                               Enumerations                                */
+/*****************************************************************************/
+
+
+
+/*****************************************************************************/
+/*                                 Structs                                   */
+/*****************************************************************************/
+
+struct Pool
+{
+	const char*		name_;				//!< name of the type of object in the pool. used for stats output only.
+	uint16_t		object_size_;		//!< bytes per object. rounded up to POOL_ALIGN, and to hold a pointer, when the first slab is allocated.
+	uint16_t		objects_per_slab_;	//!< number of objects allocated from the heap each time the pool runs out
+	void*			free_list_;			//!< free objects. each free object holds a pointer to the next one in its first bytes.
+	void*			slabs_;				//!< slabs allocated from the heap. each slab holds a pointer to the next one in its first bytes.
+	uint16_t		num_slabs_;			//!< number of slabs allocated so far
+	uint16_t		in_use_;			//!< number of objects currently allocated from the pool
+	uint16_t		high_water_;		//!< most objects ever allocated from the pool at once
+	Pool*			next_pool_;			//!< next pool in the list of pools that have allocated at least one slab. used for stats output.
+};
+
+struct PoolArenaStats
+{
+	uint32_t		size_;				//!< total bytes in the arena. 0 if the arena has not been set up yet.
+	uint32_t		in_use_;			//!< bytes in allocated blocks, including block headers
+	uint32_t		high_water_;		//!< most bytes ever in allocated blocks at once
+	uint32_t		free_;				//!< bytes in free blocks
+	uint32_t		largest_free_;		//!< bytes in the largest free block: the biggest block that could be allocated right now
+	uint16_t		num_free_blocks_;	//!< number of separate free blocks
+	uint16_t		fragmentation_;		//!< percent of free bytes that are not in the largest free block. 0 means all free space is in one piece.
+	uint32_t		heap_fallbacks_;	//!< number of allocations that did not fit in the arena and were taken from the heap. Not counted while there is no arena.
+};
+
+
+
+/*****************************************************************************/
+/*                             Global Variables                              */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*                       Public Function Prototypes                          */
+/*****************************************************************************/
+
+
+// **** SLAB POOLS *****
+
+//! Allocate one zeroed object from a pool. If the pool has no free objects, a new slab is allocated from the heap.
+//! @param	the_pool -- a Pool set up with POOL_INITIALIZER
+//! @return	Returns a pointer to the object, or NULL if the heap had no room for a new slab
+void* Pool_Alloc(Pool* the_pool);
+
+//! Return an object to the pool it was allocated from. The memory is kept by the pool for re-use, not returned to the heap.
+//! @param	the_pool -- the Pool that the object was allocated from
+//! @param	the_object -- the object to return. NULL is ignored.
+void Pool_Free(Pool* the_pool, void* the_object);
+
+
+// **** BUFFER ARENA *****
+
+//! Set up the buffer arena, replacing any arena already set up, or give the arena back to the heap
+//! Call before the first buffer is allocated, normally before Sys_InitSystem(). Until it is called, every buffer comes from the heap.
+//! @param	the_size -- bytes to take from the heap for the arena. 0 to have no arena.
+//! @return	Returns false if buffers are still allocated from the current arena (it is left as it was), or if the heap had no room for the new one
+bool Pool_InitArena(uint32_t the_size);
+
+//! Allocate a zeroed buffer from the arena, using the smallest free block it fits in
+//! If there is no arena, or no free block big enough, the buffer comes from the heap.
+//! @param	the_size -- number of bytes needed
+//! @return	Returns a pointer to the buffer, or NULL if neither the arena nor the heap had room
+void* Pool_ArenaAlloc(uint32_t the_size);
+
+//! Return a buffer allocated with Pool_ArenaAlloc(). The block is merged with any free neighbors.
+//! @param	the_buffer -- the buffer to free. NULL is ignored.
+void Pool_ArenaFree(void* the_buffer);
+
+
+// **** STATS *****
+
+//! Get current usage, high-water mark, and fragmentation stats for the buffer arena
+//! @param	the_stats -- filled with the current stats
+void Pool_GetArenaStats(PoolArenaStats* the_stats);
+
+//! Write usage stats for each slab pool and for the buffer arena to the allocation log. Does nothing unless LOG_LEVEL_5 is defined.
+void Pool_LogStats(void);
+
+
+
+#endif /* LIB_POOL_H_ */
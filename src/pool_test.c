@@ -0,0 +1,579 @@
+/*
+ * pool_test.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: agent
+ */
+
+
+
+
+
+
+/*****************************************************************************/
+/*                                Includes                                   */
+/*****************************************************************************/
+
+// unit testing framework
+#include "debug.h"
+#include "minunit.h"
+
+// project includes
+
+// class being tested
+#include "pool.h"
+
+// C includes
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+// A2560 includes
+#include "a2560k.h"
+
+
+
+/*****************************************************************************/
+/*                               Definitions                                 */
+/*****************************************************************************/
+
+#define POOL_TEST_OBJECTS			100		//!< number of objects allocated at once in the slab pool tests
+#define POOL_TEST_BUFFERS			24		//!< number of buffers live at once in the churn tests
+#define POOL_TEST_CHURN_STEPS		2000	//!< number of free + allocate pairs in the churn tests
+#define POOL_TEST_MIN_BUFFER		2048	//!< smallest buffer in the churn tests: a small dialog's bitmap
+#define POOL_TEST_MAX_BUFFER		32768	//!< biggest buffer in the churn tests: a mid-sized window's bitmap. on average, the live buffers fill about half the arena.
+#define POOL_TEST_ARENA_SIZE		786432	//!< size of the arena the tests set up
+#define POOL_TEST_HEAP_PROBE_MAX	1500000	//!< largest heap block to probe for when measuring heap fragmentation (HEAP_SIZE in the makefile)
+
+#define POOL_SPEED_TEST_OPS			5000	//!< number of allocate + free pairs in the throughput speed test
+
+
+/*****************************************************************************/
+/*                               Enumerations                                */
+/*****************************************************************************/
+
+
+
+/*****************************************************************************/
+/*                                 Structs                                   */
+/*****************************************************************************/
+
+// stands in for one of the small library structs the pools are used for
+typedef struct PoolTestObject
+{
+	int32_t		value_;
+	void*		ptr_;
+	int16_t		x_;
+	int16_t		y_;
+	uint8_t		bytes_[21];		// odd size, to check rounding up of object size
+} PoolTestObject;
+
+
+
+/*****************************************************************************/
+/*                             Global Variables                              */
+/*****************************************************************************/
+
+static uint32_t		test_random_seed = 12345;
+
+static Pool			test_pool = POOL_INITIALIZER("PoolTestObject", PoolTestObject, 16);
+
+
+/*****************************************************************************/
+/*                       Private Function Prototypes                         */
+/*****************************************************************************/
+
+// repeatable pseudo-random number from 0 to the_range - 1. (General_GetRandom uses the hardware generator, which can't be re-seeded for a repeatable test)
+uint32_t Test_Random(uint32_t the_range);
+
+// returns true if every byte of the buffer is 0
+bool Test_IsZeroed(uint8_t* the_buffer, uint32_t the_size);
+
+// find the biggest single block the heap can currently supply, to the nearest 1K (up to the_max)
+uint32_t Test_LargestHeapBlock(uint32_t the_max);
+
+// churn a set of buffers: repeatedly free a random one, and allocate a new random-sized one in its place. uses the arena if use_arena, else calloc.
+void Test_ChurnBuffers(void** the_buffers, bool use_arena);
+
+
+/*****************************************************************************/
+/*                       Private Function Definitions                        */
+/*****************************************************************************/
+
+// repeatable pseudo-random number from 0 to the_range - 1. (General_GetRandom uses the hardware generator, which can't be re-seeded for a repeatable test)
+uint32_t Test_Random(uint32_t the_range)
+{
+	test_random_seed = test_random_seed * 1103515245 + 12345;
+
+	return ((test_random_seed >> 8) & 0x00FFFFFF) % the_range;
+}
+
+
+// returns true if every byte of the buffer is 0
+bool Test_IsZeroed(uint8_t* the_buffer, uint32_t the_size)
+{
+	uint32_t	i;
+
+	for (i = 0; i < the_size; i++)
+	{
+		if (the_buffer[i] != 0)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+// find the biggest single block the heap can currently supply, to the nearest 1K (up to the_max)
+uint32_t Test_LargestHeapBlock(uint32_t the_max)
+{
+	uint32_t	low = 0;
+	uint32_t	high = the_max / 1024;
+	uint32_t	mid;
+	void*		the_block;
+
+	while (low < high)
+	{
+		mid = (low + high + 1) / 2;
+
+		if ( (the_block = malloc(mid * 1024)) != NULL)
+		{
+			free(the_block);
+			low = mid;
+		}
+		else
+		{
+			high = mid - 1;
+		}
+	}
+
+	return low * 1024;
+}
+
+
+// churn a set of buffers: repeatedly free a random one, and allocate a new random-sized one in its place. uses the arena if use_arena, else calloc.
+void Test_ChurnBuffers(void** the_buffers, bool use_arena)
+{
+	uint32_t	the_size;
+	int16_t		i;
+	int16_t		the_index;
+
+	test_random_seed = 54321;
+
+	for (i = 0; i < POOL_TEST_BUFFERS; i++)
+	{
+		the_size = POOL_TEST_MIN_BUFFER + Test_Random(POOL_TEST_MAX_BUFFER - POOL_TEST_MIN_BUFFER);
+		the_buffers[i] = (use_arena ? Pool_ArenaAlloc(the_size) : calloc(1, the_size));
+	}
+
+	for (i = 0; i < POOL_TEST_CHURN_STEPS; i++)
+	{
+		the_index = Test_Random(POOL_TEST_BUFFERS);
+		the_size = POOL_TEST_MIN_BUFFER + Test_Random(POOL_TEST_MAX_BUFFER - POOL_TEST_MIN_BUFFER);
+
+		if (use_arena)
+		{
+			Pool_ArenaFree(the_buffers[the_index]);
+			the_buffers[the_index] = Pool_ArenaAlloc(the_size);
+		}
+		else
+		{
+			free(the_buffers[the_index]);
+			the_buffers[the_index] = calloc(1, the_size);
+		}
+	}
+}
+
+
+
+
+/*****************************************************************************/
+/*                        MinUnit Function Defintions                        */
+/*****************************************************************************/
+
+
+
+void test_setup(void)	// this is called EVERY test
+{
+// 	foo = 7;
+// 	bar = 4;
+//
+}
+
+
+void test_teardown(void)	// this is called EVERY test
+{
+
+}
+
+
+
+// **** unit tests
+
+MU_TEST(pool_slab_test)
+{
+	PoolTestObject*		the_objects[POOL_TEST_OBJECTS];
+	PoolTestObject*		the_object;
+	int16_t				i;
+	int16_t				j;
+
+	for (i = 0; i < POOL_TEST_OBJECTS; i++)
+	{
+		the_objects[i] = (PoolTestObject*)Pool_Alloc(&test_pool);
+		mu_assert(the_objects[i] != NULL, "pool could not allocate object");
+		mu_assert(Test_IsZeroed((uint8_t*)the_objects[i], sizeof(PoolTestObject)), "object from pool was not zeroed");
+		mu_assert_int_eq(0, (uint32_t)the_objects[i] % POOL_ALIGN);
+
+		// scribble on it, so re-use of a live object would show up
+		memset(the_objects[i], i + 1, sizeof(PoolTestObject));
+	}
+
+	mu_assert_int_eq(POOL_TEST_OBJECTS, test_pool.in_use_);
+	mu_assert_int_eq(POOL_TEST_OBJECTS, test_pool.high_water_);
+	mu_assert_int_eq((POOL_TEST_OBJECTS + 15) / 16, test_pool.num_slabs_);
+
+	// no 2 objects overlap, and none was overwritten by a later allocation
+	for (i = 0; i < POOL_TEST_OBJECTS; i++)
+	{
+		mu_assert_int_eq(i + 1, the_objects[i]->bytes_[20]);
+
+		for (j = i + 1; j < POOL_TEST_OBJECTS; j++)
+		{
+			mu_check( (uint8_t*)the_objects[i] + sizeof(PoolTestObject) <= (uint8_t*)the_objects[j] || (uint8_t*)the_objects[j] + sizeof(PoolTestObject) <= (uint8_t*)the_objects[i] );
+		}
+	}
+
+	// free every other object; the next allocation re-uses the most recently freed one, and the pool doesn't grow
+	for (i = 0; i < POOL_TEST_OBJECTS; i += 2)
+	{
+		Pool_Free(&test_pool, the_objects[i]);
+	}
+
+	mu_assert_int_eq(POOL_TEST_OBJECTS / 2, test_pool.in_use_);
+
+	the_object = (PoolTestObject*)Pool_Alloc(&test_pool);
+	mu_check( the_object == the_objects[POOL_TEST_OBJECTS - 2] );
+	mu_assert(Test_IsZeroed((uint8_t*)the_object, sizeof(PoolTestObject)), "re-used object was not zeroed");
+	the_objects[POOL_TEST_OBJECTS - 2] = the_object;
+
+	for (i = 0; i < POOL_TEST_OBJECTS - 2; i += 2)
+	{
+		the_objects[i] = (PoolTestObject*)Pool_Alloc(&test_pool);
+	}
+
+	mu_assert_int_eq((POOL_TEST_OBJECTS + 15) / 16, test_pool.num_slabs_);
+	mu_assert_int_eq(POOL_TEST_OBJECTS, test_pool.high_water_);
+
+	for (i = 0; i < POOL_TEST_OBJECTS; i++)
+	{
+		Pool_Free(&test_pool, the_objects[i]);
+	}
+
+	mu_assert_int_eq(0, test_pool.in_use_);
+
+	// freeing NULL is harmless
+	Pool_Free(&test_pool, NULL);
+	mu_assert_int_eq(0, test_pool.in_use_);
+}
+
+
+MU_TEST(pool_arena_test)
+{
+	PoolArenaStats	the_stats;
+	uint8_t*		a;
+	uint8_t*		b;
+	uint8_t*		c;
+	uint8_t*		d;
+	uint8_t*		the_big_one;
+	uint32_t		start_in_use;
+
+	Pool_GetArenaStats(&the_stats);
+	start_in_use = the_stats.in_use_;
+
+	a = (uint8_t*)Pool_ArenaAlloc(10000);
+	mu_assert(a != NULL, "arena could not allocate buffer");
+
+	Pool_GetArenaStats(&the_stats);
+	mu_assert_int_eq(POOL_TEST_ARENA_SIZE, the_stats.size_);
+	mu_check( the_stats.in_use_ >= start_in_use + 10000 );
+
+	b = (uint8_t*)Pool_ArenaAlloc(3000);
+	c = (uint8_t*)Pool_ArenaAlloc(10000);
+	d = (uint8_t*)Pool_ArenaAlloc(3001);
+	mu_assert(b != NULL && c != NULL && d != NULL, "arena could not allocate buffer");
+	mu_assert(Test_IsZeroed(c, 10000), "arena buffer was not zeroed");
+	memset(a, 0xAA, 10000);
+	memset(b, 0xBB, 3000);
+	memset(c, 0xCC, 10000);
+	memset(d, 0xDD, 3001);
+
+	// free b and c, which are next to each other: they merge into one block
+	Pool_ArenaFree(b);
+	Pool_ArenaFree(c);
+	Pool_GetArenaStats(&the_stats);
+	mu_assert_int_eq(2, the_stats.num_free_blocks_);
+	mu_check( the_stats.fragmentation_ > 0 );
+
+	// best fit: a small buffer goes in the 13K hole, not in the big free block
+	b = (uint8_t*)Pool_ArenaAlloc(2000);
+	mu_assert(Test_IsZeroed(b, 2000), "re-used arena buffer was not zeroed");
+	Pool_GetArenaStats(&the_stats);
+	mu_assert_int_eq(2, the_stats.num_free_blocks_);
+	mu_check( b < a && b > d );	// (blocks are carved from the top of the free space down)
+
+	// a and d weren't touched
+	mu_assert_int_eq(0xAA, a[9999]);
+	mu_assert_int_eq(0xDD, d[0]);
+
+	// free everything: all free space is in one piece again
+	Pool_ArenaFree(a);
+	Pool_ArenaFree(d);
+	Pool_ArenaFree(b);
+	Pool_GetArenaStats(&the_stats);
+	mu_assert_int_eq(start_in_use, the_stats.in_use_);
+
+	if (start_in_use == 0)
+	{
+		mu_assert_int_eq(1, the_stats.num_free_blocks_);
+		mu_assert_int_eq(0, the_stats.fragmentation_);
+		mu_assert_int_eq(POOL_TEST_ARENA_SIZE, the_stats.largest_free_);
+	}
+
+	// something too big for the arena comes from the heap instead, and goes back to the heap when freed
+	the_big_one = (uint8_t*)Pool_ArenaAlloc(POOL_TEST_ARENA_SIZE + 1);
+
+	if (the_big_one != NULL)
+	{
+		Pool_GetArenaStats(&the_stats);
+		mu_check( the_stats.heap_fallbacks_ > 0 );
+		mu_assert_int_eq(start_in_use, the_stats.in_use_);
+		Pool_ArenaFree(the_big_one);
+	}
+
+	// bad requests
+	mu_check( Pool_ArenaAlloc(0) == NULL );
+	Pool_ArenaFree(NULL);
+}
+
+
+MU_TEST(pool_arena_churn_test)
+{
+	void*			the_buffers[POOL_TEST_BUFFERS];
+	PoolArenaStats	the_stats;
+	uint32_t		start_fallbacks;
+	int16_t			i;
+
+	Pool_GetArenaStats(&the_stats);
+	start_fallbacks = the_stats.heap_fallbacks_;
+
+	Test_ChurnBuffers(the_buffers, true);
+
+	Pool_GetArenaStats(&the_stats);
+	mu_assert_int_eq(start_fallbacks, the_stats.heap_fallbacks_);
+	mu_assert_int_eq(the_stats.size_, the_stats.in_use_ + the_stats.free_);
+
+	for (i = 0; i < POOL_TEST_BUFFERS; i++)
+	{
+		mu_assert(the_buffers[i] != NULL, "arena ran out of space during churn");
+		Pool_ArenaFree(the_buffers[i]);
+	}
+
+	// every block merged back together
+	Pool_GetArenaStats(&the_stats);
+	mu_assert_int_eq(1, the_stats.num_free_blocks_);
+	mu_assert_int_eq(the_stats.size_, the_stats.largest_free_);
+}
+
+
+
+// **** speed tests
+
+MU_TEST(test_speed_1)
+{
+	void*		the_objects[POOL_TEST_OBJECTS];
+	long		start1;
+	long		end1;
+	long		start2;
+	long		end2;
+	int16_t		i;
+	int16_t		j;
+
+	// allocate and free small structs with the slab pool...
+	start1 = mu_timer_real();
+
+	for (i = 0; i < POOL_SPEED_TEST_OPS / POOL_TEST_OBJECTS; i++)
+	{
+		for (j = 0; j < POOL_TEST_OBJECTS; j++)
+		{
+			the_objects[j] = Pool_Alloc(&test_pool);
+		}
+
+		for (j = 0; j < POOL_TEST_OBJECTS; j++)
+		{
+			Pool_Free(&test_pool, the_objects[j]);
+		}
+	}
+
+	end1 = mu_timer_real();
+
+	// ...and with calloc
+	start2 = mu_timer_real();
+
+	for (i = 0; i < POOL_SPEED_TEST_OPS / POOL_TEST_OBJECTS; i++)
+	{
+		for (j = 0; j < POOL_TEST_OBJECTS; j++)
+		{
+			the_objects[j] = calloc(1, sizeof(PoolTestObject));
+		}
+
+		for (j = 0; j < POOL_TEST_OBJECTS; j++)
+		{
+			free(the_objects[j]);
+		}
+	}
+
+	end2 = mu_timer_real();
+
+	printf("\nSpeed results: %i struct allocate+free pairs: pool %li ticks, calloc %li ticks\n", POOL_SPEED_TEST_OPS, end1 - start1, end2 - start2);
+}
+
+
+MU_TEST(test_speed_2)
+{
+	void*			the_buffers[POOL_TEST_BUFFERS];
+	PoolArenaStats	the_stats;
+	long			start1;
+	long			end1;
+	long			start2;
+	long			end2;
+	uint32_t		calloc_largest_before;
+	uint32_t		calloc_largest_after;
+	int16_t			i;
+
+	// churn bitmap-sized buffers in the arena, then see how fragmented it got
+	start1 = mu_timer_real();
+	Test_ChurnBuffers(the_buffers, true);
+	end1 = mu_timer_real();
+
+	Pool_GetArenaStats(&the_stats);
+
+	for (i = 0; i < POOL_TEST_BUFFERS; i++)
+	{
+		Pool_ArenaFree(the_buffers[i]);
+	}
+
+	printf("\nSpeed results: arena churn of %i buffers took %li ticks; %lu bytes live, largest free block %lu of %lu free (%u%% fragmented, %u free blocks), high water %lu\n", POOL_TEST_CHURN_STEPS, end1 - start1, the_stats.in_use_, the_stats.largest_free_, the_stats.free_, the_stats.fragmentation_, the_stats.num_free_blocks_, the_stats.high_water_);
+
+	// same churn with calloc. there's no way to see the heap's free list, so measure the biggest block it can still hand out.
+	calloc_largest_before = Test_LargestHeapBlock(POOL_TEST_HEAP_PROBE_MAX);
+
+	start2 = mu_timer_real();
+	Test_ChurnBuffers(the_buffers, false);
+	end2 = mu_timer_real();
+
+	calloc_largest_after = Test_LargestHeapBlock(POOL_TEST_HEAP_PROBE_MAX);
+
+	for (i = 0; i < POOL_TEST_BUFFERS; i++)
+	{
+		free(the_buffers[i]);
+	}
+
+	printf("Speed results: calloc churn of %i buffers took %li ticks; largest block available went from %lu to %lu\n", POOL_TEST_CHURN_STEPS, end2 - start2, calloc_largest_before, calloc_largest_after);
+}
+
+
+
+MU_TEST(pool_arena_init_test)
+{
+	PoolArenaStats	the_stats;
+	uint8_t*		a;
+	uint8_t*		b;
+	uint32_t		start_fallbacks;
+
+	// the arena can't be replaced or given back while a buffer is in it
+	a = (uint8_t*)Pool_ArenaAlloc(1000);
+	mu_check( Pool_InitArena(0) == false );
+	Pool_GetArenaStats(&the_stats);
+	mu_assert_int_eq(POOL_TEST_ARENA_SIZE, the_stats.size_);
+	Pool_ArenaFree(a);
+
+	// once it is empty, it can be given back. buffers then come from the heap, without counting as fallbacks.
+	mu_check( Pool_InitArena(0) == true );
+	Pool_GetArenaStats(&the_stats);
+	mu_assert_int_eq(0, the_stats.size_);
+	mu_assert_int_eq(0, the_stats.largest_free_);
+	start_fallbacks = the_stats.heap_fallbacks_;
+
+	b = (uint8_t*)Pool_ArenaAlloc(1000);
+	mu_assert(b != NULL, "could not allocate buffer with no arena");
+	mu_assert(Test_IsZeroed(b, 1000), "heap buffer was not zeroed");
+	Pool_GetArenaStats(&the_stats);
+	mu_assert_int_eq(start_fallbacks, the_stats.heap_fallbacks_);
+
+	// a buffer from the heap doesn't stop a new arena being set up, and still goes back to the heap after
+	mu_check( Pool_InitArena(POOL_TEST_ARENA_SIZE) == true );
+	Pool_ArenaFree(b);
+	Pool_GetArenaStats(&the_stats);
+	mu_assert_int_eq(POOL_TEST_ARENA_SIZE, the_stats.size_);
+	mu_assert_int_eq(0, the_stats.in_use_);
+	mu_assert_int_eq(1, the_stats.num_free_blocks_);
+}
+
+
+
+// speed tests
+MU_TEST_SUITE(test_suite_speed)
+{
+	MU_SUITE_CONFIGURE(&test_setup, &test_teardown);
+
+	MU_RUN_TEST(test_speed_1);
+	MU_RUN_TEST(test_speed_2);
+}
+
+
+// unit tests
+MU_TEST_SUITE(test_suite_units)
+{
+	MU_SUITE_CONFIGURE(&test_setup, &test_teardown);
+
+	MU_RUN_TEST(pool_slab_test);
+	MU_RUN_TEST(pool_arena_test);
+	MU_RUN_TEST(pool_arena_churn_test);
+	MU_RUN_TEST(pool_arena_init_test);
+}
+
+
+
+
+
+/*****************************************************************************/
+/*                        Public Function Definitions                        */
+/*****************************************************************************/
+
+
+
+int main(int argc, char* argv[])
+{
+	printf("**** pool.c Test Suite **** \n");
+
+	if (Pool_InitArena(POOL_TEST_ARENA_SIZE) == false)
+	{
+		printf("Couldn't set up the buffer arena \n");
+		return 1;
+	}
+
+	MU_RUN_SUITE(test_suite_units);
+	MU_RUN_SUITE(test_suite_speed);
+	MU_REPORT();
+
+	Pool_LogStats();
+
+	printf("pool test complete \n");
+
+	return MU_EXIT_CODE;
+}
@@ -0,0 +1,861 @@
+/*
+ * region.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: agent
+ */
+
+
+
+
+
+/*****************************************************************************/
+/*                                Includes                                   */
+/*****************************************************************************/
+
+// project includes
+#include "debug.h"
+#include "general.h"
+#include "region.h"
+
+// C includes
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// A2560 includes
+#include <mcp/syscalls.h>
+#include "a2560k.h"
+
+
+/*****************************************************************************/
+/*                               Definitions                                 */
+/*****************************************************************************/
+
+#define REGION_NO_EDGE		0x7FFF	// sentinel x/y coordinate: greater than any real edge
+
+
+/*****************************************************************************/
+/*                               Enumerations                                */
+/*****************************************************************************/
+
+typedef enum region_op
+{
+	REGION_OP_UNION = 0,
+	REGION_OP_INTERSECT,
+	REGION_OP_SUBTRACT,
+} region_op;
+
+
+/*****************************************************************************/
+/*                             Global Variables                              */
+/*****************************************************************************/
+
+
+
+/*****************************************************************************/
+/*                       Private Function Prototypes                         */
+/*****************************************************************************/
+
+//! Make sure the region has storage for at least the specified number of rects
+bool Region_Reserve(Region* the_region, int16_t num_rects);
+
+//! Free the region's rect storage
+void Region_FreeRects(Region* the_region);
+
+//! Set up a stack Region that refers to a single rect, for use as an operand. The region must not be grown or freed.
+void Region_InitFromRect(Region* the_region, Rectangle* the_rect);
+
+//! Find the end of the band that starts at the specified rect index
+int16_t Region_FindBandEnd(Region* the_region, int16_t band_start);
+
+//! Combine 2 bands' x spans with the specified operation, and append the result as a new band [y1, y2] to the result region
+bool Region_AppendCombinedBand(Region* the_result, Rectangle* a_spans, int16_t num_a, Rectangle* b_spans, int16_t num_b, region_op the_op, int16_t y1, int16_t y2, int16_t* prev_band_start);
+
+//! Combine 2 regions with the specified operation, placing the result in the target region
+bool Region_Combine(Region* the_target, Region* the_source, region_op the_op);
+
+//! Recalculate the bounds of the region from its rects
+void Region_CalculateBounds(Region* the_region);
+
+
+/*****************************************************************************/
+/*                       Private Function Definitions                        */
+/*****************************************************************************/
+
+// **** NOTE: all functions in private section REQUIRE pre-validated parameters.
+// **** NEVER call these from your own functions. Always use the public interface. You have been warned!
+
+
+//! Make sure the region has storage for at least the specified number of rects
+bool Region_Reserve(Region* the_region, int16_t num_rects)
+{
+	Rectangle*	new_rects;
+	int16_t		new_max;
+
+	if (num_rects <= the_region->max_rects_)
+	{
+		return true;
+	}
+
+	new_max = the_region->max_rects_ * 2;
+
+	if (new_max < REGION_MIN_ALLOC_RECTS)
+	{
+		new_max = REGION_MIN_ALLOC_RECTS;
+	}
+
+	if (new_max < num_rects)
+	{
+		new_max = num_rects;
+	}
+
+	if ( (new_rects = (Rectangle*)realloc(the_region->rects_, new_max * sizeof(Rectangle)) ) == NULL)
+	{
+		LOG_ERR(("%s %d: could not grow region to %i rects", __func__ , __LINE__, new_max));
+		return false;
+	}
+	LOG_ALLOC(("%s %d:	__ALLOC__	the_region->rects_	%p	size	%i", __func__ , __LINE__, new_rects, new_max * sizeof(Rectangle)));
+	TRACK_ALLOC(((new_max - the_region->max_rects_) * sizeof(Rectangle)));
+
+	the_region->rects_ = new_rects;
+	the_region->max_rects_ = new_max;
+
+	return true;
+}
+
+
+//! Free the region's rect storage
+void Region_FreeRects(Region* the_region)
+{
+	if (the_region->rects_)
+	{
+		LOG_ALLOC(("%s %d:	__FREE__	the_region->rects_	%p	size	%i", __func__ , __LINE__, the_region->rects_, the_region->max_rects_ * sizeof(Rectangle)));
+		TRACK_ALLOC((0 - the_region->max_rects_ * sizeof(Rectangle)));
+		free(the_region->rects_);
+	}
+
+	the_region->rects_ = NULL;
+	the_region->num_rects_ = 0;
+	the_region->max_rects_ = 0;
+}
+
+
+//! Set up a stack Region that refers to a single rect, for use as an operand. The region must not be grown or freed.
+void Region_InitFromRect(Region* the_region, Rectangle* the_rect)
+{
+	the_region->rects_ = the_rect;
+	the_region->max_rects_ = 1;
+	the_region->num_rects_ = (the_rect->MaxX < the_rect->MinX || the_rect->MaxY < the_rect->MinY) ? 0 : 1;
+	the_region->bounds_ = *the_rect;
+}
+
+
+//! Find the end of the band that starts at the specified rect index
+int16_t Region_FindBandEnd(Region* the_region, int16_t band_start)
+{
+	int16_t		band_end = band_start + 1;
+
+	while (band_end < the_region->num_rects_ && the_region->rects_[band_end].MinY == the_region->rects_[band_start].MinY)
+	{
+		band_end++;
+	}
+
+	return band_end;
+}
+
+
+//! Combine 2 bands' x spans with the specified operation, and append the result as a new band [y1, y2] to the result region
+bool Region_AppendCombinedBand(Region* the_result, Rectangle* a_spans, int16_t num_a, Rectangle* b_spans, int16_t num_b, region_op the_op, int16_t y1, int16_t y2, int16_t* prev_band_start)
+{
+	int16_t		ia = 0;
+	int16_t		ib = 0;
+	bool		in_a = false;
+	bool		in_b = false;
+	bool		was_in = false;
+	int16_t		span_start = 0;
+	int16_t		band_start;
+	int16_t		prev_start;
+	int16_t		band_len;
+	int16_t		prev_len;
+	int16_t		i;
+
+	// LOGIC:
+	//   Each band is a sorted list of non-touching x spans, so the spans can be merged by walking their edges left to right
+	//   At each edge, we know whether we are inside A and/or inside B, and the op decides whether that is inside the result
+	//   The result can never have more spans than the 2 inputs combined
+
+	if (Region_Reserve(the_result, the_result->num_rects_ + num_a + num_b) == false)
+	{
+		return false;
+	}
+
+	band_start = the_result->num_rects_;
+
+	while (ia < num_a || ib < num_b)
+	{
+		int16_t		next_a;
+		int16_t		next_b;
+		int16_t		x;
+		bool		is_in;
+
+		// half-open edges: a span covers [MinX, MaxX + 1)
+		next_a = (ia < num_a) ? (in_a ? a_spans[ia].MaxX + 1 : a_spans[ia].MinX) : REGION_NO_EDGE;
+		next_b = (ib < num_b) ? (in_b ? b_spans[ib].MaxX + 1 : b_spans[ib].MinX) : REGION_NO_EDGE;
+		x = (next_a < next_b) ? next_a : next_b;
+
+		while (ia < num_a && (in_a ? a_spans[ia].MaxX + 1 : a_spans[ia].MinX) == x)
+		{
+			if (in_a)
+			{
+				ia++;
+			}
+
+			in_a = !in_a;
+		}
+
+		while (ib < num_b && (in_b ? b_spans[ib].MaxX + 1 : b_spans[ib].MinX) == x)
+		{
+			if (in_b)
+			{
+				ib++;
+			}
+
+			in_b = !in_b;
+		}
+
+		switch (the_op)
+		{
+			case REGION_OP_UNION:
+				is_in = in_a || in_b;
+				break;
+
+			case REGION_OP_INTERSECT:
+				is_in = in_a && in_b;
+				break;
+
+			default:
+				is_in = in_a && !in_b;
+				break;
+		}
+
+		if (is_in && !was_in)
+		{
+			span_start = x;
+		}
+		else if (!is_in && was_in)
+		{
+			Rectangle*	the_rect = &the_result->rects_[the_result->num_rects_++];
+
+			the_rect->MinX = span_start;
+			the_rect->MaxX = x - 1;
+			the_rect->MinY = y1;
+			the_rect->MaxY = y2;
+		}
+
+		was_in = is_in;
+	}
+
+	band_len = the_result->num_rects_ - band_start;
+
+	if (band_len == 0)
+	{
+		return true;
+	}
+
+	// LOGIC:
+	//   If the previous band ends right above this one and has exactly the same spans, extend it down instead of keeping a new band
+	//   This keeps the rect count down, and means the same area always produces the same rect list
+
+	prev_start = *prev_band_start;
+	prev_len = band_start - prev_start;
+
+	if (prev_start >= 0 && prev_len == band_len && the_result->rects_[prev_start].MaxY + 1 == y1)
+	{
+		for (i = 0; i < band_len; i++)
+		{
+			if (the_result->rects_[prev_start + i].MinX != the_result->rects_[band_start + i].MinX || the_result->rects_[prev_start + i].MaxX != the_result->rects_[band_start + i].MaxX)
+			{
+				break;
+			}
+		}
+
+		if (i == band_len)
+		{
+			for (i = 0; i < band_len; i++)
+			{
+				the_result->rects_[prev_start + i].MaxY = y2;
+			}
+
+			the_result->num_rects_ = band_start;
+			return true;
+		}
+	}
+
+	*prev_band_start = band_start;
+
+	return true;
+}
+
+
+//! Combine 2 regions with the specified operation, placing the result in the target region
+bool Region_Combine(Region* the_target, Region* the_source, region_op the_op)
+{
+	Region		the_result;
+	int16_t		a_band = 0;
+	int16_t		b_band = 0;
+	int16_t		a_band_end;
+	int16_t		b_band_end;
+	int16_t		prev_band_start = -1;
+	int16_t		y;
+
+	// LOGIC:
+	//   Walk down both regions together, splitting them into horizontal strips wherever either one starts or ends a band
+	//   Within a strip, each region is either absent, or has a fixed set of x spans, so the strip can be combined span by span
+	//   The result is built in a new rect list and only swapped into the target on success, so an out of memory error leaves the target intact
+
+	memset(&the_result, 0, sizeof(Region));
+
+	y = REGION_NO_EDGE;
+
+	if (the_target->num_rects_ > 0)
+	{
+		y = the_target->rects_[0].MinY;
+	}
+
+	if (the_source->num_rects_ > 0 && the_source->rects_[0].MinY < y)
+	{
+		y = the_source->rects_[0].MinY;
+	}
+
+	while (a_band < the_target->num_rects_ || b_band < the_source->num_rects_)
+	{
+		Rectangle*	a_spans = NULL;
+		Rectangle*	b_spans = NULL;
+		int16_t		num_a = 0;
+		int16_t		num_b = 0;
+		int16_t		next_y = REGION_NO_EDGE;
+
+		if (a_band < the_target->num_rects_)
+		{
+			a_band_end = Region_FindBandEnd(the_target, a_band);
+
+			if (the_target->rects_[a_band].MinY <= y)
+			{
+				a_spans = &the_target->rects_[a_band];
+				num_a = a_band_end - a_band;
+				next_y = the_target->rects_[a_band].MaxY + 1;
+			}
+			else
+			{
+				next_y = the_target->rects_[a_band].MinY;
+			}
+		}
+
+		if (b_band < the_source->num_rects_)
+		{
+			int16_t		b_next_y;
+
+			b_band_end = Region_FindBandEnd(the_source, b_band);
+
+			if (the_source->rects_[b_band].MinY <= y)
+			{
+				b_spans = &the_source->rects_[b_band];
+				num_b = b_band_end - b_band;
+				b_next_y = the_source->rects_[b_band].MaxY + 1;
+			}
+			else
+			{
+				b_next_y = the_source->rects_[b_band].MinY;
+			}
+
+			if (b_next_y < next_y)
+			{
+				next_y = b_next_y;
+			}
+		}
+
+		if (num_a > 0 || num_b > 0)
+		{
+			if (Region_AppendCombinedBand(&the_result, a_spans, num_a, b_spans, num_b, the_op, y, next_y - 1, &prev_band_start) == false)
+			{
+				Region_FreeRects(&the_result);
+				return false;
+			}
+		}
+
+		y = next_y;
+
+		// move past any band we have now finished
+		if (a_spans && the_target->rects_[a_band].MaxY < y)
+		{
+			a_band = a_band_end;
+		}
+
+		if (b_spans && the_source->rects_[b_band].MaxY < y)
+		{
+			b_band = b_band_end;
+		}
+	}
+
+	// swap the new rect list into the target
+	Region_FreeRects(the_target);
+
+	the_target->rects_ = the_result.rects_;
+	the_target->num_rects_ = the_result.num_rects_;
+	the_target->max_rects_ = the_result.max_rects_;
+	Region_CalculateBounds(the_target);
+
+	return true;
+}
+
+
+//! Recalculate the bounds of the region from its rects
+void Region_CalculateBounds(Region* the_region)
+{
+	int16_t		i;
+
+	if (the_region->num_rects_ == 0)
+	{
+		the_region->bounds_.MinX = 0;
+		the_region->bounds_.MinY = 0;
+		the_region->bounds_.MaxX = -1;
+		the_region->bounds_.MaxY = -1;
+		return;
+	}
+
+	the_region->bounds_.MinY = the_region->rects_[0].MinY;
+	the_region->bounds_.MaxY = the_region->rects_[the_region->num_rects_ - 1].MaxY;
+	the_region->bounds_.MinX = the_region->rects_[0].MinX;
+	the_region->bounds_.MaxX = the_region->rects_[0].MaxX;
+
+	for (i = 1; i < the_region->num_rects_; i++)
+	{
+		if (the_region->rects_[i].MinX < the_region->bounds_.MinX)
+		{
+			the_region->bounds_.MinX = the_region->rects_[i].MinX;
+		}
+
+		if (the_region->rects_[i].MaxX > the_region->bounds_.MaxX)
+		{
+			the_region->bounds_.MaxX = the_region->rects_[i].MaxX;
+		}
+	}
+}
+
+
+// **** Debug functions *****
+
+void Region_Print(Region* the_region)
+{
+	int16_t		i;
+
+	DEBUG_OUT(("Region print out:"));
+	DEBUG_OUT(("  num_rects_: %i", the_region->num_rects_));
+	DEBUG_OUT(("  max_rects_: %i", the_region->max_rects_));
+	DEBUG_OUT(("  bounds_: %i, %i : %i, %i", the_region->bounds_.MinX, the_region->bounds_.MinY, the_region->bounds_.MaxX, the_region->bounds_.MaxY));
+
+	for (i = 0; i < the_region->num_rects_; i++)
+	{
+		DEBUG_OUT(("  rect %i: %i, %i : %i, %i", i, the_region->rects_[i].MinX, the_region->rects_[i].MinY, the_region->rects_[i].MaxX, the_region->rects_[i].MaxY));
+	}
+}
+
+
+
+
+/*****************************************************************************/
+/*                        Public Function Definitions                        */
+/*****************************************************************************/
+
+// **** CONSTRUCTOR AND DESTRUCTOR *****
+
+// constructor
+//! Allocate a new, empty Region object
+//! @return	Returns a new Region object, or NULL on any error condition
+Region* Region_New(void)
+{
+	Region*		the_region;
+
+	if ( (the_region = (Region*)calloc(1, sizeof(Region)) ) == NULL)
+	{
+		LOG_ERR(("%s %d: could not allocate memory to create new region", __func__ , __LINE__));
+		return NULL;
+	}
+	LOG_ALLOC(("%s %d:	__ALLOC__	the_region	%p	size	%i", __func__ , __LINE__, the_region, sizeof(Region)));
+	TRACK_ALLOC((sizeof(Region)));
+
+	Region_CalculateBounds(the_region);
+
+	return the_region;
+}
+
+
+// destructor
+// frees all allocated memory associated with the passed object, and the object itself
+//! @param	the_region -- pointer to the pointer for the Region object to be destroyed
+//! @return	Returns false if the pointer to the passed Region was NULL
+bool Region_Destroy(Region** the_region)
+{
+	if (the_region == NULL || *the_region == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		return false;
+	}
+
+	Region_FreeRects(*the_region);
+
+	LOG_ALLOC(("%s %d:	__FREE__	*the_region	%p	size	%i", __func__ , __LINE__, *the_region, sizeof(Region)));
+	TRACK_ALLOC((0 - sizeof(Region)));
+	free(*the_region);
+	*the_region = NULL;
+
+	return true;
+}
+
+
+
+
+// **** Set functions *****
+
+//! Remove all rects from the region. Storage is kept for reuse.
+//! @param	the_region -- reference to a valid Region object.
+void Region_MakeEmpty(Region* the_region)
+{
+	if (the_region == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		return;
+	}
+
+	the_region->num_rects_ = 0;
+	Region_CalculateBounds(the_region);
+}
+
+
+//! Replace the contents of the region with the passed rect
+//! @param	the_region -- reference to a valid Region object.
+//! @param	the_rect -- the rect the region should cover. If the rect is empty (MaxX < MinX or MaxY < MinY), the region will be made empty.
+//! @return	Returns false on any error condition
+bool Region_SetRect(Region* the_region, Rectangle* the_rect)
+{
+	if (the_region == NULL || the_rect == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object or rect was null", __func__ , __LINE__));
+		return false;
+	}
+
+	if (the_rect->MaxX < the_rect->MinX || the_rect->MaxY < the_rect->MinY)
+	{
+		Region_MakeEmpty(the_region);
+		return true;
+	}
+
+	if (Region_Reserve(the_region, 1) == false)
+	{
+		return false;
+	}
+
+	the_region->rects_[0] = *the_rect;
+	the_region->num_rects_ = 1;
+	the_region->bounds_ = *the_rect;
+
+	return true;
+}
+
+
+//! Replace the contents of one region with a copy of another
+//! @param	the_target -- reference to a valid Region object that will be changed to match the source
+//! @param	the_source -- reference to a valid Region object that will be copied
+//! @return	Returns false on any error condition
+bool Region_Copy(Region* the_target, Region* the_source)
+{
+	if (the_target == NULL || the_source == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		return false;
+	}
+
+	if (the_target == the_source)
+	{
+		return true;
+	}
+
+	if (Region_Reserve(the_target, the_source->num_rects_) == false)
+	{
+		return false;
+	}
+
+	if (the_source->num_rects_ > 0)
+	{
+		memcpy(the_target->rects_, the_source->rects_, the_source->num_rects_ * sizeof(Rectangle));
+	}
+
+	the_target->num_rects_ = the_source->num_rects_;
+	the_target->bounds_ = the_source->bounds_;
+
+	return true;
+}
+
+
+//! Move every rect in the region by the specified amounts
+//! @param	the_region -- reference to a valid Region object.
+//! @param	delta_x -- pixels to add to every horizontal coordinate
+//! @param	delta_y -- pixels to add to every vertical coordinate
+void Region_Offset(Region* the_region, int16_t delta_x, int16_t delta_y)
+{
+	int16_t		i;
+
+	if (the_region == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		return;
+	}
+
+	for (i = 0; i < the_region->num_rects_; i++)
+	{
+		the_region->rects_[i].MinX += delta_x;
+		the_region->rects_[i].MaxX += delta_x;
+		the_region->rects_[i].MinY += delta_y;
+		the_region->rects_[i].MaxY += delta_y;
+	}
+
+	Region_CalculateBounds(the_region);
+}
+
+
+
+
+// **** Region algebra functions *****
+
+//! Add the area of the source region to the target region
+//! @param	the_target -- reference to a valid Region object. Will be changed to the union of both regions.
+//! @param	the_source -- reference to a valid Region object. Not changed.
+//! @return	Returns false on any error condition (including out of memory, in which case the target is unchanged)
+bool Region_Union(Region* the_target, Region* the_source)
+{
+	if (the_target == NULL || the_source == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		return false;
+	}
+
+	if (the_source->num_rects_ == 0 || the_target == the_source)
+	{
+		return true;
+	}
+
+	if (the_target->num_rects_ == 0)
+	{
+		return Region_Copy(the_target, the_source);
+	}
+
+	return Region_Combine(the_target, the_source, REGION_OP_UNION);
+}
+
+
+//! Limit the target region to the area it shares with the source region
+//! @param	the_target -- reference to a valid Region object. Will be changed to the intersection of both regions.
+//! @param	the_source -- reference to a valid Region object. Not changed.
+//! @return	Returns false on any error condition (including out of memory, in which case the target is unchanged)
+bool Region_Intersect(Region* the_target, Region* the_source)
+{
+	if (the_target == NULL || the_source == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		return false;
+	}
+
+	if (the_target == the_source || the_target->num_rects_ == 0)
+	{
+		return true;
+	}
+
+	if (the_source->num_rects_ == 0 || General_RectIntersect(the_target->bounds_, the_source->bounds_) == false)
+	{
+		Region_MakeEmpty(the_target);
+		return true;
+	}
+
+	return Region_Combine(the_target, the_source, REGION_OP_INTERSECT);
+}
+
+
+//! Remove the area of the source region from the target region
+//! @param	the_target -- reference to a valid Region object. Will be changed to the target minus the source.
+//! @param	the_source -- reference to a valid Region object. Not changed.
+//! @return	Returns false on any error condition (including out of memory, in which case the target is unchanged)
+bool Region_Subtract(Region* the_target, Region* the_source)
+{
+	if (the_target == NULL || the_source == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		return false;
+	}
+
+	if (the_target == the_source)
+	{
+		Region_MakeEmpty(the_target);
+		return true;
+	}
+
+	if (the_target->num_rects_ == 0 || the_source->num_rects_ == 0 || General_RectIntersect(the_target->bounds_, the_source->bounds_) == false)
+	{
+		return true;
+	}
+
+	return Region_Combine(the_target, the_source, REGION_OP_SUBTRACT);
+}
+
+
+//! Add the area of the passed rect to the region
+//! @param	the_region -- reference to a valid Region object.
+//! @param	the_rect -- the rect to add. Empty rects are ignored.
+//! @return	Returns false on any error condition
+bool Region_UnionRect(Region* the_region, Rectangle* the_rect)
+{
+	Region		rect_region;
+
+	if (the_rect == NULL)
+	{
+		LOG_ERR(("%s %d: passed rect was null", __func__ , __LINE__));
+		return false;
+	}
+
+	Region_InitFromRect(&rect_region, the_rect);
+
+	return Region_Union(the_region, &rect_region);
+}
+
+
+//! Limit the region to the area it shares with the passed rect
+//! @param	the_region -- reference to a valid Region object.
+//! @param	the_rect -- the rect to intersect with. If empty, the region will be made empty.
+//! @return	Returns false on any error condition
+bool Region_IntersectRect(Region* the_region, Rectangle* the_rect)
+{
+	Region		rect_region;
+
+	if (the_rect == NULL)
+	{
+		LOG_ERR(("%s %d: passed rect was null", __func__ , __LINE__));
+		return false;
+	}
+
+	Region_InitFromRect(&rect_region, the_rect);
+
+	return Region_Intersect(the_region, &rect_region);
+}
+
+
+//! Remove the area of the passed rect from the region
+//! @param	the_region -- reference to a valid Region object.
+//! @param	the_rect -- the rect to remove. Empty rects are ignored.
+//! @return	Returns false on any error condition
+bool Region_SubtractRect(Region* the_region, Rectangle* the_rect)
+{
+	Region		rect_region;
+
+	if (the_rect == NULL)
+	{
+		LOG_ERR(("%s %d: passed rect was null", __func__ , __LINE__));
+		return false;
+	}
+
+	Region_InitFromRect(&rect_region, the_rect);
+
+	return Region_Subtract(the_region, &rect_region);
+}
+
+
+
+
+// **** Get functions *****
+
+//! @param	the_region -- reference to a valid Region object.
+//! @return	Returns true if the region covers no pixels
+bool Region_IsEmpty(Region* the_region)
+{
+	if (the_region == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		return true;
+	}
+
+	return (the_region->num_rects_ == 0);
+}
+
+
+//! @param	the_region -- reference to a valid Region object.
+//! @return	Returns the number of non-overlapping rects that make up the region
+int16_t Region_GetRectCount(Region* the_region)
+{
+	if (the_region == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		return 0;
+	}
+
+	return the_region->num_rects_;
+}
+
+
+//! @param	the_region -- reference to a valid Region object.
+//! @return	Returns the total number of pixels covered by the region
+uint32_t Region_GetArea(Region* the_region)
+{
+	uint32_t	the_area = 0;
+	int16_t		i;
+
+	if (the_region == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		return 0;
+	}
+
+	for (i = 0; i < the_region->num_rects_; i++)
+	{
+		Rectangle*	the_rect = &the_region->rects_[i];
+
+		the_area += (uint32_t)(the_rect->MaxX - the_rect->MinX + 1) * (uint32_t)(the_rect->MaxY - the_rect->MinY + 1);
+	}
+
+	return the_area;
+}
+
+
+//! Check if a point is within the region
+//! @param	the_region -- reference to a valid Region object.
+//! @param	x -- horizontal coordinate, in the same coordinate space as the region
+//! @param	y -- vertical coordinate, in the same coordinate space as the region
+//! @return	Returns true if the point is covered by one of the region's rects
+bool Region_ContainsPoint(Region* the_region, int16_t x, int16_t y)
+{
+	int16_t		i;
+
+	if (the_region == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		return false;
+	}
+
+	if (the_region->num_rects_ == 0 || x < the_region->bounds_.MinX || x > the_region->bounds_.MaxX || y < the_region->bounds_.MinY || y > the_region->bounds_.MaxY)
+	{
+		return false;
+	}
+
+	// rects are sorted by band, so we can stop as soon as we reach a band below the point
+	for (i = 0; i < the_region->num_rects_ && the_region->rects_[i].MinY <= y; i++)
+	{
+		Rectangle*	the_rect = &the_region->rects_[i];
+
+		if (y <= the_rect->MaxY && x >= the_rect->MinX && x <= the_rect->MaxX)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
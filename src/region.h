@@ -0,0 +1,200 @@
+//! @file region.h
+
+/*
+ * region.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: agent
+ */
+
+#ifndef LIB_REGION_H_
+#define LIB_REGION_H_
+
+
+/* about this class: Region
+ *
+ * A Region describes an arbitrary area of the screen (or of a bitmap) as a list of non-overlapping rectangles
+ * Used by windows to track which parts need to be blitted to the screen, and which parts of the screen they have exposed
+ *
+ * Rectangles are stored "y-x banded":
+ *   rects are sorted top to bottom, then left to right
+ *   rects that share any rows share exactly the same MinY and MaxY (they form a "band")
+ *   rects in a band never touch or overlap; adjacent bands with identical spans are merged into one band
+ * This means no pixel is ever covered by more than one rect, and the same area always has the same rect list
+ *
+ *** things this class needs to be able to do
+ * union, intersect, and subtract regions, or a region and a rect
+ * report the rects that make up the region, so they can be blitted
+ * offset a region (eg, global to window-local coordinates)
+ *
+ * STRETCH GOALS
+ *
+ *
+ * SUPER STRETCH GOALS
+ *
+ *
+ */
+
+
+/*****************************************************************************/
+/*                                Includes                                   */
+/*****************************************************************************/
+
+// project includes
+
+// C includes
+#include <stdbool.h>
+
+
+// A2560 includes
+#include <mcp/syscalls.h>
+#include "a2560k.h"
+
+
+/*****************************************************************************/
+/*                            Macro Definitions                              */
+/*****************************************************************************/
+
+#define REGION_MIN_ALLOC_RECTS		8	//!< when a region first needs storage for rects, it allocates at least this many slots
+
+
+/*****************************************************************************/
+/*                               Enumerations                                */
+/*****************************************************************************/
+
+
+
+/*****************************************************************************/
+/*                                 Structs                                   */
+/*****************************************************************************/
+
+struct Region
+{
+	Rectangle*		rects_;			//!< y-x banded list of non-overlapping rects. Coordinates are inclusive, as with all Rectangles.
+	int16_t			num_rects_;		//!< number of rects currently in the region. 0 = empty region.
+	int16_t			max_rects_;		//!< number of rects that can be stored in rects_ before it must be grown
+	Rectangle		bounds_;		//!< smallest rect enclosing every rect in the region. Not meaningful if region is empty.
+};
+
+
+
+/*****************************************************************************/
+/*                             Global Variables                              */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*                       Public Function Prototypes                          */
+/*****************************************************************************/
+
+
+// **** CONSTRUCTOR AND DESTRUCTOR *****
+
+// constructor
+//! Allocate a new, empty Region object
+//! @return	Returns a new Region object, or NULL on any error condition
+Region* Region_New(void);
+
+// destructor
+// frees all allocated memory associated with the passed object, and the object itself
+//! @param	the_region -- pointer to the pointer for the Region object to be destroyed
+//! @return	Returns false if the pointer to the passed Region was NULL
+bool Region_Destroy(Region** the_region);
+
+
+
+// **** Set functions *****
+
+//! Remove all rects from the region. Storage is kept for reuse.
+//! @param	the_region -- reference to a valid Region object.
+void Region_MakeEmpty(Region* the_region);
+
+//! Replace the contents of the region with the passed rect
+//! @param	the_region -- reference to a valid Region object.
+//! @param	the_rect -- the rect the region should cover. If the rect is empty (MaxX < MinX or MaxY < MinY), the region will be made empty.
+//! @return	Returns false on any error condition
+bool Region_SetRect(Region* the_region, Rectangle* the_rect);
+
+//! Replace the contents of one region with a copy of another
+//! @param	the_target -- reference to a valid Region object that will be changed to match the source
+//! @param	the_source -- reference to a valid Region object that will be copied
+//! @return	Returns false on any error condition
+bool Region_Copy(Region* the_target, Region* the_source);
+
+//! Move every rect in the region by the specified amounts
+//! @param	the_region -- reference to a valid Region object.
+//! @param	delta_x -- pixels to add to every horizontal coordinate
+//! @param	delta_y -- pixels to add to every vertical coordinate
+void Region_Offset(Region* the_region, int16_t delta_x, int16_t delta_y);
+
+
+
+// **** Region algebra functions *****
+
+//! Add the area of the source region to the target region
+//! @param	the_target -- reference to a valid Region object. Will be changed to the union of both regions.
+//! @param	the_source -- reference to a valid Region object. Not changed.
+//! @return	Returns false on any error condition (including out of memory, in which case the target is unchanged)
+bool Region_Union(Region* the_target, Region* the_source);
+
+//! Limit the target region to the area it shares with the source region
+//! @param	the_target -- reference to a valid Region object. Will be changed to the intersection of both regions.
+//! @param	the_source -- reference to a valid Region object. Not changed.
+//! @return	Returns false on any error condition (including out of memory, in which case the target is unchanged)
+bool Region_Intersect(Region* the_target, Region* the_source);
+
+//! Remove the area of the source region from the target region
+//! @param	the_target -- reference to a valid Region object. Will be changed to the target minus the source.
+//! @param	the_source -- reference to a valid Region object. Not changed.
+//! @return	Returns false on any error condition (including out of memory, in which case the target is unchanged)
+bool Region_Subtract(Region* the_target, Region* the_source);
+
+//! Add the area of the passed rect to the region
+//! @param	the_region -- reference to a valid Region object.
+//! @param	the_rect -- the rect to add. Empty rects are ignored.
+//! @return	Returns false on any error condition
+bool Region_UnionRect(Region* the_region, Rectangle* the_rect);
+
+//! Limit the region to the area it shares with the passed rect
+//! @param	the_region -- reference to a valid Region object.
+//! @param	the_rect -- the rect to intersect with. If empty, the region will be made empty.
+//! @return	Returns false on any error condition
+bool Region_IntersectRect(Region* the_region, Rectangle* the_rect);
+
+//! Remove the area of the passed rect from the region
+//! @param	the_region -- reference to a valid Region object.
+//! @param	the_rect -- the rect to remove. Empty rects are ignored.
+//! @return	Returns false on any error condition
+bool Region_SubtractRect(Region* the_region, Rectangle* the_rect);
+
+
+
+// **** Get functions *****
+
+//! @param	the_region -- reference to a valid Region object.
+//! @return	Returns true if the region covers no pixels
+bool Region_IsEmpty(Region* the_region);
+
+//! @param	the_region -- reference to a valid Region object.
+//! @return	Returns the number of non-overlapping rects that make up the region
+int16_t Region_GetRectCount(Region* the_region);
+
+//! @param	the_region -- reference to a valid Region object.
+//! @return	Returns the total number of pixels covered by the region
+uint32_t Region_GetArea(Region* the_region);
+
+//! Check if a point is within the region
+//! @param	the_region -- reference to a valid Region object.
+//! @param	x -- horizontal coordinate, in the same coordinate space as the region
+//! @param	y -- vertical coordinate, in the same coordinate space as the region
+//! @return	Returns true if the point is covered by one of the region's rects
+bool Region_ContainsPoint(Region* the_region, int16_t x, int16_t y);
+
+
+
+// **** Debug functions *****
+
+void Region_Print(Region* the_region);
+
+
+#endif /* LIB_REGION_H_ */
@@ -0,0 +1,484 @@
+/*
+ * region_test.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: agent
+ */
+
+
+
+
+
+
+/*****************************************************************************/
+/*                                Includes                                   */
+/*****************************************************************************/
+
+// unit testing framework
+#include "debug.h"
+#include "minunit.h"
+
+// project includes
+
+// class being tested
+#include "region.h"
+
+// C includes
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+
+// A2560 includes
+#include "a2560k.h"
+
+
+
+/*****************************************************************************/
+/*                               Definitions                                 */
+/*****************************************************************************/
+
+#define REGION_TEST_WIDTH		72		//!< size of the reference pixel map used to check region coverage
+#define REGION_TEST_HEIGHT		56
+#define REGION_TEST_ITERATIONS	400		//!< number of random operations applied per randomized test run
+#define REGION_TEST_RUNS		20		//!< number of times the randomized test starts over with an empty region
+
+#define REGION_SPEED_TEST_OPS	2000	//!< number of union + subtract operations in the speed test
+
+
+/*****************************************************************************/
+/*                               Enumerations                                */
+/*****************************************************************************/
+
+
+
+/*****************************************************************************/
+/*                             Global Variables                              */
+/*****************************************************************************/
+
+static uint32_t		test_random_seed = 12345;
+static uint8_t		test_pixel_map[REGION_TEST_HEIGHT][REGION_TEST_WIDTH];		// reference: 1 if pixel should be in the region
+
+
+/*****************************************************************************/
+/*                       Private Function Prototypes                         */
+/*****************************************************************************/
+
+// repeatable pseudo-random number from 0 to the_range - 1. (General_GetRandom uses the hardware generator, which can't be re-seeded for a repeatable test)
+int16_t Test_Random(int16_t the_range);
+
+// make a random rect that may extend past the edges of the reference map, and may be as small as 1x1
+void Test_RandomRect(Rectangle* the_rect);
+
+// apply an operation to the reference pixel map: 0=union, 1=intersect, 2=subtract
+void Test_ApplyToPixelMap(Rectangle* the_rect, int16_t the_op);
+
+// check the region covers exactly the pixels set in the reference map, and that its rects follow the banding rules. returns false on first problem found.
+bool Test_RegionMatchesPixelMap(Region* the_region);
+
+
+/*****************************************************************************/
+/*                       Private Function Definitions                        */
+/*****************************************************************************/
+
+// repeatable pseudo-random number from 0 to the_range - 1. (General_GetRandom uses the hardware generator, which can't be re-seeded for a repeatable test)
+int16_t Test_Random(int16_t the_range)
+{
+	test_random_seed = test_random_seed * 1103515245 + 12345;
+
+	return (int16_t)((test_random_seed >> 16) % the_range);
+}
+
+
+// make a random rect that may extend past the edges of the reference map, and may be as small as 1x1
+void Test_RandomRect(Rectangle* the_rect)
+{
+	the_rect->MinX = Test_Random(REGION_TEST_WIDTH + 8) - 4;
+	the_rect->MinY = Test_Random(REGION_TEST_HEIGHT + 8) - 4;
+	the_rect->MaxX = the_rect->MinX + Test_Random(REGION_TEST_WIDTH / 2);
+	the_rect->MaxY = the_rect->MinY + Test_Random(REGION_TEST_HEIGHT / 2);
+}
+
+
+// apply an operation to the reference pixel map: 0=union, 1=intersect, 2=subtract
+void Test_ApplyToPixelMap(Rectangle* the_rect, int16_t the_op)
+{
+	int16_t		x;
+	int16_t		y;
+
+	for (y = 0; y < REGION_TEST_HEIGHT; y++)
+	{
+		for (x = 0; x < REGION_TEST_WIDTH; x++)
+		{
+			bool	in_rect = (x >= the_rect->MinX && x <= the_rect->MaxX && y >= the_rect->MinY && y <= the_rect->MaxY);
+
+			if (the_op == 0 && in_rect)
+			{
+				test_pixel_map[y][x] = 1;
+			}
+			else if (the_op == 1 && !in_rect)
+			{
+				test_pixel_map[y][x] = 0;
+			}
+			else if (the_op == 2 && in_rect)
+			{
+				test_pixel_map[y][x] = 0;
+			}
+		}
+	}
+}
+
+
+// check the region covers exactly the pixels set in the reference map, and that its rects follow the banding rules. returns false on first problem found.
+bool Test_RegionMatchesPixelMap(Region* the_region)
+{
+	static uint8_t	coverage[REGION_TEST_HEIGHT][REGION_TEST_WIDTH];
+	int16_t			i;
+	int16_t			x;
+	int16_t			y;
+
+	memset(coverage, 0, sizeof(coverage));
+
+	for (i = 0; i < the_region->num_rects_; i++)
+	{
+		Rectangle*	the_rect = &the_region->rects_[i];
+
+		if (the_rect->MaxX < the_rect->MinX || the_rect->MaxY < the_rect->MinY)
+		{
+			printf("rect %i is empty \n", i);
+			return false;
+		}
+
+		if (i > 0)
+		{
+			Rectangle*	prev_rect = &the_region->rects_[i - 1];
+
+			if (prev_rect->MinY == the_rect->MinY)
+			{
+				// same band: must have same height, and be strictly to the right of the previous rect, with a gap
+				if (prev_rect->MaxY != the_rect->MaxY || prev_rect->MaxX + 1 >= the_rect->MinX)
+				{
+					printf("rect %i breaks band rules \n", i);
+					return false;
+				}
+			}
+			else if (prev_rect->MaxY >= the_rect->MinY)
+			{
+				printf("rect %i overlaps band above \n", i);
+				return false;
+			}
+		}
+
+		for (y = the_rect->MinY; y <= the_rect->MaxY; y++)
+		{
+			for (x = the_rect->MinX; x <= the_rect->MaxX; x++)
+			{
+				// region was only ever built from rects intersected with the map, or from the map itself, so it must stay within it
+				if (x < 0 || x >= REGION_TEST_WIDTH || y < 0 || y >= REGION_TEST_HEIGHT)
+				{
+					printf("rect %i extends outside of the test area \n", i);
+					return false;
+				}
+
+				if (coverage[y][x]++ != 0)
+				{
+					printf("pixel %i, %i covered twice \n", x, y);
+					return false;
+				}
+			}
+		}
+	}
+
+	for (y = 0; y < REGION_TEST_HEIGHT; y++)
+	{
+		for (x = 0; x < REGION_TEST_WIDTH; x++)
+		{
+			if (coverage[y][x] != test_pixel_map[y][x])
+			{
+				printf("pixel %i, %i: region has %u, expected %u \n", x, y, coverage[y][x], test_pixel_map[y][x]);
+				return false;
+			}
+
+			if (Region_ContainsPoint(the_region, x, y) != (bool)test_pixel_map[y][x])
+			{
+				printf("pixel %i, %i: Region_ContainsPoint disagrees with rects \n", x, y);
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+
+
+
+/*****************************************************************************/
+/*                        MinUnit Function Defintions                        */
+/*****************************************************************************/
+
+
+
+void test_setup(void)	// this is called EVERY test
+{
+// 	foo = 7;
+// 	bar = 4;
+//
+}
+
+
+void test_teardown(void)	// this is called EVERY test
+{
+
+}
+
+
+
+// **** unit tests
+
+MU_TEST(region_basic_test)
+{
+	Region*		the_region;
+	Rectangle	r1 = {10, 10, 19, 19};
+	Rectangle	r2 = {15, 15, 24, 24};
+	Rectangle	r3 = {0, 0, -1, -1};
+
+	the_region = Region_New();
+	mu_check(the_region != NULL);
+	mu_check(Region_IsEmpty(the_region));
+
+	// overlapping union: area counted once, 3 bands
+	mu_check(Region_UnionRect(the_region, &r1));
+	mu_check(Region_UnionRect(the_region, &r2));
+	mu_assert_int_eq(100 + 100 - 25, Region_GetArea(the_region));
+	mu_assert_int_eq(3, Region_GetRectCount(the_region));
+	mu_assert_int_eq(10, the_region->bounds_.MinX);
+	mu_assert_int_eq(24, the_region->bounds_.MaxY);
+
+	// adding the same rect again changes nothing
+	mu_check(Region_UnionRect(the_region, &r1));
+	mu_assert_int_eq(175, Region_GetArea(the_region));
+	mu_assert_int_eq(3, Region_GetRectCount(the_region));
+
+	// empty rect is ignored
+	mu_check(Region_UnionRect(the_region, &r3));
+	mu_assert_int_eq(175, Region_GetArea(the_region));
+
+	// subtract everything but the overlap
+	mu_check(Region_IntersectRect(the_region, &r2));
+	mu_assert_int_eq(100, Region_GetArea(the_region));
+	mu_assert_int_eq(1, Region_GetRectCount(the_region));
+	mu_check(Region_SubtractRect(the_region, &r1));
+	mu_assert_int_eq(75, Region_GetArea(the_region));
+	mu_check(Region_ContainsPoint(the_region, 24, 15));
+	mu_check(Region_ContainsPoint(the_region, 15, 15) == false);
+
+	// side by side rects coalesce into 1
+	mu_check(Region_SetRect(the_region, &r1));
+	r3.MinX = 20; r3.MinY = 10; r3.MaxX = 29; r3.MaxY = 19;
+	mu_check(Region_UnionRect(the_region, &r3));
+	mu_assert_int_eq(1, Region_GetRectCount(the_region));
+
+	// stacked rects coalesce into 1
+	r3.MinX = 10; r3.MinY = 20; r3.MaxX = 29; r3.MaxY = 29;
+	mu_check(Region_UnionRect(the_region, &r3));
+	mu_assert_int_eq(1, Region_GetRectCount(the_region));
+	mu_assert_int_eq(400, Region_GetArea(the_region));
+
+	Region_Offset(the_region, -10, -10);
+	mu_assert_int_eq(0, the_region->bounds_.MinX);
+	mu_assert_int_eq(19, the_region->bounds_.MaxY);
+
+	mu_check(Region_Destroy(&the_region));
+	mu_check(the_region == NULL);
+}
+
+
+MU_TEST(region_random_coverage_test)
+{
+	Region*		the_region;
+	Region*		other_region;
+	Rectangle	map_rect = {0, 0, REGION_TEST_WIDTH - 1, REGION_TEST_HEIGHT - 1};
+	int16_t		run;
+	int16_t		i;
+
+	the_region = Region_New();
+	other_region = Region_New();
+	mu_check(the_region != NULL);
+	mu_check(other_region != NULL);
+
+	// LOGIC:
+	//   apply random union/intersect/subtract rects to a region, and the same operations to a pixel map
+	//   after each step, the region's rects must cover exactly the pixels in the map, each one only once
+	//   every rect is clipped to the map area first, so the map can represent the region exactly
+
+	for (run = 0; run < REGION_TEST_RUNS; run++)
+	{
+		Region_MakeEmpty(the_region);
+		memset(test_pixel_map, 0, sizeof(test_pixel_map));
+
+		for (i = 0; i < REGION_TEST_ITERATIONS; i++)
+		{
+			Rectangle	the_rect;
+			int16_t		the_op;
+
+			Test_RandomRect(&the_rect);
+
+			// mostly unions, so the region builds up something worth subtracting from
+			the_op = Test_Random(5);
+			the_op = (the_op < 3) ? 0 : the_op - 2;
+
+			// every so often, combine with a multi-rect region instead of a single rect
+			if (Test_Random(4) == 0)
+			{
+				Rectangle	second_rect;
+
+				Test_RandomRect(&second_rect);
+				Region_SetRect(other_region, &the_rect);
+				Region_IntersectRect(other_region, &map_rect);
+				Region_UnionRect(other_region, &second_rect);
+				Region_IntersectRect(other_region, &map_rect);
+
+				if (the_op == 0)
+				{
+					mu_check(Region_Union(the_region, other_region));
+				}
+				else if (the_op == 1)
+				{
+					mu_check(Region_Intersect(the_region, other_region));
+				}
+				else
+				{
+					mu_check(Region_Subtract(the_region, other_region));
+				}
+
+				// intersect with 2 rects is not the same as 2 intersects, so the map update has to use the combined shape
+				if (the_op == 1)
+				{
+					int16_t		x;
+					int16_t		y;
+
+					for (y = 0; y < REGION_TEST_HEIGHT; y++)
+					{
+						for (x = 0; x < REGION_TEST_WIDTH; x++)
+						{
+							if (Region_ContainsPoint(other_region, x, y) == false)
+							{
+								test_pixel_map[y][x] = 0;
+							}
+						}
+					}
+				}
+				else
+				{
+					Test_ApplyToPixelMap(&the_rect, the_op);
+					Test_ApplyToPixelMap(&second_rect, the_op);
+				}
+			}
+			else
+			{
+				if (the_op == 0)
+				{
+					mu_check(Region_UnionRect(the_region, &the_rect));
+					mu_check(Region_IntersectRect(the_region, &map_rect));
+				}
+				else if (the_op == 1)
+				{
+					mu_check(Region_IntersectRect(the_region, &the_rect));
+				}
+				else
+				{
+					mu_check(Region_SubtractRect(the_region, &the_rect));
+				}
+
+				Test_ApplyToPixelMap(&the_rect, the_op);
+			}
+
+			if (Test_RegionMatchesPixelMap(the_region) == false)
+			{
+				printf("region mismatch on run %i, step %i, op %i \n", run, i, the_op);
+				Region_Print(the_region);
+				mu_fail("region coverage does not match reference pixel map");
+			}
+		}
+	}
+
+	Region_Destroy(&the_region);
+	Region_Destroy(&other_region);
+}
+
+
+
+// **** speed tests
+
+MU_TEST(test_speed_1)
+{
+	Region*		the_region;
+	Rectangle	the_rect;
+	long		start1;
+	long		end1;
+	int16_t		i;
+
+	the_region = Region_New();
+
+	// test speed of building up and cutting down a region made of many overlapping damage rects
+	start1 = mu_timer_real();
+
+	for (i = 0; i < REGION_SPEED_TEST_OPS; i++)
+	{
+		Test_RandomRect(&the_rect);
+		Region_UnionRect(the_region, &the_rect);
+		Test_RandomRect(&the_rect);
+		Region_SubtractRect(the_region, &the_rect);
+	}
+
+	end1 = mu_timer_real();
+
+	printf("\nSpeed results: %i region union+subtract pairs completed in %li ticks; region ended with %i rects\n", REGION_SPEED_TEST_OPS, end1 - start1, Region_GetRectCount(the_region));
+
+	Region_Destroy(&the_region);
+}
+
+
+
+// speed tests
+MU_TEST_SUITE(test_suite_speed)
+{
+	MU_SUITE_CONFIGURE(&test_setup, &test_teardown);
+
+	MU_RUN_TEST(test_speed_1);
+}
+
+
+// unit tests
+MU_TEST_SUITE(test_suite_units)
+{
+	MU_SUITE_CONFIGURE(&test_setup, &test_teardown);
+
+	MU_RUN_TEST(region_basic_test);
+	MU_RUN_TEST(region_random_coverage_test);
+}
+
+
+
+
+
+/*****************************************************************************/
+/*                        Public Function Definitions                        */
+/*****************************************************************************/
+
+
+
+int main(int argc, char* argv[])
+{
+	printf("**** region.c Test Suite **** \n");
+
+	MU_RUN_SUITE(test_suite_units);
+	MU_RUN_SUITE(test_suite_speed);
+	MU_REPORT();
+
+	printf("region test complete \n");
+
+	return MU_EXIT_CODE;
+}
@@ -0,0 +1,470 @@
+/*
+ * sprite.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: agent
+ */
+
+
+
+
+
+/*****************************************************************************/
+/*                                Includes                                   */
+/*****************************************************************************/
+
+// project includes
+#include "bitmap.h"
+#include "debug.h"
+#include "general.h"
+#include "sprite.h"
+
+// C includes
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// A2560 includes
+#include <mcp/syscalls.h>
+#include "a2560k.h"
+
+
+/*****************************************************************************/
+/*                               Definitions                                 */
+/*****************************************************************************/
+
+
+
+/*****************************************************************************/
+/*                               Enumerations                                */
+/*****************************************************************************/
+
+
+
+/*****************************************************************************/
+/*                          File-scoped Variables                            */
+/*****************************************************************************/
+
+static Sprite			sprite_table[SPRITE_MAX_SPRITES];
+static Sprite*			sprite_order[SPRITE_MAX_SPRITES];	// sprites in use, front to back. a sprite's index here is its hardware slot.
+static int16_t			sprite_num_in_use = 0;
+static uint32_t			sprite_regs = 0;					// address of hardware sprite 0's registers. 0 until Sprite_Init() is called.
+
+
+/*****************************************************************************/
+/*                             Global Variables                              */
+/*****************************************************************************/
+
+
+
+/*****************************************************************************/
+/*                       Private Function Prototypes                         */
+/*****************************************************************************/
+
+//! Write the sprite's position register, for the hardware slot it is in
+static void Sprite_WritePosition(Sprite* the_sprite);
+
+//! Write all of the registers of the sprite's hardware slot
+static void Sprite_WriteRegisters(Sprite* the_sprite);
+
+//! Sort the sprites in use by z-order, and give each the hardware slot matching its place. Unused slots are turned off.
+//! Only slots whose sprite changed are rewritten.
+static void Sprite_AssignSlots(void);
+
+
+/*****************************************************************************/
+/*                       Private Function Definitions                        */
+/*****************************************************************************/
+
+//! Write the sprite's position register, for the hardware slot it is in
+static void Sprite_WritePosition(Sprite* the_sprite)
+{
+	int32_t		the_x;
+	int32_t		the_y;
+
+	// LOGIC:
+	//   the VICKY's sprite coordinates are offset so that a sprite can hang off the top and left edges.
+	//   anything further off than that can't be shown anyway: pin it at the offscreen edge rather than let it wrap.
+
+	the_x = (int32_t)the_sprite->x_ - the_sprite->hot_x_ + SPRITE_POS_OFFSET;
+	the_y = (int32_t)the_sprite->y_ - the_sprite->hot_y_ + SPRITE_POS_OFFSET;
+	the_x = (the_x < 0 ? 0 : the_x);
+	the_y = (the_y < 0 ? 0 : the_y);
+
+	R32(sprite_regs + (uint32_t)the_sprite->slot_ * SPRITE_REG_STRIDE + SPRITE_REG_POS_OFFSET) = ((uint32_t)(uint16_t)the_y << 16) | (uint32_t)(uint16_t)the_x;
+}
+
+
+//! Write all of the registers of the sprite's hardware slot
+static void Sprite_WriteRegisters(Sprite* the_sprite)
+{
+	uint32_t	the_slot_regs = sprite_regs + (uint32_t)the_sprite->slot_ * SPRITE_REG_STRIDE;
+
+	R32(the_slot_regs + SPRITE_REG_ADDR_OFFSET) = the_sprite->image_.addr_int_ - (uint32_t)VRAM_START;
+	Sprite_WritePosition(the_sprite);
+	R32(the_slot_regs + SPRITE_REG_CTRL_OFFSET) = (the_sprite->visible_ ? SPRITE_CTRL_ENABLE : 0);
+}
+
+
+//! Sort the sprites in use by z-order, and give each the hardware slot matching its place. Unused slots are turned off.
+//! Only slots whose sprite changed are rewritten.
+static void Sprite_AssignSlots(void)
+{
+	Sprite*		the_sprite;
+	int16_t		old_num_in_use = sprite_num_in_use;
+	int16_t		i;
+	int16_t		j;
+
+	// LOGIC:
+	//   there are only a few sprites, and they rarely change order, so an insertion sort of the table is plenty.
+	//   walking the table in index order, and only moving a sprite past ones with a higher z-order, keeps ties in table order.
+
+	sprite_num_in_use = 0;
+
+	for (i = 0; i < SPRITE_MAX_SPRITES; i++)
+	{
+		the_sprite = &sprite_table[i];
+
+		if (the_sprite->in_use_ == false)
+		{
+			continue;
+		}
+
+		for (j = sprite_num_in_use; j > 0 && sprite_order[j - 1]->z_order_ > the_sprite->z_order_; j--)
+		{
+			sprite_order[j] = sprite_order[j - 1];
+		}
+
+		sprite_order[j] = the_sprite;
+		sprite_num_in_use++;
+	}
+
+	for (i = 0; i < sprite_num_in_use; i++)
+	{
+		the_sprite = sprite_order[i];
+
+		if (the_sprite->slot_ != i)
+		{
+			the_sprite->slot_ = i;
+			Sprite_WriteRegisters(the_sprite);
+		}
+	}
+
+	for (i = sprite_num_in_use; i < old_num_in_use; i++)
+	{
+		R32(sprite_regs + (uint32_t)i * SPRITE_REG_STRIDE + SPRITE_REG_CTRL_OFFSET) = 0;
+	}
+}
+
+
+
+
+/*****************************************************************************/
+/*                        Public Function Definitions                        */
+/*****************************************************************************/
+
+
+// **** SETUP *****
+
+//! Set up the sprite table. All sprites are freed, and all hardware sprites are turned off.
+//! @param	the_regs -- address of the first hardware sprite's registers. Normally VICKYB_SPRITE_REGS_A2560K. Tests can pass a buffer in standard RAM.
+//! @param	the_image_start -- address of the area the sprite images are stored in, in the machine's global address space. Normally VRAM_SPRITE_AREA_START.
+//! @param	the_image_len -- number of bytes in that area. Must be at least SPRITE_IMAGE_AREA_LEN.
+//! @return	Returns false if the image area is too small: no sprites will be available
+bool Sprite_Init(uint32_t the_regs, uint32_t the_image_start, uint32_t the_image_len)
+{
+	Sprite*		the_sprite;
+	int16_t		i;
+
+	sprite_regs = 0;
+	sprite_num_in_use = 0;
+
+	if (the_image_len < SPRITE_IMAGE_AREA_LEN)
+	{
+		LOG_ERR(("%s %d: sprite image area of %lu bytes is too small; need %lu", __func__ , __LINE__, the_image_len, (uint32_t)SPRITE_IMAGE_AREA_LEN));
+		return false;
+	}
+
+	sprite_regs = the_regs;
+
+	// LOGIC:
+	//   each sprite's image has a fixed place in the image area, so the address register only needs writing when a sprite changes slot.
+	//   the image is a Bitmap at a fixed VRAM address, so the usual Bitmap functions can fill and composite it.
+
+	for (i = 0; i < SPRITE_MAX_SPRITES; i++)
+	{
+		the_sprite = &sprite_table[i];
+		memset(the_sprite, 0, sizeof(Sprite));
+
+		the_sprite->image_.width_ = SPRITE_SIZE;
+		the_sprite->image_.height_ = SPRITE_SIZE;
+		the_sprite->image_.addr_int_ = the_image_start + (uint32_t)i * SPRITE_IMAGE_BYTES;
+		the_sprite->image_.addr_ = (unsigned char*)the_sprite->image_.addr_int_;
+		the_sprite->image_.in_vram_ = true;
+		the_sprite->image_.vram_block_ = false;
+		the_sprite->image_.capacity_ = 0;
+		the_sprite->slot_ = i;
+
+		R32(sprite_regs + (uint32_t)i * SPRITE_REG_STRIDE + SPRITE_REG_CTRL_OFFSET) = 0;
+	}
+
+	DEBUG_OUT(("%s %d: %i sprites, images at %lx-%lx", __func__ , __LINE__, SPRITE_MAX_SPRITES, the_image_start, the_image_start + SPRITE_IMAGE_AREA_LEN - 1));
+
+	return true;
+}
+
+
+// **** CONSTRUCTOR AND DESTRUCTOR *****
+
+//! Allocate a sprite. It starts hidden, with a transparent image, at 0,0.
+//! @param	the_z_order -- where the sprite goes in front-to-back order: 0 is front-most
+//! @return	Returns NULL if Sprite_Init() has not been called, or all sprites are in use
+Sprite* Sprite_New(uint8_t the_z_order)
+{
+	Sprite*		the_sprite;
+	int16_t		i;
+
+	if (sprite_regs == 0)
+	{
+		LOG_WARN(("%s %d: sprites are not set up", __func__ , __LINE__));
+		return NULL;
+	}
+
+	for (i = 0; i < SPRITE_MAX_SPRITES; i++)
+	{
+		the_sprite = &sprite_table[i];
+
+		if (the_sprite->in_use_ == false)
+		{
+			the_sprite->in_use_ = true;
+			the_sprite->visible_ = false;
+			the_sprite->x_ = 0;
+			the_sprite->y_ = 0;
+			the_sprite->hot_x_ = 0;
+			the_sprite->hot_y_ = 0;
+			the_sprite->z_order_ = the_z_order;
+			the_sprite->slot_ = SPRITE_MAX_SPRITES;	// not in any slot yet: forces its registers to be written
+			memset(the_sprite->image_.addr_, SPRITE_TRANSPARENT_COLOR, SPRITE_IMAGE_BYTES);
+
+			Sprite_AssignSlots();
+
+			return the_sprite;
+		}
+	}
+
+	LOG_WARN(("%s %d: all %i sprites are in use", __func__ , __LINE__, SPRITE_MAX_SPRITES));
+
+	return NULL;
+}
+
+
+//! Hide a sprite and make it available to Sprite_New() again
+//! @param	the_sprite -- pointer to a pointer to a sprite from Sprite_New(). It is set to NULL.
+void Sprite_Destroy(Sprite** the_sprite)
+{
+	if (the_sprite == NULL || *the_sprite == NULL)
+	{
+		LOG_ERR(("%s %d: passed sprite was null", __func__ , __LINE__));
+		return;
+	}
+
+	(*the_sprite)->in_use_ = false;
+	(*the_sprite)->visible_ = false;
+	*the_sprite = NULL;
+
+	// the sprites behind it each move up a slot, and the last slot is turned off
+	Sprite_AssignSlots();
+}
+
+
+// **** SET functions *****
+
+//! Copy an image into the sprite. Anything beyond SPRITE_SIZE x SPRITE_SIZE is cut off; the rest of the sprite is made transparent.
+//! @param	the_sprite -- a sprite from Sprite_New()
+//! @param	the_pixels -- the first pixel of the image, 8 bits per pixel. Pixels of SPRITE_TRANSPARENT_COLOR will be transparent.
+//! @param	the_row_bytes -- the number of bytes from one row of the_pixels to the next. To copy part of a bitmap, pass its width_.
+//! @param	width -- width of the image in pixels
+//! @param	height -- height of the image in pixels
+//! @param	hot_x -- horizontal position within the image that Sprite_MoveTo() places at the passed coordinate
+//! @param	hot_y -- vertical position within the image that Sprite_MoveTo() places at the passed coordinate
+//! @return	Returns false on any error/invalid input
+bool Sprite_SetImage(Sprite* the_sprite, const uint8_t* the_pixels, int16_t the_row_bytes, int16_t width, int16_t height, int16_t hot_x, int16_t hot_y)
+{
+	uint8_t*	the_write_loc;
+	int16_t		j;
+
+	if (the_sprite == NULL || the_pixels == NULL)
+	{
+		LOG_ERR(("%s %d: passed sprite or pixels were null", __func__ , __LINE__));
+		return false;
+	}
+
+	if (width < 0 || height < 0 || the_row_bytes < width)
+	{
+		LOG_ERR(("%s %d: invalid image size %i x %i, row bytes %i", __func__ , __LINE__, width, height, the_row_bytes));
+		return false;
+	}
+
+	width = (width > SPRITE_SIZE ? SPRITE_SIZE : width);
+	height = (height > SPRITE_SIZE ? SPRITE_SIZE : height);
+
+	// LOGIC:
+	//   the VICKY is showing this image while it is being replaced.
+	//   clearing it first and then copying rows would show a blank sprite for part of a frame; copying each row with its transparent tail doesn't.
+
+	the_write_loc = the_sprite->image_.addr_;
+
+	for (j = 0; j < height; j++)
+	{
+		memcpy(the_write_loc, the_pixels, width);
+		memset(the_write_loc + width, SPRITE_TRANSPARENT_COLOR, SPRITE_SIZE - width);
+		the_pixels += the_row_bytes;
+		the_write_loc += SPRITE_SIZE;
+	}
+
+	memset(the_write_loc, SPRITE_TRANSPARENT_COLOR, (uint32_t)(SPRITE_SIZE - height) * SPRITE_SIZE);
+
+	if (the_sprite->hot_x_ != hot_x || the_sprite->hot_y_ != hot_y)
+	{
+		the_sprite->hot_x_ = hot_x;
+		the_sprite->hot_y_ = hot_y;
+		Sprite_WritePosition(the_sprite);
+	}
+
+	return true;
+}
+
+
+//! Move the sprite so its hot spot is at the passed global coordinate. This is one register write: nothing on screen is redrawn.
+//! @param	the_sprite -- a sprite from Sprite_New()
+//! @param	x -- global horizontal coordinate. The sprite can be partly off any edge of the screen.
+//! @param	y -- global vertical coordinate.
+void Sprite_MoveTo(Sprite* the_sprite, int16_t x, int16_t y)
+{
+	if (the_sprite == NULL)
+	{
+		LOG_ERR(("%s %d: passed sprite was null", __func__ , __LINE__));
+		return;
+	}
+
+	if (the_sprite->x_ == x && the_sprite->y_ == y)
+	{
+		return;
+	}
+
+	the_sprite->x_ = x;
+	the_sprite->y_ = y;
+	Sprite_WritePosition(the_sprite);
+}
+
+
+//! Show or hide the sprite
+//! @param	the_sprite -- a sprite from Sprite_New()
+//! @param	visible -- true to show the sprite, false to hide it
+void Sprite_SetVisible(Sprite* the_sprite, bool visible)
+{
+	if (the_sprite == NULL)
+	{
+		LOG_ERR(("%s %d: passed sprite was null", __func__ , __LINE__));
+		return;
+	}
+
+	if (the_sprite->visible_ == visible)
+	{
+		return;
+	}
+
+	the_sprite->visible_ = visible;
+	R32(sprite_regs + (uint32_t)the_sprite->slot_ * SPRITE_REG_STRIDE + SPRITE_REG_CTRL_OFFSET) = (visible ? SPRITE_CTRL_ENABLE : 0);
+}
+
+
+//! Change where the sprite goes in front-to-back order. Hardware sprites are re-assigned so the VICKY draws them in the new order.
+//! @param	the_sprite -- a sprite from Sprite_New()
+//! @param	the_z_order -- 0 is front-most
+void Sprite_SetZOrder(Sprite* the_sprite, uint8_t the_z_order)
+{
+	if (the_sprite == NULL)
+	{
+		LOG_ERR(("%s %d: passed sprite was null", __func__ , __LINE__));
+		return;
+	}
+
+	if (the_sprite->z_order_ == the_z_order)
+	{
+		return;
+	}
+
+	the_sprite->z_order_ = the_z_order;
+	Sprite_AssignSlots();
+}
+
+
+// **** GET functions *****
+
+//! Get the global rect the sprite's image covers, whether it is visible or not
+//! @param	the_sprite -- a sprite from Sprite_New()
+//! @param	the_rect -- receives the rect
+void Sprite_GetRect(Sprite* the_sprite, Rectangle* the_rect)
+{
+	if (the_sprite == NULL || the_rect == NULL)
+	{
+		LOG_ERR(("%s %d: passed sprite or rect was null", __func__ , __LINE__));
+		return;
+	}
+
+	the_rect->MinX = the_sprite->x_ - the_sprite->hot_x_;
+	the_rect->MinY = the_sprite->y_ - the_sprite->hot_y_;
+	the_rect->MaxX = the_rect->MinX + SPRITE_SIZE - 1;
+	the_rect->MaxY = the_rect->MinY + SPRITE_SIZE - 1;
+}
+
+
+// **** COMPOSITING *****
+
+//! Draw the visible sprites onto a bitmap, back to front, the way the VICKY shows them on screen
+//! For hosts and emulators without a sprite engine, and for tests. On real hardware, the VICKY does this by itself.
+//! @param	the_bitmap -- the bitmap to draw onto. Its 0,0 is taken to be the screen's 0,0.
+//! @param	the_area -- optional rect within the bitmap to limit drawing to. Pass NULL to draw anywhere in the bitmap.
+void Sprite_Composite(Bitmap* the_bitmap, Rectangle* the_area)
+{
+	Sprite*		the_sprite;
+	Rectangle	the_sprite_rect;
+	Rectangle	the_draw_rect;
+	int16_t		i;
+
+	if (the_bitmap == NULL)
+	{
+		LOG_ERR(("%s %d: passed bitmap was null", __func__ , __LINE__));
+		return;
+	}
+
+	// back to front, so that sprites in front are drawn over those behind them
+	for (i = sprite_num_in_use - 1; i >= 0; i--)
+	{
+		the_sprite = sprite_order[i];
+
+		if (the_sprite->visible_ == false)
+		{
+			continue;
+		}
+
+		Sprite_GetRect(the_sprite, &the_sprite_rect);
+
+		if (the_area == NULL)
+		{
+			General_CopyRect(&the_draw_rect, &the_sprite_rect);
+		}
+		else if (General_CalculateRectIntersection(&the_sprite_rect, the_area, &the_draw_rect) == false)
+		{
+			continue;
+		}
+
+		// the blit clips to the bitmap
+		Bitmap_BlitTransparent(&the_sprite->image_, the_draw_rect.MinX - the_sprite_rect.MinX, the_draw_rect.MinY - the_sprite_rect.MinY,
+								the_bitmap, the_draw_rect.MinX, the_draw_rect.MinY,
+								the_draw_rect.MaxX - the_draw_rect.MinX + 1, the_draw_rect.MaxY - the_draw_rect.MinY + 1, SPRITE_TRANSPARENT_COLOR);
+	}
+}
@@ -0,0 +1,179 @@
+//! @file sprite.h
+
+/*
+ * sprite.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: agent
+ */
+
+#ifndef LIB_SPRITE_H_
+#define LIB_SPRITE_H_
+
+
+/* about this class: Sprite
+ *
+ * Manages the VICKY's hardware sprites, for things that move over the screen without being part of it: the mouse pointer, drag feedback, etc.
+ * A sprite is composited by the VICKY on top of the bitmap layers, so moving one is a register write: nothing under it needs to be redrawn or re-blitted.
+ *
+ * There is only one sprite engine, so sprites come from a fixed table: Sprite_Init() sets it up once, at system startup
+ * Each sprite has its own SPRITE_SIZE x SPRITE_SIZE image, in an area of VRAM kept out of the VRAM heap (so the VICKY's address for it never changes)
+ * Pixels of SPRITE_TRANSPARENT_COLOR in the image let what is under the sprite show through
+ * The VICKY draws lower-numbered hardware sprites in front of higher ones. Sprites have a z-order (0 is front-most),
+ *   and are assigned to hardware sprites in z-order. Changing a z-order re-assigns them.
+ * Sprite_Composite() draws the sprites onto a bitmap the way the VICKY would. This is a software stand-in for hosts
+ *   and emulators without a sprite engine, and lets tests check what would be on screen.
+ *
+ *** things this class needs to be able to do
+ * hand out and take back sprites
+ * copy an image into a sprite, with a hot spot: the point in the image that is placed at the sprite's position
+ * move, show, and hide sprites with as few register writes as possible
+ * keep the hardware sprite order matching the sprites' z-order
+ * draw the sprites onto a bitmap in software
+ *
+ * STRETCH GOALS
+ * animation: swap between images without copying them
+ *
+ * SUPER STRETCH GOALS
+ *
+ *
+ */
+
+
+/*****************************************************************************/
+/*                                Includes                                   */
+/*****************************************************************************/
+
+// project includes
+#include "bitmap.h"
+
+// C includes
+#include <stdbool.h>
+#include <stdint.h>
+
+
+// A2560 includes
+#include <mcp/syscalls.h>
+#include "a2560k.h"
+
+
+/*****************************************************************************/
+/*                            Macro Definitions                              */
+/*****************************************************************************/
+
+#define SPRITE_MAX_SPRITES			16		//!< number of sprites that can be allocated at once. The VICKY has more, but the OS only needs a few.
+#define SPRITE_SIZE					32		//!< width and height of every sprite image, in pixels. Images are 8 bits per pixel, using the sprite's LUT.
+#define SPRITE_IMAGE_BYTES			(SPRITE_SIZE * SPRITE_SIZE)
+#define SPRITE_IMAGE_AREA_LEN		(SPRITE_MAX_SPRITES * SPRITE_IMAGE_BYTES)	//!< bytes of VRAM needed for all the sprite images
+#define SPRITE_TRANSPARENT_COLOR	0		//!< pixels of this color in a sprite image are not drawn
+#define SPRITE_POS_OFFSET			32		//!< the VICKY places a sprite at 0,0 fully off the top left of the screen: screen coordinates are offset by this much
+
+#define SPRITE_FRONTMOST			0		//!< z-order for a sprite that should be in front of all others (eg, the mouse pointer)
+
+
+/*****************************************************************************/
+/*                               Enumerations                                */
+/*****************************************************************************/
+
+
+
+/*****************************************************************************/
+/*                                 Structs                                   */
+/*****************************************************************************/
+
+struct Sprite
+{
+	Bitmap			image_;			//!< the sprite's image. Its storage is the sprite's slot in the sprite image area, and never moves.
+	int16_t			x_;				//!< global horizontal position of the hot spot
+	int16_t			y_;				//!< global vertical position of the hot spot
+	int16_t			hot_x_;			//!< horizontal position within the image that is placed at x_
+	int16_t			hot_y_;			//!< vertical position within the image that is placed at y_
+	uint8_t			z_order_;		//!< 0 is front-most. Sprites with the same z-order are drawn in table order.
+	uint8_t			slot_;			//!< the hardware sprite this sprite is currently shown with. Lower slots draw in front.
+	bool			in_use_;		//!< false while the sprite is available to Sprite_New()
+	bool			visible_;
+};
+
+
+
+/*****************************************************************************/
+/*                             Global Variables                              */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*                       Public Function Prototypes                          */
+/*****************************************************************************/
+
+
+// **** SETUP *****
+
+//! Set up the sprite table. All sprites are freed, and all hardware sprites are turned off.
+//! @param	the_regs -- address of the first hardware sprite's registers. Normally VICKYB_SPRITE_REGS_A2560K. Tests can pass a buffer in standard RAM.
+//! @param	the_image_start -- address of the area the sprite images are stored in, in the machine's global address space. Normally VRAM_SPRITE_AREA_START.
+//! @param	the_image_len -- number of bytes in that area. Must be at least SPRITE_IMAGE_AREA_LEN.
+//! @return	Returns false if the image area is too small: no sprites will be available
+bool Sprite_Init(uint32_t the_regs, uint32_t the_image_start, uint32_t the_image_len);
+
+
+// **** CONSTRUCTOR AND DESTRUCTOR *****
+
+//! Allocate a sprite. It starts hidden, with a transparent image, at 0,0.
+//! @param	the_z_order -- where the sprite goes in front-to-back order: 0 is front-most
+//! @return	Returns NULL if Sprite_Init() has not been called, or all sprites are in use
+Sprite* Sprite_New(uint8_t the_z_order);
+
+//! Hide a sprite and make it available to Sprite_New() again
+//! @param	the_sprite -- pointer to a pointer to a sprite from Sprite_New(). It is set to NULL.
+void Sprite_Destroy(Sprite** the_sprite);
+
+
+// **** SET functions *****
+
+//! Copy an image into the sprite. Anything beyond SPRITE_SIZE x SPRITE_SIZE is cut off; the rest of the sprite is made transparent.
+//! @param	the_sprite -- a sprite from Sprite_New()
+//! @param	the_pixels -- the first pixel of the image, 8 bits per pixel. Pixels of SPRITE_TRANSPARENT_COLOR will be transparent.
+//! @param	the_row_bytes -- the number of bytes from one row of the_pixels to the next. To copy part of a bitmap, pass its width_.
+//! @param	width -- width of the image in pixels
+//! @param	height -- height of the image in pixels
+//! @param	hot_x -- horizontal position within the image that Sprite_MoveTo() places at the passed coordinate
+//! @param	hot_y -- vertical position within the image that Sprite_MoveTo() places at the passed coordinate
+//! @return	Returns false on any error/invalid input
+bool Sprite_SetImage(Sprite* the_sprite, const uint8_t* the_pixels, int16_t the_row_bytes, int16_t width, int16_t height, int16_t hot_x, int16_t hot_y);
+
+//! Move the sprite so its hot spot is at the passed global coordinate. This is one register write: nothing on screen is redrawn.
+//! @param	the_sprite -- a sprite from Sprite_New()
+//! @param	x -- global horizontal coordinate. The sprite can be partly off any edge of the screen.
+//! @param	y -- global vertical coordinate.
+void Sprite_MoveTo(Sprite* the_sprite, int16_t x, int16_t y);
+
+//! Show or hide the sprite
+//! @param	the_sprite -- a sprite from Sprite_New()
+//! @param	visible -- true to show the sprite, false to hide it
+void Sprite_SetVisible(Sprite* the_sprite, bool visible);
+
+//! Change where the sprite goes in front-to-back order. Hardware sprites are re-assigned so the VICKY draws them in the new order.
+//! @param	the_sprite -- a sprite from Sprite_New()
+//! @param	the_z_order -- 0 is front-most
+void Sprite_SetZOrder(Sprite* the_sprite, uint8_t the_z_order);
+
+
+// **** GET functions *****
+
+//! Get the global rect the sprite's image covers, whether it is visible or not
+//! @param	the_sprite -- a sprite from Sprite_New()
+//! @param	the_rect -- receives the rect
+void Sprite_GetRect(Sprite* the_sprite, Rectangle* the_rect);
+
+
+// **** COMPOSITING *****
+
+//! Draw the visible sprites onto a bitmap, back to front, the way the VICKY shows them on screen
+//! For hosts and emulators without a sprite engine, and for tests. On real hardware, the VICKY does this by itself.
+//! @param	the_bitmap -- the bitmap to draw onto. Its 0,0 is taken to be the screen's 0,0.
+//! @param	the_area -- optional rect within the bitmap to limit drawing to. Pass NULL to draw anywhere in the bitmap.
+void Sprite_Composite(Bitmap* the_bitmap, Rectangle* the_area);
+
+
+
+#endif /* LIB_SPRITE_H_ */
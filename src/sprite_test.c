@@ -0,0 +1,352 @@
+/*
+ * sprite_test.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: agent
+ */
+
+
+
+
+
+
+/*****************************************************************************/
+/*                                Includes                                   */
+/*****************************************************************************/
+
+// unit testing framework
+#include "debug.h"
+#include "minunit.h"
+
+// project includes
+#include "bitmap.h"
+#include "mouse.h"
+#include "sys.h"
+
+// class being tested
+#include "sprite.h"
+
+// C includes
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+
+// A2560 includes
+#include "a2560k.h"
+
+
+
+/*****************************************************************************/
+/*                               Definitions                                 */
+/*****************************************************************************/
+
+#define SPRITE_TEST_NUM_REGS	(SPRITE_MAX_SPRITES * SPRITE_REG_STRIDE / sizeof(uint32_t))
+
+
+/*****************************************************************************/
+/*                               Enumerations                                */
+/*****************************************************************************/
+
+
+
+/*****************************************************************************/
+/*                             Global Variables                              */
+/*****************************************************************************/
+
+System*			global_system;
+
+// LOGIC: the tests run the sprites over registers and an image area in standard RAM, rather than the VICKY's, so what was written can be checked
+static uint32_t		test_sprite_regs[SPRITE_TEST_NUM_REGS];
+static uint8_t		test_sprite_images[SPRITE_IMAGE_AREA_LEN];
+
+
+/*****************************************************************************/
+/*                       Private Function Prototypes                         */
+/*****************************************************************************/
+
+// get the value last written to one of a hardware sprite's registers
+uint32_t Test_GetSpriteReg(int16_t the_slot, uint32_t the_offset);
+
+
+/*****************************************************************************/
+/*                       Private Function Definitions                        */
+/*****************************************************************************/
+
+// get the value last written to one of a hardware sprite's registers
+uint32_t Test_GetSpriteReg(int16_t the_slot, uint32_t the_offset)
+{
+	return test_sprite_regs[((uint32_t)the_slot * SPRITE_REG_STRIDE + the_offset) / sizeof(uint32_t)];
+}
+
+
+
+
+/*****************************************************************************/
+/*                        MinUnit Function Defintions                        */
+/*****************************************************************************/
+
+
+
+void test_setup(void)	// this is called EVERY test
+{
+	memset(test_sprite_regs, 0xFF, sizeof(test_sprite_regs));
+	Sprite_Init((uint32_t)test_sprite_regs, (uint32_t)test_sprite_images, sizeof(test_sprite_images));
+}
+
+
+void test_teardown(void)	// this is called EVERY test
+{
+
+}
+
+
+
+// **** unit tests
+
+MU_TEST(sprite_alloc_test)
+{
+	Sprite*		the_sprites[SPRITE_MAX_SPRITES];
+	Sprite*		the_extra_sprite;
+	int16_t		i;
+
+	// init turns every hardware sprite off
+	for (i = 0; i < SPRITE_MAX_SPRITES; i++)
+	{
+		mu_assert_int_eq(0, Test_GetSpriteReg(i, SPRITE_REG_CTRL_OFFSET));
+	}
+
+	for (i = 0; i < SPRITE_MAX_SPRITES; i++)
+	{
+		the_sprites[i] = Sprite_New(i);
+		mu_assert(the_sprites[i] != NULL, "could not allocate sprite");
+	}
+
+	mu_check( Sprite_New(0) == NULL );
+
+	// a sprite that is given back can be handed out again, with a blank image
+	memset(the_sprites[3]->image_.addr_, 0x55, SPRITE_IMAGE_BYTES);
+	Sprite_Destroy(&the_sprites[3]);
+	mu_check( the_sprites[3] == NULL );
+
+	the_extra_sprite = Sprite_New(0);
+	mu_check( the_extra_sprite != NULL );
+	mu_assert_int_eq(SPRITE_TRANSPARENT_COLOR, the_extra_sprite->image_.addr_[SPRITE_IMAGE_BYTES - 1]);
+	mu_check( the_extra_sprite->visible_ == false );
+
+	// with no room for images, there are no sprites
+	mu_check( Sprite_Init((uint32_t)test_sprite_regs, (uint32_t)test_sprite_images, SPRITE_IMAGE_AREA_LEN - 1) == false );
+	mu_check( Sprite_New(0) == NULL );
+}
+
+
+MU_TEST(sprite_move_test)
+{
+	Sprite*		the_sprite;
+	uint8_t		the_pixels[4] = {7, 7, 7, 7};
+
+	the_sprite = Sprite_New(SPRITE_FRONTMOST);
+	mu_assert(the_sprite != NULL, "could not allocate sprite");
+
+	// the image address is set up once, when the sprite gets its slot
+	mu_assert_int_eq(the_sprite->image_.addr_int_ - (uint32_t)VRAM_START, Test_GetSpriteReg(the_sprite->slot_, SPRITE_REG_ADDR_OFFSET));
+	mu_assert_int_eq(0, Test_GetSpriteReg(the_sprite->slot_, SPRITE_REG_CTRL_OFFSET));
+
+	mu_check( Sprite_SetImage(the_sprite, the_pixels, 2, 2, 2, 1, 1) == true );
+	mu_assert_int_eq(7, the_sprite->image_.addr_[SPRITE_SIZE + 1]);
+	mu_assert_int_eq(SPRITE_TRANSPARENT_COLOR, the_sprite->image_.addr_[2]);
+
+	Sprite_SetVisible(the_sprite, true);
+	mu_assert_int_eq(SPRITE_CTRL_ENABLE, Test_GetSpriteReg(the_sprite->slot_, SPRITE_REG_CTRL_OFFSET));
+
+	// the hot spot is placed at the passed position, in the VICKY's offset coordinates
+	Sprite_MoveTo(the_sprite, 100, 50);
+	mu_assert_int_eq(((uint32_t)(50 - 1 + SPRITE_POS_OFFSET) << 16) | (100 - 1 + SPRITE_POS_OFFSET), Test_GetSpriteReg(the_sprite->slot_, SPRITE_REG_POS_OFFSET));
+
+	// partly off the top left is fine; further than that is pinned at the edge
+	Sprite_MoveTo(the_sprite, -10, -100);
+	mu_assert_int_eq((uint32_t)(-10 - 1 + SPRITE_POS_OFFSET), Test_GetSpriteReg(the_sprite->slot_, SPRITE_REG_POS_OFFSET));
+
+	Sprite_SetVisible(the_sprite, false);
+	mu_assert_int_eq(0, Test_GetSpriteReg(the_sprite->slot_, SPRITE_REG_CTRL_OFFSET));
+}
+
+
+MU_TEST(sprite_z_order_test)
+{
+	Sprite*		the_back_sprite;
+	Sprite*		the_front_sprite;
+
+	the_back_sprite = Sprite_New(5);
+	the_front_sprite = Sprite_New(1);
+	mu_assert(the_back_sprite != NULL && the_front_sprite != NULL, "could not allocate sprites");
+
+	// lower slots are drawn in front
+	mu_assert_int_eq(0, the_front_sprite->slot_);
+	mu_assert_int_eq(1, the_back_sprite->slot_);
+	mu_assert_int_eq(the_front_sprite->image_.addr_int_ - (uint32_t)VRAM_START, Test_GetSpriteReg(0, SPRITE_REG_ADDR_OFFSET));
+
+	Sprite_SetVisible(the_back_sprite, true);
+	Sprite_SetZOrder(the_back_sprite, 0);
+	mu_assert_int_eq(0, the_back_sprite->slot_);
+	mu_assert_int_eq(1, the_front_sprite->slot_);
+	mu_assert_int_eq(the_back_sprite->image_.addr_int_ - (uint32_t)VRAM_START, Test_GetSpriteReg(0, SPRITE_REG_ADDR_OFFSET));
+	mu_assert_int_eq(SPRITE_CTRL_ENABLE, Test_GetSpriteReg(0, SPRITE_REG_CTRL_OFFSET));
+
+	// when a sprite goes, those behind it move up, and the slot left over is turned off
+	Sprite_Destroy(&the_back_sprite);
+	mu_assert_int_eq(0, the_front_sprite->slot_);
+	mu_assert_int_eq(0, Test_GetSpriteReg(1, SPRITE_REG_CTRL_OFFSET));
+}
+
+
+MU_TEST(sprite_composite_test)
+{
+	Bitmap*		the_bitmap;
+	Sprite*		the_front_sprite;
+	Sprite*		the_back_sprite;
+	Sprite*		the_hidden_sprite;
+	Rectangle	the_area;
+	uint8_t		the_pixels[16];
+
+	the_bitmap = Bitmap_New(64, 64, NULL, PARAM_NOT_IN_VRAM);
+	mu_assert(the_bitmap != NULL, "could not create bitmap");
+	Bitmap_FillMemory(the_bitmap, 0x11);
+
+	the_front_sprite = Sprite_New(0);
+	the_back_sprite = Sprite_New(1);
+	the_hidden_sprite = Sprite_New(2);
+	mu_assert(the_front_sprite != NULL && the_back_sprite != NULL && the_hidden_sprite != NULL, "could not allocate sprites");
+
+	memset(the_pixels, 7, sizeof(the_pixels));
+	Sprite_SetImage(the_front_sprite, the_pixels, 4, 4, 4, 0, 0);
+	memset(the_pixels, 9, sizeof(the_pixels));
+	the_pixels[0] = SPRITE_TRANSPARENT_COLOR;
+	Sprite_SetImage(the_back_sprite, the_pixels, 4, 4, 4, 0, 0);
+	Sprite_SetImage(the_hidden_sprite, the_pixels, 4, 4, 4, 0, 0);
+
+	Sprite_MoveTo(the_front_sprite, 10, 10);
+	Sprite_MoveTo(the_back_sprite, 12, 12);
+	Sprite_MoveTo(the_hidden_sprite, 30, 30);
+	Sprite_SetVisible(the_front_sprite, true);
+	Sprite_SetVisible(the_back_sprite, true);
+
+	// the front sprite covers the back one where they overlap; transparent pixels and hidden sprites leave the bitmap alone
+	Sprite_Composite(the_bitmap, NULL);
+	mu_assert_int_eq(7, Bitmap_GetPixelAtXY(the_bitmap, 10, 10));
+	mu_assert_int_eq(7, Bitmap_GetPixelAtXY(the_bitmap, 13, 13));
+	mu_assert_int_eq(9, Bitmap_GetPixelAtXY(the_bitmap, 15, 15));
+	mu_assert_int_eq(9, Bitmap_GetPixelAtXY(the_bitmap, 14, 12));
+	mu_assert_int_eq(0x11, Bitmap_GetPixelAtXY(the_bitmap, 16, 16));
+	mu_assert_int_eq(0x11, Bitmap_GetPixelAtXY(the_bitmap, 30, 30));
+
+	// moving the back sprite in front changes which one wins
+	Sprite_SetZOrder(the_back_sprite, 0);
+	Sprite_SetZOrder(the_front_sprite, 1);
+	Sprite_Composite(the_bitmap, NULL);
+	mu_assert_int_eq(9, Bitmap_GetPixelAtXY(the_bitmap, 13, 13));
+	mu_assert_int_eq(7, Bitmap_GetPixelAtXY(the_bitmap, 12, 12));
+
+	// drawing can be limited to part of the bitmap, and sprites can hang off its edges
+	Bitmap_FillMemory(the_bitmap, 0x11);
+	Sprite_MoveTo(the_front_sprite, -2, 62);
+	the_area.MinX = 0;
+	the_area.MinY = 0;
+	the_area.MaxX = 12;
+	the_area.MaxY = 63;
+	Sprite_Composite(the_bitmap, &the_area);
+	mu_assert_int_eq(7, Bitmap_GetPixelAtXY(the_bitmap, 0, 63));
+	mu_assert_int_eq(9, Bitmap_GetPixelAtXY(the_bitmap, 12, 13));
+	mu_assert_int_eq(0x11, Bitmap_GetPixelAtXY(the_bitmap, 13, 13));
+
+	Bitmap_Destroy(&the_bitmap);
+}
+
+
+MU_TEST(sprite_drag_image_test)
+{
+	MouseTracker*	the_mouse;
+	Bitmap*			the_window_bitmap;
+	Bitmap*			the_screen;
+	Rectangle		the_grab;
+
+	the_window_bitmap = Bitmap_New(64, 64, NULL, PARAM_NOT_IN_VRAM);
+	the_screen = Bitmap_New(128, 128, NULL, PARAM_NOT_IN_VRAM);
+	mu_assert(the_window_bitmap != NULL && the_screen != NULL, "could not create bitmaps");
+	Bitmap_FillMemory(the_window_bitmap, 0x22);
+	Bitmap_SetPixelAtXY(the_window_bitmap, 0, 0, 0x33);
+
+	the_mouse = Mouse_New();
+	mu_assert(the_mouse != NULL, "could not create mouse tracker");
+	Mouse_SetXY(the_mouse, 40, 40);
+	mu_check( Mouse_HasDragImage(the_mouse) == false );
+
+	// grabbed near the window's top left corner: the part of the grab outside the window is cut off, and the click point stays under the pointer
+	the_grab.MinX = 2 - SPRITE_SIZE / 2;
+	the_grab.MinY = 2 - SPRITE_SIZE / 2;
+	the_grab.MaxX = the_grab.MinX + SPRITE_SIZE - 1;
+	the_grab.MaxY = the_grab.MinY + SPRITE_SIZE - 1;
+	mu_check( Mouse_SetDragImage(the_mouse, the_window_bitmap, &the_grab, SPRITE_SIZE / 2, SPRITE_SIZE / 2) == true );
+	mu_check( Mouse_HasDragImage(the_mouse) == true );
+
+	Bitmap_FillMemory(the_screen, 0x11);
+	Sprite_Composite(the_screen, NULL);
+	mu_assert_int_eq(0x22, Bitmap_GetPixelAtXY(the_screen, 40, 40));
+	mu_assert_int_eq(0x33, Bitmap_GetPixelAtXY(the_screen, 38, 38));
+	mu_assert_int_eq(0x11, Bitmap_GetPixelAtXY(the_screen, 37, 37));
+
+	// the image follows the pointer with no redraw
+	Mouse_SetXY(the_mouse, 60, 70);
+	Bitmap_FillMemory(the_screen, 0x11);
+	Sprite_Composite(the_screen, NULL);
+	mu_assert_int_eq(0x33, Bitmap_GetPixelAtXY(the_screen, 58, 68));
+	mu_assert_int_eq(0x11, Bitmap_GetPixelAtXY(the_screen, 38, 38));
+
+	// once cleared, its sprite is given back
+	Mouse_ClearDragImage(the_mouse);
+	mu_check( Mouse_HasDragImage(the_mouse) == false );
+	Bitmap_FillMemory(the_screen, 0x11);
+	Sprite_Composite(the_screen, NULL);
+	mu_assert_int_eq(0x11, Bitmap_GetPixelAtXY(the_screen, 58, 68));
+
+	Mouse_Destroy(&the_mouse);
+	Bitmap_Destroy(&the_window_bitmap);
+	Bitmap_Destroy(&the_screen);
+}
+
+
+
+// unit tests
+MU_TEST_SUITE(test_suite_units)
+{
+	MU_SUITE_CONFIGURE(&test_setup, &test_teardown);
+
+	MU_RUN_TEST(sprite_alloc_test);
+	MU_RUN_TEST(sprite_move_test);
+	MU_RUN_TEST(sprite_z_order_test);
+	MU_RUN_TEST(sprite_composite_test);
+	MU_RUN_TEST(sprite_drag_image_test);
+}
+
+
+
+
+
+/*****************************************************************************/
+/*                        Public Function Definitions                        */
+/*****************************************************************************/
+
+
+
+int main(int argc, char* argv[])
+{
+	printf("**** sprite.c Test Suite **** \n");
+
+	MU_RUN_SUITE(test_suite_units);
+	MU_REPORT();
+
+	printf("sprite test complete \n");
+
+	return MU_EXIT_CODE;
+}
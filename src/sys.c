@@ -19,10 +19,17 @@
 #include "event.h"
 #include "font.h"
 #include "general.h"
+#include "hitgrid.h"
 #include "list.h"
 #include "menu.h"
+#include "mouse.h"
+#include "pageflip.h"
+#include "pool.h"
+#include "region.h"
+#include "sprite.h"
 #include "sys.h"
 #include "theme.h"
+#include "vram.h"
 #include "window.h"
 #include "mcp_code/ps2.h"
 
@@ -68,6 +75,7 @@ extern System*			global_system;
 // MCP / previous interrupt handler functions for restore on exit
 p_int_handler	global_old_keyboard_interrupt;
 p_int_handler	global_old_mouse_interrupt;
+p_int_handler	global_old_sof_interrupt;
 // p_int_handler is defined in mcp/interrupt.h as typedef void (*p_int_handler)();
 
 // VGA colors, used for both fore- and background colors in Text mode
@@ -141,6 +149,10 @@ void Sys_InterruptKeyboard(void);
 // Interrupt handler for PS/2 mouse
 void Sys_InterruptMouse(void);
 
+//! Flip pages from the main loop, rather than the start of frame interrupt
+//! @param	the_system -- valid pointer to system object. Double-buffering must be on.
+void Sys_FlipFromMainLoop(System* the_system);
+
 
 
 
@@ -151,6 +163,21 @@ void Sys_InterruptMouse(void);
 
 
 
+//! Flip pages from the main loop, rather than the start of frame interrupt
+//! @param	the_system -- valid pointer to system object. Double-buffering must be on.
+void Sys_FlipFromMainLoop(System* the_system)
+{
+	// LOGIC:
+	//   the start of frame interrupt also calls PageFlip_Flip(), which reads and clears the pending flag and swaps the pages.
+	//     if it came in partway through this call, the pages would be swapped twice, and the one being drawn into would be shown.
+	//     so it is masked for the length of the flip, a few register writes.
+	
+	sys_int_disable(SYS_INT_VICKY_B_SOF);
+	PageFlip_Flip(the_system->page_flip_, Sys_GetFrameCount(the_system));
+	sys_int_enable(SYS_INT_VICKY_B_SOF);
+}
+
+
 //! Instruct all windows to close / clean themselves up
 //! @param	the_system -- valid pointer to system object
 void Sys_DestroyAllWindows(System* the_system)
@@ -176,6 +203,7 @@ void Sys_DestroyAllWindows(System* the_system)
 	{
 		Window*		this_window = (Window*)(the_item->payload_);
 		
+		HitGrid_RemoveWindow(the_system->hit_grid_, this_window);
 		Window_Destroy(&this_window);
 		++num_nodes;
 		--the_system->window_count_;
@@ -674,6 +702,12 @@ bool Sys_Destroy(System** the_system)
 		return false;
 	}
 
+	// put the screen back on the layer's own bitmap before the spare page goes away
+	if ((*the_system)->page_flip_)
+	{
+		Sys_SetDoubleBuffer(*the_system, false);
+	}
+
 	for (i = 0; i < 2; i++)
 	{
 		if ((*the_system)->screen_[i])
@@ -710,6 +744,14 @@ bool Sys_Destroy(System** the_system)
 		Sys_DestroyAllWindows(*the_system);
 	}
 
+	if ((*the_system)->hit_grid_)
+	{
+		HitGrid_Destroy(&(*the_system)->hit_grid_);
+	}
+
+	// log how far each pool and the buffer arena had to grow this session, and how fragmented the arena ended up
+	Pool_LogStats();
+	Vram_LogStats();
 
 	LOG_ALLOC(("%s %d:	__FREE__	*the_system	%p	size	%i", __func__ , __LINE__, *the_system, sizeof(System)));
 	TRACK_ALLOC((0 - sizeof(System)));
@@ -729,8 +771,10 @@ void Sys_Exit(System** the_system, bool error_condition)
 	// clean up system objects
 	Sys_Destroy(the_system);
 	
-	// clear the mouse interrupt so it doesn't call code that is no longer in RAM
+	// clear the mouse and start of frame interrupts so they don't call code that is no longer in RAM
 	sys_int_register(INT_MOUSE, NULL);
+	sys_int_disable(SYS_INT_VICKY_B_SOF);
+	sys_int_register(SYS_INT_VICKY_B_SOF, global_old_sof_interrupt);
 
 	// call MCP exit to return control to it
 	if (error_condition == PARAM_EXIT_ON_ERROR)
@@ -780,6 +824,13 @@ bool Sys_InitSystem(System* the_system)
 		goto error;
 	}
 
+	// hit grid, for finding the window under the mouse. every window, including the backdrop, is added to it as it is added to the window list
+	if ( (the_system->hit_grid_ = HitGrid_New() ) == NULL)
+	{
+		LOG_ERR(("%s %d: could not allocate memory to create the hit grid", __func__ , __LINE__));
+		goto error;
+	}
+
 	DEBUG_OUT(("%s %d: EventManager created ok. Detecting hardware...", __func__ , __LINE__));
 	
 	// check what kind of hardware the system is running on
@@ -814,6 +865,17 @@ bool Sys_InitSystem(System* the_system)
 		the_system->screen_[1] = the_system->screen_[0];
 	}
 
+	// VRAM heap: the VRAM after the 2 screen layers (see below) is handed out to window and menu bitmaps
+	if (Vram_Init(VRAM_HEAP_START, VRAM_HEAP_LEN) == false)
+	{
+		LOG_WARN(("%s %d: could not set up VRAM heap; off-screen bitmaps will use standard RAM", __func__ , __LINE__));
+	}
+
+	// LOGIC:
+	//   sprites are only set up when a program turns them on with Sys_SetGraphicMode(): see there.
+	//   the mouse pointer stays the VICKY's own. the sprite pointer (Mouse_ShowPointer()) can only replace it once mouse positions
+	//     are worked out from the PS/2 packets: until then, it would be a second pointer that doesn't follow the mouse.
+
 	DEBUG_OUT(("%s %d: returning to SysInit()...", __func__ , __LINE__, i));
 	
 	// LOGIC: we don't have font info yet; just want to make it clear these are not set and not rely on compiler behavior
@@ -864,9 +926,10 @@ bool Sys_InitSystem(System* the_system)
 	// allocate the foreground and background bitmaps, then assign them fixed locations in VRAM
 	
 	// LOGIC: 
-	//   The only bitmaps we want pointing to VRAM locations are the system's layer0 and layer1 bitmaps for the screen
+	//   The only bitmaps we want pointing to fixed VRAM locations are the system's layer0 and layer1 bitmaps for the screen
 	//   Only 1 screen has bitmapped graphics
 	//   We assign them fixed spaces in VRAM, 800*600 apart, so that the addresses are good even on a screen resolution change. 
+	//   The rest of VRAM is the VRAM heap, for other bitmaps that ask for it. 
 	
 	for (i = 0; i < 2; i++)
 	{
@@ -930,6 +993,16 @@ bool Sys_InitSystem(System* the_system)
 // 	global_old_mouse_interrupt = sys_int_register(INT_MOUSE, &Sys_InterruptMouse);
 // 	DEBUG_OUT(("%s %d: osf mouse interrupt (%p) installed, replacing MCP %p", __func__, __LINE__, &Sys_InterruptMouse, global_old_mouse_interrupt));
 
+	// LOGIC:
+	//   renders are not done as soon as something changes; they are requested, and done at most once per video frame
+	//   the start of frame interrupt just counts frames. if it never fires (emulator), Sys_GetFrameCount() falls back on jiffies
+	global_system->frame_count_ = 0;
+	global_system->last_render_frame_ = 0;
+	global_system->render_pending_ = false;
+	global_system->drag_mode_ = WIN_DRAG_OUTLINE;
+	global_old_sof_interrupt = sys_int_register(SYS_INT_VICKY_B_SOF, &Sys_InterruptStartOfFrame);
+	sys_int_enable(SYS_INT_VICKY_B_SOF);
+
 
 	DEBUG_OUT(("%s %d: System initialization complete.", __func__, __LINE__));
 
@@ -964,6 +1037,23 @@ void Sys_InterruptMouse(void)
 	return;
 }
 
+//! Interrupt handler for VICKY start of frame: advances the system frame counter, and flips pages if double-buffering. Does no drawing.
+void Sys_InterruptStartOfFrame(void)
+{
+	if (global_system != NULL)
+	{
+		global_system->frame_count_++;
+		
+		// double-buffering: show the page the last render pass composed, if it's finished. just a register write.
+		if (global_system->page_flip_ != NULL)
+		{
+			PageFlip_Flip(global_system->page_flip_, global_system->frame_count_);
+		}
+	}
+	
+	return;
+}
+
 
 
 
@@ -1006,6 +1096,26 @@ bool Sys_SetGraphicMode(System* the_system, bool enable_sprites, bool enable_bit
 	if (enable_sprites)
 	{
 		the_bits |= GRAPHICS_MODE_EN_SPRITE;
+		
+		// the sprite registers are channel B's: only the A2560K family has them at this address
+		if (the_system->sprites_ready_ == false && 
+			(the_system->model_number_ == MACHINE_A2560X || 
+			the_system->model_number_ == MACHINE_A2560K ||
+			the_system->model_number_ == MACHINE_A2560K40 ||
+			the_system->model_number_ == MACHINE_A2560K60 ||
+			the_system->model_number_ == MACHINE_GENX)
+			)
+		{
+			// images live in VRAM kept out of the VRAM heap
+			if (Sprite_Init(VICKYB_SPRITE_REGS_A2560K, VRAM_SPRITE_AREA_START, VRAM_SPRITE_AREA_LEN) == false)
+			{
+				LOG_WARN(("%s %d: could not set up sprites", __func__ , __LINE__));
+			}
+			else
+			{
+				the_system->sprites_ready_ = true;
+			}
+		}
 	}
 
 	if (enable_bitmaps)
@@ -1406,6 +1516,15 @@ bool Sys_AddToWindowList(System* the_system, Window* the_new_window)
 		List_AddItem(the_system->list_windows_, the_new_item);
 	}
 	
+	if (HitGrid_AddWindow(the_system->hit_grid_, the_new_window) == false)
+	{
+		LOG_ERR(("%s %d: could not add window to the hit grid", __func__ , __LINE__));
+		goto error;
+	}
+	
+	EventManager_Subscribe(the_new_window->event_mask_);
+	the_new_window->subscribed_ = true;
+	
 	new_display_order = SYS_MAX_WINDOWS;
 	Window_SetDisplayOrder(the_new_window, new_display_order);
 	
@@ -1702,52 +1821,19 @@ error:
 //! @param	y -- global vertical coordinate
 Window* Sys_GetWindowAtXY(System* the_system, int16_t x, int16_t y)
 {
- 	List*	the_item;
-
  	if (the_system == NULL)
  	{
 		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
 		goto error;
  	}
 	
-	if (the_system->window_count_ < 1)
-	{
-		DEBUG_OUT(("%s %d: system window count <1", __func__ , __LINE__));
-		return NULL;
-	}
-	
-	if (x < 0 || y < 0)
-	{
-		DEBUG_OUT(("%s %d: either x (%i) or y was negative (%i).", __func__ , __LINE__, x, y));
-		return NULL;
-	}
-	
 	// LOGIC:
 	//   OS/f windows are all known by the system
 	//   each window has a display order property set by the system, from low to high being backmost to frontmost
-	//   the system also keeps them sorted in its list, with first item being front most
-		
-	the_item = *(the_system->list_windows_);
-
-	while (the_item != NULL)
-	{
- 		bool		in_this_win;
-		Window*		this_window = (Window*)(the_item->payload_);
-		
-		in_this_win = General_PointInRect(x, y, this_window->global_rect_);
-		
-		DEBUG_OUT(("%s %d: in_this_win=%u, x/y=%i,%i, win rect=%i,%i", __func__ , __LINE__, in_this_win, x, y, this_window->global_rect_.MaxX, this_window->global_rect_.MaxY));
+	//   the hit grid knows which windows overlap each part of the screen, and picks the frontmost of those at x/y by display order
+	//   so only the few windows near the point are looked at, however many are open
 		
-		if (in_this_win)
-		{
-			DEBUG_OUT(("%s %d: window at %i, %i = '%s'", __func__, __LINE__, x, y, this_window->title_));
-			return this_window;
-		}
-
-		the_item = the_item->next_item_;
-	}
-	
-	return NULL;
+	return HitGrid_GetWindowAtXY(the_system->hit_grid_, x, y);
 	
 error:
 	Sys_Exit(&global_system, PARAM_EXIT_ON_ERROR);	// crash early, crash often
@@ -1755,6 +1841,22 @@ error:
 }
 
 
+//! Tell the system a window has moved or changed size, so Sys_GetWindowAtXY() finds it in its new place
+//! Changes of z-order don't need this: they are taken into account at each hit-test
+//! @param	the_system -- valid pointer to system object
+//! @param	the_window -- a window in the system's list of windows
+void Sys_UpdateWindowHitArea(System* the_system, Window* the_window)
+{
+ 	if (the_system == NULL || the_window == NULL)
+ 	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		return;
+ 	}
+	
+	HitGrid_UpdateWindow(the_system->hit_grid_, the_window);
+}
+
+
 //! Set the passed window to the active window, and marks the previously active window as inactive
 //! NOTE: This will resort the list of windows to move the (new) active one to the front
 //! NOTE: The exception to this is that the backdrop window is never moved in front of other windows
@@ -1796,8 +1898,8 @@ bool Sys_SetActiveWindow(System* the_system, Window* the_window)
 	// that changes their linked order, but doesn't renumber their display_order_; need that too
 	Sys_RenumberWindows(the_system);
 	
-	// temp
-	Sys_Render(global_system);
+	// render at the start of the next frame
+	Sys_RequestRender(global_system);
 	
 	return true;
 	
@@ -1875,14 +1977,14 @@ void Sys_CloseOneWindow(System* the_system, Window* the_window)
 	}
 	
 	// destroy the window, making sure to set a new active window
+	HitGrid_RemoveWindow(the_system->hit_grid_, the_window);
+	EventManager_Unsubscribe(the_window->event_mask_);
+	the_window->subscribed_ = false;
 	Window_Destroy(&the_window);
 	DEBUG_OUT(("%s %d: window destroyed", __func__ , __LINE__));
 	--the_system->window_count_;
 	List_RemoveItem(the_system->list_windows_, this_window_item);
-	LOG_ALLOC(("%s %d:	__FREE__	the_item	%p	size	%i", __func__ , __LINE__, this_window_item, sizeof(List)));
-	TRACK_ALLOC((0 - sizeof(List)));
-	free(this_window_item);
-	this_window_item = NULL;
+	List_DestroyItem(&this_window_item);
 	
 	if (need_different_active_window)
 	{
@@ -1899,8 +2001,8 @@ void Sys_CloseOneWindow(System* the_system, Window* the_window)
 		DEBUG_OUT(("%s %d: new active window='%s'", __func__ , __LINE__, the_system->active_window_->title_));		
 	}
 
-	// Re-render all windows
-	Sys_Render(global_system);		
+	// Re-render all windows at the start of the next frame
+	Sys_RequestRender(global_system);
 	
 	return;
 	
@@ -1910,13 +2012,56 @@ error:
 }
 
 
+//! Set how windows follow the mouse when the user drags them by the title bar
+//! @param	the_system -- valid pointer to system object
+//! @param	the_mode -- WIN_DRAG_OUTLINE to move only an outline until the mouse button is released (the window is moved and the screen repaired once), or WIN_DRAG_LIVE to move the window on every mouse move
+void Sys_SetWindowDragMode(System* the_system, window_drag_mode the_mode)
+{
+ 	if (the_system == NULL)
+ 	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		return;
+ 	}
+	
+	the_system->drag_mode_ = the_mode;
+}
+
+
+//! @param	the_system -- valid pointer to system object
+//! @return	Returns the current window drag mode (WIN_DRAG_OUTLINE or WIN_DRAG_LIVE)
+window_drag_mode Sys_GetWindowDragMode(System* the_system)
+{
+ 	if (the_system == NULL)
+ 	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		return WIN_DRAG_OUTLINE;
+ 	}
+	
+	return the_system->drag_mode_;
+}
+
+
+//! @param	the_system -- valid pointer to system object
+//! @return	Returns true if the sprite table has been set up, so Sprite_New() can hand out sprites
+bool Sys_HasSprites(System* the_system)
+{
+ 	if (the_system == NULL)
+ 	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		return false;
+ 	}
+	
+	return the_system->sprites_ready_;
+}
+
+
 //! Issue damage rects from the Active Window down to each other window in the system so that they can redraw portions of themselves
 //! Note: does not call for system re-render
 void Sys_IssueDamageRects(System* the_system)
 {
 	List*		the_item;
 	Window*		the_active_window;
-	int16_t		num_rects;
+	Region*		the_damage;
 	
 	if (the_system == NULL)
 	{
@@ -1936,10 +2081,12 @@ void Sys_IssueDamageRects(System* the_system)
 	//   Because this function does not actually re-render every window, the order they are processed here does not matter.
 	//   Windows are ordered in the window list, by Z order, from back (head) to front (tail)
 
+	//   The damage region's rects never overlap, so no window is asked to redraw the same area twice
+
 	the_active_window = Sys_GetActiveWindow(global_system);
-	num_rects = the_active_window->damage_count_;
+	the_damage = the_active_window->damage_region_;
 	
-	DEBUG_OUT(("%s %d: active window '%s' has %i damage rects", __func__ , __LINE__, the_active_window->title_, num_rects));
+	DEBUG_OUT(("%s %d: active window '%s' has %i damage rects", __func__ , __LINE__, the_active_window->title_, Region_GetRectCount(the_damage)));
 
 	the_item = *(the_system->list_windows_);
 
@@ -1947,15 +2094,15 @@ void Sys_IssueDamageRects(System* the_system)
 	{
 		Window*		this_window = (Window*)(the_item->payload_);
 		
-		//DEBUG_OUT(("%s %d: this_window '%s' has %i clip rects", __func__ , __LINE__, this_window->title_, this_window->clip_count_));
+		//DEBUG_OUT(("%s %d: this_window '%s' has %i clip rects", __func__ , __LINE__, this_window->title_, Region_GetRectCount(this_window->clip_region_)));
 
 		if (this_window != the_active_window)
 		{
 			int16_t		i;
 			
-			for (i = 0; i < num_rects; i++)
+			for (i = 0; i < the_damage->num_rects_; i++)
 			{
-				if (Window_AcceptDamageRect(this_window, &the_active_window->damage_rect_[i]) == false)
+				if (Window_AcceptDamageRect(this_window, &the_damage->rects_[i]) == false)
 				{
 				}
 			}			
@@ -1964,6 +2111,9 @@ void Sys_IssueDamageRects(System* the_system)
 		the_item = the_item->next_item_;
 	}
 	
+	// windows that accepted damage need to reblit it
+	Sys_RequestRender(the_system);
+	
 	return;
 	
 error:
@@ -2002,7 +2152,7 @@ void Sys_IssueMenuDamageRects(System* the_system)
 	{
 		Window*		this_window = (Window*)(the_item->payload_);
 		
-		//DEBUG_OUT(("%s %d: this_window '%s' has %i clip rects", __func__ , __LINE__, this_window->title_, this_window->clip_count_));
+		//DEBUG_OUT(("%s %d: this_window '%s' has %i clip rects", __func__ , __LINE__, this_window->title_, Region_GetRectCount(this_window->clip_region_)));
 		if (Window_AcceptDamageRect(this_window, &the_system->menu_manager_->global_rect_) == false)
 		{
 			LOG_ERR(("%s %d: Failed to apply menu damage rect to window '%s'", __func__ , __LINE__, this_window->title_));
@@ -2201,6 +2351,12 @@ Bitmap* Sys_GetScreenBitmap(System* the_system, bitmap_layer the_layer)
 		goto error;
 	}
 	
+	// when double-buffering, drawing goes to the hidden page, not the one on screen
+	if (the_layer == back_layer && the_system->page_flip_ != NULL)
+	{
+		return PageFlip_GetDrawPage(the_system->page_flip_);
+	}
+	
 	return the_system->screen_[ID_CHANNEL_B]->bitmap_[the_layer];
 	
 error:
@@ -2370,7 +2526,7 @@ bool Sys_SetTheme(System* the_system, Theme* the_theme)
 		Sys_UpdateWindowTheme(the_system);
 	
 		// force re-render
-		Sys_Render(the_system);
+		Sys_RequestRender(the_system);
 	}
 	
 	return true;
@@ -2453,6 +2609,7 @@ void Sys_Render(System* the_system)
 {
 	int16_t		num_nodes = 0;
 	List*		the_item;
+	long		wait_start;
 
  	if (the_system == NULL)
  	{
@@ -2461,10 +2618,34 @@ void Sys_Render(System* the_system)
  	}
 	
 	// LOGIC:
-	//   as we do not have regions and layers set up yet, we have to render every single window in its entirely, including the backdrop
-	//   therefore, it is critical that the rendering take place in the order of back to front
+	//   each window only blits its visible region: its global rect minus every visible window in front of it
+	//   so no screen pixel is written by more than one window, and the order windows are rendered in does not affect the result
 	//   display order is built into the system's window list: the first item is the foremost, and the last is the backmost
-	//   need to render from back of list towards front of list, so they built up over each other in right order.
+	//   we still render from back of list towards front of list, so that screen updates appear in a natural order
+	//   the pixel counts for the pass are totaled up so the savings from skipping covered areas can be measured
+	
+	the_system->render_pixels_blitted_ = 0;
+	the_system->render_pixels_hidden_ = 0;
+	
+	// double-buffering: the hidden page can't be drawn into until the last pass has been flipped on screen
+	//   the start of frame interrupt does the flip; Sys_FlushRender() normally only gets here in a later frame, so this rarely waits
+	//   if that interrupt has stopped since (masked, or a mode change), the flip would never come: after a few jiffies, do it here instead
+	if (the_system->page_flip_ != NULL)
+	{
+		wait_start = sys_time_jiffies();
+		
+		while (PageFlip_BeginFrame(the_system->page_flip_, Sys_GetFrameCount(the_system)) == false)
+		{
+			if (sys_time_jiffies() - wait_start >= SYS_FLIP_WAIT_MAX_JIFFIES)
+			{
+				LOG_WARN(("%s %d: start of frame interrupt did not flip pages; flipping now", __func__ , __LINE__));
+				Sys_FlipFromMainLoop(the_system);
+				continue;
+			}
+			
+			Sys_WaitForInterrupt(the_system);
+		}
+	}
 	
 	// have each window (re)render its controls/content/etc to its bitmap, and blit itself to the main screen/backdrop window bitmap
 	
@@ -2488,6 +2669,8 @@ void Sys_Render(System* the_system)
 		{
 			++num_nodes;
 			Window_Render(this_window);
+			the_system->render_pixels_blitted_ += this_window->pixels_blitted_;
+			the_system->render_pixels_hidden_ += this_window->pixels_hidden_;
 
 // 			// blit to screen
 // 			Bitmap_Blit(this_window->bitmap_, 0, 0, the_system->screen_[ID_CHANNEL_B]->bitmap_, this_window->x_, this_window->y_, this_window->width_, this_window->height_);
@@ -2497,6 +2680,21 @@ void Sys_Render(System* the_system)
 	}
 
 	//DEBUG_OUT(("%s %d: %i windows rendered out of %i total window", __func__ , __LINE__, num_nodes, the_system->window_count_));
+	//DEBUG_OUT(("%s %d: %lu pixels blitted, %lu hidden pixels skipped", __func__ , __LINE__, the_system->render_pixels_blitted_, the_system->render_pixels_hidden_));
+	
+	// double-buffering: show what was just composed at the next start of frame
+	//   with no start of frame interrupt (emulator/host builds), nothing would ever flip: do it now instead
+	if (the_system->page_flip_ != NULL)
+	{
+		if (PageFlip_QueueFlip(the_system->page_flip_) == true && the_system->frame_count_ == 0)
+		{
+			Sys_FlipFromMainLoop(the_system);
+		}
+	}
+	
+	// whatever was requested has now been rendered, whether this pass was scheduled or called directly
+	//   (controls that windows invalidate while redrawing themselves are drawn in the same pass, so don't need another)
+	the_system->render_pending_ = false;
 	
 	return;
 	
@@ -2505,3 +2703,366 @@ error:
 	return;
 }
 
+
+//! Calculate the part of a window that is not covered by any visible window in front of it, and store it in the window's visible_region_ (in window-local coordinates)
+//! @param	the_system -- valid pointer to system object
+//! @param	the_window -- reference to a valid Window object that is in the system's window list
+//! @return	Returns false on any error condition
+bool Sys_CalculateVisibleRegion(System* the_system, Window* the_window)
+{
+	List*		the_item;
+	Region*		the_visible;
+
+ 	if (the_system == NULL)
+ 	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		goto error;
+ 	}
+
+	if (the_window == NULL)
+	{
+		LOG_ERR(("%s %d: passed window was null", __func__ , __LINE__));
+		goto error;
+	}
+	
+	// LOGIC:
+	//   start with the whole window, then walk the window list from the front until we reach this window,
+	//   subtracting the global rect of each visible window we pass. 
+	//   this is recalculated every time it is needed, so it can never be stale after a window moves, resizes, or changes order
+	
+	the_visible = the_window->visible_region_;
+	
+	if (Region_SetRect(the_visible, &the_window->global_rect_) == false)
+	{
+		return false;
+	}
+	
+	the_item = *(the_system->list_windows_);
+
+	while (the_item != NULL && Region_IsEmpty(the_visible) == false)
+	{
+		Window*		this_window = (Window*)(the_item->payload_);
+		
+		if (this_window == the_window)
+		{
+			break;
+		}
+		
+		if (Window_IsVisible(this_window) == true)
+		{
+			if (Region_SubtractRect(the_visible, &this_window->global_rect_) == false)
+			{
+				return false;
+			}
+		}
+
+		the_item = the_item->next_item_;
+	}
+	
+	Region_Offset(the_visible, -the_window->x_, -the_window->y_);
+	
+	return true;
+	
+error:
+	Sys_Exit(&global_system, PARAM_EXIT_ON_ERROR);	// crash early, crash often
+	return false;
+}
+
+
+//! Ask for all windows to be rendered at the start of the next frame
+//! Any number of requests made during one frame are served by a single Sys_Render() pass, when Sys_FlushRender() is next called
+//! @param	the_system -- valid pointer to system object
+void Sys_RequestRender(System* the_system)
+{
+ 	if (the_system == NULL)
+ 	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		return;
+ 	}
+	
+	the_system->render_pending_ = true;
+}
+
+
+//! Do one Sys_Render() pass if a render has been requested and a new frame has started since the last one
+//! The event loop calls this after each event, so bursts of events cause at most one render per frame
+//! @param	the_system -- valid pointer to system object
+//! @param	wait_for_frame -- if PARAM_WAIT_FOR_NEXT_FRAME, and a render is pending but this frame has already been rendered, wait for the next frame to start, then render. If PARAM_DO_NOT_WAIT_FOR_FRAME, return without rendering (the request stays pending).
+//! @return	Returns true if a render pass was done
+bool Sys_FlushRender(System* the_system, bool wait_for_frame)
+{
+	uint32_t	this_frame;
+	
+ 	if (the_system == NULL)
+ 	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		goto error;
+ 	}
+	
+	if (the_system->render_pending_ == false)
+	{
+		return false;
+	}
+	
+	this_frame = Sys_GetFrameCount(the_system);
+	
+	if (this_frame == the_system->last_render_frame_)
+	{
+		if (wait_for_frame == PARAM_DO_NOT_WAIT_FOR_FRAME)
+		{
+			return false;
+		}
+		
+		while ((this_frame = Sys_GetFrameCount(the_system)) == the_system->last_render_frame_)
+		{
+			Sys_WaitForInterrupt(the_system);
+		}
+	}
+	
+	the_system->last_render_frame_ = this_frame;
+	Sys_Render(the_system);
+	
+	return true;
+	
+error:
+	Sys_Exit(&global_system, PARAM_EXIT_ON_ERROR);	// crash early, crash often
+	return false;
+}
+
+
+//! Get the current frame number
+//! Uses the count from the VICKY start of frame interrupt if it is running, otherwise jiffies (60 per second) as a simulated frame tick
+//! @param	the_system -- valid pointer to system object
+//! @return	Returns the current frame number. Only useful for comparing against other frame numbers.
+uint32_t Sys_GetFrameCount(System* the_system)
+{
+ 	if (the_system == NULL)
+ 	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		return 0;
+ 	}
+	
+	if (the_system->frame_count_ == 0)
+	{
+		return (uint32_t)sys_time_jiffies();
+	}
+	
+	return the_system->frame_count_;
+}
+
+
+//! Wait for the next interrupt, for code that has nothing to do until one changes something
+//! Built with SYS_IDLE_WITH_STOP, the CPU is stopped until any interrupt. Otherwise it waits for the start of frame interrupt by reading the frame count, without calling the MCP.
+//! If the start of frame interrupt is not running (emulator), it waits for the next jiffy instead. Callers must check for themselves whatever they are waiting for.
+//! @param	the_system -- valid pointer to system object
+void Sys_WaitForInterrupt(System* the_system)
+{
+	uint32_t	this_frame;
+	long		start_jiffies;
+	uint16_t	spins;
+	
+ 	if (the_system == NULL)
+ 	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		return;
+ 	}
+	
+	// LOGIC:
+	//   with STOP, any interrupt wakes the CPU: the jiffy timer, start of frame, mouse, or keyboard. each caller checks whether what it waits for has happened.
+	//   without it, the frame counter is read in a loop: a read of one word in RAM, instead of an MCP call each time round as with sys_time_jiffies().
+	//   the frame counter is only ever set by the start of frame interrupt. if it is still 0, that interrupt isn't running: wait for the jiffy count
+	//     to change instead, so callers that loop on this don't spin through their checks many times a jiffy.
+	//   if the interrupt stops after it has started (masked, or a mode change), the count would never change: every so often, check whether
+	//     a jiffy has gone by instead, so the wait never lasts much longer than one.
+	
+	#if defined(SYS_IDLE_WITH_STOP)
+		CPU_WAIT_FOR_INTERRUPT();
+	#else
+		start_jiffies = sys_time_jiffies();
+		
+		if ( (this_frame = the_system->frame_count_) == 0)
+		{
+			while (sys_time_jiffies() == start_jiffies)
+			{
+			}
+			
+			return;
+		}
+		
+		spins = 0;
+		
+		while (the_system->frame_count_ == this_frame)
+		{
+			if (++spins == SYS_WAIT_SPINS_PER_CHECK)
+			{
+				if (sys_time_jiffies() != start_jiffies)
+				{
+					return;
+				}
+				
+				spins = 0;
+			}
+		}
+	#endif
+}
+
+
+//! Get the pixel counts from the most recent Sys_Render() pass
+//! @param	the_system -- valid pointer to system object
+//! @param	pixels_blitted -- pointer to a variable that will receive the number of pixels written to the screen. Can be NULL.
+//! @param	pixels_hidden -- pointer to a variable that will receive the number of pixels that were not written because a window in front covered them. Can be NULL.
+void Sys_GetRenderStats(System* the_system, uint32_t* pixels_blitted, uint32_t* pixels_hidden)
+{
+ 	if (the_system == NULL)
+ 	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		return;
+ 	}
+	
+	if (pixels_blitted != NULL)
+	{
+		*pixels_blitted = the_system->render_pixels_blitted_;
+	}
+	
+	if (pixels_hidden != NULL)
+	{
+		*pixels_hidden = the_system->render_pixels_hidden_;
+	}
+}
+
+
+//! Turn double-buffering of the back bitmap layer on or off
+//! While on, Sys_Render() composes into a hidden page in VRAM, and the layer is flipped to it at the next start of frame, so partly drawn frames are never shown.
+//! Sys_GetScreenBitmap(back_layer) returns the hidden page. Anything drawn into it must be reported with Sys_AddScreenDamage().
+//! @param	the_system -- valid pointer to system object
+//! @param	enable_it -- true to turn double-buffering on, false to turn it off
+//! @return	Returns false if double-buffering could not be turned on (eg, no room in the VRAM heap for a second page)
+bool Sys_SetDoubleBuffer(System* the_system, bool enable_it)
+{
+	PageFlip*	the_flip;
+	Bitmap*		the_layer_bitmap;
+	Bitmap*		the_latest_page;
+	Bitmap*		the_spare_page;
+	uint32_t	the_addr_reg;
+	
+ 	if (the_system == NULL)
+ 	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		goto error;
+ 	}
+	
+	if (enable_it == (the_system->page_flip_ != NULL))
+	{
+		return true;
+	}
+	
+	the_layer_bitmap = the_system->screen_[ID_CHANNEL_B]->bitmap_[back_layer];
+	the_addr_reg = (uint32_t)(the_system->screen_[ID_CHANNEL_B]->vicky_ + BITMAP_L0_VRAM_ADDR_OFFSET_L);
+	
+	if (enable_it == false)
+	{
+		// LOGIC:
+		//   take the page flip away from the interrupt first, so it can't flip while the layer is being put back.
+		//   the hidden page (brought up to date) has everything drawn so far, flipped or not: it becomes the layer's own bitmap's contents
+		
+		the_flip = the_system->page_flip_;
+		the_system->page_flip_ = NULL;
+		
+		the_latest_page = PageFlip_GetDrawPage(the_flip);
+		the_spare_page = the_flip->page_[1];
+		
+		if (the_latest_page != the_layer_bitmap)
+		{
+			Bitmap_Blit(the_latest_page, 0, 0, the_layer_bitmap, 0, 0, the_layer_bitmap->width_, the_layer_bitmap->height_);
+		}
+		
+		R32(the_addr_reg) = the_layer_bitmap->addr_int_ - (uint32_t)VRAM_START;
+		
+		PageFlip_Destroy(&the_flip);
+		Bitmap_Destroy(&the_spare_page);
+		
+		return true;
+	}
+	
+	// LOGIC:
+	//   the spare page comes from the VRAM heap: the VICKY can only show VRAM, so if the heap is full, there is no double-buffering.
+	//   the heap can move the page when it compacts; PageFlip re-points the layer if that happens to the page on screen.
+	
+	if ( (the_spare_page = Bitmap_New(the_layer_bitmap->width_, the_layer_bitmap->height_, Sys_GetSystemFont(the_system), PARAM_PREFER_VRAM)) == NULL)
+	{
+		LOG_ERR(("%s %d: could not allocate a spare page", __func__ , __LINE__));
+		goto error;
+	}
+	
+	if (the_spare_page->in_vram_ == false)
+	{
+		LOG_WARN(("%s %d: no room in VRAM for a spare page; double-buffering stays off", __func__ , __LINE__));
+		Bitmap_Destroy(&the_spare_page);
+		return false;
+	}
+	
+	if ( (the_flip = PageFlip_New(the_layer_bitmap, the_spare_page, the_addr_reg)) == NULL)
+	{
+		LOG_ERR(("%s %d: could not set up page flipping", __func__ , __LINE__));
+		Bitmap_Destroy(&the_spare_page);
+		goto error;
+	}
+	
+	the_system->page_flip_ = the_flip;
+	
+	return true;
+	
+error:
+	Sys_Exit(&global_system, PARAM_EXIT_ON_ERROR);	// crash early, crash often
+	return false;
+}
+
+
+//! Report that part of the back layer bitmap has been drawn into. Does nothing unless double-buffering is on.
+//! Damage reported outside of Sys_Render() asks for a render, so that it gets flipped onto the screen.
+//! @param	the_system -- valid pointer to system object
+//! @param	the_rect -- the rect that was drawn into, in global coordinates
+void Sys_AddScreenDamage(System* the_system, Rectangle* the_rect)
+{
+ 	if (the_system == NULL)
+ 	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		return;
+ 	}
+	
+	if (the_system->page_flip_ == NULL)
+	{
+		return;
+	}
+	
+	PageFlip_AddDamage(the_system->page_flip_, the_rect);
+	
+	// LOGIC:
+	//   only a render pass queues a flip. inside a pass, this is cleared again when the pass ends, and the pass queues the flip itself.
+	the_system->render_pending_ = true;
+}
+
+
+//! Get the timing stats for double-buffered rendering
+//! @param	the_system -- valid pointer to system object
+//! @param	frame_time -- receives the number of frames from the start of the last flipped render to the flip (0 = it was on screen the frame it started). Can be NULL.
+//! @param	pixels_replayed -- receives the number of pixels copied to bring the hidden page up to date after the last flip. Can be NULL.
+//! @return	Returns false if double-buffering is off
+bool Sys_GetFlipStats(System* the_system, uint32_t* frame_time, uint32_t* pixels_replayed)
+{
+ 	if (the_system == NULL)
+ 	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		return false;
+ 	}
+	
+	if (the_system->page_flip_ == NULL)
+	{
+		return false;
+	}
+	
+	PageFlip_GetStats(the_system->page_flip_, frame_time, pixels_replayed, NULL);
+	
+	return true;
+}
+
@@ -77,6 +77,14 @@
 #define PARAM_EXIT_ON_ERROR		true	// parameter for Sys_Exit
 #define PARAM_EXIT_NO_ERROR		false	// parameter for Sys_Exit
 
+#define PARAM_WAIT_FOR_NEXT_FRAME	true	// parameter for Sys_FlushRender
+#define PARAM_DO_NOT_WAIT_FOR_FRAME	false	// parameter for Sys_FlushRender
+
+#define SYS_INT_VICKY_B_SOF		0x08	// MCP interrupt number for VICKY channel B start of frame
+
+#define SYS_FLIP_WAIT_MAX_JIFFIES	3		// double-buffering: if a queued flip hasn't been done by the start of frame interrupt after this many jiffies, Sys_Render() does it itself
+#define SYS_WAIT_SPINS_PER_CHECK	256		// Sys_WaitForInterrupt(): frame count reads between checks of the jiffy count, in case the start of frame interrupt has stopped
+
 /*****************************************************************************/
 /*                               Enumerations                                */
 /*****************************************************************************/
@@ -101,6 +109,15 @@ struct System
 	uint16_t		model_number_;
 	Menu*			menu_manager_;
 	char*			text_temp_buffer_;	// general use temp buffer big enough for full screen word wrap; do NOT use for real storage. Any utility function clobber it
+	uint32_t		render_pixels_blitted_;	// number of pixels written to the screen during the last Sys_Render() pass
+	uint32_t		render_pixels_hidden_;	// number of pixels the last Sys_Render() pass did not write because they were covered by a window further forward (overdraw avoided)
+	volatile uint32_t	frame_count_;		// incremented by the start of frame interrupt. Stays 0 if that interrupt never fires (emulator/host builds), in which case jiffies are used as a simulated frame tick.
+	uint32_t		last_render_frame_;	// value of the frame counter when Sys_FlushRender() last rendered
+	bool			render_pending_;	// true if something has asked for a render since the last one. Cleared when Sys_Render() runs.
+	window_drag_mode	drag_mode_;		// whether window drags move an outline (default) or the window itself
+	PageFlip*		page_flip_;			// NULL unless double-buffering is on. Its spare page (page_[1]) is owned by the system.
+	HitGrid*		hit_grid_;			// screen grid of which windows are where, for finding the window under the mouse without walking the window list
+	bool			sprites_ready_;		// true once the sprite table has been set up: the first time Sys_SetGraphicMode() turns sprites on, on a machine that has them
 };
 
 
@@ -147,6 +164,8 @@ bool Sys_InitSystem(System* the_system);
 
 // **** Event-handling functions *****
 
+//! Interrupt handler for VICKY start of frame: advances the system frame counter, and flips pages if double-buffering. Does no drawing.
+void Sys_InterruptStartOfFrame(void);
 
 
 
@@ -165,6 +184,7 @@ bool Sys_SetVideoMode(Screen* the_screen, screen_resolution new_mode);
 bool Sys_SetModeText(System* the_system, bool as_overlay);
 
 //! Switch machine into graphics mode, text mode, sprite mode, etc.
+//! The first time sprites are turned on, on a machine whose channel B has sprites (A2560K, X, GenX), the sprite table is set up, so Sprite_New() can be used.
 //! @param	the_system -- valid pointer to system object
 //! Use PARAM_SPRITES_ON/OFF, PARAM_BITMAP_ON/OFF, PARAM_TILES_ON/OFF, PARAM_TEXT_OVERLAY_ON/OFF, PARAM_TEXT_ON/OFF
 bool Sys_SetGraphicMode(System* the_system, bool enable_sprites, bool enable_bitmaps, bool enable_tiles, bool enable_text_overlay, bool enable_text);
@@ -214,11 +234,18 @@ Window* Sys_GetNextWindow(System* the_system);
 Window* Sys_GetPreviousWindow(System* the_system);
 
 // Find the Window under the mouse -- accounts for z depth (topmost window will be found)
+// Looks only at the windows in one cell of the system's hit grid, so the cost doesn't grow with the number of windows open
 //! @param	the_system -- valid pointer to system object
 //! @param	x -- global horizontal coordinate
 //! @param	y -- global vertical coordinate
 Window* Sys_GetWindowAtXY(System* the_system, int16_t x, int16_t y);
 
+//! Tell the system a window has moved or changed size, so Sys_GetWindowAtXY() finds it in its new place
+//! Changes of z-order don't need this: they are taken into account at each hit-test
+//! @param	the_system -- valid pointer to system object
+//! @param	the_window -- a window in the system's list of windows
+void Sys_UpdateWindowHitArea(System* the_system, Window* the_window);
+
 //! Set the passed window to the active window, and marks the previously active window as inactive
 //! NOTE: This will resort the list of windows to move the (new) active one to the front
 //! NOTE: The exception to this is that the backdrop window is never moved in front of other windows
@@ -231,6 +258,19 @@ bool Window_CompareDisplayOrder(void* first_payload, void* second_payload);
 // remove one window from system's list of windows, and close it
 void Sys_CloseOneWindow(System* the_system, Window* the_window);
 
+//! Set how windows follow the mouse when the user drags them by the title bar
+//! @param	the_system -- valid pointer to system object
+//! @param	the_mode -- WIN_DRAG_OUTLINE to move only an outline until the mouse button is released (the window is moved and the screen repaired once), or WIN_DRAG_LIVE to move the window on every mouse move
+void Sys_SetWindowDragMode(System* the_system, window_drag_mode the_mode);
+
+//! @param	the_system -- valid pointer to system object
+//! @return	Returns the current window drag mode (WIN_DRAG_OUTLINE or WIN_DRAG_LIVE)
+window_drag_mode Sys_GetWindowDragMode(System* the_system);
+
+//! @param	the_system -- valid pointer to system object
+//! @return	Returns true if the sprite table has been set up, so Sprite_New() can hand out sprites
+bool Sys_HasSprites(System* the_system);
+
 //! Issue damage rects from the Active Window down to each other window in the system so that they can redraw portions of themselves
 //! Note: does not call for system re-render
 void Sys_IssueDamageRects(System* the_system);
@@ -368,9 +408,67 @@ Font* Sys_LoadAppFont(void);
 
 //! Render all visible windows
 //! NOTE: this will move to a private Sys function later, once event handling is available
+//! Each window only blits the parts of itself not covered by windows in front of it, so every screen pixel is written at most once per pass
 //! @param	the_system -- valid pointer to system object
 void Sys_Render(System* the_system);
 
+//! Calculate the part of a window that is not covered by any visible window in front of it, and store it in the window's visible_region_ (in window-local coordinates)
+//! @param	the_system -- valid pointer to system object
+//! @param	the_window -- reference to a valid Window object that is in the system's window list
+//! @return	Returns false on any error condition
+bool Sys_CalculateVisibleRegion(System* the_system, Window* the_window);
+
+//! Ask for all windows to be rendered at the start of the next frame
+//! Any number of requests made during one frame are served by a single Sys_Render() pass, when Sys_FlushRender() is next called
+//! @param	the_system -- valid pointer to system object
+void Sys_RequestRender(System* the_system);
+
+//! Do one Sys_Render() pass if a render has been requested and a new frame has started since the last one
+//! The event loop calls this after each event, so bursts of events cause at most one render per frame
+//! @param	the_system -- valid pointer to system object
+//! @param	wait_for_frame -- if PARAM_WAIT_FOR_NEXT_FRAME, and a render is pending but this frame has already been rendered, wait for the next frame to start, then render. If PARAM_DO_NOT_WAIT_FOR_FRAME, return without rendering (the request stays pending).
+//! @return	Returns true if a render pass was done
+bool Sys_FlushRender(System* the_system, bool wait_for_frame);
+
+//! Get the current frame number
+//! Uses the count from the VICKY start of frame interrupt if it is running, otherwise jiffies (60 per second) as a simulated frame tick
+//! @param	the_system -- valid pointer to system object
+//! @return	Returns the current frame number. Only useful for comparing against other frame numbers.
+uint32_t Sys_GetFrameCount(System* the_system);
+
+//! Wait for the next interrupt, for code that has nothing to do until one changes something
+//! Built with SYS_IDLE_WITH_STOP, the CPU is stopped until any interrupt. Otherwise it waits for the start of frame interrupt by reading the frame count, without calling the MCP.
+//! If the start of frame interrupt is not running (emulator), it waits for the next jiffy instead. Callers must check for themselves whatever they are waiting for.
+//! @param	the_system -- valid pointer to system object
+void Sys_WaitForInterrupt(System* the_system);
+
+//! Get the pixel counts from the most recent Sys_Render() pass
+//! @param	the_system -- valid pointer to system object
+//! @param	pixels_blitted -- pointer to a variable that will receive the number of pixels written to the screen. Can be NULL.
+//! @param	pixels_hidden -- pointer to a variable that will receive the number of pixels that were not written because a window in front covered them. Without occlusion culling, these pixels would have been overdrawn. Can be NULL.
+void Sys_GetRenderStats(System* the_system, uint32_t* pixels_blitted, uint32_t* pixels_hidden);
+
+//! Turn double-buffering of the back bitmap layer on or off
+//! While on, Sys_Render() composes into a hidden page in VRAM, and the layer is flipped to it at the next start of frame, so partly drawn frames are never shown.
+//! Sys_GetScreenBitmap(back_layer) returns the hidden page. Anything drawn into it must be reported with Sys_AddScreenDamage().
+//! @param	the_system -- valid pointer to system object
+//! @param	enable_it -- true to turn double-buffering on, false to turn it off
+//! @return	Returns false if double-buffering could not be turned on (eg, no room in the VRAM heap for a second page)
+bool Sys_SetDoubleBuffer(System* the_system, bool enable_it);
+
+//! Report that part of the back layer bitmap has been drawn into. Does nothing unless double-buffering is on.
+//! Damage reported outside of Sys_Render() asks for a render, so that it gets flipped onto the screen.
+//! @param	the_system -- valid pointer to system object
+//! @param	the_rect -- the rect that was drawn into, in global coordinates
+void Sys_AddScreenDamage(System* the_system, Rectangle* the_rect);
+
+//! Get the timing stats for double-buffered rendering
+//! @param	the_system -- valid pointer to system object
+//! @param	frame_time -- receives the number of frames from the start of the last flipped render to the flip (0 = it was on screen the frame it started). Can be NULL.
+//! @param	pixels_replayed -- receives the number of pixels copied to bring the hidden page up to date after the last flip. Can be NULL.
+//! @return	Returns false if double-buffering is off
+bool Sys_GetFlipStats(System* the_system, uint32_t* frame_time, uint32_t* pixels_replayed);
+
 
 
 // **** Debug functions *****
@@ -18,6 +18,7 @@
 #include "debug.h"
 #include "general.h"
 #include "menu.h"
+#include "pool.h"
 #include "sys.h"
 
 // C includes
@@ -1496,6 +1497,9 @@ int main(int argc, char* argv[])
 
 	DEBUG_OUT(("%s %d: System object created ok. Initiating system components...", __func__, __LINE__));
 	
+	// the demo opens and closes many large windows: carve their bitmaps from an arena, so the heap doesn't fragment
+	Pool_InitArena(POOL_ARENA_DEFAULT_SIZE);
+	
 	if (Sys_InitSystem(global_system) == false)
 	{
 		DEBUG_OUT(("%s %d: Couldn't initialize the system", __func__, __LINE__));
@@ -1509,7 +1513,7 @@ int main(int argc, char* argv[])
 	
 	Sys_EnableTextModeCursor(global_system, the_screen, false);
 	
-	Sys_SetGraphicMode(global_system, PARAM_SPRITES_OFF, PARAM_BITMAP_ON, PARAM_TILES_OFF, PARAM_TEXT_OVERLAY_ON, PARAM_TEXT_ON);
+	Sys_SetGraphicMode(global_system, PARAM_SPRITES_ON, PARAM_BITMAP_ON, PARAM_TILES_OFF, PARAM_TEXT_OVERLAY_ON, PARAM_TEXT_ON);
 
  	RunDemo();
 	
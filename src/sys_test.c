@@ -23,9 +23,12 @@
 // project includes
 #include "debug.h"
 #include "startup.h"
+#include "window.h"
 
 // C includes
 #include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
 
 // A2560 includes
 #include "a2560k.h"
@@ -37,6 +40,12 @@
 /*                               Definitions                                 */
 /*****************************************************************************/
 
+#define OVERDRAW_TEST_MAX_WINDOWS		20	// most windows stacked up for the overdraw test
+#define OVERDRAW_TEST_WIN_WIDTH			240
+#define OVERDRAW_TEST_WIN_HEIGHT		180
+#define OVERDRAW_TEST_WIN_OFFSET		12	// each window is placed this many pixels right and down from the one behind it
+#define OVERDRAW_SPEED_TEST_PASSES		10
+
 
 
 /*****************************************************************************/
@@ -64,6 +73,18 @@ bool Test_OpenSerial(void);
 // test ps/2 mouse
 void Test_MCPMouse(void);
 
+// event handler for test windows. does nothing.
+void Test_WindowEventHandler(EventRecord* the_event);
+
+// open the specified number of windows, each offset a little from the one behind it, so they stack up
+bool Test_OpenStackedWindows(Window** the_windows, int16_t num_windows);
+
+// close all windows opened by Test_OpenStackedWindows
+void Test_CloseStackedWindows(Window** the_windows, int16_t num_windows);
+
+// invalidate every window, render, and return the sum of the pixel areas of all visible windows
+uint32_t Test_RenderAllInvalidated(void);
+
 /*****************************************************************************/
 /*                       Private Function Definitions                        */
 /*****************************************************************************/
@@ -176,6 +197,89 @@ void Test_MCPMouse(void)
 
 
 
+// event handler for test windows. does nothing.
+void Test_WindowEventHandler(EventRecord* the_event)
+{
+}
+
+
+// open the specified number of windows, each offset a little from the one behind it, so they stack up
+bool Test_OpenStackedWindows(Window** the_windows, int16_t num_windows)
+{
+	NewWinTemplate*		the_win_template;
+	static char*		the_win_title = "Stacked Window";
+	int16_t				i;
+	
+	if ( (the_win_template = Window_GetNewWinTemplate(the_win_title)) == NULL)
+	{
+		LOG_ERR(("%s %d: Could not get a new window template", __func__ , __LINE__));
+		return false;
+	}	
+	
+	the_win_template->width_ = OVERDRAW_TEST_WIN_WIDTH;
+	the_win_template->height_ = OVERDRAW_TEST_WIN_HEIGHT;
+	
+	for (i = 0; i < num_windows; i++)
+	{
+		the_win_template->x_ = i * OVERDRAW_TEST_WIN_OFFSET;
+		the_win_template->y_ = i * OVERDRAW_TEST_WIN_OFFSET;
+
+		if ( (the_windows[i] = Window_New(the_win_template, &Test_WindowEventHandler)) == NULL)
+		{
+			LOG_ERR(("%s %d: Couldn't instantiate a window", __func__, __LINE__));
+			free(the_win_template);
+			return false;
+		}
+
+		Window_SetVisible(the_windows[i], true);
+	}
+	
+	free(the_win_template);
+	
+	return true;
+}
+
+
+// close all windows opened by Test_OpenStackedWindows
+void Test_CloseStackedWindows(Window** the_windows, int16_t num_windows)
+{
+	int16_t		i;
+	
+	for (i = num_windows - 1; i >= 0; i--)
+	{
+		Sys_CloseOneWindow(global_system, the_windows[i]);
+		the_windows[i] = NULL;
+	}
+}
+
+
+// invalidate every window, render, and return the sum of the pixel areas of all visible windows
+uint32_t Test_RenderAllInvalidated(void)
+{
+	List*		the_item;
+	uint32_t	total_area = 0;
+	
+	the_item = *(global_system->list_windows_);
+
+	while (the_item != NULL)
+	{
+		Window*		this_window = (Window*)(the_item->payload_);
+		
+		if (Window_IsVisible(this_window) == true)
+		{
+			Window_Invalidate(this_window);
+			total_area += (uint32_t)this_window->width_ * (uint32_t)this_window->height_;
+		}
+
+		the_item = the_item->next_item_;
+	}
+	
+	Sys_Render(global_system);
+	
+	return total_area;
+}
+
+
 /*****************************************************************************/
 /*                        MinUnit Function Defintions                        */
 /*****************************************************************************/
@@ -197,36 +301,104 @@ void test_teardown(void)	// this is called EVERY test
 
 
 
-// **** speed tests
-
-MU_TEST(test_speed_1)
+// check that a full render never writes a screen pixel twice, with 5, 10, 15, and 20 windows stacked up
+MU_TEST(render_overdraw_test)
 {
-	long start1;
-	long end1;
-	long start2;
-	long end2;
+	Window*		the_windows[OVERDRAW_TEST_MAX_WINDOWS];
+	Bitmap*		the_screen_bitmap;
+	uint32_t	screen_area;
+	uint32_t	total_area;
+	uint32_t	pixels_blitted;
+	uint32_t	pixels_hidden;
+	int16_t		num_windows;
 	
-	// test speed of first variant
-	start1 = mu_timer_real();
+	the_screen_bitmap = Sys_GetScreenBitmap(global_system, back_layer);
+	screen_area = (uint32_t)the_screen_bitmap->width_ * (uint32_t)the_screen_bitmap->height_;
 	
+	for (num_windows = 5; num_windows <= OVERDRAW_TEST_MAX_WINDOWS; num_windows += 5)
+	{
+		mu_check( Test_OpenStackedWindows(the_windows, num_windows) );
+		
+		total_area = Test_RenderAllInvalidated();
+		Sys_GetRenderStats(global_system, &pixels_blitted, &pixels_hidden);
+		
+		printf("%i windows: %lu pixels blitted, %lu overdrawn pixels skipped (%lu%% of %lu) \n", num_windows, pixels_blitted, pixels_hidden, (pixels_hidden * 100) / total_area, total_area);
+		
+		// every window pixel is either blitted or skipped, never both
+		mu_assert_int_eq(total_area, pixels_blitted + pixels_hidden);
+		
+		// every window is on-screen and the backdrop covers the screen, so each screen pixel gets written exactly once
+		mu_assert_int_eq(screen_area, pixels_blitted);
+		
+		Test_CloseStackedWindows(the_windows, num_windows);
+	}
+}
 
 
-	// speed test 1 goes here
+// check that many render requests in one frame are served by one render pass, and that a frame is never rendered twice
+MU_TEST(render_scheduler_test)
+{
+	int16_t		i;
+	uint32_t	rendered_frame;
 	
+	// flush anything left over from setup
+	Sys_FlushRender(global_system, PARAM_WAIT_FOR_NEXT_FRAME);
 	
-	end1 = mu_timer_real();
+	// nothing pending: nothing to do
+	mu_check( Sys_FlushRender(global_system, PARAM_WAIT_FOR_NEXT_FRAME) == false );
+	
+	// a burst of requests is coalesced into one pass
+	for (i = 0; i < 10; i++)
+	{
+		Sys_RequestRender(global_system);
+	}
+	
+	mu_check( Sys_FlushRender(global_system, PARAM_WAIT_FOR_NEXT_FRAME) == true );
+	mu_check( Sys_FlushRender(global_system, PARAM_WAIT_FOR_NEXT_FRAME) == false );
+	rendered_frame = global_system->last_render_frame_;
 	
-	// test speed of 2nd variant
-	start2 = mu_timer_real();
+	// a new request in the frame that was just rendered stays pending until the next frame
+	Sys_RequestRender(global_system);
 	
+	if (Sys_GetFrameCount(global_system) == rendered_frame)
+	{
+		mu_check( Sys_FlushRender(global_system, PARAM_DO_NOT_WAIT_FOR_FRAME) == false );
+		mu_check( global_system->render_pending_ == true );
+	}
+	
+	mu_check( Sys_FlushRender(global_system, PARAM_WAIT_FOR_NEXT_FRAME) == true );
+	mu_check( global_system->last_render_frame_ != rendered_frame );
+}
 
 
-	// speed test 2 goes here
+// **** speed tests
+
+MU_TEST(test_speed_1)
+{
+	Window*		the_windows[OVERDRAW_TEST_MAX_WINDOWS];
+	uint32_t	total_area = 0;
+	uint32_t	pixels_blitted;
+	int16_t		i;
+	long start1;
+	long end1;
+	
+	mu_check( Test_OpenStackedWindows(the_windows, OVERDRAW_TEST_MAX_WINDOWS) );
+	
+	// full re-render of a deep window stack: only visible areas are blitted
+	start1 = mu_timer_real();
+	
+	for (i = 0; i < OVERDRAW_SPEED_TEST_PASSES; i++)
+	{
+		total_area = Test_RenderAllInvalidated();
+	}
+	
+	end1 = mu_timer_real();
 	
+	Sys_GetRenderStats(global_system, &pixels_blitted, NULL);
 	
-	end2 = mu_timer_real();
+	printf("\nSpeed results: %i full renders of %i stacked windows completed in %li ticks; %lu of %lu window pixels blitted per pass\n", OVERDRAW_SPEED_TEST_PASSES, OVERDRAW_TEST_MAX_WINDOWS, end1 - start1, pixels_blitted, total_area);
 	
-	printf("\nSpeed results: first routine completed in %li ticks; second in %li ticks\n", end1 - start1, end2 - start2);
+	Test_CloseStackedWindows(the_windows, OVERDRAW_TEST_MAX_WINDOWS);
 }
 
 
@@ -245,6 +417,8 @@ MU_TEST_SUITE(test_suite_units)
 {	
 	MU_SUITE_CONFIGURE(&test_setup, &test_teardown);
 	
+	MU_RUN_TEST(render_overdraw_test);
+	MU_RUN_TEST(render_scheduler_test);
 // 	MU_RUN_TEST(string_manipulation_test);
 // 	MU_RUN_TEST(misc_test);
 // 	MU_RUN_TEST(number_string_test);
@@ -301,7 +475,7 @@ int main(int argc, char* argv[])
 	Sys_SetGraphicMode(global_system, PARAM_SPRITES_ON, PARAM_BITMAP_ON, PARAM_TILES_OFF, PARAM_TEXT_OVERLAY_ON, PARAM_TEXT_ON);
 	
 	MU_RUN_SUITE(test_suite_units);
-// 	MU_RUN_SUITE(test_suite_speed);
+	MU_RUN_SUITE(test_suite_speed);
 	MU_REPORT();
 
 	//Sys_SetModeText(global_system, false);
@@ -2786,6 +2786,13 @@ ControlTemplate* Theme_CreateDefaultControlTemplateMaximize(void);
 //! Generate a control template for a flexible-width text button control
 ControlTemplate* Theme_CreateControlTemplateTextButton(int16_t width, int16_t height);
 
+//! Generate a control template for a window scroller, drawn with the theme's colors
+//! The template's image is one square the thickness of the scroller: the window stretches the control to fit, and the image is repeated along it
+//! @param	the_theme -- a theme with its colors already set
+//! @param	the_type -- H_SCROLLER or V_SCROLLER
+//! @param	the_size -- the thickness of the scroller, in pixels
+ControlTemplate* Theme_CreateControlTemplateScroller(Theme* the_theme, control_type the_type, int16_t the_size);
+
 // load the specified buffer data into a font object and return it
 Font* Theme_LoadFontFromBuffer(uint8_t* the_font_data, uint16_t data_size);
 
@@ -3077,6 +3084,79 @@ ControlTemplate* Theme_CreateDefaultControlTemplateMaximize(void)
 }
 
 
+//! Generate a control template for a window scroller, drawn with the theme's colors
+//! The template's image is one square the thickness of the scroller: the window stretches the control to fit, and the image is repeated along it
+//! @param	the_theme -- a theme with its colors already set
+//! @param	the_type -- H_SCROLLER or V_SCROLLER
+//! @param	the_size -- the thickness of the scroller, in pixels
+ControlTemplate* Theme_CreateControlTemplateScroller(Theme* the_theme, control_type the_type, int16_t the_size)
+{
+	ControlTemplate*	the_template;
+	int8_t				is_active;
+	int8_t				is_pushed;
+	Bitmap*				the_bitmap;
+
+	// LOGIC:
+	//   the track is the theme's inactive background, with a line in the outline color along the edge that faces the content
+	//   the thumb is not part of the image: the control draws it over the track, sized to how much of the content is in view
+	//   like labels, one bitmap is shared by all 4 states
+	
+	if (the_type != H_SCROLLER && the_type != V_SCROLLER)
+	{
+		LOG_ERR(("%s %d: control_type %i is not a scroller", __func__ , __LINE__, the_type));
+		return NULL;
+	}
+	
+	if ( (the_template = ControlTemplate_New()) == NULL)
+	{
+		LOG_ERR(("%s %d: could not allocate memory to create new ControlTemplate", __func__ , __LINE__));
+		return NULL;
+	}
+	LOG_ALLOC(("%s %d:	__ALLOC__	the_template	%p	size	%i", __func__ , __LINE__, the_template, sizeof(ControlTemplate)));
+	TRACK_ALLOC((sizeof(ControlTemplate)));
+	
+	if ( (the_bitmap = Bitmap_New(the_size, the_size, NULL, PARAM_NOT_IN_VRAM) ) == NULL)
+	{
+		LOG_ERR(("%s %d: could not create new Bitmap", __func__ , __LINE__));
+		return NULL;
+	}
+
+	Bitmap_FillMemory(the_bitmap, the_theme->inactive_back_color_);
+	
+	if (the_type == H_SCROLLER)
+	{
+		Bitmap_DrawHLine(the_bitmap, 0, 0, the_size, the_theme->outline_color_);
+	}
+	else
+	{
+		Bitmap_DrawVLine(the_bitmap, 0, 0, the_size, the_theme->outline_color_);
+	}
+
+	for (is_active = 0; is_active < 2; is_active++)
+	{
+		for (is_pushed = 0; is_pushed < 2; is_pushed++)
+		{
+			the_template->image_[is_active][is_pushed] = the_bitmap;
+		}
+	}
+
+	// the window sets the length: the template only places the scroller along the bottom or right edge of the content area
+	the_template->type_ = the_type;
+	the_template->h_align_ = (the_type == H_SCROLLER ? H_ALIGN_LEFT : H_ALIGN_RIGHT);
+	the_template->v_align_ = (the_type == H_SCROLLER ? V_ALIGN_BOTTOM : V_ALIGN_TOP);
+	the_template->x_offset_ = 0;
+	the_template->y_offset_ = 0;
+	the_template->width_ = the_size;
+	the_template->height_ = the_size;
+	the_template->min_ = 0;
+	the_template->max_ = 0;
+	the_template->caption_ = NULL;
+	the_template->avail_text_width_ = 0;
+	
+	return the_template;
+}
+
+
 //! Create a control template for a flexible-width control
 ControlTemplate* Theme_CreateControlTemplateFlexWidth(Theme* the_theme, control_type the_type, int16_t width, int16_t height, int16_t x_offset, int16_t y_offset, h_align_type h_align, v_align_type v_align, char* caption)
 {
@@ -3314,6 +3394,8 @@ void Theme_Print(Theme* the_theme)
 	DEBUG_OUT(("  control_t_minimize_: %p",	the_theme->control_t_minimize_));
 	DEBUG_OUT(("  control_t_norm_size_: %p",	the_theme->control_t_norm_size_));
 	DEBUG_OUT(("  control_t_maximize_: %p",	the_theme->control_t_maximize_));
+	DEBUG_OUT(("  control_t_h_scroller_: %p",	the_theme->control_t_h_scroller_));
+	DEBUG_OUT(("  control_t_v_scroller_: %p",	the_theme->control_t_v_scroller_));
 }
 
 
@@ -3384,6 +3466,18 @@ bool Theme_Destroy(Theme** the_theme)
 		(*the_theme)->control_t_maximize_ = NULL;
 	}
 
+	if ((*the_theme)->control_t_h_scroller_)
+	{
+ 		ControlTemplate_Destroy(&(*the_theme)->control_t_h_scroller_);
+		(*the_theme)->control_t_h_scroller_ = NULL;
+	}
+
+	if ((*the_theme)->control_t_v_scroller_)
+	{
+ 		ControlTemplate_Destroy(&(*the_theme)->control_t_v_scroller_);
+		(*the_theme)->control_t_v_scroller_ = NULL;
+	}
+
 	if ((*the_theme)->desktop_pattern_)
 	{
  		Bitmap_Destroy(&(*the_theme)->desktop_pattern_);
@@ -3486,6 +3580,8 @@ Theme* Theme_CreateDefaultTheme(bool minimal_resources)
 		the_theme->control_t_minimize_ = Theme_CreateDefaultControlTemplateMinimize();
 		the_theme->control_t_norm_size_ = Theme_CreateDefaultControlTemplateNormSize();
 		the_theme->control_t_maximize_ = Theme_CreateDefaultControlTemplateMaximize();
+		the_theme->control_t_h_scroller_ = Theme_CreateControlTemplateScroller(the_theme, H_SCROLLER, WIN_DEFAULT_SCROLLER_SIZE);
+		the_theme->control_t_v_scroller_ = Theme_CreateControlTemplateScroller(the_theme, V_SCROLLER, WIN_DEFAULT_SCROLLER_SIZE);
 
 		// get the backdrop bitmap snippets for the flexible-width controls (text buttons, text fields)
 
@@ -3684,6 +3780,30 @@ ControlTemplate* Theme_GetMaximizeControlTemplate(Theme* the_theme)
 }
 
 
+ControlTemplate* Theme_GetHScrollerControlTemplate(Theme* the_theme)
+{
+	if (the_theme == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		return NULL;
+	}
+
+	return the_theme->control_t_h_scroller_;
+}
+
+
+ControlTemplate* Theme_GetVScrollerControlTemplate(Theme* the_theme)
+{
+	if (the_theme == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		return NULL;
+	}
+
+	return the_theme->control_t_v_scroller_;
+}
+
+
 Bitmap* Theme_GetDesktopPattern(Theme* the_theme)
 {
 	if (the_theme == NULL)
@@ -3970,6 +4090,8 @@ Theme* Theme_CreateGreenTheme(void)
 	the_theme->control_t_minimize_ = Theme_CreateGreenControlTemplateMinimize();
 	the_theme->control_t_norm_size_ = Theme_CreateGreenControlTemplateNormSize();
 	the_theme->control_t_maximize_ = Theme_CreateGreenControlTemplateMaximize();
+	the_theme->control_t_h_scroller_ = Theme_CreateControlTemplateScroller(the_theme, H_SCROLLER, WIN_DEFAULT_SCROLLER_SIZE);
+	the_theme->control_t_v_scroller_ = Theme_CreateControlTemplateScroller(the_theme, V_SCROLLER, WIN_DEFAULT_SCROLLER_SIZE);
 	// get the backdrop bitmap snippets for the flexible-width controls (text buttons, text fields)
 	int8_t				is_active;
 	int8_t				is_pushed;
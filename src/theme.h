@@ -74,6 +74,7 @@
 #define WIN_DEFAULT_DESKTOP_COLOR				SYS_DEF_COLOR_DESKTOP
 #define WIN_DEFAULT_DESKTOP_WIDTH				16
 #define WIN_DEFAULT_DESKTOP_HEIGHT				16
+#define WIN_DEFAULT_SCROLLER_SIZE				10		// thickness of the window scrollers, in pixels
 #define WIN_DEFAULT_BACKGROUND_BGRA				0xCCCCCC00;
 #define WIN_DEFAULT_BORDER_BGRA					0x33333300;
 
@@ -137,6 +138,8 @@ struct Theme
 	ControlTemplate*		control_t_minimize_;
 	ControlTemplate*		control_t_norm_size_;
 	ControlTemplate*		control_t_maximize_;
+	ControlTemplate*		control_t_h_scroller_;			//! Stretched along the bottom of a window's content area when its content is wider than the window
+	ControlTemplate*		control_t_v_scroller_;			//! Stretched along the right of a window's content area when its content is taller than the window
 	ControlBackdrop			flex_width_backdrops_[2];		//! structs to hold pointers to the background left/mid/right graphics for varying-width controls like buttons
 
 };
@@ -194,6 +197,8 @@ ControlTemplate* Theme_GetCloseControlTemplate(Theme* the_theme);
 ControlTemplate* Theme_GetMinimizeControlTemplate(Theme* the_theme);
 ControlTemplate* Theme_GetNormSizeControlTemplate(Theme* the_theme);
 ControlTemplate* Theme_GetMaximizeControlTemplate(Theme* the_theme);
+ControlTemplate* Theme_GetHScrollerControlTemplate(Theme* the_theme);
+ControlTemplate* Theme_GetVScrollerControlTemplate(Theme* the_theme);
 
 //! Create a control template for a flexible-width control
 ControlTemplate* Theme_CreateControlTemplateFlexWidth(Theme* the_theme, control_type the_type, int16_t width, int16_t height, int16_t x_offset, int16_t y_offset, h_align_type h_align, v_align_type v_align, char* caption);
@@ -0,0 +1,580 @@
+/*
+ * timer.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: agent
+ */
+
+
+
+
+
+/*****************************************************************************/
+/*                                Includes                                   */
+/*****************************************************************************/
+
+// project includes
+#include "debug.h"
+#include "pool.h"
+#include "timer.h"
+
+// C includes
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// A2560 includes
+#include <mcp/syscalls.h>
+#include "a2560k.h"
+
+
+/*****************************************************************************/
+/*                               Definitions                                 */
+/*****************************************************************************/
+
+#define TIMERS_PER_SLAB		32	// caret blink, key repeat, and a few animations: one slab covers most programs
+
+
+/*****************************************************************************/
+/*                               Enumerations                                */
+/*****************************************************************************/
+
+
+
+/*****************************************************************************/
+/*                          File-scoped Variables                            */
+/*****************************************************************************/
+
+static Pool				timer_pool = POOL_INITIALIZER("Timer", Timer, TIMERS_PER_SLAB);
+
+
+/*****************************************************************************/
+/*                             Global Variables                              */
+/*****************************************************************************/
+
+
+
+/*****************************************************************************/
+/*                       Private Function Prototypes                         */
+/*****************************************************************************/
+
+//! Put a timer in the slot for its due time. A timer already due goes in the slot for the last tick processed, which is only looked at again while cascading.
+static void TimerWheel_Insert(TimerWheel* the_wheel, Timer* the_timer);
+
+//! Take a timer out of whatever slot it is in
+static void TimerWheel_Unlink(Timer* the_timer);
+
+//! Get the hash bucket for a window's timers
+static Timer** TimerWheel_GetBucket(TimerWheel* the_wheel, Window* the_window);
+
+//! Add a new timer to the hash bucket for its window
+static void TimerWheel_AddToIndex(TimerWheel* the_wheel, Timer* the_timer);
+
+//! Take a timer out of its hash bucket, and give it back to the pool
+static void TimerWheel_FreeTimer(TimerWheel* the_wheel, Timer* the_timer);
+
+//! Find a timer by window and ID
+//! @return	Returns NULL if there is no such timer
+static Timer* TimerWheel_Find(TimerWheel* the_wheel, Window* the_window, uint16_t the_id);
+
+//! Move the timers in one slot of a level down to the levels below
+//! @return	Returns the slot index, so the caller knows whether the next level up is due to cascade as well
+static uint16_t TimerWheel_Cascade(TimerWheel* the_wheel, uint16_t the_level);
+
+
+/*****************************************************************************/
+/*                       Private Function Definitions                        */
+/*****************************************************************************/
+
+//! Put a timer in the slot for its due time. A timer already due goes in the slot for the last tick processed, which is only looked at again while cascading.
+static void TimerWheel_Insert(TimerWheel* the_wheel, Timer* the_timer)
+{
+	uint32_t	delta;
+	uint16_t	the_level;
+	uint16_t	the_index;
+	Timer**		the_slot;
+
+	// LOGIC:
+	//   a timer goes in the lowest level whose 64 slots reach its due time. the slot is picked from the due time itself, not the delta,
+	//     so a timer doesn't have to be moved as the wheel turns, only when its slot at a higher level comes up and is cascaded.
+	//   during a cascade, timers due this tick land in the slot about to be run.
+
+	if ((int32_t)(the_timer->expires_ - the_wheel->now_) < 0)
+	{
+		the_timer->expires_ = the_wheel->now_;
+	}
+
+	delta = the_timer->expires_ - the_wheel->now_;
+
+	for (the_level = 0; the_level < TIMER_WHEEL_LEVELS - 1; the_level++)
+	{
+		if (delta < ((uint32_t)1 << ((the_level + 1) * TIMER_WHEEL_SLOT_BITS)))
+		{
+			break;
+		}
+	}
+
+	the_index = (the_timer->expires_ >> (the_level * TIMER_WHEEL_SLOT_BITS)) & TIMER_WHEEL_SLOT_MASK;
+	the_slot = &the_wheel->slot_[the_level][the_index];
+
+	the_timer->next_ = *the_slot;
+	the_timer->pprev_ = the_slot;
+
+	if (*the_slot != NULL)
+	{
+		(*the_slot)->pprev_ = &the_timer->next_;
+	}
+
+	*the_slot = the_timer;
+}
+
+
+//! Take a timer out of whatever slot it is in
+static void TimerWheel_Unlink(Timer* the_timer)
+{
+	*the_timer->pprev_ = the_timer->next_;
+
+	if (the_timer->next_ != NULL)
+	{
+		the_timer->next_->pprev_ = the_timer->pprev_;
+	}
+
+	the_timer->next_ = NULL;
+	the_timer->pprev_ = NULL;
+}
+
+
+//! Get the hash bucket for a window's timers
+static Timer** TimerWheel_GetBucket(TimerWheel* the_wheel, Window* the_window)
+{
+	uint32_t	the_hash;
+
+	// LOGIC:
+	//   windows are allocated from the heap, so the low bits of their addresses are the same for every window: fold in the higher ones.
+	//   every timer for a window is in the same bucket, so closing a window only has to look at one bucket.
+
+	the_hash = (uint32_t)the_window;
+	the_hash = (the_hash >> 4) ^ (the_hash >> 9);
+
+	return &the_wheel->index_[the_hash & (TIMER_INDEX_BUCKETS - 1)];
+}
+
+
+//! Add a new timer to the hash bucket for its window
+static void TimerWheel_AddToIndex(TimerWheel* the_wheel, Timer* the_timer)
+{
+	Timer**		the_bucket;
+
+	the_bucket = TimerWheel_GetBucket(the_wheel, the_timer->window_);
+
+	the_timer->index_next_ = *the_bucket;
+	the_timer->index_pprev_ = the_bucket;
+
+	if (*the_bucket != NULL)
+	{
+		(*the_bucket)->index_pprev_ = &the_timer->index_next_;
+	}
+
+	*the_bucket = the_timer;
+}
+
+
+//! Take a timer out of its hash bucket, and give it back to the pool
+static void TimerWheel_FreeTimer(TimerWheel* the_wheel, Timer* the_timer)
+{
+	*the_timer->index_pprev_ = the_timer->index_next_;
+
+	if (the_timer->index_next_ != NULL)
+	{
+		the_timer->index_next_->index_pprev_ = the_timer->index_pprev_;
+	}
+
+	Pool_Free(&timer_pool, the_timer);
+	the_wheel->count_--;
+}
+
+
+//! Find a timer by window and ID
+//! @return	Returns NULL if there is no such timer
+static Timer* TimerWheel_Find(TimerWheel* the_wheel, Window* the_window, uint16_t the_id)
+{
+	Timer*		the_timer;
+
+	for (the_timer = *TimerWheel_GetBucket(the_wheel, the_window); the_timer != NULL; the_timer = the_timer->index_next_)
+	{
+		if (the_timer->window_ == the_window && the_timer->id_ == the_id)
+		{
+			return the_timer;
+		}
+	}
+
+	return NULL;
+}
+
+
+//! Move the timers in one slot of a level down to the levels below
+//! @return	Returns the slot index, so the caller knows whether the next level up is due to cascade as well
+static uint16_t TimerWheel_Cascade(TimerWheel* the_wheel, uint16_t the_level)
+{
+	uint16_t	the_index;
+	Timer*		the_timer;
+	Timer*		the_next_timer;
+
+	the_index = (the_wheel->now_ >> (the_level * TIMER_WHEEL_SLOT_BITS)) & TIMER_WHEEL_SLOT_MASK;
+	the_timer = the_wheel->slot_[the_level][the_index];
+	the_wheel->slot_[the_level][the_index] = NULL;
+
+	while (the_timer != NULL)
+	{
+		the_next_timer = the_timer->next_;
+		TimerWheel_Insert(the_wheel, the_timer);
+		the_timer = the_next_timer;
+	}
+
+	return the_index;
+}
+
+
+
+
+/*****************************************************************************/
+/*                        Public Function Definitions                        */
+/*****************************************************************************/
+
+// **** CONSTRUCTOR AND DESTRUCTOR *****
+
+// constructor
+//! Allocate an empty TimerWheel object
+//! @param	now -- the current time in ticks
+//! @return	Returns NULL on any error
+TimerWheel* TimerWheel_New(uint32_t now)
+{
+	TimerWheel*		the_wheel;
+
+	if ( (the_wheel = (TimerWheel*)calloc(1, sizeof(TimerWheel)) ) == NULL)
+	{
+		LOG_ERR(("%s %d: could not allocate memory to create new timer wheel", __func__ , __LINE__));
+		return NULL;
+	}
+	LOG_ALLOC(("%s %d:	__ALLOC__	the_wheel	%p	size	%i", __func__ , __LINE__, the_wheel, sizeof(TimerWheel)));
+	TRACK_ALLOC((sizeof(TimerWheel)));
+
+	the_wheel->now_ = now;
+
+	return the_wheel;
+}
+
+
+// destructor
+// frees all allocated memory associated with the passed object, including any timers still in it, and the object itself
+//! @param	the_wheel -- pointer to the pointer for the TimerWheel object to be destroyed
+//! @return	Returns false if the pointer to the passed TimerWheel was NULL
+bool TimerWheel_Destroy(TimerWheel** the_wheel)
+{
+	uint16_t	the_level;
+	uint16_t	the_index;
+	Timer*		the_timer;
+
+	if (the_wheel == NULL || *the_wheel == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		return false;
+	}
+
+	for (the_level = 0; the_level < TIMER_WHEEL_LEVELS; the_level++)
+	{
+		for (the_index = 0; the_index < TIMER_WHEEL_SLOTS; the_index++)
+		{
+			while ( (the_timer = (*the_wheel)->slot_[the_level][the_index]) != NULL)
+			{
+				TimerWheel_Unlink(the_timer);
+				Pool_Free(&timer_pool, the_timer);
+			}
+		}
+	}
+
+	LOG_ALLOC(("%s %d:	__FREE__	*the_wheel	%p	size	%i", __func__ , __LINE__, *the_wheel, sizeof(TimerWheel)));
+	TRACK_ALLOC((0 - sizeof(TimerWheel)));
+	free(*the_wheel);
+	*the_wheel = NULL;
+
+	return true;
+}
+
+
+
+
+// **** TIMER functions *****
+
+//! Start a timer. If the window already has a timer with this ID, it is restarted with the new times.
+//! @param	the_wheel -- reference to a valid TimerWheel object
+//! @param	the_window -- the window the timer is for. May be NULL.
+//! @param	the_id -- the caller's ID for the timer
+//! @param	delay -- ticks from the last tick processed until the timer first fires. 0 is taken as 1: the next tick.
+//! @param	period -- ticks between firings after the first. 0 for a one-shot timer.
+//! @return	Returns false if there was no memory for the timer
+bool TimerWheel_StartTimer(TimerWheel* the_wheel, Window* the_window, uint16_t the_id, uint32_t delay, uint32_t period)
+{
+	Timer*		the_timer;
+
+	if ( (the_timer = TimerWheel_Find(the_wheel, the_window, the_id)) != NULL)
+	{
+		TimerWheel_Unlink(the_timer);
+	}
+	else
+	{
+		if ( (the_timer = (Timer*)Pool_Alloc(&timer_pool)) == NULL)
+		{
+			LOG_ERR(("%s %d: could not allocate memory to create new timer", __func__ , __LINE__));
+			return false;
+		}
+
+		the_timer->window_ = the_window;
+		the_timer->id_ = the_id;
+		TimerWheel_AddToIndex(the_wheel, the_timer);
+		the_wheel->count_++;
+	}
+
+	// the slot for the last tick processed has already been run: the soonest a new timer can fire is the next tick
+	if (delay == 0)
+	{
+		delay = 1;
+	}
+	else if (delay > TIMER_MAX_DELAY)
+	{
+		delay = TIMER_MAX_DELAY;
+	}
+
+	if (period > TIMER_MAX_DELAY)
+	{
+		period = TIMER_MAX_DELAY;
+	}
+
+	the_timer->expires_ = the_wheel->now_ + delay;
+	the_timer->period_ = period;
+	the_timer->missed_ = 0;
+	TimerWheel_Insert(the_wheel, the_timer);
+
+	return true;
+}
+
+
+//! Stop a timer. Does nothing if there is no such timer.
+//! @param	the_wheel -- reference to a valid TimerWheel object
+//! @return	Returns true if a timer was stopped
+bool TimerWheel_StopTimer(TimerWheel* the_wheel, Window* the_window, uint16_t the_id)
+{
+	Timer*		the_timer;
+
+	if ( (the_timer = TimerWheel_Find(the_wheel, the_window, the_id)) == NULL)
+	{
+		return false;
+	}
+
+	TimerWheel_Unlink(the_timer);
+	TimerWheel_FreeTimer(the_wheel, the_timer);
+
+	return true;
+}
+
+
+//! Stop all the timers for the passed window. Call this when a window is closed.
+//! @param	the_wheel -- reference to a valid TimerWheel object
+void TimerWheel_StopTimersForWindow(TimerWheel* the_wheel, Window* the_window)
+{
+	Timer*		the_timer;
+	Timer*		the_next_timer;
+
+	for (the_timer = *TimerWheel_GetBucket(the_wheel, the_window); the_timer != NULL; the_timer = the_next_timer)
+	{
+		the_next_timer = the_timer->index_next_;
+
+		if (the_timer->window_ == the_window)
+		{
+			TimerWheel_Unlink(the_timer);
+			TimerWheel_FreeTimer(the_wheel, the_timer);
+		}
+	}
+}
+
+
+//! Fire every timer due up to and including the passed time
+//! A periodic timer fires at most once per call: if the wheel is advanced past more than one of its periods, the timer's missed_ says how many were skipped.
+//! @param	the_wheel -- reference to a valid TimerWheel object
+//! @param	now -- the current time in ticks. Must not be earlier than the time last passed.
+//! @param	fire -- function called for each timer that is due. It must not start or stop timers. One-shot timers are freed after it returns.
+//! @return	Returns the number of timers fired
+uint16_t TimerWheel_Advance(TimerWheel* the_wheel, uint32_t now, void (*fire)(Timer*))
+{
+	uint16_t	the_level;
+	uint16_t	num_fired = 0;
+	uint32_t	num_periods;
+	Timer**		the_slot;
+	Timer*		the_timer;
+
+	// LOGIC:
+	//   the wheel is turned one tick at a time, but ticks with nothing to do cost a couple of comparisons.
+	//   when level 0 comes round to slot 0, the next slot of level 1 is cascaded down into it. when that is slot 0 too, level 2 goes next, and so on.
+	//   after a long sleep, with no timers at all, there is nothing to turn: jump straight to the new time.
+
+	if (the_wheel->count_ == 0)
+	{
+		the_wheel->now_ = now;
+		return 0;
+	}
+
+	while (the_wheel->now_ != now)
+	{
+		the_wheel->now_++;
+
+		if ((the_wheel->now_ & TIMER_WHEEL_SLOT_MASK) == 0)
+		{
+			for (the_level = 1; the_level < TIMER_WHEEL_LEVELS; the_level++)
+			{
+				if (TimerWheel_Cascade(the_wheel, the_level) != 0)
+				{
+					break;
+				}
+			}
+		}
+
+		the_slot = &the_wheel->slot_[0][the_wheel->now_ & TIMER_WHEEL_SLOT_MASK];
+
+		while ( (the_timer = *the_slot) != NULL)
+		{
+			TimerWheel_Unlink(the_timer);
+			the_timer->missed_ = 0;
+
+			// a periodic timer that has fallen more than a period behind skips the periods already gone, rather than firing for each of them
+			if (the_timer->period_ > 0)
+			{
+				the_timer->expires_ += the_timer->period_;
+
+				if ((int32_t)(the_timer->expires_ - now) <= 0)
+				{
+					num_periods = (now - the_timer->expires_) / the_timer->period_ + 1;
+					the_timer->expires_ += num_periods * the_timer->period_;
+					the_timer->missed_ = (num_periods > 0xFFFF) ? 0xFFFF : (uint16_t)num_periods;
+				}
+			}
+
+			(*fire)(the_timer);
+			num_fired++;
+
+			if (the_timer->period_ > 0)
+			{
+				TimerWheel_Insert(the_wheel, the_timer);
+			}
+			else
+			{
+				TimerWheel_FreeTimer(the_wheel, the_timer);
+			}
+		}
+
+		if (the_wheel->count_ == 0)
+		{
+			the_wheel->now_ = now;
+		}
+	}
+
+	return num_fired;
+}
+
+
+//! Move the wheel to a new time without firing anything: each timer keeps the number of ticks it had left
+//! For when the clock is replaced by one that reads differently. Timers that were due stay due.
+//! @param	the_wheel -- reference to a valid TimerWheel object
+//! @param	now -- the time in ticks on the new clock
+void TimerWheel_SetTime(TimerWheel* the_wheel, uint32_t now)
+{
+	uint16_t	the_level;
+	uint16_t	the_index;
+	Timer*		the_timer;
+	Timer*		the_moved_timers = NULL;
+	
+	// LOGIC: every timer is taken out and put back, as its slots depend on its due time. this is rare: a linear pass is fine.
+
+	for (the_level = 0; the_level < TIMER_WHEEL_LEVELS; the_level++)
+	{
+		for (the_index = 0; the_index < TIMER_WHEEL_SLOTS; the_index++)
+		{
+			while ( (the_timer = the_wheel->slot_[the_level][the_index]) != NULL)
+			{
+				TimerWheel_Unlink(the_timer);
+				the_timer->expires_ -= the_wheel->now_;
+				the_timer->next_ = the_moved_timers;
+				the_moved_timers = the_timer;
+			}
+		}
+	}
+
+	the_wheel->now_ = now;
+
+	while ( (the_timer = the_moved_timers) != NULL)
+	{
+		the_moved_timers = the_timer->next_;
+		the_timer->expires_ += now;
+		TimerWheel_Insert(the_wheel, the_timer);
+	}
+}
+
+
+//! Get how many ticks after the last tick processed the next timer could be due
+//! Exact for timers due within 64 ticks. For later timers, it is the time their slot is next looked at: sleep until then, advance, and ask again.
+//! @param	the_wheel -- reference to a valid TimerWheel object
+//! @return	Returns TIMER_NONE_PENDING if there are no timers
+uint32_t TimerWheel_GetTicksToNext(TimerWheel* the_wheel)
+{
+	uint16_t	the_level;
+	uint16_t	i;
+	uint16_t	the_shift;
+	uint32_t	the_block;
+	uint32_t	ticks_to_slot;
+	uint32_t	ticks_to_next = TIMER_NONE_PENDING;
+
+	// LOGIC:
+	//   a level 0 slot holds timers due at exactly that tick.
+	//   a higher level slot holds timers due some time in its block, and is cascaded when the block starts: that is the soonest they can be due.
+	//   at the higher levels, the slot for the current block was cascaded when the block started: anything in it now is 64 blocks away.
+	//   a higher level slot can come up before the first timer at level 0, so every level is looked at.
+
+	if (the_wheel->count_ == 0)
+	{
+		return TIMER_NONE_PENDING;
+	}
+
+	for (i = 1; i < TIMER_WHEEL_SLOTS; i++)
+	{
+		if (the_wheel->slot_[0][(the_wheel->now_ + i) & TIMER_WHEEL_SLOT_MASK] != NULL)
+		{
+			ticks_to_next = i;
+			break;
+		}
+	}
+
+	for (the_level = 1; the_level < TIMER_WHEEL_LEVELS; the_level++)
+	{
+		the_shift = the_level * TIMER_WHEEL_SLOT_BITS;
+
+		for (i = 1; i <= TIMER_WHEEL_SLOTS; i++)
+		{
+			the_block = (the_wheel->now_ >> the_shift) + i;
+
+			if (the_wheel->slot_[the_level][the_block & TIMER_WHEEL_SLOT_MASK] != NULL)
+			{
+				ticks_to_slot = (the_block << the_shift) - the_wheel->now_;
+
+				if (ticks_to_slot < ticks_to_next)
+				{
+					ticks_to_next = ticks_to_slot;
+				}
+
+				break;
+			}
+		}
+	}
+
+	return ticks_to_next;
+}
@@ -0,0 +1,174 @@
+//! @file timer.h
+
+/*
+ * timer.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: agent
+ */
+
+#ifndef LIB_TIMER_H_
+#define LIB_TIMER_H_
+
+
+/* about this class: TimerWheel
+ *
+ * Keeps one-shot and periodic timers, and says which are due as the clock moves on.
+ * A hierarchical timer wheel: 4 levels of 64 slots. Level 0 has a slot for each of the next 64 ticks. Each higher level has
+ *   a slot for each of the next 64 blocks of the level below: 64 ticks, 4096 ticks, then 262144 ticks (over 72 minutes at 60 ticks/sec).
+ *   A timer goes in the slot for its due time at the lowest level that reaches that far. As a higher-level slot comes up, its timers
+ *   are moved down a level. Firing a timer costs the same however many timers there are.
+ * Each timer is also in a small hash table by window, so restarting or stopping one only looks at the timers of its own window
+ *   (and of any window that hashes to the same bucket), rather than searching every slot.
+ * The wheel has no clock of its own: the caller passes the time in ticks. That keeps it testable with a stand-in clock.
+ * What a timer does when it fires is up to the caller: TimerWheel_Advance() calls the passed function for each timer that is due.
+ * Timers are identified by their window and an ID, as with Window events, rather than by pointer: one-shot timers are freed once fired.
+ *
+ *** things this class needs to be able to do
+ * start a one-shot or periodic timer for a window. starting a timer with the same window and ID restarts it.
+ * stop a timer, or all timers for a window
+ * fire every timer that is due up to a given time, catching up on periodic timers that fell behind without firing them repeatedly
+ * say how long until the next timer could be due, so the caller can sleep until then
+ *
+ * STRETCH GOALS
+ *
+ *
+ * SUPER STRETCH GOALS
+ *
+ *
+ */
+
+
+/*****************************************************************************/
+/*                                Includes                                   */
+/*****************************************************************************/
+
+// project includes
+
+
+// C includes
+#include <stdbool.h>
+#include <stdint.h>
+
+
+// A2560 includes
+#include <mcp/syscalls.h>
+#include "a2560k.h"
+
+
+/*****************************************************************************/
+/*                            Macro Definitions                              */
+/*****************************************************************************/
+
+#define TIMER_WHEEL_LEVELS		4
+#define TIMER_WHEEL_SLOT_BITS	6
+#define TIMER_WHEEL_SLOTS		(1 << TIMER_WHEEL_SLOT_BITS)		//!< slots per level
+#define TIMER_WHEEL_SLOT_MASK	(TIMER_WHEEL_SLOTS - 1)
+#define TIMER_MAX_DELAY			(((uint32_t)1 << (TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOT_BITS)) - 1)	//!< longer delays are cut to this many ticks
+
+#define TIMER_INDEX_BUCKETS		16				//!< buckets in the window hash table. Must be a power of 2.
+
+#define TIMER_NONE_PENDING		0xFFFFFFFF		//!< TimerWheel_GetTicksToNext() result when there are no timers
+
+
+/*****************************************************************************/
+/*                               Enumerations                                */
+/*****************************************************************************/
+
+
+
+/*****************************************************************************/
+/*                                 Structs                                   */
+/*****************************************************************************/
+
+struct Timer
+{
+	Timer*				next_;			//!< next timer in the same slot
+	Timer**				pprev_;			//!< the pointer that points to this timer: the slot head, or the previous timer's next_
+	Timer*				index_next_;	//!< next timer in the same window hash bucket
+	Timer**				index_pprev_;	//!< the pointer that points to this timer in its hash bucket
+	uint32_t			expires_;		//!< tick the timer is next due at
+	uint32_t			period_;		//!< ticks between firings. 0 for a one-shot timer.
+	uint16_t			missed_;		//!< set before the timer fires: the number of periods skipped because the wheel was advanced past them
+	uint16_t			id_;			//!< caller's ID for the timer. Unique per window.
+	Window*				window_;		//!< the window the timer belongs to. May be NULL.
+};
+
+struct TimerWheel
+{
+	Timer*				slot_[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS];	//!< lists of timers, by level and slot
+	Timer*				index_[TIMER_INDEX_BUCKETS];	//!< the same timers, by a hash of their window: for finding a window's timers without searching the slots
+	uint32_t			now_;			//!< the last tick processed. Timers due at or before it have fired.
+	uint16_t			count_;			//!< number of timers in the wheel
+};
+
+
+
+/*****************************************************************************/
+/*                             Global Variables                              */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*                       Public Function Prototypes                          */
+/*****************************************************************************/
+
+
+// **** CONSTRUCTOR AND DESTRUCTOR *****
+
+// constructor
+//! Allocate an empty TimerWheel object
+//! @param	now -- the current time in ticks
+//! @return	Returns NULL on any error
+TimerWheel* TimerWheel_New(uint32_t now);
+
+// destructor
+// frees all allocated memory associated with the passed object, including any timers still in it, and the object itself
+//! @param	the_wheel -- pointer to the pointer for the TimerWheel object to be destroyed
+//! @return	Returns false if the pointer to the passed TimerWheel was NULL
+bool TimerWheel_Destroy(TimerWheel** the_wheel);
+
+
+// **** TIMER functions *****
+
+//! Start a timer. If the window already has a timer with this ID, it is restarted with the new times.
+//! @param	the_wheel -- reference to a valid TimerWheel object
+//! @param	the_window -- the window the timer is for. May be NULL.
+//! @param	the_id -- the caller's ID for the timer
+//! @param	delay -- ticks from the last tick processed until the timer first fires. 0 is taken as 1: the next tick.
+//! @param	period -- ticks between firings after the first. 0 for a one-shot timer.
+//! @return	Returns false if there was no memory for the timer
+bool TimerWheel_StartTimer(TimerWheel* the_wheel, Window* the_window, uint16_t the_id, uint32_t delay, uint32_t period);
+
+//! Stop a timer. Does nothing if there is no such timer.
+//! @param	the_wheel -- reference to a valid TimerWheel object
+//! @return	Returns true if a timer was stopped
+bool TimerWheel_StopTimer(TimerWheel* the_wheel, Window* the_window, uint16_t the_id);
+
+//! Stop all the timers for the passed window. Call this when a window is closed.
+//! @param	the_wheel -- reference to a valid TimerWheel object
+void TimerWheel_StopTimersForWindow(TimerWheel* the_wheel, Window* the_window);
+
+//! Fire every timer due up to and including the passed time
+//! A periodic timer fires at most once per call: if the wheel is advanced past more than one of its periods, the timer's missed_ says how many were skipped.
+//! @param	the_wheel -- reference to a valid TimerWheel object
+//! @param	now -- the current time in ticks. Must not be earlier than the time last passed.
+//! @param	fire -- function called for each timer that is due. It must not start or stop timers. One-shot timers are freed after it returns.
+//! @return	Returns the number of timers fired
+uint16_t TimerWheel_Advance(TimerWheel* the_wheel, uint32_t now, void (*fire)(Timer*));
+
+//! Move the wheel to a new time without firing anything: each timer keeps the number of ticks it had left
+//! For when the clock is replaced by one that reads differently. Timers that were due stay due.
+//! @param	the_wheel -- reference to a valid TimerWheel object
+//! @param	now -- the time in ticks on the new clock
+void TimerWheel_SetTime(TimerWheel* the_wheel, uint32_t now);
+
+//! Get how many ticks after the last tick processed the next timer could be due
+//! Exact for timers due within 64 ticks. For later timers, it is the time their slot is next looked at: sleep until then, advance, and ask again.
+//! @param	the_wheel -- reference to a valid TimerWheel object
+//! @return	Returns TIMER_NONE_PENDING if there are no timers
+uint32_t TimerWheel_GetTicksToNext(TimerWheel* the_wheel);
+
+
+
+#endif /* LIB_TIMER_H_ */
@@ -0,0 +1,307 @@
+/*
+ * timer_test.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: agent
+ */
+
+
+
+
+
+/*****************************************************************************/
+/*                                Includes                                   */
+/*****************************************************************************/
+
+// unit testing framework
+#include "debug.h"
+#include "minunit.h"
+
+// project includes
+#include "window.h"
+
+// class being tested
+#include "timer.h"
+
+// C includes
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+
+// A2560 includes
+#include "a2560k.h"
+
+
+
+/*****************************************************************************/
+/*                               Definitions                                 */
+/*****************************************************************************/
+
+#define TIMER_TEST_MAX_FIRED	64
+
+
+/*****************************************************************************/
+/*                               Enumerations                                */
+/*****************************************************************************/
+
+
+
+/*****************************************************************************/
+/*                             Global Variables                              */
+/*****************************************************************************/
+
+// LOGIC: the wheel only compares window pointers, so the tests use bare window structs rather than real windows
+static Window		test_windows[2];
+static TimerWheel*	test_wheel;
+
+// what the fire callback was called with, in order. the wheel's time at each call is the test's stand-in clock.
+static uint16_t		fired_ids[TIMER_TEST_MAX_FIRED];
+static uint32_t		fired_times[TIMER_TEST_MAX_FIRED];
+static uint16_t		fired_missed[TIMER_TEST_MAX_FIRED];
+static uint16_t		num_fired;
+
+
+/*****************************************************************************/
+/*                       Private Function Prototypes                         */
+/*****************************************************************************/
+
+// fire callback: note which timer fired, and when
+void Test_Fire(Timer* the_timer);
+
+// advance the wheel one tick at a time up to the passed time, as the event loop would with no other work to do
+uint16_t Test_AdvanceByTicks(uint32_t now);
+
+
+/*****************************************************************************/
+/*                       Private Function Definitions                        */
+/*****************************************************************************/
+
+// fire callback: note which timer fired, and when
+void Test_Fire(Timer* the_timer)
+{
+	if (num_fired < TIMER_TEST_MAX_FIRED)
+	{
+		fired_ids[num_fired] = the_timer->id_;
+		fired_times[num_fired] = test_wheel->now_;
+		fired_missed[num_fired] = the_timer->missed_;
+	}
+
+	num_fired++;
+}
+
+
+// advance the wheel one tick at a time up to the passed time, as the event loop would with no other work to do
+uint16_t Test_AdvanceByTicks(uint32_t now)
+{
+	uint16_t	total_fired = 0;
+
+	while (test_wheel->now_ != now)
+	{
+		total_fired += TimerWheel_Advance(test_wheel, test_wheel->now_ + 1, &Test_Fire);
+	}
+
+	return total_fired;
+}
+
+
+
+
+/*****************************************************************************/
+/*                        MinUnit Function Defintions                        */
+/*****************************************************************************/
+
+
+
+void test_setup(void)	// this is called EVERY test
+{
+	memset(test_windows, 0, sizeof(test_windows));
+	num_fired = 0;
+	test_wheel = TimerWheel_New(1000);
+}
+
+
+void test_teardown(void)	// this is called EVERY test
+{
+	TimerWheel_Destroy(&test_wheel);
+}
+
+
+
+// **** unit tests
+
+MU_TEST(timer_one_shot_test)
+{
+	mu_assert(test_wheel != NULL, "could not create timer wheel");
+	mu_assert_int_eq(TIMER_NONE_PENDING, TimerWheel_GetTicksToNext(test_wheel));
+
+	mu_check( TimerWheel_StartTimer(test_wheel, &test_windows[0], 1, 10, 0) == true );
+	mu_assert_int_eq(1, test_wheel->count_);
+	mu_assert_int_eq(10, TimerWheel_GetTicksToNext(test_wheel));
+
+	// not yet
+	mu_assert_int_eq(0, TimerWheel_Advance(test_wheel, 1009, &Test_Fire));
+	mu_assert_int_eq(1, TimerWheel_GetTicksToNext(test_wheel));
+
+	mu_assert_int_eq(1, TimerWheel_Advance(test_wheel, 1010, &Test_Fire));
+	mu_assert_int_eq(1, fired_ids[0]);
+	mu_assert_int_eq(1010, fired_times[0]);
+
+	// a one-shot timer is gone once fired
+	mu_assert_int_eq(0, test_wheel->count_);
+	mu_assert_int_eq(TIMER_NONE_PENDING, TimerWheel_GetTicksToNext(test_wheel));
+	mu_assert_int_eq(0, TimerWheel_Advance(test_wheel, 2000, &Test_Fire));
+
+	// a delay of 0 is the next tick
+	TimerWheel_StartTimer(test_wheel, &test_windows[0], 2, 0, 0);
+	mu_assert_int_eq(1, TimerWheel_Advance(test_wheel, 2001, &Test_Fire));
+	mu_assert_int_eq(2001, fired_times[1]);
+}
+
+
+MU_TEST(timer_periodic_test)
+{
+	TimerWheel_StartTimer(test_wheel, &test_windows[0], 7, 5, 30);
+
+	mu_assert_int_eq(4, Test_AdvanceByTicks(1100));
+	mu_assert_int_eq(1005, fired_times[0]);
+	mu_assert_int_eq(1035, fired_times[1]);
+	mu_assert_int_eq(1065, fired_times[2]);
+	mu_assert_int_eq(1095, fired_times[3]);
+	mu_assert_int_eq(0, fired_missed[3]);
+	mu_assert_int_eq(1, test_wheel->count_);
+
+	// the loop was busy for a while: the timer fires once, and says how many times it didn't
+	num_fired = 0;
+	mu_assert_int_eq(1, TimerWheel_Advance(test_wheel, 1200, &Test_Fire));
+	mu_assert_int_eq(2, fired_missed[0]);
+
+	// and it stays on its original beat
+	mu_assert_int_eq(1, Test_AdvanceByTicks(1215));
+	mu_assert_int_eq(1215, fired_times[1]);
+	mu_assert_int_eq(0, fired_missed[1]);
+
+	mu_check( TimerWheel_StopTimer(test_wheel, &test_windows[0], 7) == true );
+	mu_check( TimerWheel_StopTimer(test_wheel, &test_windows[0], 7) == false );
+	mu_assert_int_eq(0, test_wheel->count_);
+}
+
+
+MU_TEST(timer_cascade_test)
+{
+	uint32_t	delays[] = {63, 64, 65, 100, 4095, 4096, 4097, 5000, 262143, 262144, 300000};
+	uint16_t	num_delays = sizeof(delays) / sizeof(delays[0]);
+	uint16_t	i;
+	uint32_t	ticks_to_next;
+
+	// a timer further out can have to be looked at before a nearer one is due: 1070 is cascaded at 1024, before 1050 fires
+	TimerWheel_StartTimer(test_wheel, &test_windows[1], 1, 50, 0);
+	TimerWheel_StartTimer(test_wheel, &test_windows[1], 2, 70, 0);
+	mu_assert_int_eq(1024 - 1000, TimerWheel_GetTicksToNext(test_wheel));
+	TimerWheel_StopTimersForWindow(test_wheel, &test_windows[1]);
+
+	// timers at and around each level's edge fire on exactly the right tick, however they got to level 0
+	for (i = 0; i < num_delays; i++)
+	{
+		TimerWheel_StartTimer(test_wheel, &test_windows[0], i, delays[i], 0);
+	}
+
+	mu_assert_int_eq(num_delays, Test_AdvanceByTicks(1000 + 300000));
+
+	for (i = 0; i < num_delays; i++)
+	{
+		mu_assert_int_eq(i, fired_ids[i]);
+		mu_assert_int_eq(1000 + delays[i], fired_times[i]);
+	}
+
+	// the time to the next timer never overshoots it, so a caller sleeping that long never misses one
+	num_fired = 0;
+	TimerWheel_StartTimer(test_wheel, &test_windows[0], 1, 5000, 0);
+
+	while (num_fired == 0)
+	{
+		ticks_to_next = TimerWheel_GetTicksToNext(test_wheel);
+		mu_check( ticks_to_next >= 1 && test_wheel->now_ + ticks_to_next <= 1000 + 300000 + 5000 );
+		TimerWheel_Advance(test_wheel, test_wheel->now_ + ticks_to_next, &Test_Fire);
+	}
+
+	mu_assert_int_eq(1000 + 300000 + 5000, fired_times[0]);
+}
+
+
+MU_TEST(timer_restart_and_window_test)
+{
+	TimerWheel_StartTimer(test_wheel, &test_windows[0], 1, 20, 0);
+	TimerWheel_StartTimer(test_wheel, &test_windows[0], 2, 2000, 100);
+	TimerWheel_StartTimer(test_wheel, &test_windows[1], 1, 30, 0);
+	mu_assert_int_eq(3, test_wheel->count_);
+
+	// the same window and ID restarts the timer, rather than adding a second one
+	TimerWheel_StartTimer(test_wheel, &test_windows[0], 1, 40, 0);
+	mu_assert_int_eq(3, test_wheel->count_);
+
+	// IDs belong to windows: stopping window 0's timer 1 leaves window 1's alone
+	TimerWheel_StopTimersForWindow(test_wheel, &test_windows[0]);
+	mu_assert_int_eq(1, test_wheel->count_);
+
+	mu_assert_int_eq(1, TimerWheel_Advance(test_wheel, 1100, &Test_Fire));
+	mu_assert_int_eq(1030, fired_times[0]);
+
+	// moving to a new clock keeps the ticks left
+	TimerWheel_StartTimer(test_wheel, &test_windows[1], 3, 50, 0);
+	TimerWheel_SetTime(test_wheel, 7);
+	mu_assert_int_eq(50, TimerWheel_GetTicksToNext(test_wheel));
+	mu_assert_int_eq(1, TimerWheel_Advance(test_wheel, 57, &Test_Fire));
+	mu_assert_int_eq(57, fired_times[1]);
+}
+
+
+MU_TEST(timer_wraparound_test)
+{
+	// the tick count wraps after 2^32 ticks (about 2 years at 60 per second). timers that span the wrap still fire on time.
+	test_wheel->now_ = 0xFFFFFFF0;
+
+	TimerWheel_StartTimer(test_wheel, &test_windows[0], 1, 0x20, 0);
+	TimerWheel_StartTimer(test_wheel, &test_windows[0], 2, 0x1000, 0);
+
+	mu_assert_int_eq(2, Test_AdvanceByTicks(0x0FF0));
+	mu_assert_int_eq(0x10, fired_times[0]);
+	mu_assert_int_eq(0x0FF0, fired_times[1]);
+}
+
+
+
+// unit tests
+MU_TEST_SUITE(test_suite_units)
+{
+	MU_SUITE_CONFIGURE(&test_setup, &test_teardown);
+
+	MU_RUN_TEST(timer_one_shot_test);
+	MU_RUN_TEST(timer_periodic_test);
+	MU_RUN_TEST(timer_cascade_test);
+	MU_RUN_TEST(timer_restart_and_window_test);
+	MU_RUN_TEST(timer_wraparound_test);
+}
+
+
+
+
+
+/*****************************************************************************/
+/*                        Public Function Definitions                        */
+/*****************************************************************************/
+
+
+
+int main(int argc, char* argv[])
+{
+	printf("**** timer.c Test Suite **** \n");
+
+	MU_RUN_SUITE(test_suite_units);
+	MU_REPORT();
+
+	printf("timer test complete \n");
+
+	return MU_EXIT_CODE;
+}
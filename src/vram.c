@@ -0,0 +1,493 @@
+/*
+ * vram.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: agent
+ */
+
+
+
+
+
+/*****************************************************************************/
+/*                                Includes                                   */
+/*****************************************************************************/
+
+// project includes
+#include "bitmap.h"
+#include "debug.h"
+#include "vram.h"
+
+// C includes
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// A2560 includes
+#include <mcp/syscalls.h>
+#include "a2560k.h"
+
+
+/*****************************************************************************/
+/*                               Definitions                                 */
+/*****************************************************************************/
+
+#define VRAM_ROUND_UP(x)		(((x) + (VRAM_BLOCK_ALIGN - 1)) & ~(uint32_t)(VRAM_BLOCK_ALIGN - 1))
+
+//! One allocated block of VRAM
+typedef struct VramBlock
+{
+	uint32_t		start_;			// address of the first byte of the block
+	uint32_t		size_;			// bytes in the block. always a multiple of VRAM_BLOCK_ALIGN.
+	Bitmap*			owner_;			// the bitmap whose storage this is
+} VramBlock;
+
+
+/*****************************************************************************/
+/*                               Enumerations                                */
+/*****************************************************************************/
+
+
+
+/*****************************************************************************/
+/*                          File-scoped Variables                            */
+/*****************************************************************************/
+
+static VramBlock		vram_blocks[VRAM_MAX_BLOCKS];	// allocated blocks, sorted by address. free space is the gaps between them.
+static int16_t			vram_num_blocks = 0;
+static uint32_t			vram_heap_start = 0;			// first byte of the heap. 0 until Vram_Init() is called.
+static uint32_t			vram_heap_end = 0;				// first byte after the heap
+static uint32_t			vram_in_use = 0;
+static uint32_t			vram_high_water = 0;
+static uint32_t			vram_compactions = 0;
+static uint32_t			vram_failures = 0;
+
+
+/*****************************************************************************/
+/*                             Global Variables                              */
+/*****************************************************************************/
+
+
+
+/*****************************************************************************/
+/*                       Private Function Prototypes                         */
+/*****************************************************************************/
+
+//! Find the smallest gap between blocks that can hold the_size bytes
+//! @param	the_size -- bytes needed, already rounded up to VRAM_BLOCK_ALIGN
+//! @param	the_index -- set to the index in the block table where a block in that gap belongs
+//! @param	the_start -- set to the address of the start of the gap
+//! @return	Returns false if there is no gap big enough
+bool Vram_FindGap(uint32_t the_size, int16_t* the_index, uint32_t* the_start);
+
+//! Find the block owned by the passed bitmap
+//! @return	Returns the block's index in the block table, or -1 if the bitmap doesn't own a block
+int16_t Vram_FindBlock(Bitmap* the_bitmap);
+
+//! Grow or shrink a block without moving it
+//! @param	the_index -- index of the block in the block table
+//! @param	the_size -- new size, already rounded up to VRAM_BLOCK_ALIGN
+//! @return	Returns false if growing it would run into the next block (or the end of the heap)
+bool Vram_ResizeInPlace(int16_t the_index, uint32_t the_size);
+
+
+/*****************************************************************************/
+/*                       Private Function Definitions                        */
+/*****************************************************************************/
+
+//! \cond PRIVATE
+
+//! Find the smallest gap between blocks that can hold the_size bytes
+//! @param	the_size -- bytes needed, already rounded up to VRAM_BLOCK_ALIGN
+//! @param	the_index -- set to the index in the block table where a block in that gap belongs
+//! @param	the_start -- set to the address of the start of the gap
+//! @return	Returns false if there is no gap big enough
+bool Vram_FindGap(uint32_t the_size, int16_t* the_index, uint32_t* the_start)
+{
+	uint32_t	gap_start;
+	uint32_t	gap_end;
+	uint32_t	best_size = 0;
+	bool		found = false;
+	int16_t		i;
+
+	// LOGIC:
+	//   gap i is the space before block i. there is one more gap than blocks: the one after the last block.
+	//   best fit, so the biggest gaps stay free for the biggest windows
+
+	for (i = 0; i <= vram_num_blocks; i++)
+	{
+		gap_start = (i == 0 ? vram_heap_start : vram_blocks[i - 1].start_ + vram_blocks[i - 1].size_);
+		gap_end = (i == vram_num_blocks ? vram_heap_end : vram_blocks[i].start_);
+
+		if (gap_end - gap_start >= the_size && (found == false || gap_end - gap_start < best_size))
+		{
+			found = true;
+			best_size = gap_end - gap_start;
+			*the_index = i;
+			*the_start = gap_start;
+
+			if (best_size == the_size)
+			{
+				break;
+			}
+		}
+	}
+
+	return found;
+}
+
+
+//! Find the block owned by the passed bitmap
+//! @return	Returns the block's index in the block table, or -1 if the bitmap doesn't own a block
+int16_t Vram_FindBlock(Bitmap* the_bitmap)
+{
+	int16_t		i;
+
+	for (i = 0; i < vram_num_blocks; i++)
+	{
+		if (vram_blocks[i].owner_ == the_bitmap)
+		{
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+
+//! Grow or shrink a block without moving it
+//! @param	the_index -- index of the block in the block table
+//! @param	the_size -- new size, already rounded up to VRAM_BLOCK_ALIGN
+//! @return	Returns false if growing it would run into the next block (or the end of the heap)
+bool Vram_ResizeInPlace(int16_t the_index, uint32_t the_size)
+{
+	uint32_t	next_start;
+
+	next_start = (the_index + 1 < vram_num_blocks ? vram_blocks[the_index + 1].start_ : vram_heap_end);
+
+	if (vram_blocks[the_index].start_ + the_size > next_start)
+	{
+		return false;
+	}
+
+	vram_in_use = vram_in_use - vram_blocks[the_index].size_ + the_size;
+	vram_blocks[the_index].size_ = the_size;
+
+	if (vram_in_use > vram_high_water)
+	{
+		vram_high_water = vram_in_use;
+	}
+
+	return true;
+}
+
+
+//! \endcond
+
+
+
+/*****************************************************************************/
+/*                        Public Function Definitions                        */
+/*****************************************************************************/
+
+
+// **** SETUP *****
+
+//! Set up the VRAM heap to manage the passed range of memory. Any blocks from a previous Vram_Init() are forgotten.
+//! @param	the_start -- address of the first byte of the heap, in the machine's global address space. Normally VRAM_HEAP_START.
+//! @param	the_len -- number of bytes in the heap. Normally VRAM_HEAP_LEN.
+//! @return	Returns false if the range is too small to be useful
+bool Vram_Init(uint32_t the_start, uint32_t the_len)
+{
+	vram_num_blocks = 0;
+	vram_in_use = 0;
+	vram_high_water = 0;
+	vram_compactions = 0;
+	vram_failures = 0;
+
+	vram_heap_start = VRAM_ROUND_UP(the_start);
+	vram_heap_end = (the_start + the_len) & ~(uint32_t)(VRAM_BLOCK_ALIGN - 1);
+
+	if (vram_heap_end <= vram_heap_start)
+	{
+		LOG_ERR(("%s %d: VRAM range %lx, length %lu is too small for a heap", __func__ , __LINE__, the_start, the_len));
+		vram_heap_start = 0;
+		vram_heap_end = 0;
+		return false;
+	}
+
+	DEBUG_OUT(("%s %d: VRAM heap is %lx-%lx (%lu bytes)", __func__ , __LINE__, vram_heap_start, vram_heap_end - 1, vram_heap_end - vram_heap_start));
+
+	return true;
+}
+
+
+// **** ALLOCATION *****
+
+//! Allocate a block of VRAM for a bitmap, and set the bitmap's address to it. The block is not cleared.
+//! If no gap is big enough, but the total free space is, the heap is compacted first: other bitmaps' blocks may move.
+//! @param	the_bitmap -- the bitmap that will own the block. Its addr_ and addr_int_ are set, and are updated if the block is ever moved.
+//! @param	the_size -- number of bytes needed
+//! @return	Returns false if the heap is not set up, or has no room: the bitmap is not changed
+bool Vram_Alloc(Bitmap* the_bitmap, uint32_t the_size)
+{
+	uint32_t	the_start;
+	int16_t		the_index;
+
+	if (the_bitmap == NULL)
+	{
+		LOG_ERR(("%s %d: passed bitmap was null", __func__ , __LINE__));
+		return false;
+	}
+
+	if (vram_heap_end == 0 || the_size == 0)
+	{
+		return false;
+	}
+
+	the_size = VRAM_ROUND_UP(the_size);
+
+	if (vram_num_blocks >= VRAM_MAX_BLOCKS || the_size > vram_heap_end - vram_heap_start - vram_in_use)
+	{
+		++vram_failures;
+		return false;
+	}
+
+	if (Vram_FindGap(the_size, &the_index, &the_start) == false)
+	{
+		// there's enough free in total (checked above), it's just in pieces
+		Vram_Compact();
+
+		if (Vram_FindGap(the_size, &the_index, &the_start) == false)
+		{
+			LOG_ERR(("%s %d: no VRAM gap for %lu bytes even after compacting", __func__ , __LINE__, the_size));
+			++vram_failures;
+			return false;
+		}
+	}
+
+	memmove(&vram_blocks[the_index + 1], &vram_blocks[the_index], (vram_num_blocks - the_index) * sizeof(VramBlock));
+	++vram_num_blocks;
+
+	vram_blocks[the_index].start_ = the_start;
+	vram_blocks[the_index].size_ = the_size;
+	vram_blocks[the_index].owner_ = the_bitmap;
+
+	vram_in_use += the_size;
+
+	if (vram_in_use > vram_high_water)
+	{
+		vram_high_water = vram_in_use;
+	}
+
+	the_bitmap->addr_int_ = the_start;
+	the_bitmap->addr_ = (unsigned char*)the_start;
+
+	return true;
+}
+
+
+//! Grow or shrink the bitmap's VRAM block, keeping the first keep_bytes of its contents
+//! The block grows in place if the space after it is free. If not, it moves to a free gap (compacting the heap first if needed), and the bitmap's address is updated.
+//! @param	the_bitmap -- a bitmap whose storage was allocated with Vram_Alloc()
+//! @param	the_size -- number of bytes needed
+//! @param	keep_bytes -- number of bytes at the start of the block to carry over if it has to move. Must be no more than the current block size.
+//! @return	Returns false if the bitmap does not own a VRAM block, or there is no room: the bitmap keeps its old block, and its contents
+bool Vram_Resize(Bitmap* the_bitmap, uint32_t the_size, uint32_t keep_bytes)
+{
+	VramBlock	the_block;
+	uint32_t	the_start;
+	int16_t		the_index;
+	int16_t		i;
+
+	if ((i = Vram_FindBlock(the_bitmap)) < 0)
+	{
+		LOG_ERR(("%s %d: bitmap %p does not own a VRAM block", __func__ , __LINE__, the_bitmap));
+		return false;
+	}
+
+	the_size = VRAM_ROUND_UP(the_size);
+
+	// LOGIC:
+	//   cheapest first: resize the block where it is, then move it to a gap that fits, then compact and try both again
+	//   the old block stays allocated until a new one is found, so a failed resize leaves the bitmap as it was
+
+	if (the_size > vram_heap_end - vram_heap_start - vram_in_use + vram_blocks[i].size_)
+	{
+		++vram_failures;
+		return false;
+	}
+
+	if (Vram_ResizeInPlace(i, the_size) == true)
+	{
+		return true;
+	}
+
+	if (Vram_FindGap(the_size, &the_index, &the_start) == false)
+	{
+		Vram_Compact();
+		i = Vram_FindBlock(the_bitmap);
+
+		if (Vram_ResizeInPlace(i, the_size) == true)
+		{
+			return true;
+		}
+
+		// the block would only fit by moving it past the others: not worth it, the caller can use standard RAM
+		if (Vram_FindGap(the_size, &the_index, &the_start) == false)
+		{
+			++vram_failures;
+			return false;
+		}
+	}
+
+	// the gap is outside the block, so the copy can't overlap
+	memcpy((void*)the_start, (void*)vram_blocks[i].start_, keep_bytes);
+
+	vram_in_use = vram_in_use - vram_blocks[i].size_ + the_size;
+
+	if (vram_in_use > vram_high_water)
+	{
+		vram_high_water = vram_in_use;
+	}
+
+	// take the block out of the table, and put it back in at its new address
+	the_block = vram_blocks[i];
+	the_block.start_ = the_start;
+	the_block.size_ = the_size;
+
+	--vram_num_blocks;
+	memmove(&vram_blocks[i], &vram_blocks[i + 1], (vram_num_blocks - i) * sizeof(VramBlock));
+
+	if (the_index > i)
+	{
+		--the_index;
+	}
+
+	memmove(&vram_blocks[the_index + 1], &vram_blocks[the_index], (vram_num_blocks - the_index) * sizeof(VramBlock));
+	++vram_num_blocks;
+	vram_blocks[the_index] = the_block;
+
+	the_bitmap->addr_int_ = the_start;
+	the_bitmap->addr_ = (unsigned char*)the_start;
+
+	return true;
+}
+
+
+//! Return the bitmap's VRAM block to the heap. The bitmap's address is not changed.
+//! @param	the_bitmap -- a bitmap whose storage was allocated with Vram_Alloc()
+//! @return	Returns false if the bitmap does not own a VRAM block
+bool Vram_Free(Bitmap* the_bitmap)
+{
+	int16_t		i;
+
+	if ((i = Vram_FindBlock(the_bitmap)) < 0)
+	{
+		LOG_ERR(("%s %d: bitmap %p does not own a VRAM block", __func__ , __LINE__, the_bitmap));
+		return false;
+	}
+
+	vram_in_use -= vram_blocks[i].size_;
+	--vram_num_blocks;
+	memmove(&vram_blocks[i], &vram_blocks[i + 1], (vram_num_blocks - i) * sizeof(VramBlock));
+
+	return true;
+}
+
+
+//! Slide all allocated blocks down to the start of the heap, so all free space is in one piece at the end. Owners' addresses are updated.
+void Vram_Compact(void)
+{
+	uint32_t	next_start;
+	int16_t		i;
+
+	// LOGIC:
+	//   blocks are sorted by address, so each one only ever moves down, into space already vacated: memmove copes with any overlap
+	//   the owning bitmap's address is updated on the spot. nothing else may keep a copy of a heap bitmap's address across an allocation.
+
+	next_start = vram_heap_start;
+
+	for (i = 0; i < vram_num_blocks; i++)
+	{
+		if (vram_blocks[i].start_ != next_start)
+		{
+			memmove((void*)next_start, (void*)vram_blocks[i].start_, vram_blocks[i].size_);
+
+			vram_blocks[i].start_ = next_start;
+			vram_blocks[i].owner_->addr_int_ = next_start;
+			vram_blocks[i].owner_->addr_ = (unsigned char*)next_start;
+		}
+
+		next_start += vram_blocks[i].size_;
+	}
+
+	++vram_compactions;
+}
+
+
+// **** STATS *****
+
+//! Get current usage, high-water mark, and fragmentation stats for the VRAM heap
+//! @param	the_stats -- filled with the current stats
+void Vram_GetStats(VramStats* the_stats)
+{
+	uint32_t	gap_start;
+	uint32_t	gap_end;
+	uint32_t	free_bytes;
+	int16_t		i;
+
+	if (the_stats == NULL)
+	{
+		LOG_ERR(("%s %d: passed stats struct was null", __func__ , __LINE__));
+		return;
+	}
+
+	the_stats->size_ = vram_heap_end - vram_heap_start;
+	the_stats->in_use_ = vram_in_use;
+	the_stats->high_water_ = vram_high_water;
+	the_stats->num_blocks_ = vram_num_blocks;
+	the_stats->compactions_ = vram_compactions;
+	the_stats->failures_ = vram_failures;
+	the_stats->largest_free_ = 0;
+	the_stats->fragmentation_ = 0;
+
+	if (vram_heap_end == 0)
+	{
+		return;
+	}
+
+	for (i = 0; i <= vram_num_blocks; i++)
+	{
+		gap_start = (i == 0 ? vram_heap_start : vram_blocks[i - 1].start_ + vram_blocks[i - 1].size_);
+		gap_end = (i == vram_num_blocks ? vram_heap_end : vram_blocks[i].start_);
+
+		if (gap_end - gap_start > the_stats->largest_free_)
+		{
+			the_stats->largest_free_ = gap_end - gap_start;
+		}
+	}
+
+	free_bytes = the_stats->size_ - vram_in_use;
+
+	if (free_bytes > 0)
+	{
+		// (scale down first: the heap is several MB, so free bytes * 100 could overflow 32 bits)
+		the_stats->fragmentation_ = 100 - (uint16_t)((the_stats->largest_free_ / VRAM_BLOCK_ALIGN * 100) / (free_bytes / VRAM_BLOCK_ALIGN));
+	}
+}
+
+
+//! Write usage stats for the VRAM heap to the allocation log. Does nothing unless LOG_LEVEL_5 is defined.
+void Vram_LogStats(void)
+{
+#ifdef LOG_LEVEL_5
+	VramStats	the_stats;
+
+	Vram_GetStats(&the_stats);
+
+	LOG_ALLOC(("%s %d:	__VRAM__	in use	%lu	high water	%lu	size	%lu	blocks	%u	largest free	%lu	fragmentation	%u%%	compactions	%lu	failures	%lu", __func__ , __LINE__, the_stats.in_use_, the_stats.high_water_, the_stats.size_, the_stats.num_blocks_, the_stats.largest_free_, the_stats.fragmentation_, the_stats.compactions_, the_stats.failures_));
+#endif
+}
@@ -0,0 +1,152 @@
+//! @file vram.h
+
+/*
+ * vram.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: agent
+ */
+
+#ifndef LIB_VRAM_H_
+#define LIB_VRAM_H_
+
+
+/* about this class: Vram
+ *
+ * Manages the VRAM not used by the screen's 2 bitmap layers as a heap for off-screen bitmaps (window and menu buffers)
+ * Keeping those buffers in VRAM frees up the (much smaller) system heap, and puts them in the same memory as the screen layers
+ *
+ * There is only one VRAM heap, so this class has no objects: Vram_Init() sets it up once, at system startup
+ * Each allocated block belongs to one Bitmap. The heap keeps a pointer to that bitmap, so that compacting the heap
+ *   can move the block and update the bitmap's address.
+ * Blocks are kept in a fixed table sorted by address: free space is the gaps between them.
+ * If a request doesn't fit in any gap, but would fit if the gaps were merged, the heap compacts itself and tries again.
+ * If it still doesn't fit, the request fails, and Bitmap_New uses system RAM for the bitmap instead.
+ *
+ *** things this class needs to be able to do
+ * hand out VRAM_BLOCK_ALIGN aligned blocks of VRAM to bitmaps
+ * take back blocks when a bitmap is destroyed
+ * grow or shrink a bitmap's block when it is resized, keeping its contents
+ * slide blocks together to merge free space
+ * report usage, high-water mark, and fragmentation
+ *
+ * STRETCH GOALS
+ * use VICKY/DMA for moving blocks when compacting
+ *
+ * SUPER STRETCH GOALS
+ *
+ *
+ */
+
+
+/*****************************************************************************/
+/*                                Includes                                   */
+/*****************************************************************************/
+
+// project includes
+
+// C includes
+#include <stdbool.h>
+#include <stdint.h>
+
+
+// A2560 includes
+#include <mcp/syscalls.h>
+#include "a2560k.h"
+
+
+/*****************************************************************************/
+/*                            Macro Definitions                              */
+/*****************************************************************************/
+
+#define VRAM_BLOCK_ALIGN		16		//!< every block starts on a multiple of this many bytes, and its size is rounded up to one. 68040 cache line size.
+#define VRAM_MAX_BLOCKS			64		//!< most blocks that can be allocated at once. an allocation beyond this fails (and the bitmap goes in system RAM)
+
+#define VRAM_SPRITE_AREA_LEN	0x4000	//!< bytes at the end of VRAM kept out of the heap for sprite images, which the VICKY needs at fixed addresses. See sprite.h.
+#define VRAM_SPRITE_AREA_START	((uint32_t)VRAM_START + (uint32_t)VRAM_LEN - VRAM_SPRITE_AREA_LEN)
+
+#define VRAM_HEAP_START			((uint32_t)VRAM_START + 2 * (uint32_t)VRAM_OFFSET_TO_NEXT_SCREEN)	//!< first byte after the 2 screen layers
+#define VRAM_HEAP_LEN			(VRAM_SPRITE_AREA_START - VRAM_HEAP_START)		//!< everything from there to the sprite image area at the end of VRAM
+
+
+/*****************************************************************************/
+/*                               Enumerations                                */
+/*****************************************************************************/
+
+
+
+/*****************************************************************************/
+/*                                 Structs                                   */
+/*****************************************************************************/
+
+struct VramStats
+{
+	uint32_t		size_;				//!< total bytes managed. 0 if Vram_Init() has not been called.
+	uint32_t		in_use_;			//!< bytes in allocated blocks
+	uint32_t		high_water_;		//!< most bytes ever in allocated blocks at once
+	uint32_t		largest_free_;		//!< bytes in the largest gap between blocks: the biggest block that could be allocated without compacting
+	uint16_t		num_blocks_;		//!< number of allocated blocks
+	uint16_t		fragmentation_;		//!< percent of free bytes that are not in the largest gap. 0 means all free space is in one piece.
+	uint32_t		compactions_;		//!< number of times the heap has been compacted
+	uint32_t		failures_;			//!< number of allocations that could not be satisfied (and went to system RAM instead)
+};
+
+
+
+/*****************************************************************************/
+/*                             Global Variables                              */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*                       Public Function Prototypes                          */
+/*****************************************************************************/
+
+
+// **** SETUP *****
+
+//! Set up the VRAM heap to manage the passed range of memory. Any blocks from a previous Vram_Init() are forgotten.
+//! @param	the_start -- address of the first byte of the heap, in the machine's global address space. Normally VRAM_HEAP_START.
+//! @param	the_len -- number of bytes in the heap. Normally VRAM_HEAP_LEN.
+//! @return	Returns false if the range is too small to be useful
+bool Vram_Init(uint32_t the_start, uint32_t the_len);
+
+
+// **** ALLOCATION *****
+
+//! Allocate a block of VRAM for a bitmap, and set the bitmap's address to it. The block is not cleared.
+//! If no gap is big enough, but the total free space is, the heap is compacted first: other bitmaps' blocks may move.
+//! @param	the_bitmap -- the bitmap that will own the block. Its addr_ and addr_int_ are set, and are updated if the block is ever moved.
+//! @param	the_size -- number of bytes needed
+//! @return	Returns false if the heap is not set up, or has no room: the bitmap is not changed
+bool Vram_Alloc(Bitmap* the_bitmap, uint32_t the_size);
+
+//! Grow or shrink the bitmap's VRAM block, keeping the first keep_bytes of its contents
+//! The block grows in place if the space after it is free. If not, it moves to a free gap (compacting the heap first if needed), and the bitmap's address is updated.
+//! @param	the_bitmap -- a bitmap whose storage was allocated with Vram_Alloc()
+//! @param	the_size -- number of bytes needed
+//! @param	keep_bytes -- number of bytes at the start of the block to carry over if it has to move. Must be no more than the current block size.
+//! @return	Returns false if the bitmap does not own a VRAM block, or there is no room: the bitmap keeps its old block, and its contents
+bool Vram_Resize(Bitmap* the_bitmap, uint32_t the_size, uint32_t keep_bytes);
+
+//! Return the bitmap's VRAM block to the heap. The bitmap's address is not changed.
+//! @param	the_bitmap -- a bitmap whose storage was allocated with Vram_Alloc()
+//! @return	Returns false if the bitmap does not own a VRAM block
+bool Vram_Free(Bitmap* the_bitmap);
+
+//! Slide all allocated blocks down to the start of the heap, so all free space is in one piece at the end. Owners' addresses are updated.
+void Vram_Compact(void);
+
+
+// **** STATS *****
+
+//! Get current usage, high-water mark, and fragmentation stats for the VRAM heap
+//! @param	the_stats -- filled with the current stats
+void Vram_GetStats(VramStats* the_stats);
+
+//! Write usage stats for the VRAM heap to the allocation log. Does nothing unless LOG_LEVEL_5 is defined.
+void Vram_LogStats(void);
+
+
+
+#endif /* LIB_VRAM_H_ */
@@ -0,0 +1,354 @@
+/*
+ * vram_test.c
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: agent
+ */
+
+
+
+
+
+
+/*****************************************************************************/
+/*                                Includes                                   */
+/*****************************************************************************/
+
+// unit testing framework
+#include "debug.h"
+#include "minunit.h"
+
+// project includes
+#include "bitmap.h"
+
+// class being tested
+#include "vram.h"
+
+// C includes
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+
+// A2560 includes
+#include "a2560k.h"
+
+
+
+/*****************************************************************************/
+/*                               Definitions                                 */
+/*****************************************************************************/
+
+#define VRAM_TEST_HEAP_SIZE		40000	//!< size of the stand-in VRAM heap: room for a few small bitmaps, so it can be filled up
+
+
+/*****************************************************************************/
+/*                               Enumerations                                */
+/*****************************************************************************/
+
+
+
+/*****************************************************************************/
+/*                             Global Variables                              */
+/*****************************************************************************/
+
+// LOGIC: the tests run the heap over a buffer in standard RAM, rather than real VRAM, so they don't scribble over the screen
+static uint8_t		test_vram[VRAM_TEST_HEAP_SIZE + VRAM_BLOCK_ALIGN];
+
+
+/*****************************************************************************/
+/*                       Private Function Prototypes                         */
+/*****************************************************************************/
+
+// returns true if every pixel of the bitmap is the passed color
+bool Test_BitmapIsAllColor(Bitmap* the_bitmap, uint8_t the_color);
+
+// returns true if the bitmap's storage is inside the test heap, and aligned
+bool Test_BitmapIsInTestHeap(Bitmap* the_bitmap);
+
+// color each row of the bitmap with its row number
+void Test_FillRowsWithRowNumber(Bitmap* the_bitmap);
+
+// returns true if the top-left width x height pixels of the bitmap still have their row number as their color
+bool Test_BitmapKeptRows(Bitmap* the_bitmap, int16_t width, int16_t height);
+
+
+/*****************************************************************************/
+/*                       Private Function Definitions                        */
+/*****************************************************************************/
+
+// returns true if every pixel of the bitmap is the passed color
+bool Test_BitmapIsAllColor(Bitmap* the_bitmap, uint8_t the_color)
+{
+	uint32_t	i;
+
+	for (i = 0; i < (uint32_t)the_bitmap->width_ * the_bitmap->height_; i++)
+	{
+		if (the_bitmap->addr_[i] != the_color)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+// returns true if the bitmap's storage is inside the test heap, and aligned
+bool Test_BitmapIsInTestHeap(Bitmap* the_bitmap)
+{
+	return (the_bitmap->addr_ >= test_vram && the_bitmap->addr_ + (uint32_t)the_bitmap->width_ * the_bitmap->height_ <= test_vram + sizeof(test_vram) && the_bitmap->addr_int_ % VRAM_BLOCK_ALIGN == 0 && the_bitmap->addr_int_ == (uint32_t)the_bitmap->addr_);
+}
+
+
+// color each row of the bitmap with its row number
+void Test_FillRowsWithRowNumber(Bitmap* the_bitmap)
+{
+	int16_t		y;
+
+	for (y = 0; y < the_bitmap->height_; y++)
+	{
+		memset(the_bitmap->addr_ + (uint32_t)y * the_bitmap->width_, (uint8_t)y, the_bitmap->width_);
+	}
+}
+
+
+// returns true if the top-left width x height pixels of the bitmap still have their row number as their color
+bool Test_BitmapKeptRows(Bitmap* the_bitmap, int16_t width, int16_t height)
+{
+	int16_t		x;
+	int16_t		y;
+
+	for (y = 0; y < height; y++)
+	{
+		for (x = 0; x < width; x++)
+		{
+			if (the_bitmap->addr_[(uint32_t)y * the_bitmap->width_ + x] != (uint8_t)y)
+			{
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+
+
+
+/*****************************************************************************/
+/*                        MinUnit Function Defintions                        */
+/*****************************************************************************/
+
+
+
+void test_setup(void)	// this is called EVERY test
+{
+	Vram_Init((uint32_t)test_vram, sizeof(test_vram));
+}
+
+
+void test_teardown(void)	// this is called EVERY test
+{
+
+}
+
+
+
+// **** unit tests
+
+MU_TEST(vram_alloc_test)
+{
+	Bitmap*		bitmap1;
+	Bitmap*		bitmap2;
+	Bitmap*		bitmap3;
+	Bitmap*		the_ram_bitmap;
+	VramStats	the_stats;
+
+	memset(test_vram, 0xFF, sizeof(test_vram));
+
+	bitmap1 = Bitmap_New(100, 100, NULL, PARAM_PREFER_VRAM);
+	bitmap2 = Bitmap_New(101, 99, NULL, PARAM_PREFER_VRAM);
+	mu_assert(bitmap1 != NULL && bitmap2 != NULL, "could not create bitmaps");
+
+	mu_check( bitmap1->in_vram_ == true && bitmap1->vram_block_ == true );
+	mu_check( Test_BitmapIsInTestHeap(bitmap1) );
+	mu_check( Test_BitmapIsInTestHeap(bitmap2) );
+	mu_check( Test_BitmapIsAllColor(bitmap1, 0) );
+	mu_check( Test_BitmapIsAllColor(bitmap2, 0) );
+
+	// blocks don't overlap
+	mu_check( bitmap1->addr_ + 100 * 100 <= bitmap2->addr_ || bitmap2->addr_ + 101 * 99 <= bitmap1->addr_ );
+
+	Vram_GetStats(&the_stats);
+	mu_assert_int_eq(2, the_stats.num_blocks_);
+	mu_assert_int_eq(10000 + 10000, the_stats.in_use_);		// 101 * 99 = 9999, rounded up to the block alignment
+
+	// heap is too full for this one: it goes in standard RAM
+	the_ram_bitmap = Bitmap_New(200, 110, NULL, PARAM_PREFER_VRAM);
+	mu_assert(the_ram_bitmap != NULL, "could not create bitmap");
+	mu_check( the_ram_bitmap->in_vram_ == false && the_ram_bitmap->vram_block_ == false );
+	mu_check( Test_BitmapIsAllColor(the_ram_bitmap, 0) );
+
+	Vram_GetStats(&the_stats);
+	mu_assert_int_eq(1, the_stats.failures_);
+
+	// destroying a VRAM bitmap gives its block back
+	Bitmap_Destroy(&bitmap1);
+	bitmap3 = Bitmap_New(100, 100, NULL, PARAM_PREFER_VRAM);
+	mu_check( bitmap3->vram_block_ == true );
+	mu_check( Test_BitmapIsInTestHeap(bitmap3) );
+
+	Bitmap_Destroy(&bitmap2);
+	Bitmap_Destroy(&bitmap3);
+	Bitmap_Destroy(&the_ram_bitmap);
+
+	Vram_GetStats(&the_stats);
+	mu_assert_int_eq(0, the_stats.num_blocks_);
+	mu_assert_int_eq(0, the_stats.in_use_);
+	mu_assert_int_eq(20000, the_stats.high_water_);
+	mu_assert_int_eq(the_stats.size_, the_stats.largest_free_);
+	mu_assert_int_eq(0, the_stats.fragmentation_);
+}
+
+
+MU_TEST(vram_compact_test)
+{
+	Bitmap*		the_bitmaps[4];
+	Bitmap*		the_big_bitmap;
+	VramStats	the_stats;
+	int16_t		i;
+
+	// fill the heap with 4 bitmaps, then free the 1st and 3rd: half the heap is free, but in 2 pieces
+	for (i = 0; i < 4; i++)
+	{
+		the_bitmaps[i] = Bitmap_New(100, 96, NULL, PARAM_PREFER_VRAM);
+		mu_check( the_bitmaps[i]->vram_block_ == true );
+		Bitmap_FillMemory(the_bitmaps[i], i + 1);
+	}
+
+	Bitmap_Destroy(&the_bitmaps[0]);
+	Bitmap_Destroy(&the_bitmaps[2]);
+
+	Vram_GetStats(&the_stats);
+	mu_check( the_stats.fragmentation_ > 0 );
+	mu_assert_int_eq(0, the_stats.compactions_);
+
+	// this only fits if the 2 free pieces are joined: the heap compacts, moving the other bitmaps, and their pixels go with them
+	the_big_bitmap = Bitmap_New(100, 150, NULL, PARAM_PREFER_VRAM);
+	mu_check( the_big_bitmap->vram_block_ == true );
+	mu_check( Test_BitmapIsInTestHeap(the_big_bitmap) );
+
+	Vram_GetStats(&the_stats);
+	mu_assert_int_eq(1, the_stats.compactions_);
+	mu_assert_int_eq(0, the_stats.failures_);
+
+	mu_check( Test_BitmapIsInTestHeap(the_bitmaps[1]) );
+	mu_check( Test_BitmapIsInTestHeap(the_bitmaps[3]) );
+	mu_check( Test_BitmapIsAllColor(the_bitmaps[1], 2) );
+	mu_check( Test_BitmapIsAllColor(the_bitmaps[3], 4) );
+	mu_check( Test_BitmapIsAllColor(the_big_bitmap, 0) );
+
+	// growing a VRAM bitmap past what's free moves it to standard RAM
+	mu_check( Bitmap_Resize(the_bitmaps[1], 200, 120) == true );
+	mu_check( the_bitmaps[1]->in_vram_ == false && the_bitmaps[1]->vram_block_ == false );
+	Bitmap_FillMemory(the_bitmaps[1], 9);
+	mu_check( Test_BitmapIsAllColor(the_bitmaps[1], 9) );
+
+	// ...and shrinking one keeps its block
+	mu_check( Bitmap_Resize(the_bitmaps[3], 50, 50) == true );
+	mu_check( the_bitmaps[3]->vram_block_ == true );
+
+	Bitmap_Destroy(&the_bitmaps[1]);
+	Bitmap_Destroy(&the_bitmaps[3]);
+	Bitmap_Destroy(&the_big_bitmap);
+
+	Vram_GetStats(&the_stats);
+	mu_assert_int_eq(0, the_stats.in_use_);
+}
+
+
+MU_TEST(vram_resize_test)
+{
+	Bitmap*			the_bitmap;
+	Bitmap*			the_neighbor;
+	unsigned char*	the_addr;
+	VramStats		the_stats;
+
+	the_bitmap = Bitmap_New(100, 100, NULL, PARAM_PREFER_VRAM);
+	the_neighbor = Bitmap_New(100, 100, NULL, PARAM_PREFER_VRAM);
+	mu_assert(the_bitmap != NULL && the_neighbor != NULL, "could not create bitmaps");
+	Test_FillRowsWithRowNumber(the_bitmap);
+
+	// the neighbor's block is right after it, so growing means moving: the pixels go along
+	the_addr = the_bitmap->addr_;
+	mu_check( Bitmap_Resize(the_bitmap, 110, 100) == true );
+	mu_check( the_bitmap->vram_block_ == true );
+	mu_check( the_bitmap->addr_ != the_addr );
+	mu_check( Test_BitmapIsInTestHeap(the_bitmap) );
+	mu_check( Test_BitmapKeptRows(the_bitmap, 100, 100) );
+
+	// with the neighbor gone, the block can grow where it is
+	Bitmap_Destroy(&the_neighbor);
+	the_addr = the_bitmap->addr_;
+	mu_check( Bitmap_Resize(the_bitmap, 150, 100) == true );
+	mu_check( the_bitmap->addr_ == the_addr );
+	mu_check( Test_BitmapKeptRows(the_bitmap, 100, 100) );
+
+	Vram_GetStats(&the_stats);
+	mu_assert_int_eq(1, the_stats.num_blocks_);
+	mu_check( the_stats.in_use_ >= the_bitmap->capacity_ && the_stats.in_use_ < the_bitmap->capacity_ + VRAM_BLOCK_ALIGN );
+
+	Bitmap_Destroy(&the_bitmap);
+}
+
+
+MU_TEST(vram_no_heap_test)
+{
+	Bitmap*		the_bitmap;
+
+	// with no heap set up, everything goes in standard RAM
+	mu_check( Vram_Init(0, 0) == false );
+
+	the_bitmap = Bitmap_New(100, 100, NULL, PARAM_PREFER_VRAM);
+	mu_assert(the_bitmap != NULL, "could not create bitmap");
+	mu_check( the_bitmap->in_vram_ == false && the_bitmap->vram_block_ == false );
+
+	Bitmap_Destroy(&the_bitmap);
+}
+
+
+
+// unit tests
+MU_TEST_SUITE(test_suite_units)
+{
+	MU_SUITE_CONFIGURE(&test_setup, &test_teardown);
+
+	MU_RUN_TEST(vram_alloc_test);
+	MU_RUN_TEST(vram_compact_test);
+	MU_RUN_TEST(vram_resize_test);
+	MU_RUN_TEST(vram_no_heap_test);
+}
+
+
+
+
+
+/*****************************************************************************/
+/*                        Public Function Definitions                        */
+/*****************************************************************************/
+
+
+
+int main(int argc, char* argv[])
+{
+	printf("**** vram.c Test Suite **** \n");
+
+	MU_RUN_SUITE(test_suite_units);
+	MU_REPORT();
+
+	printf("vram test complete \n");
+
+	return MU_EXIT_CODE;
+}
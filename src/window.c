@@ -17,8 +17,10 @@
 #include "bitmap.h"
 #include "control.h"
 #include "debug.h"
+#include "event.h"
 #include "font.h"
 #include "general.h"
+#include "region.h"
 #include "sys.h"
 #include "theme.h"
 #include "window.h"
@@ -110,6 +112,77 @@ static void Window_DrawTitlebar(Window* the_window);
 //! @param	the_window -- a valid pointer to a Window
 static void Window_DrawTitle(Window* the_window);
 
+//! Mark every control that overlaps the passed rect as needing to be redrawn
+//! @param	the_window -- a valid pointer to a Window
+//! @param	the_rect -- window-local rect
+static void Window_InvalidateControlsInRect(Window* the_window, Rectangle* the_rect);
+
+//! Redraw the part of the content area within the passed rect: clear it, replay the draw batch into it, and queue it to be blitted
+//! Controls that overlap it are marked to be redrawn on top
+//! @param	the_window -- a valid pointer to a Window, with a valid bitmap
+//! @param	the_rect -- window-local rect. Only the part of it within the content area is redrawn.
+static void Window_RefreshContentRect(Window* the_window, Rectangle* the_rect);
+
+//! After a resize, redraw only the parts of the window that the resize changed, keeping the rest of what's in the bitmap
+//! @param	the_window -- a valid pointer to a Window, already resized, with its structure rects configured for the new size
+//! @param	the_old_overall_rect -- the window's overall rect before the resize
+//! @param	the_old_content_rect -- the window's content rect before the resize
+//! @return:	Returns false if nothing from before the resize could be kept: the caller must invalidate the whole window
+static bool Window_RedrawResizedArea(Window* the_window, Rectangle* the_old_overall_rect, Rectangle* the_old_content_rect);
+
+//! Split the part of the outer rect not covered by the inner rect into up to 4 bands: the full width above and below the inner rect, and the 2 sides between them
+//! @param	the_outer -- the containing rect
+//! @param	the_inner -- a rect within the_outer
+//! @param	the_bands -- array of 4 rects to receive the bands
+//! @return:	Returns the number of bands written to the_bands
+static int16_t Window_CalculateBands(Rectangle* the_outer, Rectangle* the_inner, Rectangle* the_bands);
+
+//! Mark an area changed by one of the drawing functions so it gets blitted in the next render, and ask for a render
+//! @param	the_window -- a valid pointer to a Window, with a valid bitmap
+//! @param	x1 -- horizontal bitmap coordinate of one corner of the area. Corners are inclusive, and can be passed in either order.
+//! @param	y1 -- vertical bitmap coordinate of the same corner
+//! @param	x2 -- horizontal bitmap coordinate of the opposite corner
+//! @param	y2 -- vertical bitmap coordinate of the opposite corner
+static void Window_AddDirtyRect(Window* the_window, int16_t x1, int16_t y1, int16_t x2, int16_t y2);
+
+
+
+// **** Private BATCH DRAW functions *****
+
+//! Draw every command in the window's batch, clipped to the content area
+//! @param	the_window -- a valid pointer to a Window, with a valid bitmap
+//! @param	the_limit -- optional window-local rect to further limit drawing to (eg, the part of the content area uncovered by a resize). Pass NULL to draw the whole content area.
+//! @param	the_dirty_rect -- receives the window-local bounding rect of everything drawn. If nothing was drawn, MaxX will be less than MinX.
+static void Window_RunBatch(Window* the_window, Rectangle* the_limit, Rectangle* the_dirty_rect);
+
+//! Limit a rect to the area it shares with the clip rect
+//! @return:	Returns false if the rects do not overlap (the rect is left unchanged)
+static bool Window_ClipBatchRect(Rectangle* the_rect, Rectangle* the_clip);
+
+//! Fill a rect that is already known to be within the bitmap, one memset per row
+static void Window_BatchFillRect(Bitmap* the_bitmap, Rectangle* the_rect, uint8_t the_color);
+
+
+
+// **** Private SCROLLING functions *****
+
+//! Get the part of the content area that scrolls: the content area, less any scrollers showing along its edges
+//! @param	the_window -- a valid pointer to a Window
+//! @param	the_rect -- receives the window-local rect
+static void Window_GetScrollRect(Window* the_window, Rectangle* the_rect);
+
+//! Show the scrollers the content size needs, fit them to the content area, and keep the scroll position within range
+//! Scrollers are created from the theme's templates the first time they are needed. With a theme that has no scroller templates, the window scrolls without them.
+//! @param	the_window -- a valid pointer to a Window
+//! @param	do_refresh -- if true, content area that a scroller moved off of or was hidden from is redrawn
+//! @return:	Returns true if the scroll position had to change to stay in range: the caller must redraw the content area
+static bool Window_LayoutScrollers(Window* the_window, bool do_refresh);
+
+//! Ask the window's event handler to redraw part of the content area, by posting an updateEvt for it
+//! @param	the_window -- a valid pointer to a Window
+//! @param	the_rect -- window-local rect. It is posted relative to the content area.
+static void Window_PostUpdate(Window* the_window, Rectangle* the_rect);
+
 
 /*****************************************************************************/
 /*                       Private Function Definitions                        */
@@ -395,6 +468,17 @@ void Window_UpdateControlTheme(Window* the_window)
 		{
 			the_template = Theme_GetMaximizeControlTemplate(the_theme);
 		}
+		else if (the_control->id_ == H_SCROLLER_WIDGET_ID || the_control->id_ == V_SCROLLER_WIDGET_ID)
+		{
+			the_template = (the_control->id_ == H_SCROLLER_WIDGET_ID ? Theme_GetHScrollerControlTemplate(the_theme) : Theme_GetVScrollerControlTemplate(the_theme));
+			
+			// a theme without scrollers leaves the old ones in place: Window_LayoutScrollers() will hide them
+			if (the_template == NULL)
+			{
+				the_control = the_control->next_;
+				continue;
+			}
+		}
 		else if (the_control->type_ == TEXT_BUTTON)
 		{
 			int16_t		new_height = the_theme->flex_width_backdrops_[TEXT_BUTTON].height_;
@@ -413,6 +497,9 @@ void Window_UpdateControlTheme(Window* the_window)
 		the_control = the_control->next_;
 	}
 	
+	// the new theme's scrollers may be a different size
+	Window_LayoutScrollers(the_window, false);
+	
 	// TODO: maybe add a Theme_GetXXControl() function that takes one of the widget IDs. 
 	// that could let above just be iteration. 
 
@@ -610,7 +697,12 @@ static void Window_DrawControls(Window* the_window, bool force_redraw)
 	while (this_control)
 	{
 		this_control->enabled_ = true;
-		this_control->visible_ = true;
+		
+		// scrollers come and go with the content size: Window_LayoutScrollers() decides if they show
+		if (this_control->id_ != H_SCROLLER_WIDGET_ID && this_control->id_ != V_SCROLLER_WIDGET_ID)
+		{
+			this_control->visible_ = true;
+		}
 	
 		if (force_redraw)
 		{
@@ -747,217 +839,899 @@ error:
 }
 
 
-// **** Debug functions *****
-
-void Window_Print(Window* the_window)
+//! Mark every control that overlaps the passed rect as needing to be redrawn
+//! @param	the_window -- a valid pointer to a Window
+//! @param	the_rect -- window-local rect
+static void Window_InvalidateControlsInRect(Window* the_window, Rectangle* the_rect)
 {
-	DEBUG_OUT(("Window print out:"));
-	DEBUG_OUT(("  address: %p", 		the_window));
-	DEBUG_OUT(("  id_: %i", 			the_window->id_));
-	DEBUG_OUT(("  display_order_: %i", 	the_window->display_order_));
-	DEBUG_OUT(("  user_data_: %i",		the_window->user_data_));
-	DEBUG_OUT(("  title_: '%s'",		the_window->title_));
-	DEBUG_OUT(("  state_: %i",			the_window->state_));
-	DEBUG_OUT(("  bitmap_: %p",			the_window->bitmap_));
-	DEBUG_OUT(("  buffer_bitmap_: %p",	the_window->buffer_bitmap_));
-	DEBUG_OUT(("  overall_rect_: %i, %i, %i, %i", the_window->overall_rect_.MinX, the_window->overall_rect_.MinY, the_window->overall_rect_.MaxX, the_window->overall_rect_.MaxY));
-	DEBUG_OUT(("  titlebar_rect_: %i, %i, %i, %i", the_window->titlebar_rect_.MinX, the_window->titlebar_rect_.MinY, the_window->titlebar_rect_.MaxX, the_window->titlebar_rect_.MaxY));
-	DEBUG_OUT(("  iconbar_rect_: %i, %i, %i, %i", the_window->iconbar_rect_.MinX, the_window->iconbar_rect_.MinY, the_window->iconbar_rect_.MaxX, the_window->iconbar_rect_.MaxY));
-	DEBUG_OUT(("  content_rect_: %i, %i, %i, %i", the_window->content_rect_.MinX, the_window->content_rect_.MinY, the_window->content_rect_.MaxX, the_window->content_rect_.MaxY));
-	DEBUG_OUT(("  grow_left_rect_: %i, %i, %i, %i", the_window->grow_left_rect_.MinX, the_window->grow_left_rect_.MinY, the_window->grow_left_rect_.MaxX, the_window->grow_left_rect_.MaxY));
-	DEBUG_OUT(("  grow_right_rect_: %i, %i, %i, %i", the_window->grow_right_rect_.MinX, the_window->grow_right_rect_.MinY, the_window->grow_right_rect_.MaxX, the_window->grow_right_rect_.MaxY));
-	DEBUG_OUT(("  grow_top_rect_: %i, %i, %i, %i", the_window->grow_top_rect_.MinX, the_window->grow_top_rect_.MinY, the_window->grow_top_rect_.MaxX, the_window->grow_top_rect_.MaxY));
-	DEBUG_OUT(("  grow_bottom_rect_: %i, %i, %i, %i", the_window->grow_bottom_rect_.MinX, the_window->grow_bottom_rect_.MinY, the_window->grow_bottom_rect_.MaxX, the_window->grow_bottom_rect_.MaxY));
-	DEBUG_OUT(("  show_iconbar_: %i",	the_window->show_iconbar_));
-	DEBUG_OUT(("  is_backdrop_: %i",	the_window->is_backdrop_));
-	DEBUG_OUT(("  visible_: %i",		the_window->visible_));
-	DEBUG_OUT(("  active_: %i",			the_window->active_));
-	DEBUG_OUT(("  changes_to_save_: %i",	the_window->changes_to_save_));
-	DEBUG_OUT(("  can_resize_: %i",		the_window->can_resize_));	
-	DEBUG_OUT(("  x_: %i",				the_window->x_));	
-	DEBUG_OUT(("  y_: %i",				the_window->y_));	
-	DEBUG_OUT(("  width_: %i",			the_window->width_));	
-	DEBUG_OUT(("  height_: %i",			the_window->height_));	
-	DEBUG_OUT(("  min_width_: %i",		the_window->min_width_));	
-	DEBUG_OUT(("  min_height_: %i",		the_window->min_height_));	
-	DEBUG_OUT(("  max_width_: %i",		the_window->max_width_));	
-	DEBUG_OUT(("  max_height_: %i",		the_window->max_height_));	
-	DEBUG_OUT(("  inner_width_: %i",	the_window->inner_width_));	
-	DEBUG_OUT(("  inner_height_: %i",	the_window->inner_height_));	
-	DEBUG_OUT(("  avail_title_width_: %i",	the_window->avail_title_width_));	
-	DEBUG_OUT(("  content_left_: %i",	the_window->content_left_));	
-	DEBUG_OUT(("  content_top_: %i",	the_window->content_top_));	
-	DEBUG_OUT(("  required_inner_width_: %i",		the_window->required_inner_width_));	
-	DEBUG_OUT(("  required_inner_height_: %i",		the_window->required_inner_height_));	
-	DEBUG_OUT(("  h_scroller_visible_: %i",			the_window->h_scroller_visible_));	
-	DEBUG_OUT(("  v_scroller_visible_: %i",			the_window->v_scroller_visible_));	
-	DEBUG_OUT(("  pattern_: %p",		the_window->pattern_));	
-	DEBUG_OUT(("  parent_window_: %p",	the_window->parent_window_));	
-	DEBUG_OUT(("  child_window_: %p",	the_window->child_window_));	
-	DEBUG_OUT(("  root_control_: %p",	the_window->root_control_));	
+	Control*	the_control;
+
+	the_control = Window_GetRootControl(the_window);
+
+	while (the_control)
+	{
+		if (General_RectIntersect(the_control->rect_, *the_rect) == true)
+		{
+			Control_MarkInvalidated(the_control, true);
+		}
+		
+		the_control = the_control->next_;
+	}
 }
 
 
-// helper function called by List class's print function: prints one window entry
-void Window_PrintBrief(void* the_payload)
+//! Redraw the part of the content area within the passed rect: clear it, replay the draw batch into it, and queue it to be blitted
+//! Controls that overlap it are marked to be redrawn on top
+//! @param	the_window -- a valid pointer to a Window, with a valid bitmap
+//! @param	the_rect -- window-local rect. Only the part of it within the content area is redrawn.
+static void Window_RefreshContentRect(Window* the_window, Rectangle* the_rect)
 {
-	Window*		this_window = (Window*)(the_payload);
+	Theme*		the_theme;
+	Rectangle	the_area;
+	Rectangle	the_batch_rect;
 
-	DEBUG_OUT(("%s %d: %s (%p, %i)", __func__ , __LINE__, (this_window->is_backdrop_ == false ? this_window->title_ : (char*)"Backdrop"), this_window, this_window->display_order_ ));
+	if (General_CalculateRectIntersection(the_rect, &the_window->content_rect_, &the_area) == false)
+	{
+		return;
+	}
+	
+	the_theme = Sys_GetTheme(global_system);
 
+	Window_BatchFillRect(the_window->bitmap_, &the_area, Theme_GetContentAreaColor(the_theme));
+	
+	if (the_window->batch_open_ == false)
+	{
+		Window_RunBatch(the_window, &the_area, &the_batch_rect);
+	}
+	
+	Window_AddClipRect(the_window, &the_area);
+	Window_InvalidateControlsInRect(the_window, &the_area);
 }
 
 
-/*****************************************************************************/
-/*                        Public Function Definitions                        */
-/*****************************************************************************/
-
-// **** CONSTRUCTOR AND DESTRUCTOR *****
-
-// constructor
-//! Allocate a Window object
-//! the_win_template->width_: cannot be smaller than WIN_DEFAULT_MIN_WIDTH, cannot be greater than WIN_DEFAULT_MAX_WIDTH
-//! the_win_template->height_: cannot be smaller than WIN_DEFAULT_MIN_HEIGHT, cannot be greater than WIN_DEFAULT_MAX_HEIGHT
-//! the_win_template->min_width_: cannot be smaller than WIN_DEFAULT_MIN_WIDTH
-//! the_win_template->min_height_: cannot be smaller than WIN_DEFAULT_MIN_HEIGHT
-//! the_win_template->max_width_: cannot be smaller than WIN_DEFAULT_MIN_WIDTH
-//! the_win_template->max_height_: cannot be smaller than WIN_DEFAULT_MIN_HEIGHT
-//! @param	the_win_template -- a populated new window template whose data will be used to create the new window object
-//! @param	event_handler -- pointer to the function that will handle all events for the window. This function will be called when the system detects an event associated with the window.
-Window* Window_New(NewWinTemplate* the_win_template, void (* event_handler)(EventRecord*))
+//! After a resize, redraw only the parts of the window that the resize changed, keeping the rest of what's in the bitmap
+//! @param	the_window -- a valid pointer to a Window, already resized, with its structure rects configured for the new size
+//! @param	the_old_overall_rect -- the window's overall rect before the resize
+//! @param	the_old_content_rect -- the window's content rect before the resize
+//! @return:	Returns false if nothing from before the resize could be kept: the caller must invalidate the whole window
+static bool Window_RedrawResizedArea(Window* the_window, Rectangle* the_old_overall_rect, Rectangle* the_old_content_rect)
 {
-	Window*		the_window = NULL;
 	Theme*		the_theme;
-	Control*	close_control;
-	Control*	minimize_control;
-	Control*	normsize_control;
-	Control*	maximize_control;
-		
-	// LOGIC: 
-	//   Only a few parameter values can be so bad that the window creation process must terminate
-	//   The offscreen bitmap can be NULL and be ok
-	//   The main bitmap can also be NULL, and if so, a new one will be allocated
-	//     If the new window is going to be a backdrop window, however, it will be assigned the system screen's bitmap
-	//   The size parameters can be adjusted to match system mins and maxs.
+	Rectangle	the_kept_rect;
+	Rectangle	the_inner_rect;
+	Rectangle	the_bands[4];
+	int16_t		num_bands;
+	int16_t		i;
+
+	// LOGIC:
+	//   Bitmap_Resize kept the top-left of the window's pixels. The part of that which was content, and still is, is good as it is:
+	//     unless it was under the old border, or is under the new one. (the content area runs under the right border)
+	//   everything else in the window is the band around that kept rect. all of it gets blitted:
+	//     the content part of it is cleared and has the draw batch replayed into it
+	//     the border is redrawn (it's only 4 lines)
+	//     the titlebar is only redrawn if the caller invalidated it (it changed width, or moved). otherwise its pixels were kept.
+	//     controls in the band are redrawn by the next render pass
 	
-	if ( the_win_template == NULL)
+	the_theme = Sys_GetTheme(global_system);
+
+	the_inner_rect.MinX = the_old_overall_rect->MinX + 1;
+	the_inner_rect.MinY = the_old_overall_rect->MinY + 1;
+	the_inner_rect.MaxX = the_old_overall_rect->MaxX - 1;
+	the_inner_rect.MaxY = the_old_overall_rect->MaxY - 1;
+	
+	if (General_CalculateRectIntersection(the_old_content_rect, &the_window->content_rect_, &the_kept_rect) == false || 
+		General_CalculateRectIntersection(&the_kept_rect, &the_inner_rect, &the_kept_rect) == false)
 	{
-		LOG_ERR(("%s %d: passed NewWinTemplate was NULL", __func__ , __LINE__));
-		goto error;
+		return false;
 	}
 	
-	if ( (the_theme = Sys_GetTheme(global_system)) == NULL)
+	the_inner_rect.MinX = the_window->overall_rect_.MinX + 1;
+	the_inner_rect.MinY = the_window->overall_rect_.MinY + 1;
+	the_inner_rect.MaxX = the_window->overall_rect_.MaxX - 1;
+	the_inner_rect.MaxY = the_window->overall_rect_.MaxY - 1;
+	
+	if (General_CalculateRectIntersection(&the_kept_rect, &the_inner_rect, &the_kept_rect) == false)
 	{
-		LOG_ERR(("%s %d: failed to get the current system theme!", __func__ , __LINE__));
-		goto error;
+		return false;
 	}
 	
-	DEBUG_OUT(("%s %d: x=%i, y=%i, width=%i", __func__, __LINE__, the_win_template->x_, the_win_template->y_, the_win_template->width_));
+	num_bands = Window_CalculateBands(&the_window->content_rect_, &the_kept_rect, the_bands);
 	
-	if ( (the_window = (Window*)calloc(1, sizeof(Window)) ) == NULL)
+	for (i = 0; i < num_bands; i++)
 	{
-		LOG_ERR(("%s %d: could not allocate memory to create new Window", __func__ , __LINE__));
-		goto error;
+		Window_RefreshContentRect(the_window, &the_bands[i]);
 	}
-	LOG_ALLOC(("%s %d:	__ALLOC__	the_window	%p	size	%i", __func__ , __LINE__, the_window, sizeof(Window)));
-	TRACK_ALLOC((sizeof(Window)));
 	
-	if ( (the_window->title_ = General_StrlcpyWithAlloc(the_win_template->title_, WINDOW_MAX_WINTITLE_SIZE)) == NULL)
+	Bitmap_DrawBoxRect(the_window->bitmap_, &the_window->overall_rect_, Theme_GetOutlineColor(the_theme));
+	
+	num_bands = Window_CalculateBands(&the_window->overall_rect_, &the_kept_rect, the_bands);
+	
+	for (i = 0; i < num_bands; i++)
 	{
-		LOG_ERR(("%s %d: could not allocate memory for the window name string", __func__ , __LINE__));
-		goto error;
+		Window_AddClipRect(the_window, &the_bands[i]);
+		Window_InvalidateControlsInRect(the_window, &the_bands[i]);
 	}
-	LOG_ALLOC(("%s %d:	__ALLOC__	the_window->title_	%p	size	%i		'%s'", __func__ , __LINE__, the_window->title_, General_Strnlen(the_window->title_, WINDOW_MAX_WINTITLE_SIZE) + 1, the_window->title_));
-	TRACK_ALLOC((General_Strnlen(the_window->title_, WINDOW_MAX_WINTITLE_SIZE) + 1));
 	
-	// do check on the height, max height, min height, etc. 
-	Window_CheckDimensions(the_window, the_win_template);
+	return true;
+}
 
-	// assign the bitmap passed by win_setup, or allocate a new one
-	if ( the_win_template->bitmap_ == NULL)
+
+//! Split the part of the outer rect not covered by the inner rect into up to 4 bands: the full width above and below the inner rect, and the 2 sides between them
+//! @param	the_outer -- the containing rect
+//! @param	the_inner -- a rect within the_outer
+//! @param	the_bands -- array of 4 rects to receive the bands
+//! @return:	Returns the number of bands written to the_bands
+static int16_t Window_CalculateBands(Rectangle* the_outer, Rectangle* the_inner, Rectangle* the_bands)
+{
+	int16_t		num_bands = 0;
+	
+	if (the_inner->MinY > the_outer->MinY)
 	{
-		if ( (the_window->bitmap_ = Bitmap_New(the_win_template->width_, the_win_template->height_, Sys_GetAppFont(global_system), PARAM_NOT_IN_VRAM)) == NULL)
-		{
-			LOG_ERR(("%s %d: Failed to create bitmap", __func__, __LINE__));
-			goto error;
-		}
+		the_bands[num_bands].MinX = the_outer->MinX;
+		the_bands[num_bands].MinY = the_outer->MinY;
+		the_bands[num_bands].MaxX = the_outer->MaxX;
+		the_bands[num_bands].MaxY = the_inner->MinY - 1;
+		++num_bands;
 	}
-	else
+	
+	if (the_inner->MaxY < the_outer->MaxY)
 	{
-		the_window->bitmap_ = the_win_template->bitmap_;
+		the_bands[num_bands].MinX = the_outer->MinX;
+		the_bands[num_bands].MinY = the_inner->MaxY + 1;
+		the_bands[num_bands].MaxX = the_outer->MaxX;
+		the_bands[num_bands].MaxY = the_outer->MaxY;
+		++num_bands;
 	}
 	
-	the_window->x_ = the_win_template->x_;
-	the_window->y_ = the_win_template->y_;
-	the_window->width_ = the_win_template->width_;
-	the_window->height_ = the_win_template->height_;
-	the_window->norm_x_ = the_win_template->x_;
-	the_window->norm_y_ = the_win_template->y_;
-	the_window->norm_width_ = the_win_template->width_;
-	the_window->norm_height_ = the_win_template->height_;
-	the_window->global_rect_.MinX = the_window->x_;
-	the_window->global_rect_.MaxX = (the_window->x_ + the_window->width_) - 1;
-	the_window->global_rect_.MinY = the_window->y_;
-	the_window->global_rect_.MaxY = (the_window->y_ + the_window->height_) - 1;
-	the_window->min_width_ = the_win_template->min_width_;
-	the_window->min_height_ = the_win_template->min_height_;
-	the_window->max_width_ = the_win_template->max_width_;
-	the_window->max_height_ = the_win_template->max_height_;
-
-	the_window->user_data_ = the_win_template->user_data_;
-	the_window->buffer_bitmap_ = the_win_template->buffer_bitmap_;
-	the_window->show_iconbar_ = the_win_template->show_iconbar_;
-	the_window->is_backdrop_ = the_win_template->is_backdrop_;
-	the_window->can_resize_ = the_win_template->can_resize_;
-	the_window->clip_count_ = 0;
-	the_window->event_handler_ = event_handler;
-	the_window->selected_control_ = NULL;
+	if (the_inner->MinX > the_outer->MinX)
+	{
+		the_bands[num_bands].MinX = the_outer->MinX;
+		the_bands[num_bands].MinY = the_inner->MinY;
+		the_bands[num_bands].MaxX = the_inner->MinX - 1;
+		the_bands[num_bands].MaxY = the_inner->MaxY;
+		++num_bands;
+	}
 	
-	// set up the rects for titlebar, content, etc. 
-	Window_ConfigureStructureRects(the_window);
+	if (the_inner->MaxX < the_outer->MaxX)
+	{
+		the_bands[num_bands].MinX = the_inner->MaxX + 1;
+		the_bands[num_bands].MinY = the_inner->MinY;
+		the_bands[num_bands].MaxX = the_outer->MaxX;
+		the_bands[num_bands].MaxY = the_inner->MaxY;
+		++num_bands;
+	}
+	
+	return num_bands;
+}
 
-	if (the_window->can_resize_)
+
+//! Mark an area changed by one of the drawing functions so it gets blitted in the next render, and ask for a render
+//! @param	the_window -- a valid pointer to a Window, with a valid bitmap
+//! @param	x1 -- horizontal bitmap coordinate of one corner of the area. Corners are inclusive, and can be passed in either order.
+//! @param	y1 -- vertical bitmap coordinate of the same corner
+//! @param	x2 -- horizontal bitmap coordinate of the opposite corner
+//! @param	y2 -- vertical bitmap coordinate of the opposite corner
+static void Window_AddDirtyRect(Window* the_window, int16_t x1, int16_t y1, int16_t x2, int16_t y2)
+{
+	Rectangle	the_rect;
+	
+	// LOGIC:
+	//   the area is the bounding box of the drawing call, trimmed to the bitmap. it can be a little bigger than what was actually drawn, never smaller.
+	//   if the whole window is going to be blitted anyway, there is nothing to add.
+	
+	if (the_window->invalidated_)
 	{
-		// window can be resized, so needs drag zones to be established
-		Window_ConfigureDragRects(the_window);
+		return;
 	}
 	
-	// all windows start off non-visible
-	the_window->visible_ = false;
+	the_rect.MinX = (x1 < x2 ? x1 : x2);
+	the_rect.MaxX = (x1 < x2 ? x2 : x1);
+	the_rect.MinY = (y1 < y2 ? y1 : y2);
+	the_rect.MaxY = (y1 < y2 ? y2 : y1);
 	
-	// all windows start out as invalidated, so that they are rendered fully next render pass
-	the_window->invalidated_ = true;
-	the_window->titlebar_invalidated_ = true;
+	if (the_rect.MinX < 0)
+	{
+		the_rect.MinX = 0;
+	}
 	
-	// pen location starts at 0,0 (relative to content area, not to window rect)
-	the_window->pen_x_ = 0;
-	the_window->pen_y_ = 0;
+	if (the_rect.MinY < 0)
+	{
+		the_rect.MinY = 0;
+	}
 	
-	// add the base controls (not needed for backdrops -- we don't want user to be able to close a backdrop)
+	if (the_rect.MaxX >= the_window->bitmap_->width_)
+	{
+		the_rect.MaxX = the_window->bitmap_->width_ - 1;
+	}
 	
-	if ( the_win_template->is_backdrop_ == false)
+	if (the_rect.MaxY >= the_window->bitmap_->height_)
 	{
-		DEBUG_OUT(("%s %d: getting theme and theme controls...", __func__, __LINE__));
-
-		close_control = Control_New(Theme_GetCloseControlTemplate(the_theme), the_window, &the_window->titlebar_rect_, CLOSE_WIDGET_ID, 0);
-		minimize_control = Control_New(Theme_GetMinimizeControlTemplate(the_theme), the_window, &the_window->titlebar_rect_, MINIMIZE_WIDGET_ID, 0);
-		normsize_control = Control_New(Theme_GetNormSizeControlTemplate(the_theme), the_window, &the_window->titlebar_rect_, NORM_SIZE_WIDGET_ID, 0);
-		maximize_control = Control_New(Theme_GetMaximizeControlTemplate(the_theme), the_window, &the_window->titlebar_rect_, MAXIMIZE_WIDGET_ID, 0);
+		the_rect.MaxY = the_window->bitmap_->height_ - 1;
+	}
 	
-		DEBUG_OUT(("%s %d: close_control=%p", __func__, __LINE__, close_control));
-		DEBUG_OUT(("%s %d: minimize_control=%p", __func__, __LINE__, minimize_control));
-		DEBUG_OUT(("%s %d: normsize_control=%p", __func__, __LINE__, normsize_control));
-		DEBUG_OUT(("%s %d: maximize_control=%p", __func__, __LINE__, maximize_control));
+	if (the_rect.MaxX < the_rect.MinX || the_rect.MaxY < the_rect.MinY)
+	{
+		return;
+	}
 	
-		the_window->root_control_ = close_control;
+	Window_AddClipRect(the_window, &the_rect);
+	Sys_RequestRender(global_system);
+}
 
-		Control_SetNextControl(close_control, minimize_control);
-		Control_SetNextControl(minimize_control, normsize_control);
-		Control_SetNextControl(normsize_control, maximize_control);
-		Control_SetNextControl(maximize_control, NULL);
 
-		// set controls to active, except for the normal size one, because windows open at normal size
-		Control_SetActive(close_control, CONTROL_ACTIVE);
+
+// **** Private BATCH DRAW functions *****
+
+//! Draw every command in the window's batch, clipped to the content area
+//! @param	the_window -- a valid pointer to a Window, with a valid bitmap
+//! @param	the_limit -- optional window-local rect to further limit drawing to (eg, the part of the content area uncovered by a resize). Pass NULL to draw the whole content area.
+//! @param	the_dirty_rect -- receives the window-local bounding rect of everything drawn. If nothing was drawn, MaxX will be less than MinX.
+static void Window_RunBatch(Window* the_window, Rectangle* the_limit, Rectangle* the_dirty_rect)
+{
+	Bitmap*			the_bitmap = the_window->bitmap_;
+	WindowDrawOp*	the_op;
+	Rectangle		the_clip;
+	Rectangle		the_content;
+	Rectangle		the_op_rect;
+	Rectangle		the_bounds;
+	Rectangle		the_edge;
+	int16_t			offset_x = the_window->content_rect_.MinX - the_window->content_left_;
+	int16_t			offset_y = the_window->content_rect_.MinY - the_window->content_top_;
+	uint16_t		i;
+	
+	// LOGIC:
+	//   the window and its bitmap were validated once by the caller. from here on, each command only has to be clipped, 
+	//     then it is written straight to the bitmap, without going back through the validating Window_Draw*/Bitmap_* functions.
+	//   the clip is the part of the content area that scrolls (in bitmap coordinates), limited to the bitmap itself
+	//   commands are in content coordinates: the scroll position is taken off them on the way to the bitmap
+	//   the bounds of every command drawn are collected into one dirty rect for the compositor. 
+	//     one rect, rather than one per command, keeps a batch of hundreds of commands from turning into hundreds of region unions.
+	
+	Window_GetScrollRect(the_window, &the_clip);
+	
+	if (the_clip.MinX < 0)
+	{
+		the_clip.MinX = 0;
+	}
+	
+	if (the_clip.MinY < 0)
+	{
+		the_clip.MinY = 0;
+	}
+	
+	if (the_clip.MaxX >= the_bitmap->width_)
+	{
+		the_clip.MaxX = the_bitmap->width_ - 1;
+	}
+	
+	if (the_clip.MaxY >= the_bitmap->height_)
+	{
+		the_clip.MaxY = the_bitmap->height_ - 1;
+	}
+	
+	the_dirty_rect->MinX = the_clip.MaxX;
+	the_dirty_rect->MinY = the_clip.MaxY;
+	the_dirty_rect->MaxX = -1;
+	the_dirty_rect->MaxY = -1;
+	
+	// text is placed relative to the whole content area, even when drawing is limited to part of it
+	General_CopyRect(&the_content, &the_clip);
+	
+	// nothing in the limit rect is in the content area: nothing to draw
+	if (the_limit != NULL && Window_ClipBatchRect(&the_clip, the_limit) == false)
+	{
+		return;
+	}
+	
+	for (i = 0; i < the_window->batch_count_; i++)
+	{
+		the_op = &the_window->batch_ops_[i];
+		
+		// put the command's area into bitmap coordinates, with the corners in order
+		the_op_rect.MinX = (the_op->x1_ < the_op->x2_ ? the_op->x1_ : the_op->x2_) + offset_x;
+		the_op_rect.MaxX = (the_op->x1_ < the_op->x2_ ? the_op->x2_ : the_op->x1_) + offset_x;
+		the_op_rect.MinY = (the_op->y1_ < the_op->y2_ ? the_op->y1_ : the_op->y2_) + offset_y;
+		the_op_rect.MaxY = (the_op->y1_ < the_op->y2_ ? the_op->y2_ : the_op->y1_) + offset_y;
+		
+		if (the_op->type_ == WIN_OP_HLINE)
+		{
+			the_op_rect.MinY = the_op_rect.MaxY = the_op->y1_ + offset_y;
+		}
+		else if (the_op->type_ == WIN_OP_VLINE)
+		{
+			the_op_rect.MinX = the_op_rect.MaxX = the_op->x1_ + offset_x;
+		}
+		else if (the_op->type_ == WIN_OP_TEXT)
+		{
+			if (the_op->data_ == NULL || the_bitmap->font_ == NULL)
+			{
+				continue;
+			}
+			
+			// text is as wide as it turns out to be: start with everything to the right of the pen, and trim after drawing
+			the_op_rect.MinX = the_op->x1_ + offset_x;
+			the_op_rect.MinY = the_op->y1_ + offset_y;
+			the_op_rect.MaxX = the_content.MaxX;
+			the_op_rect.MaxY = the_op_rect.MinY + the_bitmap->font_->fRectHeight - 1;
+			
+			// a glyph can't be cut off part way across, so text must start within the content area's columns. rows are clipped when it is drawn.
+			//   under a limit rect, the whole width of the string is drawn if any of it might be in the limit rect. what's outside it is the same as what's already there.
+			if (the_op_rect.MinX < the_content.MinX || the_op_rect.MinX > the_content.MaxX)
+			{
+				continue;
+			}
+		}
+		
+		General_CopyRect(&the_bounds, &the_op_rect);
+		
+		if (Window_ClipBatchRect(&the_bounds, &the_clip) == false)
+		{
+			continue;
+		}
+		
+		switch (the_op->type_)
+		{
+			case WIN_OP_HLINE:
+			case WIN_OP_VLINE:
+			case WIN_OP_FILL:
+				Window_BatchFillRect(the_bitmap, &the_bounds, the_op->color_);
+				break;
+				
+			case WIN_OP_BOX:
+				// each edge that survived clipping is a 1 pixel high or wide fill
+				General_CopyRect(&the_edge, &the_bounds);
+				
+				if (the_op_rect.MinY == the_bounds.MinY)
+				{
+					the_edge.MaxY = the_edge.MinY;
+					Window_BatchFillRect(the_bitmap, &the_edge, the_op->color_);
+				}
+				
+				if (the_op_rect.MaxY == the_bounds.MaxY)
+				{
+					the_edge.MinY = the_edge.MaxY = the_bounds.MaxY;
+					Window_BatchFillRect(the_bitmap, &the_edge, the_op->color_);
+				}
+				
+				General_CopyRect(&the_edge, &the_bounds);
+				
+				if (the_op_rect.MinX == the_bounds.MinX)
+				{
+					the_edge.MaxX = the_edge.MinX;
+					Window_BatchFillRect(the_bitmap, &the_edge, the_op->color_);
+				}
+				
+				if (the_op_rect.MaxX == the_bounds.MaxX)
+				{
+					the_edge.MinX = the_edge.MaxX = the_bounds.MaxX;
+					Window_BatchFillRect(the_bitmap, &the_edge, the_op->color_);
+				}
+				break;
+				
+			case WIN_OP_LINE:
+				Bitmap_DrawLineClipped(the_bitmap, the_op->x1_ + offset_x, the_op->y1_ + offset_y, the_op->x2_ + offset_x, the_op->y2_ + offset_y, the_op->color_, &the_clip);
+				break;
+				
+			case WIN_OP_BLIT:
+				if (the_op->data_ == NULL)
+				{
+					continue;
+				}
+				
+				// start the copy as far into the source as clipping moved the target
+				Bitmap_Blit((Bitmap*)the_op->data_, the_op->src_x_ + (the_bounds.MinX - the_op_rect.MinX), the_op->src_y_ + (the_bounds.MinY - the_op_rect.MinY), the_bitmap, the_bounds.MinX, the_bounds.MinY, the_bounds.MaxX - the_bounds.MinX + 1, the_bounds.MaxY - the_bounds.MinY + 1);
+				break;
+				
+			case WIN_OP_TEXT:
+				{
+					Bitmap		the_rows;
+					int16_t		max_chars;
+					int16_t		pixels_used;
+					
+					// LOGIC:
+					//   the font code only clips to the bitmap it is given. so draw into a copy of the bitmap that starts at the clip's top row and
+					//     is only as high as the clip: rows above or below it are dropped. the row length is unchanged, so pixels stay where they were.
+					//   on the right, only the chars that fit before the edge of the content area are drawn
+					
+					the_rows = *the_bitmap;
+					the_rows.addr_int_ = the_bitmap->addr_int_ + (uint32_t)the_clip.MinY * (uint32_t)the_bitmap->width_;
+					the_rows.addr_ = (unsigned char*)the_rows.addr_int_;
+					the_rows.height_ = the_clip.MaxY - the_clip.MinY + 1;
+					the_rows.x_ = the_op_rect.MinX;
+					the_rows.y_ = the_op_rect.MinY - the_clip.MinY;
+					the_rows.color_ = the_op->color_;
+					
+					max_chars = the_op->src_x_;
+					
+					if (max_chars < 0 || max_chars > (int16_t)strlen((char*)the_op->data_))
+					{
+						max_chars = GEN_NO_STRLEN_CAP;
+					}
+					
+					max_chars = Font_MeasureStringWidth(the_bitmap->font_, (char*)the_op->data_, max_chars, the_content.MaxX - the_op_rect.MinX + 1, 0, &pixels_used);
+					
+					if (max_chars > 0)
+					{
+						Font_DrawString(&the_rows, (char*)the_op->data_, max_chars);
+					}
+					
+					if (the_rows.x_ - 1 < the_bounds.MaxX)
+					{
+						the_bounds.MaxX = the_rows.x_ - 1;
+					}
+				}
+				break;
+				
+			default:
+				continue;
+		}
+		
+		if (the_bounds.MinX < the_dirty_rect->MinX)
+		{
+			the_dirty_rect->MinX = the_bounds.MinX;
+		}
+		
+		if (the_bounds.MinY < the_dirty_rect->MinY)
+		{
+			the_dirty_rect->MinY = the_bounds.MinY;
+		}
+		
+		if (the_bounds.MaxX > the_dirty_rect->MaxX)
+		{
+			the_dirty_rect->MaxX = the_bounds.MaxX;
+		}
+		
+		if (the_bounds.MaxY > the_dirty_rect->MaxY)
+		{
+			the_dirty_rect->MaxY = the_bounds.MaxY;
+		}
+	}
+}
+
+
+//! Limit a rect to the area it shares with the clip rect
+//! @return:	Returns false if the rects do not overlap (the rect is left unchanged)
+static bool Window_ClipBatchRect(Rectangle* the_rect, Rectangle* the_clip)
+{
+	if (the_rect->MaxX < the_clip->MinX || the_rect->MinX > the_clip->MaxX || the_rect->MaxY < the_clip->MinY || the_rect->MinY > the_clip->MaxY)
+	{
+		return false;
+	}
+	
+	if (the_rect->MinX < the_clip->MinX)
+	{
+		the_rect->MinX = the_clip->MinX;
+	}
+	
+	if (the_rect->MinY < the_clip->MinY)
+	{
+		the_rect->MinY = the_clip->MinY;
+	}
+	
+	if (the_rect->MaxX > the_clip->MaxX)
+	{
+		the_rect->MaxX = the_clip->MaxX;
+	}
+	
+	if (the_rect->MaxY > the_clip->MaxY)
+	{
+		the_rect->MaxY = the_clip->MaxY;
+	}
+	
+	return true;
+}
+
+
+//! Fill a rect that is already known to be within the bitmap, one memset per row
+static void Window_BatchFillRect(Bitmap* the_bitmap, Rectangle* the_rect, uint8_t the_color)
+{
+	uint8_t*	the_write_loc;
+	size_t		the_len;
+	int16_t		y;
+	
+	the_write_loc = the_bitmap->addr_ + (uint32_t)the_rect->MinY * (uint32_t)the_bitmap->width_ + (uint32_t)the_rect->MinX;
+	the_len = (size_t)(the_rect->MaxX - the_rect->MinX + 1);
+	
+	for (y = the_rect->MinY; y <= the_rect->MaxY; y++)
+	{
+		memset(the_write_loc, the_color, the_len);
+		the_write_loc += the_bitmap->width_;
+	}
+}
+
+
+
+// **** Private SCROLLING functions *****
+
+//! Get the part of the content area that scrolls: the content area, less any scrollers showing along its edges
+//! @param	the_window -- a valid pointer to a Window
+//! @param	the_rect -- receives the window-local rect
+static void Window_GetScrollRect(Window* the_window, Rectangle* the_rect)
+{
+	Control*	the_scroller;
+	
+	// the content rect's right and bottom edges sit on the window border: the space inside it is inner_width_ x inner_height_
+	the_rect->MinX = the_window->content_rect_.MinX;
+	the_rect->MinY = the_window->content_rect_.MinY;
+	the_rect->MaxX = the_window->content_rect_.MinX + the_window->inner_width_ - 1;
+	the_rect->MaxY = the_window->content_rect_.MinY + the_window->inner_height_ - 1;
+	
+	if (the_window->h_scroller_visible_ && (the_scroller = Window_GetControl(the_window, H_SCROLLER_WIDGET_ID)) != NULL)
+	{
+		the_rect->MaxY = the_scroller->rect_.MinY - 1;
+	}
+	
+	if (the_window->v_scroller_visible_ && (the_scroller = Window_GetControl(the_window, V_SCROLLER_WIDGET_ID)) != NULL)
+	{
+		the_rect->MaxX = the_scroller->rect_.MinX - 1;
+	}
+}
+
+
+//! Show the scrollers the content size needs, fit them to the content area, and keep the scroll position within range
+//! Scrollers are created from the theme's templates the first time they are needed. With a theme that has no scroller templates, the window scrolls without them.
+//! @param	the_window -- a valid pointer to a Window
+//! @param	do_refresh -- if true, content area that a scroller moved off of or was hidden from is redrawn
+//! @return:	Returns true if the scroll position had to change to stay in range: the caller must redraw the content area
+static bool Window_LayoutScrollers(Window* the_window, bool do_refresh)
+{
+	Theme*				the_theme;
+	ControlTemplate*	the_template[2];
+	Control*			the_scroller[2];
+	Rectangle			the_old_rect[2];
+	bool				was_visible[2];
+	bool				is_needed[2];
+	int16_t				the_size[2] = {0, 0};
+	int16_t				the_max[2];
+	int16_t				i;
+	bool				position_changed = false;
+	Rectangle			the_scroll_rect;
+	
+	// LOGIC:
+	//   index 0 is the horizontal scroller, along the bottom of the content area; index 1 is the vertical one, along the right.
+	//   a scroller is needed when the content doesn't fit in the space for it. a scroller takes space from the other direction, 
+	//     so whether the vertical one is needed depends on the horizontal one, and vice versa: checking each twice settles it.
+	//   scrollers are never removed once created: when not needed, they are just hidden.
+	
+	the_theme = Sys_GetTheme(global_system);
+	the_template[0] = Theme_GetHScrollerControlTemplate(the_theme);
+	the_template[1] = Theme_GetVScrollerControlTemplate(the_theme);
+	the_scroller[0] = Window_GetControl(the_window, H_SCROLLER_WIDGET_ID);
+	the_scroller[1] = Window_GetControl(the_window, V_SCROLLER_WIDGET_ID);
+	was_visible[0] = the_window->h_scroller_visible_;
+	was_visible[1] = the_window->v_scroller_visible_;
+	
+	// the backdrop has no controls to add scrollers to
+	if (the_window->is_backdrop_ == false)
+	{
+		if (the_template[0] != NULL)
+		{
+			the_size[0] = the_template[0]->height_;
+		}
+		
+		if (the_template[1] != NULL)
+		{
+			the_size[1] = the_template[1]->width_;
+		}
+	}
+
+	is_needed[0] = (the_size[0] > 0 && the_window->required_inner_width_ > the_window->inner_width_);
+	is_needed[1] = (the_size[1] > 0 && the_window->required_inner_height_ > the_window->inner_height_ - (is_needed[0] ? the_size[0] : 0));
+	is_needed[0] = (the_size[0] > 0 && the_window->required_inner_width_ > the_window->inner_width_ - (is_needed[1] ? the_size[1] : 0));
+	
+	for (i = 0; i < 2; i++)
+	{
+		if (is_needed[i] && the_scroller[i] == NULL)
+		{
+			if ( (the_scroller[i] = Window_AddNewControlFromTemplate(the_window, the_template[i], (i == 0 ? H_SCROLLER_WIDGET_ID : V_SCROLLER_WIDGET_ID), CONTROL_NO_GROUP)) == NULL)
+			{
+				LOG_WARN(("%s %d: could not add a scroller to the window", __func__, __LINE__));
+				is_needed[i] = false;
+			}
+		}
+	}
+	
+	the_window->h_scroller_visible_ = is_needed[0];
+	the_window->v_scroller_visible_ = is_needed[1];
+	
+	for (i = 0; i < 2; i++)
+	{
+		if (the_scroller[i] == NULL)
+		{
+			continue;
+		}
+		
+		General_CopyRect(&the_old_rect[i], &the_scroller[i]->rect_);
+		the_scroller[i]->visible_ = is_needed[i];
+		
+		if (i == 0)
+		{
+			the_scroller[i]->width_ = the_window->inner_width_ - (is_needed[1] ? the_size[1] : 0);
+		}
+		else
+		{
+			the_scroller[i]->height_ = the_window->inner_height_ - (is_needed[0] ? the_size[0] : 0);
+		}
+		
+		Control_AlignToParentRect(the_scroller[i]);
+	}
+	
+	// keep the scroll position in range for the space now available
+	Window_GetScrollRect(the_window, &the_scroll_rect);
+	the_max[0] = the_window->required_inner_width_ - (the_scroll_rect.MaxX - the_scroll_rect.MinX + 1);
+	the_max[1] = the_window->required_inner_height_ - (the_scroll_rect.MaxY - the_scroll_rect.MinY + 1);
+	
+	for (i = 0; i < 2; i++)
+	{
+		if (the_max[i] < 0)
+		{
+			the_max[i] = 0;
+		}
+	}
+	
+	if (the_window->content_left_ > the_max[0])
+	{
+		the_window->content_left_ = the_max[0];
+		position_changed = true;
+	}
+	
+	if (the_window->content_top_ > the_max[1])
+	{
+		the_window->content_top_ = the_max[1];
+		position_changed = true;
+	}
+	
+	for (i = 0; i < 2; i++)
+	{
+		if (the_scroller[i] == NULL)
+		{
+			continue;
+		}
+		
+		the_scroller[i]->min_ = 0;
+		the_scroller[i]->max_ = the_max[i];
+		the_scroller[i]->value_ = (i == 0 ? the_window->content_left_ : the_window->content_top_);
+		the_scroller[i]->page_size_ = (i == 0 ? the_scroll_rect.MaxX - the_scroll_rect.MinX + 1 : the_scroll_rect.MaxY - the_scroll_rect.MinY + 1);
+		
+		// what a scroller moved off of, or was hidden from, is content again
+		if (do_refresh && was_visible[i] && (is_needed[i] == false || memcmp(&the_old_rect[i], &the_scroller[i]->rect_, sizeof(Rectangle)) != 0))
+		{
+			Window_RefreshContentRect(the_window, &the_old_rect[i]);
+			Window_PostUpdate(the_window, &the_old_rect[i]);
+		}
+	}
+	
+	return position_changed;
+}
+
+
+//! Ask the window's event handler to redraw part of the content area, by posting an updateEvt for it
+//! @param	the_window -- a valid pointer to a Window
+//! @param	the_rect -- window-local rect. It is posted relative to the content area.
+static void Window_PostUpdate(Window* the_window, Rectangle* the_rect)
+{
+	EventManager_AddWindowEvent(updateEvt, the_rect->MinX - the_window->content_rect_.MinX, the_rect->MinY - the_window->content_rect_.MinY, the_rect->MaxX - the_rect->MinX + 1, the_rect->MaxY - the_rect->MinY + 1, the_window, NULL);
+}
+
+
+// **** Debug functions *****
+
+void Window_Print(Window* the_window)
+{
+	DEBUG_OUT(("Window print out:"));
+	DEBUG_OUT(("  address: %p", 		the_window));
+	DEBUG_OUT(("  id_: %i", 			the_window->id_));
+	DEBUG_OUT(("  display_order_: %i", 	the_window->display_order_));
+	DEBUG_OUT(("  user_data_: %i",		the_window->user_data_));
+	DEBUG_OUT(("  title_: '%s'",		the_window->title_));
+	DEBUG_OUT(("  state_: %i",			the_window->state_));
+	DEBUG_OUT(("  bitmap_: %p",			the_window->bitmap_));
+	DEBUG_OUT(("  buffer_bitmap_: %p",	the_window->buffer_bitmap_));
+	DEBUG_OUT(("  overall_rect_: %i, %i, %i, %i", the_window->overall_rect_.MinX, the_window->overall_rect_.MinY, the_window->overall_rect_.MaxX, the_window->overall_rect_.MaxY));
+	DEBUG_OUT(("  titlebar_rect_: %i, %i, %i, %i", the_window->titlebar_rect_.MinX, the_window->titlebar_rect_.MinY, the_window->titlebar_rect_.MaxX, the_window->titlebar_rect_.MaxY));
+	DEBUG_OUT(("  iconbar_rect_: %i, %i, %i, %i", the_window->iconbar_rect_.MinX, the_window->iconbar_rect_.MinY, the_window->iconbar_rect_.MaxX, the_window->iconbar_rect_.MaxY));
+	DEBUG_OUT(("  content_rect_: %i, %i, %i, %i", the_window->content_rect_.MinX, the_window->content_rect_.MinY, the_window->content_rect_.MaxX, the_window->content_rect_.MaxY));
+	DEBUG_OUT(("  grow_left_rect_: %i, %i, %i, %i", the_window->grow_left_rect_.MinX, the_window->grow_left_rect_.MinY, the_window->grow_left_rect_.MaxX, the_window->grow_left_rect_.MaxY));
+	DEBUG_OUT(("  grow_right_rect_: %i, %i, %i, %i", the_window->grow_right_rect_.MinX, the_window->grow_right_rect_.MinY, the_window->grow_right_rect_.MaxX, the_window->grow_right_rect_.MaxY));
+	DEBUG_OUT(("  grow_top_rect_: %i, %i, %i, %i", the_window->grow_top_rect_.MinX, the_window->grow_top_rect_.MinY, the_window->grow_top_rect_.MaxX, the_window->grow_top_rect_.MaxY));
+	DEBUG_OUT(("  grow_bottom_rect_: %i, %i, %i, %i", the_window->grow_bottom_rect_.MinX, the_window->grow_bottom_rect_.MinY, the_window->grow_bottom_rect_.MaxX, the_window->grow_bottom_rect_.MaxY));
+	DEBUG_OUT(("  show_iconbar_: %i",	the_window->show_iconbar_));
+	DEBUG_OUT(("  is_backdrop_: %i",	the_window->is_backdrop_));
+	DEBUG_OUT(("  visible_: %i",		the_window->visible_));
+	DEBUG_OUT(("  active_: %i",			the_window->active_));
+	DEBUG_OUT(("  changes_to_save_: %i",	the_window->changes_to_save_));
+	DEBUG_OUT(("  can_resize_: %i",		the_window->can_resize_));	
+	DEBUG_OUT(("  x_: %i",				the_window->x_));	
+	DEBUG_OUT(("  y_: %i",				the_window->y_));	
+	DEBUG_OUT(("  width_: %i",			the_window->width_));	
+	DEBUG_OUT(("  height_: %i",			the_window->height_));	
+	DEBUG_OUT(("  min_width_: %i",		the_window->min_width_));	
+	DEBUG_OUT(("  min_height_: %i",		the_window->min_height_));	
+	DEBUG_OUT(("  max_width_: %i",		the_window->max_width_));	
+	DEBUG_OUT(("  max_height_: %i",		the_window->max_height_));	
+	DEBUG_OUT(("  inner_width_: %i",	the_window->inner_width_));	
+	DEBUG_OUT(("  inner_height_: %i",	the_window->inner_height_));	
+	DEBUG_OUT(("  avail_title_width_: %i",	the_window->avail_title_width_));	
+	DEBUG_OUT(("  content_left_: %i",	the_window->content_left_));	
+	DEBUG_OUT(("  content_top_: %i",	the_window->content_top_));	
+	DEBUG_OUT(("  required_inner_width_: %i",		the_window->required_inner_width_));	
+	DEBUG_OUT(("  required_inner_height_: %i",		the_window->required_inner_height_));	
+	DEBUG_OUT(("  h_scroller_visible_: %i",			the_window->h_scroller_visible_));	
+	DEBUG_OUT(("  v_scroller_visible_: %i",			the_window->v_scroller_visible_));	
+	DEBUG_OUT(("  pattern_: %p",		the_window->pattern_));	
+	DEBUG_OUT(("  parent_window_: %p",	the_window->parent_window_));	
+	DEBUG_OUT(("  child_window_: %p",	the_window->child_window_));	
+	DEBUG_OUT(("  root_control_: %p",	the_window->root_control_));	
+}
+
+
+// helper function called by List class's print function: prints one window entry
+void Window_PrintBrief(void* the_payload)
+{
+	Window*		this_window = (Window*)(the_payload);
+
+	DEBUG_OUT(("%s %d: %s (%p, %i)", __func__ , __LINE__, (this_window->is_backdrop_ == false ? this_window->title_ : (char*)"Backdrop"), this_window, this_window->display_order_ ));
+
+}
+
+
+/*****************************************************************************/
+/*                        Public Function Definitions                        */
+/*****************************************************************************/
+
+// **** CONSTRUCTOR AND DESTRUCTOR *****
+
+// constructor
+//! Allocate a Window object
+//! the_win_template->width_: cannot be smaller than WIN_DEFAULT_MIN_WIDTH, cannot be greater than WIN_DEFAULT_MAX_WIDTH
+//! the_win_template->height_: cannot be smaller than WIN_DEFAULT_MIN_HEIGHT, cannot be greater than WIN_DEFAULT_MAX_HEIGHT
+//! the_win_template->min_width_: cannot be smaller than WIN_DEFAULT_MIN_WIDTH
+//! the_win_template->min_height_: cannot be smaller than WIN_DEFAULT_MIN_HEIGHT
+//! the_win_template->max_width_: cannot be smaller than WIN_DEFAULT_MIN_WIDTH
+//! the_win_template->max_height_: cannot be smaller than WIN_DEFAULT_MIN_HEIGHT
+//! @param	the_win_template -- a populated new window template whose data will be used to create the new window object
+//! @param	event_handler -- pointer to the function that will handle all events for the window. This function will be called when the system detects an event associated with the window.
+Window* Window_New(NewWinTemplate* the_win_template, void (* event_handler)(EventRecord*))
+{
+	Window*		the_window = NULL;
+	Theme*		the_theme;
+	Control*	close_control;
+	Control*	minimize_control;
+	Control*	normsize_control;
+	Control*	maximize_control;
+		
+	// LOGIC: 
+	//   Only a few parameter values can be so bad that the window creation process must terminate
+	//   The offscreen bitmap can be NULL and be ok
+	//   The main bitmap can also be NULL, and if so, a new one will be allocated
+	//     If the new window is going to be a backdrop window, however, it will be assigned the system screen's bitmap
+	//   The size parameters can be adjusted to match system mins and maxs.
+	
+	if ( the_win_template == NULL)
+	{
+		LOG_ERR(("%s %d: passed NewWinTemplate was NULL", __func__ , __LINE__));
+		goto error;
+	}
+	
+	if ( (the_theme = Sys_GetTheme(global_system)) == NULL)
+	{
+		LOG_ERR(("%s %d: failed to get the current system theme!", __func__ , __LINE__));
+		goto error;
+	}
+	
+	DEBUG_OUT(("%s %d: x=%i, y=%i, width=%i", __func__, __LINE__, the_win_template->x_, the_win_template->y_, the_win_template->width_));
+	
+	if ( (the_window = (Window*)calloc(1, sizeof(Window)) ) == NULL)
+	{
+		LOG_ERR(("%s %d: could not allocate memory to create new Window", __func__ , __LINE__));
+		goto error;
+	}
+	LOG_ALLOC(("%s %d:	__ALLOC__	the_window	%p	size	%i", __func__ , __LINE__, the_window, sizeof(Window)));
+	TRACK_ALLOC((sizeof(Window)));
+	
+	if ( (the_window->title_ = General_StrlcpyWithAlloc(the_win_template->title_, WINDOW_MAX_WINTITLE_SIZE)) == NULL)
+	{
+		LOG_ERR(("%s %d: could not allocate memory for the window name string", __func__ , __LINE__));
+		goto error;
+	}
+	LOG_ALLOC(("%s %d:	__ALLOC__	the_window->title_	%p	size	%i		'%s'", __func__ , __LINE__, the_window->title_, General_Strnlen(the_window->title_, WINDOW_MAX_WINTITLE_SIZE) + 1, the_window->title_));
+	TRACK_ALLOC((General_Strnlen(the_window->title_, WINDOW_MAX_WINTITLE_SIZE) + 1));
+
+	// set up the clip and damage regions. they start empty
+	if ( (the_window->clip_region_ = Region_New()) == NULL || (the_window->damage_region_ = Region_New()) == NULL || (the_window->visible_region_ = Region_New()) == NULL)
+	{
+		LOG_ERR(("%s %d: could not allocate clip/damage/visible regions for new window", __func__ , __LINE__));
+		goto error;
+	}
+	
+	// do check on the height, max height, min height, etc. 
+	Window_CheckDimensions(the_window, the_win_template);
+
+	// assign the bitmap passed by win_setup, or allocate a new one
+	if ( the_win_template->bitmap_ == NULL)
+	{
+		if ( (the_window->bitmap_ = Bitmap_New(the_win_template->width_, the_win_template->height_, Sys_GetAppFont(global_system), PARAM_PREFER_VRAM)) == NULL)
+		{
+			LOG_ERR(("%s %d: Failed to create bitmap", __func__, __LINE__));
+			goto error;
+		}
+	}
+	else
+	{
+		the_window->bitmap_ = the_win_template->bitmap_;
+	}
+	
+	the_window->x_ = the_win_template->x_;
+	the_window->y_ = the_win_template->y_;
+	the_window->width_ = the_win_template->width_;
+	the_window->height_ = the_win_template->height_;
+	the_window->norm_x_ = the_win_template->x_;
+	the_window->norm_y_ = the_win_template->y_;
+	the_window->norm_width_ = the_win_template->width_;
+	the_window->norm_height_ = the_win_template->height_;
+	the_window->global_rect_.MinX = the_window->x_;
+	the_window->global_rect_.MaxX = (the_window->x_ + the_window->width_) - 1;
+	the_window->global_rect_.MinY = the_window->y_;
+	the_window->global_rect_.MaxY = (the_window->y_ + the_window->height_) - 1;
+	the_window->min_width_ = the_win_template->min_width_;
+	the_window->min_height_ = the_win_template->min_height_;
+	the_window->max_width_ = the_win_template->max_width_;
+	the_window->max_height_ = the_win_template->max_height_;
+
+	the_window->user_data_ = the_win_template->user_data_;
+	the_window->buffer_bitmap_ = the_win_template->buffer_bitmap_;
+	the_window->show_iconbar_ = the_win_template->show_iconbar_;
+	the_window->is_backdrop_ = the_win_template->is_backdrop_;
+	the_window->can_resize_ = the_win_template->can_resize_;
+	the_window->event_handler_ = event_handler;
+	the_window->event_mask_ = WIN_DEFAULT_EVENT_MASK;
+	the_window->selected_control_ = NULL;
+	
+	// set up the rects for titlebar, content, etc. 
+	Window_ConfigureStructureRects(the_window);
+
+	if (the_window->can_resize_)
+	{
+		// window can be resized, so needs drag zones to be established
+		Window_ConfigureDragRects(the_window);
+	}
+	
+	// all windows start off non-visible
+	the_window->visible_ = false;
+	
+	// all windows start out as invalidated, so that they are rendered fully next render pass
+	the_window->invalidated_ = true;
+	the_window->titlebar_invalidated_ = true;
+	
+	// pen location starts at 0,0 (relative to content area, not to window rect)
+	the_window->pen_x_ = 0;
+	the_window->pen_y_ = 0;
+	
+	// add the base controls (not needed for backdrops -- we don't want user to be able to close a backdrop)
+	
+	if ( the_win_template->is_backdrop_ == false)
+	{
+		DEBUG_OUT(("%s %d: getting theme and theme controls...", __func__, __LINE__));
+
+		close_control = Control_New(Theme_GetCloseControlTemplate(the_theme), the_window, &the_window->titlebar_rect_, CLOSE_WIDGET_ID, 0);
+		minimize_control = Control_New(Theme_GetMinimizeControlTemplate(the_theme), the_window, &the_window->titlebar_rect_, MINIMIZE_WIDGET_ID, 0);
+		normsize_control = Control_New(Theme_GetNormSizeControlTemplate(the_theme), the_window, &the_window->titlebar_rect_, NORM_SIZE_WIDGET_ID, 0);
+		maximize_control = Control_New(Theme_GetMaximizeControlTemplate(the_theme), the_window, &the_window->titlebar_rect_, MAXIMIZE_WIDGET_ID, 0);
+	
+		DEBUG_OUT(("%s %d: close_control=%p", __func__, __LINE__, close_control));
+		DEBUG_OUT(("%s %d: minimize_control=%p", __func__, __LINE__, minimize_control));
+		DEBUG_OUT(("%s %d: normsize_control=%p", __func__, __LINE__, normsize_control));
+		DEBUG_OUT(("%s %d: maximize_control=%p", __func__, __LINE__, maximize_control));
+	
+		the_window->root_control_ = close_control;
+
+		Control_SetNextControl(close_control, minimize_control);
+		Control_SetNextControl(minimize_control, normsize_control);
+		Control_SetNextControl(normsize_control, maximize_control);
+		Control_SetNextControl(maximize_control, NULL);
+
+		// set controls to active, except for the normal size one, because windows open at normal size
+		Control_SetActive(close_control, CONTROL_ACTIVE);
 		Control_SetActive(minimize_control, CONTROL_ACTIVE);
 		Control_SetActive(normsize_control, CONTROL_INACTIVE);
 		Control_SetActive(maximize_control, CONTROL_ACTIVE);
@@ -981,6 +1755,13 @@ Window* Window_New(NewWinTemplate* the_win_template, void (* event_handler)(Even
 	if ( the_win_template->is_backdrop_ == true)
 	{
 		the_window->display_order_ = SYS_WIN_Z_ORDER_BACKDROP;
+
+		// backdrop windows re-tile their pattern lazily, only where about to be blitted
+		if ( (the_window->untiled_region_ = Region_New()) == NULL)
+		{
+			LOG_ERR(("%s %d: could not allocate untiled region for backdrop window", __func__ , __LINE__));
+			goto error;
+		}
 	}
 
 	//Window_Print(the_window);
@@ -1017,6 +1798,34 @@ bool Window_Destroy(Window** the_window)
 		Bitmap_Destroy(&(*the_window)->bitmap_);
 	}
 	
+	if ((*the_window)->clip_region_)
+	{
+		Region_Destroy(&(*the_window)->clip_region_);
+	}
+	
+	if ((*the_window)->damage_region_)
+	{
+		Region_Destroy(&(*the_window)->damage_region_);
+	}
+	
+	if ((*the_window)->visible_region_)
+	{
+		Region_Destroy(&(*the_window)->visible_region_);
+	}
+	
+	if ((*the_window)->untiled_region_)
+	{
+		Region_Destroy(&(*the_window)->untiled_region_);
+	}
+	
+	if ((*the_window)->batch_ops_)
+	{
+		LOG_ALLOC(("%s %d:	__FREE__	(*the_window)->batch_ops_	%p	size	%i", __func__ , __LINE__, (*the_window)->batch_ops_, (*the_window)->batch_max_ * sizeof(WindowDrawOp)));
+		TRACK_ALLOC((0 - (*the_window)->batch_max_ * sizeof(WindowDrawOp)));
+		free((*the_window)->batch_ops_);
+		(*the_window)->batch_ops_ = NULL;
+	}
+	
 	LOG_ALLOC(("%s %d:	__FREE__	*the_window	%p	size	%i", __func__ , __LINE__, *the_window, sizeof(Window)));
 	TRACK_ALLOC((0 - sizeof(Window)));
 	free(*the_window);
@@ -1079,20 +1888,17 @@ error:
 // **** CLIP RECT MANAGEMENT functions *****
 
 
-//! Copy the passed rectangle to the window's clip rect collection
-//! If the window already has the maximum allowed number of clip rects, the rectangle will not be added.
+//! Add the passed rectangle to the window's clip region
+//! Any part of the rectangle that overlaps area already in the clip region is merged with it, so it will only be blitted once.
 //! NOTE: the incoming rect must be using window-local coordinates, not global. No translation will be performed.
 //! @param	the_window -- reference to a valid Window object.
 //! @param	new_rect -- reference to the rectangle describing the coordinates to be added to the window as a clipping rect. Coordinates of this rect must be window-local! Coordinates in rect are copied to window storage, so it is safe to free the rect after calling this function.
-//! @return:	Returns true if rect is copied successfully. Returns false on any error, or if the window already had the maximum number of allowed clip rects.
+//! @return:	Returns true if rect is added successfully. Returns false on any error.
 bool Window_AddClipRect(Window* the_window, Rectangle* new_rect)
 {
-	Rectangle*	the_clip;
-	
 	// LOGIC:
-	//   A window has a maximum number of clip rects it will track
-	//   after that number has been reached, the whole window will need to be reblitted
-	//   therefore, once that number is reached, stop accepting new ones
+	//   The clip region merges overlapping and adjoining rects as they come in
+	//   There is no upper limit on how many rects it can hold, so the window never has to fall back to reblitting everything
 	
 	if ( the_window == NULL)
 	{
@@ -1106,22 +1912,13 @@ bool Window_AddClipRect(Window* the_window, Rectangle* new_rect)
 		goto error;
 	}
 	
-	if ( the_window->clip_count_ >= WIN_MAX_CLIP_RECTS)
+	if (Region_UnionRect(the_window->clip_region_, new_rect) == false)
 	{
+		LOG_ERR(("%s %d: could not add rect to clip region", __func__ , __LINE__));
 		return false;
 	}
-	
-	// LOGIC:
-	//   controls / etc pass on their window-local coords
-	//   but to blit to screen, we need to correct to global coords
-
-	the_clip = &the_window->clip_rect_[the_window->clip_count_];
-
-	General_CopyRect(the_clip, new_rect);	
-	
-	the_window->clip_count_++;
 
-	//DEBUG_OUT(("%s %d: window '%s' picked up a clip rect, now has %i cliprects; new clip rect is %i, %i : %i, %i", __func__, __LINE__, the_window->title_, the_window->clip_count_, the_clip->MinX, the_clip->MinY, the_clip->MaxX, the_clip->MaxY));
+	//DEBUG_OUT(("%s %d: window '%s' picked up a clip rect, now has %i cliprects; new clip rect is %i, %i : %i, %i", __func__, __LINE__, the_window->title_, Region_GetRectCount(the_window->clip_region_), new_rect->MinX, new_rect->MinY, new_rect->MaxX, new_rect->MaxY));
 	
 	return true;
 	
@@ -1132,8 +1929,9 @@ error:
 
 
 //! Merge and de-duplicate clip rects
-//! Consolidating the clip rects will happen reduce unnecessary reblitting
-// need to study more before trying to implement this; looks hairy. 
+//! The clip region merges rects as they are added, so there is nothing left to do here. Kept for compatibility.
+//! @param	the_window -- reference to a valid Window object.
+//! @return:	Returns true unless the window is NULL
 bool Window_MergeClipRects(Window* the_window)
 {
 	if ( the_window == NULL)
@@ -1142,7 +1940,7 @@ bool Window_MergeClipRects(Window* the_window)
 		goto error;
 	}
 	
-	return false;
+	return true;
 	
 error:
 	Sys_Exit(&global_system, PARAM_EXIT_ON_ERROR);	// crash early, crash often
@@ -1150,13 +1948,14 @@ error:
 }
 
 
-//! Blit each clip rect to the screen, and clear all clip rects when done
+//! Blit each rect of the clip region to the screen, and empty the clip region when done
 //! This is the actual mechanics of rendering the window to the screen
 //! @param	the_window -- reference to a valid Window object.
 //! @return:	Returns true if there are either no clips to blit, or if there are clips and they are blitted successfully. Returns false on any error.
 bool Window_BlitClipRects(Window* the_window)
 {
 	Rectangle*	the_clip;
+	Rectangle	the_global_clip;
 	Bitmap*		the_screen_bitmap;
 	int16_t		i;
 	
@@ -1166,17 +1965,20 @@ bool Window_BlitClipRects(Window* the_window)
 		goto error;
 	}
 	
-	if (the_window->clip_count_ == 0)
+	if (Region_IsEmpty(the_window->clip_region_))
 	{
-		DEBUG_OUT(("%s %d: the_window->clip_count_ == 0 (not error condition)", __func__, __LINE__));
+		DEBUG_OUT(("%s %d: the_window clip region is empty (not error condition)", __func__, __LINE__));
 		return true; // not an error condition
 	}
 	
 	the_screen_bitmap = Sys_GetScreenBitmap(global_system, back_layer);
 	
-	for (i = 0; i < the_window->clip_count_; i++)
+	// LOGIC:
+	//   The clip region's rects never overlap, so each pixel that needs updating is blitted exactly once
+	
+	for (i = 0; i < the_window->clip_region_->num_rects_; i++)
 	{
-		the_clip = &the_window->clip_rect_[i];
+		the_clip = &the_window->clip_region_->rects_[i];
 
 		DEBUG_OUT(("%s %d: win '%s' blitting cliprect %p (%i, %i -- %i, %i)", __func__, __LINE__, the_window->title_, the_clip, the_clip->MinX, the_clip->MinY, the_clip->MaxX, the_clip->MaxY));
 	
@@ -1189,13 +1991,20 @@ bool Window_BlitClipRects(Window* the_window)
 					the_clip->MaxX - the_clip->MinX + 1, 
 					the_clip->MaxY - the_clip->MinY + 1
 					);
+		
+		// if double-buffering, the other page needs this too once it's flipped on screen
+		the_global_clip.MinX = the_clip->MinX + the_window->x_;
+		the_global_clip.MinY = the_clip->MinY + the_window->y_;
+		the_global_clip.MaxX = the_clip->MaxX + the_window->x_;
+		the_global_clip.MaxY = the_clip->MaxY + the_window->y_;
+		Sys_AddScreenDamage(global_system, &the_global_clip);
 	}
 	
 	// LOGIC: 
 	//   clip rects are one-time usage: once we have blitted them, we never want to blit them again
 	//   we want to clear the decks for the next set of updates
 	
-	the_window->clip_count_ = 0;
+	Region_MakeEmpty(the_window->clip_region_);
 	
 	return true;
 	
@@ -1205,8 +2014,8 @@ error:
 }
 
 
-//! Calculate damage rects, if any, caused by window moving or being resized
-//! NOTE: it is not necessarily an error condition if a given window doesn't end up with damage rects as a result of this operation: if the window rect doesn't intersect the incoming rect, no damage is relevant.
+//! Calculate damage region, if any, caused by window moving or being resized: the part of the old rect no longer covered by the window
+//! NOTE: it is not necessarily an error condition if a given window doesn't end up with damage rects as a result of this operation: if the new window rect covers the old one, no damage is relevant.
 //! @param	the_window -- reference to a valid Window object.
 //! @param	the_old_rect -- reference to the rectangle to be checked for overlap with the specified window. Coordinates of this rect must be global!
 //! @return:	Returns true if 1 or more damage rects were created. Returns false on any error condition, or if no damage rects needed to be created.
@@ -1217,12 +2026,23 @@ bool Window_GenerateDamageRects(Window* the_window, Rectangle* the_old_rect)
 		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
 		goto error;
 	}
-		
-	the_window->damage_count_ = General_CalculateRectDifference(&the_window->global_rect_, the_old_rect, &the_window->damage_rect_[0], &the_window->damage_rect_[1], &the_window->damage_rect_[2], &the_window->damage_rect_[3]);
+	
+	if ( the_old_rect == NULL)
+	{
+		LOG_ERR(("%s %d: passed rect was null", __func__ , __LINE__));
+		goto error;
+	}
+	
+	if (Region_SetRect(the_window->damage_region_, the_old_rect) == false || Region_SubtractRect(the_window->damage_region_, &the_window->global_rect_) == false)
+	{
+		LOG_ERR(("%s %d: could not calculate damage region", __func__ , __LINE__));
+		Region_MakeEmpty(the_window->damage_region_);
+		return false;
+	}
 
-	//DEBUG_OUT(("%s %d: window '%s' has damage count of %i", __func__, __LINE__, the_window->title_, the_window->damage_count_));
+	//DEBUG_OUT(("%s %d: window '%s' has damage count of %i", __func__, __LINE__, the_window->title_, Region_GetRectCount(the_window->damage_region_)));
 
-	return (the_window->damage_count_ != -1);
+	return (Region_IsEmpty(the_window->damage_region_) == false);
 	
 error:
 	Sys_Exit(&global_system, PARAM_EXIT_ON_ERROR);	// crash early, crash often
@@ -1230,7 +2050,7 @@ error:
 }
 
 
-//! Copy the passed rectangle to the window's clip rect collection, translating to local coordinates as it does so
+//! Add the passed rectangle to the window's clip region, translating to local coordinates as it does so
 //! NOTE: the incoming rect is assumed to be using global, not window-local coordinates. Coordinates will be translated to window-local. 
 //! Note: it is safe to pass non-intersecting rects to this function: it will check for non-intersection; will trim copy of clip to just the intersection
 //! @param	the_window -- reference to a valid Window object.
@@ -1238,12 +2058,7 @@ error:
 //! @return:	Returns true if the passed rect has any intersection with the window. Returns false if not intersection, or on any error condition.
 bool Window_AcceptDamageRect(Window* the_window, Rectangle* damage_rect)
 {
-	Rectangle*	the_clip;
-	
-	// LOGIC:
-	//   A window has a maximum number of clip rects it will track
-	//   after that number has been reached, the whole window will need to be reblitted
-	//   therefore, once that number is reached, stop accepting new ones
+	Rectangle	the_clip;
 	
 	if ( the_window == NULL)
 	{
@@ -1257,23 +2072,20 @@ bool Window_AcceptDamageRect(Window* the_window, Rectangle* damage_rect)
 		goto error;
 	}
 	
-	//DEBUG_OUT(("%s %d: window '%s' has %i cliprects; incoming dmg rect is %i, %i : %i, %i", __func__, __LINE__, the_window->title_, the_window->clip_count_, damage_rect->MinX, damage_rect->MinY, damage_rect->MaxX, damage_rect->MaxY));
-	
-	if ( the_window->clip_count_ >= WIN_MAX_CLIP_RECTS)
-	{
-		return false;
-	}
-	
-	the_clip = &the_window->clip_rect_[the_window->clip_count_];
+	//DEBUG_OUT(("%s %d: window '%s' has %i cliprects; incoming dmg rect is %i, %i : %i, %i", __func__, __LINE__, the_window->title_, Region_GetRectCount(the_window->clip_region_), damage_rect->MinX, damage_rect->MinY, damage_rect->MaxX, damage_rect->MaxY));
 	
-	if (General_CalculateRectIntersection(&the_window->global_rect_, damage_rect, the_clip) == true)
+	if (General_CalculateRectIntersection(&the_window->global_rect_, damage_rect, &the_clip) == true)
 	{
-		Window_GlobalToLocal(the_window, &the_clip->MinX, &the_clip->MinY);
-		Window_GlobalToLocal(the_window, &the_clip->MaxX, &the_clip->MaxY);
+		Window_GlobalToLocal(the_window, &the_clip.MinX, &the_clip.MinY);
+		Window_GlobalToLocal(the_window, &the_clip.MaxX, &the_clip.MaxY);
 		
-		the_window->clip_count_++;
+		if (Region_UnionRect(the_window->clip_region_, &the_clip) == false)
+		{
+			LOG_ERR(("%s %d: could not add damage rect to clip region", __func__ , __LINE__));
+			return false;
+		}
 	
-		DEBUG_OUT(("%s %d: win '%s' got new dmg rect, now has %i cliprects; new dmg rect (l) is %i, %i : %i, %i", __func__, __LINE__, the_window->title_, the_window->clip_count_, the_clip->MinX, the_clip->MinY, the_clip->MaxX, the_clip->MaxY));
+		DEBUG_OUT(("%s %d: win '%s' got new dmg rect, now has %i cliprects; new dmg rect (l) is %i, %i : %i, %i", __func__, __LINE__, the_window->title_, Region_GetRectCount(the_window->clip_region_), the_clip.MinX, the_clip.MinY, the_clip.MaxX, the_clip.MaxY));
 		
 		return true;
 	}
@@ -1715,6 +2527,12 @@ Control* Window_GetControlAtXY(Window* the_window, int16_t x, int16_t y)
 		
 		in_this_control = General_PointInRect(x, y, the_control->rect_);
 		
+		// a hidden scroller still has a rect, but it is content area now
+		if (in_this_control && the_control->visible_ == false && (the_control->id_ == H_SCROLLER_WIDGET_ID || the_control->id_ == V_SCROLLER_WIDGET_ID))
+		{
+			in_this_control = false;
+		}
+		
 		if (in_this_control)
 		{
 			return the_control;
@@ -1754,13 +2572,16 @@ void Window_Render(Window* the_window)
 	//   Backdrop windows always fill the screen and always are filled with their backdrop pattern and never have borders, controls, etc. 
 	//   Non-backdrop windows are built up from overall struct, content area, and controls. 
 	//     Except for the first render, the overall struct and content area are generally not cleared/re-rendered. 
-	//   For both backdrop and non-backdrop windows, render will only redraw the entire window if either:
-	//     A) the window itself is set as invalidated OR
-	//     B) there are more than X clip rects that need blitting, so system decides it is faster to blit the window in one go.
+	//   For both backdrop and non-backdrop windows, render will only redraw the entire window if the window itself is set as invalidated
+	//   Whether redrawn in full or not, only the parts of the window not covered by windows in front of it are blitted to the screen.
+	//     Each screen pixel is therefore written by at most one window per render pass.
 	
 	the_theme = Sys_GetTheme(global_system);
 	the_pattern = Theme_GetDesktopPattern(the_theme);
 
+	the_window->pixels_blitted_ = 0;
+	the_window->pixels_hidden_ = 0;
+	
 	if (the_window->visible_ == false)
 	{
 		return;
@@ -1770,9 +2591,21 @@ void Window_Render(Window* the_window)
 	{
 		if (the_window->invalidated_ == true)
 		{
-			// backdrop window: fill it with its pattern. no controls, borders, etc. 
-			// tile the default theme's background pattern
-			Bitmap_Tile(the_pattern, 0, 0, the_window->bitmap_, the_theme->pattern_width_, the_theme->pattern_height_);
+			Rectangle	the_local_rect;
+			
+			// backdrop window: it is filled with its pattern. no controls, borders, etc. 
+			// don't tile the whole screen here: just mark all of it as needing the pattern, and tile only what gets blitted (below)
+			//   the untiled region is window-local, like the clip region it is compared with, wherever the window is on screen
+			the_local_rect.MinX = 0;
+			the_local_rect.MinY = 0;
+			the_local_rect.MaxX = the_window->width_ - 1;
+			the_local_rect.MaxY = the_window->height_ - 1;
+			
+			if (Region_SetRect(the_window->untiled_region_, &the_local_rect) == false)
+			{
+				LOG_ERR(("%s %d: could not reset untiled region for backdrop window", __func__ , __LINE__));
+				goto error;
+			}
 		}
 	}
 	else
@@ -1785,7 +2618,15 @@ void Window_Render(Window* the_window)
 		
 		if (the_window->invalidated_ == true)
 		{
+			Rectangle	the_batch_rect;
+			
 			Window_DrawAll(the_window);
+			
+			// clearing the content area wiped out whatever the last draw batch drew: draw it again. the whole window is about to be blitted anyway. 
+			if (the_window->batch_open_ == false)
+			{
+				Window_RunBatch(the_window, NULL, &the_batch_rect);
+			}
 		}
 		else
 		{
@@ -1803,20 +2644,65 @@ void Window_Render(Window* the_window)
 
 	// blit to screen
 	
-	// if the entire window has had to be redrawn, then don't bother with individual cliprects, just do one for entire window
-	if (the_window->invalidated_ == true || the_window->clip_count_ >= WIN_MAX_CLIP_RECTS)
+	// find out which parts of this window are not covered by windows in front of it
+	if (Sys_CalculateVisibleRegion(global_system, the_window) == false)
+	{
+		LOG_ERR(("%s %d: could not calculate visible region for window '%s'", __func__ , __LINE__, the_window->title_));
+		goto error;
+	}
+	
+	// if the entire window has had to be redrawn, then don't bother with individual cliprects, just blit everything that is visible
+	if (the_window->invalidated_ == true)
 	{
-		the_window->clip_count_ = 0;
-		Bitmap_BlitRect(the_window->bitmap_, &the_window->overall_rect_, Sys_GetScreenBitmap(global_system, back_layer), the_window->x_, the_window->y_);
+		the_window->pixels_hidden_ = (uint32_t)the_window->width_ * (uint32_t)the_window->height_;
+		Region_Copy(the_window->clip_region_, the_window->visible_region_);
 		the_window->invalidated_ = false;
 	}
 	else
 	{
-		DEBUG_OUT(("%s %d: window '%s' has %i clip rects to render", __func__, __LINE__, the_window->title_, the_window->clip_count_));
+		the_window->pixels_hidden_ = Region_GetArea(the_window->clip_region_);
+		Region_Intersect(the_window->clip_region_, the_window->visible_region_);
+	}
+	
+	the_window->pixels_blitted_ = Region_GetArea(the_window->clip_region_);
+	the_window->pixels_hidden_ -= the_window->pixels_blitted_;
+
+	DEBUG_OUT(("%s %d: window '%s' has %i clip rects to render", __func__, __LINE__, the_window->title_, Region_GetRectCount(the_window->clip_region_)));
+	
+	// backdrop: tile the theme pattern into any clip rect that hasn't had it since the last invalidation
+	//   the pattern is anchored at the bitmap origin, so tiling it piecemeal gives the same pixels as tiling the whole screen
+	if (the_window->is_backdrop_ && Region_IsEmpty(the_window->untiled_region_) == false)
+	{
+		Rectangle*	the_clip_rect;
+		Rectangle*	the_untiled_rect;
+		Rectangle	the_tile_rect;
+		int16_t		i;
+		int16_t		j;
+		
+		for (i = 0; i < the_window->clip_region_->num_rects_; i++)
+		{
+			the_clip_rect = &the_window->clip_region_->rects_[i];
+			
+			for (j = 0; j < the_window->untiled_region_->num_rects_; j++)
+			{
+				the_untiled_rect = &the_window->untiled_region_->rects_[j];
+				
+				if (General_CalculateRectIntersection(the_clip_rect, the_untiled_rect, &the_tile_rect))
+				{
+					Bitmap_TileRect(the_pattern, 0, 0, the_window->bitmap_, the_theme->pattern_width_, the_theme->pattern_height_, &the_tile_rect);
+				}
+			}
+		}
 		
-		Window_BlitClipRects(the_window);
+		if (Region_Subtract(the_window->untiled_region_, the_window->clip_region_) == false)
+		{
+			LOG_ERR(("%s %d: could not update untiled region for backdrop window", __func__ , __LINE__));
+			goto error;
+		}
 	}
 	
+	Window_BlitClipRects(the_window);
+	
 	return;
 	
 error:
@@ -1897,6 +2783,8 @@ void Window_Invalidate(Window* the_window)
 		Window_InvalidateTitlebar(the_window);
 	}
 	
+	Sys_RequestRender(global_system);
+	
 	return;
 	
 error:
@@ -1965,6 +2853,39 @@ error:
 }
 
 
+//! Set which kinds of event the window's event handler is called for
+//! Events of kinds no window subscribes to are thrown away as they happen, so they never use up a slot in the event queue.
+//! NOTE: new windows subscribe to WIN_DEFAULT_EVENT_MASK: every kind a window can be given, except mouseMoved
+//! @param	the_window -- reference to a valid Window object.
+//! @param	the_mask -- event_mask bits (eg, keyDownMask | mouseMovedMask). Bits outside EVENT_WINDOW_MASK are ignored.
+void Window_SetEventMask(Window* the_window, uint32_t the_mask)
+{
+	if (the_window == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		goto error;
+	}
+	
+	the_mask &= EVENT_WINDOW_MASK;
+	
+	// the event manager keeps a count of subscribers for each kind: swap this window's old subscription for the new one
+	//   a window only subscribes once it is added to the system's window list. before that, just note the mask: Sys_AddToWindowList() subscribes it.
+	if (the_window->subscribed_ == true)
+	{
+		EventManager_Subscribe(the_mask);
+		EventManager_Unsubscribe(the_window->event_mask_);
+	}
+	
+	the_window->event_mask_ = the_mask;
+	
+	return;
+	
+error:
+	Sys_Exit(&global_system, PARAM_EXIT_ON_ERROR);	// crash early, crash often
+	return;
+}
+
+
 //! Set the display order of the window
 //! NOTE: This does not immediately re-render or change the display order visibly.
 //! WARNING: This function is designed to be called by the system only: do not use this
@@ -2090,6 +3011,7 @@ error:
 //! Change position and/or size of window
 //! NOTE: passed x, y will be checked against the window's min/max values
 //! Will also adjust the position of the built-in maximize/minimize/normsize controls
+//! What is already drawn in the window is kept: a move only re-blits the window, and a resize only redraws the newly uncovered content, the border, and the titlebar and controls if they changed
 //! @param	the_window -- reference to a valid Window object.
 //! @param	x -- The new global horizontal position
 //! @param	y -- The new global vertical position
@@ -2099,7 +3021,14 @@ error:
 void Window_ChangeWindow(Window* the_window, int16_t x, int16_t y, int16_t width, int16_t height, bool update_norm)
 {
 	bool		width_changed = false;
+	bool		size_changed = false;
+	bool		position_changed = false;
+	bool		redraw_all;
+	bool		scroll_changed = false;
 	Rectangle	the_old_rect; //! will contain global rect of window before resize/move
+	Rectangle	the_old_overall_rect;
+	Rectangle	the_old_content_rect;
+	int16_t		the_old_titlebar_y;
 	
 	if (the_window == NULL)
 	{
@@ -2118,6 +3047,9 @@ void Window_ChangeWindow(Window* the_window, int16_t x, int16_t y, int16_t width
 			width_changed = true;
 		}
 		
+		size_changed = (width_changed || the_window->height_ != height);
+		position_changed = (the_window->x_ != x || the_window->y_ != y);
+		
 		if (update_norm)
 		{
 			the_window->norm_x_ = x;
@@ -2129,6 +3061,11 @@ void Window_ChangeWindow(Window* the_window, int16_t x, int16_t y, int16_t width
 		// get copy of window rect before changing it, for use with calculating damage rects
 		General_CopyRect(&the_old_rect, &the_window->global_rect_);
 		
+		// and of the local rects, for working out which parts of the window need to be redrawn
+		General_CopyRect(&the_old_overall_rect, &the_window->overall_rect_);
+		General_CopyRect(&the_old_content_rect, &the_window->content_rect_);
+		the_old_titlebar_y = the_window->titlebar_rect_.MinY;
+		
 		the_window->x_ = x;
 		the_window->y_ = y;
 		the_window->width_ = width;
@@ -2137,6 +3074,7 @@ void Window_ChangeWindow(Window* the_window, int16_t x, int16_t y, int16_t width
 		the_window->global_rect_.MaxX = the_window->x_ + the_window->width_ - 1;
 		the_window->global_rect_.MinY = the_window->y_;
 		the_window->global_rect_.MaxY = the_window->y_ + the_window->height_ - 1;
+		Sys_UpdateWindowHitArea(global_system, the_window);
 
 		// create damage rects at this point - does not percolate them anywhere, or do any rendering
 		Window_GenerateDamageRects(the_window, &the_old_rect);
@@ -2145,24 +3083,40 @@ void Window_ChangeWindow(Window* the_window, int16_t x, int16_t y, int16_t width
 		// set up the rects for titlebar, content, etc. 
 		Window_ConfigureStructureRects(the_window);
 	
-		// invalidate the window and titlebar so they redraw
-		the_window->invalidated_ = true;
-		Window_InvalidateTitlebar(the_window);
-
-		// get bigger storage if necessary
-		if (Bitmap_Resize(the_window->bitmap_, width, height) == false)
+		// LOGIC:
+		//   the backdrop, and a window that is already due to be redrawn in full (eg, it hasn't been drawn yet), are redrawn in full
+		//   otherwise, the bitmap keeps what was drawn in it, and only what the move or resize changed is redrawn:
+		//     a move with no resize redraws nothing: the window is just re-blitted at its new position
+		//     a resize redraws the newly uncovered content, the border, the titlebar if it changed width or moved, and controls that moved
+		//     a live resize is then about as cheap as a drag
+		
+		redraw_all = (the_window->invalidated_ == true || the_window->is_backdrop_ == true);
+		
+		// get bigger storage if necessary. the pixels the old and new sizes share are kept.
+		if (size_changed && Bitmap_Resize(the_window->bitmap_, width, height) == false)
 		{
 			LOG_ERR(("%s %d: could not resize window storage!", __func__ , __LINE__));
 			goto error;
 		}		
 
-		// when width changes, controls in titlebar, and in content area, need to get re-aligned to new width
-		if (width_changed)
+		// invalidate the window and/or titlebar so they redraw
+		if (redraw_all)
+		{
+			the_window->invalidated_ = true;
+			Window_InvalidateTitlebar(the_window);
+		}
+		else if (width_changed || the_window->titlebar_rect_.MinY != the_old_titlebar_y)
+		{
+			Window_InvalidateTitlebar(the_window);
+		}
+
+		// when size changes, controls in titlebar, and in content area, need to get re-aligned to new size
+		if (size_changed)
 		{
 			Control*	the_control = NULL;
 			
 			// Note: recalculating title space and moving titlebar widgets if width changed is probably slow
-			if ( the_window->is_backdrop_ == false)
+			if (width_changed && the_window->is_backdrop_ == false)
 			{
 				// calculate available title width
 				Window_CalculateTitleSpace(the_window);
@@ -2176,11 +3130,55 @@ void Window_ChangeWindow(Window* the_window, int16_t x, int16_t y, int16_t width
 				// skip aligning title bar controls if this window doesn't even have a titlebar
 				if (Control_GetID(the_control) >= MAX_BUILT_IN_WIDGET || the_window->is_backdrop_ == false)
 				{
+					Rectangle	the_old_control_rect;
+					bool		was_invalidated = the_control->invalidated_;
+					
+					General_CopyRect(&the_old_control_rect, &the_control->rect_);
 					Control_AlignToParentRect(the_control);
+					
+					if (redraw_all == false)
+					{
+						if (the_control->rect_.MinX == the_old_control_rect.MinX && the_control->rect_.MinY == the_old_control_rect.MinY)
+						{
+							// didn't move: it only needs redrawing if it did before, or if the resize redraws what's under it (below)
+							Control_MarkInvalidated(the_control, was_invalidated);
+						}
+						else if (the_control->visible_)
+						{
+							// moved: redraw what it was covering
+							Window_RefreshContentRect(the_window, &the_old_control_rect);
+						}
+					}
 				}
 				
 				the_control = the_control->next_;						
-			}		
+			}
+			
+			// the content may fit now, or not anymore: show or hide the scrollers, and fit them to the new size
+			scroll_changed = Window_LayoutScrollers(the_window, redraw_all == false);
+			
+			if (redraw_all == false && Window_RedrawResizedArea(the_window, &the_old_overall_rect, &the_old_content_rect) == false)
+			{
+				redraw_all = true;
+				the_window->invalidated_ = true;
+				Window_InvalidateTitlebar(the_window);
+			}
+			
+			// growing the window at the end of the content pulled the scroll position back: everything in view moved
+			if (scroll_changed && redraw_all == false)
+			{
+				Rectangle	the_scroll_rect;
+				
+				Window_GetScrollRect(the_window, &the_scroll_rect);
+				Window_RefreshContentRect(the_window, &the_scroll_rect);
+				Window_PostUpdate(the_window, &the_scroll_rect);
+			}
+		}
+		
+		// the whole window is somewhere new on screen: re-blit all of it, without redrawing it
+		if (position_changed && redraw_all == false)
+		{
+			Window_AddClipRect(the_window, &the_window->overall_rect_);
 		}
 	}
 	
@@ -2214,7 +3212,7 @@ void Window_Maximize(Window* the_window)
 
 	Window_SetState(the_window, WIN_MAXIMIZED);
 	Window_ChangeWindow(the_window, 0, 0, the_screen->width_, the_screen->height_, WIN_PARAM_DO_NOT_UPDATE_NORM_SIZE);
-	Sys_Render(global_system);
+	Sys_RequestRender(global_system);
 	
 	return;
 	
@@ -2244,7 +3242,7 @@ void Window_NormSize(Window* the_window)
 
 	Window_SetState(the_window, WIN_NORMAL);
 	Window_ChangeWindow(the_window, the_window->norm_x_, the_window->norm_y_, the_window->norm_width_, the_window->norm_height_, WIN_PARAM_DO_NOT_UPDATE_NORM_SIZE);
-	Sys_Render(global_system);
+	Sys_RequestRender(global_system);
 	
 	return;
 	
@@ -2283,7 +3281,7 @@ void Window_Minimize(Window* the_window)
 	
 	Window_SetState(the_window, WIN_MINIMIZED);
 	Window_SetVisible(the_window, false);
-	Sys_Render(global_system);
+	Sys_RequestRender(global_system);
 	
 	DEBUG_OUT(("%s %d: window '%s' has been minimized", __func__, __LINE__, the_window->title_));
 	
@@ -2354,6 +3352,25 @@ error:
 }
 
 
+//! Get the kinds of event the window's event handler is called for
+//! @param	the_window -- reference to a valid Window object.
+//! @return:	Returns event_mask bits. Returns 0 in any error condition.
+uint32_t Window_GetEventMask(Window* the_window)
+{
+	if (the_window == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		goto error;
+	}
+	
+	return the_window->event_mask_;
+	
+error:
+	Sys_Exit(&global_system, PARAM_EXIT_ON_ERROR);	// crash early, crash often
+	return 0;
+}
+
+
 //! Get the window's type (normal, backdrop, dialog, etc.)
 //! @param	the_window -- reference to a valid Window object.
 //! @return:	Returns a window_type enum. Returns WIN_UNKNOWN_TYPE in any error condition.
@@ -2744,7 +3761,14 @@ bool Window_Blit(Window* the_window, Bitmap* src_bm, int16_t src_x, int16_t src_
 		goto error;
 	}
 	
-	return Bitmap_Blit(src_bm, src_x, src_y, the_window->bitmap_, the_window->pen_x_, the_window->pen_y_, width, height);
+	if (Bitmap_Blit(src_bm, src_x, src_y, the_window->bitmap_, the_window->pen_x_, the_window->pen_y_, width, height) == false)
+	{
+		return false;
+	}
+	
+	Window_AddDirtyRect(the_window, the_window->pen_x_, the_window->pen_y_, the_window->pen_x_ + width - 1, the_window->pen_y_ + height - 1);
+	
+	return true;
 	
 error:
 	Sys_Exit(&global_system, PARAM_EXIT_ON_ERROR);	// crash early, crash often
@@ -2766,7 +3790,14 @@ bool Window_FillBox(Window* the_window, int16_t width, int16_t height, uint8_t t
 		goto error;
 	}
 	
-	return Bitmap_FillBox(the_window->bitmap_, the_window->pen_x_, the_window->pen_y_, width, height, the_color);
+	if (Bitmap_FillBox(the_window->bitmap_, the_window->pen_x_, the_window->pen_y_, width, height, the_color) == false)
+	{
+		return false;
+	}
+	
+	Window_AddDirtyRect(the_window, the_window->pen_x_, the_window->pen_y_, the_window->pen_x_ + width, the_window->pen_y_ + height);
+	
+	return true;
 	
 error:
 	Sys_Exit(&global_system, PARAM_EXIT_ON_ERROR);	// crash early, crash often
@@ -2798,7 +3829,14 @@ bool Window_FillBoxRect(Window* the_window, Rectangle* the_coords, uint8_t the_c
 	x2 = the_coords->MaxX + the_window->content_rect_.MinX;
 	y2 = the_coords->MaxY + the_window->content_rect_.MinY;
 	
-	return Bitmap_FillBox(the_window->bitmap_, x1, y1, x2 - x1, y2 - y1, the_color);
+	if (Bitmap_FillBox(the_window->bitmap_, x1, y1, x2 - x1, y2 - y1, the_color) == false)
+	{
+		return false;
+	}
+	
+	Window_AddDirtyRect(the_window, x1, y1, x2, y2);
+	
+	return true;
 	
 error:
 	Sys_Exit(&global_system, PARAM_EXIT_ON_ERROR);	// crash early, crash often
@@ -2818,7 +3856,14 @@ bool Window_SetPixel(Window* the_window, uint8_t the_color)
 		goto error;
 	}
 	
-	return Bitmap_SetPixelAtXY(the_window->bitmap_, the_window->pen_x_, the_window->pen_y_, the_color);
+	if (Bitmap_SetPixelAtXY(the_window->bitmap_, the_window->pen_x_, the_window->pen_y_, the_color) == false)
+	{
+		return false;
+	}
+	
+	Window_AddDirtyRect(the_window, the_window->pen_x_, the_window->pen_y_, the_window->pen_x_, the_window->pen_y_);
+	
+	return true;
 	
 error:
 	Sys_Exit(&global_system, PARAM_EXIT_ON_ERROR);	// crash early, crash often
@@ -2827,16 +3872,17 @@ error:
 
 
 //! Draws a line between 2 passed coordinates.
-//! Use for any line that is not perfectly vertical or perfectly horizontal
+//! Only the part of the line within the content area is drawn.
 //! @param	the_window -- reference to a valid Window object.
 //! @param	x1 -- the starting horizontal position within the content area of the window
 //! @param	y1 -- the starting vertical position within the content area of the window
 //! @param	x2 -- the ending horizontal position within the content area of the window
 //! @param	y2 -- the ending vertical position within the content area of the window
 //! @param	the_color -- a 1-byte index to the current color LUT
-//! Based on http://rosettacode.org/wiki/Bitmap/Bresenham%27s_line_algorithm#C. Used in C128 Lich King. 
 bool Window_DrawLine(Window* the_window, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint8_t the_color)
 {
+	Rectangle	the_line_rect;
+	
 	if (the_window == NULL)
 	{
 		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
@@ -2849,7 +3895,22 @@ bool Window_DrawLine(Window* the_window, int16_t x1, int16_t y1, int16_t x2, int
 	x2 += the_window->content_rect_.MinX;
 	y2 += the_window->content_rect_.MinY;
 	
-	return Bitmap_DrawLine(the_window->bitmap_, x1, y1, x2, y2, the_color);
+	if (Bitmap_DrawLineClipped(the_window->bitmap_, x1, y1, x2, y2, the_color, &the_window->content_rect_) == false)
+	{
+		return false;
+	}
+	
+	the_line_rect.MinX = (x1 < x2 ? x1 : x2);
+	the_line_rect.MinY = (y1 < y2 ? y1 : y2);
+	the_line_rect.MaxX = (x1 < x2 ? x2 : x1);
+	the_line_rect.MaxY = (y1 < y2 ? y2 : y1);
+	
+	if (General_CalculateRectIntersection(&the_line_rect, &the_window->content_rect_, &the_line_rect))
+	{
+		Window_AddDirtyRect(the_window, the_line_rect.MinX, the_line_rect.MinY, the_line_rect.MaxX, the_line_rect.MaxY);
+	}
+	
+	return true;
 	
 error:
 	Sys_Exit(&global_system, PARAM_EXIT_ON_ERROR);	// crash early, crash often
@@ -2870,7 +3931,14 @@ bool Window_DrawHLine(Window* the_window, int16_t the_line_len, uint8_t the_colo
 		goto error;
 	}
 	
-	return Bitmap_DrawHLine(the_window->bitmap_, the_window->pen_x_, the_window->pen_y_, the_line_len, the_color);
+	if (Bitmap_DrawHLine(the_window->bitmap_, the_window->pen_x_, the_window->pen_y_, the_line_len, the_color) == false)
+	{
+		return false;
+	}
+	
+	Window_AddDirtyRect(the_window, the_window->pen_x_, the_window->pen_y_, the_window->pen_x_ + the_line_len - 1, the_window->pen_y_);
+	
+	return true;
 	
 error:
 	Sys_Exit(&global_system, PARAM_EXIT_ON_ERROR);	// crash early, crash often
@@ -2891,7 +3959,14 @@ bool Window_DrawVLine(Window* the_window, int16_t the_line_len, uint8_t the_colo
 		goto error;
 	}
 	
-	return Bitmap_DrawVLine(the_window->bitmap_, the_window->pen_x_, the_window->pen_y_, the_line_len, the_color);
+	if (Bitmap_DrawVLine(the_window->bitmap_, the_window->pen_x_, the_window->pen_y_, the_line_len, the_color) == false)
+	{
+		return false;
+	}
+	
+	Window_AddDirtyRect(the_window, the_window->pen_x_, the_window->pen_y_, the_window->pen_x_, the_window->pen_y_ + the_line_len - 1);
+	
+	return true;
 	
 error:
 	Sys_Exit(&global_system, PARAM_EXIT_ON_ERROR);	// crash early, crash often
@@ -2923,7 +3998,14 @@ bool Window_DrawBoxRect(Window* the_window, Rectangle* the_coords, uint8_t the_c
 	x2 = the_coords->MaxX + the_window->content_rect_.MinX;
 	y2 = the_coords->MaxY + the_window->content_rect_.MinY;
 	
-	return Bitmap_DrawBoxCoords(the_window->bitmap_, x1, y1, x2, y2, the_color);
+	if (Bitmap_DrawBoxCoords(the_window->bitmap_, x1, y1, x2, y2, the_color) == false)
+	{
+		return false;
+	}
+	
+	Window_AddDirtyRect(the_window, x1, y1, x2, y2);
+	
+	return true;
 	
 error:
 	Sys_Exit(&global_system, PARAM_EXIT_ON_ERROR);	// crash early, crash often
@@ -2953,7 +4035,14 @@ bool Window_DrawBoxCoords(Window* the_window, int16_t x1, int16_t y1, int16_t x2
 	x2 += the_window->content_rect_.MinX;
 	y2 += the_window->content_rect_.MinY;
 	
-	return Bitmap_DrawBoxCoords(the_window->bitmap_, x1, y1, x2, y2, the_color);
+	if (Bitmap_DrawBoxCoords(the_window->bitmap_, x1, y1, x2, y2, the_color) == false)
+	{
+		return false;
+	}
+	
+	Window_AddDirtyRect(the_window, x1, y1, x2, y2);
+	
+	return true;
 	
 error:
 	Sys_Exit(&global_system, PARAM_EXIT_ON_ERROR);	// crash early, crash often
@@ -2976,7 +4065,14 @@ bool Window_DrawBox(Window* the_window, int16_t width, int16_t height, uint8_t t
 		goto error;
 	}
 	
-	return Bitmap_DrawBox(the_window->bitmap_, the_window->pen_x_, the_window->pen_y_, width, height, the_color, do_fill);
+	if (Bitmap_DrawBox(the_window->bitmap_, the_window->pen_x_, the_window->pen_y_, width, height, the_color, do_fill) == false)
+	{
+		return false;
+	}
+	
+	Window_AddDirtyRect(the_window, the_window->pen_x_, the_window->pen_y_, the_window->pen_x_ + width - 1, the_window->pen_y_ + height - 1);
+	
+	return true;
 	
 error:
 	Sys_Exit(&global_system, PARAM_EXIT_ON_ERROR);	// crash early, crash often
@@ -2988,7 +4084,7 @@ error:
 //! @param	the_window -- reference to a valid Window object.
 //! @param	width -- width, in pixels, of the rectangle to be drawn
 //! @param	height -- height, in pixels, of the rectangle to be drawn
-//! @param	radius -- radius, in pixels, of the arc to be applied to the rectangle's corners. Minimum 3, maximum 20.
+//! @param	radius -- radius, in pixels, of the arc to be applied to the rectangle's corners. 0 draws square corners. A radius too big for the box is reduced to the largest that fits.
 //! @param	the_color -- a 1-byte index to the current color LUT
 //! @param	do_fill -- If true, the box will be filled with the provided color. If false, the box will only draw the outline.
 //! @return:	returns false on any error/invalid input.
@@ -3000,7 +4096,14 @@ bool Window_DrawRoundBox(Window* the_window, int16_t width, int16_t height, int1
 		goto error;
 	}
 	
-	return Bitmap_DrawRoundBox(the_window->bitmap_, the_window->pen_x_, the_window->pen_y_, width, height, radius, the_color, do_fill);
+	if (Bitmap_DrawRoundBox(the_window->bitmap_, the_window->pen_x_, the_window->pen_y_, width, height, radius, the_color, do_fill) == false)
+	{
+		return false;
+	}
+	
+	Window_AddDirtyRect(the_window, the_window->pen_x_, the_window->pen_y_, the_window->pen_x_ + width - 1, the_window->pen_y_ + height - 1);
+	
+	return true;
 	
 error:
 	Sys_Exit(&global_system, PARAM_EXIT_ON_ERROR);	// crash early, crash often
@@ -3013,7 +4116,8 @@ error:
 //! @param	the_window -- reference to a valid Window object.
 //! @param	radius -- radius, in pixels, measured from the window's current pen location
 //! @param	the_color -- a 1-byte index to the current color LUT
-bool Window_DrawCircle(Window* the_window, int16_t radius, uint8_t the_color)
+//! @param	do_fill -- If true, the circle will be filled with the provided color. If false, only the outline will be drawn.
+bool Window_DrawCircle(Window* the_window, int16_t radius, uint8_t the_color, bool do_fill)
 {
 	if (the_window == NULL)
 	{
@@ -3021,7 +4125,14 @@ bool Window_DrawCircle(Window* the_window, int16_t radius, uint8_t the_color)
 		goto error;
 	}
 	
-	return Bitmap_DrawCircle(the_window->bitmap_, the_window->pen_x_, the_window->pen_y_, radius, the_color);
+	if (Bitmap_DrawCircle(the_window->bitmap_, the_window->pen_x_, the_window->pen_y_, radius, the_color, do_fill) == false)
+	{
+		return false;
+	}
+	
+	Window_AddDirtyRect(the_window, the_window->pen_x_ - radius, the_window->pen_y_ - radius, the_window->pen_x_ + radius, the_window->pen_y_ + radius);
+	
+	return true;
 	
 error:
 	Sys_Exit(&global_system, PARAM_EXIT_ON_ERROR);	// crash early, crash often
@@ -3036,13 +4147,28 @@ error:
 // If max_chars is -1, then the full string length will be drawn, as space allows.
 bool Window_DrawString(Window* the_window, char* the_string, int16_t max_chars)
 {
+	int16_t		start_x;
+	
 	if (the_window == NULL)
 	{
 		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
 		goto error;
 	}
 	
-	return Font_DrawString(the_window->bitmap_, the_string, max_chars);
+	start_x = the_window->bitmap_->x_;
+	
+	if (Font_DrawString(the_window->bitmap_, the_string, max_chars) == false)
+	{
+		return false;
+	}
+	
+	// the bitmap's pen is left just after the last character drawn, on the same line
+	if (the_window->bitmap_->x_ > start_x)
+	{
+		Window_AddDirtyRect(the_window, start_x, the_window->bitmap_->y_, the_window->bitmap_->x_ - 1, the_window->bitmap_->y_ + the_window->bitmap_->font_->fRectHeight - 1);
+	}
+	
+	return true;
 	
 error:
 	Sys_Exit(&global_system, PARAM_EXIT_ON_ERROR);	// crash early, crash often
@@ -3063,6 +4189,10 @@ error:
 //! @return:	returns a pointer to the first character in the string after which it stopped processing (if string is too long to be displayed in its entirety). Returns the original string if the entire string was processed successfully. Returns NULL in the event of any error.
 char* Window_DrawStringInBox(Window* the_window, int16_t width, int16_t height, char* the_string, int16_t num_chars, char** wrap_buffer, bool (* continue_function)(void))
 {
+	int16_t		start_x;
+	int16_t		start_y;
+	char*		the_remainder;
+	
 	if (the_window == NULL)
 	{
 		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
@@ -3080,7 +4210,17 @@ char* Window_DrawStringInBox(Window* the_window, int16_t width, int16_t height,
 		height -= the_window->inner_height_ - the_window->pen_y_;
 	}
 	
-	return Font_DrawStringInBox(the_window->bitmap_, width, height, the_string, num_chars, wrap_buffer, continue_function);
+	start_x = the_window->bitmap_->x_;
+	start_y = the_window->bitmap_->y_;
+	
+	the_remainder = Font_DrawStringInBox(the_window->bitmap_, width, height, the_string, num_chars, wrap_buffer, continue_function);
+	
+	if (the_remainder != NULL)
+	{
+		Window_AddDirtyRect(the_window, start_x, start_y, start_x + width - 1, start_y + height - 1);
+	}
+	
+	return the_remainder;
 	
 error:
 	Sys_Exit(&global_system, PARAM_EXIT_ON_ERROR);	// crash early, crash often
@@ -3089,6 +4229,377 @@ error:
 
 
 
+// **** BATCH DRAW functions *****
+
+//! Start a new draw batch for the window, discarding the previous one
+//! Use a batch instead of individual Window_Draw* calls when drawing many primitives at once (charts, grids, lists, etc.)
+//! The batch is kept after it is submitted, and is drawn again automatically whenever the whole window has to be redrawn
+//! @param	the_window -- reference to a valid Window object.
+//! @return:	returns false on any error/invalid input.
+bool Window_BeginBatch(Window* the_window)
+{
+	if (the_window == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		goto error;
+	}
+	
+	// storage is kept for reuse: apps typically rebuild a batch of about the same size on every update
+	the_window->batch_count_ = 0;
+	the_window->batch_open_ = true;
+	
+	return true;
+	
+error:
+	Sys_Exit(&global_system, PARAM_EXIT_ON_ERROR);	// crash early, crash often
+	return false;
+}
+
+
+//! Add one draw command to the window's open batch. Nothing is drawn or checked until the batch is submitted.
+//! @param	the_window -- reference to a valid Window object, with a batch started with Window_BeginBatch()
+//! @param	the_op -- the command to add. It is copied, so it can be reused for the next command.
+//! @return:	returns false if no batch was open, or if there was not enough memory to add the command
+bool Window_AppendOp(Window* the_window, WindowDrawOp* the_op)
+{
+	WindowDrawOp*	new_ops;
+	uint32_t		new_max;
+	
+	if (the_window == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		goto error;
+	}
+	
+	if (the_op == NULL || the_window->batch_open_ == false)
+	{
+		LOG_ERR(("%s %d: passed op was null, or no batch was open", __func__ , __LINE__));
+		return false;
+	}
+	
+	if (the_window->batch_count_ >= the_window->batch_max_)
+	{
+		if (the_window->batch_max_ >= WIN_BATCH_MAX_OPS)
+		{
+			LOG_ERR(("%s %d: draw batch already has the maximum of %u ops", __func__ , __LINE__, WIN_BATCH_MAX_OPS));
+			return false;
+		}
+		
+		new_max = (uint32_t)the_window->batch_max_ * 2;
+		
+		if (new_max < WIN_BATCH_MIN_OPS)
+		{
+			new_max = WIN_BATCH_MIN_OPS;
+		}
+		
+		if (new_max > WIN_BATCH_MAX_OPS)
+		{
+			new_max = WIN_BATCH_MAX_OPS;
+		}
+		
+		if ( (new_ops = (WindowDrawOp*)realloc(the_window->batch_ops_, new_max * sizeof(WindowDrawOp)) ) == NULL)
+		{
+			LOG_ERR(("%s %d: could not grow draw batch to %lu ops", __func__ , __LINE__, new_max));
+			return false;
+		}
+		LOG_ALLOC(("%s %d:	__ALLOC__	the_window->batch_ops_	%p	size	%i", __func__ , __LINE__, new_ops, new_max * sizeof(WindowDrawOp)));
+		TRACK_ALLOC(((new_max - the_window->batch_max_) * sizeof(WindowDrawOp)));
+		
+		the_window->batch_ops_ = new_ops;
+		the_window->batch_max_ = new_max;
+	}
+	
+	the_window->batch_ops_[the_window->batch_count_++] = *the_op;
+	
+	return true;
+	
+error:
+	Sys_Exit(&global_system, PARAM_EXIT_ON_ERROR);	// crash early, crash often
+	return false;
+}
+
+
+//! Draw every command in the window's open batch, and mark the area drawn to be blitted in the next render
+//! Commands are clipped to the window's content area. Commands of an unknown type, or with a NULL bitmap/string, are skipped.
+//! @param	the_window -- reference to a valid Window object, with a batch started with Window_BeginBatch()
+//! @return:	returns false if no batch was open
+bool Window_SubmitBatch(Window* the_window)
+{
+	Rectangle	the_dirty_rect;
+	
+	if (the_window == NULL || the_window->bitmap_ == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null, or had no bitmap", __func__ , __LINE__));
+		goto error;
+	}
+	
+	if (the_window->batch_open_ == false)
+	{
+		LOG_ERR(("%s %d: no batch was open", __func__ , __LINE__));
+		return false;
+	}
+	
+	the_window->batch_open_ = false;
+	
+	Window_RunBatch(the_window, NULL, &the_dirty_rect);
+	
+	if (the_dirty_rect.MaxX >= the_dirty_rect.MinX)
+	{
+		Window_AddClipRect(the_window, &the_dirty_rect);
+		Sys_RequestRender(global_system);
+	}
+	
+	return true;
+	
+error:
+	Sys_Exit(&global_system, PARAM_EXIT_ON_ERROR);	// crash early, crash often
+	return false;
+}
+
+
+
+// **** SCROLLING functions *****
+
+//! Tell the window how big its content is. The window shows a scroller from the theme for each direction the content doesn't fit in.
+//! If the content shrinks so that the current scroll position is out of range, the window is scrolled back, and the content area is redrawn.
+//! @param	the_window -- reference to a valid Window object.
+//! @param	width -- the width of all the content, in pixels
+//! @param	height -- the height of all the content, in pixels
+//! @return:	returns false on any error/invalid input.
+bool Window_SetContentSize(Window* the_window, int16_t width, int16_t height)
+{
+	Rectangle	the_scroll_rect;
+	bool		do_refresh;
+	
+	if (the_window == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		goto error;
+	}
+	
+	if (width < 0 || height < 0)
+	{
+		LOG_ERR(("%s %d: content size can't be negative", __func__ , __LINE__));
+		return false;
+	}
+	
+	the_window->required_inner_width_ = width;
+	the_window->required_inner_height_ = height;
+	
+	// a window that will be redrawn in full anyway doesn't need anything refreshed piecemeal
+	do_refresh = (the_window->invalidated_ == false && the_window->bitmap_ != NULL);
+	
+	if (Window_LayoutScrollers(the_window, do_refresh) && do_refresh)
+	{
+		Window_GetScrollRect(the_window, &the_scroll_rect);
+		Window_RefreshContentRect(the_window, &the_scroll_rect);
+		Window_PostUpdate(the_window, &the_scroll_rect);
+	}
+	
+	Sys_RequestRender(global_system);
+	
+	return true;
+	
+error:
+	Sys_Exit(&global_system, PARAM_EXIT_ON_ERROR);	// crash early, crash often
+	return false;
+}
+
+
+//! Scroll the content area by the passed distances, limited to the content size set with Window_SetContentSize()
+//! The pixels still in view are moved with one overlapping blit. Only the strips scrolled into view are redrawn: 
+//!   they are cleared, the window's draw batch (if any) is replayed into them, and an updateEvt is posted to the window for each one.
+//!   The updateEvt's x, y, width, and height describe the strip, relative to the content area (the coordinates the Window_Draw functions use). Add content_left_/content_top_ for the position within the content.
+//! Controls in the content area (other than the scrollers) stay where they are: the area their moved copy landed on is redrawn like a strip.
+//! @param	the_window -- reference to a valid Window object.
+//! @param	dx -- number of pixels to scroll right. Negative values scroll left.
+//! @param	dy -- number of pixels to scroll down. Negative values scroll up.
+//! @return:	returns false on any error/invalid input. Returns true, without doing anything, if the window can't scroll any further in that direction.
+bool Window_ScrollBy(Window* the_window, int16_t dx, int16_t dy)
+{
+	Rectangle	the_area;
+	Rectangle	the_strip;
+	Rectangle	the_ghost;
+	Control*	the_control;
+	int16_t		the_width;
+	int16_t		the_height;
+	int16_t		max_left;
+	int16_t		max_top;
+	int16_t		new_left;
+	int16_t		new_top;
+	int16_t		abs_dx;
+	int16_t		abs_dy;
+	
+	if (the_window == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		goto error;
+	}
+	
+	if (the_window->bitmap_ == NULL)
+	{
+		LOG_ERR(("%s %d: window has no bitmap", __func__ , __LINE__));
+		return false;
+	}
+	
+	// LOGIC:
+	//   scrolling by dy moves everything in view up by dy. the pixels that stay in view are moved with one blit: 
+	//     Bitmap_Blit copies in whichever direction is safe when source and destination overlap.
+	//   only the strips that come into view need drawing. this turns a scroll from a redraw of the whole content area
+	//     into a blit, plus a redraw of a strip as tall as the distance scrolled.
+	//   everything in the content area scrolls, except the controls: they are redrawn where they were, 
+	//     and the copy of them that the blit moved is covered up by redrawing the content under it.
+	
+	Window_GetScrollRect(the_window, &the_area);
+	the_width = the_area.MaxX - the_area.MinX + 1;
+	the_height = the_area.MaxY - the_area.MinY + 1;
+	
+	if (the_width < 1 || the_height < 1)
+	{
+		return true;
+	}
+	
+	// keep the scroll position within the content
+	max_left = the_window->required_inner_width_ - the_width;
+	max_top = the_window->required_inner_height_ - the_height;
+	max_left = (max_left < 0 ? 0 : max_left);
+	max_top = (max_top < 0 ? 0 : max_top);
+	
+	new_left = the_window->content_left_ + dx;
+	new_top = the_window->content_top_ + dy;
+	new_left = (new_left < 0 ? 0 : (new_left > max_left ? max_left : new_left));
+	new_top = (new_top < 0 ? 0 : (new_top > max_top ? max_top : new_top));
+	
+	dx = new_left - the_window->content_left_;
+	dy = new_top - the_window->content_top_;
+	
+	if (dx == 0 && dy == 0)
+	{
+		return true;
+	}
+	
+	the_window->content_left_ = new_left;
+	the_window->content_top_ = new_top;
+	
+	// move the scroller thumbs
+	Window_LayoutScrollers(the_window, false);
+	
+	if (the_window->h_scroller_visible_)
+	{
+		Control_MarkInvalidated(Window_GetControl(the_window, H_SCROLLER_WIDGET_ID), true);
+	}
+	
+	if (the_window->v_scroller_visible_)
+	{
+		Control_MarkInvalidated(Window_GetControl(the_window, V_SCROLLER_WIDGET_ID), true);
+	}
+	
+	// a window that will be redrawn in full anyway just needs its owner to know the content moved
+	if (the_window->invalidated_)
+	{
+		Window_PostUpdate(the_window, &the_area);
+		Sys_RequestRender(global_system);
+		return true;
+	}
+	
+	abs_dx = (dx < 0 ? -dx : dx);
+	abs_dy = (dy < 0 ? -dy : dy);
+	
+	// scrolled by more than a screenful: nothing in view stays in view
+	if (abs_dx >= the_width || abs_dy >= the_height)
+	{
+		Window_RefreshContentRect(the_window, &the_area);
+		Window_PostUpdate(the_window, &the_area);
+		Sys_RequestRender(global_system);
+		return true;
+	}
+	
+	Bitmap_Blit(the_window->bitmap_, the_area.MinX + (dx > 0 ? dx : 0), the_area.MinY + (dy > 0 ? dy : 0), 
+				the_window->bitmap_, the_area.MinX + (dx < 0 ? abs_dx : 0), the_area.MinY + (dy < 0 ? abs_dy : 0), 
+				the_width - abs_dx, the_height - abs_dy);
+	Window_AddClipRect(the_window, &the_area);
+	
+	// cover up the moved copies of the controls, and put the controls back on top
+	the_control = Window_GetRootControl(the_window);
+	
+	while (the_control)
+	{
+		// only the part of a control within the area was moved. titlebar controls are never in it.
+		if (the_control->visible_ && the_control->id_ != H_SCROLLER_WIDGET_ID && the_control->id_ != V_SCROLLER_WIDGET_ID && 
+			General_CalculateRectIntersection(&the_control->rect_, &the_area, &the_ghost))
+		{
+			the_ghost.MinX -= dx;
+			the_ghost.MaxX -= dx;
+			the_ghost.MinY -= dy;
+			the_ghost.MaxY -= dy;
+			
+			if (General_CalculateRectIntersection(&the_ghost, &the_area, &the_strip))
+			{
+				Window_RefreshContentRect(the_window, &the_strip);
+				Window_PostUpdate(the_window, &the_strip);
+				Control_MarkInvalidated(the_control, true);
+			}
+		}
+		
+		the_control = the_control->next_;
+	}
+	
+	// the rows scrolled into view, the whole width of the area
+	if (dy != 0)
+	{
+		General_CopyRect(&the_strip, &the_area);
+		
+		if (dy > 0)
+		{
+			the_strip.MinY = the_area.MaxY - abs_dy + 1;
+		}
+		else
+		{
+			the_strip.MaxY = the_area.MinY + abs_dy - 1;
+		}
+		
+		Window_RefreshContentRect(the_window, &the_strip);
+		Window_PostUpdate(the_window, &the_strip);
+	}
+	
+	// the columns scrolled into view, less the rows already redrawn
+	if (dx != 0)
+	{
+		General_CopyRect(&the_strip, &the_area);
+		
+		if (dx > 0)
+		{
+			the_strip.MinX = the_area.MaxX - abs_dx + 1;
+		}
+		else
+		{
+			the_strip.MaxX = the_area.MinX + abs_dx - 1;
+		}
+		
+		if (dy > 0)
+		{
+			the_strip.MaxY = the_area.MaxY - abs_dy;
+		}
+		else if (dy < 0)
+		{
+			the_strip.MinY = the_area.MinY + abs_dy;
+		}
+		
+		Window_RefreshContentRect(the_window, &the_strip);
+		Window_PostUpdate(the_window, &the_strip);
+	}
+	
+	Sys_RequestRender(global_system);
+	
+	return true;
+	
+error:
+	Sys_Exit(&global_system, PARAM_EXIT_ON_ERROR);	// crash early, crash often
+	return false;
+}
+
+
+
 
 // **** Get functions *****
 
@@ -25,6 +25,8 @@
  * Manage state of all controls on the window
  * Handle resizing/minimizing/maximizing of window
  * Reposition controls on window in response to resize events
+ * Track the areas changed by drawing calls, so renders only blit what changed
+ * Scroll the content area, moving what is in view with a blit and redrawing only what scrolls into view
  * 
  *
  * STRETCH GOALS
@@ -72,7 +74,6 @@
 
 #define WINDOW_MAX_WINTITLE_SIZE		128
 
-#define WIN_MAX_CLIP_RECTS				10	//! if a window accumulates more clip rects than this, it will refresh the entire window in one go
 #define WIN_MENU_MAX_GROUPS				4	//! Maximum number of menus levels that can be defined per window
 
 #define WIN_PARAM_OPEN_AS_BACKDROP				true	// Window_New() parameter
@@ -84,6 +85,11 @@
 #define WIN_PARAM_UPDATE_NORM_SIZE_TO_MATCH		true	// Window_ChangeWindow() parameter
 #define WIN_PARAM_DO_NOT_UPDATE_NORM_SIZE		false	// Window_ChangeWindow() parameter
 
+#define WIN_DEFAULT_EVENT_MASK	(EVENT_WINDOW_MASK & ~mouseMovedMask)	// event kinds a new window subscribes to. Following the mouse costs an event per move, so windows must ask for mouseMoved.
+
+#define WIN_BATCH_MIN_OPS		32		// when a window's draw batch first needs storage, it allocates at least this many ops. Storage doubles as needed after that.
+#define WIN_BATCH_MAX_OPS		16384	// most ops a window's draw batch can hold. Window_AppendOp() fails once a batch has this many.
+
 
 /*****************************************************************************/
 /*                               Enumerations                                */
@@ -113,8 +119,28 @@ typedef enum window_base_control_id
 	NORM_SIZE_WIDGET_ID		= 2,
 	MAXIMIZE_WIDGET_ID		= 3,
 	MAX_BUILT_IN_WIDGET		= 4,
+	H_SCROLLER_WIDGET_ID	= 0x7FF0,	// the window's scrollers: added by the window when its content doesn't fit. IDs kept clear of the titlebar widgets and of programmer-assigned IDs.
+	V_SCROLLER_WIDGET_ID	= 0x7FF1,
 } window_base_control_id;
 
+typedef enum window_draw_op_type
+{
+	WIN_OP_LINE				= 0,	// line from x1_, y1_ to x2_, y2_
+	WIN_OP_HLINE			= 1,	// horizontal line on row y1_, from x1_ to x2_
+	WIN_OP_VLINE			= 2,	// vertical line on column x1_, from y1_ to y2_
+	WIN_OP_BOX				= 3,	// outline of the box x1_, y1_ to x2_, y2_
+	WIN_OP_FILL				= 4,	// fill the box x1_, y1_ to x2_, y2_
+	WIN_OP_BLIT				= 5,	// copy pixels from the Bitmap in data_, starting at src_x_, src_y_, into the box x1_, y1_ to x2_, y2_
+	WIN_OP_TEXT				= 6,	// draw the string in data_ with the window's font, starting at x1_, y1_. src_x_ is the max chars to draw (-1 for all)
+	WIN_OP_UNKNOWN,
+} window_draw_op_type;
+
+typedef enum window_drag_mode
+{
+	WIN_DRAG_OUTLINE		= 0,	// while dragging/resizing, only an XOR outline moves; the window is changed once, on mouse up
+	WIN_DRAG_LIVE			= 1,	// while dragging, the window itself is moved on every mouse move
+} window_drag_mode;
+
 
 
 
@@ -131,6 +157,20 @@ struct ClipRect
 	int16_t					height_;	
 };
 
+//! One command in a window's draw batch. All coordinates are inclusive, and relative to the top left of the window's content as if it were not scrolled.
+struct WindowDrawOp
+{
+	uint8_t					type_;							// one of the window_draw_op_type values
+	uint8_t					color_;							// LUT index to draw with. Not used by WIN_OP_BLIT.
+	int16_t					x1_;
+	int16_t					y1_;
+	int16_t					x2_;
+	int16_t					y2_;
+	int16_t					src_x_;							// WIN_OP_BLIT: left edge of the area to copy from the source bitmap. WIN_OP_TEXT: max chars to draw.
+	int16_t					src_y_;							// WIN_OP_BLIT: top edge of the area to copy from the source bitmap
+	void*					data_;							// WIN_OP_BLIT: source Bitmap*. WIN_OP_TEXT: null-terminated string. Must stay valid as long as the batch may be replayed.
+};
+
 struct Window
 {
 	uint8_t					id_;							// reserved. Not currently used.
@@ -185,22 +225,30 @@ struct Window
 	int16_t					inner_width_;					// space available inside the content area, accounting for border thicknesses
 	int16_t					inner_height_;					// space available inside the content area, accounting for border thicknesses and title bar
 	int16_t					avail_title_width_;				// available pixel width for the title to be rendered, based on delta between title x offset and left-most titlebar control
-	int16_t					content_left_;					// of the raw x pos of the window (non-gzz), the x pos where window should start rendering content. =gzz_left_ until window is scrolled leftwards
-	int16_t					content_top_;					// of the raw y pos of the window (non-gzz), the y pos where window should start rendering content. =gzz_top_ until window is scrolled down
-	int16_t					required_inner_width_;			// greater of current inner_width or H space required inside the window to display all content. If greater than H space, a scroller is needed.
-	int16_t					required_inner_height_;			// greater of current inner_height or V space required inside the window to display all content. If greater than V space, a scroller is needed.
-	bool					h_scroller_visible_;
-	bool					v_scroller_visible_;
+	int16_t					content_left_;					// horizontal scroll position: the H position within the content that is shown at the left edge of the content area. 0 until the window is scrolled. See Window_ScrollBy().
+	int16_t					content_top_;					// vertical scroll position: the V position within the content that is shown at the top edge of the content area. 0 until the window is scrolled.
+	int16_t					required_inner_width_;			// H space required inside the window to display all content, as set by Window_SetContentSize(). If greater than H space, a scroller is needed.
+	int16_t					required_inner_height_;			// V space required inside the window to display all content, as set by Window_SetContentSize(). If greater than V space, a scroller is needed.
+	bool					h_scroller_visible_;			// read-only: true while the content is wider than the window, and the theme has a horizontal scroller
+	bool					v_scroller_visible_;			// read-only: true while the content is taller than the window, and the theme has a vertical scroller
 	Bitmap*					pattern_;						// optional pattern used for filling the window content rect background on refresh. 
 	Window*					parent_window_;					// can be NULL. used for requesters that are spawned from a specific window.
 	Window*					child_window_;					// can be NULL. used when a window spawns a requester. (This is the requester). NULLs out again when requester is closed. 
 	Control*				root_control_;					// first control in the window
 	Control*				selected_control_;				// the currently selected control for the window. Only 1 can be selected per window. No guarantee that any are selected.
-	Rectangle				clip_rect_[WIN_MAX_CLIP_RECTS];		// one or more clipping rects; determines which parts of window need to be blitted to the main screen
-	int16_t					clip_count_;					// number of clip rects the window is currently tracking
-	Rectangle				damage_rect_[4];				// 0 to 4 rects that describe to other windows under this one, which parts of the screen were previously covered by this window (prior to a move or resize)
-	int16_t					damage_count_;					// number of damage rects the window is currently tracking
+	Region*					clip_region_;					// window-local area that needs to be blitted to the main screen. Overlapping clip rects are merged, so no pixel is blitted twice.
+	Region*					damage_region_;					// global area that describes to other windows under this one, which parts of the screen were previously covered by this window (prior to a move or resize)
+	Region*					visible_region_;				// window-local area not covered by any window in front of this one. Recalculated by the system each time the window renders. Only this area is ever blitted to the screen.
+	Region*					untiled_region_;				// backdrop windows only: window-local area of the bitmap that has not been re-tiled with the pattern since the window was last invalidated. NULL for other windows.
+	uint32_t				pixels_blitted_;				// number of pixels written to the screen by the most recent render
+	uint32_t				pixels_hidden_;					// number of pixels the most recent render skipped because windows in front of this one cover them
+	WindowDrawOp*			batch_ops_;						// the window's draw batch: built with Window_AppendOp(), drawn by Window_SubmitBatch(), and kept so it can be redrawn when the window is invalidated
+	uint16_t				batch_count_;					// number of ops in batch_ops_
+	uint16_t				batch_max_;						// number of ops batch_ops_ has room for. Never more than WIN_BATCH_MAX_OPS.
+	bool					batch_open_;					// true between Window_BeginBatch() and Window_SubmitBatch()
 	void					(*event_handler_)(EventRecord*);	// function that will be called by the system when an event related to the window is encountered.
+	uint32_t				event_mask_;					// event_mask bits for the event kinds event_handler_ is called for. See Window_SetEventMask().
+	bool					subscribed_;					// true while event_mask_ is counted in the event manager's subscriptions: from Sys_AddToWindowList() until the window is closed
 	Menu*					menu_[WIN_MENU_MAX_GROUPS];				// non-permanent containers for menu structures; will be used for first, 2nd, 3rd, and 4th level menus as used in the window.
 	int16_t					current_menu_level_;			// index to menu_[]; starts out at menu_no_menu; when a menu is opened, it goes to menu_level_0; increases with each submenu. Resets to menu_no_men uon close of menu.
 // 	Window*					zoom_to_window_;				// the window that contains the zoom_to_file, so we can get offset to global screen coords
@@ -273,33 +321,34 @@ NewWinTemplate* Window_GetNewWinTemplate(char* the_win_title);
 
 // **** CLIP RECT MANAGEMENT functions *****
 
-//! Copy the passed rectangle to the window's clip rect collection
-//! If the window already has the maximum allowed number of clip rects, the rectangle will not be added.
+//! Add the passed rectangle to the window's clip region
+//! Any part of the rectangle that overlaps area already in the clip region is merged with it, so it will only be blitted once.
 //! NOTE: the incoming rect must be using window-local coordinates, not global. No translation will be performed.
 //! @param	the_window -- reference to a valid Window object.
 //! @param	new_rect -- reference to the rectangle describing the coordinates to be added to the window as a clipping rect. Coordinates of this rect must be window-local! Coordinates in rect are copied to window storage, so it is safe to free the rect after calling this function.
-//! @return:	Returns true if rect is copied successfully. Returns false on any error, or if the window already had the maximum number of allowed clip rects.
+//! @return:	Returns true if rect is added successfully. Returns false on any error.
 bool Window_AddClipRect(Window* the_window, Rectangle* new_rect);
 
 //! Merge and de-duplicate clip rects
-//! Consolidating the clip rects will happen reduce unnecessary reblitting
+//! The clip region merges rects as they are added, so there is nothing left to do here. Kept for compatibility.
 //! @param	the_window -- reference to a valid Window object.
+//! @return:	Returns true unless the window is NULL
 bool Window_MergeClipRects(Window* the_window);
 
-//! Blit each clip rect to the screen, and clear all clip rects when done
+//! Blit each rect of the clip region to the screen, and empty the clip region when done
 //! This is the actual mechanics of rendering the window to the screen
 //! @param	the_window -- reference to a valid Window object.
 //! @return:	Returns true if there are either no clips to blit, or if there are clips and they are blitted successfully. Returns false on any error.
 bool Window_BlitClipRects(Window* the_window);
 
-//! Calculate damage rects, if any, caused by window moving or being resized
-//! NOTE: it is not necessarily an error condition if a given window doesn't end up with damage rects as a result of this operation: if the window rect doesn't intersect the incoming rect, no damage is relevant.
+//! Calculate damage region, if any, caused by window moving or being resized: the part of the old rect no longer covered by the window
+//! NOTE: it is not necessarily an error condition if a given window doesn't end up with damage rects as a result of this operation: if the new window rect covers the old one, no damage is relevant.
 //! @param	the_window -- reference to a valid Window object.
 //! @param	the_old_rect -- reference to the rectangle to be checked for overlap with the specified window. Coordinates of this rect must be global!
 //! @return:	Returns true if 1 or more damage rects were created. Returns false on any error condition, or if no damage rects needed to be created.
 bool Window_GenerateDamageRects(Window* the_window, Rectangle* the_old_rect);
 
-//! Copy the passed rectangle to the window's clip rect collection, translating to local coordinates as it does so
+//! Add the passed rectangle to the window's clip region, translating to local coordinates as it does so
 //! NOTE: the incoming rect is assumed to be using global, not window-local coordinates. Coordinates will be translated to window-local. 
 //! Note: it is safe to pass non-intersecting rects to this function: it will check for non-intersection; will trim copy of clip to just the intersection
 //! @param	the_window -- reference to a valid Window object.
@@ -419,6 +468,13 @@ void Window_SetTitle(Window* the_window, char* the_title);
 //! @param	is_visible -- set to true if window should be rendered in the next pass, false if not
 void Window_SetVisible(Window* the_window, bool is_visible);
 
+//! Set which kinds of event the window's event handler is called for
+//! Events of kinds no window subscribes to are thrown away as they happen, so they never use up a slot in the event queue.
+//! NOTE: new windows subscribe to WIN_DEFAULT_EVENT_MASK: every kind a window can be given, except mouseMoved
+//! @param	the_window -- reference to a valid Window object.
+//! @param	the_mask -- event_mask bits (eg, keyDownMask | mouseMovedMask). Bits outside EVENT_WINDOW_MASK are ignored.
+void Window_SetEventMask(Window* the_window, uint32_t the_mask);
+
 //! Set the display order of the window
 //! NOTE: This does not immediately re-render or change the display order visibly.
 //! WARNING: This function is designed to be called by the system only: do not use this
@@ -450,6 +506,7 @@ void Window_EvaluateWindowChange(Window* the_window, int16_t* x, int16_t* y, int
 //! Change position and/or size of window
 //! NOTE: passed x, y will be checked against the window's min/max values
 //! Will also adjust the position of the built-in maximize/minimize/normsize controls
+//! What is already drawn in the window is kept: a move only re-blits the window, and a resize only redraws the newly uncovered content, the border, and the titlebar and controls if they changed
 //! @param	the_window -- reference to a valid Window object.
 //! @param	x -- The new global horizontal position
 //! @param	y -- The new global vertical position
@@ -490,6 +547,11 @@ char* Window_GetTitle(Window* the_window);
 //! @return:	Returns an unsigned 32 bit value. Returns 0 in any error condition.
 uint32_t Window_GetUserData(Window* the_window);
 
+//! Get the kinds of event the window's event handler is called for
+//! @param	the_window -- reference to a valid Window object.
+//! @return:	Returns event_mask bits. Returns 0 in any error condition.
+uint32_t Window_GetEventMask(Window* the_window);
+
 //! Get the window's type (normal, backdrop, dialog, etc.)
 //! @param	the_window -- reference to a valid Window object.
 //! @return:	Returns a window_type enum. Returns WIN_UNKNOWN_TYPE in any error condition.
@@ -547,6 +609,7 @@ bool Window_IsActive(Window* the_window);
 // **** RENDER functions *****
 
 //! Draw/re-draw any necessary components, and blit the window (or parts of it, via cliprects) to the screen
+//! Only the parts of the window not covered by windows in front of it are blitted. pixels_blitted_ and pixels_hidden_ are updated to reflect what was skipped.
 //! @param	the_window -- reference to a valid Window object.
 void Window_Render(Window* the_window);
 
@@ -567,6 +630,9 @@ void Window_Invalidate(Window* the_window);
 
 // **** DRAW functions *****
 
+// The Window_Draw*, Window_FillBox*, Window_SetPixel, and Window_Blit functions add the area they drew to the window's clip region, 
+//   and request a render, so only what changed is blitted to the screen. There is no need to invalidate the window after drawing.
+
 //! Convert the passed x, y global coordinates to local (to window) coordinates
 //! @param	the_window -- reference to a valid Window object.
 //! @param	x -- the global horizontal position to be converted to window-local.
@@ -647,14 +713,13 @@ bool Window_FillBoxRect(Window* the_window, Rectangle* the_coords, uint8_t the_c
 bool Window_SetPixel(Window* the_window, uint8_t the_color);
 
 //! Draws a line between 2 passed coordinates.
-//! Use for any line that is not perfectly vertical or perfectly horizontal
+//! Only the part of the line within the content area is drawn.
 //! @param	the_window -- reference to a valid Window object.
 //! @param	x1 -- the starting horizontal position within the content area of the window
 //! @param	y1 -- the starting vertical position within the content area of the window
 //! @param	x2 -- the ending horizontal position within the content area of the window
 //! @param	y2 -- the ending vertical position within the content area of the window
 //! @param	the_color -- a 1-byte index to the current color LUT
-//! Based on http://rosettacode.org/wiki/Bitmap/Bresenham%27s_line_algorithm#C. Used in C128 Lich King. 
 bool Window_DrawLine(Window* the_window, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint8_t the_color);
 
 //! Draws a horizontal line from the current pen location, for n pixels, using the specified pixel value
@@ -701,7 +766,7 @@ bool Window_DrawBox(Window* the_window, int16_t width, int16_t height, uint8_t t
 //! @param	the_window -- reference to a valid Window object.
 //! @param	width -- width, in pixels, of the rectangle to be drawn
 //! @param	height -- height, in pixels, of the rectangle to be drawn
-//! @param	radius -- radius, in pixels, of the arc to be applied to the rectangle's corners. Minimum 3, maximum 20.
+//! @param	radius -- radius, in pixels, of the arc to be applied to the rectangle's corners. 0 draws square corners. A radius too big for the box is reduced to the largest that fits.
 //! @param	the_color -- a 1-byte index to the current color LUT
 //! @param	do_fill -- If true, the box will be filled with the provided color. If false, the box will only draw the outline.
 //! @return:	returns false on any error/invalid input.
@@ -712,7 +777,8 @@ bool Window_DrawRoundBox(Window* the_window, int16_t width, int16_t height, int1
 //! @param	the_window -- reference to a valid Window object.
 //! @param	radius -- radius, in pixels, measured from the window's current pen location
 //! @param	the_color -- a 1-byte index to the current color LUT
-bool Window_DrawCircle(Window* the_window, int16_t radius, uint8_t the_color);
+//! @param	do_fill -- If true, the circle will be filled with the provided color. If false, only the outline will be drawn.
+bool Window_DrawCircle(Window* the_window, int16_t radius, uint8_t the_color, bool do_fill);
 
 // Draw a string at the current "pen" location, using the current pen color of the Window
 // Truncate, but still draw the string if it is too long to display on the line it started.
@@ -736,6 +802,52 @@ char* Window_DrawStringInBox(Window* the_window, int16_t width, int16_t height,
 
 
 
+// **** BATCH DRAW functions *****
+
+//! Start a new draw batch for the window, discarding the previous one
+//! Use a batch instead of individual Window_Draw* calls when drawing many primitives at once (charts, grids, lists, etc.)
+//! The batch is kept after it is submitted, and is drawn again automatically whenever the whole window has to be redrawn
+//! @param	the_window -- reference to a valid Window object.
+//! @return:	returns false on any error/invalid input.
+bool Window_BeginBatch(Window* the_window);
+
+//! Add one draw command to the window's open batch. Nothing is drawn or checked until the batch is submitted.
+//! @param	the_window -- reference to a valid Window object, with a batch started with Window_BeginBatch()
+//! @param	the_op -- the command to add. It is copied, so it can be reused for the next command.
+//! @return:	returns false if no batch was open, or if there was not enough memory to add the command
+bool Window_AppendOp(Window* the_window, WindowDrawOp* the_op);
+
+//! Draw every command in the window's open batch, and mark the area drawn to be blitted in the next render
+//! Commands are clipped to the window's content area. Commands of an unknown type, or with a NULL bitmap/string, are skipped.
+//! @param	the_window -- reference to a valid Window object, with a batch started with Window_BeginBatch()
+//! @return:	returns false if no batch was open
+bool Window_SubmitBatch(Window* the_window);
+
+
+
+// **** SCROLLING functions *****
+
+//! Tell the window how big its content is. The window shows a scroller from the theme for each direction the content doesn't fit in.
+//! If the content shrinks so that the current scroll position is out of range, the window is scrolled back, and the content area is redrawn.
+//! @param	the_window -- reference to a valid Window object.
+//! @param	width -- the width of all the content, in pixels
+//! @param	height -- the height of all the content, in pixels
+//! @return:	returns false on any error/invalid input.
+bool Window_SetContentSize(Window* the_window, int16_t width, int16_t height);
+
+//! Scroll the content area by the passed distances, limited to the content size set with Window_SetContentSize()
+//! The pixels still in view are moved with one overlapping blit. Only the strips scrolled into view are redrawn: 
+//!   they are cleared, the window's draw batch (if any) is replayed into them, and an updateEvt is posted to the window for each one.
+//!   The updateEvt's x, y, width, and height describe the strip, relative to the content area (the coordinates the Window_Draw functions use). Add content_left_/content_top_ for the position within the content.
+//! Controls in the content area (other than the scrollers) stay where they are: the area their moved copy landed on is redrawn like a strip.
+//! @param	the_window -- reference to a valid Window object.
+//! @param	dx -- number of pixels to scroll right. Negative values scroll left.
+//! @param	dy -- number of pixels to scroll down. Negative values scroll up.
+//! @return:	returns false on any error/invalid input. Returns true, without doing anything, if the window can't scroll any further in that direction.
+bool Window_ScrollBy(Window* the_window, int16_t dx, int16_t dy);
+
+
+
 // **** Debug functions *****
 
 //! @param	the_window -- reference to a valid Window object.
@@ -16,6 +16,7 @@
 
 // project includes
 #include "debug.h"
+#include "pool.h"
 #include "sys.h"
 #include "theme.h"
 
@@ -325,7 +326,10 @@ void RunDemo(void)
 	
 	DEBUG_OUT(("%s %d: Setting graphics mode...", __func__, __LINE__));
 
-	Sys_SetGraphicMode(global_system, PARAM_SPRITES_OFF, PARAM_BITMAP_ON, PARAM_TILES_OFF, PARAM_TEXT_OVERLAY_OFF, PARAM_TEXT_OFF);
+	Sys_SetGraphicMode(global_system, PARAM_SPRITES_ON, PARAM_BITMAP_ON, PARAM_TILES_OFF, PARAM_TEXT_OVERLAY_OFF, PARAM_TEXT_OFF);
+	
+	// compose off screen and flip, so windows don't flicker while being dragged. carries on single-buffered if there's no VRAM for it.
+	Sys_SetDoubleBuffer(global_system, true);
 	
 	if ( (the_win_template = Window_GetNewWinTemplate(the_win_title)) == NULL)
 	{
@@ -439,6 +443,9 @@ int main(int argc, char* argv[])
 
 	DEBUG_OUT(("%s %d: System object created ok. Initiating system components...", __func__, __LINE__));
 	
+	// the demo opens and closes many large windows: carve their bitmaps from an arena, so the heap doesn't fragment
+	Pool_InitArena(POOL_ARENA_DEFAULT_SIZE);
+	
 	if (Sys_InitSystem(global_system) == false)
 	{
 		DEBUG_OUT(("%s %d: Couldn't initialize the system", __func__, __LINE__));
@@ -19,13 +19,18 @@
 
 // project includes
 #include "debug.h"
+#include "event.h"
+#include "region.h"
 #include "sys.h"
+#include "theme.h"
 
 // class being tested
 #include "window.h"
 
 // C includes
 #include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
 
 
 // A2560 includes
@@ -37,6 +42,8 @@
 /*                               Definitions                                 */
 /*****************************************************************************/
 
+#define BATCH_SPEED_TEST_NUM_ROWS		100	// number of grid rows drawn per pass in the batch speed test. each row is 1 fill, 1 hline, and 1 vline.
+#define BATCH_SPEED_TEST_PASSES			20
 
 
 /*****************************************************************************/
@@ -61,6 +68,12 @@ System*			global_system;
 // handler for the hello world window
 void HelloWindowEventHandler(EventRecord* the_event);
 
+// make a window with the default template, or return NULL
+Window* Test_NewWindow(void);
+
+// fill in a draw op
+void Test_SetOp(WindowDrawOp* the_op, window_draw_op_type the_type, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint8_t the_color);
+
 
 /*****************************************************************************/
 /*                       Private Function Definitions                        */
@@ -75,6 +88,41 @@ void HelloWindowEventHandler(EventRecord* the_event)
 }
 
 
+// make a window with the default template, or return NULL
+Window* Test_NewWindow(void)
+{
+	Window*				the_window;
+	NewWinTemplate*		the_win_template;
+	static char*		the_win_title = "Batch Test Window";
+	
+	if ( (the_win_template = Window_GetNewWinTemplate(the_win_title)) == NULL)
+	{
+		LOG_ERR(("%s %d: Could not get a new window template", __func__ , __LINE__));
+		return NULL;
+	}	
+	
+	the_window = Window_New(the_win_template, &HelloWindowEventHandler);
+	free(the_win_template);
+	
+	return the_window;
+}
+
+
+// fill in a draw op
+void Test_SetOp(WindowDrawOp* the_op, window_draw_op_type the_type, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint8_t the_color)
+{
+	the_op->type_ = the_type;
+	the_op->color_ = the_color;
+	the_op->x1_ = x1;
+	the_op->y1_ = y1;
+	the_op->x2_ = x2;
+	the_op->y2_ = y2;
+	the_op->src_x_ = 0;
+	the_op->src_y_ = 0;
+	the_op->data_ = NULL;
+}
+
+
 
 
 
@@ -134,6 +182,64 @@ MU_TEST(test_speed_1)
 }
 
 
+// draw the same grid with individual Window_Draw* calls, and as one batch
+MU_TEST(test_speed_2_batch)
+{
+	Window*			the_window;
+	WindowDrawOp	the_op;
+	long			start_ticks;
+	long			single_ticks;
+	long			batch_ticks;
+	int16_t			i;
+	int16_t			j;
+	
+	the_window = Test_NewWindow();
+	mu_assert(the_window != NULL, "could not create window");
+	
+	start_ticks = mu_timer_real();
+	
+	for (j = 0; j < BATCH_SPEED_TEST_PASSES; j++)
+	{
+		for (i = 0; i < BATCH_SPEED_TEST_NUM_ROWS; i++)
+		{
+			Window_SetPenXY(the_window, 0, i);
+			Window_FillBox(the_window, 40, 0, (uint8_t)i);
+			Window_DrawHLine(the_window, 100, (uint8_t)j);
+			Window_SetPenXY(the_window, i, 0);
+			Window_DrawVLine(the_window, 50, (uint8_t)j);
+		}
+	}
+	
+	single_ticks = mu_timer_real() - start_ticks;
+	
+	start_ticks = mu_timer_real();
+	
+	for (j = 0; j < BATCH_SPEED_TEST_PASSES; j++)
+	{
+		Window_BeginBatch(the_window);
+		
+		for (i = 0; i < BATCH_SPEED_TEST_NUM_ROWS; i++)
+		{
+			Test_SetOp(&the_op, WIN_OP_FILL, 0, i, 39, i, (uint8_t)i);
+			Window_AppendOp(the_window, &the_op);
+			Test_SetOp(&the_op, WIN_OP_HLINE, 0, i, 99, i, (uint8_t)j);
+			Window_AppendOp(the_window, &the_op);
+			Test_SetOp(&the_op, WIN_OP_VLINE, i, 0, i, 49, (uint8_t)j);
+			Window_AppendOp(the_window, &the_op);
+		}
+		
+		Window_SubmitBatch(the_window);
+	}
+	
+	batch_ticks = mu_timer_real() - start_ticks;
+	
+	printf("\nBatch speed results: %i ops x %i passes: individual calls: %li ticks; batched: %li ticks\n", BATCH_SPEED_TEST_NUM_ROWS * 3, BATCH_SPEED_TEST_PASSES, single_ticks, batch_ticks);
+	DEBUG_OUT(("Batch speed results: %i ops x %i passes: individual calls: %li ticks; batched: %li ticks", BATCH_SPEED_TEST_NUM_ROWS * 3, BATCH_SPEED_TEST_PASSES, single_ticks, batch_ticks));
+	
+	Window_Destroy(&the_window);
+}
+
+
 // test for memory corruption byu comparing known values for bitmap images to actual ram (not VRAM, can't test that) 
 MU_TEST(unit_test_1)
 {
@@ -212,6 +318,253 @@ MU_TEST(unit_test_1)
 }
 
 
+MU_TEST(batch_draw_test)
+{
+	Window*			the_window;
+	Bitmap*			the_bitmap;
+	WindowDrawOp	the_op;
+	int16_t			left;
+	int16_t			top;
+	int16_t			right;
+	uint8_t			border_pixel;
+	
+	the_window = Test_NewWindow();
+	mu_assert(the_window != NULL, "could not create window");
+	
+	the_bitmap = the_window->bitmap_;
+	left = the_window->content_rect_.MinX;
+	top = the_window->content_rect_.MinY;
+	right = the_window->content_rect_.MaxX;
+	border_pixel = Bitmap_GetPixelAtXY(the_bitmap, right + 1, top + 10);
+	
+	// ops can't be added until a batch is started
+	Test_SetOp(&the_op, WIN_OP_HLINE, 0, 0, 9, 0, 7);
+	mu_check( Window_AppendOp(the_window, &the_op) == false );
+	
+	mu_check( Window_BeginBatch(the_window) == true );
+	Test_SetOp(&the_op, WIN_OP_HLINE, 2, 3, 9, 0, 7);
+	mu_check( Window_AppendOp(the_window, &the_op) == true );
+	
+	// a fill that runs past the right edge of the content area is clipped to it
+	Test_SetOp(&the_op, WIN_OP_FILL, right - left - 4, 10, right - left + 20, 12, 9);
+	mu_check( Window_AppendOp(the_window, &the_op) == true );
+	
+	// corners given in either order are the same box
+	Test_SetOp(&the_op, WIN_OP_BOX, 30, 30, 20, 20, 11);
+	mu_check( Window_AppendOp(the_window, &the_op) == true );
+	
+	Test_SetOp(&the_op, WIN_OP_LINE, 0, 40, 5, 45, 13);
+	mu_check( Window_AppendOp(the_window, &the_op) == true );
+	mu_assert_int_eq(4, the_window->batch_count_);
+	
+	Region_MakeEmpty(the_window->clip_region_);
+	mu_check( Window_SubmitBatch(the_window) == true );
+	
+	// nothing is drawn until the batch is submitted; after that, everything is, within the content area only
+	mu_assert_int_eq(7, Bitmap_GetPixelAtXY(the_bitmap, left + 2, top + 3));
+	mu_assert_int_eq(7, Bitmap_GetPixelAtXY(the_bitmap, left + 9, top + 3));
+	mu_assert_int_eq(9, Bitmap_GetPixelAtXY(the_bitmap, right, top + 11));
+	mu_assert_int_eq(border_pixel, Bitmap_GetPixelAtXY(the_bitmap, right + 1, top + 10));
+	mu_assert_int_eq(11, Bitmap_GetPixelAtXY(the_bitmap, left + 20, top + 25));
+	mu_assert_int_eq(11, Bitmap_GetPixelAtXY(the_bitmap, left + 30, top + 30));
+	mu_check( Bitmap_GetPixelAtXY(the_bitmap, left + 25, top + 25) != 11 );
+	mu_assert_int_eq(13, Bitmap_GetPixelAtXY(the_bitmap, left + 5, top + 45));
+	
+	// the area drawn was queued for the compositor
+	mu_check( Region_ContainsPoint(the_window->clip_region_, left + 2, top + 3) == true );
+	mu_check( Region_ContainsPoint(the_window->clip_region_, right, top + 11) == true );
+	mu_check( Region_ContainsPoint(the_window->clip_region_, right + 1, top + 11) == false );
+	
+	// the batch is closed, but kept for replay
+	mu_check( Window_AppendOp(the_window, &the_op) == false );
+	mu_check( Window_SubmitBatch(the_window) == false );
+	mu_assert_int_eq(4, the_window->batch_count_);
+	
+	// starting a new batch discards the old one
+	mu_check( Window_BeginBatch(the_window) == true );
+	mu_assert_int_eq(0, the_window->batch_count_);
+	mu_check( Window_SubmitBatch(the_window) == true );
+	
+	Window_Destroy(&the_window);
+}
+
+MU_TEST(resize_keeps_content_test)
+{
+	Window*			the_window;
+	Bitmap*			the_bitmap;
+	Theme*			the_theme;
+	int16_t			left;
+	int16_t			top;
+	int16_t			right;
+	int16_t			bottom;
+	
+	the_window = Test_NewWindow();
+	mu_assert(the_window != NULL, "could not create window");
+	
+	the_theme = Sys_GetTheme(global_system);
+	the_bitmap = the_window->bitmap_;
+	
+	// the first render draws everything. after that, draw a marker that only exists in the bitmap.
+	Window_Render(the_window);
+	mu_check( the_window->invalidated_ == false );
+	
+	left = the_window->content_rect_.MinX;
+	top = the_window->content_rect_.MinY;
+	Bitmap_FillBox(the_bitmap, left + 5, top + 5, 10, 10, 9);
+	Region_MakeEmpty(the_window->clip_region_);
+	
+	// grow it: the marker is kept, and isn't re-blitted. the uncovered strips are cleared, and the border moves out.
+	Window_ChangeWindow(the_window, the_window->x_, the_window->y_, the_window->width_ + 40, the_window->height_ + 30, WIN_PARAM_UPDATE_NORM_SIZE_TO_MATCH);
+	the_bitmap = the_window->bitmap_;
+	right = the_window->content_rect_.MaxX;
+	bottom = the_window->content_rect_.MaxY;
+	
+	mu_check( the_window->invalidated_ == false );
+	mu_assert_int_eq(9, Bitmap_GetPixelAtXY(the_bitmap, left + 5, top + 5));
+	mu_assert_int_eq(9, Bitmap_GetPixelAtXY(the_bitmap, left + 14, top + 14));
+	mu_check( Region_ContainsPoint(the_window->clip_region_, left + 5, top + 5) == false );
+	
+	mu_assert_int_eq(Theme_GetContentAreaColor(the_theme), Bitmap_GetPixelAtXY(the_bitmap, right - 10, top + 5));
+	mu_assert_int_eq(Theme_GetContentAreaColor(the_theme), Bitmap_GetPixelAtXY(the_bitmap, left + 5, bottom - 5));
+	mu_check( Region_ContainsPoint(the_window->clip_region_, right - 10, top + 5) == true );
+	mu_check( Region_ContainsPoint(the_window->clip_region_, left + 5, bottom - 5) == true );
+	mu_assert_int_eq(Theme_GetOutlineColor(the_theme), Bitmap_GetPixelAtXY(the_bitmap, the_window->width_ - 1, top + 5));
+	mu_assert_int_eq(Theme_GetOutlineColor(the_theme), Bitmap_GetPixelAtXY(the_bitmap, left + 5, the_window->height_ - 1));
+	
+	// shrink it: the part of the marker that still fits is kept
+	Window_Render(the_window);
+	Window_ChangeWindow(the_window, the_window->x_, the_window->y_, the_window->width_ - 60, the_window->height_ - 10, WIN_PARAM_UPDATE_NORM_SIZE_TO_MATCH);
+	mu_check( the_window->invalidated_ == false );
+	mu_assert_int_eq(9, Bitmap_GetPixelAtXY(the_window->bitmap_, left + 14, top + 14));
+	
+	// a move redraws nothing, but re-blits the whole window
+	Window_Render(the_window);
+	Window_ChangeWindow(the_window, the_window->x_ + 10, the_window->y_ + 10, the_window->width_, the_window->height_, WIN_PARAM_UPDATE_NORM_SIZE_TO_MATCH);
+	mu_check( the_window->invalidated_ == false );
+	mu_check( the_window->titlebar_invalidated_ == false );
+	mu_assert_int_eq(9, Bitmap_GetPixelAtXY(the_window->bitmap_, left + 5, top + 5));
+	mu_check( Region_ContainsPoint(the_window->clip_region_, 0, 0) == true );
+	mu_check( Region_ContainsPoint(the_window->clip_region_, left + 5, top + 5) == true );
+	
+	Window_Destroy(&the_window);
+}
+
+MU_TEST(event_mask_test)
+{
+	Window*			the_window;
+	EventManager*	the_event_manager;
+	uint8_t			moved_count;
+	uint8_t			down_count;
+	
+	the_window = Test_NewWindow();
+	mu_assert(the_window != NULL, "could not create window");
+	
+	// a window that isn't in the system's window list yet doesn't count as a subscriber: changing its mask leaves the counts alone
+	the_event_manager = Sys_GetEventManager(global_system);
+	moved_count = the_event_manager->subscribers_[mouseMoved];
+	down_count = the_event_manager->subscribers_[mouseDown];
+	
+	mu_check( the_window->subscribed_ == false );
+	Window_SetEventMask(the_window, mouseMovedMask);
+	mu_assert_int_eq(mouseMovedMask, Window_GetEventMask(the_window));
+	mu_assert_int_eq(moved_count, the_event_manager->subscribers_[mouseMoved]);
+	mu_assert_int_eq(down_count, the_event_manager->subscribers_[mouseDown]);
+	
+	Window_Destroy(&the_window);
+}
+
+MU_TEST(dirty_rect_test)
+{
+	Window*			the_window;
+	Rectangle		the_coords;
+	int16_t			left;
+	int16_t			top;
+	
+	the_window = Test_NewWindow();
+	mu_assert(the_window != NULL, "could not create window");
+	
+	// once the window has been rendered, only what is drawn after that is queued for the compositor
+	Window_Render(the_window);
+	Region_MakeEmpty(the_window->clip_region_);
+	
+	left = the_window->content_rect_.MinX;
+	top = the_window->content_rect_.MinY;
+	
+	the_coords.MinX = 10;
+	the_coords.MinY = 10;
+	the_coords.MaxX = 20;
+	the_coords.MaxY = 15;
+	mu_check( Window_FillBoxRect(the_window, &the_coords, 9) == true );
+	mu_check( Region_ContainsPoint(the_window->clip_region_, left + 10, top + 10) == true );
+	mu_check( Region_ContainsPoint(the_window->clip_region_, left + 20, top + 15) == true );
+	mu_check( Region_ContainsPoint(the_window->clip_region_, left + 40, top + 40) == false );
+	
+	// a line is only queued for the part of it within the content area
+	mu_check( Window_DrawLine(the_window, 30, 40, 50, 40, 7) == true );
+	mu_check( Region_ContainsPoint(the_window->clip_region_, left + 40, top + 40) == true );
+	mu_check( Window_DrawLine(the_window, -20, 60, 5, 60, 7) == true );
+	mu_check( Region_ContainsPoint(the_window->clip_region_, left, top + 60) == true );
+	mu_check( Region_ContainsPoint(the_window->clip_region_, left - 1, top + 60) == false );
+	
+	// an invalidated window is blitted in full anyway, so nothing more is queued
+	Window_Invalidate(the_window);
+	Region_MakeEmpty(the_window->clip_region_);
+	mu_check( Window_FillBoxRect(the_window, &the_coords, 9) == true );
+	mu_check( Region_ContainsPoint(the_window->clip_region_, left + 10, top + 10) == false );
+	
+	Window_Destroy(&the_window);
+}
+
+
+MU_TEST(scroll_test)
+{
+	Window*			the_window;
+	Bitmap*			the_bitmap;
+	Rectangle		the_coords;
+	int16_t			left;
+	int16_t			top;
+	
+	the_window = Test_NewWindow();
+	mu_assert(the_window != NULL, "could not create window");
+	
+	the_bitmap = the_window->bitmap_;
+	
+	// content taller than the window gets a vertical scroller, but not a horizontal one
+	mu_check( Window_SetContentSize(the_window, 10, 2000) == true );
+	mu_check( the_window->v_scroller_visible_ == true );
+	mu_check( the_window->h_scroller_visible_ == false );
+	
+	Window_Render(the_window);
+	
+	left = the_window->content_rect_.MinX;
+	top = the_window->content_rect_.MinY;
+	
+	the_coords.MinX = 5;
+	the_coords.MinY = 20;
+	the_coords.MaxX = 8;
+	the_coords.MaxY = 22;
+	mu_check( Window_FillBoxRect(the_window, &the_coords, 9) == true );
+	
+	// what was drawn moves up with the content
+	mu_check( Window_ScrollBy(the_window, 0, 10) == true );
+	mu_assert_int_eq(10, the_window->content_top_);
+	mu_assert_int_eq(9, Bitmap_GetPixelAtXY(the_bitmap, left + 5, top + 10));
+	mu_check( Bitmap_GetPixelAtXY(the_bitmap, left + 5, top + 20) != 9 );
+	
+	// the content is only 10 pixels wide: there is nowhere to scroll sideways, or above the top
+	mu_check( Window_ScrollBy(the_window, 50, -100) == true );
+	mu_assert_int_eq(0, the_window->content_left_);
+	mu_assert_int_eq(0, the_window->content_top_);
+	mu_assert_int_eq(9, Bitmap_GetPixelAtXY(the_bitmap, left + 5, top + 20));
+	
+	// when the content fits again, the scroller goes away
+	mu_check( Window_SetContentSize(the_window, 10, 10) == true );
+	mu_check( the_window->v_scroller_visible_ == false );
+	
+	Window_Destroy(&the_window);
+}
+
+
 
 
 // speed tests
@@ -220,6 +573,7 @@ MU_TEST_SUITE(test_suite_speed)
 	MU_SUITE_CONFIGURE(&test_setup, &test_teardown);
 	
 	MU_RUN_TEST(test_speed_1);
+	MU_RUN_TEST(test_speed_2_batch);
 }
 
 
@@ -229,6 +583,11 @@ MU_TEST_SUITE(test_suite_units)
 	MU_SUITE_CONFIGURE(&test_setup, &test_teardown);
 	
 // 	MU_RUN_TEST(unit_test_1);
+	MU_RUN_TEST(batch_draw_test);
+	MU_RUN_TEST(resize_keeps_content_test);
+	MU_RUN_TEST(dirty_rect_test);
+	MU_RUN_TEST(scroll_test);
+	MU_RUN_TEST(event_mask_test);
 }
 
 